@@ -1,10 +1,14 @@
 #include "benchmark/benchmark.h"
 #include "foundation/array.hpp"
 #include "foundation/set.hpp"
-#include "math/quaternion.hpp"
+#include "foundation/map.hpp"
+#include "foundation/sparse_array.hpp"
+#include "foundation/bit_array.hpp"
+#include <algorithm>
 #include <vector>
 #include <set>
 #include <unordered_set>
+#include <unordered_map>
 
 using namespace Engine;
 
@@ -227,31 +231,240 @@ static void BM_StdStringAppend(benchmark::State& state)
     }
 }
 
-static void BM_RotatorToQuat(benchmark::State& state)
+static void BM_MapAdd(benchmark::State& state)
 {
-    Rotator rotator(10, 60, 10);
+    const int32 num = static_cast<int32>(state.range(0));
     for (auto _ : state)
     {
-        rotator.ToQuaternion();
+        Map<int32, int32> map;
+        for (int32 i = 0; i < num; i++)
+        {
+            map.Add(i, i);
+        }
+        benchmark::DoNotOptimize(map.Size());
+    }
+    state.SetItemsProcessed(state.iterations() * num);
+}
+
+static void BM_StlHashMapAdd(benchmark::State& state)
+{
+    const int32 num = static_cast<int32>(state.range(0));
+    for (auto _ : state)
+    {
+        std::unordered_map<int32, int32> map;
+        for (int32 i = 0; i < num; i++)
+        {
+            map.emplace(i, i);
+        }
+        benchmark::DoNotOptimize(map.size());
+    }
+    state.SetItemsProcessed(state.iterations() * num);
+}
+
+static void BM_MapFind(benchmark::State& state)
+{
+    const int32 num = static_cast<int32>(state.range(0));
+    Map<int32, int32> map;
+    for (int32 i = 0; i < num; i++)
+    {
+        map.Add(i * 7, i);
+    }
+
+    int32 key = 0;
+    for (auto _ : state)
+    {
+        // half of lookups miss
+        benchmark::DoNotOptimize(map.Find(key));
+        key = key + 3 < num * 7 ? key + 3 : 0;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_StlHashMapFind(benchmark::State& state)
+{
+    const int32 num = static_cast<int32>(state.range(0));
+    std::unordered_map<int32, int32> map;
+    for (int32 i = 0; i < num; i++)
+    {
+        map.emplace(i * 7, i);
+    }
+
+    int32 key = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(map.find(key));
+        key = key + 3 < num * 7 ? key + 3 : 0;
     }
+    state.SetItemsProcessed(state.iterations());
 }
 
-static void BM_VectorCross(benchmark::State& state)
+static void BM_MapRemove(benchmark::State& state)
 {
-    Vector3f vec(5, 6.2, 7.1);
+    const int32 num = static_cast<int32>(state.range(0));
+    Map<int32, int32> map;
+    for (int32 i = 0; i < num; i++)
+    {
+        map.Add(i, i);
+    }
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto copy = map;
+        state.ResumeTiming();
+        for (int32 i = 0; i < num; i++)
+        {
+            copy.Remove(i);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * num);
+}
+
+static void BM_MapLoop(benchmark::State& state)
+{
+    const int32 num = static_cast<int32>(state.range(0));
+    Map<int32, int32> map;
+    for (int32 i = 0; i < num; i++)
+    {
+        map.Add(i, i);
+    }
+
     for (auto _ : state)
     {
-        Vector3f::Cross(vec, vec);
+        int64 sum = 0;
+        for (auto&& pair : map)
+        {
+            sum += pair.Value;
+        }
+        benchmark::DoNotOptimize(sum);
     }
+    state.SetItemsProcessed(state.iterations() * num);
 }
 
-static void BM_QuatNormalize(benchmark::State& state)
+static void BM_SparseArrayAdd(benchmark::State& state)
 {
-    Quat quat({5, 4, 3, 1});
+    const int32 num = static_cast<int32>(state.range(0));
     for (auto _ : state)
     {
-        quat.Normalize();
+        SparseArray<int32> array;
+        for (int32 i = 0; i < num; i++)
+        {
+            array.Add(i);
+        }
+        benchmark::DoNotOptimize(array.Size());
     }
+    state.SetItemsProcessed(state.iterations() * num);
+}
+
+static void BM_SparseArrayRemoveAndReuse(benchmark::State& state)
+{
+    const int32 num = static_cast<int32>(state.range(0));
+    SparseArray<int32> array;
+    for (int32 i = 0; i < num; i++)
+    {
+        array.Add(i);
+    }
+
+    for (auto _ : state)
+    {
+        // holes are refilled through free list
+        for (int32 i = 0; i < num; i += 2)
+        {
+            array.RemoveAt(i);
+        }
+        for (int32 i = 0; i < num; i += 2)
+        {
+            array.Add(i);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * num);
+}
+
+static void BM_SparseArrayLoop(benchmark::State& state)
+{
+    const int32 num = static_cast<int32>(state.range(0));
+    SparseArray<int32> array;
+    for (int32 i = 0; i < num; i++)
+    {
+        array.Add(i);
+    }
+    for (int32 i = 0; i < num; i += 3)
+    {
+        array.RemoveAt(i);
+    }
+
+    for (auto _ : state)
+    {
+        int64 sum = 0;
+        for (auto&& val : array)
+        {
+            sum += val;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * array.Size());
+}
+
+static void BM_BitArrayAdd(benchmark::State& state)
+{
+    const int32 num = static_cast<int32>(state.range(0));
+    for (auto _ : state)
+    {
+        BitArray bits;
+        for (int32 i = 0; i < num; i++)
+        {
+            bits.Add((i & 1) != 0);
+        }
+        benchmark::DoNotOptimize(bits.Size());
+    }
+    state.SetItemsProcessed(state.iterations() * num);
+}
+
+static void BM_BitArrayFind(benchmark::State& state)
+{
+    const int32 num = static_cast<int32>(state.range(0));
+    BitArray bits(false, num);
+    bits[num - 1] = true;
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(bits.Find(true));
+    }
+    state.SetItemsProcessed(state.iterations() * num);
+}
+
+static void BM_BitArrayValidLoop(benchmark::State& state)
+{
+    const int32 num = static_cast<int32>(state.range(0));
+    BitArray bits(false, num);
+    for (int32 i = 0; i < num; i += 5)
+    {
+        bits[i] = true;
+    }
+
+    for (auto _ : state)
+    {
+        int32 count = 0;
+        for (auto it = bits.CreateValidIterator(); it; ++it)
+        {
+            ++count;
+        }
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetItemsProcessed(state.iterations() * num);
+}
+
+static void BM_VectorBoolFind(benchmark::State& state)
+{
+    const int32 num = static_cast<int32>(state.range(0));
+    std::vector<bool> bits(num, false);
+    bits[num - 1] = true;
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(std::find(bits.begin(), bits.end(), true));
+    }
+    state.SetItemsProcessed(state.iterations() * num);
 }
 
 BENCHMARK(BM_DyanmicArrayAdd);
@@ -274,8 +487,18 @@ BENCHMARK(BM_StlSetLoop);
 BENCHMARK(BM_StdString);
 BENCHMARK(BM_StdStringAppend);
 
-BENCHMARK(BM_RotatorToQuat);
-BENCHMARK(BM_VectorCross);
-BENCHMARK(BM_QuatNormalize);
-
-BENCHMARK_MAIN();
\ No newline at end of file
+BENCHMARK(BM_MapAdd)->RangeMultiplier(8)->Range(8, 1 << 15);
+BENCHMARK(BM_StlHashMapAdd)->RangeMultiplier(8)->Range(8, 1 << 15);
+BENCHMARK(BM_MapFind)->RangeMultiplier(8)->Range(8, 1 << 15);
+BENCHMARK(BM_StlHashMapFind)->RangeMultiplier(8)->Range(8, 1 << 15);
+BENCHMARK(BM_MapRemove)->RangeMultiplier(8)->Range(8, 1 << 15);
+BENCHMARK(BM_MapLoop)->RangeMultiplier(8)->Range(8, 1 << 15);
+
+BENCHMARK(BM_SparseArrayAdd)->RangeMultiplier(8)->Range(8, 1 << 15);
+BENCHMARK(BM_SparseArrayRemoveAndReuse)->RangeMultiplier(8)->Range(8, 1 << 15);
+BENCHMARK(BM_SparseArrayLoop)->RangeMultiplier(8)->Range(8, 1 << 15);
+
+BENCHMARK(BM_BitArrayAdd)->RangeMultiplier(8)->Range(64, 1 << 18);
+BENCHMARK(BM_BitArrayFind)->RangeMultiplier(8)->Range(64, 1 << 18);
+BENCHMARK(BM_BitArrayValidLoop)->RangeMultiplier(8)->Range(64, 1 << 18);
+BENCHMARK(BM_VectorBoolFind)->RangeMultiplier(8)->Range(64, 1 << 18);
@@ -0,0 +1,122 @@
+#include "benchmark/benchmark.h"
+#include "foundation/delegate.hpp"
+#include <functional>
+
+using namespace Engine;
+
+namespace
+{
+    int32 AddStatic(int32 value)
+    {
+        return value + 1;
+    }
+
+    void AccumulateStatic(int32 value, int64& sum)
+    {
+        sum += value;
+    }
+
+    class Receiver
+    {
+    public:
+        int32 Add(int32 value)
+        {
+            Total += value;
+            return Total;
+        }
+
+        void Accumulate(int32 value, int64& sum)
+        {
+            sum += value + Total;
+        }
+
+        int32 Total{ 0 };
+    };
+}
+
+static void BM_DelegateStatic(benchmark::State& state)
+{
+    Delegate<int32, int32> delegate;
+    delegate.BindStatic(&AddStatic);
+    int32 value = 0;
+    for (auto _ : state)
+    {
+        value = delegate.Execute(value);
+    }
+    benchmark::DoNotOptimize(value);
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_DelegateRaw(benchmark::State& state)
+{
+    Receiver receiver;
+    Delegate<int32, int32> delegate;
+    delegate.BindRaw(&receiver, &Receiver::Add);
+    int32 value = 0;
+    for (auto _ : state)
+    {
+        value = delegate.Execute(1);
+    }
+    benchmark::DoNotOptimize(value);
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_DelegateSP(benchmark::State& state)
+{
+    SharedPtr<Receiver> receiver = MakeShared<Receiver>();
+    Delegate<int32, int32> delegate;
+    delegate.BindSP(receiver, &Receiver::Add);
+    for (auto _ : state)
+    {
+        // checks receiver is alive before every call
+        delegate.ExecuteIfBound(1);
+    }
+    benchmark::DoNotOptimize(receiver->Total);
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_StdFunction(benchmark::State& state)
+{
+    Receiver receiver;
+    std::function<int32(int32)> function = [&receiver](int32 value) { return receiver.Add(value); };
+    int32 value = 0;
+    for (auto _ : state)
+    {
+        value = function(1);
+    }
+    benchmark::DoNotOptimize(value);
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_MultiDelegateBroadcast(benchmark::State& state)
+{
+    const int32 num = static_cast<int32>(state.range(0));
+    Array<Receiver> receivers;
+    receivers.Resize(num);
+    MultiDelegate<void, int32, int64&> delegate;
+    for (int32 i = 0; i < num; i++)
+    {
+        if ((i & 1) == 0)
+        {
+            delegate.AddStatic(&AccumulateStatic);
+        }
+        else
+        {
+            delegate.AddRaw(&receivers[i], &Receiver::Accumulate);
+        }
+    }
+
+    int64 sum = 0;
+    for (auto _ : state)
+    {
+        delegate.Broadcast(1, sum);
+    }
+    benchmark::DoNotOptimize(sum);
+    state.SetItemsProcessed(state.iterations() * num);
+}
+
+BENCHMARK(BM_DelegateStatic);
+BENCHMARK(BM_DelegateRaw);
+BENCHMARK(BM_DelegateSP);
+BENCHMARK(BM_StdFunction);
+BENCHMARK(BM_MultiDelegateBroadcast)->RangeMultiplier(4)->Range(1, 256);
@@ -0,0 +1,140 @@
+#include "benchmark/benchmark.h"
+#include "file_system/file_system.hpp"
+#include "file_system/file_stream.hpp"
+#include "file_system/async_file_io.hpp"
+#include "file_system/path.hpp"
+#include "foundation/map.hpp"
+#include "math/generic_math.hpp"
+
+using namespace Engine;
+
+namespace
+{
+    constexpr int64 CHUNK_SIZE = 64 << 10;
+
+    /** file of given size under saved/benchmark, written once and reused, so reads are served by page cache */
+    const String& GetBenchmarkFile(int64 size)
+    {
+        static Map<int64, String>* files = new Map<int64, String>();
+        if (const String* filePath = files->Find(size))
+        {
+            return *filePath;
+        }
+
+        const String dir = Path::Combine(FileSystem::GetEngineSaveDir(), "benchmark");
+        FileSystem::MakeDirTree(dir);
+        String filePath = Path::Combine(dir, String::Format("read_{0}.bin", size));
+        if (FileSystem::FileSize(filePath) != size)
+        {
+            FileWriter writer(filePath);
+            Array<uint8> chunk;
+            chunk.Resize(static_cast<int32>(CHUNK_SIZE));
+            for (int32 i = 0; i < chunk.Size(); i++)
+            {
+                chunk[i] = static_cast<uint8>(i * 31);
+            }
+            for (int64 written = 0; written < size; written += CHUNK_SIZE)
+            {
+                writer.Write(chunk.Data(), Math::Min(CHUNK_SIZE, size - written));
+            }
+        }
+        return files->Add(size, filePath);
+    }
+}
+
+static void BM_FileReadAt(benchmark::State& state)
+{
+    const int64 size = state.range(0);
+    UniquePtr<IFileHandle> handle = FileSystem::OpenFile(GetBenchmarkFile(size), EFileAccess::Read);
+    Array64<uint8> buffer;
+    buffer.Resize(CHUNK_SIZE);
+    for (auto _ : state)
+    {
+        for (int64 offset = 0; offset < size; offset += CHUNK_SIZE)
+        {
+            handle->ReadAt(buffer.Data(), Math::Min(CHUNK_SIZE, size - offset), offset);
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * size);
+}
+
+static void BM_FileReader(benchmark::State& state)
+{
+    const int64 size = state.range(0);
+    const String& filePath = GetBenchmarkFile(size);
+    Array64<uint8> buffer;
+    buffer.Resize(CHUNK_SIZE);
+    for (auto _ : state)
+    {
+        FileReader reader(filePath);
+        while (reader.Read(buffer.Data(), CHUNK_SIZE) > 0)
+        {
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * size);
+}
+
+static void BM_FileReadToBinary(benchmark::State& state)
+{
+    const int64 size = state.range(0);
+    const String& filePath = GetBenchmarkFile(size);
+    for (auto _ : state)
+    {
+        Array64<uint8> binary;
+        FileSystem::ReadFileToBinary(filePath, binary);
+        benchmark::DoNotOptimize(binary.Data());
+    }
+    state.SetBytesProcessed(state.iterations() * size);
+}
+
+static void BM_FileMap(benchmark::State& state)
+{
+    const int64 size = state.range(0);
+    const String& filePath = GetBenchmarkFile(size);
+    for (auto _ : state)
+    {
+        UniquePtr<IMappedFileHandle> mapped = FileSystem::MapFile(filePath, 0, -1, EMappedAccessHint::Sequential);
+        // touch every page, mapping alone reads nothing
+        uint64 sum = 0;
+        const uint8* data = mapped->GetData();
+        for (int64 offset = 0; offset < mapped->GetSize(); offset += 4096)
+        {
+            sum += data[offset];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetBytesProcessed(state.iterations() * size);
+}
+
+/** whole file as a batch of chunk requests, it's how streaming issues reads */
+static void BM_FileAsyncRead(benchmark::State& state)
+{
+    const int64 size = state.range(0);
+    SharedPtr<AsyncReadFile> file = AsyncFileIO::OpenFile(GetBenchmarkFile(size));
+    Array64<uint8> buffer;
+    buffer.Resize(size);
+    for (auto _ : state)
+    {
+        Array<AsyncReadRequestPtr> requests;
+        for (int64 offset = 0; offset < size; offset += CHUNK_SIZE)
+        {
+            requests.Add(MakeShared<AsyncReadRequest>(file, offset, Math::Min(CHUNK_SIZE, size - offset), EAsyncIOPriority::Normal,
+                                                      buffer.Data() + offset));
+        }
+        AsyncFileIO::Submit(requests);
+        for (const AsyncReadRequestPtr& request : requests)
+        {
+            request->Wait();
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * size);
+    state.SetLabel(AsyncFileIO::GetBackendName());
+}
+
+#define FILE_BENCHMARK(name) BENCHMARK(name)->RangeMultiplier(16)->Range(64 << 10, 64 << 20)->UseRealTime()
+
+FILE_BENCHMARK(BM_FileReadAt);
+FILE_BENCHMARK(BM_FileReader);
+FILE_BENCHMARK(BM_FileReadToBinary);
+FILE_BENCHMARK(BM_FileMap);
+FILE_BENCHMARK(BM_FileAsyncRead);
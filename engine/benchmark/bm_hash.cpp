@@ -0,0 +1,105 @@
+#include "benchmark/benchmark.h"
+#include "foundation/string.hpp"
+#include "math/city_hash.hpp"
+#include "math/hash_helper.hpp"
+#include "misc/type_hash.hpp"
+#include <functional>
+#include <string_view>
+
+using namespace Engine;
+
+namespace
+{
+    Array<char> MakeHashInput(int64 size)
+    {
+        Array<char> data;
+        data.Reserve(static_cast<int32>(size));
+        for (int64 i = 0; i < size; i++)
+        {
+            data.Add(static_cast<char>('a' + i % 26));
+        }
+        return data;
+    }
+}
+
+static void BM_CityHash64(benchmark::State& state)
+{
+    const Array<char> data = MakeHashInput(state.range(0));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(CityHash::CityHash64(data.Data(), data.Size()));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_CityHash32(benchmark::State& state)
+{
+    const Array<char> data = MakeHashInput(state.range(0));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(CityHash::CityHash32(data.Data(), data.Size()));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_FnvHash(benchmark::State& state)
+{
+    const Array<char> data = MakeHashInput(state.range(0));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(HashHelper::FnvHash(data.Data(), data.Size()));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_Crc32c(benchmark::State& state)
+{
+    const Array<char> data = MakeHashInput(state.range(0));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(HashHelper::Crc32c(data.Data(), data.Size()));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_StdHash(benchmark::State& state)
+{
+    const Array<char> data = MakeHashInput(state.range(0));
+    const std::string_view view(data.Data(), data.Size());
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(std::hash<std::string_view>()(view));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_StringGetHashCode(benchmark::State& state)
+{
+    const Array<char> data = MakeHashInput(state.range(0));
+    const String str(data.Data(), data.Size());
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(str.GetHashCode());
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_IntegerGetHashCode(benchmark::State& state)
+{
+    uint64 value = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(GetHashCode(value++));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+#define HASH_BENCHMARK(name) BENCHMARK(name)->RangeMultiplier(4)->Range(4, 1 << 16)
+
+HASH_BENCHMARK(BM_CityHash64);
+HASH_BENCHMARK(BM_CityHash32);
+HASH_BENCHMARK(BM_FnvHash);
+HASH_BENCHMARK(BM_Crc32c);
+HASH_BENCHMARK(BM_StdHash);
+HASH_BENCHMARK(BM_StringGetHashCode);
+BENCHMARK(BM_IntegerGetHashCode);
@@ -0,0 +1,69 @@
+#include "benchmark/benchmark.h"
+#include "foundation/encoding.hpp"
+#include "file_system/file_system.hpp"
+#include "file_system/path.hpp"
+#include "memory/override_new_delete.hpp"
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace Engine;
+
+static const char* GetBuildConfig()
+{
+#if defined(DEBUG)
+    return "debug";
+#elif defined(DEVELOPMENT)
+    return "development";
+#elif defined(SHIPPING)
+    return "shipping";
+#else
+    return "unknown";
+#endif
+}
+
+/**
+ * Results are written as json to saved/benchmark/benchmark_result.json unless --benchmark_out is given,
+ * so every run leaves a baseline which later runs can be compared against.
+ */
+int main(int argc, char* argv[])
+{
+    SetupLocale();
+
+    bool hasOutput = false;
+    for (int index = 1; index < argc; ++index)
+    {
+        hasOutput |= std::strncmp(argv[index], "--benchmark_out=", 16) == 0;
+    }
+
+    std::string outArg;
+    std::string formatArg = "--benchmark_out_format=json";
+    std::vector<char*> args(argv, argv + argc);
+    if (!hasOutput)
+    {
+        const String outDir = Path::Combine(FileSystem::GetEngineSaveDir(), "benchmark");
+        FileSystem::MakeDirTree(outDir);
+        outArg = std::string("--benchmark_out=") + Path::Combine(outDir, "benchmark_result.json").Data();
+        args.push_back(outArg.data());
+        args.push_back(formatArg.data());
+    }
+    int argNum = static_cast<int>(args.size());
+
+    benchmark::Initialize(&argNum, args.data());
+    if (benchmark::ReportUnrecognizedArguments(argNum, args.data()))
+    {
+        return 1;
+    }
+
+    benchmark::AddCustomContext("build_config", GetBuildConfig());
+#if WITH_ISPC
+    benchmark::AddCustomContext("ispc", "on");
+#else
+    benchmark::AddCustomContext("ispc", "off");
+#endif
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    ShutdownLocale();
+    return 0;
+}
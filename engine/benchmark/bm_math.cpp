@@ -0,0 +1,491 @@
+#include "benchmark/benchmark.h"
+#include "foundation/array.hpp"
+#include "math/quaternion.hpp"
+#include "math/rotator.hpp"
+#include "math/matrix.hpp"
+#include "math/math_stream.hpp"
+#include "math/transform.hpp"
+
+using namespace Engine;
+
+namespace
+{
+    constexpr int32 STREAM_SIZE = 1024;
+
+    float RandomFloat(uint32& seed)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        return static_cast<float>(seed >> 8) / static_cast<float>(1 << 24) * 2.0f - 1.0f;
+    }
+
+    Quat RandomQuat(uint32& seed)
+    {
+        Quat quat(RandomFloat(seed), RandomFloat(seed), RandomFloat(seed), RandomFloat(seed) + 2.0f);
+        quat.Normalize();
+        return quat;
+    }
+
+    Vector3f RandomVector(uint32& seed)
+    {
+        return Vector3f(RandomFloat(seed), RandomFloat(seed), RandomFloat(seed));
+    }
+
+    void NormalizeScalar(float* sequence, int32 size)
+    {
+        float sizeSq = 0.0f;
+        for (int32 index = 0; index < size; ++index)
+        {
+            sizeSq += sequence[index] * sequence[index];
+        }
+        const float scale = 1.0f / Math::Sqrt(sizeSq);
+        for (int32 index = 0; index < size; ++index)
+        {
+            sequence[index] *= scale;
+        }
+    }
+
+    void CrossScalar(const float* a, const float* b, float* result)
+    {
+        result[0] = a[1] * b[2] - a[2] * b[1];
+        result[1] = a[2] * b[0] - a[0] * b[2];
+        result[2] = a[0] * b[1] - a[1] * b[0];
+    }
+}
+
+static void BM_RotatorToQuat(benchmark::State& state)
+{
+    Rotator rotator(10, 60, 10);
+    for (auto _ : state)
+    {
+        rotator.ToQuaternion();
+    }
+}
+
+static void BM_VectorCross(benchmark::State& state)
+{
+    Vector3f vec(5, 6.2, 7.1);
+    for (auto _ : state)
+    {
+        Vector3f::Cross(vec, vec);
+    }
+}
+
+static void BM_QuatNormalize(benchmark::State& state)
+{
+    Quat quat({5, 4, 3, 1});
+    for (auto _ : state)
+    {
+        quat.Normalize();
+    }
+}
+
+static void BM_QuatMultiply(benchmark::State& state)
+{
+    uint32 seed = 1;
+    Array<Quat> quats;
+    for (int32 i = 0; i < STREAM_SIZE; i++)
+    {
+        quats.Add(RandomQuat(seed));
+    }
+
+    for (auto _ : state)
+    {
+        Quat result(0, 0, 0, 1);
+        for (const Quat& quat : quats)
+        {
+            result = result * quat;
+        }
+        benchmark::DoNotOptimize(result);
+    }
+    state.SetItemsProcessed(state.iterations() * STREAM_SIZE);
+}
+
+static void BM_QuatRotateVector(benchmark::State& state)
+{
+    uint32 seed = 2;
+    Array<Quat> quats;
+    Array<Vector3f> vectors;
+    for (int32 i = 0; i < STREAM_SIZE; i++)
+    {
+        quats.Add(RandomQuat(seed));
+        vectors.Add(RandomVector(seed));
+    }
+
+    for (auto _ : state)
+    {
+        for (int32 i = 0; i < STREAM_SIZE; i++)
+        {
+            benchmark::DoNotOptimize(quats[i].RotateVector(vectors[i]));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * STREAM_SIZE);
+}
+
+static void BM_QuatSlerp(benchmark::State& state)
+{
+    uint32 seed = 3;
+    const Quat src = RandomQuat(seed);
+    const Quat dest = RandomQuat(seed);
+    float alpha = 0.0f;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(Quat::Slerp(src, dest, alpha));
+        alpha = alpha < 1.0f ? alpha + 0.001f : 0.0f;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_MatrixMultiply(benchmark::State& state)
+{
+    uint32 seed = 4;
+    Array<Matrix> matrices;
+    for (int32 i = 0; i < STREAM_SIZE; i++)
+    {
+        Matrix matrix;
+        for (int32 row = 0; row < 4; row++)
+        {
+            for (int32 column = 0; column < 4; column++)
+            {
+                matrix.At(row, column) = RandomFloat(seed);
+            }
+        }
+        matrices.Add(matrix);
+    }
+
+    Matrix result;
+    for (auto _ : state)
+    {
+        for (int32 i = 1; i < STREAM_SIZE; i++)
+        {
+            Matrix::Multiply(matrices[i - 1], matrices[i], result);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * (STREAM_SIZE - 1));
+}
+
+static void BM_TransformMultiply(benchmark::State& state)
+{
+    uint32 seed = 5;
+    Array<Transform> transforms;
+    for (int32 i = 0; i < STREAM_SIZE; i++)
+    {
+        transforms.Add(Transform(RandomQuat(seed), RandomVector(seed), Vector3f(1.0f, 1.0f, 1.0f)));
+    }
+
+    Transform result;
+    for (auto _ : state)
+    {
+        for (int32 i = 1; i < STREAM_SIZE; i++)
+        {
+            Transform::Multiply(transforms[i - 1], transforms[i], result);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * (STREAM_SIZE - 1));
+}
+
+static void BM_MatrixInverse(benchmark::State& state)
+{
+    uint32 seed = 4;
+    Array<Matrix> matrices;
+    for (int32 i = 0; i < STREAM_SIZE; i++)
+    {
+        Matrix matrix;
+        for (int32 row = 0; row < 4; row++)
+        {
+            for (int32 column = 0; column < 4; column++)
+            {
+                matrix.At(row, column) = RandomFloat(seed) + (row == column ? 4.0f : 0.0f);
+            }
+        }
+        matrices.Add(matrix);
+    }
+
+    for (auto _ : state)
+    {
+        for (int32 i = 0; i < STREAM_SIZE; i++)
+        {
+            benchmark::DoNotOptimize(matrices[i].Inverse());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * STREAM_SIZE);
+}
+
+static void BM_TransformPosition(benchmark::State& state)
+{
+    uint32 seed = 5;
+    Array<Transform> transforms;
+    Array<Vector3f> positions;
+    for (int32 i = 0; i < STREAM_SIZE; i++)
+    {
+        transforms.Add(Transform(RandomQuat(seed), RandomVector(seed), Vector3f(1.0f, 2.0f, 1.0f)));
+        positions.Add(RandomVector(seed));
+    }
+
+    for (auto _ : state)
+    {
+        for (int32 i = 0; i < STREAM_SIZE; i++)
+        {
+            benchmark::DoNotOptimize(transforms[i].TransformPosition(positions[i]));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * STREAM_SIZE);
+}
+
+/** normalize range(0) component vectors, scalar loop is the baseline of ispc kernel below */
+static void BM_NormalizeScalar(benchmark::State& state)
+{
+    const int32 size = static_cast<int32>(state.range(0));
+    uint32 seed = 6;
+    Array<float> data;
+    for (int32 i = 0; i < STREAM_SIZE * size; i++)
+    {
+        data.Add(RandomFloat(seed) + 2.0f);
+    }
+
+    for (auto _ : state)
+    {
+        for (int32 i = 0; i < STREAM_SIZE; i++)
+        {
+            NormalizeScalar(data.Data() + i * size, size);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * STREAM_SIZE);
+}
+
+static void BM_CrossScalar(benchmark::State& state)
+{
+    uint32 seed = 7;
+    Array<float> data;
+    for (int32 i = 0; i < STREAM_SIZE * 3; i++)
+    {
+        data.Add(RandomFloat(seed));
+    }
+
+    float result[3];
+    for (auto _ : state)
+    {
+        for (int32 i = 1; i < STREAM_SIZE; i++)
+        {
+            CrossScalar(data.Data() + (i - 1) * 3, data.Data() + i * 3, result);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * (STREAM_SIZE - 1));
+}
+
+/**
+ * Batch kernels of MathStream, range(0) is the backend and range(1) the number of elements.
+ * Backends the cpu doesn't support are skipped, previous backend is restored when the benchmark ends.
+ */
+struct StreamBackendScope
+{
+    explicit StreamBackendScope(benchmark::State& state)
+        : PrevBackend(MathStream::GetBackend())
+    {
+        const auto backend = static_cast<EMathStreamBackend>(state.range(0));
+        Supported = MathStream::SetBackend(backend);
+        if (Supported)
+        {
+            state.SetLabel(MathStream::GetBackendName(backend));
+        }
+        else
+        {
+            state.SkipWithError("backend isn't supported");
+        }
+    }
+
+    ~StreamBackendScope()
+    {
+        MathStream::SetBackend(PrevBackend);
+    }
+
+    EMathStreamBackend PrevBackend;
+    bool Supported{ false };
+};
+
+static void BM_TransformStreamMultiply(benchmark::State& state)
+{
+    StreamBackendScope scope(state);
+    if (!scope.Supported)
+    {
+        return;
+    }
+
+    const int32 num = static_cast<int32>(state.range(1));
+    uint32 seed = 5;
+    TransformStream a;
+    TransformStream b;
+    for (int32 i = 0; i < num; i++)
+    {
+        a.Add(Transform(RandomQuat(seed), RandomVector(seed), Vector3f(1.0f, 1.0f, 1.0f)));
+        b.Add(Transform(RandomQuat(seed), RandomVector(seed), Vector3f(1.0f, 1.0f, 1.0f)));
+    }
+
+    TransformStream result;
+    for (auto _ : state)
+    {
+        MathStream::Multiply(a, b, result);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * num);
+}
+
+static void BM_QuatStreamSlerp(benchmark::State& state)
+{
+    StreamBackendScope scope(state);
+    if (!scope.Supported)
+    {
+        return;
+    }
+
+    const int32 num = static_cast<int32>(state.range(1));
+    uint32 seed = 3;
+    QuatStream src;
+    QuatStream dest;
+    for (int32 i = 0; i < num; i++)
+    {
+        src.Add(RandomQuat(seed));
+        dest.Add(RandomQuat(seed));
+    }
+
+    QuatStream result;
+    for (auto _ : state)
+    {
+        MathStream::Slerp(src, dest, 0.3f, result);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * num);
+}
+
+static void BM_QuatStreamRotateVector(benchmark::State& state)
+{
+    StreamBackendScope scope(state);
+    if (!scope.Supported)
+    {
+        return;
+    }
+
+    const int32 num = static_cast<int32>(state.range(1));
+    uint32 seed = 2;
+    QuatStream quats;
+    Vector3Stream vectors;
+    for (int32 i = 0; i < num; i++)
+    {
+        quats.Add(RandomQuat(seed));
+        vectors.Add(RandomVector(seed));
+    }
+
+    Vector3Stream result;
+    for (auto _ : state)
+    {
+        MathStream::RotateVector(quats, vectors, result);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * num);
+}
+
+static void BM_Vector3StreamNormalize(benchmark::State& state)
+{
+    StreamBackendScope scope(state);
+    if (!scope.Supported)
+    {
+        return;
+    }
+
+    const int32 num = static_cast<int32>(state.range(1));
+    uint32 seed = 6;
+    Vector3Stream vectors;
+    for (int32 i = 0; i < num; i++)
+    {
+        vectors.Add(RandomVector(seed) + Vector3f(2.0f, 2.0f, 2.0f));
+    }
+
+    for (auto _ : state)
+    {
+        MathStream::Normalize(vectors);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * num);
+}
+
+static void StreamArguments(benchmark::internal::Benchmark* benchmark)
+{
+    for (EMathStreamBackend backend : { EMathStreamBackend::Scalar, EMathStreamBackend::Sse, EMathStreamBackend::Avx2, EMathStreamBackend::Avx512, EMathStreamBackend::Ispc })
+    {
+        for (int64 num : { 1024, 100000 })
+        {
+            benchmark->Args({ static_cast<int64>(backend), num });
+        }
+    }
+}
+
+#if WITH_ISPC
+static void BM_NormalizeIspc(benchmark::State& state)
+{
+    const int32 size = static_cast<int32>(state.range(0));
+    uint32 seed = 6;
+    Array<float> data;
+    for (int32 i = 0; i < STREAM_SIZE * size; i++)
+    {
+        data.Add(RandomFloat(seed) + 2.0f);
+    }
+
+    for (auto _ : state)
+    {
+        for (int32 i = 0; i < STREAM_SIZE; i++)
+        {
+            ispc::FloatNormalizeFast(data.Data() + i * size, size);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * STREAM_SIZE);
+}
+
+static void BM_CrossIspc(benchmark::State& state)
+{
+    uint32 seed = 7;
+    Array<float> data;
+    for (int32 i = 0; i < STREAM_SIZE * 3; i++)
+    {
+        data.Add(RandomFloat(seed));
+    }
+
+    float result[3];
+    for (auto _ : state)
+    {
+        for (int32 i = 1; i < STREAM_SIZE; i++)
+        {
+            ispc::CrossProduct(data.Data() + (i - 1) * 3, data.Data() + i * 3, result);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * (STREAM_SIZE - 1));
+}
+#endif
+
+BENCHMARK(BM_RotatorToQuat);
+BENCHMARK(BM_VectorCross);
+BENCHMARK(BM_QuatNormalize);
+
+BENCHMARK(BM_QuatMultiply);
+BENCHMARK(BM_QuatRotateVector);
+BENCHMARK(BM_QuatSlerp);
+BENCHMARK(BM_MatrixMultiply);
+BENCHMARK(BM_TransformMultiply);
+BENCHMARK(BM_MatrixInverse);
+BENCHMARK(BM_TransformPosition);
+
+BENCHMARK(BM_NormalizeScalar)->Arg(3)->Arg(4)->Arg(16);
+BENCHMARK(BM_CrossScalar);
+#if WITH_ISPC
+BENCHMARK(BM_NormalizeIspc)->Arg(3)->Arg(4)->Arg(16);
+BENCHMARK(BM_CrossIspc);
+#endif
+
+BENCHMARK(BM_TransformStreamMultiply)->Apply(StreamArguments);
+BENCHMARK(BM_QuatStreamSlerp)->Apply(StreamArguments);
+BENCHMARK(BM_QuatStreamRotateVector)->Apply(StreamArguments);
+BENCHMARK(BM_Vector3StreamNormalize)->Apply(StreamArguments);
\ No newline at end of file
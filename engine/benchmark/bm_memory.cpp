@@ -0,0 +1,95 @@
+#include "benchmark/benchmark.h"
+#include "memory/memory.hpp"
+#include "memory/ansi_c_malloc.hpp"
+#include "memory/object_pool.hpp"
+#include <cstdlib>
+
+using namespace Engine;
+
+namespace
+{
+    constexpr int32 BATCH_NUM = 256;
+
+    /** sizes between 16 and range(0) bytes, same sequence for every allocator */
+    size_t GetAllocationSize(int32 index, int64 maxSize)
+    {
+        const uint32 hash = static_cast<uint32>(index) * 2654435761u;
+        return 16 + static_cast<size_t>(hash % static_cast<uint32>(maxSize - 15));
+    }
+
+    /** allocate a batch then free it, so allocator works with live blocks rather than reusing the last one */
+    template <typename AllocFun, typename FreeFun>
+    void RunAllocationBatches(benchmark::State& state, AllocFun&& allocFun, FreeFun&& freeFun)
+    {
+        void* ptrs[BATCH_NUM];
+        int32 seed = state.thread_index() * BATCH_NUM;
+        for (auto _ : state)
+        {
+            for (int32 i = 0; i < BATCH_NUM; i++)
+            {
+                ptrs[i] = allocFun(GetAllocationSize(seed + i, state.range(0)));
+            }
+            for (int32 i = 0; i < BATCH_NUM; i++)
+            {
+                freeFun(ptrs[i]);
+            }
+            seed += BATCH_NUM;
+        }
+        state.SetItemsProcessed(state.iterations() * BATCH_NUM);
+    }
+}
+
+static void BM_MemoryMalloc(benchmark::State& state)
+{
+    RunAllocationBatches(state, [](size_t size) { return Memory::Malloc(size); }, [](void* ptr) { Memory::Free(ptr); });
+}
+
+static void BM_AnsiCMalloc(benchmark::State& state)
+{
+    static AnsiCMalloc* ansi = new AnsiCMalloc();
+    RunAllocationBatches(state, [](size_t size) { return ansi->Malloc(size, 16); }, [](void* ptr) { ansi->Free(ptr); });
+}
+
+static void BM_StdMalloc(benchmark::State& state)
+{
+    RunAllocationBatches(state, [](size_t size) { return std::malloc(size); }, [](void* ptr) { std::free(ptr); });
+}
+
+static void BM_SmallObjectPool(benchmark::State& state)
+{
+    const size_t size = static_cast<size_t>(state.range(0));
+    void* ptrs[BATCH_NUM];
+    for (auto _ : state)
+    {
+        for (int32 i = 0; i < BATCH_NUM; i++)
+        {
+            ptrs[i] = SmallObjectPool::Allocate(size);
+        }
+        for (int32 i = 0; i < BATCH_NUM; i++)
+        {
+            SmallObjectPool::Free(ptrs[i], size);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * BATCH_NUM);
+}
+
+static void BM_MemoryRealloc(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        void* ptr = nullptr;
+        for (size_t size = 16; size <= static_cast<size_t>(state.range(0)); size *= 2)
+        {
+            ptr = Memory::Realloc(ptr, size);
+        }
+        Memory::Free(ptr);
+    }
+}
+
+#define ALLOCATOR_BENCHMARK(name) BENCHMARK(name)->RangeMultiplier(16)->Range(64, 1 << 16)->ThreadRange(1, 8)->UseRealTime()
+
+ALLOCATOR_BENCHMARK(BM_MemoryMalloc);
+ALLOCATOR_BENCHMARK(BM_AnsiCMalloc);
+ALLOCATOR_BENCHMARK(BM_StdMalloc);
+BENCHMARK(BM_SmallObjectPool)->RangeMultiplier(4)->Range(16, 256)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_MemoryRealloc)->RangeMultiplier(16)->Range(256, 1 << 20);
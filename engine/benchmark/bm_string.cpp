@@ -0,0 +1,215 @@
+#include "benchmark/benchmark.h"
+#include "foundation/string.hpp"
+#include "foundation/string_id.hpp"
+#include <atomic>
+#include <string>
+
+using namespace Engine;
+
+/** comma separated words, eg: "word0,word1,..." */
+static String MakeWordList(int32 num)
+{
+    String str;
+    for (int32 i = 0; i < num; i++)
+    {
+        if (i > 0)
+        {
+            str.Append(',');
+        }
+        str.Append(String::Format("word{0}", i));
+    }
+    return str;
+}
+
+static void BM_StringIndexOf(benchmark::State& state)
+{
+    const String str = MakeWordList(static_cast<int32>(state.range(0)));
+    const String needle = String::Format("word{0}", state.range(0) - 1);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(str.IndexOf(needle));
+    }
+    state.SetBytesProcessed(state.iterations() * str.Length());
+}
+
+static void BM_StdStringFind(benchmark::State& state)
+{
+    const String words = MakeWordList(static_cast<int32>(state.range(0)));
+    const std::string str(words.Data(), words.Length());
+    const std::string needle = "word" + std::to_string(state.range(0) - 1);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(str.find(needle));
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64>(str.length()));
+}
+
+static void BM_StringIndexOfCaseInsensitive(benchmark::State& state)
+{
+    const String str = MakeWordList(static_cast<int32>(state.range(0)));
+    const String needle = String::Format("WORD{0}", state.range(0) - 1);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(str.IndexOf(needle, CaseInsensitive));
+    }
+    state.SetBytesProcessed(state.iterations() * str.Length());
+}
+
+static void BM_StringSplit(benchmark::State& state)
+{
+    const String str = MakeWordList(static_cast<int32>(state.range(0)));
+    for (auto _ : state)
+    {
+        Array<String> parts = str.Split(',');
+        benchmark::DoNotOptimize(parts.Size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_StringReplace(benchmark::State& state)
+{
+    const String str = MakeWordList(static_cast<int32>(state.range(0)));
+    for (auto _ : state)
+    {
+        String copy = str;
+        copy.Replace("word", "token");
+        benchmark::DoNotOptimize(copy.Length());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_StringFormat(benchmark::State& state)
+{
+    int32 index = 0;
+    for (auto _ : state)
+    {
+        String str = String::Format("{0}/{1}_{2}.{3:.2f}", "content", "mesh", ++index, 0.5f);
+        benchmark::DoNotOptimize(str.Length());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_StringAppend(benchmark::State& state)
+{
+    const int32 num = static_cast<int32>(state.range(0));
+    for (auto _ : state)
+    {
+        String str;
+        for (int32 i = 0; i < num; i++)
+        {
+            str.Append("abc");
+        }
+        benchmark::DoNotOptimize(str.Length());
+    }
+    state.SetItemsProcessed(state.iterations() * num);
+}
+
+/** terminator lookup of c string, goes through simd string kernels */
+static void BM_StringLength(benchmark::State& state)
+{
+    const String str = MakeWordList(static_cast<int32>(state.range(0)));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(CharTraits<char>::Length(str.Data()));
+    }
+    state.SetBytesProcessed(state.iterations() * str.Length());
+}
+
+static void BM_StringCompare(benchmark::State& state)
+{
+    const String lhs = MakeWordList(static_cast<int32>(state.range(0)));
+    const String rhs = MakeWordList(static_cast<int32>(state.range(0)));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(lhs == rhs);
+    }
+    state.SetBytesProcessed(state.iterations() * lhs.Length());
+}
+
+/** names already stored in pool, it's the common case of looking up assets and properties */
+static void BM_StringIDFind(benchmark::State& state)
+{
+    constexpr int32 NAME_NUM = 1024;
+    static Array<String>* names = []() {
+        auto* result = new Array<String>();
+        for (int32 i = 0; i < NAME_NUM; i++)
+        {
+            result->Add(String::Format("BenchmarkName{0}", i));
+            StringID id(result->Last());
+        }
+        return result;
+    }();
+
+    int32 index = state.thread_index();
+    for (auto _ : state)
+    {
+        StringID id((*names)[index & (NAME_NUM - 1)]);
+        benchmark::DoNotOptimize(id);
+        ++index;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+/** every id is new, entry pool is written by all threads */
+static void BM_StringIDCreate(benchmark::State& state)
+{
+    constexpr int32 BATCH_SIZE = 4096;
+    static std::atomic<int32> counter{ 0 };
+    Array<String> names;
+    int32 index = BATCH_SIZE;
+    for (auto _ : state)
+    {
+        if (index == BATCH_SIZE)
+        {
+            state.PauseTiming();
+            names.Clear();
+            const int32 start = counter.fetch_add(BATCH_SIZE, std::memory_order_relaxed);
+            for (int32 i = 0; i < BATCH_SIZE; i++)
+            {
+                names.Add(String::Format("UniqueName{0}", start + i));
+            }
+            index = 0;
+            state.ResumeTiming();
+        }
+        StringID id(names[index++]);
+        benchmark::DoNotOptimize(id);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_StringIDCompare(benchmark::State& state)
+{
+    const StringID lhs("BenchmarkCompare");
+    const StringID rhs("BenchmarkCompare");
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(lhs == rhs);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_StringIDToString(benchmark::State& state)
+{
+    const StringID id("BenchmarkToString_12");
+    for (auto _ : state)
+    {
+        String str = id.ToString();
+        benchmark::DoNotOptimize(str.Length());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_StringIndexOf)->RangeMultiplier(8)->Range(8, 1 << 12);
+BENCHMARK(BM_StdStringFind)->RangeMultiplier(8)->Range(8, 1 << 12);
+BENCHMARK(BM_StringIndexOfCaseInsensitive)->RangeMultiplier(8)->Range(8, 1 << 12);
+BENCHMARK(BM_StringSplit)->RangeMultiplier(8)->Range(8, 1 << 12);
+BENCHMARK(BM_StringReplace)->RangeMultiplier(8)->Range(8, 1 << 12);
+BENCHMARK(BM_StringFormat);
+BENCHMARK(BM_StringAppend)->RangeMultiplier(8)->Range(8, 1 << 12);
+BENCHMARK(BM_StringLength)->RangeMultiplier(8)->Range(8, 1 << 12);
+BENCHMARK(BM_StringCompare)->RangeMultiplier(8)->Range(8, 1 << 12);
+
+BENCHMARK(BM_StringIDFind)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_StringIDCreate)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_StringIDCompare);
+BENCHMARK(BM_StringIDToString);
@@ -0,0 +1,138 @@
+#include "benchmark/benchmark.h"
+#include "taskflow.hpp"
+#include <algorithm>
+#include <thread>
+
+using namespace Engine;
+
+namespace
+{
+    /** fixed amount of work, so scaling isn't hidden by dispatch overhead */
+    struct SpinTask
+    {
+        void operator()()
+        {
+            uint32 value = 1;
+            for (int32 i = 0; i < 1000; i++)
+            {
+                value = value * 1664525u + 1013904223u;
+            }
+            benchmark::DoNotOptimize(value);
+        }
+    };
+
+    struct EmptyTask
+    {
+        void operator()() {}
+    };
+}
+
+/** one empty task, round trip of Execute and Wait */
+static void BM_TaskflowLatency(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        Taskflow taskflow;
+        taskflow.Add<EmptyTask>();
+        taskflow.Execute();
+        taskflow.Wait();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+/** dependent tasks run one after another, time per item is the cost of a hop between workers */
+static void BM_TaskflowChainLatency(benchmark::State& state)
+{
+    const int32 num = static_cast<int32>(state.range(0));
+    for (auto _ : state)
+    {
+        Taskflow taskflow;
+        GraphTaskBase* last = nullptr;
+        for (int32 i = 0; i < num; i++)
+        {
+            GraphTaskBase& task = taskflow.Add<EmptyTask>();
+            if (last != nullptr)
+            {
+                *last > task;
+            }
+            last = &task;
+        }
+        taskflow.Execute();
+        taskflow.Wait();
+    }
+    state.SetItemsProcessed(state.iterations() * num);
+}
+
+/** independent empty tasks, measures dispatch throughput */
+static void BM_TaskflowThroughput(benchmark::State& state)
+{
+    const int32 num = static_cast<int32>(state.range(0));
+    for (auto _ : state)
+    {
+        Taskflow taskflow;
+        for (int32 i = 0; i < num; i++)
+        {
+            taskflow.Add<EmptyTask>();
+        }
+        taskflow.Execute();
+        taskflow.Wait();
+    }
+    state.SetItemsProcessed(state.iterations() * num);
+}
+
+/**
+ * Same amount of work split into range(0) parallel chains, worker pool is sized by hardware concurrency,
+ * so time should drop until chains exceed workers.
+ */
+static void BM_TaskflowParallelChains(benchmark::State& state)
+{
+    constexpr int32 TASK_NUM = 256;
+    const int32 width = static_cast<int32>(state.range(0));
+    for (auto _ : state)
+    {
+        Taskflow taskflow;
+        Array<GraphTaskBase*> lasts;
+        lasts.Resize(width, nullptr);
+        for (int32 i = 0; i < TASK_NUM; i++)
+        {
+            GraphTaskBase& task = taskflow.Add<SpinTask>();
+            GraphTaskBase*& last = lasts[i % width];
+            if (last != nullptr)
+            {
+                *last > task;
+            }
+            last = &task;
+        }
+        taskflow.Execute();
+        taskflow.Wait();
+    }
+    state.SetItemsProcessed(state.iterations() * TASK_NUM);
+}
+
+/** several threads submit taskflows at the same time, eg: systems of a frame kicking off their jobs */
+static void BM_TaskflowConcurrentSubmit(benchmark::State& state)
+{
+    constexpr int32 TASK_NUM = 64;
+    for (auto _ : state)
+    {
+        Taskflow taskflow;
+        for (int32 i = 0; i < TASK_NUM; i++)
+        {
+            taskflow.Add<SpinTask>();
+        }
+        taskflow.Execute();
+        taskflow.Wait();
+    }
+    state.SetItemsProcessed(state.iterations() * TASK_NUM);
+}
+
+static int32 GetMaxBenchmarkThreads()
+{
+    return static_cast<int32>(std::max(2u, std::thread::hardware_concurrency()));
+}
+
+BENCHMARK(BM_TaskflowLatency)->UseRealTime();
+BENCHMARK(BM_TaskflowChainLatency)->RangeMultiplier(4)->Range(4, 256)->UseRealTime();
+BENCHMARK(BM_TaskflowThroughput)->RangeMultiplier(4)->Range(16, 4096)->UseRealTime();
+BENCHMARK(BM_TaskflowParallelChains)->DenseRange(1, 4)->Arg(8)->Arg(16)->UseRealTime();
+BENCHMARK(BM_TaskflowConcurrentSubmit)->ThreadRange(1, GetMaxBenchmarkThreads())->UseRealTime();
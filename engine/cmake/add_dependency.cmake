@@ -1,6 +1,10 @@
 
 function(add_3rd_dependency target package_name )
-    set(platform_folder "win")
+    if(WIN32)
+        set(platform_folder "win")
+    else()
+        set(platform_folder "linux")
+    endif()
 
     set(package_root ${CMAKE_SOURCE_DIR}/third_parties/${package_name}/)
 
@@ -11,6 +15,10 @@ function(add_3rd_dependency target package_name )
     endif()
 
     set (platform_package_root ${CMAKE_SOURCE_DIR}/third_parties/${package_name}/${platform_folder})
+    if (NOT EXISTS ${platform_package_root})
+        message(FATAL_ERROR "Can't find ${platform_folder} package of ${package_name} by ${platform_package_root}")
+        return()
+    endif()
 
     set(package_link_root ${platform_package_root})
     if(${CMAKE_BUILD_TYPE} MATCHES "Debug")
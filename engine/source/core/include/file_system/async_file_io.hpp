@@ -0,0 +1,178 @@
+#pragma once
+
+#include <atomic>
+#include "global.hpp"
+#include "definitions_core.hpp"
+#include "foundation/array.hpp"
+#include "foundation/delegate.hpp"
+#include "foundation/smart_ptr.hpp"
+#include "foundation/string.hpp"
+
+namespace Engine
+{
+    enum class EAsyncIOPriority : uint32
+    {
+        Low,
+        Normal,
+        High,
+        Critical,
+        Count
+    };
+
+    enum class EAsyncIOStatus : uint32
+    {
+        Pending,
+        Reading,
+        Completed,
+        Failed,
+        Cancelled
+    };
+
+    /** file opened for async reading, it's closed after the last request which references it finished */
+    class CORE_API AsyncReadFile
+    {
+    public:
+        AsyncReadFile(intptr nativeHandle, int64 size) : NativeHandle(nativeHandle), Size(size) {}
+
+        ~AsyncReadFile();
+
+        AsyncReadFile(const AsyncReadFile& other) = delete;
+
+        AsyncReadFile& operator= (const AsyncReadFile& other) = delete;
+
+        /** HANDLE on windows, file descriptor on linux */
+        intptr GetNativeHandle() const { return NativeHandle; }
+
+        int64 GetSize() const { return Size; }
+
+    private:
+        intptr NativeHandle;
+        int64 Size;
+    };
+
+    class AsyncReadRequest;
+
+    /** executed on an io thread, keep it short or hand the work over to a task */
+    DECLARE_DELEGATE_ONE_PARAM(AsyncReadCompleted, AsyncReadRequest&);
+
+    class CORE_API AsyncReadRequest
+    {
+        friend class AsyncFileIO;
+    public:
+        /**
+         * @param dest buffer to read into, must hold size bytes. Request allocates and owns a buffer if it's nullptr
+         */
+        AsyncReadRequest(SharedPtr<AsyncReadFile> file, int64 offset, int64 size,
+                         EAsyncIOPriority priority = EAsyncIOPriority::Normal, uint8* dest = nullptr);
+
+        ~AsyncReadRequest();
+
+        AsyncReadRequest(const AsyncReadRequest& other) = delete;
+
+        AsyncReadRequest& operator= (const AsyncReadRequest& other) = delete;
+
+        const SharedPtr<AsyncReadFile>& GetFile() const { return File; }
+
+        int64 GetOffset() const { return Offset; }
+
+        int64 GetSize() const { return Size; }
+
+        EAsyncIOPriority GetPriority() const { return Priority; }
+
+        EAsyncIOStatus GetStatus() const { return Status.load(std::memory_order_acquire); }
+
+        /** less than size if the end of file is reached */
+        int64 GetBytesRead() const { return BytesRead; }
+
+        uint8* GetData() const { return Dest; }
+
+        /** take over the buffer allocated by request, it must be released by Memory::Free */
+        uint8* ReleaseData();
+
+        /**
+         * Cancel request which hasn't been picked by an io thread, completion callback is executed on calling thread.
+         * @return false if request is already reading or finished
+         */
+        bool Cancel();
+
+        /** block until request is finished and completion callback returned */
+        void Wait() const;
+
+        bool IsFinished() const { return Finished.load(std::memory_order_acquire); }
+
+        /** bind before submitting */
+        AsyncReadCompleted OnCompleted;
+
+        /** used by backends only: Pending -> Reading, false if request has been cancelled */
+        bool TryStart();
+
+        /** used by backends only: Reading -> Completed or Failed */
+        void Finish(int64 bytesRead, bool succeeded);
+
+    private:
+        void NotifyFinished();
+
+        SharedPtr<AsyncReadFile> File;
+        int64 Offset;
+        int64 Size;
+        int64 BytesRead{ 0 };
+        uint8* Dest;
+        bool OwnsBuffer;
+        EAsyncIOPriority Priority;
+        std::atomic<EAsyncIOStatus> Status{ EAsyncIOStatus::Pending };
+        std::atomic<bool> Finished{ false };
+    };
+
+    using AsyncReadRequestPtr = SharedPtr<AsyncReadRequest>;
+
+    class CORE_API IAsyncIOBackend
+    {
+    public:
+        virtual ~IAsyncIOBackend() = default;
+
+        /** queue requests at once, higher priority requests are issued first */
+        virtual void Submit(const AsyncReadRequestPtr* requests, int32 count) = 0;
+
+        virtual const char* GetName() const = 0;
+    };
+
+    /**
+     * Entry of asynchronous file reading. Requests are served by io_uring on linux when it's available,
+     * otherwise by a group of io threads issuing blocking positional reads.
+     */
+    class CORE_API AsyncFileIO
+    {
+    public:
+        /**
+         * Create backend explicitly, it's created with default settings on first use otherwise.
+         * @param allowNativeBackend false to always use io threads
+         * @param threadNum io thread number of thread backend, 0 means decided by hardware concurrency
+         */
+        static void Initialize(bool allowNativeBackend = true, int32 threadNum = 0);
+
+        /** cancel pending requests and wait for in flight requests */
+        static void Shutdown();
+
+        static const char* GetBackendName();
+
+        /** @return nullptr if failed */
+        static SharedPtr<AsyncReadFile> OpenFile(const String& filePath);
+
+        /**
+         * Read a region of file asynchronously.
+         * @param size negative means until the end of file
+         * @param dest buffer to read into, request allocates one if it's nullptr
+         */
+        static AsyncReadRequestPtr Read(const SharedPtr<AsyncReadFile>& file, int64 offset, int64 size,
+                                        EAsyncIOPriority priority = EAsyncIOPriority::Normal,
+                                        AsyncReadCompleted&& onCompleted = AsyncReadCompleted(), uint8* dest = nullptr);
+
+        /** submit a batch of requests with one queue operation, prefer it when streaming many small chunks */
+        static void Submit(const Array<AsyncReadRequestPtr>& requests);
+
+        static void Submit(const AsyncReadRequestPtr& request);
+
+        /** used by backends: blocking read at offset without touching any file pointer, -1 if failed */
+        static int64 ReadAt(intptr nativeHandle, uint8* dest, int64 offset, int64 size);
+    };
+}
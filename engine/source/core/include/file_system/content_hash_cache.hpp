@@ -0,0 +1,110 @@
+#pragma once
+
+#include <mutex>
+#include "global.hpp"
+#include "definitions_core.hpp"
+#include "foundation/array.hpp"
+#include "foundation/map.hpp"
+#include "foundation/string.hpp"
+
+namespace Engine
+{
+    /** 128 bits CityHash of whole file content */
+    struct ContentHash
+    {
+        uint64 Low{ 0 };
+        uint64 High{ 0 };
+
+        friend bool operator== (const ContentHash& lhs, const ContentHash& rhs) { return lhs.Low == rhs.Low && lhs.High == rhs.High; }
+
+        friend bool operator!= (const ContentHash& lhs, const ContentHash& rhs) { return !(lhs == rhs); }
+    };
+
+    /**
+     * On-disk cache of file content hashes keyed by path, size and modify time, so a file which didn't change since
+     * last run is recognized by stat calls only. Artifacts derived from content, eg: compiled shaders, can be kept
+     * with the record and are dropped together once file changes.
+     * Times are kept in milliseconds. Modify time is only as precise as file system keeps it, so a file hashed within
+     * 2 seconds after its modify time is hashed again next time, as it may still be changed without changing modify time.
+     * All functions are thread safe.
+     */
+    class CORE_API ContentHashCache
+    {
+    public:
+        static constexpr uint32 MAGIC = 0x43484350;
+        static constexpr uint32 VERSION = 2;
+
+        /** @param cacheFile records are loaded from it if it exists and is valid */
+        explicit ContentHashCache(const String& cacheFile);
+
+        /** unsaved records are written into cache file */
+        ~ContentHashCache();
+
+        ContentHashCache(const ContentHashCache& other) = delete;
+
+        ContentHashCache& operator= (const ContentHashCache& other) = delete;
+
+        /** read and hash whole file without touching any cache */
+        static bool HashFile(const String& path, ContentHash& outHash);
+
+        /** true if file has a record and its size and modify time still match, file isn't read */
+        bool IsUnchanged(const String& path) const;
+
+        /**
+         * Get hash from record if file is unchanged, otherwise read and hash file and update record.
+         * @return false if file can't be read
+         */
+        bool GetHash(const String& path, ContentHash& outHash);
+
+        /**
+         * Keep artifact with record of file, it's ignored if file content isn't the one it's derived from.
+         * @param sourceHash hash of the content artifact is derived from, see GetHash
+         */
+        bool SetArtifact(const String& path, const ContentHash& sourceHash, const String& name, Array<uint8>&& data);
+
+        /** @return false if there is no such artifact or file is changed */
+        bool FindArtifact(const String& path, const String& name, Array<uint8>& outData) const;
+
+        void Remove(const String& path);
+
+        void Clear();
+
+        int32 GetRecordNum() const;
+
+        /** write records into cache file if anything changed, cache file is replaced only after writing succeeded */
+        bool Save();
+
+    private:
+        struct Record
+        {
+            int64 Size{ 0 };
+            /** milliseconds since epoch */
+            uint64 ModifyTime{ 0 };
+            /** milliseconds since epoch before file is read, record is trusted only if file is modified well before it */
+            uint64 HashTime{ 0 };
+            ContentHash Hash;
+            Map<String, Array<uint8>> Artifacts;
+        };
+
+        struct FileState
+        {
+            int64 Size{ -1 };
+            /** milliseconds since epoch */
+            uint64 ModifyTime{ 0 };
+
+            bool IsValid() const { return Size >= 0; }
+        };
+
+        static FileState GetFileState(const String& path);
+
+        /** must be called with lock held */
+        const Record* FindValidRecord(const String& key, const FileState& state) const;
+
+        bool Load();
+
+        String CacheFile;
+        mutable std::mutex Mutex;
+        Map<String, Record> Records;
+        bool Dirty{ false };
+    };
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "global.hpp"
+#include "definitions_core.hpp"
+#include "file_system/file_matcher.hpp"
+#include "file_system/platform_file_interface.hpp"
+#include "thread/thread_pool.hpp"
+
+namespace Engine
+{
+    /**
+     * Scan directory tree with multiple threads. Every subdirectory found is queued and picked up by an idle thread,
+     * so large trees are listed in parallel and entries are streamed to visitor instead of collected.
+     * Calling thread scans as well, the others are workers of a thread pool, walks share one pool unless given.
+     */
+    class CORE_API DirectoryWalker
+    {
+    public:
+        /**
+         * @param threadNum number of scanning threads including calling one, 0 means decided by hardware
+         * @param threadPool pool scanning tasks run on, nullptr for the one shared by walks
+         */
+        explicit DirectoryWalker(IPlatformFile& platformFile, int32 threadNum = 0, IThreadPool* threadPool = nullptr);
+
+        /**
+         * Visit entries under root which match matcher. Visitor is called from multiple threads at the same time
+         * and in no particular order, return false from it to stop walking.
+         * @param recursive also visit entries in subdirectories
+         * @param includeDirectories pass directories to visitor as well as files
+         * @return number of entries passed to visitor
+         */
+        int64 Walk(const String& root, const FileMatcher& matcher, const DirectoryVisitor& visitor, bool recursive = true,
+                   bool includeDirectories = false);
+
+    private:
+        IPlatformFile& PlatformFile;
+        int32 ThreadNum;
+        IThreadPool* ThreadPool;
+    };
+}
@@ -8,8 +8,11 @@ namespace Engine
     enum class EFileAccess : uint32
     {
         None = 0,
+        /** open an existing file */
         Read = 1 << 0,
+        /** create a new file or truncate an existing one */
         Write = 1 << 1,
+        /** open an existing file or create a new one, content is kept */
         ReadWrite = 1 << 2
     };
 
@@ -21,6 +24,32 @@ namespace Engine
         Delete = 1 << 2
     };
 
+    enum class ESeekOrigin : uint32
+    {
+        Begin,
+        Current,
+        End
+    };
+
+    /** one buffer of vectored read */
+    struct FileReadVector
+    {
+        uint8* Dest;
+        int64 Size;
+    };
+
+    /** one buffer of vectored write */
+    struct FileWriteVector
+    {
+        const uint8* Src;
+        int64 Size;
+    };
+
+    /**
+     * Handle of an opened file.
+     * Read, Write and Seek share a cursor owned by handle and must be used by one thread at a time,
+     * positional functions never touch the cursor, so they can be called by multiple threads on the same handle.
+     */
     class CORE_API IFileHandle
     {
     public:
@@ -28,7 +57,63 @@ namespace Engine
 
         virtual int64 GetSize() const = 0;
 
+        /** read at cursor and advance it, false if less than size bytes are read */
         virtual bool Read(uint8* dest, int64 size) = 0;
+
+        /** write at cursor and advance it */
+        virtual bool Write(const uint8* src, int64 size) = 0;
+
+        /** move cursor, it's allowed to move beyond the end of file */
+        virtual bool Seek(int64 offset, ESeekOrigin origin = ESeekOrigin::Begin) = 0;
+
+        virtual int64 Tell() const = 0;
+
+        /** @return bytes read which is less than size at the end of file, -1 if failed */
+        virtual int64 ReadAt(uint8* dest, int64 size, int64 offset) = 0;
+
+        /** @return bytes written, -1 if failed */
+        virtual int64 WriteAt(const uint8* src, int64 size, int64 offset) = 0;
+
+        /** read continuous region starting at offset into buffers in order */
+        virtual int64 ReadV(const FileReadVector* vectors, int32 count, int64 offset) = 0;
+
+        /** write buffers in order into continuous region starting at offset */
+        virtual int64 WriteV(const FileWriteVector* vectors, int32 count, int64 offset) = 0;
+
+        /** extend or cut file to size, cursor isn't moved */
+        virtual bool Truncate(int64 size) = 0;
+
+        /** flush written data to device */
+        virtual bool Flush() = 0;
+    };
+
+    enum class EMappedAccessHint : uint32
+    {
+        Normal,
+        Sequential,
+        Random,
+        WillNeed
+    };
+
+    /** read only view of a file region, data is valid until handle is destroyed */
+    class CORE_API IMappedFileHandle
+    {
+    public:
+        virtual ~IMappedFileHandle() = default;
+
+        virtual const uint8* GetData() const = 0;
+
+        virtual int64 GetSize() const = 0;
+
+        /**
+         * Tell system how a region of view will be accessed.
+         * @param offset offset relative to the start of view
+         * @param size size of region, negative means until the end of view
+         */
+        virtual void Advise(EMappedAccessHint hint, int64 offset = 0, int64 size = -1) = 0;
+
+        /** read region into memory ahead of access */
+        virtual void Prefetch(int64 offset = 0, int64 size = -1) = 0;
     };
 
     class CORE_API IFindFileHandle
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "global.hpp"
+#include "definitions_core.hpp"
+#include "foundation/array.hpp"
+#include "foundation/string.hpp"
+#include "foundation/string_view.hpp"
+
+namespace Engine
+{
+    /**
+     * Match file names by glob patterns without std::regex, patterns are separated by ';', eg: "*.png;*.tga".
+     * '*' matches any characters except '/', '**' also matches '/', '?' matches one character,
+     * [abc] [a-z] [!abc] match one character in or not in set.
+     * Pattern containing '/' or '**' is matched against path relative to search root, otherwise against file name.
+     * Pattern like "*.png" is checked as a plain suffix compare.
+     */
+    class CORE_API FileMatcher
+    {
+    public:
+        /** match everything */
+        FileMatcher() = default;
+
+        explicit FileMatcher(const String& patterns, ECaseSensitivity cs = CaseSensitive);
+
+        bool IsMatchAll() const { return Patterns.Empty(); }
+
+        /**
+         * @param name file name without directory
+         * @param relativePath path relative to search root with '/' as separator, it's used by path patterns
+         */
+        bool Match(const StringView& name, const StringView& relativePath) const;
+
+        bool Match(const StringView& name) const
+        {
+            return Match(name, name);
+        }
+
+    private:
+        enum class EPatternKind : uint8
+        {
+            Exact,
+            Suffix,
+            Glob
+        };
+
+        struct Pattern
+        {
+            String Text;
+            EPatternKind Kind;
+            bool MatchPath;
+        };
+
+        Array<Pattern> Patterns;
+        ECaseSensitivity CaseSensitivity{ CaseSensitive };
+    };
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "global.hpp"
+#include "definitions_core.hpp"
+#include "foundation/endian.hpp"
+#include "foundation/smart_ptr.hpp"
+#include "foundation/string.hpp"
+#include "file_system/async_file_io.hpp"
+#include "file_system/file_handle_interface.hpp"
+
+namespace Engine
+{
+    /**
+     * Buffered sequential reader, memory usage is two buffers no matter how large the file is.
+     * With read ahead enabled, next block is read by async io backend while current one is consumed.
+     */
+    class CORE_API FileReader
+    {
+    public:
+        static constexpr int64 DEFAULT_BUFFER_SIZE = 1 << 20;
+
+        explicit FileReader(const String& filePath, int64 bufferSize = DEFAULT_BUFFER_SIZE, bool readAhead = true);
+
+        ~FileReader();
+
+        FileReader(const FileReader& other) = delete;
+
+        FileReader& operator= (const FileReader& other) = delete;
+
+        /** false if file can't be opened */
+        bool IsValid() const { return File != nullptr; }
+
+        /** true once a read failed, following reads return nothing */
+        bool HasError() const { return Error; }
+
+        int64 GetSize() const { return File != nullptr ? File->GetSize() : 0; }
+
+        int64 Tell() const { return Blocks[Current].Offset + Cursor; }
+
+        bool IsEof() const { return Tell() >= GetSize(); }
+
+        /** @return bytes read, less than size at the end of file */
+        int64 Read(uint8* dest, int64 size);
+
+        /** read a value stored in given byte order */
+        template <ByteSwappable T>
+        bool Read(T& value)
+        {
+            if (Read(reinterpret_cast<uint8*>(&value), sizeof(T)) != sizeof(T))
+            {
+                return false;
+            }
+            value = ConvertEndian(value, Endian);
+            return true;
+        }
+
+        /** block ahead is dropped if position falls out of buffered range */
+        bool Seek(int64 position);
+
+        bool Skip(int64 size) { return Seek(Tell() + size); }
+
+        void SetEndian(EEndian endian) { Endian = endian; }
+
+        EEndian GetEndian() const { return Endian; }
+
+    private:
+        struct Block
+        {
+            uint8* Data{ nullptr };
+            int64 Offset{ 0 };
+            int64 Size{ 0 };
+            AsyncReadRequestPtr Request;
+        };
+
+        void Issue(Block& block, int64 offset, EAsyncIOPriority priority);
+
+        /** wait for block in flight and take its size */
+        void Complete(Block& block);
+
+        void CancelAll();
+
+        /** move to next block, false at the end of file */
+        bool Advance();
+
+        SharedPtr<AsyncReadFile> File;
+        Block Blocks[2];
+        int32 Current{ 0 };
+        int64 Cursor{ 0 };
+        int64 BufferSize;
+        bool ReadAhead;
+        bool Error{ false };
+        EEndian Endian{ EEndian::Native };
+    };
+
+    /** buffered sequential writer, buffer is written when it's full, on Flush and on destruction */
+    class CORE_API FileWriter
+    {
+    public:
+        static constexpr int64 DEFAULT_BUFFER_SIZE = 1 << 20;
+
+        /** @param append keep content and write from the end of file, otherwise file is truncated */
+        explicit FileWriter(const String& filePath, int64 bufferSize = DEFAULT_BUFFER_SIZE, bool append = false);
+
+        ~FileWriter();
+
+        FileWriter(const FileWriter& other) = delete;
+
+        FileWriter& operator= (const FileWriter& other) = delete;
+
+        bool IsValid() const { return Handle != nullptr; }
+
+        bool HasError() const { return Error; }
+
+        int64 Tell() const { return Position + BufferUsed; }
+
+        bool Write(const uint8* src, int64 size);
+
+        /** write a value in given byte order */
+        template <ByteSwappable T>
+        bool Write(T value)
+        {
+            value = ConvertEndian(value, Endian);
+            return Write(reinterpret_cast<const uint8*>(&value), sizeof(T));
+        }
+
+        /**
+         * Write buffered data into file.
+         * @param toDevice also flush file to device, which is much slower
+         */
+        bool Flush(bool toDevice = false);
+
+        void SetEndian(EEndian endian) { Endian = endian; }
+
+        EEndian GetEndian() const { return Endian; }
+
+    private:
+        bool WriteBuffer();
+
+        UniquePtr<IFileHandle> Handle;
+        uint8* Buffer{ nullptr };
+        int64 BufferSize;
+        int64 BufferUsed{ 0 };
+        int64 Position{ 0 };
+        bool Error{ false };
+        EEndian Endian{ EEndian::Native };
+    };
+}
@@ -3,11 +3,14 @@
 #include "global.hpp"
 #include "foundation/array.hpp"
 #include "foundation/smart_ptr.hpp"
+#include "file_system/file_matcher.hpp"
 #include "file_system/platform_file_interface.hpp"
 #include "foundation/string.hpp"
 
 namespace Engine
 {
+    class ContentHashCache;
+
     class CORE_API FileSystem
     {
     public:
@@ -46,6 +49,18 @@ namespace Engine
 
         static FileTime GetFileTime(const String& path);
 
+        /** @return -1 if path isn't a file */
+        static int64 FileSize(const String& path);
+
+        /**
+         * Content hash cache shared by engine and tools, it's kept under saved directory.
+         * Records are loaded on first use and written back on engine shutdown or by ContentHashCache::Save.
+         */
+        static ContentHashCache& GetContentHashCache();
+
+        /** true if file keeps size and modify time it had when it's hashed by shared content hash cache, file isn't read */
+        static bool IsFileUnchanged(const String& path);
+
         /**
          * @brief query file (and directory) by regex
          * @param searchPath path for start search
@@ -55,12 +70,43 @@ namespace Engine
          */
         static Array<String> QueryFiles(const String& searchPath, const String& regex, bool recursion = false);
 
+        /**
+         * Walk directory tree with multiple threads and stream matched entries to visitor, see DirectoryWalker.
+         * Prefer it to QueryFiles for large trees.
+         * @return number of entries passed to visitor
+         */
+        static int64 WalkDirectory(const String& root, const FileMatcher& matcher, const DirectoryVisitor& visitor,
+                                   bool recursive = true, bool includeDirectories = false);
+
         static String GetEngineRootPath();
 
         static String GetEngineSaveDir();
 
+        /**
+         * Open file for sequential or positional io.
+         * @return nullptr if failed
+         */
+        static UniquePtr<IFileHandle> OpenFile(const String& fileName, EFileAccess access,
+                                               EFileShareMode mode = EFileShareMode::Read);
+
         static void ReadFileToBinary(const String& fileName, Array64<uint8>& outBinary);
 
+        /**
+         * Map file into memory without copying, prefer it to ReadFileToBinary for large or read only content.
+         * @param length negative means until the end of file
+         * @return nullptr if failed
+         */
+        static UniquePtr<IMappedFileHandle> MapFile(const String& fileName, int64 offset = 0, int64 length = -1,
+                                                    EMappedAccessHint hint = EMappedAccessHint::Normal);
+
+        /**
+         * Mount pak so files inside it can be used as files under mount point, see PakPlatformFile.
+         * @return false if pak can't be loaded
+         */
+        static bool MountPak(const String& pakPath, const String& mountPoint);
+
+        static bool UnmountPak(const String& pakPath);
+
         class DirectoryIterImpl
         {
         public:
@@ -22,6 +22,7 @@ namespace Engine
         Invalid       = 0xFFFFFFFF,
     };
 
+    /** times are milliseconds since epoch on every platform */
     struct CORE_API FileStat
     {
         Timestamp LastWriteTime = {};
@@ -33,6 +34,7 @@ namespace Engine
         bool IsValid = false;
     };
 
+    /** times are seconds since epoch */
     struct CORE_API FileTime
     {
         size_t CreationTime = 0;
@@ -58,6 +60,16 @@ namespace Engine
             return Path;
         }
 
+        const FileStat& GetStat() const
+        {
+            return Stat;
+        }
+
+        bool IsDirectory() const
+        {
+            return Stat.IsDirectory;
+        }
+
     private:
         String Path;
         FileStat Stat;
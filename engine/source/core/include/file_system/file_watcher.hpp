@@ -0,0 +1,146 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include "global.hpp"
+#include "definitions_core.hpp"
+#include "foundation/array.hpp"
+#include "foundation/delegate.hpp"
+#include "foundation/map.hpp"
+#include "foundation/smart_ptr.hpp"
+#include "foundation/string.hpp"
+
+namespace Engine
+{
+    enum class EFileChangeAction : uint8
+    {
+        Added,
+        Modified,
+        Removed,
+        Renamed,
+        /** backend dropped changes, Path is the watched directory and listeners should rescan it */
+        Overflow
+    };
+
+    struct FileChange
+    {
+        EFileChangeAction Action;
+        /** full path with '/' as separator */
+        String Path;
+        /** path before renaming, empty for other actions */
+        String OldPath;
+    };
+
+    /** all changes under one watched directory which happened in a burst */
+    DECLARE_DELEGATE_ONE_PARAM(FileChangesDelegate, const Array<FileChange>&);
+
+    enum class EFileWatchDispatch : uint8
+    {
+        /** delegate is executed on watcher thread as soon as a batch is ready, keep it short */
+        WatcherThread,
+        /** batches are queued until FileWatcher::DispatchEvents is called, eg: from game thread tick */
+        Deferred
+    };
+
+    using FileWatchHandle = int32;
+
+    class IFileWatcherBackend;
+    struct RawFileChange;
+
+    /**
+     * Observe changes of files under directories without polling, by inotify on linux and ReadDirectoryChangesW on windows.
+     * Changes of a path are merged until the directory stays quiet for coalesce delay,
+     * eg: a file created then written several times is reported once as added, a file created then removed is not reported.
+     */
+    class CORE_API FileWatcher
+    {
+    public:
+        /**
+         * @param coalesceDelayMs changes are held until no new change comes in this duration
+         * @param maxBatchDelayMs changes older than this are reported even if directory keeps changing
+         */
+        explicit FileWatcher(int32 coalesceDelayMs = 50, int32 maxBatchDelayMs = 1000);
+
+        ~FileWatcher();
+
+        FileWatcher(const FileWatcher& other) = delete;
+
+        FileWatcher& operator= (const FileWatcher& other) = delete;
+
+        /** false if platform has no backend or it failed to initialize */
+        bool IsAvailable() const { return Backend != nullptr; }
+
+        /**
+         * Start watching directory.
+         * @param recursive also watch subdirectories, including ones created later
+         * @return INDEX_NONE if failed
+         */
+        FileWatchHandle Watch(const String& directory, bool recursive, FileChangesDelegate&& onChanged,
+                              EFileWatchDispatch dispatch = EFileWatchDispatch::Deferred);
+
+        /** delegate won't be executed after it returns, it's safe to be called inside the delegate */
+        bool Unwatch(FileWatchHandle handle);
+
+        /**
+         * Execute delegates of deferred batches on calling thread.
+         * @return number of batches dispatched
+         */
+        int32 DispatchEvents();
+
+    private:
+        struct WatchedDirectory
+        {
+            FileChangesDelegate OnChanged;
+            EFileWatchDispatch Dispatch;
+            Array<FileChange> PendingChanges;
+            /** path to index in PendingChanges */
+            Map<String, int32> PendingIndices;
+            int64 FirstChangeTime{ 0 };
+            int64 LastChangeTime{ 0 };
+        };
+
+        struct ReadyBatch
+        {
+            FileWatchHandle Handle;
+            SharedPtr<WatchedDirectory> Watched;
+            Array<FileChange> Changes;
+        };
+
+        void Run();
+
+        /** must be called with lock held */
+        void AddChange(WatchedDirectory& watched, RawFileChange& change, int64 now);
+
+        /** merge added, modified or removed with pending change of the same path */
+        static void MergeChange(WatchedDirectory& watched, EFileChangeAction action, String&& path);
+
+        static FileChange* FindPendingChange(WatchedDirectory& watched, const String& path);
+
+        static void AddPendingChange(WatchedDirectory& watched, EFileChangeAction action, String&& path, String&& oldPath);
+
+        static void DropPendingChange(WatchedDirectory& watched, FileChange& change);
+
+        /** @return milliseconds to wait until next batch is ready, -1 if nothing is pending */
+        int32 FlushReadyBatches(int64 now, Array<ReadyBatch>& outImmediateBatches);
+
+        /** @return false if directory has been unwatched */
+        bool DispatchBatch(ReadyBatch& batch);
+
+        static int64 GetTimeMs();
+
+        UniquePtr<IFileWatcherBackend> Backend;
+        int32 CoalesceDelayMs;
+        int32 MaxBatchDelayMs;
+
+        /** guards watched directories and ready batches */
+        std::mutex Mutex;
+        /** held while a delegate is executed, so Unwatch can wait for it */
+        std::recursive_mutex DispatchMutex;
+        Map<FileWatchHandle, SharedPtr<WatchedDirectory>> WatchedDirectories;
+        Array<ReadyBatch> ReadyBatches;
+        FileWatchHandle NextHandle{ 0 };
+        std::atomic<bool> Stopping{ false };
+        std::thread Thread;
+    };
+}
@@ -0,0 +1,170 @@
+#pragma once
+
+#include "global.hpp"
+#include "definitions_core.hpp"
+#include "foundation/array.hpp"
+#include "foundation/compression.hpp"
+#include "foundation/set.hpp"
+#include "foundation/smart_ptr.hpp"
+#include "foundation/string.hpp"
+#include "file_system/file_handle_interface.hpp"
+#include "file_system/file_stream.hpp"
+
+namespace Engine
+{
+    /**
+     * Pak file layout, all values are little endian:
+     * [blocks][index][footer]
+     * Content of every file is split into blocks of BlockSize, each block is compressed on its own and starts at an
+     * aligned offset, so any part of a file can be read by decoding only the blocks it covers.
+     * Index holds entries sorted by path hash, blocks of all entries and a name table.
+     */
+    struct PakFooter
+    {
+        static constexpr uint32 MAGIC = 0x4B50504C;
+        static constexpr uint32 VERSION = 1;
+        /** size on disk, which isn't sizeof(PakFooter) */
+        static constexpr int64 SERIALIZED_SIZE = 48;
+
+        uint32 Magic{ MAGIC };
+        uint32 Version{ VERSION };
+        uint32 BlockSize{ 0 };
+        uint32 EntryNum{ 0 };
+        uint32 BlockNum{ 0 };
+        uint32 NameTableSize{ 0 };
+        uint64 IndexOffset{ 0 };
+        uint64 IndexSize{ 0 };
+        /** hash of index, which is verified on loading */
+        uint64 IndexHash{ 0 };
+    };
+
+    struct PakBlock
+    {
+        uint64 Offset{ 0 };
+        uint32 CompressedSize{ 0 };
+        ECompressionMethod Method{ ECompressionMethod::None };
+    };
+
+    struct PakEntry
+    {
+        uint64 PathHash{ 0 };
+        int64 Size{ 0 };
+        uint32 FirstBlock{ 0 };
+        uint32 BlockNum{ 0 };
+        uint32 NameOffset{ 0 };
+        uint32 NameLength{ 0 };
+    };
+
+    /** read only view of a pak, reading functions are thread safe */
+    class CORE_API PakFile
+    {
+    public:
+        /** @return nullptr if handle isn't a valid pak */
+        static SharedPtr<PakFile> Load(UniquePtr<IFileHandle> handle);
+
+        /** path inside pak with '/' as separator and without leading separator */
+        static String NormalizePath(const String& path);
+
+        /** hash of path which ignores case and separator style, it's stable across runs and platforms */
+        static uint64 HashPath(const String& path);
+
+        explicit PakFile(UniquePtr<IFileHandle> handle) : Handle(MoveTemp(handle)) {}
+
+        /** @return nullptr if path isn't in pak */
+        const PakEntry* FindEntry(const String& path) const;
+
+        int32 GetEntryNum() const { return Entries.Size(); }
+
+        const PakEntry& GetEntry(int32 index) const { return Entries[index]; }
+
+        String GetEntryPath(const PakEntry& entry) const;
+
+        int64 GetBlockSize() const { return Footer.BlockSize; }
+
+        const PakBlock& GetBlock(const PakEntry& entry, int32 blockIndex) const { return Blocks[entry.FirstBlock + blockIndex]; }
+
+        int64 GetBlockUncompressedSize(const PakEntry& entry, int32 blockIndex) const;
+
+        /** read and decode a whole block into dest */
+        bool ReadBlock(const PakEntry& entry, int32 blockIndex, uint8* dest) const;
+
+        /** @return bytes read which is less than size at the end of entry, -1 if failed */
+        int64 Read(const PakEntry& entry, uint8* dest, int64 size, int64 offset) const;
+
+        /**
+         * Entry stored without compression in continuous blocks can be mapped directly from pak.
+         * @return offset of entry in pak, -1 if entry isn't mappable
+         */
+        int64 GetMappableOffset(const PakEntry& entry) const;
+
+    private:
+        bool LoadIndex();
+
+        UniquePtr<IFileHandle> Handle;
+        PakFooter Footer;
+        Array<PakEntry> Entries;
+        Array<PakBlock> Blocks;
+        Array<char> NameTable;
+    };
+
+    /** build a pak, files are written as they are added and index is written on Finalize */
+    class CORE_API PakWriter
+    {
+    public:
+        static constexpr uint32 DEFAULT_BLOCK_SIZE = 64 * 1024;
+        static constexpr uint32 DEFAULT_ALIGNMENT = 16;
+
+        /**
+         * @param blockSize uncompressed size of block, power of two
+         * @param alignment alignment of block offset in pak, power of two not greater than block size
+         */
+        explicit PakWriter(const String& pakPath, ECompressionMethod method = ECompressionMethod::LZ4,
+                           uint32 blockSize = DEFAULT_BLOCK_SIZE, uint32 alignment = DEFAULT_ALIGNMENT);
+
+        /** pak is finalized if it isn't */
+        ~PakWriter();
+
+        PakWriter(const PakWriter& other) = delete;
+
+        PakWriter& operator= (const PakWriter& other) = delete;
+
+        bool IsValid() const { return Writer.IsValid() && !Writer.HasError(); }
+
+        /**
+         * Add file content with given path inside pak.
+         * @return false if path is already added or writing failed
+         */
+        bool AddFile(const String& path, const uint8* data, int64 size);
+
+        /** add file on disk with given path inside pak */
+        bool AddFile(const String& path, const String& sourceFile);
+
+        /** write index, nothing can be added after it */
+        bool Finalize();
+
+        int32 GetEntryNum() const { return Entries.Size(); }
+
+        int64 GetUncompressedSize() const { return UncompressedSize; }
+
+        int64 GetCompressedSize() const { return CompressedSize; }
+
+    private:
+        bool BeginEntry(const String& path);
+
+        /** compress and write one block, block which doesn't get smaller is stored as is */
+        bool WriteBlock(const uint8* data, int64 size);
+
+        FileWriter Writer;
+        ECompressionMethod Method;
+        uint32 BlockSize;
+        uint32 Alignment;
+        Array<PakEntry> Entries;
+        Array<PakBlock> Blocks;
+        Array<char> NameTable;
+        Set<String> AddedPaths;
+        Array<uint8> CompressBuffer;
+        int64 UncompressedSize{ 0 };
+        int64 CompressedSize{ 0 };
+        bool Finalized{ false };
+    };
+}
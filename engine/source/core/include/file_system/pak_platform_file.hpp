@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <shared_mutex>
+#include "global.hpp"
+#include "file_system/pak_file.hpp"
+#include "file_system/platform_file_interface.hpp"
+
+namespace Engine
+{
+    /**
+     * Platform file layer which serves files inside mounted paks as if they were on disk, other requests are passed to lower layer.
+     * Files in paks are read only, a pak mounted later overrides earlier ones and physical files with same path.
+     */
+    class CORE_API PakPlatformFile final : public IPlatformFile
+    {
+    public:
+        explicit PakPlatformFile(UniquePtr<IPlatformFile> lowerLevel);
+
+        virtual ~PakPlatformFile() = default;
+
+        /**
+         * Mount pak so its content appears under mount point.
+         * @param mountPoint directory which content is mounted to, eg: mounted "textures/a.png" is found as "{mountPoint}/textures/a.png"
+         * @return false if pak can't be loaded
+         */
+        bool Mount(const String& pakPath, const String& mountPoint);
+
+        /** opened files keep reading from pak after it's unmounted */
+        bool Unmount(const String& pakPath);
+
+        IPlatformFile* GetLowerLevel() const { return LowerLevel.get(); }
+
+        bool MakeDir(const String& path) final;
+
+        bool RemoveDir(const String& path) final;
+
+        bool MakeFile(const String& path) final;
+
+        bool RemoveFile(const String& path) final;
+
+        bool MoveFile(const String& from, const String& to) final;
+
+        bool CopyFile(const String& from, const String& to) final;
+
+        bool FileExists(const String& path) final;
+
+        bool IsReadOnly(const String& filePath) final;
+
+        int64 FileSize(const String& filePath) final;
+
+        bool DirExists(const String& path) final;
+
+        FileTime GetFileTime(const String& path) final;
+
+        Array<String> QueryFiles(const String& searchPath, const String& regexExpr, bool recursion) final;
+
+        bool IterateDirectory(const String& directory, const DirectoryVisitor& visitor) final;
+
+        UniquePtr<IFileHandle> OpenFile(const String& fileName, EFileAccess access, EFileShareMode mode) final;
+
+        UniquePtr<IMappedFileHandle> MapFile(const String& fileName, int64 offset, int64 length, EMappedAccessHint hint) final;
+
+    private:
+        struct MountedPak
+        {
+            String PakPath;
+            /** normalized and ends with '/' */
+            String MountPoint;
+            SharedPtr<PakFile> Pak;
+            /** sorted hashes of directories inside pak */
+            Array<uint64> DirHashes;
+        };
+
+        struct FoundEntry
+        {
+            const MountedPak* Mounted{ nullptr };
+            const PakEntry* Entry{ nullptr };
+        };
+
+        /** path relative to mount point, false if path isn't under it */
+        static bool GetPathInPak(const MountedPak& mounted, const String& path, String& outPath);
+
+        /** must be called with lock held */
+        FoundEntry FindEntry(const String& path) const;
+
+        UniquePtr<IPlatformFile> LowerLevel;
+        Array<MountedPak> MountedPaks;
+        /** checked without lock, so nothing is paid until a pak is mounted */
+        std::atomic<int32> MountedNum{ 0 };
+        mutable std::shared_mutex Mutex;
+    };
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "foundation/string.hpp"
+#include "foundation/string_view.hpp"
 
 namespace Engine
 {
@@ -12,6 +13,7 @@ namespace Engine
     public:
         static String Combine(const String& dest, const String& part);
 
+        /** same as PathView::GetExtension, a leading '.' belongs to file name, eg: .gitignore has no extension */
         static String GetExtension(const String& path);
 
         static String RemoveExtension(const String& path);
@@ -25,6 +27,131 @@ namespace Engine
 
         static Array<String> SplitPath(const String& path);
 
+        /** replace '\\' with '/' and remove trailing '/' unless path is a root, eg: "/", "c:/" */
         static String Normalize(const String& path);
     };
-}
\ No newline at end of file
+
+    /**
+     * @brief non-owning view of a path, offsets of root, file name and extension are found once on construction
+     * both '/' and '\\' are taken as separator, comparing and hashing are case insensitive
+     * eg: for c:/app/engine.hpp parent is c:/app, file name is engine.hpp, stem is engine and extension is .hpp
+     */
+    class CORE_API PathView
+    {
+    public:
+        PathView() = default;
+
+        explicit PathView(StringView path);
+
+        PathView(const String& path) : PathView(StringView(path.Data(), path.Length())) {}
+
+        PathView(const char* path) : PathView(StringView(path)) {}
+
+        bool Empty() const { return Len == 0; }
+
+        /** path starts with a root, eg: "/", "//", "c:/" */
+        bool IsAbsolute() const { return RootLen > 0; }
+
+        StringView GetPath() const { return StringView(Str, Len); }
+
+        StringView GetRoot() const { return StringView(Str, RootLen); }
+
+        /** path without file name and separator before it, parent of a root is the root itself */
+        StringView GetParent() const;
+
+        StringView GetFileName() const { return StringView(Str + NameStart, Len - NameStart); }
+
+        StringView GetStem() const { return StringView(Str + NameStart, ExtensionStart - NameStart); }
+
+        /** extension with '.', empty if file name has no '.' except a leading one, eg: .gitignore */
+        StringView GetExtension() const { return StringView(Str + ExtensionStart, Len - ExtensionStart); }
+
+        /** @param extension with or without '.' */
+        bool HasExtension(StringView extension) const;
+
+        bool Equals(const PathView& other, ECaseSensitivity cs = CaseInsensitive) const;
+
+        /** separators and case are folded, so it's consistent with Equals ignoring case */
+        uint64 GetHash64() const;
+
+        uint32 GetHashCode() const
+        {
+            const uint64 hash = GetHash64();
+            return static_cast<uint32>(hash ^ (hash >> 32));
+        }
+
+        friend bool operator== (const PathView& lhs, const PathView& rhs) { return lhs.Equals(rhs); }
+
+        friend bool operator!= (const PathView& lhs, const PathView& rhs) { return !lhs.Equals(rhs); }
+
+        static constexpr bool IsSeparator(char ch) { return ch == '/' || ch == '\\'; }
+
+        /** @return length of root, eg: 1 for "/", 2 for "//" and "c:", 3 for "c:/" */
+        static int32 GetRootLength(const char* path, int32 length);
+
+    private:
+        const char* Str{ nullptr };
+        int32 Len{ 0 };
+        int32 RootLen{ 0 };
+        int32 NameStart{ 0 };
+        /** equals to Len if there is no extension */
+        int32 ExtensionStart{ 0 };
+    };
+
+    /**
+     * @brief compose a normalized path in a reusable buffer
+     * appended parts are normalized in place: '\\' becomes '/', duplicated separators and "." are removed,
+     * ".." is resolved lexically, and there is no trailing '/' except for a root.
+     * Reset keeps the capacity, so building paths in a loop with one builder doesn't allocate once buffer is big enough.
+     */
+    class CORE_API PathBuilder
+    {
+    public:
+        explicit PathBuilder(int32 capacity = 128);
+
+        explicit PathBuilder(StringView path, int32 capacity = 128);
+
+        /** append part as a sub path, leading separators of part are ignored when builder isn't empty */
+        PathBuilder& Append(StringView part);
+
+        PathBuilder& Append(const String& part) { return Append(StringView(part.Data(), part.Length())); }
+
+        PathBuilder& Append(const char* part) { return Append(StringView(part)); }
+
+        template <typename T>
+        PathBuilder& operator/= (const T& part) { return Append(part); }
+
+        /** append text to file name without a separator, eg: ".bak" */
+        PathBuilder& Concat(StringView text);
+
+        /** @param extension with or without '.', empty removes extension */
+        PathBuilder& ReplaceExtension(StringView extension);
+
+        /** change to parent path */
+        PathBuilder& RemoveFileName();
+
+        void Reset() { Buffer.Clear(); }
+
+        void Reset(StringView path);
+
+        bool Empty() const { return Buffer.Empty(); }
+
+        int32 Length() const { return Buffer.Length(); }
+
+        PathView GetView() const { return PathView(StringView(Buffer.Data(), Buffer.Length())); }
+
+        const String& ToString() const { return Buffer; }
+
+        /** move built path out, builder is empty afterwards */
+        String Release();
+
+        /**
+         * Normalize path[start, length) in place, path[0, start) must be normalized already.
+         * @return new length of path
+         */
+        static int32 NormalizeInPlace(char* path, int32 length, int32 start = 0);
+
+    private:
+        String Buffer;
+    };
+}
@@ -1,11 +1,15 @@
 #pragma once
 
+#include <functional>
 #include "global.hpp"
 #include "foundation/smart_ptr.hpp"
 #include "file_system/file_handle_interface.hpp"
 
 namespace Engine
 {
+    /** called for each entry found, return false to stop */
+    using DirectoryVisitor = std::function<bool(const DirectoryEntry& entry)>;
+
     class CORE_API IPlatformFile
     {
     public:
@@ -35,6 +39,20 @@ namespace Engine
 
         virtual Array<String> QueryFiles(const String& searchPath, const String& regexExpr, bool recursion) = 0;
 
+        /**
+         * List entries directly under directory with their stat, "." and ".." are skipped.
+         * It's safe to list different directories from multiple threads at the same time.
+         * @return false if directory can't be opened
+         */
+        virtual bool IterateDirectory(const String& directory, const DirectoryVisitor& visitor) = 0;
+
         virtual UniquePtr<IFileHandle> OpenFile(const String& fileName, EFileAccess access, EFileShareMode mode) = 0;
+
+        /**
+         * Map a region of file into memory as read only view.
+         * @param length negative means until the end of file
+         * @return nullptr if failed
+         */
+        virtual UniquePtr<IMappedFileHandle> MapFile(const String& fileName, int64 offset, int64 length, EMappedAccessHint hint) = 0;
     };
 }
\ No newline at end of file
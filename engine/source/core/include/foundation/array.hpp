@@ -695,9 +695,17 @@ namespace Engine
             return Pair.SecondVal.Capacity;
         }
 
+        /** allocator may hold fewer elements than SizeType can count, eg: VirtualAllocator */
         constexpr SizeType MaxSize() const
         {
-            return NumericLimits<SizeType>::Max();
+            if constexpr (requires { AllocatorType::GetMaxSize(); })
+            {
+                return AllocatorType::GetMaxSize();
+            }
+            else
+            {
+                return NumericLimits<SizeType>::Max();
+            }
         }
 
         bool Empty() const
@@ -868,13 +876,13 @@ namespace Engine
 
         void Sort()
         {
-            std::sort(begin(), end());
+            std::sort(Data(), Data() + Size());
         }
 
         template <typename Predicate>
         void Sort(Predicate pred)
         {
-            std::sort(begin(), end(), pred);
+            std::sort(Data(), Data() + Size(), pred);
         }
 
         Iterator begin()
@@ -990,7 +998,7 @@ namespace Engine
             destSize = destSize >= 0 ? destSize : Pair.SecondVal.Size;
             SizeType newCapacity = CalculateGrowth(destSize);
             ENSURE(destSize <= newCapacity);
-            Reallocate(newCapacity);
+            Reallocate(newCapacity, true);
         }
 
         SizeType CalculateGrowth(const SizeType newSize) const
@@ -1027,7 +1035,7 @@ namespace Engine
 
         void CopyAssign(const ValueType* data, SizeType size, SizeType extraSlack = 0)
         {
-            ENSURE(data && size > 0 && extraSlack >= 0);
+            ENSURE((data || size == 0) && size >= 0 && extraSlack >= 0);
             auto& myVal = Pair.SecondVal;
             if (myVal.Data)
             {
@@ -1063,15 +1071,38 @@ namespace Engine
             otherVal.Capacity = 0;
         }
 
-        void Reallocate(SizeType newCapacity)
+        /**
+         * @param useSlack take every element the allocation can hold as capacity, so following adds don't reallocate.
+         * Only growth uses it, Reserve and Shrink keep the exact capacity asked for
+         */
+        void Reallocate(SizeType newCapacity, bool useSlack = false)
         {
+            MEMORY_TAG_FALLBACK_SCOPE(Container);
             auto& myVal = Pair.SecondVal;
             auto& alloc = Pair.GetFirst();
 
+            if constexpr (requires { alloc.TryResize(myVal.Data, myVal.Capacity, newCapacity); })
+            {
+                if (myVal.Data && newCapacity > 0 && alloc.TryResize(myVal.Data, myVal.Capacity, newCapacity))
+                {
+                    myVal.Capacity = newCapacity;
+                    return;
+                }
+            }
+
             ValueType* newPtr = alloc.Allocate(newCapacity);
+            if constexpr (requires { alloc.GetUsableCapacity(newPtr, newCapacity); })
+            {
+                if (useSlack)
+                {
+                    newCapacity = alloc.GetUsableCapacity(newPtr, newCapacity);
+                }
+            }
+
             if (myVal.Data)
             {
-                Memory::Memmove(newPtr, myVal.Data, myVal.Size * sizeof(ValueType));
+                // size may already include elements being added, which don't exist in old buffer
+                Memory::Memmove(newPtr, myVal.Data, Math::Min(myVal.Size, myVal.Capacity) * sizeof(ValueType));
                 alloc.Deallocate(myVal.Data, myVal.Capacity);
             }
 
@@ -1112,4 +1143,8 @@ namespace Engine
 
     template <typename Elem>
     using Array64 = Array<Elem, StandardAllocator<int64>>;
+
+    /** array grows in reserved address space, see VirtualAllocator */
+    template <typename Elem, uint64 ReserveBytes = (1ull << 36)>
+    using VirtualArray = Array<Elem, VirtualAllocator<ReserveBytes, int64>>;
 }
\ No newline at end of file
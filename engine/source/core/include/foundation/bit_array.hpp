@@ -738,7 +738,7 @@ namespace Engine
         ConstValidIterator CreateValidIterator(SizeType startIndex = 0) const
         {
             ENSURE(startIndex >= 0 && startIndex <= Size());
-            return ConstValidIterator(*this, 0);
+            return ConstValidIterator(*this, startIndex);
         }
 
         Iterator begin()
@@ -847,7 +847,7 @@ namespace Engine
             if (myVal.Data)
             {
                 auto& alloc = GetAlloc();
-                alloc.Deallocate(myVal.Data, myVal.Capacity);
+                alloc.Deallocate(myVal.Data, myVal.Capacity / ELEMENT_BITS_NUM);
             }
 
             myVal.Size = otherVal.Size;
@@ -902,6 +902,7 @@ namespace Engine
 
         void Reallocate(SizeType newCapacity)
         {
+            MEMORY_TAG_FALLBACK_SCOPE(Container);
             auto& myVal = Pair.SecondVal;
             auto& alloc = Pair.GetFirst();
 
@@ -911,8 +912,10 @@ namespace Engine
             ValueType* newPtr = alloc.Allocate(elemCount);
             if (myVal.Data)
             {
-                Memory::Memmove(newPtr, myVal.Data, myVal.Size);
-                alloc.Deallocate(myVal.Data, myVal.Capacity);
+                // size may already include bits being added, copy the elements old buffer actually holds
+                const SizeType oldElemCount = Math::Min(Math::DivideAndCeil(myVal.Capacity, ELEMENT_BITS_NUM), elemCount);
+                Memory::Memmove(newPtr, myVal.Data, oldElemCount * sizeof(ValueType));
+                alloc.Deallocate(myVal.Data, myVal.Capacity / ELEMENT_BITS_NUM);
             }
 
             myVal.Data = newPtr;
@@ -925,7 +928,7 @@ namespace Engine
             if (myVal.Data)
             {
                 auto& alloc = GetAlloc();
-                alloc.Deallocate(myVal.Data, myVal.Capacity);
+                alloc.Deallocate(myVal.Data, myVal.Capacity / ELEMENT_BITS_NUM);
             }
             myVal.Size = 0;
             myVal.Capacity = 0;
@@ -5,6 +5,7 @@
 #include "memory/memory.hpp"
 #include "math/generic_math.hpp"
 #include "math/limit.hpp"
+#include "foundation/string_kernels.hpp"
 
 namespace Engine
 {
@@ -15,6 +16,11 @@ namespace Engine
         using IntType = U;
         using SizeType = V;
 
+        /** 1 and 2 bytes units go through StringKernels at runtime, shorter runs than this stay in the inline loop */
+        static constexpr bool USE_STRING_KERNELS = sizeof(CharType) == 1 || sizeof(CharType) == 2;
+        static constexpr SizeType STRING_KERNEL_MIN_LENGTH = 16;
+        using KernelUnit = std::conditional_t<sizeof(CharType) == 1, uint8, uint16>;
+
         static constexpr bool IsSpace(CharType ch) noexcept
         {
             return ToInt(ch) == 0x20;
@@ -22,6 +28,14 @@ namespace Engine
 
         static constexpr SizeType Length(const CharType* str) noexcept
         {
+            if constexpr (USE_STRING_KERNELS)
+            {
+                if (!std::is_constant_evaluated())
+                {
+                    return static_cast<SizeType>(StringKernels::Length(reinterpret_cast<const KernelUnit*>(str)));
+                }
+            }
+
             SizeType len = 0;
             while (*str != CharType())
             {
@@ -33,6 +47,15 @@ namespace Engine
 
         static constexpr const CharType* Find(const CharType* first, SizeType len, const CharType& ch) noexcept
         {
+            if constexpr (USE_STRING_KERNELS)
+            {
+                if (!std::is_constant_evaluated() && len >= STRING_KERNEL_MIN_LENGTH)
+                {
+                    auto found = StringKernels::Find(reinterpret_cast<const KernelUnit*>(first), static_cast<size_t>(len), static_cast<KernelUnit>(ch));
+                    return reinterpret_cast<const CharType*>(found);
+                }
+            }
+
             for (; 0 < len; --len, ++first)
             {
                 if (*first == ch)
@@ -102,6 +125,21 @@ namespace Engine
 
             if (cs == CaseSensitive)
             {
+                if constexpr (USE_STRING_KERNELS && std::is_same_v<CharType, OtherChar>)
+                {
+                    if (!std::is_constant_evaluated() && count >= STRING_KERNEL_MIN_LENGTH)
+                    {
+                        auto left = reinterpret_cast<const KernelUnit*>(lhs);
+                        auto right = reinterpret_cast<const KernelUnit*>(rhs);
+                        const size_t index = StringKernels::Mismatch(left, right, static_cast<size_t>(count));
+                        if (index == static_cast<size_t>(count))
+                        {
+                            return 0;
+                        }
+                        return left[index] < right[index] ? -1 : +1;
+                    }
+                }
+
                 auto left = reinterpret_cast<const typename std::make_unsigned_t<CharType>*>(lhs);
                 auto right = reinterpret_cast<const typename std::make_unsigned_t<OtherChar>*>(rhs);
                 for (; 0 < count; --count, ++left, ++right)
@@ -117,8 +155,8 @@ namespace Engine
                 for (; 0 < count; --count, ++lhs, ++rhs)
                 {
                     auto left = ToInt(FoldCaseLatin1(*lhs));
-                    auto right = ToInt(FoldCaseLatin1(*lhs));
-                    if (left != left)
+                    auto right = ToInt(FoldCaseLatin1(static_cast<CharType>(*rhs)));
+                    if (left != right)
                     {
                         return left < right ? -1 : +1;
                     }
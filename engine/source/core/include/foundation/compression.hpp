@@ -0,0 +1,34 @@
+#pragma once
+
+#include "global.hpp"
+#include "definitions_core.hpp"
+
+namespace Engine
+{
+    enum class ECompressionMethod : uint8
+    {
+        None,
+        /** lz4 block format, fast to decode and good enough for packed assets */
+        LZ4
+    };
+
+    /** block compression, every call is independent so blocks can be decoded in any order */
+    class CORE_API Compression
+    {
+    public:
+        /** size of dest buffer which is always large enough to hold compressed data */
+        static int64 GetMaxCompressedSize(ECompressionMethod method, int64 srcSize);
+
+        /**
+         * @return compressed size, -1 if dest isn't large enough
+         */
+        static int64 Compress(ECompressionMethod method, uint8* dest, int64 destCapacity, const uint8* src, int64 srcSize);
+
+        /**
+         * Decompress a whole block, untrusted input never writes out of dest.
+         * @param destSize exact size of uncompressed data
+         * @return false if data is corrupted or not match destSize
+         */
+        static bool Decompress(ECompressionMethod method, uint8* dest, int64 destSize, const uint8* src, int64 srcSize);
+    };
+}
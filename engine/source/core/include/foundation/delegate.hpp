@@ -1,5 +1,6 @@
 #pragma once
 
+#include "foundation/array.hpp"
 #include "foundation/smart_ptr.hpp"
 #include "foundation/details/delegate_instance.hpp"
 
@@ -2,6 +2,7 @@
 
 #include "foundation/tuple.hpp"
 #include "foundation/details/delegate_handle.hpp"
+#include "memory/object_pool.hpp"
 
 namespace Engine
 {
@@ -21,7 +22,7 @@ namespace Engine
     };
 
     template <typename RetType, typename... ArgTypes>
-    class IDelegateInstance
+    class IDelegateInstance : public PoolNewDeleteObject
     {
     public:
         virtual ~IDelegateInstance() = default;
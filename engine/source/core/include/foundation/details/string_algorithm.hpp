@@ -129,22 +129,19 @@ namespace Engine::Private
             const CharType* begin = haystack;
             const CharType* current = begin + from;
             const CharType* end = haystack + len;
+            if (cs == CaseSensitive)
+            {
+                // long runs go through simd string kernels
+                const CharType* found = Traits::Find(current, len - from, ch);
+                return found ? static_cast<SizeType>(found - begin) : INDEX_NONE;
+            }
+
             while (current < end)
             {
-                if (cs == CaseSensitive)
-                {
-                    if (*current == ch)
-                    {
-                        return static_cast<SizeType>(current - begin);
-                    }
-                }
-                else
+                if (Traits::FoldCaseLatin1(static_cast<char32_t>(*current)) ==
+                    Traits::FoldCaseLatin1(static_cast<char32_t>(ch)))
                 {
-                    if (Traits::FoldCaseLatin1(static_cast<char32_t>(*current)) ==
-                        Traits::FoldCaseLatin1(static_cast<char32_t>(ch)))
-                    {
-                        return static_cast<SizeType>(current - begin);
-                    }
+                    return static_cast<SizeType>(current - begin);
                 }
                 ++current;
             }
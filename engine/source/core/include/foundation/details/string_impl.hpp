@@ -397,7 +397,7 @@ namespace Engine
     BasicString<Elem, Traits, Alloc> BasicString<Elem, Traits, Alloc>::Trimmed() const
     {
         const CharType* start = Data();
-        const CharType* end = Data() + Length() - 1;
+        const CharType* end = Data() + Length();
 
         while (start < end && CharTraits::IsSpace(*start))
         {
@@ -530,6 +530,7 @@ namespace Engine
             return;
         }
 
+        MEMORY_TAG_FALLBACK_SCOPE(String);
         auto& alloc = GetAlloc();
         CharType* ptr = alloc.Allocate(capacity);
         CharType* oldPtr = val.UB.Ptr;
@@ -812,6 +813,7 @@ namespace Engine
     template <typename Elem, typename Traits, typename Alloc>
     void BasicString<Elem, Traits, Alloc>::BecomeLarge(SizeType capacity)
     {
+        MEMORY_TAG_FALLBACK_SCOPE(String);
         auto& myVal = Pair.SecondVal;
         CharType* ptr = GetAlloc().Allocate(capacity);
         CharTraits::Copy(ptr, myVal.UB.Buffer, Size());
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <bit>
+#include "global.hpp"
+
+namespace Engine
+{
+    enum class EEndian : uint32
+    {
+        Little,
+        Big,
+        Native = std::endian::native == std::endian::little ? Little : Big
+    };
+
+    template <typename T>
+    concept ByteSwappable = std::is_arithmetic_v<T> || std::is_enum_v<T>;
+
+    /** reverse byte order of value, compiles to a single bswap for integers */
+    template <ByteSwappable T>
+    NODISCARD constexpr T ByteSwap(T value)
+    {
+        if constexpr (sizeof(T) == 1)
+        {
+            return value;
+        }
+        else
+        {
+            struct Bytes { uint8 Value[sizeof(T)]; };
+            Bytes bytes = std::bit_cast<Bytes>(value);
+            for (size_t index = 0; index < sizeof(T) / 2; ++index)
+            {
+                const uint8 temp = bytes.Value[index];
+                bytes.Value[index] = bytes.Value[sizeof(T) - 1 - index];
+                bytes.Value[sizeof(T) - 1 - index] = temp;
+            }
+            return std::bit_cast<T>(bytes);
+        }
+    }
+
+    /** convert between native byte order and given one, it works for both directions */
+    template <ByteSwappable T>
+    NODISCARD constexpr T ConvertEndian(T value, EEndian endian)
+    {
+        return endian == EEndian::Native ? value : ByteSwap(value);
+    }
+}
@@ -235,7 +235,7 @@ namespace Engine
 
         ConstIterator end() const
         {
-            return ConstIterator(Pairs.begin());
+            return ConstIterator(Pairs.end());
         }
 
     private:
@@ -17,7 +17,7 @@ namespace Engine
 
         const ValueType& operator*() const { return (*It).MyVal; }
 
-        const ValueType* operator->() const { return It->MyVal; }
+        const ValueType* operator->() const { return &(*It).MyVal; }
 
         explicit operator bool() const
         {
@@ -175,6 +175,7 @@ namespace Engine
 
         void Resize(SizeType newSize)
         {
+            MEMORY_TAG_FALLBACK_SCOPE(Container);
             auto& alloc = GetAlloc();
             auto& myVal = Pair.SecondVal;
             ValueType* newData = alloc.Allocate(newSize);
@@ -261,7 +262,7 @@ namespace Engine
         using ValueType = Elem;
         using KeyType = typename KeyFun::KeyType;
         using SizeType = Alloc::SizeType;
-        using SetElemIndex = SetElemIndex<SizeType>;
+        using ElemIndexType = SetElemIndex<SizeType>;
 
         struct SetElement
         {
@@ -273,13 +274,13 @@ namespace Engine
 
             ValueType MyVal;
             uint32 HashIndex = 0;
-            SetElemIndex HashNextId;
+            ElemIndexType HashNextId;
         };
 
-        using HashBucketType = SetHashBucket<SetElemIndex, Alloc>;
+        using HashBucketType = SetHashBucket<ElemIndexType, Alloc>;
         using SparseArrayType = SparseArray<SetElement, Alloc>;
         using AllocatorType = SparseArrayType::AllocatorType;
-        using BucketAllocatorType = typename Alloc::template ElementAllocator<SetElemIndex>;
+        using BucketAllocatorType = typename Alloc::template ElementAllocator<ElemIndexType>;
         using Iterator = SetIterator<Set>;
         using ConstIterator = ConstSetIterator<Set>;
 
@@ -384,7 +385,7 @@ namespace Engine
             ValueType* ret = nullptr;
             if (Size() > 0)
             {
-                SetElemIndex* elementIndex = &GetFirstIndex(KeyFun::GetHashCode(key));
+                ElemIndexType* elementIndex = &GetFirstIndex(KeyFun::GetHashCode(key));
                 while (elementIndex->IsValid())
                 {
                     auto&& setElement = Elements[elementIndex->Index];
@@ -395,7 +396,7 @@ namespace Engine
                     }
                     else
                     {
-                        elementIndex = const_cast<SetElemIndex*>(&setElement.HashNextId);
+                        elementIndex = const_cast<ElemIndexType*>(&setElement.HashNextId);
                     }
                 }
             }
@@ -412,7 +413,7 @@ namespace Engine
             bool ret = false;
             if (Size() > 0)
             {
-                SetElemIndex* elementIndex = &GetFirstIndex(KeyFun::GetHashCode(key));
+                ElemIndexType* elementIndex = &GetFirstIndex(KeyFun::GetHashCode(key));
                 while (elementIndex->IsValid())
                 {
                     auto&& setElement = Elements[elementIndex->Index];
@@ -496,11 +497,11 @@ namespace Engine
 
         Iterator begin() { return Iterator(Elements.begin()); }
 
-        ConstIterator begin() const { return ConstIterator(const_cast<const SparseArrayType>(Elements).begin()); }
+        ConstIterator begin() const { return ConstIterator(Elements.begin()); }
 
         Iterator end() { return Iterator(Elements.end()); }
 
-        ConstIterator end() const { return ConstIterator(const_cast<const SparseArrayType>(Elements).end()); }
+        ConstIterator end() const { return ConstIterator(Elements.end()); }
 
     private:
         template <typename ElemType>
@@ -508,7 +509,7 @@ namespace Engine
         {
             uint32 hashCode = KeyFun::GetHashCode(KeyFun::GetKey(val));
 
-            SetElemIndex index = FindIndex(KeyFun::GetKey(val), hashCode);
+            ElemIndexType index = FindIndex(KeyFun::GetKey(val), hashCode);
             if (index.IsValid())
             {
                 auto&& setElement = Elements[index.Index];
@@ -520,22 +521,22 @@ namespace Engine
             CheckRehash(Elements.Size() + 1);
             SizeType indexInSparseArray = Elements.AddUnconstructElement();
             SetElement* item = new(Elements.Data() + indexInSparseArray) SetElement(std::forward<ElemType>(val));
-            LinkElement(SetElemIndex(indexInSparseArray), *item, hashCode);
+            LinkElement(ElemIndexType(indexInSparseArray), *item, hashCode);
             return item->MyVal;
         }
 
         /** Contains key index in sparse array */
-        SetElemIndex FindIndex(const KeyType& key) const
+        ElemIndexType FindIndex(const KeyType& key) const
         {
             return FindIndex(key, KeyFun::GetHashCode(key));
         }
 
         /** Contains key index in sparse array */
-        SetElemIndex FindIndex(const KeyType& key, uint32 hashCode) const
+        ElemIndexType FindIndex(const KeyType& key, uint32 hashCode) const
         {
             if (Elements.Size() > 0)
             {
-                for (SetElemIndex index = GetFirstIndex(hashCode); index.IsValid(); index = Elements[index].HashNextId)
+                for (ElemIndexType index = GetFirstIndex(hashCode); index.IsValid(); index = Elements[index].HashNextId)
                 {
                     if (KeyFun::Equals(KeyFun::GetKey(Elements[index].MyVal), key))
                     {
@@ -544,11 +545,11 @@ namespace Engine
                     }
                 }
             }
-            return SetElemIndex{};
+            return ElemIndexType{};
         }
 
         /** Contains the head of SetElement list */
-        SetElemIndex& GetFirstIndex(uint32 hashCode) const
+        ElemIndexType& GetFirstIndex(uint32 hashCode) const
         {
             ENSURE(Size() > 0);
             return HashBucket.GetFirstIndex(hashCode);
@@ -573,11 +574,11 @@ namespace Engine
             // Add the existing elements to the new hash.
             for (typename SparseArrayType::Iterator iter = Elements.begin(); iter != Elements.end(); ++iter)
             {
-                LinkElement(SetElemIndex(iter.GetIndex()), *iter, KeyFun::GetHashCode(KeyFun::GetKey((*iter).MyVal)));
+                LinkElement(ElemIndexType(iter.GetIndex()), *iter, KeyFun::GetHashCode(KeyFun::GetKey((*iter).MyVal)));
             }
         }
 
-        void LinkElement(SetElemIndex index, SetElement& elem, uint32 hashCode) const
+        void LinkElement(ElemIndexType index, SetElement& elem, uint32 hashCode) const
         {
             // get the index of hash bucket.
             elem.HashIndex = HashBucket.GetHashIndex(hashCode);
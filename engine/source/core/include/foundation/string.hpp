@@ -266,6 +266,9 @@ namespace Engine
             return Pair.SecondVal.MaxSize;
         }
 
+        /** make room for capacity characters, it never shrinks */
+        void Reserve(SizeType capacity);
+
         AllocatorType GetAllocator() const
         {
             return static_cast<AllocatorType>(GetAlloc());
@@ -672,8 +675,6 @@ namespace Engine
             new(Data() + index) CharType(Forward<Args>(args)...);
         }
 
-        void Reserve(SizeType capacity);
-
         void Invalidate();
 
         void MoveAssign(BasicString&& right);
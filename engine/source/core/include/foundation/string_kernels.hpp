@@ -0,0 +1,36 @@
+#pragma once
+
+#include "global.hpp"
+#include "definitions_core.hpp"
+#include "misc/cpu_features.hpp"
+
+namespace Engine
+{
+    /**
+     * Bulk scans over 1 and 2 bytes code units used by CharTraits.
+     * Picked once at runtime for CpuFeatures::GetSimdLevel, every variant returns the same result as the scalar loop
+     */
+    class CORE_API StringKernels
+    {
+    public:
+        StringKernels() = delete;
+
+        /** number of units before the first zero */
+        static size_t Length(const uint8* str);
+
+        static size_t Length(const uint16* str);
+
+        /** first unit equal to ch, nullptr if there isn't one */
+        static const uint8* Find(const uint8* first, size_t len, uint8 ch);
+
+        static const uint16* Find(const uint16* first, size_t len, uint16 ch);
+
+        /** index of the first unit lhs and rhs differ at, len if they are equal */
+        static size_t Mismatch(const uint8* lhs, const uint8* rhs, size_t len);
+
+        static size_t Mismatch(const uint16* lhs, const uint16* rhs, size_t len);
+
+        /** instruction set kernels are running on */
+        static ESimdLevel GetSimdLevel();
+    };
+}
\ No newline at end of file
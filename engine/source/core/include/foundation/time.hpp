@@ -55,4 +55,120 @@ namespace Engine
                     system_clock::now().time_since_epoch()));
         }
     };
+
+    /**
+     * Monotonic high resolution clock for measuring durations, it isn't affected by system time adjustments.
+     * Reads invariant time stamp counter on x86, converted to nanoseconds by a factor calibrated against steady_clock
+     * on first use, otherwise steady_clock itself.
+     * Time point has no relation with wall clock, use PlatformClock for it.
+     */
+    struct CORE_API HighResolutionClock
+    {
+        using rep        = int64;
+        using period     = std::nano;
+        using duration   = std::chrono::nanoseconds;
+        using time_point = std::chrono::time_point<HighResolutionClock>;
+        static constexpr bool is_steady = true;
+
+        NODISCARD static time_point now() noexcept { return time_point(duration(Now())); }
+
+        /** nanoseconds since an unspecified point */
+        NODISCARD static int64 Now();
+
+        /** raw counter, cheapest to read, convert a difference of it by CyclesToNanoseconds */
+        NODISCARD static int64 Cycles();
+
+        NODISCARD static int64 CyclesToNanoseconds(int64 cycles);
+
+        NODISCARD static double CyclesToSeconds(int64 cycles);
+
+        NODISCARD static double GetCyclesPerSecond();
+
+        /** false if counter isn't invariant and steady_clock is read instead, cycle is a nanosecond then */
+        NODISCARD static bool IsUsingTsc();
+    };
+
+    /** measure elapsed time, it can be paused and resumed */
+    class CORE_API Stopwatch
+    {
+    public:
+        explicit Stopwatch(bool start = true)
+        {
+            if (start)
+            {
+                Start();
+            }
+        }
+
+        void Start()
+        {
+            if (!Running)
+            {
+                StartCycles = HighResolutionClock::Cycles();
+                Running = true;
+            }
+        }
+
+        void Stop()
+        {
+            if (Running)
+            {
+                AccumulatedCycles += HighResolutionClock::Cycles() - StartCycles;
+                Running = false;
+            }
+        }
+
+        void Reset()
+        {
+            AccumulatedCycles = 0;
+            Running = false;
+        }
+
+        void Restart()
+        {
+            Reset();
+            Start();
+        }
+
+        NODISCARD bool IsRunning() const { return Running; }
+
+        NODISCARD int64 GetElapsedCycles() const
+        {
+            return AccumulatedCycles + (Running ? HighResolutionClock::Cycles() - StartCycles : 0);
+        }
+
+        NODISCARD int64 GetElapsedNanoseconds() const { return HighResolutionClock::CyclesToNanoseconds(GetElapsedCycles()); }
+
+        NODISCARD double GetElapsedMilliseconds() const { return GetElapsedNanoseconds() / 1e6; }
+
+        NODISCARD double GetElapsedSeconds() const { return HighResolutionClock::CyclesToSeconds(GetElapsedCycles()); }
+
+    private:
+        int64 StartCycles{ 0 };
+        int64 AccumulatedCycles{ 0 };
+        bool Running{ false };
+    };
+
+    /** add nanoseconds elapsed in scope to a counter when scope ends */
+    class CORE_API ScopedTimer
+    {
+    public:
+        explicit ScopedTimer(int64& outNanoseconds)
+            : Output(outNanoseconds)
+            , StartCycles(HighResolutionClock::Cycles())
+        {}
+
+        ~ScopedTimer()
+        {
+            Output += HighResolutionClock::CyclesToNanoseconds(HighResolutionClock::Cycles() - StartCycles);
+        }
+
+        ScopedTimer(const ScopedTimer& other) = delete;
+
+        ScopedTimer& operator= (const ScopedTimer& other) = delete;
+
+    private:
+        int64& Output;
+        int64 StartCycles;
+    };
 }
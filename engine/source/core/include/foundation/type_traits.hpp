@@ -68,7 +68,7 @@ template <typename Type>
 constexpr bool HasTrivialDestructorV = __has_trivial_destructor(Type);
 
 template <typename Type>
-constexpr bool HasUserDestructorV = __has_virtual_destructor(Type) || __has_user_destructor(Type);
+constexpr bool HasUserDestructorV = std::has_virtual_destructor_v<Type> || !std::is_trivially_destructible_v<Type>;
 
 /** return type depend predicate */
 template <bool Predicate, typename TrueType, typename FalseType>
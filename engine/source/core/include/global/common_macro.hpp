@@ -18,7 +18,23 @@
     #define UNLIKELY(expr)  expr
 #endif
 
-#if defined(ENABLE_TRANSFORM_INTRINSICS)
-#undef ENABLE_TRANSFORM_INTRINSICS
+/** sse path of Transform and Matrix, 0 builds the scalar reference path */
+#ifndef ENABLE_TRANSFORM_INTRINSICS
+    #if SUPPORT_SSE2
+        #define ENABLE_TRANSFORM_INTRINSICS 1
+    #else
+        #define ENABLE_TRANSFORM_INTRINSICS 0
+    #endif
 #endif
-#define ENABLE_TRANSFORM_INTRINSICS 0
\ No newline at end of file
+
+#ifndef ENABLE_MEMORY_TRACKING
+#define ENABLE_MEMORY_TRACKING 0
+#endif
+
+#ifndef ENABLE_OVERRIDE_NEW_DELETE
+#define ENABLE_OVERRIDE_NEW_DELETE 0
+#endif
+
+#ifndef ENABLE_PROFILER
+#define ENABLE_PROFILER 0
+#endif
\ No newline at end of file
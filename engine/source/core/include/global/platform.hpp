@@ -3,6 +3,8 @@
 #include "global/prerequisite.hpp"
 #if PLATFORM_WINDOWS
 #include "windows/windows_platform.hpp"
+#elif PLATFORM_LINUX
+#include "linux/linux_platform.hpp"
 #endif
 
 namespace Engine
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "definitions_core.hpp"
+#include "global.hpp"
+#include "memory/malloc_interface.hpp"
+
+namespace Engine
+{
+    class CORE_API LinuxMemory
+    {
+    public:
+        static IMalloc* GetDefaultMalloc();
+
+        static uint32 GetDefaultAlignment();
+
+        static void Memcpy(void* dest, void const* src, size_t size);
+
+        static void Memmove(void* dest, void* src, size_t size);
+
+        static void Memset(void* dest, uint8 byte, size_t size);
+
+        static bool Memcmp(void* lBuffer, void* rBuffer, size_t size);
+
+        /** capture return addresses of current thread, caller of this function is the first frame */
+        static int32 CaptureCallstack(void** frames, int32 maxDepth);
+
+        static size_t GetPageSize();
+
+        /** reserve address space without backing memory, nullptr if failed */
+        static void* Reserve(size_t size);
+
+        /** make pages in reserved range accessible, ptr and size should be page aligned */
+        static bool Commit(void* ptr, size_t size);
+
+        /** give pages back to system, range stays reserved */
+        static void Decommit(void* ptr, size_t size);
+
+        /** release whole range returned by Reserve */
+        static void Release(void* ptr, size_t size);
+    private:
+        static uint32 SDefaultAlignment;
+    };
+
+    typedef LinuxMemory PlatformMemory;
+}
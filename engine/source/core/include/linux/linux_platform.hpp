@@ -0,0 +1,22 @@
+#pragma once
+
+#include "global/details/platform_type.hpp"
+
+namespace Engine
+{
+    struct LinuxPlatformType : public PlatformType
+    {
+        typedef decltype(sizeof(0))                     size_t;
+        typedef decltype((char*)nullptr - (char*)nullptr) ptrdiff;
+        typedef int64                                   intptr;
+        typedef uint64                                  uintptr;
+        typedef uint32                                  wcharsize;
+    };
+
+    typedef LinuxPlatformType CorePlatformType;
+
+    #define DLLIMPORT __attribute__((visibility("default")))
+    #define DLLEXPORT __attribute__((visibility("default")))
+
+    #define NODISCARD [[nodiscard]]
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "log/log_format.hpp"
+#include "foundation/array.hpp"
+#include "foundation/map.hpp"
+#include "foundation/smart_ptr.hpp"
+
+namespace Engine
+{
+    class FileReader;
+    class FileWriter;
+
+    /**
+     * Binary log keeps raw arguments of deferred messages, format strings are written once per call site,
+     * so logging costs a memcpy and nothing is formatted until it's decoded, see BinaryLogReader.
+     * Layout, little endian: magic, version, then records each starts with EBinaryLogRecord.
+     */
+    enum class EBinaryLogRecord : uint8
+    {
+        /** id, level, line, category, file, format, argument number and types */
+        Site = 1,
+        /** site id, time, thread id, size and raw arguments */
+        Message = 2,
+        /** level, category, time, thread id and text, for messages formatted on logging thread */
+        Text = 3
+    };
+
+    class CORE_API BinaryLogWriter
+    {
+    public:
+        static constexpr uint32 MAGIC = 0x4C424C50;
+        static constexpr uint32 VERSION = 1;
+
+        explicit BinaryLogWriter(const String& filePath);
+
+        ~BinaryLogWriter();
+
+        bool IsValid() const;
+
+        bool HasError() const;
+
+        void WriteMessage(const LogSite& site, int64 time, uint64 threadId, const uint8* args, int32 size);
+
+        void WriteText(spdlog::level::level_enum level, StringView category, int64 time, uint64 threadId, StringView text);
+
+        bool Flush();
+
+    private:
+        void WriteString(StringView str);
+
+        UniquePtr<FileWriter> Writer;
+        /** ids of sites already written */
+        Map<uint64, uint32> SiteIds;
+    };
+
+    /** offline decoder of binary log, it doesn't need the binary which wrote the log */
+    class CORE_API BinaryLogReader
+    {
+    public:
+        explicit BinaryLogReader(const String& filePath);
+
+        ~BinaryLogReader();
+
+        /** false if file can't be opened or isn't a binary log */
+        bool IsValid() const { return Valid; }
+
+        /** @return false at end of log or if it's corrupted, see HasError */
+        bool Next(LogEntry& outEntry);
+
+        bool HasError() const { return Error; }
+
+        /** decode binary log into text log with the same layout engine log uses */
+        static bool ConvertToText(const String& binaryPath, const String& textPath);
+
+    private:
+        struct Site
+        {
+            spdlog::level::level_enum Level{ spdlog::level::off };
+            int32 Line{ 0 };
+            String Category;
+            String File;
+            String Format;
+            Array<ELogArgType> ArgTypes;
+        };
+
+        bool ReadSite();
+
+        bool ReadString(String& outStr);
+
+        UniquePtr<FileReader> Reader;
+        /** indexed by site id */
+        Array<Site> Sites;
+        Array<uint8> Args;
+        fmt::memory_buffer Buffer;
+        bool Valid{ false };
+        bool Error{ false };
+    };
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "spdlog/sinks/sink.h"
+#include "global.hpp"
+#include "definitions_core.hpp"
+#include "foundation/array.hpp"
+#include "foundation/smart_ptr.hpp"
+#include "foundation/string.hpp"
+#include "log/log_file.hpp"
+#include "log/log_format.hpp"
+
+namespace Engine
+{
+    enum class ELogOverflowPolicy : uint8
+    {
+        /** logging thread waits until writer thread makes room, nothing is lost */
+        Block,
+        /** message is dropped and counted, writer thread reports how many are lost */
+        Drop
+    };
+
+    class ThreadLogQueue;
+    struct LogRecord;
+    class BinaryLogWriter;
+    class StructuredLogWriter;
+
+    /**
+     * Shared asynchronous pipeline behind all log categories.
+     * Every logging thread owns a lock-free single producer queue, one writer thread merges them by time and
+     * writes into console, a text log and a structured log shared by all categories, so logging threads never wait for io.
+     * Log files are kept across runs and rotated, see RotatingLogFile.
+     * Messages are flushed on Flush, on LOG_FATAL, on exit and when the process crashes.
+     * Messages whose arguments can be recorded are formatted on writer thread, or not at all once binary log is open.
+     */
+    class CORE_API LogBackend
+    {
+    public:
+        /** messages each thread can hold before overflow policy applies */
+        static constexpr int32 QUEUE_CAPACITY = 4096;
+        /** writer thread wakes up at least this often */
+        static constexpr int32 WRITE_INTERVAL_MS = 10;
+
+        static LogBackend& Get();
+
+        /** sink which pushes into queue of calling thread, every category logger uses it */
+        const std::shared_ptr<spdlog::sinks::sink>& GetSink() const { return Sink; }
+
+        /** queue a message to be formatted later, args are serialized by LogArgs, used by log macros */
+        void PushDeferred(const LogSite& site, const uint8* args, int32 size);
+
+        /** block until messages logged before it are written and flushed to device */
+        void Flush();
+
+        /** stop writer thread after writing everything, messages logged later are written synchronously */
+        void Shutdown();
+
+        void SetOverflowPolicy(ELogOverflowPolicy policy) { OverflowPolicy.store(policy, std::memory_order_relaxed); }
+
+        ELogOverflowPolicy GetOverflowPolicy() const { return OverflowPolicy.load(std::memory_order_relaxed); }
+
+        /** number of messages dropped since start, including ones logged from inside backend which only go to stderr */
+        int64 GetDroppedNum() const { return DroppedNum.load(std::memory_order_relaxed); }
+
+        /**
+         * Write all following messages into a binary log instead of formatting them, see BinaryLogReader.
+         * Messages of warning and above are still formatted into console and text log.
+         */
+        bool OpenBinaryLog(const String& filePath);
+
+        /** write out queued messages and close binary log, following messages are formatted again */
+        void CloseBinaryLog();
+
+        /**
+         * Replace structured log, see StructuredLogWriter.
+         * By default it's written to logs/engine_log.jsonl in engine save directory.
+         */
+        bool OpenStructuredLog(const String& filePath, const LogRotationPolicy& policy = LogRotationPolicy());
+
+        void CloseStructuredLog();
+
+        /**
+         * Write queued messages on calling thread without waiting for writer thread, used when process is crashing.
+         * It's called through crash handlers installed on start, never from inside a signal handler.
+         */
+        static void FlushOnCrash();
+
+    private:
+        friend class AsyncLogSink;
+
+        LogBackend();
+
+        ~LogBackend();
+
+        void Push(const spdlog::details::log_msg& msg);
+
+        template <typename Fill>
+        void PushRecord(spdlog::level::level_enum level, Fill&& fill);
+
+        ThreadLogQueue& GetThreadQueue();
+
+        void Run();
+
+        /** merge messages of all queues by time and write them, must be called with SinkMutex held */
+        bool WriteQueued();
+
+        /** must be called with SinkMutex held */
+        void WriteRecord(const LogRecord& record);
+
+        /** message logged from inside backend can't be queued, it's counted as dropped and only written to stderr */
+        static void WriteToStderr(const LogRecord& record);
+
+        void WriteDroppedReport();
+
+        void FlushSinks();
+
+        void Wake();
+
+        std::shared_ptr<spdlog::sinks::sink> Sink;
+        Array<std::shared_ptr<spdlog::sinks::sink>> OutputSinks;
+        /** guards output sinks, held by writer thread while writing */
+        std::mutex SinkMutex;
+        UniquePtr<BinaryLogWriter> BinaryWriter;
+        UniquePtr<StructuredLogWriter> StructuredWriter;
+        fmt::memory_buffer DecodeBuffer;
+
+        /** guards queue list */
+        std::mutex QueuesMutex;
+        Array<SharedPtr<ThreadLogQueue>> Queues;
+
+        std::mutex WakeMutex;
+        std::condition_variable WakeCondition;
+        std::condition_variable FlushedCondition;
+        uint64 FlushRequest{ 0 };
+        uint64 FlushDone{ 0 };
+        std::atomic<bool> WriterWaiting{ false };
+        std::atomic<bool> Running{ false };
+        std::atomic<bool> Stopping{ false };
+        std::thread Writer;
+
+        std::atomic<ELogOverflowPolicy> OverflowPolicy{ ELogOverflowPolicy::Block };
+        std::atomic<int64> DroppedNum{ 0 };
+        int64 ReportedDroppedNum{ 0 };
+    };
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "global.hpp"
+#include "definitions_core.hpp"
+#include "foundation/array.hpp"
+#include "foundation/smart_ptr.hpp"
+#include "foundation/string.hpp"
+
+namespace Engine
+{
+    class FileWriter;
+
+    struct LogRotationPolicy
+    {
+        /** rotate once file would grow beyond it, 0 disables */
+        int64 MaxFileSize{ 32ll << 20 };
+        /** rotate once file is written for longer than it since it's opened, 0 disables */
+        int64 MaxFileAgeSeconds{ 24 * 3600 };
+        /** oldest rotated files beyond it are removed, 0 keeps all */
+        int32 MaxRotatedFiles{ 16 };
+        /** rotated files are compressed with lz4 blocks, see ReadFile */
+        bool Compress{ true };
+    };
+
+    /**
+     * Log file appended across runs, so history isn't lost on restart.
+     * Once it's too big or too old it's renamed to name.yyyymmdd-hhmmss.ext and a new file is started, renamed file
+     * is compressed and old files are removed on an archive thread, so writer isn't held up by them.
+     * Not thread safe, it's owned by writer thread of LogBackend. Destructor waits for archive thread to finish.
+     */
+    class CORE_API RotatingLogFile
+    {
+    public:
+        static constexpr uint32 COMPRESSED_MAGIC = 0x345A4C50;
+        static constexpr const char* COMPRESSED_EXTENSION = ".lz4";
+
+        explicit RotatingLogFile(const String& filePath, const LogRotationPolicy& policy = LogRotationPolicy());
+
+        ~RotatingLogFile();
+
+        RotatingLogFile(const RotatingLogFile& other) = delete;
+
+        RotatingLogFile& operator= (const RotatingLogFile& other) = delete;
+
+        bool IsValid() const { return Writer != nullptr; }
+
+        /** rotate first if data doesn't fit in current file, a record is never split across files */
+        bool Write(const uint8* data, int64 size);
+
+        bool Flush(bool toDevice = false);
+
+        bool Rotate();
+
+        int64 GetSize() const { return Size; }
+
+        const String& GetFilePath() const { return FilePath; }
+
+        /** rotated files of a log, oldest first */
+        static Array<String> GetRotatedFiles(const String& filePath);
+
+        /** compress src into dest as a sequence of independent lz4 blocks */
+        static bool CompressFile(const String& src, const String& dest);
+
+        /** read a plain or compressed log file */
+        static bool ReadFile(const String& path, Array64<uint8>& outData);
+
+    private:
+        bool Open();
+
+        String MakeRotatedPath() const;
+
+        /** queue rotated file for archive thread, which is started on first rotation */
+        void Archive(const String& rotatedPath);
+
+        void RunArchiver();
+
+        void RemoveOldFiles();
+
+        String FilePath;
+        LogRotationPolicy Policy;
+        UniquePtr<FileWriter> Writer;
+        int64 Size{ 0 };
+        /** seconds since epoch */
+        int64 OpenTime{ 0 };
+        std::thread Archiver;
+        std::mutex ArchiveMutex;
+        std::condition_variable ArchiveCondition;
+        Array<String> ArchiveQueue;
+        bool ArchiveStop{ false };
+    };
+}
@@ -0,0 +1,370 @@
+#pragma once
+
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include "spdlog/common.h"
+#include "global.hpp"
+#include "definitions_core.hpp"
+#include "foundation/array.hpp"
+#include "foundation/string.hpp"
+
+namespace Engine
+{
+    /** type of argument recorded by deferred logging, serialized into binary log so don't reorder */
+    enum class ELogArgType : uint8
+    {
+        /** can't be recorded, message is formatted on logging thread */
+        None,
+        Bool,
+        Char,
+        Int32,
+        UInt32,
+        Int64,
+        UInt64,
+        Float,
+        Double,
+        String,
+        Pointer,
+        /** flag combined with value type, argument is a named field, eg: LogField("path", path) */
+        Named = 0x80
+    };
+
+    constexpr ELogArgType MakeNamedLogArgType(ELogArgType type)
+    {
+        return static_cast<ELogArgType>(static_cast<uint8>(type) | static_cast<uint8>(ELogArgType::Named));
+    }
+
+    constexpr bool IsNamedLogArgType(ELogArgType type)
+    {
+        return (static_cast<uint8>(type) & static_cast<uint8>(ELogArgType::Named)) != 0;
+    }
+
+    constexpr ELogArgType GetLogArgValueType(ELogArgType type)
+    {
+        return static_cast<ELogArgType>(static_cast<uint8>(type) & ~static_cast<uint8>(ELogArgType::Named));
+    }
+
+    /**
+     * Named argument of a log, it's referenced by name in format string and kept as a key value field
+     * by structured log, eg: LOG_INFO(FileSystem, "Mount {pak}", LogField("pak", path))
+     */
+    template <typename T>
+    fmt::detail::named_arg<char, T> LogField(const char* name, const T& value)
+    {
+        return fmt::arg(name, value);
+    }
+
+    template <typename T>
+    struct IsLogField : std::false_type {};
+
+    template <typename T>
+    struct IsLogField<fmt::detail::named_arg<char, T>> : std::true_type
+    {
+        using ValueType = T;
+    };
+
+    /**
+     * Everything about a log call known at compile time, one constant instance per call site.
+     * Deferred messages only carry a pointer to it plus raw arguments, formatting happens on writer thread
+     * or when binary log is decoded.
+     */
+    struct LogSite
+    {
+        const char* Category{ nullptr };
+        spdlog::level::level_enum Level{ spdlog::level::off };
+        const char* Format{ nullptr };
+        /** nullptr if source isn't recorded */
+        const char* File{ nullptr };
+        int32 Line{ 0 };
+        const ELogArgType* ArgTypes{ nullptr };
+        int32 ArgNum{ 0 };
+    };
+
+    template <typename T>
+    constexpr ELogArgType GetLogArgType()
+    {
+        using Type = std::remove_cvref_t<T>;
+        using DecayType = std::decay_t<T>;
+        if constexpr (IsLogField<Type>::value)
+        {
+            constexpr ELogArgType valueType = GetLogArgType<typename IsLogField<Type>::ValueType>();
+            return valueType == ELogArgType::None ? ELogArgType::None : MakeNamedLogArgType(valueType);
+        }
+        else if constexpr (std::is_same_v<Type, bool>)
+        {
+            return ELogArgType::Bool;
+        }
+        else if constexpr (std::is_same_v<Type, char>)
+        {
+            return ELogArgType::Char;
+        }
+        else if constexpr (std::is_integral_v<Type> && !std::is_same_v<Type, wchar_t> && sizeof(Type) <= 8)
+        {
+            if constexpr (std::is_signed_v<Type>)
+            {
+                return sizeof(Type) <= 4 ? ELogArgType::Int32 : ELogArgType::Int64;
+            }
+            else
+            {
+                return sizeof(Type) <= 4 ? ELogArgType::UInt32 : ELogArgType::UInt64;
+            }
+        }
+        else if constexpr (std::is_same_v<Type, float>)
+        {
+            return ELogArgType::Float;
+        }
+        else if constexpr (std::is_same_v<Type, double>)
+        {
+            return ELogArgType::Double;
+        }
+        else if constexpr (std::is_same_v<DecayType, const char*> || std::is_same_v<DecayType, char*> ||
+                           std::is_same_v<Type, String> || std::is_same_v<Type, std::string> ||
+                           std::is_same_v<Type, std::string_view>)
+        {
+            return ELogArgType::String;
+        }
+        else if constexpr (std::is_same_v<DecayType, const void*> || std::is_same_v<DecayType, void*> ||
+                           std::is_same_v<Type, std::nullptr_t>)
+        {
+            return ELogArgType::Pointer;
+        }
+        else
+        {
+            return ELogArgType::None;
+        }
+    }
+
+    /**
+     * Serialize log arguments into bytes in native layout, strings are stored as uint32 length and characters.
+     * Name of a field is stored before its value as a string followed by '\0'.
+     */
+    template <typename... Args>
+    struct LogArgs
+    {
+        static constexpr ELogArgType TYPES[sizeof...(Args) + 1] = { GetLogArgType<Args>()..., ELogArgType::None };
+
+        /** all arguments can be recorded, so message can be formatted later */
+        static constexpr bool DEFERRABLE = ((GetLogArgType<Args>() != ELogArgType::None) && ...);
+
+        static constexpr LogSite MakeSite(LogSite site)
+        {
+            site.ArgTypes = TYPES;
+            site.ArgNum = static_cast<int32>(sizeof...(Args));
+            return site;
+        }
+
+        static int32 GetSize(const Args&... args)
+        {
+            return (0 + ... + GetArgSize(args));
+        }
+
+        static void Write(uint8* dest, const Args&... args)
+        {
+            ((dest = WriteArg(dest, args)), ...);
+        }
+
+    private:
+        template <typename T>
+        static std::string_view ToStringView(const T& arg)
+        {
+            using Type = std::remove_cvref_t<T>;
+            if constexpr (std::is_same_v<Type, String>)
+            {
+                return std::string_view(arg.Data(), static_cast<size_t>(arg.Length()));
+            }
+            else if constexpr (std::is_same_v<Type, std::string> || std::is_same_v<Type, std::string_view>)
+            {
+                return std::string_view(arg);
+            }
+            else
+            {
+                return arg != nullptr ? std::string_view(arg) : std::string_view("(null)");
+            }
+        }
+
+        template <typename T>
+        static int32 GetArgSize(const T& arg)
+        {
+            constexpr ELogArgType type = GetLogArgType<T>();
+            if constexpr (IsNamedLogArgType(type))
+            {
+                return static_cast<int32>(sizeof(uint32) + std::strlen(arg.name) + 1) + GetArgSize(arg.value);
+            }
+            else if constexpr (type == ELogArgType::String)
+            {
+                return static_cast<int32>(sizeof(uint32) + ToStringView(arg).size());
+            }
+            else if constexpr (type == ELogArgType::Bool || type == ELogArgType::Char)
+            {
+                return 1;
+            }
+            else if constexpr (type == ELogArgType::Int32 || type == ELogArgType::UInt32 || type == ELogArgType::Float)
+            {
+                return 4;
+            }
+            else
+            {
+                return 8;
+            }
+        }
+
+        template <typename T>
+        static uint8* WriteArg(uint8* dest, const T& arg)
+        {
+            constexpr ELogArgType type = GetLogArgType<T>();
+            if constexpr (IsNamedLogArgType(type))
+            {
+                const uint32 length = static_cast<uint32>(std::strlen(arg.name));
+                std::memcpy(dest, &length, sizeof(length));
+                std::memcpy(dest + sizeof(length), arg.name, length + 1);
+                return WriteArg(dest + sizeof(length) + length + 1, arg.value);
+            }
+            else if constexpr (type == ELogArgType::String)
+            {
+                const std::string_view view = ToStringView(arg);
+                const uint32 length = static_cast<uint32>(view.size());
+                std::memcpy(dest, &length, sizeof(length));
+                std::memcpy(dest + sizeof(length), view.data(), view.size());
+                return dest + sizeof(length) + view.size();
+            }
+            else if constexpr (type == ELogArgType::Bool || type == ELogArgType::Char)
+            {
+                *dest = static_cast<uint8>(arg);
+                return dest + 1;
+            }
+            else if constexpr (type == ELogArgType::Int32)
+            {
+                return WriteValue(dest, static_cast<int32>(arg));
+            }
+            else if constexpr (type == ELogArgType::UInt32)
+            {
+                return WriteValue(dest, static_cast<uint32>(arg));
+            }
+            else if constexpr (type == ELogArgType::Int64)
+            {
+                return WriteValue(dest, static_cast<int64>(arg));
+            }
+            else if constexpr (type == ELogArgType::UInt64)
+            {
+                return WriteValue(dest, static_cast<uint64>(arg));
+            }
+            else if constexpr (type == ELogArgType::Pointer)
+            {
+                return WriteValue(dest, static_cast<uint64>(reinterpret_cast<uintptr_t>(static_cast<const void*>(arg))));
+            }
+            else
+            {
+                return WriteValue(dest, arg);
+            }
+        }
+
+        template <typename T>
+        static uint8* WriteValue(uint8* dest, T value)
+        {
+            std::memcpy(dest, &value, sizeof(T));
+            return dest + sizeof(T);
+        }
+    };
+
+    /** recorded argument read back by LogArgReader */
+    struct LogArgValue
+    {
+        /** without Named flag */
+        ELogArgType Type{ ELogArgType::None };
+        /** empty unless it's a named field, it's followed by '\0' */
+        std::string_view Name;
+        union
+        {
+            bool Bool;
+            char Char;
+            int64 Int;
+            uint64 UInt;
+            double Float;
+            const void* Pointer;
+        };
+        /** characters of a String argument */
+        std::string_view Str;
+
+        LogArgValue() : UInt(0) {}
+    };
+
+    /** read arguments serialized by LogArgs, bytes aren't copied so they must be kept while values are used */
+    class CORE_API LogArgReader
+    {
+    public:
+        LogArgReader(const ELogArgType* argTypes, int32 argNum, const uint8* args, int32 size)
+            : ArgTypes(argTypes), ArgNum(argNum), Cursor(args), End(args + size)
+        {}
+
+        /** @return false after last argument or if arguments are corrupted, see HasError */
+        bool Next(LogArgValue& outValue);
+
+        bool HasError() const { return Error; }
+
+        /** all arguments are read and nothing is left */
+        bool IsFinished() const { return !Error && Index == ArgNum && Cursor == End; }
+
+    private:
+        bool ReadString(std::string_view& outStr);
+
+        const ELogArgType* ArgTypes;
+        int32 ArgNum;
+        int32 Index{ 0 };
+        const uint8* Cursor;
+        const uint8* End;
+        bool Error{ false };
+    };
+
+    struct LogEntryField
+    {
+        String Key;
+        /** value formatted as text */
+        String Value;
+    };
+
+    /** a message read back from binary or structured log */
+    struct LogEntry
+    {
+        /** nanoseconds since epoch */
+        int64 Time{ 0 };
+        uint64 ThreadId{ 0 };
+        spdlog::level::level_enum Level{ spdlog::level::off };
+        String Category;
+        String File;
+        int32 Line{ 0 };
+        String Message;
+        /** named arguments of message */
+        Array<LogEntryField> Fields;
+    };
+
+    class CORE_API LogFormatter
+    {
+    public:
+        /** layout of console and text log */
+        static constexpr const char* TEXT_PATTERN = "[%n] [%D] [%H:%M:%S] [%l] %v%$";
+
+        /** format entry like text log does, fields are appended as key=value */
+        static void FormatText(const LogEntry& entry, spdlog::memory_buf_t& out);
+
+        /** format a single argument alone with "{}" */
+        static void FormatValue(const LogArgValue& value, fmt::memory_buffer& out);
+
+        /** read named arguments as fields */
+        static bool ReadFields(const ELogArgType* argTypes, int32 argNum, const uint8* args, int32 size,
+                               Array<LogEntryField>& outFields);
+
+        /**
+         * Format recorded arguments with format string of site, result is appended to out.
+         * @return false if arguments don't match site, eg: read from a corrupted binary log
+         */
+        static bool Format(const char* format, const ELogArgType* argTypes, int32 argNum, const uint8* args, int32 size,
+                           fmt::memory_buffer& out);
+
+        static bool Format(const LogSite& site, const uint8* args, int32 size, fmt::memory_buffer& out)
+        {
+            return Format(site.Format, site.ArgTypes, site.ArgNum, args, size, out);
+        }
+    };
+}
@@ -1,13 +1,13 @@
 #pragma once
 
+#include <atomic>
 #include "spdlog/spdlog.h"
-#include "spdlog/sinks/basic_file_sink.h"
-#include "spdlog/sinks/stdout_color_sinks.h"
-#include "spdlog/pattern_formatter.h"
 #include "foundation/string.hpp"
 #include "foundation/smart_ptr.hpp"
 #include "file_system/path.hpp"
 #include "file_system/file_system.hpp"
+#include "log/log_backend.hpp"
+#include "log/log_format.hpp"
 
 namespace Engine
 {
@@ -22,51 +22,116 @@ namespace Engine
         Off = SPDLOG_LEVEL_OFF,
     };
 
+    /**
+     * Categories are compiled out below this level, arguments of stripped logs aren't even evaluated.
+     * Shipping build keeps info and above only, so debug and trace sites cost nothing there.
+     */
+#ifndef LOG_COMPILE_TIME_LEVEL
+#   if defined(DEBUG)
+#       define LOG_COMPILE_TIME_LEVEL ELogLevel::Trace
+#   elif defined(SHIPPING)
+#       define LOG_COMPILE_TIME_LEVEL ELogLevel::Info
+#   else
+#       define LOG_COMPILE_TIME_LEVEL ELogLevel::Debug
+#   endif
+#endif
+
+    /** runtime level of categories by name, so they can be changed by config or command line */
+    class CORE_API LogCategoryRegistry
+    {
+    public:
+        static void Register(const char* name, std::atomic<int32>& level);
+
+        /** called when level is destroyed, eg: module declaring the category is unloaded */
+        static void Unregister(std::atomic<int32>& level);
+
+        /** @return false if there is no such category */
+        static bool SetLevel(StringView name, ELogLevel level);
+
+        static void SetAllLevels(ELogLevel level);
+    };
+
     class CORE_API GLogCategory
     {
+    protected:
+        struct Registrar
+        {
+            Registrar(const char* name, std::atomic<int32>& level) : Level(level) { LogCategoryRegistry::Register(name, level); }
 
+            ~Registrar() { LogCategoryRegistry::Unregister(Level); }
+
+            std::atomic<int32>& Level;
+        };
     };
 
-#define DECLARE_LOG_CATEGORY(name) \
+    /**
+     * @param defaultLevel runtime level on start
+     * @param compileTimeLevel logs below it are compiled out
+     */
+#define DECLARE_LOG_CATEGORY_EX(name, defaultLevel, compileTimeLevel) \
     class GLogCategory_##name : public GLogCategory \
     { \
     public: \
+        static constexpr const char* NAME = #name; \
+        static constexpr ELogLevel COMPILE_TIME_LEVEL = compileTimeLevel; \
+        static bool IsEnabled(ELogLevel level) { return level >= RuntimeLevel.load(std::memory_order_relaxed); } \
+        static void SetLevel(ELogLevel level) { RuntimeLevel.store(level, std::memory_order_relaxed); } \
         static spdlog::logger* GetLogger() \
         { \
-            static UniquePtr<spdlog::logger> logger; \
-            if (logger == nullptr) \
-            { \
-                std::vector<spdlog::sink_ptr> sinks; \
-                auto colorSink = MakeShared<spdlog::sinks::stdout_color_sink_mt>(); \
-                colorSink->set_color(spdlog::level::info, 0xffff); \
-                sinks.push_back(colorSink); \
-                String save = Path::Combine(FileSystem::GetEngineSaveDir(), "logs/engine_log.txt"); \
-                sinks.push_back(MakeShared<spdlog::sinks::basic_file_sink_mt>(save.Data(), true)); \
-                logger = MakeUnique<spdlog::logger>(#name, begin(sinks), end(sinks)); \
-                logger->set_pattern("[%n] [%D] [%H:%M:%S] [%l] %v%$"); \
-            } \
-            return logger.get(); \
+            static spdlog::logger* logger = LogSystem::CreateLogger(#name); \
+            return logger; \
         } \
+    private: \
+        inline static std::atomic<int32> RuntimeLevel{ defaultLevel }; \
+        inline static Registrar LevelRegistrar{ #name, RuntimeLevel }; \
     }
 
-    DECLARE_LOG_CATEGORY(LogTemp);
+#define DECLARE_LOG_CATEGORY(name) DECLARE_LOG_CATEGORY_EX(name, ELogLevel::Info, LOG_COMPILE_TIME_LEVEL)
 
     class CORE_API LogSystem
     {
     public:
-        template<typename... Args>
-        static void Log(spdlog::logger* logger, spdlog::source_loc src, ELogLevel level, fmt::format_string<Args...> fmt, Args&&... args)
-        {
-            logger->log(src, CastLevel(level), fmt, std::forward<Args>(args)...);
-        }
+        /** arguments are kept in a stack buffer up to this size */
+        static constexpr int32 INLINE_ARGS_SIZE = 256;
+
+        /** logger for messages which can't be deferred, it's never destroyed so logging on exit is fine */
+        static spdlog::logger* CreateLogger(const char* name);
 
-        template<typename... Args>
-        static void Log(spdlog::logger* logger, ELogLevel level, fmt::format_string<Args...> fmt, Args&&... args)
+        /**
+         * Log through backend, level is already checked by macro.
+         * Message is formatted later if all arguments can be recorded, see LogArgs, otherwise it's formatted here.
+         * @param siteMaker constexpr callable returns LogSite of the call site
+         */
+        template <typename Category, typename SiteMaker, typename... Args>
+        static void Log(SiteMaker siteMaker, fmt::format_string<Args...> format, Args&&... args)
         {
-            logger->log(CastLevel(level), fmt, std::forward<Args>(args)...);
+            using Recorder = LogArgs<std::remove_cvref_t<Args>...>;
+            if constexpr (Recorder::DEFERRABLE)
+            {
+                static constexpr LogSite site = Recorder::MakeSite(SiteMaker()());
+                const int32 size = Recorder::GetSize(args...);
+                if (size <= INLINE_ARGS_SIZE)
+                {
+                    uint8 buffer[INLINE_ARGS_SIZE];
+                    Recorder::Write(buffer, args...);
+                    LogBackend::Get().PushDeferred(site, buffer, size);
+                }
+                else
+                {
+                    Array<uint8> buffer;
+                    buffer.Resize(size);
+                    Recorder::Write(buffer.Data(), args...);
+                    LogBackend::Get().PushDeferred(site, buffer.Data(), size);
+                }
+            }
+            else
+            {
+                constexpr LogSite site = SiteMaker()();
+                Category::GetLogger()->log(spdlog::source_loc{ site.File, site.Line, nullptr }, site.Level, format,
+                                           std::forward<Args>(args)...);
+            }
         }
 
-    private:
         static constexpr spdlog::level::level_enum CastLevel(ELogLevel level)
         {
             switch (level)
@@ -89,8 +154,24 @@ namespace Engine
         }
     };
 
-    #define PL_LOG_IMPL(level, category, fmt, ...)  {LogSystem::Log(GLogCategory_##category::GetLogger(), spdlog::source_loc{ __FILE__, __LINE__, SPDLOG_FUNCTION }, level, fmt, ## __VA_ARGS__);}
-    #define PL_LOG_WITHOUT_SOURCE(level, category, fmt, ...)  {LogSystem::Log(GLogCategory_##category::GetLogger(), level, fmt, ## __VA_ARGS__);}
+    DECLARE_LOG_CATEGORY(LogTemp);
+
+    /** level is checked with one relaxed load, logs below compile time level of category cost nothing */
+    #define PL_LOG_SITE(level, category, fmt, file, line, ...) \
+        { \
+            if constexpr (level >= GLogCategory_##category::COMPILE_TIME_LEVEL) \
+            { \
+                if (GLogCategory_##category::IsEnabled(level)) \
+                { \
+                    LogSystem::Log<GLogCategory_##category>([]() constexpr { \
+                        return LogSite{ #category, LogSystem::CastLevel(level), fmt, file, line }; \
+                    }, fmt, ## __VA_ARGS__); \
+                } \
+            } \
+        }
+
+    #define PL_LOG_IMPL(level, category, fmt, ...) PL_LOG_SITE(level, category, fmt, __FILE__, __LINE__, ## __VA_ARGS__)
+    #define PL_LOG_WITHOUT_SOURCE(level, category, fmt, ...) PL_LOG_SITE(level, category, fmt, nullptr, 0, ## __VA_ARGS__)
 
     #define LOG_VERBOSE(category, fmt, ...) PL_LOG_WITHOUT_SOURCE(Trace, category, fmt, ## __VA_ARGS__)
     #define LOG_INFO(category, fmt, ...) PL_LOG_WITHOUT_SOURCE(Info, category, fmt, ## __VA_ARGS__)
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "log/log_file.hpp"
+#include "log/log_format.hpp"
+
+namespace Engine
+{
+    /** a message passed to StructuredLogWriter, nothing is copied */
+    struct StructuredLogRecord
+    {
+        /** nanoseconds since epoch */
+        int64 Time{ 0 };
+        uint64 ThreadId{ 0 };
+        spdlog::level::level_enum Level{ spdlog::level::off };
+        StringView Category;
+        /** nullptr if source isn't recorded */
+        const char* File{ nullptr };
+        int32 Line{ 0 };
+        StringView Message;
+        /** recorded arguments of a deferred message, named ones are written as fields */
+        const LogSite* Site{ nullptr };
+        const uint8* Args{ nullptr };
+        int32 ArgsSize{ 0 };
+    };
+
+    /**
+     * JSON lines log, one object per message so it can be ingested without parsing text, eg:
+     * {"time":"2022-06-01T08:00:00.000000Z","thread":42,"level":"info","category":"FileSystem","file":"pak_file.cpp",
+     *  "line":12,"message":"Mount a.pak","fields":{"pak":"a.pak","entries":12}}
+     * file, line and fields are omitted if there are none. File is appended across runs and rotated, see RotatingLogFile.
+     */
+    class CORE_API StructuredLogWriter
+    {
+    public:
+        explicit StructuredLogWriter(const String& filePath, const LogRotationPolicy& policy = LogRotationPolicy());
+
+        bool IsValid() const { return File.IsValid(); }
+
+        void Write(const StructuredLogRecord& record);
+
+        bool Flush() { return File.Flush(); }
+
+        RotatingLogFile& GetFile() { return File; }
+
+    private:
+        RotatingLogFile File;
+        fmt::memory_buffer Line;
+        fmt::memory_buffer Value;
+    };
+
+    /** read structured log written by StructuredLogWriter, a compressed rotated file can be read directly */
+    class CORE_API StructuredLogReader
+    {
+    public:
+        explicit StructuredLogReader(const String& filePath);
+
+        bool IsValid() const { return Valid; }
+
+        /** @return false at end of log, a malformed line is skipped and counted */
+        bool Next(LogEntry& outEntry);
+
+        int32 GetMalformedLineNum() const { return MalformedLineNum; }
+
+        /** parse one JSON line, it only has to understand what StructuredLogWriter writes */
+        static bool ParseLine(StringView line, LogEntry& outEntry);
+
+    private:
+        Array64<uint8> Data;
+        int64 Cursor{ 0 };
+        int32 MalformedLineNum{ 0 };
+        bool Valid{ false };
+    };
+}
@@ -11,4 +11,12 @@ namespace Engine
 
         return (T)(((uint64)value + aligment - 1) & ~(aligment - 1));
     }
+
+    template<typename T>
+    bool IsAligned(T value, uint64 alignment)
+    {
+        static_assert(std::is_integral_v<T> || std::is_pointer_v<T>, "IsAligned expects an integer or pointer type");
+
+        return ((uint64)value & (alignment - 1)) == 0;
+    }
 }
\ No newline at end of file
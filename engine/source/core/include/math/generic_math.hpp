@@ -1,6 +1,7 @@
 #pragma once
 
 #include <bit>
+#include <climits>
 #include <cmath>
 #include "definitions_core.hpp"
 #include "foundation/type_traits.hpp"
@@ -52,7 +53,7 @@ namespace Engine
 
         static float FMod(float a, float b)
         {
-            return std::fmodf(a, b);
+            return std::fmod(a, b);
         }
 
         template <typename T>
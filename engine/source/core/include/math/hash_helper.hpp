@@ -10,5 +10,11 @@ namespace Engine
         static uint64 FnvHash(const char* str, uint64 n) noexcept;
 
         static uint64 FnvHash(const StringView& str) noexcept;
+
+        /**
+         * Castagnoli crc32, same value on every cpu, sse4.2 crc32 instruction is used when CpuFeatures has it
+         * @param crc result of the previous block to continue a checksum, 0 to start one
+         */
+        static uint32 Crc32c(const void* data, size_t size, uint32 crc = 0) noexcept;
     };
 }
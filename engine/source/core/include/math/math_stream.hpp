@@ -0,0 +1,203 @@
+#pragma once
+
+#include "foundation/array.hpp"
+#include "math/transform.hpp"
+
+namespace Engine
+{
+    /**
+     * Vectors stored as one array per component (SoA), so batch kernels load as many vectors as registers are wide
+     */
+    struct CORE_API Vector3Stream
+    {
+        Vector3Stream() = default;
+
+        explicit Vector3Stream(int32 num) { Resize(num); }
+
+        int32 Size() const { return X.Size(); }
+
+        void Resize(int32 num)
+        {
+            X.Resize(num);
+            Y.Resize(num);
+            Z.Resize(num);
+        }
+
+        void Reserve(int32 num)
+        {
+            X.Reserve(num);
+            Y.Reserve(num);
+            Z.Reserve(num);
+        }
+
+        void Add(const Vector3f& vector)
+        {
+            X.Add(vector.X);
+            Y.Add(vector.Y);
+            Z.Add(vector.Z);
+        }
+
+        Vector3f Get(int32 index) const
+        {
+            return Vector3f(X[index], Y[index], Z[index]);
+        }
+
+        void Set(int32 index, const Vector3f& vector)
+        {
+            X[index] = vector.X;
+            Y[index] = vector.Y;
+            Z[index] = vector.Z;
+        }
+
+        Array<float> X;
+        Array<float> Y;
+        Array<float> Z;
+    };
+
+    struct CORE_API QuatStream
+    {
+        QuatStream() = default;
+
+        explicit QuatStream(int32 num) { Resize(num); }
+
+        int32 Size() const { return X.Size(); }
+
+        void Resize(int32 num)
+        {
+            X.Resize(num);
+            Y.Resize(num);
+            Z.Resize(num);
+            W.Resize(num);
+        }
+
+        void Reserve(int32 num)
+        {
+            X.Reserve(num);
+            Y.Reserve(num);
+            Z.Reserve(num);
+            W.Reserve(num);
+        }
+
+        void Add(const Quat& quat)
+        {
+            X.Add(quat.X);
+            Y.Add(quat.Y);
+            Z.Add(quat.Z);
+            W.Add(quat.W);
+        }
+
+        Quat Get(int32 index) const
+        {
+            return Quat(X[index], Y[index], Z[index], W[index]);
+        }
+
+        void Set(int32 index, const Quat& quat)
+        {
+            X[index] = quat.X;
+            Y[index] = quat.Y;
+            Z[index] = quat.Z;
+            W[index] = quat.W;
+        }
+
+        Array<float> X;
+        Array<float> Y;
+        Array<float> Z;
+        Array<float> W;
+    };
+
+    struct CORE_API TransformStream
+    {
+        TransformStream() = default;
+
+        explicit TransformStream(int32 num) { Resize(num); }
+
+        int32 Size() const { return Rotation.Size(); }
+
+        void Resize(int32 num)
+        {
+            Rotation.Resize(num);
+            Translation.Resize(num);
+            Scale.Resize(num);
+        }
+
+        void Reserve(int32 num)
+        {
+            Rotation.Reserve(num);
+            Translation.Reserve(num);
+            Scale.Reserve(num);
+        }
+
+        void Add(const Transform& transform)
+        {
+            Rotation.Add(transform.GetRotation());
+            Translation.Add(transform.GetTranslation());
+            Scale.Add(transform.GetScale());
+        }
+
+        Transform Get(int32 index) const
+        {
+            return Transform(Rotation.Get(index), Translation.Get(index), Scale.Get(index));
+        }
+
+        void Set(int32 index, const Transform& transform)
+        {
+            Rotation.Set(index, transform.GetRotation());
+            Translation.Set(index, transform.GetTranslation());
+            Scale.Set(index, transform.GetScale());
+        }
+
+        QuatStream Rotation;
+        Vector3Stream Translation;
+        Vector3Stream Scale;
+    };
+
+    enum class EMathStreamBackend : uint8
+    {
+        /** per element Vector3f, Quat and Transform methods, the reference other backends are tested against */
+        Scalar,
+        Sse,
+        Avx2,
+        Ispc,
+        /** after Ispc, so values of the backends above stay the same in stored benchmark results */
+        Avx512,
+    };
+
+    /**
+     * Batch kernels over streams, same results as calling the per element method on every element.
+     * Output is resized to size of input and may be one of the inputs.
+     * Backend is picked at runtime, widest one CpuFeatures::GetSimdLevel allows by default.
+     */
+    class CORE_API MathStream
+    {
+    public:
+        MathStream() = delete;
+
+        /** vectors must not be zero, same as Vector3f::Normalize */
+        static void Normalize(Vector3Stream& vectors);
+
+        static void Dot(const Vector3Stream& a, const Vector3Stream& b, Array<float>& outDots);
+
+        static void Cross(const Vector3Stream& a, const Vector3Stream& b, Vector3Stream& outCross);
+
+        static void Normalize(QuatStream& quats);
+
+        /** a[i] * b[i], same order as Quat::operator* */
+        static void Multiply(const QuatStream& a, const QuatStream& b, QuatStream& outQuats);
+
+        static void RotateVector(const QuatStream& quats, const Vector3Stream& vectors, Vector3Stream& outVectors);
+
+        static void Slerp(const QuatStream& src, const QuatStream& dest, float slerp, QuatStream& outQuats);
+
+        /** same as Transform::Multiply(a[i], b[i], out[i]) */
+        static void Multiply(const TransformStream& a, const TransformStream& b, TransformStream& outTransforms);
+
+        static bool IsBackendSupported(EMathStreamBackend backend);
+
+        /** @return false if backend isn't compiled in or cpu doesn't support it, current backend is kept */
+        static bool SetBackend(EMathStreamBackend backend);
+
+        static EMathStreamBackend GetBackend();
+
+        static const char* GetBackendName(EMathStreamBackend backend);
+    };
+}
@@ -4,7 +4,7 @@
 
 namespace Engine
 {
-    struct alignas(16) CORE_API Matrix
+    struct CORE_API Matrix
     {
         Matrix() = default;
 
@@ -16,14 +16,7 @@ namespace Engine
          * @param b
          * @param result
          */
-        static void Multipy(const Matrix& a, const Matrix& b, Matrix& result);
-
-        /**
-         * Pre-multiple a matrix to this
-         * A.operator* B means B * A
-         * @param other
-         * @return
-         */
+        static void Multiply(const Matrix& a, const Matrix& b, Matrix& result);
 
         float& At(int32 row, int32 column)
         {
@@ -41,6 +34,35 @@ namespace Engine
 
         Vector3f GetScale(float tolerance = SMALL_FLOAT) const;
 
+        Matrix GetTransposed() const;
+
+        /**
+         * Identity if matrix is singular
+         * @return
+         */
+        Matrix Inverse() const;
+
+        /**
+         * Row vector times matrix, rows are axes and row 3 is translation
+         * @param vector
+         * @return
+         */
+        Vector4f TransformVector4(const Vector4f& vector) const;
+
+        /** w of position is 1 */
+        Vector3f TransformPosition(const Vector3f& position) const;
+
+        /** w of vector is 0 */
+        Vector3f TransformVector(const Vector3f& vector) const;
+
+        bool Equals(const Matrix& other, float tolerance = KINDA_SMALL_FLOAT) const;
+
+        /**
+         * Pre-multiple a matrix to this
+         * A.operator* B means B * A
+         * @param other
+         * @return
+         */
         Matrix operator* (const Matrix& other) const;
 
         Matrix operator*= (const Matrix& other);
@@ -49,6 +71,6 @@ namespace Engine
 
         static const Matrix Identity;
 
-        float M[4][4];
+        alignas(16) float M[4][4];
     };
 }
\ No newline at end of file
@@ -8,7 +8,7 @@ namespace Engine
     /**
      * https://danceswithcode.net/engineeringnotes/quaternions/quaternions.html
      */
-    struct alignas(16) CORE_API Quat
+    struct CORE_API Quat
     {
         Quat() = default;
 
@@ -67,7 +67,7 @@ namespace Engine
 
         static const Quat Identity;
 
-        float X = 0.0f;
+        alignas(16) float X = 0.0f;
         float Y = 0.0f;
         float Z = 0.0f;
         float W = 0.0f;
@@ -16,6 +16,15 @@
 #include <xmmintrin.h>
 #endif
 
+/**
+ * SUPPORT_SSE41 only means cpu of build machine has it, gcc and clang also need it enabled for the translation unit
+ */
+#if SUPPORT_SSE41 && (defined(COMPILER_MSVC) || defined(__SSE4_1__))
+#define USE_SSE41_INTRINSICS 1
+#else
+#define USE_SSE41_INTRINSICS 0
+#endif
+
 namespace Engine
 {
     using VectorRegister = __m128;
@@ -30,28 +39,31 @@ namespace Engine
         return _mm_setr_ps(x, y, z, w);
     }
 
-    inline VectorRegister VectorShuffle(VectorRegister vec, int32 a, int32 b, int32 c, int32 d)
+    /**
+     * Return (vec[X], vec[Y], vec[Z], vec[W])
+     */
+    template <int32 X, int32 Y, int32 Z, int32 W>
+    inline VectorRegister VectorShuffle(VectorRegister vec)
     {
-        return _mm_shuffle_ps(vec, vec, _MM_SHUFFLE(a, b, c, d));
+        return _mm_shuffle_ps(vec, vec, _MM_SHUFFLE(W, Z, Y, X));
     }
 
-    inline VectorRegister VectorShuffle(VectorRegister vec1, VectorRegister vec2, int32 a, int32 b, int32 c, int32 d)
+    /**
+     * Return (vec1[X], vec1[Y], vec2[Z], vec2[W])
+     */
+    template <int32 X, int32 Y, int32 Z, int32 W>
+    inline VectorRegister VectorShuffle(VectorRegister vec1, VectorRegister vec2)
     {
-        return _mm_shuffle_ps(vec1, vec2, _MM_SHUFFLE(a, b, c, d));
+        return _mm_shuffle_ps(vec1, vec2, _MM_SHUFFLE(W, Z, Y, X));
     }
 
-    inline VectorRegister Vector3fDot(const VectorRegister& lhs, const VectorRegister& rhs)
+    /**
+     * Return (vec[Index], vec[Index], vec[Index], vec[Index])
+     */
+    template <int32 Index>
+    inline VectorRegister VectorReplicate(VectorRegister vec)
     {
-#if !SUPPORT_SSE41
-        return _mm_dp_ps(lhs, rhs, 0x7f);
-#else
-        VectorRegister dot = _mm_mul_ps(lhs, rhs);
-        VectorRegister temp = VectorShuffle(dot, 1, 1, 2, 2);
-        dot = _mm_add_ps(dot, temp);
-        temp = VectorShuffle(dot, 3, 3, 3, 3);
-        dot = _mm_add_ps(dot, temp);
-        return VectorShuffle(dot, 0, 0, 0, 0);
-#endif
+        return VectorShuffle<Index, Index, Index, Index>(vec);
     }
 
     /**
@@ -63,9 +75,190 @@ namespace Engine
         return _mm_setzero_ps();
     }
 
+    inline VectorRegister VectorLoad(const float* ptr)
+    {
+        return _mm_loadu_ps(ptr);
+    }
+
+    /**
+     * ptr must be 16 bytes aligned
+     */
+    inline VectorRegister VectorLoadAligned(const float* ptr)
+    {
+        return _mm_load_ps(ptr);
+    }
+
+    /**
+     * Return (ptr[0], ptr[1], ptr[2], 0), never reads ptr[3]
+     */
+    inline VectorRegister VectorLoadFloat3(const float* ptr)
+    {
+        const VectorRegister xy = _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(ptr)));
+        return _mm_movelh_ps(xy, _mm_load_ss(ptr + 2));
+    }
+
+    inline void VectorStore(VectorRegister vec, float* ptr)
+    {
+        _mm_storeu_ps(ptr, vec);
+    }
+
+    /**
+     * ptr must be 16 bytes aligned
+     */
+    inline void VectorStoreAligned(VectorRegister vec, float* ptr)
+    {
+        _mm_store_ps(ptr, vec);
+    }
+
+    /**
+     * Store x, y, z of vec, never writes ptr[3]
+     */
+    inline void VectorStoreFloat3(VectorRegister vec, float* ptr)
+    {
+        _mm_storel_pi(reinterpret_cast<__m64*>(ptr), vec);
+        _mm_store_ss(ptr + 2, VectorReplicate<2>(vec));
+    }
+
+    inline float VectorGetX(VectorRegister vec)
+    {
+        return _mm_cvtss_f32(vec);
+    }
+
+    inline VectorRegister VectorAdd(VectorRegister lhs, VectorRegister rhs)
+    {
+        return _mm_add_ps(lhs, rhs);
+    }
+
+    inline VectorRegister VectorSubtract(VectorRegister lhs, VectorRegister rhs)
+    {
+        return _mm_sub_ps(lhs, rhs);
+    }
+
+    inline VectorRegister VectorMultiply(VectorRegister lhs, VectorRegister rhs)
+    {
+        return _mm_mul_ps(lhs, rhs);
+    }
+
+    inline VectorRegister VectorDivide(VectorRegister lhs, VectorRegister rhs)
+    {
+        return _mm_div_ps(lhs, rhs);
+    }
+
+    /**
+     * Return a * b + c
+     */
+    inline VectorRegister VectorMultiplyAdd(VectorRegister a, VectorRegister b, VectorRegister c)
+    {
+        return _mm_add_ps(_mm_mul_ps(a, b), c);
+    }
+
+    inline VectorRegister VectorNegate(VectorRegister vec)
+    {
+        return _mm_sub_ps(_mm_setzero_ps(), vec);
+    }
+
+    inline VectorRegister VectorAbs(VectorRegister vec)
+    {
+        return _mm_andnot_ps(_mm_set1_ps(-0.0f), vec);
+    }
+
+    /**
+     * 1 / vec per component, components whose absolute value isn't bigger than tolerance become 0
+     */
+    inline VectorRegister VectorReciprocalSafe(VectorRegister vec, float tolerance = SMALL_FLOAT)
+    {
+        const VectorRegister valid = _mm_cmpgt_ps(VectorAbs(vec), _mm_set1_ps(tolerance));
+        return _mm_and_ps(valid, _mm_div_ps(_mm_set1_ps(1.0f), vec));
+    }
+
+    /**
+     * Return (x, y, z, w) of vector with w replaced
+     */
     inline VectorRegister VectorSetW(VectorRegister vector, float w)
     {
-        VectorRegister temp = _mm_movehl_ps(MakeVectorRegister(w, w, w, w), vector);
-        return VectorShuffle(vector, temp, 0, 1, 0, 3);
+        // (vector.z, vector.w, w, w)
+        VectorRegister temp = _mm_movehl_ps(MakeVectorRegister(w), vector);
+        return VectorShuffle<0, 1, 0, 2>(vector, temp);
+    }
+
+    /**
+     * Dot product of x, y, z, replicated to all components
+     */
+    inline VectorRegister Vector3fDot(const VectorRegister& lhs, const VectorRegister& rhs)
+    {
+#if USE_SSE41_INTRINSICS
+        return _mm_dp_ps(lhs, rhs, 0x7f);
+#else
+        VectorRegister dot = _mm_mul_ps(lhs, rhs);
+        VectorRegister sum = _mm_add_ss(dot, VectorReplicate<1>(dot));
+        sum = _mm_add_ss(sum, VectorReplicate<2>(dot));
+        return VectorReplicate<0>(sum);
+#endif
+    }
+
+    /**
+     * Dot product of all four components, replicated to all components
+     */
+    inline VectorRegister Vector4fDot(const VectorRegister& lhs, const VectorRegister& rhs)
+    {
+#if USE_SSE41_INTRINSICS
+        return _mm_dp_ps(lhs, rhs, 0xff);
+#else
+        VectorRegister dot = _mm_mul_ps(lhs, rhs);
+        dot = _mm_add_ps(dot, VectorShuffle<2, 3, 0, 1>(dot));
+        return _mm_add_ps(dot, VectorShuffle<1, 0, 3, 2>(dot));
+#endif
+    }
+
+    /**
+     * Cross product of x, y, z, w of result is 0
+     */
+    inline VectorRegister VectorCross(VectorRegister lhs, VectorRegister rhs)
+    {
+        const VectorRegister lhsYZX = VectorShuffle<1, 2, 0, 3>(lhs);
+        const VectorRegister rhsYZX = VectorShuffle<1, 2, 0, 3>(rhs);
+        // (lhs * rhs.yzx - lhs.yzx * rhs).yzx
+        const VectorRegister cross = _mm_sub_ps(_mm_mul_ps(lhs, rhsYZX), _mm_mul_ps(lhsYZX, rhs));
+        return VectorShuffle<1, 2, 0, 3>(cross);
+    }
+
+    /**
+     * Same as Quat::operator*, lhs * rhs
+     */
+    inline VectorRegister VectorQuaternionMultiply(VectorRegister lhs, VectorRegister rhs)
+    {
+        const VectorRegister signW = MakeVectorRegister(0.0f, 0.0f, 0.0f, -0.0f);
+
+        // lhs.w * rhs
+        VectorRegister result = _mm_mul_ps(VectorReplicate<3>(lhs), rhs);
+        // (lhs.x, lhs.y, lhs.z, -lhs.x) * (rhs.w, rhs.w, rhs.w, rhs.x)
+        VectorRegister term = _mm_mul_ps(_mm_xor_ps(VectorShuffle<0, 1, 2, 0>(lhs), signW), VectorShuffle<3, 3, 3, 0>(rhs));
+        result = _mm_add_ps(result, term);
+        // (lhs.z, lhs.x, lhs.y, -lhs.y) * (rhs.y, rhs.z, rhs.x, rhs.y)
+        term = _mm_mul_ps(_mm_xor_ps(VectorShuffle<2, 0, 1, 1>(lhs), signW), VectorShuffle<1, 2, 0, 1>(rhs));
+        result = _mm_add_ps(result, term);
+        // (lhs.y, lhs.z, lhs.x, lhs.z) * (rhs.z, rhs.x, rhs.y, rhs.z)
+        term = _mm_mul_ps(VectorShuffle<1, 2, 0, 2>(lhs), VectorShuffle<2, 0, 1, 2>(rhs));
+        return _mm_sub_ps(result, term);
+    }
+
+    /**
+     * Same as Quat::RotateVector, w of vec must be 0
+     */
+    inline VectorRegister VectorQuaternionRotateVector(VectorRegister quat, VectorRegister vec)
+    {
+        const VectorRegister q = VectorSetW(quat, 0.0f);
+        const VectorRegister t = _mm_mul_ps(_mm_set1_ps(2.0f), VectorCross(q, vec));
+        const VectorRegister result = _mm_add_ps(vec, _mm_mul_ps(VectorReplicate<3>(quat), t));
+        return _mm_add_ps(result, VectorCross(q, t));
+    }
+
+    /**
+     * Same as Quat::Inverse, conjugate divided by size squared
+     */
+    inline VectorRegister VectorQuaternionInverse(VectorRegister quat)
+    {
+        const VectorRegister conjugate = _mm_xor_ps(quat, MakeVectorRegister(-0.0f, -0.0f, -0.0f, 0.0f));
+        return _mm_div_ps(conjugate, Vector4fDot(quat, quat));
     }
-}
\ No newline at end of file
+}
@@ -8,8 +8,21 @@
 
 namespace Engine
 {
-    struct alignas(16) CORE_API Transform
+    /**
+     * Scale, then rotate, then translate.
+     * Use getters and setters outside of math, members are VectorRegister when ENABLE_TRANSFORM_INTRINSICS is on
+     */
+    struct CORE_API Transform
     {
+#if ENABLE_TRANSFORM_INTRINSICS
+        Transform();
+
+        explicit Transform(const Quat& rotation);
+
+        explicit Transform(const Vector3f& location);
+
+        Transform(const Quat& rotation, const Vector3f& location, const Vector3f& scale);
+#else
         Transform()
             : Rotation(0, 0, 0, 1)
             , Translation(0, 0, 0)
@@ -28,26 +41,103 @@ namespace Engine
             , Scale(1, 1, 1)
         {}
 
-        Transform(const Quat& rotation, const Vector3f location, const Vector3f& scale)
+        Transform(const Quat& rotation, const Vector3f& location, const Vector3f& scale)
             : Rotation(rotation)
             , Translation(location)
             , Scale(scale)
         {}
+#endif
 
+        /**
+         * Apply a then b, result may be a or b
+         * @param a
+         * @param b
+         * @param result
+         */
         static void Multiply(const Transform& a, const Transform& b, Transform& result);
 
         Transform operator* (const Transform& other) const;
 
         Transform operator*= (const Transform& other);
 
-        Quat Rotation;
-        Vector3f Translation;
-        Vector3f Scale;
+        /**
+         * Exact when scale is uniform, like every TRS transform non-uniform scale after rotation can't be represented.
+         * Zero scale components stay zero
+         */
+        Transform Inverse() const;
+
+        Vector3f TransformPosition(const Vector3f& position) const;
+
+        /** Same as TransformPosition without translation */
+        Vector3f TransformVector(const Vector3f& vector) const;
+
+        /** Exact inverse of TransformPosition, zero scale components give zero */
+        Vector3f InverseTransformPosition(const Vector3f& position) const;
+
+        bool Equals(const Transform& other, float tolerance = KINDA_SMALL_FLOAT) const
+        {
+            return GetRotation().Equals(other.GetRotation(), tolerance) &&
+                   GetTranslation().Equals(other.GetTranslation(), tolerance) &&
+                   GetScale().Equals(other.GetScale(), tolerance);
+        }
 
 #if ENABLE_TRANSFORM_INTRINSICS
-        VectorRegister Rotation;
+        Quat GetRotation() const
+        {
+            Quat rotation;
+            VectorStoreAligned(Rotation, &rotation.X);
+            return rotation;
+        }
+
+        Vector3f GetTranslation() const
+        {
+            Vector3f translation;
+            VectorStoreFloat3(Translation, &translation.X);
+            return translation;
+        }
+
+        Vector3f GetScale() const
+        {
+            Vector3f scale;
+            VectorStoreFloat3(Scale, &scale.X);
+            return scale;
+        }
+
+        void SetRotation(const Quat& rotation)
+        {
+            Rotation = VectorLoadAligned(&rotation.X);
+        }
+
+        void SetTranslation(const Vector3f& translation)
+        {
+            Translation = VectorLoadFloat3(&translation.X);
+        }
+
+        void SetScale(const Vector3f& scale)
+        {
+            Scale = VectorLoadFloat3(&scale.X);
+        }
+
+        /** w of Translation and Scale is always 0 */
+        alignas(16) VectorRegister Rotation;
         VectorRegister Translation;
         VectorRegister Scale;
+#else
+        Quat GetRotation() const { return Rotation; }
+
+        Vector3f GetTranslation() const { return Translation; }
+
+        Vector3f GetScale() const { return Scale; }
+
+        void SetRotation(const Quat& rotation) { Rotation = rotation; }
+
+        void SetTranslation(const Vector3f& translation) { Translation = translation; }
+
+        void SetScale(const Vector3f& scale) { Scale = scale; }
+
+        alignas(16) Quat Rotation;
+        Vector3f Translation;
+        Vector3f Scale;
 #endif
     };
 }
\ No newline at end of file
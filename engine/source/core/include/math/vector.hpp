@@ -299,6 +299,22 @@ namespace Engine
             return *this;
         }
 
+        Vector operator- (const Vector& other) const
+        {
+            return Vector(X - other.X, Y - other.Y, Z - other.Z);
+        }
+
+        Vector operator-= (const Vector& other)
+        {
+            *this = *this - other;
+            return *this;
+        }
+
+        Vector operator- () const
+        {
+            return Vector(-X, -Y, -Z);
+        }
+
         union
         {
             struct
@@ -471,6 +487,22 @@ namespace Engine
             return *this;
         }
 
+        Vector operator- (const Vector& other) const
+        {
+            return Vector(X - other.X, Y - other.Y, Z - other.Z, W - other.W);
+        }
+
+        Vector operator-= (const Vector& other)
+        {
+            *this = *this - other;
+            return *this;
+        }
+
+        Vector operator- () const
+        {
+            return Vector(-X, -Y, -Z, -W);
+        }
+
         union
         {
             struct
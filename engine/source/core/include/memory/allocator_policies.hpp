@@ -3,8 +3,12 @@
 #include "global.hpp"
 #include "foundation/type_traits.hpp"
 #include "memory/memory.hpp"
+#include "memory/memory_tag.hpp"
 #include "math/limit.hpp"
+#include "math/generic_math.hpp"
+#include "math/align_utils.hpp"
 #include "memory/untyped_data.hpp"
+#include "memory/object_pool.hpp"
 
 namespace Engine
 {
@@ -38,6 +42,23 @@ namespace Engine
             {
                 Memory::Free(ptr);
             }
+
+            /** grow or shrink allocation from oldN to newN elements without moving them */
+            bool TryResize(ValueType* ptr, SizeType, SizeType newN)
+            {
+                return Memory::TryResizeInPlace(ptr, newN * sizeof(ValueType));
+            }
+
+            /** elements an allocation of n elements can hold, malloc may round the block up to its size class */
+            SizeType GetUsableCapacity(ValueType* ptr, SizeType n) const
+            {
+                const size_t usableNum = Memory::GetAllocationSize(ptr) / sizeof(ValueType);
+                if (usableNum <= static_cast<size_t>(n))
+                {
+                    return n;
+                }
+                return static_cast<SizeType>(Math::Min(usableNum, static_cast<size_t>(NumericLimits<SizeType>::Max())));
+            }
         };
     };
 
@@ -84,4 +105,150 @@ namespace Engine
             UntypedData<ValueType> Buffer[InlineSize];
         };
     };
+
+    /**
+     * Single element allocations are served by ObjectPool<ElementType>::Get(),
+     * suitable for containers which allocate one node at a time.
+     * Deallocate asks the pool whether it owns a block instead of trusting the count, so a container which counts
+     * capacity in another unit, eg: bits, can't send a heap block into the pool.
+     */
+    template <SignedIntegralType IntType = int32>
+    class PoolAllocator
+    {
+    public:
+        using SizeType = IntType;
+
+        template <typename ElementType>
+        class ElementAllocator
+        {
+        public:
+            using SizeType = IntType;
+            using ValueType = ElementType;
+
+            ElementAllocator() = default;
+
+            ElementAllocator(const ElementAllocator& other) noexcept = default;
+
+            ElementAllocator(ElementAllocator&& other) noexcept = default;
+
+            ElementAllocator& operator=(const ElementAllocator& other) = default;
+
+            NODISCARD ValueType* Allocate(SizeType n)
+            {
+                if (n == 1)
+                {
+                    return static_cast<ValueType*>(ObjectPool<ValueType>::Get().Allocate());
+                }
+                return static_cast<ValueType*>(Memory::Malloc(n * sizeof(ValueType), alignof(ValueType)));
+            }
+
+            constexpr void Deallocate(ValueType* ptr, SizeType)
+            {
+                if (ptr == nullptr)
+                {
+                    return;
+                }
+
+                ObjectPool<ValueType>& pool = ObjectPool<ValueType>::Get();
+                if (pool.Owns(ptr))
+                {
+                    pool.Free(ptr);
+                }
+                else
+                {
+                    Memory::Free(ptr);
+                }
+            }
+        };
+    };
+
+    /**
+     * Reserves ReserveBytes of address space on first allocation and commits pages on demand,
+     * growth never moves elements so pointers stay stable. Suitable for huge containers which can't afford
+     * the transient memory of reallocation, capacity is limited to ReserveBytes / sizeof(ElementType).
+     */
+    template <uint64 ReserveBytes = (1ull << 36), SignedIntegralType IntType = int64>
+    class VirtualAllocator
+    {
+    public:
+        using SizeType = IntType;
+
+        template <typename ElementType>
+        class ElementAllocator
+        {
+        public:
+            using SizeType = IntType;
+            using ValueType = ElementType;
+
+            ElementAllocator() = default;
+
+            ElementAllocator(const ElementAllocator& other) noexcept = default;
+
+            ElementAllocator(ElementAllocator&& other) noexcept = default;
+
+            ElementAllocator& operator=(const ElementAllocator& other) = default;
+
+            NODISCARD ValueType* Allocate(SizeType n)
+            {
+                if (n == 0)
+                {
+                    return nullptr;
+                }
+
+                ENSURE(n * sizeof(ValueType) <= ReserveBytes);
+                void* ptr = PlatformMemory::Reserve(ReserveBytes);
+                ENSURE(ptr);
+                if (!PlatformMemory::Commit(ptr, GetCommitSize(n)))
+                {
+                    // reserved but uncommitted pages fault on first write, never hand them out
+                    PlatformMemory::Release(ptr, ReserveBytes);
+                    ENSURE(false);
+                    return nullptr;
+                }
+                return static_cast<ValueType*>(ptr);
+            }
+
+            constexpr void Deallocate(ValueType* ptr, SizeType)
+            {
+                if (ptr != nullptr)
+                {
+                    PlatformMemory::Release(ptr, ReserveBytes);
+                }
+            }
+
+            /** most elements the reservation can hold, containers cap their growth to it */
+            static constexpr SizeType GetMaxSize()
+            {
+                return static_cast<SizeType>(Math::Min(ReserveBytes / sizeof(ValueType), static_cast<uint64>(NumericLimits<SizeType>::Max())));
+            }
+
+            /** commit or decommit pages between oldN and newN elements */
+            bool TryResize(ValueType* ptr, SizeType oldN, SizeType newN)
+            {
+                const size_t oldSize = GetCommitSize(oldN);
+                const size_t newSize = GetCommitSize(newN);
+                if (newSize > ReserveBytes)
+                {
+                    return false;
+                }
+
+                uint8* base = reinterpret_cast<uint8*>(ptr);
+                if (newSize > oldSize)
+                {
+                    return PlatformMemory::Commit(base + oldSize, newSize - oldSize);
+                }
+                if (newSize < oldSize)
+                {
+                    PlatformMemory::Decommit(base + newSize, oldSize - newSize);
+                }
+                return true;
+            }
+
+        private:
+            static size_t GetCommitSize(SizeType n)
+            {
+                return Align(static_cast<size_t>(n) * sizeof(ValueType), PlatformMemory::GetPageSize());
+            }
+        };
+    };
 }
\ No newline at end of file
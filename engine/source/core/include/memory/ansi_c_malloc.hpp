@@ -18,6 +18,8 @@ namespace Engine
 
         virtual void* Realloc(void* ptr, size_t size, uint32 alignment) final;
 
-        size_t GetAllocateSize(void* ptr);
+        virtual size_t GetAllocationSize(void* ptr) final;
+
+        virtual bool TryResizeInPlace(void* ptr, size_t newSize) final;
     };
 }
\ No newline at end of file
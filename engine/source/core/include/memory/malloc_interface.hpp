@@ -15,6 +15,15 @@ namespace Engine
 
         virtual void* Realloc(void* ptr, size_t size, uint32 alignment) = 0;
 
+        /** usable size of allocation which may be larger than requested, 0 if unknown */
+        virtual size_t GetAllocationSize(void*) { return 0; }
+
+        /**
+         * Grow or shrink allocation without moving it, return false if allocation is unchanged.
+         * Implementations may refuse a shrink which would keep a lot of unused memory, so that realloc can release it
+         */
+        virtual bool TryResizeInPlace(void*, size_t) { return false; }
+
         virtual void SetupCurrentThreadTLS() {};
     };
 }
\ No newline at end of file
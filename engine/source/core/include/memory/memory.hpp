@@ -1,7 +1,7 @@
 #pragma once
 
 #include "memory/platform_memory.hpp"
-#include <xmemory>
+#include <memory>
 
 namespace Engine
 {
@@ -16,6 +16,12 @@ namespace Engine
 
         static void* Realloc(void* ptr, size_t newSize, uint32 alignment = PlatformMemory::GetDefaultAlignment());
 
+        /** usable size of allocation which may be larger than requested, 0 if unknown */
+        static size_t GetAllocationSize(void* ptr);
+
+        /** grow or shrink allocation without moving it, return false if allocation is unchanged */
+        static bool TryResizeInPlace(void* ptr, size_t newSize);
+
         static void Memcpy(void* dest, void const* src, size_t size);
 
         /**
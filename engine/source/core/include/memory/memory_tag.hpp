@@ -0,0 +1,67 @@
+#pragma once
+
+#include "global.hpp"
+#include "definitions_core.hpp"
+
+namespace Engine
+{
+    /** owner of an allocation, the current tag of a thread is set by MEMORY_TAG_SCOPE */
+    enum class EMemoryTag : uint8
+    {
+        Untagged,
+        Container,
+        String,
+        Object,
+        Delegate,
+        Taskflow,
+        FileSystem,
+        Log,
+        Module,
+        Render,
+        Application,
+        Count
+    };
+
+    CORE_API const char* GetMemoryTagName(EMemoryTag tag);
+
+    /**
+     * Push a tag to the tag stack of current thread, allocations made in the scope are attributed to it.
+     * Reallocation keeps the tag of the original allocation.
+     */
+    class CORE_API MemoryTagScope
+    {
+    public:
+        explicit MemoryTagScope(EMemoryTag tag);
+
+        ~MemoryTagScope();
+
+        MemoryTagScope(const MemoryTagScope& other) = delete;
+
+        MemoryTagScope& operator= (const MemoryTagScope& other) = delete;
+
+        static EMemoryTag GetCurrentTag();
+
+        /** current tag, or fallback when no subsystem has tagged current thread */
+        static EMemoryTag GetCurrentTagOr(EMemoryTag fallback)
+        {
+            const EMemoryTag tag = GetCurrentTag();
+            return tag == EMemoryTag::Untagged ? fallback : tag;
+        }
+    };
+}
+
+#define MEMORY_TAG_SCOPE_JOIN_INNER(a, b) a##b
+#define MEMORY_TAG_SCOPE_JOIN(a, b) MEMORY_TAG_SCOPE_JOIN_INNER(a, b)
+
+/** subsystem entry points, allocations in the scope belong to tag even when made by containers */
+#define MEMORY_TAG_SCOPE(tag) ::Engine::MemoryTagScope MEMORY_TAG_SCOPE_JOIN(memoryTagScope, __LINE__)(::Engine::EMemoryTag::tag)
+
+/**
+ * Containers and strings, tag only applies if no subsystem scope is active.
+ * It's on the path of every container allocation, so it compiles to nothing without memory tracking
+ */
+#if ENABLE_MEMORY_TRACKING
+#define MEMORY_TAG_FALLBACK_SCOPE(tag) ::Engine::MemoryTagScope MEMORY_TAG_SCOPE_JOIN(memoryTagScope, __LINE__)(::Engine::MemoryTagScope::GetCurrentTagOr(::Engine::EMemoryTag::tag))
+#else
+#define MEMORY_TAG_FALLBACK_SCOPE(tag)
+#endif
\ No newline at end of file
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include "memory/malloc_interface.hpp"
+#include "memory/memory_tag.hpp"
+#include "memory/system_new_delete_object.hpp"
+
+namespace Engine
+{
+    struct CORE_API MemoryTagStats
+    {
+        int64 AllocatedBytes = 0;
+        int64 PeakBytes = 0;
+        int64 AllocationCount = 0;
+        uint64 TotalAllocationCount = 0;
+    };
+
+    struct CORE_API MemoryTrackerStats
+    {
+        /** allocation count of size in [2^i, 2^(i+1)) */
+        static constexpr int32 HISTOGRAM_BUCKET_NUM = 32;
+
+        MemoryTagStats Tags[static_cast<int32>(EMemoryTag::Count)];
+        int64 AllocatedBytes = 0;
+        int64 PeakBytes = 0;
+        int64 AllocationCount = 0;
+        uint64 SizeHistogram[HISTOGRAM_BUCKET_NUM] = {};
+    };
+
+    /**
+     * Decorator of IMalloc which records bytes and counts per tag, peak usage and size histogram.
+     * Every alive allocation is linked to a list so that outstanding allocations can be reported on shutdown,
+     * with their callstacks if callstack capturing is enabled. The list is split into shards picked by allocating
+     * thread, so threads don't contend on one lock.
+     * Installed as GMalloc when built with memory_tracking option.
+     */
+    class CORE_API MemoryTracker final : public IMalloc, public SystemNewDeleteObject
+    {
+    public:
+        explicit MemoryTracker(IMalloc* innerMalloc);
+
+        virtual ~MemoryTracker();
+
+        /** get the tracker installed as GMalloc, nullptr if tracking is disabled */
+        static MemoryTracker* Get();
+
+        virtual void* Malloc(size_t size, uint32 alignment) final;
+
+        virtual void Free(void* ptr) final;
+
+        virtual void* Realloc(void* ptr, size_t size, uint32 alignment) final;
+
+        virtual void SetupCurrentThreadTLS() final;
+
+        virtual size_t GetAllocationSize(void* ptr) final;
+
+        virtual bool TryResizeInPlace(void* ptr, size_t newSize) final;
+
+        /** only affects allocations made afterwards */
+        void SetCaptureCallstack(bool enable) { bCaptureCallstack.store(enable, std::memory_order_relaxed); }
+
+        bool IsCaptureCallstack() const { return bCaptureCallstack.load(std::memory_order_relaxed); }
+
+        MemoryTrackerStats GetStats() const;
+
+        /** log usage of every tag and size histogram */
+        void DumpStats() const;
+
+        /**
+         * Log allocations which are still alive, call it on shutdown to find leaks.
+         * @return count of alive allocations
+         */
+        int64 ReportLeaks(int32 maxReportNum = 64) const;
+
+        static constexpr int32 MAX_CALLSTACK_DEPTH = 16;
+
+    private:
+        friend class Memory;
+
+        /** called by Memory when the tracker becomes GMalloc, other trackers are never returned by Get */
+        static void Install(MemoryTracker* tracker);
+
+        struct AllocationHeader;
+
+        struct Callstack
+        {
+            void* Frames[MAX_CALLSTACK_DEPTH];
+            int32 Depth;
+        };
+
+        struct ListShard
+        {
+            std::mutex Mutex;
+            AllocationHeader* Head{ nullptr };
+        };
+
+        struct TagCounter
+        {
+            std::atomic<int64> AllocatedBytes{ 0 };
+            std::atomic<int64> PeakBytes{ 0 };
+            std::atomic<int64> AllocationCount{ 0 };
+            std::atomic<uint64> TotalAllocationCount{ 0 };
+        };
+
+        void* TrackedMalloc(size_t size, uint32 alignment, EMemoryTag tag);
+
+        void OnAllocate(size_t size, EMemoryTag tag);
+
+        void OnFree(size_t size, EMemoryTag tag);
+
+        /** allocation resized in place, counts and size histogram are untouched */
+        void OnResize(size_t oldSize, size_t newSize, EMemoryTag tag);
+
+        static AllocationHeader* GetHeader(void* ptr);
+
+        static void UpdatePeak(std::atomic<int64>& peak, int64 value);
+
+        IMalloc* InnerMalloc;
+        std::atomic<bool> bCaptureCallstack{ false };
+
+        static constexpr int32 LIST_SHARD_NUM = 32;
+
+        /** shard of calling thread, threads are spread over shards round robin */
+        static int32 GetThreadShardIndex();
+
+        mutable ListShard ListShards[LIST_SHARD_NUM];
+
+        TagCounter TagCounters[static_cast<int32>(EMemoryTag::Count)];
+        std::atomic<int64> AllocatedBytes{ 0 };
+        std::atomic<int64> PeakBytes{ 0 };
+        std::atomic<int64> AllocationCount{ 0 };
+        std::atomic<uint64> SizeHistogram[MemoryTrackerStats::HISTOGRAM_BUCKET_NUM];
+    };
+}
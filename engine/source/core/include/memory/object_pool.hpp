@@ -0,0 +1,241 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include "global.hpp"
+#include "definitions_core.hpp"
+#include "foundation/type_traits.hpp"
+#include "memory/system_new_delete_object.hpp"
+
+namespace Engine
+{
+    /**
+     * Statistics of a pool. Counters of each thread are merged when the thread exchanges a batch with
+     * the global depot or flushes its cache, so live and peak counts lag behind by at most one batch per thread.
+     */
+    struct CORE_API PoolStats
+    {
+        uint64 AllocateCount = 0;
+        uint64 FreeCount = 0;
+        int64 LiveCount = 0;
+        int64 PeakLiveCount = 0;
+        int64 BlockCount = 0;
+        uint64 DepotFetchCount = 0;
+        uint64 DepotReturnCount = 0;
+    };
+
+    /**
+     * Untyped pool of fixed size elements.
+     * Every thread keeps its own free list, elements are exchanged with the global depot in batches,
+     * so allocate and free only touch thread local memory in the common case.
+     * Blocks are committed inside address ranges the pool reserves, so ownership of an address is a range check.
+     */
+    class CORE_API FixedSizePool : public SystemNewDeleteObject
+    {
+        friend class PoolThreadCache;
+    public:
+        FixedSizePool(size_t elementSize, uint32 alignment, int32 elementsPerBlock = 256, int32 batchSize = 32);
+
+        ~FixedSizePool();
+
+        FixedSizePool(const FixedSizePool& other) = delete;
+
+        FixedSizePool& operator= (const FixedSizePool& other) = delete;
+
+        NODISCARD void* Allocate();
+
+        void Free(void* ptr);
+
+        /** whether ptr is an element of this pool, lock free */
+        bool Owns(const void* ptr) const;
+
+        /** return elements cached by calling thread to global depot */
+        void FlushThreadCache();
+
+        PoolStats GetStats() const;
+
+        size_t GetElementSize() const { return ElementSize; }
+
+        uint32 GetAlignment() const { return Alignment; }
+
+    private:
+        /** free element, batches are linked by depot so the node is a single pointer */
+        struct FreeNode
+        {
+            FreeNode* Next;
+        };
+
+        struct DepotBatch
+        {
+            FreeNode* Head;
+            int32 Count;
+        };
+
+        struct LocalCache
+        {
+            FreeNode* Head{ nullptr };
+            int32 Count{ 0 };
+            uint64 AllocateCount{ 0 };
+            uint64 FreeCount{ 0 };
+        };
+
+        /** segment i reserves room for INITIAL_SEGMENT_BLOCKS << i blocks */
+        static constexpr int32 MAX_SEGMENT_NUM = 40;
+
+        static constexpr int32 INITIAL_SEGMENT_BLOCKS = 16;
+
+        /** pop a batch from depot, allocate a new block if depot is empty */
+        FreeNode* FetchBatch(int32& outCount);
+
+        void ReturnBatch(FreeNode* head, int32 count);
+
+        void PushBatch(FreeNode* head, int32 count);
+
+        void AllocateBlock();
+
+        void MergeStats(LocalCache& cache);
+
+        size_t ElementSize;
+        size_t Stride;
+        size_t BlockSize;
+        uint32 Alignment;
+        int32 ElementsPerBlock;
+        int32 BatchSize;
+        uint32 PoolIndex;
+
+        std::mutex DepotMutex;
+        /** stack of free batches, guarded by depot lock */
+        DepotBatch* DepotBatches{ nullptr };
+        int32 DepotBatchNum{ 0 };
+        int32 DepotBatchCapacity{ 0 };
+        /** carved and committed bytes of the last segment, guarded by depot lock */
+        size_t SegmentUsed{ 0 };
+        size_t SegmentCommitted{ 0 };
+
+        /** segments are only appended under depot lock and published by SegmentNum, Owns reads them without lock */
+        uint8* SegmentBases[MAX_SEGMENT_NUM]{};
+        size_t SegmentSizes[MAX_SEGMENT_NUM]{};
+        std::atomic<int32> SegmentNum{ 0 };
+
+        std::atomic<uint64> AllocateCount{ 0 };
+        std::atomic<uint64> FreeCount{ 0 };
+        std::atomic<int64> PeakLiveCount{ 0 };
+        std::atomic<int64> BlockCount{ 0 };
+        std::atomic<uint64> DepotFetchCount{ 0 };
+        std::atomic<uint64> DepotReturnCount{ 0 };
+    };
+
+    /**
+     * Size classed pools shared by small objects which are frequently created and destroyed,
+     * allocations larger than MAX_POOLED_SIZE fall back to Memory::Malloc.
+     */
+    class CORE_API SmallObjectPool
+    {
+    public:
+        SmallObjectPool() = delete;
+
+        NODISCARD static void* Allocate(size_t size);
+
+        static void Free(void* ptr, size_t size);
+
+        static PoolStats GetStats(size_t size);
+
+        static constexpr size_t POOLED_GRANULARITY = 16;
+
+        static constexpr size_t MAX_POOLED_SIZE = 256;
+    };
+
+    /**
+     * Inherit from PoolNewDeleteObject to allocate object from SmallObjectPool.
+     * Deletion must go through a virtual destructor (or the exact type) to pass the right size.
+     */
+    class CORE_API PoolNewDeleteObject
+    {
+    public:
+        void* operator new(size_t size) { return SmallObjectPool::Allocate(size); }
+
+        void* operator new(size_t size, void* place) { return place; }
+
+        void operator delete(void* ptr, size_t size) { SmallObjectPool::Free(ptr, size); }
+
+        /** elements of an array don't know their size on delete, so arrays can't be pooled */
+        void* operator new[](size_t size) = delete;
+
+        void operator delete[](void* ptr, size_t size) = delete;
+    };
+
+    /**
+     * Typed pool, can be used as a global per type pool through ObjectPool<T>::Get().
+     * The global pool lives in every module which instantiates it, so objects must be freed
+     * by the module which allocated them in shared build.
+     */
+    template <typename T>
+    class ObjectPool
+    {
+    public:
+        using ValueType = T;
+
+        static ObjectPool& Get()
+        {
+            static ObjectPool pool;
+            return pool;
+        }
+
+        explicit ObjectPool(int32 elementsPerBlock = 256, int32 batchSize = 32)
+            : Pool(sizeof(ValueType), alignof(ValueType), elementsPerBlock, batchSize)
+        {}
+
+        template <typename... ArgTypes>
+        NODISCARD ValueType* New(ArgTypes&&... args)
+        {
+            return new(Pool.Allocate()) ValueType(Forward<ArgTypes>(args)...);
+        }
+
+        void Delete(ValueType* obj)
+        {
+            if (obj != nullptr)
+            {
+                std::destroy_at(obj);
+                Pool.Free(obj);
+            }
+        }
+
+        NODISCARD void* Allocate()
+        {
+            return Pool.Allocate();
+        }
+
+        void Free(void* ptr)
+        {
+            Pool.Free(ptr);
+        }
+
+        bool Owns(const void* ptr) const
+        {
+            return Pool.Owns(ptr);
+        }
+
+        void FlushThreadCache()
+        {
+            Pool.FlushThreadCache();
+        }
+
+        PoolStats GetStats() const
+        {
+            return Pool.GetStats();
+        }
+
+    private:
+        FixedSizePool Pool;
+    };
+
+    /** deleter of UniquePtr which returns object to ObjectPool<T>::Get() */
+    template <typename T>
+    struct PoolDeleter
+    {
+        void operator() (T* obj) const
+        {
+            ObjectPool<T>::Get().Delete(obj);
+        }
+    };
+}
@@ -4,59 +4,88 @@
 #include "memory/memory.hpp"
 
 /**
- * override global operator new.
+ * Override global operator new and delete, route them to Memory::Malloc and Memory::Free.
  * https://en.cppreference.com/w/cpp/memory/new/operator_new
+ *
+ * Enabled by override_new_delete build option. Include this file in exactly one source file of every module
+ * and executable (definitions_xxx.cpp and main), since msvc binds operator new per binary in shared build.
+ * In static build only the one compiled into core is kept to avoid duplicated definitions.
+ *
+ * Memory::Malloc creates GMalloc lazily with class specific new, so it's safe to be called during static initialization,
+ * and GMalloc is kept alive after Memory::Shutdown to serve static destructors.
  */
-//NODISCARD void* operator new(size_t size)
-//{
-//    if (void* ptr = Engine::Memory::Malloc(size))
-//    {
-//        return ptr;
-//    }
-//    throw std::bad_alloc{};
-//}
-//
-//NODISCARD void* operator new(size_t size, const std::nothrow_t&) noexcept
-//{
-//    return Engine::Memory::Malloc(size);
-//}
-//
-//NODISCARD void* operator new[](size_t size)
-//{
-//    if (void* ptr = Engine::Memory::Malloc(size))
-//    {
-//        return ptr;
-//    }
-//    throw std::bad_alloc{};
-//}
-//
-//NODISCARD void* operator new[](size_t size, const std::nothrow_t&) noexcept
-//{
-//    return Engine::Memory::Malloc(size);
-//}
-//
-///** override global operator delete */
-//void operator delete(void* ptr)
-//{
-//    Engine::Memory::Free(ptr);
-//}
-//
-//void operator delete(void* ptr, const std::nothrow_t&)
-//{
-//    Engine::Memory::Free(ptr);
-//}
-//
-//void operator delete[](void* ptr)
-//{
-//    Engine::Memory::Free(ptr);
-//}
-//
-//void operator delete[](void* ptr, const std::nothrow_t&)
-//{
-//    Engine::Memory::Free(ptr);
-//}
-//
-//void operator delete (void* ptr, size_t size) { Engine::Memory::Free(ptr); }
-//void operator delete[](void* ptr, size_t size) {Engine::Memory::Free(ptr); }
-//void operator delete (void* ptr, size_t size, const std::nothrow_t&) noexcept { Engine::Memory::Free(ptr); }
-//void operator delete[](void* ptr, size_t size, const std::nothrow_t&) noexcept {Engine::Memory::Free(ptr); }
+#if ENABLE_OVERRIDE_NEW_DELETE && (defined(PL_SHARED) || defined(CORE_EXPORT))
+
+namespace Engine::Details
+{
+    inline void* OperatorNew(std::size_t size, std::size_t alignment)
+    {
+        // operator new must return distinct non-null pointer for zero size
+        if (void* ptr = Memory::Malloc(size > 0 ? size : 1, static_cast<uint32>(alignment)))
+        {
+            return ptr;
+        }
+        throw std::bad_alloc{};
+    }
+
+    inline void* OperatorNewNoThrow(std::size_t size, std::size_t alignment) noexcept
+    {
+        return Memory::Malloc(size > 0 ? size : 1, static_cast<uint32>(alignment));
+    }
+}
+
+NODISCARD void* operator new(std::size_t size)
+{
+    return Engine::Details::OperatorNew(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+NODISCARD void* operator new[](std::size_t size)
+{
+    return Engine::Details::OperatorNew(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+NODISCARD void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return Engine::Details::OperatorNewNoThrow(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+NODISCARD void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return Engine::Details::OperatorNewNoThrow(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+NODISCARD void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    return Engine::Details::OperatorNew(size, static_cast<std::size_t>(alignment));
+}
+
+NODISCARD void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return Engine::Details::OperatorNew(size, static_cast<std::size_t>(alignment));
+}
+
+NODISCARD void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return Engine::Details::OperatorNewNoThrow(size, static_cast<std::size_t>(alignment));
+}
+
+NODISCARD void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return Engine::Details::OperatorNewNoThrow(size, static_cast<std::size_t>(alignment));
+}
+
+/** override global operator delete */
+void operator delete(void* ptr) noexcept { Engine::Memory::Free(ptr); }
+void operator delete[](void* ptr) noexcept { Engine::Memory::Free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { Engine::Memory::Free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { Engine::Memory::Free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { Engine::Memory::Free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { Engine::Memory::Free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { Engine::Memory::Free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { Engine::Memory::Free(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { Engine::Memory::Free(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { Engine::Memory::Free(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { Engine::Memory::Free(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { Engine::Memory::Free(ptr); }
+
+#endif
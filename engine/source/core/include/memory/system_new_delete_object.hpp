@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdlib>
 #include <new>
 #include "definitions_core.hpp"
 
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "global.hpp"
+#include "definitions_core.hpp"
+
+namespace Engine
+{
+    enum class ECpuFeature : uint8
+    {
+        Sse2,
+        Sse3,
+        Ssse3,
+        Sse41,
+        Sse42,
+        Popcnt,
+        Avx,
+        Avx2,
+        Fma,
+        Bmi2,
+        Avx512F,
+        Avx512BW,
+        Avx512VL,
+        Count
+    };
+
+    /** Instruction set tiers kernels are dispatched on, every tier includes the ones before it */
+    enum class ESimdLevel : uint8
+    {
+        Scalar,
+        /** baseline of x86-64 */
+        Sse2,
+        /** avx, avx2 and fma */
+        Avx2,
+        /** avx512 f, bw and vl */
+        Avx512,
+    };
+
+    /**
+     * Features of the cpu the process runs on, detected once with cpuid, so one binary can pick the widest kernels
+     * a machine supports instead of what the build machine supported.
+     * Environment variable POLARIS_SIMD_LEVEL (scalar, sse2, avx2 or avx512) lowers the level for testing and
+     * disables features of the tiers above it, a level higher than the detected one is ignored.
+     */
+    class CORE_API CpuFeatures
+    {
+    public:
+        static constexpr const char* OVERRIDE_ENV_NAME = "POLARIS_SIMD_LEVEL";
+
+        CpuFeatures() = delete;
+
+        /**
+         * @return false if cpu or os doesn't support feature, or its tier is above GetSimdLevel.
+         * Sse3 to Popcnt belong to tier Sse2, Avx to Bmi2 to tier Avx2
+         */
+        static bool HasFeature(ECpuFeature feature);
+
+        /** detected level, lowered by POLARIS_SIMD_LEVEL */
+        static ESimdLevel GetSimdLevel();
+
+        static ESimdLevel GetDetectedSimdLevel();
+
+        static const char* GetFeatureName(ECpuFeature feature);
+
+        static const char* GetSimdLevelName(ESimdLevel level);
+
+        /** case insensitive reverse of GetSimdLevelName, returns false if name is unknown */
+        static bool ParseSimdLevel(const char* name, ESimdLevel& outLevel);
+    };
+}
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "definitions_core.hpp"
 #include "global.hpp"
 #include "module/module_interface.hpp"
+#include "memory/memory_tag.hpp"
 #include "foundation/string_id.hpp"
 
 namespace Engine
@@ -49,6 +50,7 @@ namespace Engine
 
                 if (!module)
                 {
+                    MEMORY_TAG_SCOPE(Module);
                     module = new Module();
                     module->Startup();
                     CachedModule.Add(name, module);
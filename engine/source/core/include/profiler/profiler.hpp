@@ -0,0 +1,135 @@
+#pragma once
+
+#include <atomic>
+#include "global.hpp"
+#include "definitions_core.hpp"
+#include "foundation/array.hpp"
+#include "foundation/string.hpp"
+
+namespace Engine
+{
+    /** a finished PROFILE_SCOPE, time is in nanoseconds of Profiler::Now */
+    struct ProfileEvent
+    {
+        /** must outlive profiler, string literal in general */
+        const char* Name{ nullptr };
+        int64 Begin{ 0 };
+        int64 End{ 0 };
+        /** nesting level in its thread, 0 for outermost scope */
+        int32 Depth{ 0 };
+    };
+
+    struct ProfileThreadEvents
+    {
+        uint64 ThreadId{ 0 };
+        String ThreadName;
+        /** ordered by end time */
+        Array<ProfileEvent> Events;
+    };
+
+    /** aggregated scopes of the same name within a frame */
+    struct ProfileScopeStat
+    {
+        const char* Name{ nullptr };
+        int32 CallNum{ 0 };
+        /** time including nested scopes */
+        int64 InclusiveTime{ 0 };
+        /** time excluding nested scopes */
+        int64 ExclusiveTime{ 0 };
+        int64 MaxTime{ 0 };
+    };
+
+    struct ProfileFrame
+    {
+        uint64 Index{ 0 };
+        int64 Begin{ 0 };
+        int64 End{ 0 };
+        /** ordered by exclusive time, largest first */
+        Array<ProfileScopeStat> Stats;
+    };
+
+    /**
+     * Hierarchical cpu profiler fed by PROFILE_SCOPE.
+     * Every thread writes finished scopes into its own ring buffer without locking, oldest events are overwritten,
+     * so the last few frames can be captured at any time without attaching an external profiler.
+     * Frames are delimited by MarkFrame, which is called once a tick by EngineLoop.
+     */
+    class CORE_API Profiler
+    {
+    public:
+        /** events each thread keeps */
+        static constexpr int32 THREAD_BUFFER_CAPACITY = 1 << 14;
+        /** frame markers kept */
+        static constexpr int32 FRAME_CAPACITY = 256;
+
+        static bool IsEnabled() { return Enabled.load(std::memory_order_relaxed); }
+
+        static void SetEnabled(bool enable) { Enabled.store(enable, std::memory_order_relaxed); }
+
+        /** nanoseconds of HighResolutionClock */
+        static int64 Now();
+
+        /** record a finished scope of calling thread, begin and end are cycles of HighResolutionClock */
+        static void Record(const char* name, int64 begin, int64 end, int32 depth);
+
+        /** start a new frame, events are attributed to the frame they begin in */
+        static void MarkFrame();
+
+        /** index of current frame, 0 before first MarkFrame */
+        static uint64 GetFrameIndex();
+
+        /** shown instead of thread id in exported trace */
+        static void SetThreadName(const String& name);
+
+        /** copy buffered events of every thread, events still being written are skipped */
+        static Array<ProfileThreadEvents> CollectEvents();
+
+        /** aggregate last frameNum finished frames, oldest first, a frame whose events are overwritten is skipped */
+        static Array<ProfileFrame> CollectFrames(int32 frameNum);
+
+        /**
+         * Write buffered events as Chrome trace event format, it can be opened by chrome://tracing, Perfetto,
+         * or imported by Tracy with its import-chrome tool.
+         */
+        static bool ExportChromeTrace(const String& filePath);
+
+        /** write aggregated report of last frameNum frames as text */
+        static bool ExportFrameReport(const String& filePath, int32 frameNum);
+
+        /** drop buffered events and frames */
+        static void Reset();
+
+    private:
+        static std::atomic<bool> Enabled;
+    };
+
+    /** record a scope when it ends, use it by PROFILE_SCOPE */
+    class CORE_API ProfileScope
+    {
+    public:
+        explicit ProfileScope(const char* name);
+
+        ~ProfileScope();
+
+        ProfileScope(const ProfileScope& other) = delete;
+
+        ProfileScope& operator= (const ProfileScope& other) = delete;
+
+    private:
+        const char* Name;
+        int64 Begin{ 0 };
+    };
+
+#if ENABLE_PROFILER
+    #define PROFILE_SCOPE_JOIN_INNER(a, b) a##b
+    #define PROFILE_SCOPE_JOIN(a, b) PROFILE_SCOPE_JOIN_INNER(a, b)
+    /** name must be a string literal or live as long as profiler */
+    #define PROFILE_SCOPE(name) ::Engine::ProfileScope PROFILE_SCOPE_JOIN(profileScope, __LINE__)(name)
+    #define PROFILE_FUNCTION() PROFILE_SCOPE(__FUNCTION__)
+    #define PROFILE_FRAME() ::Engine::Profiler::MarkFrame()
+#else
+    #define PROFILE_SCOPE(name)
+    #define PROFILE_FUNCTION()
+    #define PROFILE_FRAME()
+#endif
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "global.hpp"
+#include "definitions_core.hpp"
+#include "foundation/array.hpp"
+#include "foundation/string.hpp"
+#include "foundation/string_id.hpp"
+#include "spdlog/fmt/fmt.h"
+
+namespace Engine
+{
+    enum class EStatType : uint8
+    {
+        /** monotonically increasing total, eg: bytes read */
+        Counter,
+        /** current value which can go up and down, eg: loaded modules */
+        Gauge,
+        /** distribution of recorded values in power of two buckets, eg: allocation size */
+        Histogram
+    };
+
+    enum class EStatExportFormat : uint8
+    {
+        Text,
+        /** a row per stat is appended on every export, so values can be tracked over time */
+        Csv,
+        /** text exposition format, it can be collected by textfile collector of node exporter */
+        Prometheus
+    };
+
+    /** value of a stat merged at the end of last frame */
+    struct StatValue
+    {
+        StringID Name;
+        String Description;
+        EStatType Type{ EStatType::Counter };
+        /** total of counter, value of gauge, recorded count of histogram */
+        int64 Value{ 0 };
+        /** increase of counter and count of histogram in last frame, 0 for gauge */
+        int64 FrameValue{ 0 };
+        /** sum of values recorded by histogram */
+        int64 Sum{ 0 };
+        /** count of histogram bucket i, see Stats::GetBucketUpperBound */
+        Array<int64> Buckets;
+    };
+
+    /**
+     * Process wide registry of counters, gauges and histograms identified by name.
+     * Counters and histograms are accumulated by every thread without locking or contended atomics,
+     * and merged once a frame by EndFrame, which is called by EngineLoop.
+     * Stats are registered once and never removed, handles are cheap to keep in static variables.
+     */
+    class CORE_API Stats
+    {
+    public:
+        static constexpr int32 MAX_STAT_NUM = 512;
+        /** upper bound of slots threads accumulate into, a histogram takes HISTOGRAM_BUCKET_NUM + 2. Blocks of threads only hold registered ones */
+        static constexpr int32 MAX_SLOT_NUM = 4096;
+        /** bucket 0 holds values <= 0, bucket i holds [2^(i-1), 2^i), the last bucket holds anything larger */
+        static constexpr int32 HISTOGRAM_BUCKET_NUM = 48;
+
+        /** merge values of every thread, exports which are due are written afterwards */
+        static void EndFrame();
+
+        /** frames merged so far */
+        static uint64 GetFrameIndex();
+
+        /** values as of last EndFrame, ordered by registration */
+        static Array<StatValue> GetValues();
+
+        /** @return nullptr if stat isn't registered */
+        static const StatValue* FindValue(const Array<StatValue>& values, const StringID& name);
+
+        /** inclusive upper bound of histogram bucket, INT64_MAX for the last one */
+        static int64 GetBucketUpperBound(int32 bucket);
+
+        static bool Export(EStatExportFormat format, const String& filePath);
+
+        /** export from EndFrame every intervalSeconds, so stats are written continuously while engine runs */
+        static void AddPeriodicExport(EStatExportFormat format, const String& filePath, int32 intervalSeconds);
+
+        static void RemovePeriodicExports();
+
+        static void Format(EStatExportFormat format, const Array<StatValue>& values, fmt::memory_buffer& out);
+
+    private:
+        friend class StatCounter;
+        friend class StatGauge;
+        friend class StatHistogram;
+
+        /** @return index of stat, 0 if registry is full */
+        static uint32 Register(const StringID& name, const char* description, EStatType type);
+
+        static uint32 GetSlot(uint32 index);
+    };
+
+    /**
+     * Handle of a counter, eg: static StatCounter GStatBytesRead("FileSystem.BytesRead", "bytes read from files");
+     * A handle whose constructor hasn't run yet is zero and ignores values, so it can be updated while static objects are
+     * initialized, eg: counting allocations made by registration itself.
+     */
+    class CORE_API StatCounter
+    {
+    public:
+        explicit StatCounter(const StringID& name, const char* description = "");
+
+        void Add(int64 value = 1) const;
+
+        bool IsValid() const { return Slot != 0; }
+
+    private:
+        uint32 Slot{ 0 };
+    };
+
+    class CORE_API StatGauge
+    {
+    public:
+        explicit StatGauge(const StringID& name, const char* description = "");
+
+        void Set(int64 value) const;
+
+        void Add(int64 value) const;
+
+        int64 Get() const;
+
+        bool IsValid() const { return Index != 0; }
+
+    private:
+        uint32 Index{ 0 };
+    };
+
+    class CORE_API StatHistogram
+    {
+    public:
+        explicit StatHistogram(const StringID& name, const char* description = "");
+
+        void Record(int64 value) const;
+
+        bool IsValid() const { return Slot != 0; }
+
+    private:
+        uint32 Slot{ 0 };
+    };
+}
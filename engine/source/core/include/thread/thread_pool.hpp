@@ -28,8 +28,9 @@ namespace Engine
         WorkThread(WorkThread&& other) noexcept;
 
     public:
-        std::atomic<bool> Stop;
+        std::atomic<bool> Stop{ false };
         IWorkThreadTask* volatile Task{ nullptr };
+        std::mutex Mutex;
         std::condition_variable Condition;
 
     private:
@@ -79,5 +80,7 @@ namespace Engine
         std::queue<WorkThread*> IdleWorkers;
         std::mutex TaskQueueMutex;
         std::mutex WorkerQueueMutex;
+        /** set while workers are stopped, tasks added meanwhile run on adding thread, guarded by both queue mutexes */
+        bool Destroying{ false };
     };
 }
@@ -0,0 +1,255 @@
+#include "file_system/async_file_io.hpp"
+#include "log/logger.hpp"
+#include "math/generic_math.hpp"
+#include "memory/memory.hpp"
+#include "profiler/profiler.hpp"
+#include "file_system/async_io_backend.hpp"
+#include "file_system/file_system_log.hpp"
+#include "stats/stats.hpp"
+
+namespace Engine
+{
+    static StatCounter GStatBytesRead("FileSystem.BytesRead", "bytes read from files, including async reads");
+
+    AsyncReadRequest::AsyncReadRequest(SharedPtr<AsyncReadFile> file, int64 offset, int64 size, EAsyncIOPriority priority, uint8* dest)
+        : File(MoveTemp(file))
+        , Offset(offset)
+        , Size(Math::Max(size, static_cast<int64>(0)))
+        , Dest(dest)
+        , OwnsBuffer(dest == nullptr)
+        , Priority(priority)
+    {
+        if (OwnsBuffer && Size > 0)
+        {
+            Dest = static_cast<uint8*>(Memory::Malloc(static_cast<size_t>(Size)));
+        }
+    }
+
+    AsyncReadRequest::~AsyncReadRequest()
+    {
+        if (OwnsBuffer)
+        {
+            Memory::Free(Dest);
+        }
+    }
+
+    uint8* AsyncReadRequest::ReleaseData()
+    {
+        OwnsBuffer = false;
+        return Dest;
+    }
+
+    bool AsyncReadRequest::Cancel()
+    {
+        EAsyncIOStatus expected = EAsyncIOStatus::Pending;
+        if (!Status.compare_exchange_strong(expected, EAsyncIOStatus::Cancelled, std::memory_order_acq_rel))
+        {
+            return false;
+        }
+        NotifyFinished();
+        return true;
+    }
+
+    void AsyncReadRequest::Wait() const
+    {
+        while (!Finished.load(std::memory_order_acquire))
+        {
+            Finished.wait(false, std::memory_order_acquire);
+        }
+    }
+
+    bool AsyncReadRequest::TryStart()
+    {
+        EAsyncIOStatus expected = EAsyncIOStatus::Pending;
+        return Status.compare_exchange_strong(expected, EAsyncIOStatus::Reading, std::memory_order_acq_rel);
+    }
+
+    void AsyncReadRequest::Finish(int64 bytesRead, bool succeeded)
+    {
+        BytesRead = bytesRead;
+        GStatBytesRead.Add(bytesRead);
+        Status.store(succeeded ? EAsyncIOStatus::Completed : EAsyncIOStatus::Failed, std::memory_order_release);
+        NotifyFinished();
+    }
+
+    void AsyncReadRequest::NotifyFinished()
+    {
+        OnCompleted.ExecuteIfBound(*this);
+        Finished.store(true, std::memory_order_release);
+        Finished.notify_all();
+    }
+
+    ThreadAsyncIOBackend::ThreadAsyncIOBackend(int32 threadNum)
+    {
+        Threads.Reserve(threadNum);
+        for (int32 index = 0; index < threadNum; ++index)
+        {
+            Threads.Add(std::thread(&ThreadAsyncIOBackend::Run, this));
+        }
+    }
+
+    ThreadAsyncIOBackend::~ThreadAsyncIOBackend()
+    {
+        {
+            std::scoped_lock lock(Mutex);
+            Stopping = true;
+        }
+        Condition.notify_all();
+
+        for (std::thread& thread : Threads)
+        {
+            thread.join();
+        }
+
+        while (AsyncReadRequestPtr request = PendingRequests.Pop())
+        {
+            request->Cancel();
+        }
+    }
+
+    void ThreadAsyncIOBackend::Submit(const AsyncReadRequestPtr* requests, int32 count)
+    {
+        {
+            std::scoped_lock lock(Mutex);
+            for (int32 index = 0; index < count; ++index)
+            {
+                PendingRequests.Push(requests[index]);
+            }
+        }
+
+        if (count == 1)
+        {
+            Condition.notify_one();
+        }
+        else
+        {
+            Condition.notify_all();
+        }
+    }
+
+    void ThreadAsyncIOBackend::Run()
+    {
+        MEMORY_TAG_SCOPE(FileSystem);
+        while (true)
+        {
+            AsyncReadRequestPtr request;
+            {
+                std::unique_lock lock(Mutex);
+                Condition.wait(lock, [this]() { return Stopping || !PendingRequests.Empty(); });
+                if (Stopping)
+                {
+                    return;
+                }
+                request = PendingRequests.Pop();
+            }
+
+            if (!request->TryStart())
+            {
+                continue;
+            }
+
+            PROFILE_SCOPE("ThreadAsyncIOBackend::Read");
+            const int64 bytesRead = AsyncFileIO::ReadAt(request->GetFile()->GetNativeHandle(), request->GetData(),
+                                                        request->GetOffset(), request->GetSize());
+            request->Finish(Math::Max(bytesRead, static_cast<int64>(0)), bytesRead >= 0);
+        }
+    }
+
+    static std::mutex GAsyncIOMutex;
+    /** shared so that a caller still submitting keeps backend alive across a concurrent Shutdown or Initialize */
+    static SharedPtr<IAsyncIOBackend> GAsyncIOBackend;
+
+    static UniquePtr<IAsyncIOBackend> CreateAsyncIOBackend(bool allowNativeBackend, int32 threadNum)
+    {
+        UniquePtr<IAsyncIOBackend> backend = allowNativeBackend ? CreateNativeAsyncIOBackend() : nullptr;
+        if (backend == nullptr)
+        {
+            if (threadNum <= 0)
+            {
+                // io threads mostly sleep in kernel, a few of them are enough to keep device queue busy
+                threadNum = Math::Clamp(static_cast<int32>(std::thread::hardware_concurrency()) / 2, 2, 8);
+            }
+            backend = MakeUnique<ThreadAsyncIOBackend>(threadNum);
+        }
+        LOG_INFO(FileSystem, "Async io backend: {0}", backend->GetName());
+        return backend;
+    }
+
+    static SharedPtr<IAsyncIOBackend> GetAsyncIOBackend()
+    {
+        std::scoped_lock lock(GAsyncIOMutex);
+        if (UNLIKELY(GAsyncIOBackend == nullptr))
+        {
+            GAsyncIOBackend = CreateAsyncIOBackend(true, 0);
+        }
+        return GAsyncIOBackend;
+    }
+
+    /**
+     * Destroy a backend which is no longer reachable from GAsyncIOBackend, out of lock since completion callbacks
+     * of draining requests may read again. Waits for callers still submitting, so that it's always destroyed here
+     * and never on one of its own io threads.
+     */
+    static void DestroyAsyncIOBackend(SharedPtr<IAsyncIOBackend>&& backend)
+    {
+        while (backend != nullptr && backend.use_count() > 1)
+        {
+            std::this_thread::yield();
+        }
+        backend.reset();
+    }
+
+    void AsyncFileIO::Initialize(bool allowNativeBackend, int32 threadNum)
+    {
+        SharedPtr<IAsyncIOBackend> oldBackend;
+        {
+            std::scoped_lock lock(GAsyncIOMutex);
+            oldBackend = MoveTemp(GAsyncIOBackend);
+            GAsyncIOBackend = CreateAsyncIOBackend(allowNativeBackend, threadNum);
+        }
+        DestroyAsyncIOBackend(MoveTemp(oldBackend));
+    }
+
+    void AsyncFileIO::Shutdown()
+    {
+        SharedPtr<IAsyncIOBackend> backend;
+        {
+            std::scoped_lock lock(GAsyncIOMutex);
+            backend = MoveTemp(GAsyncIOBackend);
+        }
+        DestroyAsyncIOBackend(MoveTemp(backend));
+    }
+
+    const char* AsyncFileIO::GetBackendName()
+    {
+        return GetAsyncIOBackend()->GetName();
+    }
+
+    AsyncReadRequestPtr AsyncFileIO::Read(const SharedPtr<AsyncReadFile>& file, int64 offset, int64 size,
+                                          EAsyncIOPriority priority, AsyncReadCompleted&& onCompleted, uint8* dest)
+    {
+        ENSURE(file != nullptr);
+        if (size < 0 || offset + size > file->GetSize())
+        {
+            size = Math::Max(file->GetSize() - offset, static_cast<int64>(0));
+        }
+
+        auto request = MakeShared<AsyncReadRequest>(file, offset, size, priority, dest);
+        request->OnCompleted = MoveTemp(onCompleted);
+        Submit(request);
+        return request;
+    }
+
+    void AsyncFileIO::Submit(const Array<AsyncReadRequestPtr>& requests)
+    {
+        if (requests.Size() > 0)
+        {
+            GetAsyncIOBackend()->Submit(requests.Data(), requests.Size());
+        }
+    }
+
+    void AsyncFileIO::Submit(const AsyncReadRequestPtr& request)
+    {
+        GetAsyncIOBackend()->Submit(&request, 1);
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "foundation/queue.hpp"
+#include "file_system/async_file_io.hpp"
+
+namespace Engine
+{
+    constexpr int32 ASYNC_IO_PRIORITY_NUM = static_cast<int32>(EAsyncIOPriority::Count);
+
+    /** pending requests bucketed by priority, FIFO inside a bucket */
+    class AsyncIOPriorityQueue
+    {
+    public:
+        void Push(const AsyncReadRequestPtr& request)
+        {
+            Buckets[static_cast<int32>(request->GetPriority())].push(request);
+            ++Count;
+        }
+
+        AsyncReadRequestPtr Pop()
+        {
+            for (int32 index = ASYNC_IO_PRIORITY_NUM - 1; index >= 0; --index)
+            {
+                if (!Buckets[index].empty())
+                {
+                    AsyncReadRequestPtr request = MoveTemp(Buckets[index].front());
+                    Buckets[index].pop();
+                    --Count;
+                    return request;
+                }
+            }
+            return nullptr;
+        }
+
+        bool Empty() const { return Count == 0; }
+
+    private:
+        Queue<AsyncReadRequestPtr> Buckets[ASYNC_IO_PRIORITY_NUM];
+        int32 Count{ 0 };
+    };
+
+    /** portable backend, every io thread issues blocking positional reads */
+    class ThreadAsyncIOBackend final : public IAsyncIOBackend
+    {
+    public:
+        explicit ThreadAsyncIOBackend(int32 threadNum);
+
+        ~ThreadAsyncIOBackend() final;
+
+        void Submit(const AsyncReadRequestPtr* requests, int32 count) final;
+
+        const char* GetName() const final { return "Thread"; }
+
+    private:
+        void Run();
+
+        std::mutex Mutex;
+        std::condition_variable Condition;
+        AsyncIOPriorityQueue PendingRequests;
+        Array<std::thread> Threads;
+        bool Stopping{ false };
+    };
+
+    /** platform backend such as io_uring, nullptr if it's not supported */
+    UniquePtr<IAsyncIOBackend> CreateNativeAsyncIOBackend();
+}
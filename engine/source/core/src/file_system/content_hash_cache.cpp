@@ -0,0 +1,364 @@
+#include "file_system/content_hash_cache.hpp"
+#include "file_system/file_stream.hpp"
+#include "file_system/file_system.hpp"
+#include "file_system/file_system_log.hpp"
+#include "file_system/path.hpp"
+#include "foundation/time.hpp"
+#include "log/logger.hpp"
+#include "math/city_hash.hpp"
+
+namespace Engine
+{
+    namespace
+    {
+        constexpr int64 HASH_CHUNK_SIZE = 1 << 20;
+        /** guard against allocating for a corrupted length */
+        constexpr uint32 MAX_SERIALIZED_LENGTH = 1u << 30;
+        /** coarsest modify time resolution of common file systems, FAT keeps it in 2 seconds */
+        constexpr uint64 MODIFY_TIME_GRANULARITY_MS = 2000;
+
+        void WriteString(FileWriter& writer, const String& str)
+        {
+            writer.Write(static_cast<uint32>(str.Length()));
+            writer.Write(reinterpret_cast<const uint8*>(str.Data()), str.Length());
+        }
+
+        bool ReadString(FileReader& reader, String& outStr)
+        {
+            uint32 length;
+            if (!reader.Read(length) || length > MAX_SERIALIZED_LENGTH)
+            {
+                return false;
+            }
+            outStr.Clear();
+            if (length == 0)
+            {
+                return true;
+            }
+            outStr = String(static_cast<int32>(length), '\0');
+            return reader.Read(reinterpret_cast<uint8*>(outStr.Data()), length) == length;
+        }
+
+        bool ReadBinary(FileReader& reader, Array<uint8>& outData)
+        {
+            uint32 size;
+            if (!reader.Read(size) || size > MAX_SERIALIZED_LENGTH)
+            {
+                return false;
+            }
+            outData.Resize(static_cast<int32>(size));
+            return reader.Read(outData.Data(), size) == size;
+        }
+    }
+
+    ContentHashCache::ContentHashCache(const String& cacheFile)
+        : CacheFile(cacheFile)
+    {
+        if (FileSystem::FileExists(CacheFile) && !Load())
+        {
+            LOG_WARN(FileSystem, "Content hash cache {0} is corrupted, it's rebuilt", CacheFile.Data());
+            Records.Clear();
+            Dirty = true;
+        }
+    }
+
+    bool ContentHashCache::HashFile(const String& path, ContentHash& outHash)
+    {
+        FileReader reader(path, HASH_CHUNK_SIZE);
+        if (!reader.IsValid())
+        {
+            return false;
+        }
+
+        // whole file is rarely in memory, so chunks are chained by seeding each with hash of previous ones
+        Array<uint8> chunk;
+        chunk.Resize(static_cast<int32>(HASH_CHUNK_SIZE));
+        uint128 hash{ 0, 0 };
+        bool first = true;
+        while (true)
+        {
+            const int64 size = reader.Read(chunk.Data(), HASH_CHUNK_SIZE);
+            if (size <= 0 && !first)
+            {
+                break;
+            }
+            const char* data = reinterpret_cast<const char*>(chunk.Data());
+            hash = first ? CityHash::CityHash128(data, static_cast<size_t>(size)) :
+                           CityHash::CityHash128WithSeed(data, static_cast<size_t>(size), hash);
+            first = false;
+            if (size < HASH_CHUNK_SIZE)
+            {
+                break;
+            }
+        }
+
+        if (reader.HasError())
+        {
+            LOG_ERROR(FileSystem, "Read {0} for hashing failed", path.Data());
+            return false;
+        }
+        outHash = ContentHash{ hash.first, hash.second };
+        return true;
+    }
+
+    ContentHashCache::~ContentHashCache()
+    {
+        Save();
+    }
+
+    bool ContentHashCache::IsUnchanged(const String& path) const
+    {
+        const FileState state = GetFileState(path);
+        if (!state.IsValid())
+        {
+            return false;
+        }
+
+        std::scoped_lock lock(Mutex);
+        return FindValidRecord(Path::Normalize(path), state) != nullptr;
+    }
+
+    bool ContentHashCache::GetHash(const String& path, ContentHash& outHash)
+    {
+        const String key = Path::Normalize(path);
+        const uint64 hashTime = static_cast<uint64>(PlatformClock::Now().ToTimePoint().time_since_epoch().count());
+        const FileState state = GetFileState(path);
+        if (!state.IsValid())
+        {
+            return false;
+        }
+
+        {
+            std::scoped_lock lock(Mutex);
+            if (const Record* record = FindValidRecord(key, state))
+            {
+                outHash = record->Hash;
+                return true;
+            }
+        }
+
+        if (!HashFile(path, outHash))
+        {
+            return false;
+        }
+
+        // file changed while it's read, hash is fine for caller but not for record
+        const FileState stateAfter = GetFileState(path);
+        if (stateAfter.Size != state.Size || stateAfter.ModifyTime != state.ModifyTime)
+        {
+            return true;
+        }
+
+        std::scoped_lock lock(Mutex);
+        Record* record = Records.Find(key);
+        if (record == nullptr)
+        {
+            record = &Records.Add(key, Record());
+        }
+        if (record->Hash != outHash)
+        {
+            record->Artifacts.Clear();
+        }
+        record->Size = state.Size;
+        record->ModifyTime = state.ModifyTime;
+        record->HashTime = hashTime;
+        record->Hash = outHash;
+        Dirty = true;
+        return true;
+    }
+
+    bool ContentHashCache::SetArtifact(const String& path, const ContentHash& sourceHash, const String& name, Array<uint8>&& data)
+    {
+        std::scoped_lock lock(Mutex);
+        Record* record = Records.Find(Path::Normalize(path));
+        if (record == nullptr || record->Hash != sourceHash)
+        {
+            return false;
+        }
+
+        if (Array<uint8>* artifact = record->Artifacts.Find(name))
+        {
+            *artifact = MoveTemp(data);
+        }
+        else
+        {
+            record->Artifacts.Add(name, MoveTemp(data));
+        }
+        Dirty = true;
+        return true;
+    }
+
+    bool ContentHashCache::FindArtifact(const String& path, const String& name, Array<uint8>& outData) const
+    {
+        const FileState state = GetFileState(path);
+        if (!state.IsValid())
+        {
+            return false;
+        }
+
+        std::scoped_lock lock(Mutex);
+        const Record* record = FindValidRecord(Path::Normalize(path), state);
+        const Array<uint8>* artifact = record != nullptr ? record->Artifacts.Find(name) : nullptr;
+        if (artifact == nullptr)
+        {
+            return false;
+        }
+        outData = *artifact;
+        return true;
+    }
+
+    void ContentHashCache::Remove(const String& path)
+    {
+        std::scoped_lock lock(Mutex);
+        Dirty |= Records.Remove(Path::Normalize(path));
+    }
+
+    void ContentHashCache::Clear()
+    {
+        std::scoped_lock lock(Mutex);
+        Dirty |= Records.Size() > 0;
+        Records.Clear();
+    }
+
+    int32 ContentHashCache::GetRecordNum() const
+    {
+        std::scoped_lock lock(Mutex);
+        return Records.Size();
+    }
+
+    bool ContentHashCache::Save()
+    {
+        std::scoped_lock lock(Mutex);
+        if (!Dirty)
+        {
+            return true;
+        }
+
+        const int32 separator = CacheFile.LastIndexOf('/');
+        if (separator > 0)
+        {
+            FileSystem::MakeDirTree(CacheFile.Slices(0, separator));
+        }
+
+        const String tempFile = CacheFile + ".tmp";
+        bool written;
+        {
+            FileWriter writer(tempFile);
+            if (!writer.IsValid())
+            {
+                LOG_ERROR(FileSystem, "Save content hash cache {0} failed", CacheFile.Data());
+                return false;
+            }
+            writer.SetEndian(EEndian::Little);
+            writer.Write(MAGIC);
+            writer.Write(VERSION);
+            writer.Write(static_cast<uint32>(Records.Size()));
+            for (const auto& pair : Records)
+            {
+                const Record& record = pair.Value;
+                WriteString(writer, pair.Key);
+                writer.Write(record.Size);
+                writer.Write(record.ModifyTime);
+                writer.Write(record.HashTime);
+                writer.Write(record.Hash.Low);
+                writer.Write(record.Hash.High);
+                writer.Write(static_cast<uint32>(record.Artifacts.Size()));
+                for (const auto& artifact : record.Artifacts)
+                {
+                    WriteString(writer, artifact.Key);
+                    writer.Write(static_cast<uint32>(artifact.Value.Size()));
+                    writer.Write(artifact.Value.Data(), artifact.Value.Size());
+                }
+            }
+            written = writer.Flush() && !writer.HasError();
+        }
+
+        if (!written)
+        {
+            LOG_ERROR(FileSystem, "Save content hash cache {0} failed", CacheFile.Data());
+            FileSystem::RemoveFile(tempFile);
+            return false;
+        }
+
+        FileSystem::RemoveFile(CacheFile);
+        if (!FileSystem::MoveFile(tempFile, CacheFile))
+        {
+            LOG_ERROR(FileSystem, "Replace content hash cache {0} failed", CacheFile.Data());
+            return false;
+        }
+        Dirty = false;
+        return true;
+    }
+
+    bool ContentHashCache::Load()
+    {
+        MEMORY_TAG_SCOPE(FileSystem);
+        FileReader reader(CacheFile);
+        if (!reader.IsValid())
+        {
+            return false;
+        }
+        reader.SetEndian(EEndian::Little);
+
+        uint32 magic, version, recordNum;
+        if (!reader.Read(magic) || magic != MAGIC || !reader.Read(version) || !reader.Read(recordNum))
+        {
+            return false;
+        }
+        if (version != VERSION)
+        {
+            // records of other versions are simply dropped
+            Dirty = true;
+            return true;
+        }
+
+        for (uint32 index = 0; index < recordNum; ++index)
+        {
+            String key;
+            Record record;
+            uint32 artifactNum;
+            if (!ReadString(reader, key) || !reader.Read(record.Size) || !reader.Read(record.ModifyTime) ||
+                !reader.Read(record.HashTime) || !reader.Read(record.Hash.Low) || !reader.Read(record.Hash.High) ||
+                !reader.Read(artifactNum))
+            {
+                return false;
+            }
+
+            for (uint32 artifactIndex = 0; artifactIndex < artifactNum; ++artifactIndex)
+            {
+                String name;
+                Array<uint8> data;
+                if (!ReadString(reader, name) || !ReadBinary(reader, data))
+                {
+                    return false;
+                }
+                record.Artifacts.Add(MoveTemp(name), MoveTemp(data));
+            }
+            Records.Add(MoveTemp(key), MoveTemp(record));
+        }
+        return !reader.HasError();
+    }
+
+    ContentHashCache::FileState ContentHashCache::GetFileState(const String& path)
+    {
+        FileState state;
+        state.Size = FileSystem::FileSize(path);
+        if (state.Size >= 0)
+        {
+            // file time is in seconds, FileStat of the same file truncated
+            state.ModifyTime = static_cast<uint64>(FileSystem::GetFileTime(path).LastModifyTime) * 1000;
+        }
+        return state;
+    }
+
+    const ContentHashCache::Record* ContentHashCache::FindValidRecord(const String& key, const FileState& state) const
+    {
+        const Record* record = Records.Find(key);
+        if (record == nullptr || record->Size != state.Size || record->ModifyTime != state.ModifyTime)
+        {
+            return nullptr;
+        }
+        // modify time is truncated to file system granularity, a change right after hashing may keep the same one
+        return record->HashTime > state.ModifyTime + MODIFY_TIME_GRANULARITY_MS ? record : nullptr;
+    }
+}
@@ -0,0 +1,234 @@
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "file_system/directory_walker.hpp"
+#include "file_system/path.hpp"
+#include "foundation/smart_ptr.hpp"
+#include "math/generic_math.hpp"
+
+namespace Engine
+{
+    /** state shared by threads of one walk, pool tasks keep it alive as they may start after walk is done */
+    class DirectoryWalkContext
+    {
+    public:
+        DirectoryWalkContext(IPlatformFile& platformFile, const String& root, const FileMatcher& matcher,
+                             const DirectoryVisitor& visitor, bool recursive, bool includeDirectories)
+            : PlatformFile(platformFile)
+            , Matcher(matcher)
+            , Visitor(visitor)
+            , Recursive(recursive)
+            , IncludeDirectories(includeDirectories)
+        {
+            String normalizedRoot = Path::Normalize(root);
+            RootLength = normalizedRoot.Length() + (normalizedRoot.EndsWith('/') ? 0 : 1);
+            PendingDirs.Add(MoveTemp(normalizedRoot));
+        }
+
+        /** take queued directories until tree is done, every thread runs it */
+        void Run()
+        {
+            MEMORY_TAG_SCOPE(FileSystem);
+            Array<String> subdirs;
+            while (true)
+            {
+                String directory;
+                {
+                    std::unique_lock lock(Mutex);
+                    Condition.wait(lock, [this] {
+                        return !PendingDirs.Empty() || BusyNum == 0 || Stopped.load(std::memory_order_relaxed);
+                    });
+
+                    // nothing queued and nobody scanning means no more directories will come
+                    if (PendingDirs.Empty() || Stopped.load(std::memory_order_relaxed))
+                    {
+                        return;
+                    }
+                    directory = PendingDirs.Pop();
+                    ++BusyNum;
+                }
+
+                subdirs.Clear();
+                Scan(directory, subdirs);
+
+                bool finished;
+                {
+                    std::lock_guard lock(Mutex);
+                    for (String& subdir : subdirs)
+                    {
+                        PendingDirs.Push(MoveTemp(subdir));
+                    }
+                    --BusyNum;
+                    finished = BusyNum == 0 && PendingDirs.Empty();
+                }
+
+                if (finished || subdirs.Size() > 1 || Stopped.load(std::memory_order_relaxed))
+                {
+                    Condition.notify_all();
+                }
+                else if (subdirs.Size() == 1)
+                {
+                    Condition.notify_one();
+                }
+            }
+        }
+
+        /** called by pool task before Run, false if walk is already done */
+        bool Enter()
+        {
+            std::lock_guard lock(Mutex);
+            if (Closed)
+            {
+                return false;
+            }
+            ++ActiveNum;
+            return true;
+        }
+
+        void Leave()
+        {
+            {
+                std::lock_guard lock(Mutex);
+                --ActiveNum;
+            }
+            Condition.notify_all();
+        }
+
+        /** wait for pool tasks still in Run, tasks which start later won't touch visitor */
+        void Close()
+        {
+            std::unique_lock lock(Mutex);
+            Closed = true;
+            Condition.wait(lock, [this] { return ActiveNum == 0; });
+        }
+
+        int64 GetVisitedNum() const
+        {
+            return VisitedNum.load(std::memory_order_relaxed);
+        }
+
+    private:
+        void Scan(const String& directory, Array<String>& subdirs)
+        {
+            PlatformFile.IterateDirectory(directory, [&](const DirectoryEntry& entry) {
+                if (Stopped.load(std::memory_order_relaxed))
+                {
+                    return false;
+                }
+
+                const String& path = entry.GetPath();
+                const bool isDirectory = entry.IsDirectory();
+                if (isDirectory && Recursive)
+                {
+                    subdirs.Add(path);
+                }
+                if (isDirectory && !IncludeDirectories)
+                {
+                    return true;
+                }
+
+                if (!Matcher.IsMatchAll())
+                {
+                    const int32 nameStart = path.LastIndexOf('/') + 1;
+                    const StringView name(path.Data() + nameStart, path.Length() - nameStart);
+                    const StringView relativePath(path.Data() + RootLength, path.Length() - RootLength);
+                    if (!Matcher.Match(name, relativePath))
+                    {
+                        return true;
+                    }
+                }
+
+                VisitedNum.fetch_add(1, std::memory_order_relaxed);
+                if (!Visitor(entry))
+                {
+                    Stopped.store(true, std::memory_order_relaxed);
+                    return false;
+                }
+                return true;
+            });
+        }
+
+        IPlatformFile& PlatformFile;
+        const FileMatcher& Matcher;
+        const DirectoryVisitor& Visitor;
+        bool Recursive;
+        bool IncludeDirectories;
+        int32 RootLength;
+
+        std::mutex Mutex;
+        std::condition_variable Condition;
+        /** used as a stack, so a thread tends to go deep and stay in nearby directories */
+        Array<String> PendingDirs;
+        int32 BusyNum{ 0 };
+        /** pool tasks in Run */
+        int32 ActiveNum{ 0 };
+        bool Closed{ false };
+        std::atomic<bool> Stopped{ false };
+        std::atomic<int64> VisitedNum{ 0 };
+    };
+
+    class DirectoryWalkTask final : public IWorkThreadTask
+    {
+    public:
+        explicit DirectoryWalkTask(SharedPtr<DirectoryWalkContext> context)
+            : Context(MoveTemp(context))
+        {}
+
+        void Run() override
+        {
+            if (Context->Enter())
+            {
+                Context->Run();
+                Context->Leave();
+            }
+            // pool doesn't own tasks, nothing touches this one after it returns
+            delete this;
+        }
+
+    private:
+        SharedPtr<DirectoryWalkContext> Context;
+    };
+
+    static int32 GetDefaultThreadNum()
+    {
+        // listing mostly waits on file system, more threads than cores still helps on cold cache
+        return Math::Clamp(static_cast<int32>(std::thread::hardware_concurrency()), 2, 16);
+    }
+
+    static IThreadPool& GetSharedThreadPool()
+    {
+        static UniquePtr<BuiltInThreadPool> pool = []() {
+            UniquePtr<BuiltInThreadPool> newPool = MakeUnique<BuiltInThreadPool>();
+            // calling thread of a walk scans as well
+            newPool->Create(GetDefaultThreadNum() - 1);
+            return newPool;
+        }();
+        return *pool;
+    }
+
+    DirectoryWalker::DirectoryWalker(IPlatformFile& platformFile, int32 threadNum, IThreadPool* threadPool)
+        : PlatformFile(platformFile)
+        , ThreadNum(threadNum > 0 ? threadNum : GetDefaultThreadNum())
+        , ThreadPool(threadPool)
+    {}
+
+    int64 DirectoryWalker::Walk(const String& root, const FileMatcher& matcher, const DirectoryVisitor& visitor,
+                                bool recursive, bool includeDirectories)
+    {
+        SharedPtr<DirectoryWalkContext> context = MakeShared<DirectoryWalkContext>(PlatformFile, root, matcher, visitor,
+                                                                                   recursive, includeDirectories);
+
+        // one directory has nothing to share
+        const int32 threadNum = recursive ? ThreadNum : 1;
+        IThreadPool& threadPool = ThreadPool != nullptr ? *ThreadPool : GetSharedThreadPool();
+        for (int32 index = 1; index < threadNum; ++index)
+        {
+            threadPool.AddTask(new DirectoryWalkTask(context));
+        }
+
+        context->Run();
+        context->Close();
+        return context->GetVisitedNum();
+    }
+}
@@ -0,0 +1,273 @@
+#include "file_system/file_matcher.hpp"
+
+namespace Engine
+{
+    namespace
+    {
+        enum class EGlobResult : uint8
+        {
+            Matched,
+            NotMatched,
+            /** nothing after this point can match, outer stars don't need to retry */
+            AbortAll,
+            /** only an outer '**' can retry, as rest of string crosses a '/' */
+            AbortToDoubleStar
+        };
+
+        inline char FoldCase(char ch, bool caseInsensitive)
+        {
+            return caseInsensitive && ch >= 'A' && ch <= 'Z' ? static_cast<char>(ch - 'A' + 'a') : ch;
+        }
+
+        inline bool CharEquals(char lhs, char rhs, bool caseInsensitive)
+        {
+            return FoldCase(lhs, caseInsensitive) == FoldCase(rhs, caseInsensitive);
+        }
+
+        bool EqualsView(const char* lhs, const char* rhs, int32 length, bool caseInsensitive)
+        {
+            for (int32 index = 0; index < length; ++index)
+            {
+                if (!CharEquals(lhs[index], rhs[index], caseInsensitive))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /**
+         * Match one character against set starting after '['.
+         * @param pattern moved to closing ']'
+         * @return false if set isn't closed, then '[' is a normal character
+         */
+        bool MatchSet(const char*& pattern, const char* patternEnd, char ch, bool caseInsensitive, bool& outMatched)
+        {
+            const char* cursor = pattern + 1;
+            const bool negate = cursor < patternEnd && (*cursor == '!' || *cursor == '^');
+            if (negate)
+            {
+                ++cursor;
+            }
+
+            bool matched = false;
+            const char folded = FoldCase(ch, caseInsensitive);
+            // ']' right after '[' is a member of set
+            for (bool first = true; cursor < patternEnd && (first || *cursor != ']'); ++cursor, first = false)
+            {
+                if (cursor + 2 < patternEnd && cursor[1] == '-' && cursor[2] != ']')
+                {
+                    matched |= folded >= FoldCase(cursor[0], caseInsensitive) && folded <= FoldCase(cursor[2], caseInsensitive);
+                    cursor += 2;
+                }
+                else
+                {
+                    matched |= folded == FoldCase(*cursor, caseInsensitive);
+                }
+            }
+
+            if (cursor >= patternEnd)
+            {
+                return false;
+            }
+            pattern = cursor;
+            outMatched = matched != negate;
+            return true;
+        }
+
+        EGlobResult GlobMatch(const char* pattern, const char* patternEnd, const char* str, const char* strEnd, bool caseInsensitive)
+        {
+            for (; pattern < patternEnd; ++pattern, ++str)
+            {
+                const char ch = *pattern;
+                if (str >= strEnd && ch != '*')
+                {
+                    return EGlobResult::AbortAll;
+                }
+
+                switch (ch)
+                {
+                    case '?':
+                    {
+                        if (*str == '/')
+                        {
+                            return EGlobResult::NotMatched;
+                        }
+                        break;
+                    }
+                    case '*':
+                    {
+                        const bool matchSlash = pattern + 1 < patternEnd && pattern[1] == '*';
+                        while (pattern < patternEnd && *pattern == '*')
+                        {
+                            ++pattern;
+                        }
+
+                        if (pattern == patternEnd)
+                        {
+                            if (matchSlash)
+                            {
+                                return EGlobResult::Matched;
+                            }
+                            for (; str < strEnd; ++str)
+                            {
+                                if (*str == '/')
+                                {
+                                    return EGlobResult::NotMatched;
+                                }
+                            }
+                            return EGlobResult::Matched;
+                        }
+
+                        // "**/" also matches no directory
+                        if (matchSlash && *pattern == '/' &&
+                            GlobMatch(pattern + 1, patternEnd, str, strEnd, caseInsensitive) == EGlobResult::Matched)
+                        {
+                            return EGlobResult::Matched;
+                        }
+
+                        for (;; ++str)
+                        {
+                            const EGlobResult result = GlobMatch(pattern, patternEnd, str, strEnd, caseInsensitive);
+                            if (result != EGlobResult::NotMatched && (!matchSlash || result != EGlobResult::AbortToDoubleStar))
+                            {
+                                return result;
+                            }
+                            if (str >= strEnd)
+                            {
+                                return EGlobResult::AbortAll;
+                            }
+                            if (!matchSlash && *str == '/')
+                            {
+                                return EGlobResult::AbortToDoubleStar;
+                            }
+                        }
+                    }
+                    case '[':
+                    {
+                        bool matched = false;
+                        if (MatchSet(pattern, patternEnd, *str, caseInsensitive, matched))
+                        {
+                            if (!matched || *str == '/')
+                            {
+                                return EGlobResult::NotMatched;
+                            }
+                            break;
+                        }
+                        if (*str != '[')
+                        {
+                            return EGlobResult::NotMatched;
+                        }
+                        break;
+                    }
+                    default:
+                    {
+                        if (!CharEquals(ch, *str, caseInsensitive))
+                        {
+                            return EGlobResult::NotMatched;
+                        }
+                        break;
+                    }
+                }
+            }
+            return str == strEnd ? EGlobResult::Matched : EGlobResult::NotMatched;
+        }
+
+        bool HasWildcard(const String& text, int32 start)
+        {
+            for (int32 index = start; index < text.Length(); ++index)
+            {
+                if (text[index] == '*' || text[index] == '?' || text[index] == '[')
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+    }
+
+    FileMatcher::FileMatcher(const String& patterns, ECaseSensitivity cs)
+        : CaseSensitivity(cs)
+    {
+        const Array<String> parts = patterns.Split(";", SkipEmptyParts);
+        for (const String& part : parts)
+        {
+            Pattern pattern;
+            pattern.Text = part.Trimmed();
+            pattern.Text.Replace("\\", "/");
+            if (pattern.Text.Empty())
+            {
+                continue;
+            }
+
+            pattern.MatchPath = pattern.Text.Contains('/') || pattern.Text.Contains("**");
+            if (pattern.Text == "*" || pattern.Text == "**")
+            {
+                // any pattern matching everything makes the whole matcher match everything
+                Patterns.Clear();
+                return;
+            }
+            else if (!HasWildcard(pattern.Text, 0))
+            {
+                pattern.Kind = EPatternKind::Exact;
+            }
+            else if (pattern.Text[0] == '*' && !pattern.MatchPath && !HasWildcard(pattern.Text, 1))
+            {
+                pattern.Kind = EPatternKind::Suffix;
+                pattern.Text.Remove(0, 1);
+            }
+            else
+            {
+                pattern.Kind = EPatternKind::Glob;
+            }
+            Patterns.Add(MoveTemp(pattern));
+        }
+    }
+
+    bool FileMatcher::Match(const StringView& name, const StringView& relativePath) const
+    {
+        if (Patterns.Empty())
+        {
+            return true;
+        }
+
+        const bool caseInsensitive = CaseSensitivity == CaseInsensitive;
+        for (const Pattern& pattern : Patterns)
+        {
+            const StringView& target = pattern.MatchPath ? relativePath : name;
+            const int32 length = pattern.Text.Length();
+            switch (pattern.Kind)
+            {
+                case EPatternKind::Exact:
+                {
+                    if (target.Length() == length && EqualsView(target.Data(), pattern.Text.Data(), length, caseInsensitive))
+                    {
+                        return true;
+                    }
+                    break;
+                }
+                case EPatternKind::Suffix:
+                {
+                    if (target.Length() >= length &&
+                        EqualsView(target.Data() + target.Length() - length, pattern.Text.Data(), length, caseInsensitive))
+                    {
+                        return true;
+                    }
+                    break;
+                }
+                case EPatternKind::Glob:
+                {
+                    if (GlobMatch(pattern.Text.Data(), pattern.Text.Data() + length, target.Data(),
+                                  target.Data() + target.Length(), caseInsensitive) == EGlobResult::Matched)
+                    {
+                        return true;
+                    }
+                    break;
+                }
+                default:
+                    return true;
+            }
+        }
+        return false;
+    }
+}
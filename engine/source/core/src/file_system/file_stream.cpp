@@ -0,0 +1,269 @@
+#include "file_system/file_stream.hpp"
+#include "math/generic_math.hpp"
+#include "memory/memory.hpp"
+#include "file_system/file_system.hpp"
+
+namespace Engine
+{
+    FileReader::FileReader(const String& filePath, int64 bufferSize, bool readAhead)
+        : File(AsyncFileIO::OpenFile(filePath))
+        , BufferSize(Math::Max(bufferSize, static_cast<int64>(1)))
+        , ReadAhead(readAhead)
+    {
+        if (File == nullptr)
+        {
+            return;
+        }
+
+        const int32 blockNum = ReadAhead ? 2 : 1;
+        for (int32 index = 0; index < blockNum; ++index)
+        {
+            Blocks[index].Data = static_cast<uint8*>(Memory::Malloc(static_cast<size_t>(BufferSize)));
+        }
+
+        Issue(Blocks[0], 0, EAsyncIOPriority::High);
+        if (ReadAhead)
+        {
+            Issue(Blocks[1], BufferSize, EAsyncIOPriority::Normal);
+        }
+    }
+
+    FileReader::~FileReader()
+    {
+        // requests write into blocks, they must be finished before blocks are released
+        CancelAll();
+        for (Block& block : Blocks)
+        {
+            Memory::Free(block.Data);
+        }
+    }
+
+    int64 FileReader::Read(uint8* dest, int64 size)
+    {
+        if (!IsValid())
+        {
+            return 0;
+        }
+
+        int64 totalSize = 0;
+        while (totalSize < size && !Error)
+        {
+            Block& block = Blocks[Current];
+            Complete(block);
+
+            const int64 available = block.Size - Cursor;
+            if (available <= 0)
+            {
+                if (!Advance())
+                {
+                    break;
+                }
+                continue;
+            }
+
+            const int64 copySize = Math::Min(available, size - totalSize);
+            Memory::Memcpy(dest + totalSize, block.Data + Cursor, static_cast<size_t>(copySize));
+            Cursor += copySize;
+            totalSize += copySize;
+        }
+        return totalSize;
+    }
+
+    bool FileReader::Seek(int64 position)
+    {
+        if (!IsValid() || position < 0)
+        {
+            return false;
+        }
+
+        // stay in current block, either loaded or in flight
+        Block& block = Blocks[Current];
+        const int64 blockEnd = block.Offset + (block.Request != nullptr ? block.Request->GetSize() : block.Size);
+        if (position >= block.Offset && position <= blockEnd)
+        {
+            Cursor = position - block.Offset;
+            return true;
+        }
+
+        CancelAll();
+        Current = 0;
+        Cursor = 0;
+        Issue(Blocks[0], position, EAsyncIOPriority::High);
+        if (ReadAhead)
+        {
+            Issue(Blocks[1], position + BufferSize, EAsyncIOPriority::Normal);
+        }
+        return true;
+    }
+
+    void FileReader::Issue(Block& block, int64 offset, EAsyncIOPriority priority)
+    {
+        block.Offset = offset;
+        block.Size = 0;
+        block.Request.reset();
+        if (offset < GetSize())
+        {
+            block.Request = AsyncFileIO::Read(File, offset, Math::Min(BufferSize, GetSize() - offset), priority,
+                                              AsyncReadCompleted(), block.Data);
+        }
+    }
+
+    void FileReader::Complete(Block& block)
+    {
+        if (block.Request == nullptr)
+        {
+            return;
+        }
+
+        block.Request->Wait();
+        if (block.Request->GetStatus() == EAsyncIOStatus::Completed)
+        {
+            block.Size = block.Request->GetBytesRead();
+        }
+        else
+        {
+            Error = true;
+        }
+        block.Request.reset();
+    }
+
+    void FileReader::CancelAll()
+    {
+        for (Block& block : Blocks)
+        {
+            if (block.Request != nullptr && !block.Request->Cancel())
+            {
+                block.Request->Wait();
+            }
+            block.Request.reset();
+            block.Size = 0;
+        }
+    }
+
+    bool FileReader::Advance()
+    {
+        const Block& block = Blocks[Current];
+        const int64 nextOffset = block.Offset + block.Size;
+        if (block.Size == 0 || nextOffset >= GetSize())
+        {
+            return false;
+        }
+
+        if (!ReadAhead)
+        {
+            // single block is reused
+            Cursor = 0;
+            Issue(Blocks[Current], nextOffset, EAsyncIOPriority::High);
+            Complete(Blocks[Current]);
+            return Blocks[Current].Size > 0;
+        }
+
+        Block& next = Blocks[1 - Current];
+        const bool nextReady = next.Offset == nextOffset && (next.Request != nullptr || next.Size > 0);
+        if (!nextReady)
+        {
+            CancelAll();
+            Issue(next, nextOffset, EAsyncIOPriority::High);
+        }
+
+        Current = 1 - Current;
+        Cursor = 0;
+        Complete(Blocks[Current]);
+
+        // previous block is free now, start reading the one after
+        Block& current = Blocks[Current];
+        Issue(Blocks[1 - Current], current.Offset + current.Size, EAsyncIOPriority::Normal);
+        return current.Size > 0;
+    }
+
+    FileWriter::FileWriter(const String& filePath, int64 bufferSize, bool append)
+        : Handle(FileSystem::OpenFile(filePath, append ? EFileAccess::ReadWrite : EFileAccess::Write))
+        , BufferSize(Math::Max(bufferSize, static_cast<int64>(1)))
+    {
+        if (Handle == nullptr)
+        {
+            return;
+        }
+
+        Position = append ? Handle->GetSize() : 0;
+        Buffer = static_cast<uint8*>(Memory::Malloc(static_cast<size_t>(BufferSize)));
+    }
+
+    FileWriter::~FileWriter()
+    {
+        if (IsValid())
+        {
+            WriteBuffer();
+        }
+        Memory::Free(Buffer);
+    }
+
+    bool FileWriter::Write(const uint8* src, int64 size)
+    {
+        if (!IsValid() || Error)
+        {
+            return false;
+        }
+
+        // large data skips buffer
+        if (size >= BufferSize)
+        {
+            if (!WriteBuffer())
+            {
+                return false;
+            }
+
+            if (Handle->WriteAt(src, size, Position) != size)
+            {
+                Error = true;
+                return false;
+            }
+            Position += size;
+            return true;
+        }
+
+        while (size > 0)
+        {
+            const int64 copySize = Math::Min(size, BufferSize - BufferUsed);
+            Memory::Memcpy(Buffer + BufferUsed, src, static_cast<size_t>(copySize));
+            BufferUsed += copySize;
+            src += copySize;
+            size -= copySize;
+
+            if (BufferUsed == BufferSize && !WriteBuffer())
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool FileWriter::Flush(bool toDevice)
+    {
+        if (!IsValid() || !WriteBuffer())
+        {
+            return false;
+        }
+        return !toDevice || Handle->Flush();
+    }
+
+    bool FileWriter::WriteBuffer()
+    {
+        if (Error)
+        {
+            return false;
+        }
+
+        if (BufferUsed > 0)
+        {
+            if (Handle->WriteAt(Buffer, BufferUsed, Position) != BufferUsed)
+            {
+                Error = true;
+                return false;
+            }
+            Position += BufferUsed;
+            BufferUsed = 0;
+        }
+        return true;
+    }
+}
@@ -1,10 +1,16 @@
 //#include "precompiled_core.hpp"
 #include "file_system/file_system.hpp"
 #include "file_system/path.hpp"
+#include "file_system/content_hash_cache.hpp"
+#include "file_system/directory_walker.hpp"
+#include "file_system/pak_platform_file.hpp"
 
 #if PLATFORM_WINDOWS
 #include "windows/windows_platform_file.hpp"
 #include "windows/windows_file_handle.hpp"
+#elif PLATFORM_LINUX
+#include "linux/linux_platform_file.hpp"
+#include "linux/linux_file_handle.hpp"
 #endif
 
 namespace Engine
@@ -49,11 +55,12 @@ namespace Engine
 
     bool FileSystem::ClearDir(const String& path)
     {
-        auto files = PlatformFile->QueryFiles(path, ".", false);
+        auto files = PlatformFile->QueryFiles(path, ".*", true);
         //! files is BFS
         for (auto iter = files.rbegin(); iter != files.rend(); --iter)
         {
-            if (IsDirectory(*iter) && !RemoveDir(*iter))
+            //! link to a directory is listed but not descended, only unlink removes it
+            if (IsDirectory(*iter) && !RemoveDir(*iter) && !RemoveFile(*iter))
             {
                 return false;
             }
@@ -70,6 +77,12 @@ namespace Engine
         return PlatformFile->QueryFiles(searchPath, regex, recursion);
     }
 
+    int64 FileSystem::WalkDirectory(const String& root, const FileMatcher& matcher, const DirectoryVisitor& visitor,
+                                    bool recursive, bool includeDirectories)
+    {
+        return DirectoryWalker(*PlatformFile).Walk(root, matcher, visitor, recursive, includeDirectories);
+    }
+
     String FileSystem::GetEngineRootPath()
     {
         return ENGINE_ROOT_PATH;
@@ -80,18 +93,47 @@ namespace Engine
         return Path::Combine(GetEngineRootPath(), "saved");
     }
 
+    // pak layer is always on top, it forwards everything to physical file system until a pak is mounted
 #if PLATFORM_WINDOWS
-    UniquePtr<IPlatformFile> FileSystem::PlatformFile = MakeUnique<WindowsPlatformFile>();
+    UniquePtr<IPlatformFile> FileSystem::PlatformFile = MakeUnique<PakPlatformFile>(MakeUnique<WindowsPlatformFile>());
+#elif PLATFORM_LINUX
+    UniquePtr<IPlatformFile> FileSystem::PlatformFile = MakeUnique<PakPlatformFile>(MakeUnique<LinuxPlatformFile>());
 #endif
 
+    bool FileSystem::MountPak(const String& pakPath, const String& mountPoint)
+    {
+        return static_cast<PakPlatformFile*>(PlatformFile.get())->Mount(pakPath, mountPoint);
+    }
+
+    bool FileSystem::UnmountPak(const String& pakPath)
+    {
+        return static_cast<PakPlatformFile*>(PlatformFile.get())->Unmount(pakPath);
+    }
+
     void FileSystem::ReadFileToBinary(const String& fileName, Array64<uint8>& outBinary)
     {
         UniquePtr<IFileHandle> handle = PlatformFile->OpenFile(fileName, EFileAccess::Read, EFileShareMode::Read);
+        if (handle == nullptr)
+        {
+            outBinary.Clear();
+            return;
+        }
+
         int64 fileSize = handle->GetSize();
         outBinary.Resize(fileSize);
         handle->Read(outBinary.Data(), fileSize);
     }
 
+    UniquePtr<IMappedFileHandle> FileSystem::MapFile(const String& fileName, int64 offset, int64 length, EMappedAccessHint hint)
+    {
+        return PlatformFile->MapFile(fileName, offset, length, hint);
+    }
+
+    UniquePtr<IFileHandle> FileSystem::OpenFile(const String& fileName, EFileAccess access, EFileShareMode mode)
+    {
+        return PlatformFile->OpenFile(fileName, access, mode);
+    }
+
     bool FileSystem::MakeFile(const String& path)
     {
         return PlatformFile->MakeFile(path);
@@ -127,6 +169,22 @@ namespace Engine
         return PlatformFile->GetFileTime(path);
     }
 
+    int64 FileSystem::FileSize(const String& path)
+    {
+        return PlatformFile->FileSize(path);
+    }
+
+    ContentHashCache& FileSystem::GetContentHashCache()
+    {
+        static ContentHashCache cache(Path::Combine(GetEngineSaveDir(), "cache/content_hash.bin"));
+        return cache;
+    }
+
+    bool FileSystem::IsFileUnchanged(const String& path)
+    {
+        return GetContentHashCache().IsUnchanged(path);
+    }
+
     FileSystem::DirectoryIterImpl::DirectoryIterImpl(const String& path, bool recursive)
     {
         if (recursive)
@@ -0,0 +1,338 @@
+#include <chrono>
+#include "file_system/file_watcher.hpp"
+#include "file_system/file_watcher_backend.hpp"
+#include "file_system/path.hpp"
+#include "math/generic_math.hpp"
+
+namespace Engine
+{
+    FileWatcher::FileWatcher(int32 coalesceDelayMs, int32 maxBatchDelayMs)
+        : Backend(CreateFileWatcherBackend())
+        , CoalesceDelayMs(coalesceDelayMs)
+        , MaxBatchDelayMs(Math::Max(coalesceDelayMs, maxBatchDelayMs))
+    {
+        if (Backend)
+        {
+            Thread = std::thread(&FileWatcher::Run, this);
+        }
+    }
+
+    FileWatcher::~FileWatcher()
+    {
+        if (Backend)
+        {
+            Stopping.store(true, std::memory_order_release);
+            Backend->Wake();
+            Thread.join();
+        }
+    }
+
+    FileWatchHandle FileWatcher::Watch(const String& directory, bool recursive, FileChangesDelegate&& onChanged,
+                                       EFileWatchDispatch dispatch)
+    {
+        if (!Backend)
+        {
+            return INDEX_NONE;
+        }
+
+        String path = Path::Normalize(directory);
+        while (path.Length() > 1 && path.EndsWith('/') && !path.EndsWith(":/"))
+        {
+            path.Chop(1);
+        }
+
+        SharedPtr<WatchedDirectory> watched = MakeShared<WatchedDirectory>();
+        watched->OnChanged = MoveTemp(onChanged);
+        watched->Dispatch = dispatch;
+
+        FileWatchHandle handle;
+        {
+            std::scoped_lock lock(Mutex);
+            handle = NextHandle++;
+            WatchedDirectories.Add(handle, watched);
+        }
+
+        if (!Backend->AddWatch(handle, path, recursive))
+        {
+            std::scoped_lock lock(Mutex);
+            WatchedDirectories.Remove(handle);
+            return INDEX_NONE;
+        }
+        return handle;
+    }
+
+    bool FileWatcher::Unwatch(FileWatchHandle handle)
+    {
+        if (!Backend)
+        {
+            return false;
+        }
+
+        // wait for delegate running on other thread
+        std::scoped_lock dispatchLock(DispatchMutex);
+        std::scoped_lock lock(Mutex);
+        if (!WatchedDirectories.Remove(handle))
+        {
+            return false;
+        }
+
+        for (int32 index = ReadyBatches.Size() - 1; index >= 0; --index)
+        {
+            if (ReadyBatches[index].Handle == handle)
+            {
+                ReadyBatches.RemoveAt(index);
+            }
+        }
+        Backend->RemoveWatch(handle);
+        return true;
+    }
+
+    int32 FileWatcher::DispatchEvents()
+    {
+        Array<ReadyBatch> batches;
+        {
+            std::scoped_lock lock(Mutex);
+            if (ReadyBatches.Empty())
+            {
+                return 0;
+            }
+            batches = MoveTemp(ReadyBatches);
+            ReadyBatches.Clear();
+        }
+
+        int32 dispatchedNum = 0;
+        for (ReadyBatch& batch : batches)
+        {
+            dispatchedNum += DispatchBatch(batch) ? 1 : 0;
+        }
+        return dispatchedNum;
+    }
+
+    void FileWatcher::Run()
+    {
+        MEMORY_TAG_SCOPE(FileSystem);
+        Array<RawFileChange> changes;
+        Array<ReadyBatch> immediateBatches;
+        int32 timeoutMs = -1;
+        while (!Stopping.load(std::memory_order_acquire))
+        {
+            Backend->WaitChanges(timeoutMs, changes);
+
+            const int64 now = GetTimeMs();
+            if (!changes.Empty())
+            {
+                std::scoped_lock lock(Mutex);
+                for (RawFileChange& change : changes)
+                {
+                    // changes of unwatched directory may still come from backend
+                    if (SharedPtr<WatchedDirectory>* watched = WatchedDirectories.Find(change.Handle))
+                    {
+                        AddChange(**watched, change, now);
+                    }
+                }
+                changes.Clear();
+            }
+
+            timeoutMs = FlushReadyBatches(now, immediateBatches);
+            for (ReadyBatch& batch : immediateBatches)
+            {
+                DispatchBatch(batch);
+            }
+            immediateBatches.Clear();
+        }
+    }
+
+    void FileWatcher::AddChange(WatchedDirectory& watched, RawFileChange& change, int64 now)
+    {
+        if (watched.PendingChanges.Empty())
+        {
+            watched.FirstChangeTime = now;
+        }
+        watched.LastChangeTime = now;
+
+        if (change.Action == EFileChangeAction::Renamed)
+        {
+            String fromPath = MoveTemp(change.OldPath);
+            bool created = false;
+            if (FileChange* pending = FindPendingChange(watched, fromPath))
+            {
+                // file created or renamed in this burst is only known by its final path
+                created = pending->Action == EFileChangeAction::Added;
+                if (pending->Action == EFileChangeAction::Renamed)
+                {
+                    fromPath = pending->OldPath;
+                }
+                DropPendingChange(watched, *pending);
+            }
+
+            if (FileChange* pending = FindPendingChange(watched, change.Path))
+            {
+                // file being overwritten was renamed from somewhere, the source is gone too
+                if (pending->Action == EFileChangeAction::Renamed)
+                {
+                    String overwrittenPath = pending->OldPath;
+                    DropPendingChange(watched, *pending);
+                    MergeChange(watched, EFileChangeAction::Removed, MoveTemp(overwrittenPath));
+                }
+                else
+                {
+                    DropPendingChange(watched, *pending);
+                }
+            }
+
+            if (created)
+            {
+                AddPendingChange(watched, EFileChangeAction::Added, MoveTemp(change.Path), String());
+            }
+            else if (fromPath == change.Path)
+            {
+                AddPendingChange(watched, EFileChangeAction::Modified, MoveTemp(change.Path), String());
+            }
+            else
+            {
+                AddPendingChange(watched, EFileChangeAction::Renamed, MoveTemp(change.Path), MoveTemp(fromPath));
+            }
+        }
+        else
+        {
+            MergeChange(watched, change.Action, MoveTemp(change.Path));
+        }
+    }
+
+    void FileWatcher::MergeChange(WatchedDirectory& watched, EFileChangeAction action, String&& path)
+    {
+        FileChange* pending = FindPendingChange(watched, path);
+        if (pending == nullptr)
+        {
+            AddPendingChange(watched, action, MoveTemp(path), String());
+            return;
+        }
+
+        switch (action)
+        {
+            case EFileChangeAction::Added:
+            {
+                // removed then created again is a replacement
+                if (pending->Action == EFileChangeAction::Removed)
+                {
+                    pending->Action = EFileChangeAction::Modified;
+                }
+                break;
+            }
+            case EFileChangeAction::Removed:
+            {
+                if (pending->Action == EFileChangeAction::Added)
+                {
+                    // listeners never saw this file
+                    DropPendingChange(watched, *pending);
+                }
+                else if (pending->Action == EFileChangeAction::Renamed)
+                {
+                    String oldPath = MoveTemp(pending->OldPath);
+                    DropPendingChange(watched, *pending);
+                    MergeChange(watched, EFileChangeAction::Removed, MoveTemp(oldPath));
+                }
+                else
+                {
+                    pending->Action = EFileChangeAction::Removed;
+                }
+                break;
+            }
+            case EFileChangeAction::Overflow:
+            {
+                pending->Action = EFileChangeAction::Overflow;
+                break;
+            }
+            default:
+                // added, replaced or renamed file is reloaded anyway
+                break;
+        }
+    }
+
+    FileChange* FileWatcher::FindPendingChange(WatchedDirectory& watched, const String& path)
+    {
+        int32* index = watched.PendingIndices.Find(path);
+        return index != nullptr ? &watched.PendingChanges[*index] : nullptr;
+    }
+
+    void FileWatcher::AddPendingChange(WatchedDirectory& watched, EFileChangeAction action, String&& path, String&& oldPath)
+    {
+        watched.PendingIndices.Add(path, watched.PendingChanges.Size());
+        watched.PendingChanges.Add(FileChange{ action, MoveTemp(path), MoveTemp(oldPath) });
+    }
+
+    void FileWatcher::DropPendingChange(WatchedDirectory& watched, FileChange& change)
+    {
+        watched.PendingIndices.Remove(change.Path);
+        // empty path marks a dropped change, indices of others stay valid
+        change.Path.Clear();
+        change.OldPath.Clear();
+    }
+
+    int32 FileWatcher::FlushReadyBatches(int64 now, Array<ReadyBatch>& outImmediateBatches)
+    {
+        int64 waitMs = -1;
+        std::scoped_lock lock(Mutex);
+        for (auto& pair : WatchedDirectories)
+        {
+            WatchedDirectory& watched = *pair.Value;
+            if (watched.PendingChanges.Empty())
+            {
+                continue;
+            }
+
+            const int64 readyTime = Math::Min(watched.LastChangeTime + CoalesceDelayMs, watched.FirstChangeTime + MaxBatchDelayMs);
+            if (now < readyTime)
+            {
+                waitMs = waitMs < 0 ? readyTime - now : Math::Min(waitMs, readyTime - now);
+                continue;
+            }
+
+            ReadyBatch batch;
+            batch.Handle = pair.Key;
+            batch.Watched = pair.Value;
+            for (FileChange& change : watched.PendingChanges)
+            {
+                if (!change.Path.Empty())
+                {
+                    batch.Changes.Add(MoveTemp(change));
+                }
+            }
+            watched.PendingChanges.Clear();
+            watched.PendingIndices.Clear();
+
+            if (!batch.Changes.Empty())
+            {
+                if (watched.Dispatch == EFileWatchDispatch::WatcherThread)
+                {
+                    outImmediateBatches.Add(MoveTemp(batch));
+                }
+                else
+                {
+                    ReadyBatches.Add(MoveTemp(batch));
+                }
+            }
+        }
+        return static_cast<int32>(waitMs);
+    }
+
+    bool FileWatcher::DispatchBatch(ReadyBatch& batch)
+    {
+        std::scoped_lock dispatchLock(DispatchMutex);
+        {
+            std::scoped_lock lock(Mutex);
+            if (!WatchedDirectories.Contains(batch.Handle))
+            {
+                return false;
+            }
+        }
+        // batch holds the delegate, it's fine for delegate to unwatch itself
+        batch.Watched->OnChanged.ExecuteIfBound(batch.Changes);
+        return true;
+    }
+
+    int64 FileWatcher::GetTimeMs()
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+}
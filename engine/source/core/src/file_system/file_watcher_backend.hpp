@@ -0,0 +1,42 @@
+#pragma once
+
+#include "file_system/file_watcher.hpp"
+
+namespace Engine
+{
+    /** change reported by backend, it's merged with others of the same path by FileWatcher */
+    struct RawFileChange
+    {
+        FileWatchHandle Handle;
+        EFileChangeAction Action;
+        String Path;
+        String OldPath;
+    };
+
+    class IFileWatcherBackend
+    {
+    public:
+        virtual ~IFileWatcherBackend() = default;
+
+        /**
+         * Thread safe, watching subdirectories created later is handled by backend.
+         * @param directory normalized and without trailing '/'
+         */
+        virtual bool AddWatch(FileWatchHandle handle, const String& directory, bool recursive) = 0;
+
+        /** thread safe, a WaitChanges running at the same time may still report changes of handle */
+        virtual void RemoveWatch(FileWatchHandle handle) = 0;
+
+        /**
+         * Called by watcher thread only, block until changes come, timeout expires or Wake is called.
+         * @param timeoutMs negative means waiting forever
+         */
+        virtual void WaitChanges(int32 timeoutMs, Array<RawFileChange>& outChanges) = 0;
+
+        /** make WaitChanges return */
+        virtual void Wake() = 0;
+    };
+
+    /** nullptr if platform isn't supported */
+    UniquePtr<IFileWatcherBackend> CreateFileWatcherBackend();
+}
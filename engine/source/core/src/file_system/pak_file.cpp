@@ -0,0 +1,537 @@
+#include <algorithm>
+#include "file_system/pak_file.hpp"
+#include "file_system/file_system.hpp"
+#include "file_system/file_system_log.hpp"
+#include "log/logger.hpp"
+#include "math/city_hash.hpp"
+#include "math/generic_math.hpp"
+#include "math/limit.hpp"
+#include "memory/memory.hpp"
+
+namespace Engine
+{
+    namespace
+    {
+        constexpr int64 SERIALIZED_ENTRY_SIZE = 32;
+        constexpr int64 SERIALIZED_BLOCK_SIZE = 16;
+
+        /** append little endian values to memory */
+        class IndexWriter
+        {
+        public:
+            explicit IndexWriter(Array<uint8>& data) : Data(data) {}
+
+            template <ByteSwappable T>
+            void Write(T value)
+            {
+                value = ConvertEndian(value, EEndian::Little);
+                Write(reinterpret_cast<const uint8*>(&value), sizeof(T));
+            }
+
+            void Write(const uint8* src, int64 size)
+            {
+                Data.Add(src, static_cast<int32>(size));
+            }
+
+        private:
+            Array<uint8>& Data;
+        };
+
+        /** read little endian values from memory, reading past the end fails */
+        class IndexReader
+        {
+        public:
+            IndexReader(const uint8* data, int64 size) : Data(data), Size(size) {}
+
+            template <ByteSwappable T>
+            bool Read(T& value)
+            {
+                if (!Read(reinterpret_cast<uint8*>(&value), sizeof(T)))
+                {
+                    return false;
+                }
+                value = ConvertEndian(value, EEndian::Little);
+                return true;
+            }
+
+            bool Read(uint8* dest, int64 size)
+            {
+                if (Size - Position < size)
+                {
+                    return false;
+                }
+                Memory::Memcpy(dest, Data + Position, static_cast<size_t>(size));
+                Position += size;
+                return true;
+            }
+
+        private:
+            const uint8* Data;
+            int64 Size;
+            int64 Position{ 0 };
+        };
+
+        void SerializeFooter(IndexWriter& writer, const PakFooter& footer)
+        {
+            writer.Write(footer.Magic);
+            writer.Write(footer.Version);
+            writer.Write(footer.BlockSize);
+            writer.Write(footer.EntryNum);
+            writer.Write(footer.BlockNum);
+            writer.Write(footer.NameTableSize);
+            writer.Write(footer.IndexOffset);
+            writer.Write(footer.IndexSize);
+            writer.Write(footer.IndexHash);
+        }
+
+        bool DeserializeFooter(IndexReader& reader, PakFooter& footer)
+        {
+            return reader.Read(footer.Magic) && reader.Read(footer.Version) && reader.Read(footer.BlockSize) &&
+                   reader.Read(footer.EntryNum) && reader.Read(footer.BlockNum) && reader.Read(footer.NameTableSize) &&
+                   reader.Read(footer.IndexOffset) && reader.Read(footer.IndexSize) && reader.Read(footer.IndexHash);
+        }
+
+        bool IsPowerOfTwo(uint32 value)
+        {
+            return value != 0 && (value & (value - 1)) == 0;
+        }
+    }
+
+    SharedPtr<PakFile> PakFile::Load(UniquePtr<IFileHandle> handle)
+    {
+        MEMORY_TAG_SCOPE(FileSystem);
+        if (handle == nullptr)
+        {
+            return nullptr;
+        }
+
+        SharedPtr<PakFile> pak = MakeShared<PakFile>(MoveTemp(handle));
+        if (!pak->LoadIndex())
+        {
+            return nullptr;
+        }
+        return pak;
+    }
+
+    String PakFile::NormalizePath(const String& path)
+    {
+        String ret = path;
+        ret.Replace("\\", "/");
+        while (ret.StartsWith("./"))
+        {
+            ret.Remove(0, 2);
+        }
+        while (ret.StartsWith('/'))
+        {
+            ret.Remove(0, 1);
+        }
+        return ret;
+    }
+
+    uint64 PakFile::HashPath(const String& path)
+    {
+        String lower = NormalizePath(path);
+        lower.ToLowerLatin1();
+        return CityHash::CityHash64(lower.Data(), lower.Length());
+    }
+
+    bool PakFile::LoadIndex()
+    {
+        const int64 fileSize = Handle->GetSize();
+        if (fileSize < PakFooter::SERIALIZED_SIZE)
+        {
+            return false;
+        }
+
+        uint8 footerData[PakFooter::SERIALIZED_SIZE];
+        if (Handle->ReadAt(footerData, PakFooter::SERIALIZED_SIZE, fileSize - PakFooter::SERIALIZED_SIZE) != PakFooter::SERIALIZED_SIZE)
+        {
+            return false;
+        }
+
+        IndexReader footerReader(footerData, PakFooter::SERIALIZED_SIZE);
+        DeserializeFooter(footerReader, Footer);
+        if (Footer.Magic != PakFooter::MAGIC)
+        {
+            LOG_ERROR(FileSystem, "File is not a pak");
+            return false;
+        }
+        if (Footer.Version != PakFooter::VERSION)
+        {
+            LOG_ERROR(FileSystem, "Pak version {0} is not supported", Footer.Version);
+            return false;
+        }
+
+        const int64 expectedIndexSize = Footer.EntryNum * SERIALIZED_ENTRY_SIZE + Footer.BlockNum * SERIALIZED_BLOCK_SIZE +
+                                        Footer.NameTableSize;
+        if (!IsPowerOfTwo(Footer.BlockSize) || static_cast<int64>(Footer.IndexSize) != expectedIndexSize ||
+            static_cast<int64>(Footer.IndexOffset + Footer.IndexSize) != fileSize - PakFooter::SERIALIZED_SIZE)
+        {
+            LOG_ERROR(FileSystem, "Pak footer is corrupted");
+            return false;
+        }
+
+        Array64<uint8> indexData;
+        indexData.Resize(static_cast<int64>(Footer.IndexSize));
+        if (Handle->ReadAt(indexData.Data(), indexData.Size(), static_cast<int64>(Footer.IndexOffset)) != indexData.Size())
+        {
+            return false;
+        }
+        if (CityHash::CityHash64(reinterpret_cast<const char*>(indexData.Data()), indexData.Size()) != Footer.IndexHash)
+        {
+            LOG_ERROR(FileSystem, "Pak index is corrupted");
+            return false;
+        }
+
+        IndexReader reader(indexData.Data(), indexData.Size());
+        Entries.Resize(static_cast<int32>(Footer.EntryNum));
+        for (PakEntry& entry : Entries)
+        {
+            reader.Read(entry.PathHash);
+            reader.Read(entry.Size);
+            reader.Read(entry.FirstBlock);
+            reader.Read(entry.BlockNum);
+            reader.Read(entry.NameOffset);
+            reader.Read(entry.NameLength);
+        }
+
+        Blocks.Resize(static_cast<int32>(Footer.BlockNum));
+        for (PakBlock& block : Blocks)
+        {
+            uint8 padding[3];
+            reader.Read(block.Offset);
+            reader.Read(block.CompressedSize);
+            reader.Read(block.Method);
+            reader.Read(padding, sizeof(padding));
+        }
+
+        NameTable.Resize(static_cast<int32>(Footer.NameTableSize));
+        reader.Read(reinterpret_cast<uint8*>(NameTable.Data()), NameTable.Size());
+
+        // hash only catches accidental damage, ranges are still checked before entries are used
+        for (const PakEntry& entry : Entries)
+        {
+            const int64 expectedBlockNum = (entry.Size + Footer.BlockSize - 1) / Footer.BlockSize;
+            if (entry.Size < 0 || entry.BlockNum != expectedBlockNum ||
+                static_cast<int64>(entry.FirstBlock) + entry.BlockNum > Blocks.Size() ||
+                static_cast<int64>(entry.NameOffset) + entry.NameLength > NameTable.Size())
+            {
+                LOG_ERROR(FileSystem, "Pak entry is corrupted");
+                return false;
+            }
+        }
+        return true;
+    }
+
+    const PakEntry* PakFile::FindEntry(const String& path) const
+    {
+        const uint64 hash = HashPath(path);
+        const String normalizedPath = NormalizePath(path);
+        const PakEntry* const end = Entries.Data() + Entries.Size();
+        const PakEntry* iter = std::lower_bound(Entries.Data(), end, hash, [](const PakEntry& entry, uint64 value) {
+            return entry.PathHash < value;
+        });
+
+        // different paths may share a hash, so names are compared
+        for (; iter != end && iter->PathHash == hash; ++iter)
+        {
+            if (static_cast<int32>(iter->NameLength) == normalizedPath.Length() &&
+                normalizedPath.StartsWith(StringView(NameTable.Data() + iter->NameOffset, iter->NameLength), CaseInsensitive))
+            {
+                return iter;
+            }
+        }
+        return nullptr;
+    }
+
+    String PakFile::GetEntryPath(const PakEntry& entry) const
+    {
+        return String(NameTable.Data() + entry.NameOffset, static_cast<int32>(entry.NameLength));
+    }
+
+    int64 PakFile::GetBlockUncompressedSize(const PakEntry& entry, int32 blockIndex) const
+    {
+        const int64 offset = static_cast<int64>(blockIndex) * Footer.BlockSize;
+        return Math::Min(entry.Size - offset, static_cast<int64>(Footer.BlockSize));
+    }
+
+    bool PakFile::ReadBlock(const PakEntry& entry, int32 blockIndex, uint8* dest) const
+    {
+        const PakBlock& block = GetBlock(entry, blockIndex);
+        const int64 size = GetBlockUncompressedSize(entry, blockIndex);
+        if (block.Method == ECompressionMethod::None)
+        {
+            return Handle->ReadAt(dest, size, static_cast<int64>(block.Offset)) == size;
+        }
+
+        Array<uint8> compressed;
+        compressed.Resize(static_cast<int32>(block.CompressedSize));
+        if (Handle->ReadAt(compressed.Data(), compressed.Size(), static_cast<int64>(block.Offset)) != compressed.Size())
+        {
+            return false;
+        }
+        if (!Compression::Decompress(block.Method, dest, size, compressed.Data(), compressed.Size()))
+        {
+            LOG_ERROR(FileSystem, "Decompress block {0} of {1} failed", blockIndex, GetEntryPath(entry).Data());
+            return false;
+        }
+        return true;
+    }
+
+    int64 PakFile::Read(const PakEntry& entry, uint8* dest, int64 size, int64 offset) const
+    {
+        if (offset < 0)
+        {
+            return -1;
+        }
+
+        size = Math::Min(size, entry.Size - offset);
+        int64 totalSize = 0;
+        Array<uint8> blockBuffer;
+        while (totalSize < size)
+        {
+            const int64 position = offset + totalSize;
+            const int32 blockIndex = static_cast<int32>(position / Footer.BlockSize);
+            const int64 offsetInBlock = position % Footer.BlockSize;
+            const int64 blockSize = GetBlockUncompressedSize(entry, blockIndex);
+            const int64 copySize = Math::Min(blockSize - offsetInBlock, size - totalSize);
+            const PakBlock& block = GetBlock(entry, blockIndex);
+
+            if (block.Method == ECompressionMethod::None)
+            {
+                if (Handle->ReadAt(dest + totalSize, copySize, static_cast<int64>(block.Offset) + offsetInBlock) != copySize)
+                {
+                    return -1;
+                }
+            }
+            else if (copySize == blockSize)
+            {
+                // whole block is decoded into dest directly
+                if (!ReadBlock(entry, blockIndex, dest + totalSize))
+                {
+                    return -1;
+                }
+            }
+            else
+            {
+                blockBuffer.Resize(static_cast<int32>(blockSize));
+                if (!ReadBlock(entry, blockIndex, blockBuffer.Data()))
+                {
+                    return -1;
+                }
+                Memory::Memcpy(dest + totalSize, blockBuffer.Data() + offsetInBlock, static_cast<size_t>(copySize));
+            }
+            totalSize += copySize;
+        }
+        return totalSize;
+    }
+
+    int64 PakFile::GetMappableOffset(const PakEntry& entry) const
+    {
+        if (entry.BlockNum == 0)
+        {
+            return -1;
+        }
+
+        const int64 offset = static_cast<int64>(GetBlock(entry, 0).Offset);
+        for (int32 index = 0; index < static_cast<int32>(entry.BlockNum); ++index)
+        {
+            const PakBlock& block = GetBlock(entry, index);
+            if (block.Method != ECompressionMethod::None ||
+                static_cast<int64>(block.Offset) != offset + static_cast<int64>(index) * Footer.BlockSize)
+            {
+                return -1;
+            }
+        }
+        return offset;
+    }
+
+    PakWriter::PakWriter(const String& pakPath, ECompressionMethod method, uint32 blockSize, uint32 alignment)
+        : Writer(pakPath)
+        , Method(method)
+        , BlockSize(blockSize)
+        , Alignment(alignment)
+    {
+        ENSURE(IsPowerOfTwo(BlockSize) && IsPowerOfTwo(Alignment) && Alignment <= BlockSize);
+        Writer.SetEndian(EEndian::Little);
+        CompressBuffer.Resize(static_cast<int32>(Compression::GetMaxCompressedSize(Method, BlockSize)));
+    }
+
+    PakWriter::~PakWriter()
+    {
+        if (!Finalized && Writer.IsValid())
+        {
+            Finalize();
+        }
+    }
+
+    bool PakWriter::BeginEntry(const String& path)
+    {
+        if (Finalized || !IsValid())
+        {
+            return false;
+        }
+
+        const String normalizedPath = PakFile::NormalizePath(path);
+        String lowerPath = normalizedPath;
+        lowerPath.ToLowerLatin1();
+        if (normalizedPath.Empty() || AddedPaths.Contains(lowerPath))
+        {
+            LOG_ERROR(FileSystem, "Path {0} is empty or already added to pak", normalizedPath.Data());
+            return false;
+        }
+        AddedPaths.Add(MoveTemp(lowerPath));
+
+        Entries.Add(PakEntry());
+        PakEntry& entry = Entries.Last();
+        entry.PathHash = PakFile::HashPath(normalizedPath);
+        entry.FirstBlock = static_cast<uint32>(Blocks.Size());
+        entry.NameOffset = static_cast<uint32>(NameTable.Size());
+        entry.NameLength = static_cast<uint32>(normalizedPath.Length());
+        NameTable.Add(normalizedPath.Data(), normalizedPath.Length());
+        return true;
+    }
+
+    bool PakWriter::WriteBlock(const uint8* data, int64 size)
+    {
+        // padding keeps block offset aligned
+        static constexpr uint8 PADDING[PakWriter::DEFAULT_ALIGNMENT] = {};
+        int64 paddingSize = (Alignment - Writer.Tell() % Alignment) % Alignment;
+        while (paddingSize > 0)
+        {
+            const int64 writeSize = Math::Min(paddingSize, static_cast<int64>(sizeof(PADDING)));
+            Writer.Write(PADDING, writeSize);
+            paddingSize -= writeSize;
+        }
+
+        Blocks.Add(PakBlock());
+        PakBlock& block = Blocks.Last();
+        block.Offset = static_cast<uint64>(Writer.Tell());
+
+        int64 compressedSize = -1;
+        if (Method != ECompressionMethod::None)
+        {
+            // capacity less than size fails early when data doesn't compress
+            compressedSize = Compression::Compress(Method, CompressBuffer.Data(), size - 1, data, size);
+        }
+
+        if (compressedSize > 0)
+        {
+            block.Method = Method;
+            block.CompressedSize = static_cast<uint32>(compressedSize);
+            Writer.Write(CompressBuffer.Data(), compressedSize);
+        }
+        else
+        {
+            block.Method = ECompressionMethod::None;
+            block.CompressedSize = static_cast<uint32>(size);
+            Writer.Write(data, size);
+        }
+
+        Entries.Last().Size += size;
+        Entries.Last().BlockNum += 1;
+        UncompressedSize += size;
+        CompressedSize += block.CompressedSize;
+        return IsValid();
+    }
+
+    bool PakWriter::AddFile(const String& path, const uint8* data, int64 size)
+    {
+        if (!BeginEntry(path))
+        {
+            return false;
+        }
+
+        for (int64 offset = 0; offset < size; offset += BlockSize)
+        {
+            if (!WriteBlock(data + offset, Math::Min(size - offset, static_cast<int64>(BlockSize))))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool PakWriter::AddFile(const String& path, const String& sourceFile)
+    {
+        FileReader reader(sourceFile);
+        if (!reader.IsValid())
+        {
+            LOG_ERROR(FileSystem, "Can't open {0} to add into pak", sourceFile.Data());
+            return false;
+        }
+
+        if (!BeginEntry(path))
+        {
+            return false;
+        }
+
+        Array<uint8> block;
+        block.Resize(static_cast<int32>(BlockSize));
+        while (!reader.IsEof())
+        {
+            const int64 size = reader.Read(block.Data(), BlockSize);
+            if (reader.HasError() || size <= 0 || !WriteBlock(block.Data(), size))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool PakWriter::Finalize()
+    {
+        if (Finalized)
+        {
+            return false;
+        }
+        Finalized = true;
+
+        if (!IsValid())
+        {
+            return false;
+        }
+
+        std::sort(Entries.Data(), Entries.Data() + Entries.Size(), [](const PakEntry& lhs, const PakEntry& rhs) {
+            return lhs.PathHash < rhs.PathHash;
+        });
+
+        Array<uint8> index;
+        IndexWriter indexWriter(index);
+        for (const PakEntry& entry : Entries)
+        {
+            indexWriter.Write(entry.PathHash);
+            indexWriter.Write(entry.Size);
+            indexWriter.Write(entry.FirstBlock);
+            indexWriter.Write(entry.BlockNum);
+            indexWriter.Write(entry.NameOffset);
+            indexWriter.Write(entry.NameLength);
+        }
+        for (const PakBlock& block : Blocks)
+        {
+            static constexpr uint8 padding[3] = {};
+            indexWriter.Write(block.Offset);
+            indexWriter.Write(block.CompressedSize);
+            indexWriter.Write(block.Method);
+            indexWriter.Write(padding, sizeof(padding));
+        }
+        indexWriter.Write(reinterpret_cast<const uint8*>(NameTable.Data()), NameTable.Size());
+
+        PakFooter footer;
+        footer.BlockSize = BlockSize;
+        footer.EntryNum = static_cast<uint32>(Entries.Size());
+        footer.BlockNum = static_cast<uint32>(Blocks.Size());
+        footer.NameTableSize = static_cast<uint32>(NameTable.Size());
+        footer.IndexOffset = static_cast<uint64>(Writer.Tell());
+        footer.IndexSize = static_cast<uint64>(index.Size());
+        footer.IndexHash = CityHash::CityHash64(reinterpret_cast<const char*>(index.Data()), index.Size());
+
+        Array<uint8> footerData;
+        IndexWriter footerWriter(footerData);
+        SerializeFooter(footerWriter, footer);
+
+        Writer.Write(index.Data(), index.Size());
+        Writer.Write(footerData.Data(), footerData.Size());
+        return Writer.Flush() && IsValid();
+    }
+}
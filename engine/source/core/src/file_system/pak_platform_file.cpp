@@ -0,0 +1,680 @@
+#include <algorithm>
+#include <mutex>
+#include <regex>
+#include "file_system/pak_platform_file.hpp"
+#include "file_system/path.hpp"
+#include "file_system/file_system_log.hpp"
+#include "log/logger.hpp"
+#include "math/generic_math.hpp"
+#include "memory/memory.hpp"
+
+namespace Engine
+{
+    /** read only handle of a file inside pak, last decoded block is kept for sequential reads */
+    class PakFileHandle final : public IFileHandle
+    {
+    public:
+        PakFileHandle(SharedPtr<PakFile> pak, const PakEntry& entry) : Pak(MoveTemp(pak)), Entry(entry) {}
+
+        int64 GetSize() const final
+        {
+            return Entry.Size;
+        }
+
+        bool Read(uint8* dest, int64 size) final
+        {
+            const int64 blockSize = Pak->GetBlockSize();
+            int64 totalSize = 0;
+            while (totalSize < size && PosInFile < Entry.Size)
+            {
+                const int32 blockIndex = static_cast<int32>(PosInFile / blockSize);
+                const int64 offsetInBlock = PosInFile % blockSize;
+                const int64 uncompressedSize = Pak->GetBlockUncompressedSize(Entry, blockIndex);
+                const int64 copySize = Math::Min(uncompressedSize - offsetInBlock, size - totalSize);
+
+                if (Pak->GetBlock(Entry, blockIndex).Method == ECompressionMethod::None || copySize == uncompressedSize)
+                {
+                    if (Pak->Read(Entry, dest + totalSize, copySize, PosInFile) != copySize)
+                    {
+                        return false;
+                    }
+                }
+                else
+                {
+                    // small reads inside one compressed block decode it once
+                    if (CachedBlock != blockIndex)
+                    {
+                        CachedData.Resize(static_cast<int32>(uncompressedSize));
+                        if (!Pak->ReadBlock(Entry, blockIndex, CachedData.Data()))
+                        {
+                            CachedBlock = -1;
+                            return false;
+                        }
+                        CachedBlock = blockIndex;
+                    }
+                    Memory::Memcpy(dest + totalSize, CachedData.Data() + offsetInBlock, static_cast<size_t>(copySize));
+                }
+                PosInFile += copySize;
+                totalSize += copySize;
+            }
+            return totalSize == size;
+        }
+
+        bool Write(const uint8*, int64) final
+        {
+            return false;
+        }
+
+        bool Seek(int64 offset, ESeekOrigin origin) final
+        {
+            int64 base = 0;
+            if (origin == ESeekOrigin::Current)
+            {
+                base = PosInFile;
+            }
+            else if (origin == ESeekOrigin::End)
+            {
+                base = Entry.Size;
+            }
+
+            if (base + offset < 0)
+            {
+                return false;
+            }
+            PosInFile = base + offset;
+            return true;
+        }
+
+        int64 Tell() const final
+        {
+            return PosInFile;
+        }
+
+        int64 ReadAt(uint8* dest, int64 size, int64 offset) final
+        {
+            return Pak->Read(Entry, dest, size, offset);
+        }
+
+        int64 WriteAt(const uint8*, int64, int64) final
+        {
+            return -1;
+        }
+
+        int64 ReadV(const FileReadVector* vectors, int32 count, int64 offset) final
+        {
+            int64 totalSize = 0;
+            for (int32 index = 0; index < count; ++index)
+            {
+                const int64 readBytes = Pak->Read(Entry, vectors[index].Dest, vectors[index].Size, offset + totalSize);
+                if (readBytes < 0)
+                {
+                    return -1;
+                }
+                totalSize += readBytes;
+                if (readBytes < vectors[index].Size)
+                {
+                    break;
+                }
+            }
+            return totalSize;
+        }
+
+        int64 WriteV(const FileWriteVector*, int32, int64) final
+        {
+            return -1;
+        }
+
+        bool Truncate(int64) final
+        {
+            return false;
+        }
+
+        bool Flush() final
+        {
+            return true;
+        }
+
+    private:
+        SharedPtr<PakFile> Pak;
+        PakEntry Entry;
+        int64 PosInFile{ 0 };
+        int32 CachedBlock{ -1 };
+        Array<uint8> CachedData;
+    };
+
+    /** compressed entry is decoded into memory to be mapped */
+    class PakMemoryMappedFileHandle final : public IMappedFileHandle
+    {
+    public:
+        explicit PakMemoryMappedFileHandle(Array64<uint8>&& data) : Data(MoveTemp(data)) {}
+
+        const uint8* GetData() const final
+        {
+            return Data.Data();
+        }
+
+        int64 GetSize() const final
+        {
+            return Data.Size();
+        }
+
+        void Advise(EMappedAccessHint hint, int64 offset, int64 size) final {}
+
+        void Prefetch(int64 offset, int64 size) final {}
+
+    private:
+        Array64<uint8> Data;
+    };
+
+    /** @return index of first '/' from start, -1 if not found */
+    static int32 FindSeparator(const String& path, int32 start)
+    {
+        for (int32 index = start; index < path.Length(); ++index)
+        {
+            if (path[index] == '/')
+            {
+                return index;
+            }
+        }
+        return -1;
+    }
+
+    PakPlatformFile::PakPlatformFile(UniquePtr<IPlatformFile> lowerLevel)
+        : LowerLevel(MoveTemp(lowerLevel))
+    {}
+
+    bool PakPlatformFile::Mount(const String& pakPath, const String& mountPoint)
+    {
+        SharedPtr<PakFile> pak = PakFile::Load(LowerLevel->OpenFile(pakPath, EFileAccess::Read, EFileShareMode::Read));
+        if (pak == nullptr)
+        {
+            LOG_ERROR(FileSystem, "Mount pak {0} failed", pakPath.Data());
+            return false;
+        }
+
+        MountedPak mounted;
+        mounted.PakPath = pakPath;
+        mounted.MountPoint = Path::Normalize(mountPoint);
+        if (!mounted.MountPoint.EndsWith('/'))
+        {
+            mounted.MountPoint.Append('/');
+        }
+
+        // every parent directory of entries is a directory in pak
+        for (int32 index = 0; index < pak->GetEntryNum(); ++index)
+        {
+            const String entryPath = pak->GetEntryPath(pak->GetEntry(index));
+            for (int32 pos = 0; pos < entryPath.Length(); ++pos)
+            {
+                if (entryPath[pos] == '/')
+                {
+                    mounted.DirHashes.Add(PakFile::HashPath(entryPath.Slices(0, pos)));
+                }
+            }
+        }
+        uint64* dirHashes = mounted.DirHashes.Data();
+        std::sort(dirHashes, dirHashes + mounted.DirHashes.Size());
+        mounted.DirHashes.Resize(static_cast<int32>(std::unique(dirHashes, dirHashes + mounted.DirHashes.Size()) - dirHashes));
+        mounted.Pak = MoveTemp(pak);
+
+        std::lock_guard lock(Mutex);
+        MountedPaks.Add(MoveTemp(mounted));
+        MountedNum.store(MountedPaks.Size(), std::memory_order_release);
+        LOG_INFO(FileSystem, "Mount pak {0} to {1}", pakPath.Data(), MountedPaks.Last().MountPoint.Data());
+        return true;
+    }
+
+    bool PakPlatformFile::Unmount(const String& pakPath)
+    {
+        std::lock_guard lock(Mutex);
+        for (int32 index = MountedPaks.Size() - 1; index >= 0; --index)
+        {
+            if (MountedPaks[index].PakPath == pakPath)
+            {
+                MountedPaks.RemoveAt(index);
+                MountedNum.store(MountedPaks.Size(), std::memory_order_release);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool PakPlatformFile::GetPathInPak(const MountedPak& mounted, const String& path, String& outPath)
+    {
+        String normalizedPath = Path::Normalize(path);
+        if (!normalizedPath.EndsWith('/'))
+        {
+            normalizedPath.Append('/');
+        }
+        if (!normalizedPath.StartsWith(mounted.MountPoint, CaseInsensitive))
+        {
+            return false;
+        }
+
+        outPath = normalizedPath.Slices(mounted.MountPoint.Length(), normalizedPath.Length() - mounted.MountPoint.Length());
+        if (!outPath.Empty())
+        {
+            outPath.Chop(1);
+        }
+        return true;
+    }
+
+    PakPlatformFile::FoundEntry PakPlatformFile::FindEntry(const String& path) const
+    {
+        String pathInPak;
+        for (int32 index = MountedPaks.Size() - 1; index >= 0; --index)
+        {
+            const MountedPak& mounted = MountedPaks[index];
+            if (!GetPathInPak(mounted, path, pathInPak) || pathInPak.Empty())
+            {
+                continue;
+            }
+
+            if (const PakEntry* entry = mounted.Pak->FindEntry(pathInPak))
+            {
+                return { &mounted, entry };
+            }
+        }
+        return {};
+    }
+
+    bool PakPlatformFile::MakeDir(const String& path)
+    {
+        return LowerLevel->MakeDir(path);
+    }
+
+    bool PakPlatformFile::RemoveDir(const String& path)
+    {
+        return LowerLevel->RemoveDir(path);
+    }
+
+    bool PakPlatformFile::MakeFile(const String& path)
+    {
+        return LowerLevel->MakeFile(path);
+    }
+
+    bool PakPlatformFile::RemoveFile(const String& path)
+    {
+        return LowerLevel->RemoveFile(path);
+    }
+
+    bool PakPlatformFile::MoveFile(const String& from, const String& to)
+    {
+        return LowerLevel->MoveFile(from, to);
+    }
+
+    bool PakPlatformFile::CopyFile(const String& from, const String& to)
+    {
+        if (MountedNum.load(std::memory_order_acquire) == 0)
+        {
+            return LowerLevel->CopyFile(from, to);
+        }
+
+        SharedPtr<PakFile> pak;
+        PakEntry entry;
+        {
+            std::shared_lock lock(Mutex);
+            FoundEntry found = FindEntry(from);
+            if (found.Entry == nullptr)
+            {
+                return LowerLevel->CopyFile(from, to);
+            }
+            pak = found.Mounted->Pak;
+            entry = *found.Entry;
+        }
+
+        // fail if destination exists, same as physical copy
+        if (FileExists(to))
+        {
+            return false;
+        }
+
+        UniquePtr<IFileHandle> dest = LowerLevel->OpenFile(to, EFileAccess::Write, EFileShareMode::None);
+        if (dest == nullptr)
+        {
+            return false;
+        }
+
+        Array<uint8> buffer;
+        buffer.Resize(static_cast<int32>(Math::Min(entry.Size, static_cast<int64>(1 << 20))));
+        for (int64 offset = 0; offset < entry.Size; offset += buffer.Size())
+        {
+            const int64 readBytes = pak->Read(entry, buffer.Data(), buffer.Size(), offset);
+            if (readBytes <= 0 || dest->WriteAt(buffer.Data(), readBytes, offset) != readBytes)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool PakPlatformFile::FileExists(const String& path)
+    {
+        if (MountedNum.load(std::memory_order_acquire) > 0)
+        {
+            std::shared_lock lock(Mutex);
+            if (FindEntry(path).Entry != nullptr)
+            {
+                return true;
+            }
+        }
+        return LowerLevel->FileExists(path);
+    }
+
+    bool PakPlatformFile::IsReadOnly(const String& filePath)
+    {
+        if (MountedNum.load(std::memory_order_acquire) > 0)
+        {
+            std::shared_lock lock(Mutex);
+            if (FindEntry(filePath).Entry != nullptr)
+            {
+                return true;
+            }
+        }
+        return LowerLevel->IsReadOnly(filePath);
+    }
+
+    int64 PakPlatformFile::FileSize(const String& filePath)
+    {
+        if (MountedNum.load(std::memory_order_acquire) > 0)
+        {
+            std::shared_lock lock(Mutex);
+            FoundEntry found = FindEntry(filePath);
+            if (found.Entry != nullptr)
+            {
+                return found.Entry->Size;
+            }
+        }
+        return LowerLevel->FileSize(filePath);
+    }
+
+    bool PakPlatformFile::DirExists(const String& path)
+    {
+        if (MountedNum.load(std::memory_order_acquire) > 0)
+        {
+            std::shared_lock lock(Mutex);
+            String pathInPak;
+            for (const MountedPak& mounted : MountedPaks)
+            {
+                if (!GetPathInPak(mounted, path, pathInPak))
+                {
+                    continue;
+                }
+
+                const uint64* dirHashes = mounted.DirHashes.Data();
+                if (pathInPak.Empty() || std::binary_search(dirHashes, dirHashes + mounted.DirHashes.Size(), PakFile::HashPath(pathInPak)))
+                {
+                    return true;
+                }
+            }
+        }
+        return LowerLevel->DirExists(path);
+    }
+
+    FileTime PakPlatformFile::GetFileTime(const String& path)
+    {
+        if (MountedNum.load(std::memory_order_acquire) > 0)
+        {
+            String pakPath;
+            {
+                std::shared_lock lock(Mutex);
+                FoundEntry found = FindEntry(path);
+                if (found.Entry != nullptr)
+                {
+                    pakPath = found.Mounted->PakPath;
+                }
+            }
+            // files in pak share time of pak
+            if (!pakPath.Empty())
+            {
+                return LowerLevel->GetFileTime(pakPath);
+            }
+        }
+        return LowerLevel->GetFileTime(path);
+    }
+
+    Array<String> PakPlatformFile::QueryFiles(const String& searchPath, const String& regexExpr, bool recursion)
+    {
+        if (MountedNum.load(std::memory_order_acquire) == 0)
+        {
+            return LowerLevel->QueryFiles(searchPath, regexExpr, recursion);
+        }
+
+        Array<String> ret;
+        Set<String> found;
+        const std::regex pattern(regexExpr.Data());
+        const auto addPath = [&](String&& path) {
+            if (!found.Contains(path))
+            {
+                found.Add(path);
+                ret.Add(MoveTemp(path));
+            }
+        };
+
+        {
+            std::shared_lock lock(Mutex);
+            String searchDir = Path::Normalize(searchPath);
+            if (!searchDir.EndsWith('/'))
+            {
+                searchDir.Append('/');
+            }
+
+            for (int32 index = MountedPaks.Size() - 1; index >= 0; --index)
+            {
+                const MountedPak& mounted = MountedPaks[index];
+                String dirInPak;
+                if (GetPathInPak(mounted, searchDir, dirInPak))
+                {
+                    if (!dirInPak.Empty())
+                    {
+                        dirInPak.Append('/');
+                    }
+                }
+                else if (!recursion || !mounted.MountPoint.StartsWith(searchDir, CaseInsensitive))
+                {
+                    // pak is neither mounted above nor below search path
+                    continue;
+                }
+
+                const PakFile& pak = *mounted.Pak;
+                for (int32 entryIndex = 0; entryIndex < pak.GetEntryNum(); ++entryIndex)
+                {
+                    const String entryPath = pak.GetEntryPath(pak.GetEntry(entryIndex));
+                    if (!dirInPak.Empty() && !entryPath.StartsWith(dirInPak, CaseInsensitive))
+                    {
+                        continue;
+                    }
+
+                    int32 nameStart = dirInPak.Length();
+                    for (int32 pos = nameStart; pos < entryPath.Length(); ++pos)
+                    {
+                        if (entryPath[pos] != '/')
+                        {
+                            continue;
+                        }
+                        if (!recursion)
+                        {
+                            nameStart = -1;
+                            break;
+                        }
+                        // directories between search path and file
+                        const String dirName = entryPath.Slices(nameStart, pos - nameStart);
+                        if (std::regex_match(dirName.Data(), pattern))
+                        {
+                            addPath(mounted.MountPoint + entryPath.Slices(0, pos));
+                        }
+                        nameStart = pos + 1;
+                    }
+
+                    if (nameStart >= 0 && std::regex_match(entryPath.Data() + nameStart, pattern))
+                    {
+                        addPath(mounted.MountPoint + entryPath);
+                    }
+                }
+            }
+        }
+
+        for (String& path : LowerLevel->QueryFiles(searchPath, regexExpr, recursion))
+        {
+            if (!found.Contains(Path::Normalize(path)))
+            {
+                ret.Add(MoveTemp(path));
+            }
+        }
+        return ret;
+    }
+
+    bool PakPlatformFile::IterateDirectory(const String& directory, const DirectoryVisitor& visitor)
+    {
+        if (MountedNum.load(std::memory_order_acquire) == 0)
+        {
+            return LowerLevel->IterateDirectory(directory, visitor);
+        }
+
+        String prefix = Path::Normalize(directory);
+        if (!prefix.EndsWith('/'))
+        {
+            prefix.Append('/');
+        }
+
+        // entries are collected under lock, visitor is free to use file system
+        Array<DirectoryEntry> pakEntries;
+        Set<String> names;
+        const auto addEntry = [&](const String& name, int64 size, bool isDirectory) {
+            if (!names.Contains(name))
+            {
+                names.Add(name);
+                FileStat status;
+                status.FileSize = size;
+                status.ReadOnly = true;
+                status.IsDirectory = isDirectory;
+                status.IsValid = true;
+                pakEntries.Add(DirectoryEntry(status, prefix + name));
+            }
+        };
+
+        {
+            std::shared_lock lock(Mutex);
+            for (int32 index = MountedPaks.Size() - 1; index >= 0; --index)
+            {
+                const MountedPak& mounted = MountedPaks[index];
+                String dirInPak;
+                if (!GetPathInPak(mounted, prefix, dirInPak))
+                {
+                    // mount point below directory shows up as a directory
+                    if (mounted.MountPoint.StartsWith(prefix, CaseInsensitive))
+                    {
+                        const int32 start = prefix.Length();
+                        const int32 end = FindSeparator(mounted.MountPoint, start);
+                        addEntry(mounted.MountPoint.Slices(start, end - start), 0, true);
+                    }
+                    continue;
+                }
+
+                if (!dirInPak.Empty())
+                {
+                    dirInPak.Append('/');
+                }
+
+                const PakFile& pak = *mounted.Pak;
+                for (int32 entryIndex = 0; entryIndex < pak.GetEntryNum(); ++entryIndex)
+                {
+                    const PakEntry& entry = pak.GetEntry(entryIndex);
+                    const String entryPath = pak.GetEntryPath(entry);
+                    if (!dirInPak.Empty() && !entryPath.StartsWith(dirInPak, CaseInsensitive))
+                    {
+                        continue;
+                    }
+
+                    const int32 start = dirInPak.Length();
+                    const int32 end = FindSeparator(entryPath, start);
+                    if (end < 0)
+                    {
+                        addEntry(entryPath.Slices(start, entryPath.Length() - start), entry.Size, false);
+                    }
+                    else
+                    {
+                        addEntry(entryPath.Slices(start, end - start), 0, true);
+                    }
+                }
+            }
+        }
+
+        for (const DirectoryEntry& entry : pakEntries)
+        {
+            if (!visitor(entry))
+            {
+                return true;
+            }
+        }
+
+        const bool lowerExists = LowerLevel->IterateDirectory(directory, [&](const DirectoryEntry& entry) {
+            // files in pak override physical ones
+            return names.Contains(Path::GetShortName(entry.GetPath())) || visitor(entry);
+        });
+        return lowerExists || !pakEntries.Empty();
+    }
+
+    UniquePtr<IFileHandle> PakPlatformFile::OpenFile(const String& fileName, EFileAccess access, EFileShareMode mode)
+    {
+        if (MountedNum.load(std::memory_order_acquire) > 0)
+        {
+            std::shared_lock lock(Mutex);
+            FoundEntry found = FindEntry(fileName);
+            if (found.Entry != nullptr)
+            {
+                if (access != EFileAccess::Read)
+                {
+                    LOG_ERROR(FileSystem, "File {0} in pak is read only", fileName.Data());
+                    return nullptr;
+                }
+                return MakeUnique<PakFileHandle>(found.Mounted->Pak, *found.Entry);
+            }
+        }
+        return LowerLevel->OpenFile(fileName, access, mode);
+    }
+
+    UniquePtr<IMappedFileHandle> PakPlatformFile::MapFile(const String& fileName, int64 offset, int64 length, EMappedAccessHint hint)
+    {
+        if (MountedNum.load(std::memory_order_acquire) == 0)
+        {
+            return LowerLevel->MapFile(fileName, offset, length, hint);
+        }
+
+        SharedPtr<PakFile> pak;
+        PakEntry entry;
+        String pakPath;
+        {
+            std::shared_lock lock(Mutex);
+            FoundEntry found = FindEntry(fileName);
+            if (found.Entry == nullptr)
+            {
+                return LowerLevel->MapFile(fileName, offset, length, hint);
+            }
+            pak = found.Mounted->Pak;
+            entry = *found.Entry;
+            pakPath = found.Mounted->PakPath;
+        }
+
+        if (offset < 0 || offset > entry.Size)
+        {
+            return nullptr;
+        }
+        length = length < 0 ? entry.Size - offset : Math::Min(length, entry.Size - offset);
+
+        // stored entry is mapped from pak directly, otherwise it's decoded into memory
+        const int64 mappableOffset = pak->GetMappableOffset(entry);
+        if (mappableOffset >= 0)
+        {
+            return LowerLevel->MapFile(pakPath, mappableOffset + offset, length, hint);
+        }
+
+        Array64<uint8> data;
+        data.Resize(length);
+        if (pak->Read(entry, data.Data(), length, offset) != length)
+        {
+            return nullptr;
+        }
+        return MakeUnique<PakMemoryMappedFileHandle>(MoveTemp(data));
+    }
+}
@@ -1,92 +1,323 @@
 //#include "precompiled_core.hpp"
 #include "file_system/path.hpp"
+#include "math/city_hash.hpp"
+#include "math/generic_math.hpp"
 
 namespace Engine
 {
     String Path::Combine(const String& dest, const String& part)
     {
-        String path = dest;
-        String normalizedPart = part;
+        const bool destEndsWithSeparator = dest.EndsWith('/') || dest.EndsWith('\\');
+        const bool partStartsWithSeparator = part.StartsWith('/') || part.StartsWith('\\');
+        // keep only one separator between dest and part
+        const int32 skip = destEndsWithSeparator && partStartsWithSeparator ? 1 : 0;
 
-        if (dest.EndsWith("/") || dest.EndsWith("\\"))
+        String path;
+        path.Reserve(dest.Length() + part.Length() + 2);
+        path.Append(dest);
+        if (!destEndsWithSeparator && !partStartsWithSeparator)
         {
-            if (part.StartsWith("/"))
-            {
-                normalizedPart.Remove(0, 1);
-            }
-            else if (part.StartsWith("\\"))
+            path.Append('/');
+        }
+        path.Append(StringView(part.Data() + skip, part.Length() - skip));
+        return path;
+    }
+
+    String Path::GetExtension(const String& path)
+    {
+        const StringView extension = PathView(path).GetExtension();
+        return String(extension.Data(), extension.Length());
+    }
+
+    String Path::RemoveExtension(const String& path)
+    {
+        const StringView extension = PathView(path).GetExtension();
+        return extension.Empty() ? path : path.Slices(0, path.Length() - extension.Length());
+    }
+
+    String Path::GetShortName(const String& path, bool withExtension)
+    {
+        const PathView view(path);
+        const StringView name = withExtension ? view.GetFileName() : view.GetStem();
+        return String(name.Data(), name.Length());
+    }
+
+    Array<String> Path::SplitPath(const String& path)
+    {
+        return path.SplitAny("/\\");
+    }
+
+    String Path::Normalize(const String& path)
+    {
+        String ret = path;
+        char* data = ret.Data();
+        for (int32 index = 0; index < ret.Length(); ++index)
+        {
+            if (data[index] == '\\')
             {
-                normalizedPart.Remove(0, 2);
+                data[index] = '/';
             }
         }
-        else
+
+        const int32 rootLength = PathView::GetRootLength(data, ret.Length());
+        int32 length = ret.Length();
+        while (length > rootLength && data[length - 1] == '/')
         {
-            if (!part.StartsWith("/") && !part.StartsWith("\\"))
+            --length;
+        }
+        ret.Truncate(length);
+        return ret;
+    }
+
+    PathView::PathView(StringView path)
+        : Str(path.Data())
+        , Len(path.Length())
+        , RootLen(GetRootLength(path.Data(), path.Length()))
+    {
+        NameStart = Len;
+        while (NameStart > RootLen && !IsSeparator(Str[NameStart - 1]))
+        {
+            --NameStart;
+        }
+
+        ExtensionStart = Len;
+        // a leading '.' belongs to stem, and a trailing '.' isn't an extension
+        for (int32 pos = Len - 1; pos > NameStart; --pos)
+        {
+            if (Str[pos] == '.')
             {
-                normalizedPart.Prepend("/");
+                if (pos < Len - 1)
+                {
+                    ExtensionStart = pos;
+                }
+                break;
             }
         }
+    }
 
-        path.Append(normalizedPart);
-        return path;
+    StringView PathView::GetParent() const
+    {
+        return StringView(Str, NameStart > RootLen ? NameStart - 1 : RootLen);
     }
 
-    String Path::GetExtension(const String& path)
+    bool PathView::HasExtension(StringView extension) const
     {
-        int32 pos;
-        if ((pos = path.LastIndexOf('.')) >= 0 && pos < path.Length() - 1)
+        const StringView mine = GetExtension();
+        const int32 skip = (!extension.Empty() && extension.Data()[0] == '.') ? 1 : 0;
+        if (mine.Empty())
         {
-            return path.Slices(pos, path.Length() - pos);
+            return extension.Length() == skip;
         }
-        return String();
+        return CharTraits<char>::Compare(mine.Data() + 1, mine.Length() - 1, extension.Data() + skip, extension.Length() - skip,
+                                         CaseInsensitive) == 0;
     }
 
-    String Path::RemoveExtension(const String& path)
+    bool PathView::Equals(const PathView& other, ECaseSensitivity cs) const
     {
-        int32 idx = path.LastIndexOf('.');
-        if (idx == 0)
+        if (Len != other.Len)
         {
-            return String();
+            return false;
         }
-        else if (idx > 0)
+
+        for (int32 index = 0; index < Len; ++index)
         {
-            return path.Slices(0, idx);
+            const char lhs = Str[index];
+            const char rhs = other.Str[index];
+            if (lhs == rhs || (IsSeparator(lhs) && IsSeparator(rhs)))
+            {
+                continue;
+            }
+            if (cs == CaseSensitive || CharTraits<char>::FoldCaseLatin1(lhs) != CharTraits<char>::FoldCaseLatin1(rhs))
+            {
+                return false;
+            }
         }
-        return path;
+        return true;
     }
 
-    String Path::GetShortName(const String& path, bool withExtension)
+    uint64 PathView::GetHash64() const
     {
-        String ret = path;
-        int32 idx = path.LastIndexOfAny("/\\");
-        if (idx > -1)
+        // fold into a stack buffer chunk by chunk, long paths are chained by seed
+        constexpr int32 CHUNK_SIZE = 256;
+        char folded[CHUNK_SIZE];
+        uint64 hash = 0;
+        for (int32 offset = 0; offset < Len || offset == 0; offset += CHUNK_SIZE)
         {
-            ret = ret.Slices(idx + 1, path.Length() - idx - 1);
+            const int32 size = Math::Min(CHUNK_SIZE, Len - offset);
+            for (int32 index = 0; index < size; ++index)
+            {
+                const char ch = Str[offset + index];
+                folded[index] = IsSeparator(ch) ? '/' : CharTraits<char>::FoldCaseLatin1(ch);
+            }
+            hash = offset == 0 ? CityHash::CityHash64(folded, size) : CityHash::CityHash64WithSeed(folded, size, hash);
         }
+        return hash;
+    }
 
-        if (!withExtension)
+    int32 PathView::GetRootLength(const char* path, int32 length)
+    {
+        if (length >= 2 && path[1] == ':' && CharTraits<char>::ToLowerLatin1(path[0]) >= 'a' && CharTraits<char>::ToLowerLatin1(path[0]) <= 'z')
         {
-            return RemoveExtension(ret);
+            return length >= 3 && IsSeparator(path[2]) ? 3 : 2;
         }
+        if (length >= 2 && IsSeparator(path[0]) && IsSeparator(path[1]))
+        {
+            return 2;
+        }
+        return length >= 1 && IsSeparator(path[0]) ? 1 : 0;
+    }
 
-        return ret;
+    PathBuilder::PathBuilder(int32 capacity)
+    {
+        Buffer.Reserve(capacity);
     }
 
-    Array<String> Path::SplitPath(const String& path)
+    PathBuilder::PathBuilder(StringView path, int32 capacity)
     {
-        return path.SplitAny("/\\");
+        Buffer.Reserve(Math::Max(capacity, path.Length()));
+        Reset(path);
     }
 
-    String Path::Normalize(const String& path)
+    PathBuilder& PathBuilder::Append(StringView part)
     {
-        String ret = path;
-        ret.Replace("\\", "/");
+        const int32 start = Buffer.Length();
+        if (!Buffer.Empty() && !Buffer.EndsWith('/'))
+        {
+            Buffer.Append('/');
+        }
+        Buffer.Append(part);
+        Buffer.Truncate(NormalizeInPlace(Buffer.Data(), Buffer.Length(), start));
+        return *this;
+    }
+
+    PathBuilder& PathBuilder::Concat(StringView text)
+    {
+        const PathView view = GetView();
+        const int32 nameStart = view.GetPath().Length() - view.GetFileName().Length();
+        // text may contain separators, so the whole file name is normalized again
+        const int32 start = nameStart > view.GetRoot().Length() ? nameStart - 1 : nameStart;
+        Buffer.Append(text);
+        Buffer.Truncate(NormalizeInPlace(Buffer.Data(), Buffer.Length(), start));
+        return *this;
+    }
+
+    PathBuilder& PathBuilder::ReplaceExtension(StringView extension)
+    {
+        const PathView view = GetView();
+        if (view.GetFileName().Empty())
+        {
+            return *this;
+        }
 
-        if (ret.EndsWith('/') && ret.EndsWith("//") && ret.EndsWith(":/"))
+        Buffer.Truncate(Buffer.Length() - view.GetExtension().Length());
+        if (!extension.Empty())
         {
-            ret.Remove(ret.Length() - 1, 1);
+            if (extension.Data()[0] != '.')
+            {
+                Buffer.Append('.');
+            }
+            Buffer.Append(extension);
         }
+        return *this;
+    }
+
+    PathBuilder& PathBuilder::RemoveFileName()
+    {
+        Buffer.Truncate(GetView().GetParent().Length());
+        return *this;
+    }
 
+    void PathBuilder::Reset(StringView path)
+    {
+        Buffer.Clear();
+        Buffer.Append(path);
+        Buffer.Truncate(NormalizeInPlace(Buffer.Data(), Buffer.Length()));
+    }
+
+    String PathBuilder::Release()
+    {
+        String ret = MoveTemp(Buffer);
+        Buffer.Clear();
         return ret;
     }
+
+    int32 PathBuilder::NormalizeInPlace(char* path, int32 length, int32 start)
+    {
+        if (start == 1 && path[0] == '.')
+        {
+            // "." is only a placeholder of empty relative path
+            start = 0;
+        }
+
+        int32 rootLength;
+        if (start == 0)
+        {
+            rootLength = PathView::GetRootLength(path, length);
+            for (int32 index = 0; index < rootLength; ++index)
+            {
+                path[index] = PathView::IsSeparator(path[index]) ? '/' : path[index];
+            }
+            start = rootLength;
+        }
+        else
+        {
+            rootLength = PathView::GetRootLength(path, start);
+        }
+
+        int32 write = start;
+        int32 read = start;
+        while (read < length)
+        {
+            while (read < length && PathView::IsSeparator(path[read]))
+            {
+                ++read;
+            }
+            const int32 partStart = read;
+            while (read < length && !PathView::IsSeparator(path[read]))
+            {
+                ++read;
+            }
+            const int32 partLength = read - partStart;
+
+            if (partLength == 0 || (partLength == 1 && path[partStart] == '.'))
+            {
+                continue;
+            }
+
+            if (partLength == 2 && path[partStart] == '.' && path[partStart + 1] == '.')
+            {
+                int32 lastStart = write;
+                while (lastStart > rootLength && path[lastStart - 1] != '/')
+                {
+                    --lastStart;
+                }
+                const bool lastIsParent = write - lastStart == 2 && path[lastStart] == '.' && path[lastStart + 1] == '.';
+                if (write > rootLength && !lastIsParent)
+                {
+                    write = lastStart > rootLength ? lastStart - 1 : rootLength;
+                    continue;
+                }
+                if (rootLength > 0)
+                {
+                    // nothing is above root
+                    continue;
+                }
+            }
+
+            if (write > rootLength)
+            {
+                path[write++] = '/';
+            }
+            for (int32 index = 0; index < partLength; ++index)
+            {
+                path[write++] = path[partStart + index];
+            }
+        }
+
+        if (write == 0 && length > 0)
+        {
+            path[write++] = '.';
+        }
+        return write;
+    }
 }
@@ -0,0 +1,282 @@
+#include <cstring>
+#include "foundation/compression.hpp"
+#include "math/generic_math.hpp"
+#include "math/limit.hpp"
+
+namespace Engine
+{
+    /**
+     * Implementation of lz4 block format, output can be decoded by any lz4 library and vice versa.
+     * https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md
+     */
+    namespace LZ4
+    {
+        constexpr int32 MIN_MATCH = 4;
+        /** last 5 bytes of block are always literals */
+        constexpr int32 LAST_LITERALS = 5;
+        /** last match must start at least 12 bytes before the end of block */
+        constexpr int32 MF_LIMIT = 12;
+        constexpr int32 MAX_OFFSET = 65535;
+        constexpr int32 HASH_BITS = 12;
+        constexpr int32 RUN_MASK = 15;
+
+        inline uint32 Read32(const uint8* ptr)
+        {
+            uint32 value;
+            std::memcpy(&value, ptr, sizeof(uint32));
+            return value;
+        }
+
+        inline uint32 Hash(uint32 sequence)
+        {
+            return (sequence * 2654435761U) >> (32 - HASH_BITS);
+        }
+
+        /** bytes needed to encode a length besides the token */
+        inline int64 LengthBytes(int64 length)
+        {
+            return length >= RUN_MASK ? (length - RUN_MASK) / 255 + 1 : 0;
+        }
+
+        inline uint8* WriteLength(uint8* op, int64 length)
+        {
+            length -= RUN_MASK;
+            while (length >= 255)
+            {
+                *op++ = 255;
+                length -= 255;
+            }
+            *op++ = static_cast<uint8>(length);
+            return op;
+        }
+
+        int64 Compress(uint8* dest, int64 destCapacity, const uint8* src, int64 srcSize)
+        {
+            const uint8* ip = src;
+            const uint8* anchor = src;
+            const uint8* const end = src + srcSize;
+            uint8* op = dest;
+            uint8* const destEnd = dest + destCapacity;
+
+            if (srcSize > MF_LIMIT)
+            {
+                const uint8* const mfLimit = end - MF_LIMIT;
+                const uint8* const matchLimit = end - LAST_LITERALS;
+
+                int32 table[1 << HASH_BITS];
+                std::memset(table, 0xFF, sizeof(table));
+
+                while (ip <= mfLimit)
+                {
+                    const uint32 sequence = Read32(ip);
+                    const uint32 hash = Hash(sequence);
+                    const int64 ref = table[hash];
+                    table[hash] = static_cast<int32>(ip - src);
+
+                    if (ref < 0 || (ip - src) - ref > MAX_OFFSET || Read32(src + ref) != sequence)
+                    {
+                        // skip faster through data which doesn't compress
+                        ip += 1 + ((ip - anchor) >> 6);
+                        continue;
+                    }
+
+                    const uint8* match = src + ref;
+                    while (ip > anchor && match > src && ip[-1] == match[-1])
+                    {
+                        --ip;
+                        --match;
+                    }
+
+                    const uint8* matchEnd = ip + MIN_MATCH;
+                    const uint8* matchRef = match + MIN_MATCH;
+                    while (matchEnd < matchLimit && *matchEnd == *matchRef)
+                    {
+                        ++matchEnd;
+                        ++matchRef;
+                    }
+
+                    const int64 literalLength = ip - anchor;
+                    const int64 matchLength = matchEnd - ip - MIN_MATCH;
+                    if (destEnd - op < 1 + LengthBytes(literalLength) + literalLength + 2 + LengthBytes(matchLength))
+                    {
+                        return -1;
+                    }
+
+                    uint8* token = op++;
+                    *token = static_cast<uint8>(Math::Min(literalLength, static_cast<int64>(RUN_MASK)) << 4);
+                    if (literalLength >= RUN_MASK)
+                    {
+                        op = WriteLength(op, literalLength);
+                    }
+                    std::memcpy(op, anchor, literalLength);
+                    op += literalLength;
+
+                    const int64 offset = ip - match;
+                    *op++ = static_cast<uint8>(offset & 0xFF);
+                    *op++ = static_cast<uint8>(offset >> 8);
+
+                    *token |= static_cast<uint8>(Math::Min(matchLength, static_cast<int64>(RUN_MASK)));
+                    if (matchLength >= RUN_MASK)
+                    {
+                        op = WriteLength(op, matchLength);
+                    }
+
+                    ip = matchEnd;
+                    anchor = ip;
+                }
+            }
+
+            const int64 literalLength = end - anchor;
+            if (destEnd - op < 1 + LengthBytes(literalLength) + literalLength)
+            {
+                return -1;
+            }
+
+            uint8* token = op++;
+            *token = static_cast<uint8>(Math::Min(literalLength, static_cast<int64>(RUN_MASK)) << 4);
+            if (literalLength >= RUN_MASK)
+            {
+                op = WriteLength(op, literalLength);
+            }
+            std::memcpy(op, anchor, literalLength);
+            op += literalLength;
+
+            return op - dest;
+        }
+
+        /** @return false if run of length bytes exceeds input */
+        inline bool ReadLength(const uint8*& ip, const uint8* end, int64& length)
+        {
+            uint8 value;
+            do
+            {
+                if (ip >= end)
+                {
+                    return false;
+                }
+                value = *ip++;
+                length += value;
+            } while (value == 255);
+            return true;
+        }
+
+        bool Decompress(uint8* dest, int64 destSize, const uint8* src, int64 srcSize)
+        {
+            const uint8* ip = src;
+            const uint8* const end = src + srcSize;
+            uint8* op = dest;
+            uint8* const destEnd = dest + destSize;
+
+            while (ip < end)
+            {
+                const uint8 token = *ip++;
+
+                int64 literalLength = token >> 4;
+                if (literalLength == RUN_MASK && !ReadLength(ip, end, literalLength))
+                {
+                    return false;
+                }
+                if (end - ip < literalLength || destEnd - op < literalLength)
+                {
+                    return false;
+                }
+                std::memcpy(op, ip, literalLength);
+                ip += literalLength;
+                op += literalLength;
+
+                // last sequence has literals only
+                if (ip == end)
+                {
+                    break;
+                }
+
+                if (end - ip < 2)
+                {
+                    return false;
+                }
+                const int64 offset = ip[0] | (ip[1] << 8);
+                ip += 2;
+                if (offset == 0 || offset > op - dest)
+                {
+                    return false;
+                }
+
+                int64 matchLength = token & RUN_MASK;
+                if (matchLength == RUN_MASK && !ReadLength(ip, end, matchLength))
+                {
+                    return false;
+                }
+                matchLength += MIN_MATCH;
+                if (destEnd - op < matchLength)
+                {
+                    return false;
+                }
+
+                // regions overlap when offset is less than length, which repeats the pattern
+                const uint8* match = op - offset;
+                if (offset >= matchLength)
+                {
+                    std::memcpy(op, match, matchLength);
+                    op += matchLength;
+                }
+                else
+                {
+                    for (int64 index = 0; index < matchLength; ++index)
+                    {
+                        *op++ = *match++;
+                    }
+                }
+            }
+
+            return op == destEnd;
+        }
+    }
+
+    int64 Compression::GetMaxCompressedSize(ECompressionMethod method, int64 srcSize)
+    {
+        switch (method)
+        {
+            case ECompressionMethod::LZ4:
+                return srcSize + srcSize / 255 + 16;
+            default:
+                return srcSize;
+        }
+    }
+
+    int64 Compression::Compress(ECompressionMethod method, uint8* dest, int64 destCapacity, const uint8* src, int64 srcSize)
+    {
+        switch (method)
+        {
+            case ECompressionMethod::LZ4:
+                // positions in hash table are 32 bits
+                if (srcSize > MAX_INT32)
+                {
+                    return -1;
+                }
+                return LZ4::Compress(dest, destCapacity, src, srcSize);
+            default:
+                if (destCapacity < srcSize)
+                {
+                    return -1;
+                }
+                std::memcpy(dest, src, srcSize);
+                return srcSize;
+        }
+    }
+
+    bool Compression::Decompress(ECompressionMethod method, uint8* dest, int64 destSize, const uint8* src, int64 srcSize)
+    {
+        switch (method)
+        {
+            case ECompressionMethod::LZ4:
+                return LZ4::Decompress(dest, destSize, src, srcSize);
+            default:
+                if (destSize != srcSize)
+                {
+                    return false;
+                }
+                std::memcpy(dest, src, srcSize);
+                return true;
+        }
+    }
+}
@@ -1,7 +1,10 @@
 #include "foundation/string_id.hpp"
+#include "stats/stats.hpp"
 
 namespace Engine
 {
+    static StatCounter GStatStringIDCreated("StringID.Created", "string ids made from text, each one looks up entry pool");
+
     StringID::StringID(const char* str)
     {
         MakeStringID(StringView(str));
@@ -31,6 +34,7 @@ namespace Engine
     {
         Number = StringIDHelper::SplitNumber(view);
         EntryID = StringEntryPool::Get().FindOrStore(view);
+        GStatStringIDCreated.Add();
     }
 
     String StringID::ToString() const
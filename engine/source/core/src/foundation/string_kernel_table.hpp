@@ -0,0 +1,29 @@
+#pragma once
+
+// std headers used by kernels are included here, before variants switch on wider instruction sets with target pragmas
+#include <bit>
+#include "global.hpp"
+
+namespace Engine
+{
+    /**
+     * Raw pointer kernels of StringKernels, variants only see uint8 and uint16 so they don't instantiate
+     * inline functions of engine headers with a wider instruction set
+     */
+    struct StringKernelTable
+    {
+        size_t (*Length8)(const uint8* str);
+        size_t (*Length16)(const uint16* str);
+        const uint8* (*Find8)(const uint8* first, size_t len, uint8 ch);
+        const uint16* (*Find16)(const uint16* first, size_t len, uint16 ch);
+        size_t (*Mismatch8)(const uint8* lhs, const uint8* rhs, size_t len);
+        size_t (*Mismatch16)(const uint16* lhs, const uint16* rhs, size_t len);
+    };
+
+    /** nullptr when variant isn't compiled for this platform, cpu support is checked by caller */
+    const StringKernelTable* GetSse2StringKernels();
+
+    const StringKernelTable* GetAvx2StringKernels();
+
+    const StringKernelTable* GetAvx512StringKernels();
+}
\ No newline at end of file
@@ -0,0 +1,121 @@
+#include "foundation/string_kernels.hpp"
+#include "foundation/string_kernel_table.hpp"
+#include <utility>
+
+namespace Engine
+{
+    namespace
+    {
+        template <typename T>
+        size_t ScalarLength(const T* str)
+        {
+            const T* cursor = str;
+            while (*cursor != 0)
+            {
+                ++cursor;
+            }
+            return cursor - str;
+        }
+
+        template <typename T>
+        const T* ScalarFind(const T* first, size_t len, T ch)
+        {
+            for (size_t index = 0; index < len; ++index)
+            {
+                if (first[index] == ch)
+                {
+                    return first + index;
+                }
+            }
+            return nullptr;
+        }
+
+        template <typename T>
+        size_t ScalarMismatch(const T* lhs, const T* rhs, size_t len)
+        {
+            for (size_t index = 0; index < len; ++index)
+            {
+                if (lhs[index] != rhs[index])
+                {
+                    return index;
+                }
+            }
+            return len;
+        }
+
+        const StringKernelTable GScalarStringKernels = {
+            &ScalarLength<uint8>,
+            &ScalarLength<uint16>,
+            &ScalarFind<uint8>,
+            &ScalarFind<uint16>,
+            &ScalarMismatch<uint8>,
+            &ScalarMismatch<uint16>,
+        };
+
+        struct SelectedStringKernels
+        {
+            const StringKernelTable* Kernels{ &GScalarStringKernels };
+            ESimdLevel Level{ ESimdLevel::Scalar };
+        };
+
+        SelectedStringKernels SelectStringKernels()
+        {
+            const ESimdLevel level = CpuFeatures::GetSimdLevel();
+            const std::pair<ESimdLevel, const StringKernelTable*> candidates[] = {
+                { ESimdLevel::Avx512, GetAvx512StringKernels() },
+                { ESimdLevel::Avx2, GetAvx2StringKernels() },
+                { ESimdLevel::Sse2, GetSse2StringKernels() },
+            };
+
+            for (const auto& [candidateLevel, kernels] : candidates)
+            {
+                if (kernels != nullptr && candidateLevel <= level)
+                {
+                    return { kernels, candidateLevel };
+                }
+            }
+            return {};
+        }
+
+        const SelectedStringKernels& GetStringKernels()
+        {
+            static const SelectedStringKernels selected = SelectStringKernels();
+            return selected;
+        }
+    }
+
+    size_t StringKernels::Length(const uint8* str)
+    {
+        return GetStringKernels().Kernels->Length8(str);
+    }
+
+    size_t StringKernels::Length(const uint16* str)
+    {
+        return GetStringKernels().Kernels->Length16(str);
+    }
+
+    const uint8* StringKernels::Find(const uint8* first, size_t len, uint8 ch)
+    {
+        return GetStringKernels().Kernels->Find8(first, len, ch);
+    }
+
+    const uint16* StringKernels::Find(const uint16* first, size_t len, uint16 ch)
+    {
+        return GetStringKernels().Kernels->Find16(first, len, ch);
+    }
+
+    size_t StringKernels::Mismatch(const uint8* lhs, const uint8* rhs, size_t len)
+    {
+        return GetStringKernels().Kernels->Mismatch8(lhs, rhs, len);
+    }
+
+    size_t StringKernels::Mismatch(const uint16* lhs, const uint16* rhs, size_t len)
+    {
+        return GetStringKernels().Kernels->Mismatch16(lhs, rhs, len);
+    }
+
+    ESimdLevel StringKernels::GetSimdLevel()
+    {
+        return GetStringKernels().Level;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,78 @@
+#include "foundation/string_kernel_table.hpp"
+
+#if SUPPORT_SSE2
+
+// everything after this point may use avx2, string kernels only call into it after checking cpu supports it
+#if defined(COMPILER_GNUC)
+#pragma GCC target("avx2")
+#elif defined(COMPILER_CLANG) || defined(COMPILER_APPLECLANG)
+#pragma clang attribute push (__attribute__((target("avx2"))), apply_to = function)
+#endif
+
+#include "foundation/string_kernels_simd.hpp"
+
+namespace Engine
+{
+    namespace
+    {
+        struct Avx2Lanes
+        {
+            using Reg = __m256i;
+            static constexpr size_t BYTES = 32;
+
+            static Reg Load(const void* data) { return _mm256_loadu_si256(static_cast<const __m256i*>(data)); }
+            static Reg LoadAligned(const void* data) { return _mm256_load_si256(static_cast<const __m256i*>(data)); }
+
+            template <typename T>
+            static Reg Set(T value)
+            {
+                if constexpr (sizeof(T) == 1)
+                {
+                    return _mm256_set1_epi8(static_cast<char>(value));
+                }
+                else
+                {
+                    return _mm256_set1_epi16(static_cast<short>(value));
+                }
+            }
+
+            template <typename T>
+            static uint64 EqualMask(Reg a, Reg b)
+            {
+                if constexpr (sizeof(T) == 1)
+                {
+                    return static_cast<uint32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)));
+                }
+                else
+                {
+                    // packs works per 128 bits lane, the permute puts both packed halves back in order
+                    const Reg equal = _mm256_cmpeq_epi16(a, b);
+                    const Reg packed = _mm256_permute4x64_epi64(_mm256_packs_epi16(equal, _mm256_setzero_si256()), 0xD8);
+                    return static_cast<uint32>(_mm256_movemask_epi8(packed)) & 0xFFFF;
+                }
+            }
+        };
+    }
+
+    const StringKernelTable* GetAvx2StringKernels()
+    {
+        static const StringKernelTable kernels = MakeStringKernelTable<Avx2Lanes>();
+        return &kernels;
+    }
+}
+
+#if defined(COMPILER_CLANG) || defined(COMPILER_APPLECLANG)
+#pragma clang attribute pop
+#endif
+
+#else
+
+namespace Engine
+{
+    const StringKernelTable* GetAvx2StringKernels()
+    {
+        return nullptr;
+    }
+}
+
+#endif
\ No newline at end of file
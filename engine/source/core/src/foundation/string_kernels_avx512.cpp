@@ -0,0 +1,75 @@
+#include "foundation/string_kernel_table.hpp"
+
+#if SUPPORT_SSE2
+
+// everything after this point may use avx512, string kernels only call into it after checking cpu supports it
+#if defined(COMPILER_GNUC)
+#pragma GCC target("avx512f,avx512bw")
+#elif defined(COMPILER_CLANG) || defined(COMPILER_APPLECLANG)
+#pragma clang attribute push (__attribute__((target("avx512f,avx512bw"))), apply_to = function)
+#endif
+
+#include "foundation/string_kernels_simd.hpp"
+
+namespace Engine
+{
+    namespace
+    {
+        struct Avx512Lanes
+        {
+            using Reg = __m512i;
+            static constexpr size_t BYTES = 64;
+
+            static Reg Load(const void* data) { return _mm512_loadu_si512(data); }
+            static Reg LoadAligned(const void* data) { return _mm512_load_si512(data); }
+
+            template <typename T>
+            static Reg Set(T value)
+            {
+                if constexpr (sizeof(T) == 1)
+                {
+                    return _mm512_set1_epi8(static_cast<char>(value));
+                }
+                else
+                {
+                    return _mm512_set1_epi16(static_cast<short>(value));
+                }
+            }
+
+            template <typename T>
+            static uint64 EqualMask(Reg a, Reg b)
+            {
+                if constexpr (sizeof(T) == 1)
+                {
+                    return _mm512_cmpeq_epi8_mask(a, b);
+                }
+                else
+                {
+                    return _mm512_cmpeq_epi16_mask(a, b);
+                }
+            }
+        };
+    }
+
+    const StringKernelTable* GetAvx512StringKernels()
+    {
+        static const StringKernelTable kernels = MakeStringKernelTable<Avx512Lanes>();
+        return &kernels;
+    }
+}
+
+#if defined(COMPILER_CLANG) || defined(COMPILER_APPLECLANG)
+#pragma clang attribute pop
+#endif
+
+#else
+
+namespace Engine
+{
+    const StringKernelTable* GetAvx512StringKernels()
+    {
+        return nullptr;
+    }
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <immintrin.h>
+#include "foundation/string_kernel_table.hpp"
+
+#if defined(COMPILER_MSVC)
+#define STRING_KERNEL_NO_SANITIZE_ADDRESS __declspec(no_sanitize_address)
+#else
+#define STRING_KERNEL_NO_SANITIZE_ADDRESS __attribute__((no_sanitize_address))
+#endif
+
+/**
+ * Kernels shared by sse2, avx2 and avx512 variants, written once against a lanes type which provides Reg, BYTES
+ * and static Load, LoadAligned, Set<T>, EqualMask<T> (one bit per unit of type T).
+ * Anonymous namespace on purpose, see math_stream_simd.hpp.
+ */
+namespace Engine
+{
+    namespace
+    {
+        template <typename L, typename T>
+        constexpr size_t UNITS_PER_REGISTER = L::BYTES / sizeof(T);
+
+        template <typename L, typename T>
+        constexpr uint64 FULL_MASK = UNITS_PER_REGISTER<L, T> == 64 ? ~static_cast<uint64>(0) : (static_cast<uint64>(1) << UNITS_PER_REGISTER<L, T>) - 1;
+
+        /**
+         * Loads are aligned to the register after a scalar prologue, an aligned load never crosses a page,
+         * so reading past the terminator can't fault. Address sanitizer doesn't know that.
+         */
+        template <typename L, typename T>
+        STRING_KERNEL_NO_SANITIZE_ADDRESS size_t LengthKernel(const T* str)
+        {
+            const T* cursor = str;
+            if (reinterpret_cast<uintptr>(str) % sizeof(T) != 0)
+            {
+                while (*cursor != 0)
+                {
+                    ++cursor;
+                }
+                return cursor - str;
+            }
+
+            for (; reinterpret_cast<uintptr>(cursor) % L::BYTES != 0; ++cursor)
+            {
+                if (*cursor == 0)
+                {
+                    return cursor - str;
+                }
+            }
+
+            const typename L::Reg zero = L::template Set<T>(0);
+            for (;; cursor += UNITS_PER_REGISTER<L, T>)
+            {
+                const uint64 mask = L::template EqualMask<T>(L::LoadAligned(cursor), zero);
+                if (mask != 0)
+                {
+                    return (cursor - str) + std::countr_zero(mask);
+                }
+            }
+        }
+
+        template <typename L, typename T>
+        const T* FindKernel(const T* first, size_t len, T ch)
+        {
+            const typename L::Reg value = L::template Set<T>(ch);
+            size_t index = 0;
+            for (; index + UNITS_PER_REGISTER<L, T> <= len; index += UNITS_PER_REGISTER<L, T>)
+            {
+                const uint64 mask = L::template EqualMask<T>(L::Load(first + index), value);
+                if (mask != 0)
+                {
+                    return first + index + std::countr_zero(mask);
+                }
+            }
+
+            for (; index < len; ++index)
+            {
+                if (first[index] == ch)
+                {
+                    return first + index;
+                }
+            }
+            return nullptr;
+        }
+
+        template <typename L, typename T>
+        size_t MismatchKernel(const T* lhs, const T* rhs, size_t len)
+        {
+            size_t index = 0;
+            for (; index + UNITS_PER_REGISTER<L, T> <= len; index += UNITS_PER_REGISTER<L, T>)
+            {
+                const uint64 different = ~L::template EqualMask<T>(L::Load(lhs + index), L::Load(rhs + index)) & FULL_MASK<L, T>;
+                if (different != 0)
+                {
+                    return index + std::countr_zero(different);
+                }
+            }
+
+            for (; index < len; ++index)
+            {
+                if (lhs[index] != rhs[index])
+                {
+                    return index;
+                }
+            }
+            return len;
+        }
+
+        template <typename L>
+        StringKernelTable MakeStringKernelTable()
+        {
+            return {
+                &LengthKernel<L, uint8>,
+                &LengthKernel<L, uint16>,
+                &FindKernel<L, uint8>,
+                &FindKernel<L, uint16>,
+                &MismatchKernel<L, uint8>,
+                &MismatchKernel<L, uint16>,
+            };
+        }
+    }
+}
\ No newline at end of file
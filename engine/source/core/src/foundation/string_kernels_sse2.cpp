@@ -0,0 +1,66 @@
+#include "foundation/string_kernel_table.hpp"
+
+#if SUPPORT_SSE2
+
+#include "foundation/string_kernels_simd.hpp"
+
+namespace Engine
+{
+    namespace
+    {
+        struct Sse2Lanes
+        {
+            using Reg = __m128i;
+            static constexpr size_t BYTES = 16;
+
+            static Reg Load(const void* data) { return _mm_loadu_si128(static_cast<const __m128i*>(data)); }
+            static Reg LoadAligned(const void* data) { return _mm_load_si128(static_cast<const __m128i*>(data)); }
+
+            template <typename T>
+            static Reg Set(T value)
+            {
+                if constexpr (sizeof(T) == 1)
+                {
+                    return _mm_set1_epi8(static_cast<char>(value));
+                }
+                else
+                {
+                    return _mm_set1_epi16(static_cast<short>(value));
+                }
+            }
+
+            template <typename T>
+            static uint64 EqualMask(Reg a, Reg b)
+            {
+                if constexpr (sizeof(T) == 1)
+                {
+                    return static_cast<uint32>(_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)));
+                }
+                else
+                {
+                    // lanes are all ones or zero, signed saturation keeps them that way in one byte
+                    const Reg equal = _mm_cmpeq_epi16(a, b);
+                    return static_cast<uint32>(_mm_movemask_epi8(_mm_packs_epi16(equal, _mm_setzero_si128()))) & 0xFF;
+                }
+            }
+        };
+    }
+
+    const StringKernelTable* GetSse2StringKernels()
+    {
+        static const StringKernelTable kernels = MakeStringKernelTable<Sse2Lanes>();
+        return &kernels;
+    }
+}
+
+#else
+
+namespace Engine
+{
+    const StringKernelTable* GetSse2StringKernels()
+    {
+        return nullptr;
+    }
+}
+
+#endif
\ No newline at end of file
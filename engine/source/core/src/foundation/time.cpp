@@ -1,3 +1,144 @@
-//
-// Created by Shinonome on 2022/8/14.
-//
+#include "foundation/time.hpp"
+
+#if defined(_M_X64) || defined(__x86_64__)
+    #define CLOCK_USE_TSC 1
+    #if defined(COMPILER_MSVC)
+        #include <intrin.h>
+    #else
+        #include <cpuid.h>
+        #include <x86intrin.h>
+    #endif
+#else
+    #define CLOCK_USE_TSC 0
+#endif
+
+namespace Engine
+{
+    namespace
+    {
+        constexpr int64 CALIBRATION_NANOSECONDS = 5'000'000;
+
+        struct ClockCalibration
+        {
+            bool UseTsc{ false };
+            /** nanoseconds per cycle in 32.32 fixed point, integer and fraction */
+            uint64 NanosecondsPerCycle{ 1 };
+            uint64 NanosecondsPerCycleFraction{ 0 };
+            double CyclesPerSecond{ 1e9 };
+        };
+
+        int64 SteadyNanoseconds()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+#if CLOCK_USE_TSC
+        int64 ReadTsc()
+        {
+            return static_cast<int64>(__rdtsc());
+        }
+
+        /** counter of an invariant tsc runs at constant rate in all power states and is synchronized across cores */
+        bool IsTscInvariant()
+        {
+#if defined(COMPILER_MSVC)
+            int32 regs[4];
+            __cpuid(regs, 0x80000000);
+            if (static_cast<uint32>(regs[0]) < 0x80000007)
+            {
+                return false;
+            }
+            __cpuid(regs, 0x80000007);
+            return (regs[3] & (1 << 8)) != 0;
+#else
+            uint32 eax, ebx, ecx, edx;
+            return __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) != 0 && (edx & (1u << 8)) != 0;
+#endif
+        }
+#endif
+
+        ClockCalibration Calibrate()
+        {
+            ClockCalibration calibration;
+#if CLOCK_USE_TSC
+            if (!IsTscInvariant())
+            {
+                return calibration;
+            }
+
+            // busy wait a few milliseconds, it only happens once per process
+            const int64 steadyBegin = SteadyNanoseconds();
+            const int64 tscBegin = ReadTsc();
+            int64 steadyEnd;
+            do
+            {
+                steadyEnd = SteadyNanoseconds();
+            }
+            while (steadyEnd - steadyBegin < CALIBRATION_NANOSECONDS);
+            const int64 tscEnd = ReadTsc();
+
+            const double nanosecondsPerCycle = static_cast<double>(steadyEnd - steadyBegin) / static_cast<double>(tscEnd - tscBegin);
+            if (tscEnd > tscBegin && nanosecondsPerCycle < 1e3)
+            {
+                calibration.UseTsc = true;
+                const uint64 fixed = static_cast<uint64>(nanosecondsPerCycle * 4294967296.0 + 0.5);
+                calibration.NanosecondsPerCycle = fixed >> 32;
+                calibration.NanosecondsPerCycleFraction = fixed & 0xFFFFFFFFull;
+                calibration.CyclesPerSecond = 1e9 / nanosecondsPerCycle;
+            }
+#endif
+            return calibration;
+        }
+
+        const ClockCalibration& GetCalibration()
+        {
+            static const ClockCalibration calibration = Calibrate();
+            return calibration;
+        }
+    }
+
+    int64 HighResolutionClock::Now()
+    {
+        return CyclesToNanoseconds(Cycles());
+    }
+
+    int64 HighResolutionClock::Cycles()
+    {
+#if CLOCK_USE_TSC
+        if (GetCalibration().UseTsc)
+        {
+            return ReadTsc();
+        }
+#endif
+        return SteadyNanoseconds();
+    }
+
+    int64 HighResolutionClock::CyclesToNanoseconds(int64 cycles)
+    {
+        if (cycles < 0)
+        {
+            return -CyclesToNanoseconds(-cycles);
+        }
+        // split to 32 bits halves so fixed point product doesn't overflow without 128 bits integer
+        const ClockCalibration& calibration = GetCalibration();
+        const uint64 value = static_cast<uint64>(cycles);
+        const uint64 fraction = calibration.NanosecondsPerCycleFraction;
+        return static_cast<int64>(value * calibration.NanosecondsPerCycle + (value >> 32) * fraction +
+                                  (((value & 0xFFFFFFFFull) * fraction) >> 32));
+    }
+
+    double HighResolutionClock::CyclesToSeconds(int64 cycles)
+    {
+        return static_cast<double>(cycles) / GetCalibration().CyclesPerSecond;
+    }
+
+    double HighResolutionClock::GetCyclesPerSecond()
+    {
+        return GetCalibration().CyclesPerSecond;
+    }
+
+    bool HighResolutionClock::IsUsingTsc()
+    {
+        return GetCalibration().UseTsc;
+    }
+}
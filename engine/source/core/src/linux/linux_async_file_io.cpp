@@ -0,0 +1,533 @@
+#include "file_system/async_file_io.hpp"
+#if PLATFORM_LINUX
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "log/logger.hpp"
+#include "math/generic_math.hpp"
+#include "file_system/async_io_backend.hpp"
+#include "file_system/file_system_log.hpp"
+#include "profiler/profiler.hpp"
+
+namespace Engine
+{
+    AsyncReadFile::~AsyncReadFile()
+    {
+        ::close(static_cast<int32>(NativeHandle));
+    }
+
+    SharedPtr<AsyncReadFile> AsyncFileIO::OpenFile(const String& filePath)
+    {
+        const int32 fd = ::open(filePath.Data(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            LOG_ERROR(FileSystem, "Open file {0} for async reading failed, error code: {1:d}", filePath.Data(), errno);
+            return nullptr;
+        }
+
+        struct stat fileStat;
+        if (::fstat(fd, &fileStat) != 0)
+        {
+            LOG_ERROR(FileSystem, "Stat file {0} failed, error code: {1:d}", filePath.Data(), errno);
+            ::close(fd);
+            return nullptr;
+        }
+        return MakeShared<AsyncReadFile>(static_cast<intptr>(fd), static_cast<int64>(fileStat.st_size));
+    }
+
+    int64 AsyncFileIO::ReadAt(intptr nativeHandle, uint8* dest, int64 offset, int64 size)
+    {
+        const int32 fd = static_cast<int32>(nativeHandle);
+        int64 totalSize = 0;
+        while (totalSize < size)
+        {
+            const ssize_t readBytes = ::pread(fd, dest + totalSize, static_cast<size_t>(size - totalSize), offset + totalSize);
+            if (readBytes < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                LOG_ERROR(FileSystem, "Async read file meet error, error code: {0:d}", errno);
+                return -1;
+            }
+
+            if (readBytes == 0)
+            {
+                break;
+            }
+            totalSize += readBytes;
+        }
+        return totalSize;
+    }
+
+    /**
+     * Single thread drives an io_uring: it moves pending requests into submission queue by priority,
+     * then sleeps in io_uring_enter until any read completes. A read of an eventfd is always kept in flight,
+     * so that Submit can wake the thread up while it's waiting for completions.
+     */
+    class IoUringAsyncIOBackend final : public IAsyncIOBackend
+    {
+    public:
+        static UniquePtr<IAsyncIOBackend> Create(uint32 queueDepth)
+        {
+            UniquePtr<IoUringAsyncIOBackend> backend(new IoUringAsyncIOBackend());
+            if (!backend->Setup(queueDepth))
+            {
+                return nullptr;
+            }
+            backend->Thread = std::thread(&IoUringAsyncIOBackend::Run, backend.get());
+            return backend;
+        }
+
+        ~IoUringAsyncIOBackend() final
+        {
+            if (Thread.joinable())
+            {
+                {
+                    std::scoped_lock lock(Mutex);
+                    Stopping = true;
+                }
+                WakeUp();
+                Thread.join();
+            }
+
+            while (AsyncReadRequestPtr request = PendingRequests.Pop())
+            {
+                request->Cancel();
+            }
+
+            CloseRing();
+            if (WakeUpFd >= 0)
+            {
+                ::close(WakeUpFd);
+            }
+        }
+
+        void Submit(const AsyncReadRequestPtr* requests, int32 count) final
+        {
+            bool broken;
+            {
+                std::scoped_lock lock(Mutex);
+                broken = Broken;
+                for (int32 index = 0; !broken && index < count; ++index)
+                {
+                    PendingRequests.Push(requests[index]);
+                }
+            }
+
+            if (broken)
+            {
+                // completion callbacks may submit again, never run them under lock
+                for (int32 index = 0; index < count; ++index)
+                {
+                    FailRequest(requests[index]);
+                }
+                return;
+            }
+            WakeUp();
+        }
+
+        const char* GetName() const final { return "IoUring"; }
+
+    private:
+        struct InflightRead
+        {
+            AsyncReadRequestPtr Request;
+            int64 BytesRead{ 0 };
+        };
+
+        static constexpr uint64 WAKE_UP_USER_DATA = ~0ull;
+
+        static constexpr uint64 CANCEL_USER_DATA = ~0ull - 1;
+
+        /** a single read is split so that its length fits in sqe */
+        static constexpr int64 MAX_READ_CHUNK = 1ll << 30;
+
+        IoUringAsyncIOBackend() = default;
+
+        bool Setup(uint32 queueDepth)
+        {
+            io_uring_params params;
+            std::memset(&params, 0, sizeof(params));
+            RingFd = static_cast<int32>(::syscall(__NR_io_uring_setup, queueDepth, &params));
+            if (RingFd < 0)
+            {
+                LOG_WARN(FileSystem, "io_uring is unavailable, error code: {0:d}", errno);
+                return false;
+            }
+
+            // IORING_OP_READ comes with the same kernel version as this feature
+            if ((params.features & IORING_FEAT_SINGLE_MMAP) == 0 || (params.features & IORING_FEAT_RW_CUR_POS) == 0)
+            {
+                LOG_WARN(FileSystem, "io_uring of current kernel is too old");
+                return false;
+            }
+
+            // submission and completion rings share one mapping
+            RingSize = Math::Max(params.sq_off.array + params.sq_entries * sizeof(uint32),
+                                 params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+            SqeSize = params.sq_entries * sizeof(io_uring_sqe);
+
+            void* ring = ::mmap(nullptr, RingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, RingFd, IORING_OFF_SQ_RING);
+            void* sqes = ::mmap(nullptr, SqeSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, RingFd, IORING_OFF_SQES);
+            SqRing = ring != MAP_FAILED ? static_cast<uint8*>(ring) : nullptr;
+            CqRing = SqRing;
+            Sqes = sqes != MAP_FAILED ? static_cast<io_uring_sqe*>(sqes) : nullptr;
+            if (SqRing == nullptr || Sqes == nullptr)
+            {
+                LOG_WARN(FileSystem, "Map io_uring failed, error code: {0:d}", errno);
+                return false;
+            }
+
+            SqHead = reinterpret_cast<uint32*>(SqRing + params.sq_off.head);
+            SqTail = reinterpret_cast<uint32*>(SqRing + params.sq_off.tail);
+            SqEntries = params.sq_entries;
+            SqMask = *reinterpret_cast<uint32*>(SqRing + params.sq_off.ring_mask);
+            SqArray = reinterpret_cast<uint32*>(SqRing + params.sq_off.array);
+            CqHead = reinterpret_cast<uint32*>(CqRing + params.cq_off.head);
+            CqTail = reinterpret_cast<uint32*>(CqRing + params.cq_off.tail);
+            CqMask = *reinterpret_cast<uint32*>(CqRing + params.cq_off.ring_mask);
+            Cqes = reinterpret_cast<io_uring_cqe*>(CqRing + params.cq_off.cqes);
+            LocalSqTail = *SqTail;
+
+            WakeUpFd = ::eventfd(0, EFD_CLOEXEC);
+            if (WakeUpFd < 0)
+            {
+                LOG_WARN(FileSystem, "Create eventfd for io_uring failed, error code: {0:d}", errno);
+                return false;
+            }
+
+            // one entry is reserved by wake up read, every read owns at most one entry so submission queue never overflows
+            const int32 slotNum = static_cast<int32>(params.sq_entries) - 1;
+            Slots.Resize(slotNum);
+            FreeSlots.Reserve(slotNum);
+            for (int32 index = slotNum - 1; index >= 0; --index)
+            {
+                FreeSlots.Add(index);
+            }
+            return true;
+        }
+
+        void WakeUp()
+        {
+            const uint64 value = 1;
+            CLOG(::write(WakeUpFd, &value, sizeof(value)) < 0, FileSystem, Error, "Wake up io_uring thread failed");
+        }
+
+        void Run()
+        {
+            MEMORY_TAG_SCOPE(FileSystem);
+            QueueWakeUpRead();
+            while (true)
+            {
+                bool stopping;
+                // finished outside the lock, completion callback may submit a follow-up read
+                Array<AsyncReadRequestPtr> emptyRequests;
+                {
+                    PROFILE_SCOPE("IoUringAsyncIOBackend::Submit");
+                    std::scoped_lock lock(Mutex);
+                    stopping = Stopping;
+                    while (!stopping && FreeSlots.Size() > 0 && !PendingRequests.Empty())
+                    {
+                        AsyncReadRequestPtr request = PendingRequests.Pop();
+                        if (!request->TryStart())
+                        {
+                            continue;
+                        }
+
+                        if (request->GetSize() == 0)
+                        {
+                            emptyRequests.Add(MoveTemp(request));
+                            continue;
+                        }
+
+                        const int32 slot = FreeSlots.Pop();
+                        Slots[slot].Request = MoveTemp(request);
+                        Slots[slot].BytesRead = 0;
+                        QueueRead(slot);
+                        ++InflightNum;
+                    }
+                }
+
+                for (const AsyncReadRequestPtr& request : emptyRequests)
+                {
+                    request->Finish(0, true);
+                }
+
+                if (stopping && InflightNum == 0)
+                {
+                    break;
+                }
+
+                const int32 ret = static_cast<int32>(::syscall(__NR_io_uring_enter, RingFd, ToSubmit, 1, IORING_ENTER_GETEVENTS, nullptr, 0));
+                if (ret < 0 && errno != EINTR && errno != EBUSY)
+                {
+                    // retrying a persistent error only spins, give up the ring and fail every outstanding read
+                    LOG_ERROR(FileSystem, "io_uring_enter failed, error code: {0:d}", errno);
+                    Shutdown();
+                    break;
+                }
+                ToSubmit -= ret > 0 ? static_cast<uint32>(ret) : 0;
+
+                PROFILE_SCOPE("IoUringAsyncIOBackend::ReapCompletions");
+                ReapCompletions();
+            }
+        }
+
+        void Shutdown()
+        {
+            // kernel keeps writing into buffers of submitted reads, they can't be finished before it gives them back
+            if (!CancelInflightReads())
+            {
+                LOG_ERROR(FileSystem, "Cancel io_uring reads failed, error code: {0:d}", errno);
+                // closing the ring makes kernel cancel what's left of it
+                CloseRing();
+            }
+
+            for (InflightRead& read : Slots)
+            {
+                if (read.Request)
+                {
+                    AsyncReadRequestPtr request = MoveTemp(read.Request);
+                    request->Finish(read.BytesRead, false);
+                }
+            }
+            InflightNum = 0;
+
+            Array<AsyncReadRequestPtr> pendingRequests;
+            {
+                std::scoped_lock lock(Mutex);
+                Broken = true;
+                while (AsyncReadRequestPtr request = PendingRequests.Pop())
+                {
+                    pendingRequests.Add(MoveTemp(request));
+                }
+            }
+            for (const AsyncReadRequestPtr& request : pendingRequests)
+            {
+                FailRequest(request);
+            }
+        }
+
+        /**
+         * Cancel every read in flight and reap completions until all of them are back.
+         * @return false if ring fails again, reads may still be owned by kernel
+         */
+        bool CancelInflightReads()
+        {
+            Cancelling = true;
+            int32 nextSlot = 0;
+            while (InflightNum > 0)
+            {
+                // cancel entries take free room of submission queue, reads which aren't submitted yet just complete
+                const uint32 sqHead = std::atomic_ref<uint32>(*SqHead).load(std::memory_order_acquire);
+                while (nextSlot < Slots.Size() && LocalSqTail - sqHead < SqEntries)
+                {
+                    if (Slots[nextSlot].Request)
+                    {
+                        QueueCancel(nextSlot);
+                    }
+                    ++nextSlot;
+                }
+
+                const int32 ret = static_cast<int32>(::syscall(__NR_io_uring_enter, RingFd, ToSubmit, 1, IORING_ENTER_GETEVENTS, nullptr, 0));
+                if (ret < 0 && errno != EINTR && errno != EBUSY)
+                {
+                    return false;
+                }
+                ToSubmit -= ret > 0 ? static_cast<uint32>(ret) : 0;
+                ReapCompletions();
+            }
+            return true;
+        }
+
+        void CloseRing()
+        {
+            if (Sqes != nullptr)
+            {
+                ::munmap(Sqes, SqeSize);
+                Sqes = nullptr;
+            }
+            if (SqRing != nullptr)
+            {
+                ::munmap(SqRing, RingSize);
+                SqRing = nullptr;
+                CqRing = nullptr;
+            }
+            if (RingFd >= 0)
+            {
+                ::close(RingFd);
+                RingFd = -1;
+            }
+        }
+
+        static void FailRequest(const AsyncReadRequestPtr& request)
+        {
+            if (request->TryStart())
+            {
+                request->Finish(0, false);
+            }
+        }
+
+        io_uring_sqe* AcquireSqe()
+        {
+            const uint32 index = LocalSqTail & SqMask;
+            io_uring_sqe* sqe = &Sqes[index];
+            std::memset(sqe, 0, sizeof(io_uring_sqe));
+            SqArray[index] = index;
+            return sqe;
+        }
+
+        void CommitSqe()
+        {
+            ++LocalSqTail;
+            ++ToSubmit;
+            std::atomic_ref<uint32>(*SqTail).store(LocalSqTail, std::memory_order_release);
+        }
+
+        void QueueWakeUpRead()
+        {
+            io_uring_sqe* sqe = AcquireSqe();
+            sqe->opcode = IORING_OP_READ;
+            sqe->fd = WakeUpFd;
+            sqe->addr = reinterpret_cast<uint64>(&WakeUpValue);
+            sqe->len = sizeof(WakeUpValue);
+            sqe->user_data = WAKE_UP_USER_DATA;
+            CommitSqe();
+        }
+
+        void QueueRead(int32 slot)
+        {
+            InflightRead& read = Slots[slot];
+            AsyncReadRequest& request = *read.Request;
+
+            io_uring_sqe* sqe = AcquireSqe();
+            sqe->opcode = IORING_OP_READ;
+            sqe->fd = static_cast<int32>(request.GetFile()->GetNativeHandle());
+            sqe->off = static_cast<uint64>(request.GetOffset() + read.BytesRead);
+            sqe->addr = reinterpret_cast<uint64>(request.GetData() + read.BytesRead);
+            sqe->len = static_cast<uint32>(Math::Min(request.GetSize() - read.BytesRead, MAX_READ_CHUNK));
+            sqe->user_data = static_cast<uint64>(slot);
+            CommitSqe();
+        }
+
+        void QueueCancel(int32 slot)
+        {
+            io_uring_sqe* sqe = AcquireSqe();
+            sqe->opcode = IORING_OP_ASYNC_CANCEL;
+            sqe->fd = -1;
+            sqe->addr = static_cast<uint64>(slot);
+            sqe->user_data = CANCEL_USER_DATA;
+            CommitSqe();
+        }
+
+        void ReapCompletions()
+        {
+            uint32 head = *CqHead;
+            const uint32 tail = std::atomic_ref<uint32>(*CqTail).load(std::memory_order_acquire);
+            while (head != tail)
+            {
+                const io_uring_cqe& cqe = Cqes[head & CqMask];
+                const uint64 userData = cqe.user_data;
+                int32 result = cqe.res;
+                ++head;
+
+                if (userData == WAKE_UP_USER_DATA)
+                {
+                    if (!Cancelling)
+                    {
+                        QueueWakeUpRead();
+                    }
+                    continue;
+                }
+
+                // result of a cancel only tells whether target read was found, the read completes on its own
+                if (userData == CANCEL_USER_DATA)
+                {
+                    continue;
+                }
+
+                const int32 slot = static_cast<int32>(userData);
+                InflightRead& read = Slots[slot];
+                if (!Cancelling && (result == -EINTR || result == -EAGAIN))
+                {
+                    QueueRead(slot);
+                    continue;
+                }
+
+                if (result > 0)
+                {
+                    read.BytesRead += result;
+                    // short read before the end of file, read the rest
+                    if (read.BytesRead < read.Request->GetSize())
+                    {
+                        if (!Cancelling)
+                        {
+                            QueueRead(slot);
+                            continue;
+                        }
+                        result = -ECANCELED;
+                    }
+                }
+                CLOG(result < 0 && result != -ECANCELED, FileSystem, Error, "Async read file meet error, error code: {0:d}", -result);
+
+                AsyncReadRequestPtr request = MoveTemp(read.Request);
+                FreeSlots.Add(slot);
+                --InflightNum;
+                request->Finish(read.BytesRead, result >= 0);
+            }
+            std::atomic_ref<uint32>(*CqHead).store(head, std::memory_order_release);
+        }
+
+        int32 RingFd{ -1 };
+        int32 WakeUpFd{ -1 };
+        uint64 WakeUpValue{ 0 };
+
+        uint8* SqRing{ nullptr };
+        uint8* CqRing{ nullptr };
+        io_uring_sqe* Sqes{ nullptr };
+        size_t RingSize{ 0 };
+        size_t SqeSize{ 0 };
+
+        uint32* SqHead{ nullptr };
+        uint32* SqTail{ nullptr };
+        uint32* SqArray{ nullptr };
+        uint32 SqMask{ 0 };
+        uint32 SqEntries{ 0 };
+        uint32 LocalSqTail{ 0 };
+        uint32 ToSubmit{ 0 };
+
+        uint32* CqHead{ nullptr };
+        uint32* CqTail{ nullptr };
+        uint32 CqMask{ 0 };
+        io_uring_cqe* Cqes{ nullptr };
+
+        /** only touched by ring thread */
+        Array<InflightRead> Slots;
+        Array<int32> FreeSlots;
+        int32 InflightNum{ 0 };
+        /** reads are being cancelled after an error, completions are never queued again */
+        bool Cancelling{ false };
+
+        std::mutex Mutex;
+        AsyncIOPriorityQueue PendingRequests;
+        bool Stopping{ false };
+        /** ring thread has quit after an unrecoverable error, submitted requests fail at once */
+        bool Broken{ false };
+        std::thread Thread;
+    };
+
+    UniquePtr<IAsyncIOBackend> CreateNativeAsyncIOBackend()
+    {
+        return IoUringAsyncIOBackend::Create(64);
+    }
+}
+#endif
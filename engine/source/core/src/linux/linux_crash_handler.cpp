@@ -0,0 +1,142 @@
+#include "log/crash_handler.hpp"
+#if PLATFORM_LINUX
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <exception>
+#include <fcntl.h>
+#include <poll.h>
+#include <thread>
+#include <unistd.h>
+
+namespace Engine
+{
+    namespace
+    {
+        constexpr int32 CRASH_SIGNALS[] = { SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT };
+
+        /** crashing thread waits no longer than this for callback, it may be blocked by locks the crash left held */
+        constexpr int32 CRASH_CALLBACK_TIMEOUT_MS = 200;
+
+        CrashCallback GCrashCallback = nullptr;
+        struct sigaction GPreviousActions[sizeof(CRASH_SIGNALS) / sizeof(CRASH_SIGNALS[0])];
+        std::terminate_handler GPreviousTerminate = nullptr;
+        /** set by the first crash, abort raised by terminate handler or a nested fault doesn't call callback again */
+        std::atomic<bool> GCrashHandled{ false };
+        /** signal handler writes request pipe, callback thread answers through done pipe */
+        int32 GRequestPipe[2] = { -1, -1 };
+        int32 GDonePipe[2] = { -1, -1 };
+
+        /**
+         * Callback locks and allocates, which isn't allowed inside a signal handler, so it runs on a thread
+         * spawned on install. Only write, poll and read are used by signal handler.
+         */
+        void RunCrashCallbackThread()
+        {
+            char request;
+            while (true)
+            {
+                const ssize_t readBytes = ::read(GRequestPipe[0], &request, 1);
+                if (readBytes == 1)
+                {
+                    break;
+                }
+                if (readBytes < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                return;
+            }
+
+            GCrashCallback();
+            const char done = 1;
+            [[maybe_unused]] const ssize_t writtenBytes = ::write(GDonePipe[1], &done, 1);
+        }
+
+        void CallCrashCallbackFromSignal()
+        {
+            const char request = 1;
+            if (GRequestPipe[1] < 0 || ::write(GRequestPipe[1], &request, 1) != 1)
+            {
+                return;
+            }
+
+            pollfd fd = { GDonePipe[0], POLLIN, 0 };
+            while (::poll(&fd, 1, CRASH_CALLBACK_TIMEOUT_MS) < 0 && errno == EINTR)
+            {
+            }
+        }
+
+        void HandleCrashSignal(int32 signal, siginfo_t* info, void* context)
+        {
+            const int32 savedErrno = errno;
+            if (!GCrashHandled.exchange(true))
+            {
+                CallCrashCallbackFromSignal();
+            }
+            errno = savedErrno;
+
+            // restore previous handler and raise again, so core dump or debugger sees the original crash
+            for (int32 index = 0; index < static_cast<int32>(sizeof(CRASH_SIGNALS) / sizeof(CRASH_SIGNALS[0])); ++index)
+            {
+                if (CRASH_SIGNALS[index] == signal)
+                {
+                    ::sigaction(signal, &GPreviousActions[index], nullptr);
+                    const struct sigaction& previous = GPreviousActions[index];
+                    if ((previous.sa_flags & SA_SIGINFO) != 0 && previous.sa_sigaction != nullptr)
+                    {
+                        previous.sa_sigaction(signal, info, context);
+                        return;
+                    }
+                    if (previous.sa_handler != SIG_DFL && previous.sa_handler != SIG_IGN)
+                    {
+                        previous.sa_handler(signal);
+                        return;
+                    }
+                    break;
+                }
+            }
+            ::raise(signal);
+        }
+
+        void HandleTerminate()
+        {
+            // not in a signal handler, callback is called directly
+            if (!GCrashHandled.exchange(true))
+            {
+                GCrashCallback();
+            }
+            if (GPreviousTerminate != nullptr)
+            {
+                GPreviousTerminate();
+            }
+            std::abort();
+        }
+    }
+
+    void InstallCrashHandler(CrashCallback callback)
+    {
+        if (GCrashCallback != nullptr)
+        {
+            return;
+        }
+        GCrashCallback = callback;
+
+        if (::pipe2(GRequestPipe, O_CLOEXEC) == 0 && ::pipe2(GDonePipe, O_CLOEXEC) == 0)
+        {
+            std::thread(RunCrashCallbackThread).detach();
+        }
+
+        struct sigaction action{};
+        action.sa_sigaction = HandleCrashSignal;
+        action.sa_flags = SA_SIGINFO | SA_ONSTACK;
+        sigemptyset(&action.sa_mask);
+        for (int32 index = 0; index < static_cast<int32>(sizeof(CRASH_SIGNALS) / sizeof(CRASH_SIGNALS[0])); ++index)
+        {
+            ::sigaction(CRASH_SIGNALS[index], &action, &GPreviousActions[index]);
+        }
+        GPreviousTerminate = std::set_terminate(HandleTerminate);
+    }
+}
+#endif
@@ -0,0 +1,460 @@
+#include "linux/linux_file_handle.hpp"
+#if PLATFORM_LINUX
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include "log/logger.hpp"
+#include "math/generic_math.hpp"
+#include "memory/memory.hpp"
+#include "file_system/path.hpp"
+#include "file_system/file_system_log.hpp"
+#include "linux/linux_utils.hpp"
+#include "stats/stats.hpp"
+
+namespace Engine
+{
+    static StatCounter GStatBytesRead("FileSystem.BytesRead", "bytes read from files, including async reads");
+
+    /** vectored io handles at most IOV_MAX buffers per call */
+    static constexpr int32 MAX_IO_VECTOR_NUM = 1024;
+
+    LinuxFileHandle::~LinuxFileHandle()
+    {
+        bool result = ::close(Fd) == 0;
+        CLOG(!result, FileSystem, Error, "Close linux file handle failed");
+    }
+
+    int64 LinuxFileHandle::GetSize() const
+    {
+        struct stat fileStat;
+        if (::fstat(Fd, &fileStat) != 0)
+        {
+            return -1;
+        }
+        return static_cast<int64>(fileStat.st_size);
+    }
+
+    bool LinuxFileHandle::Read(uint8* dest, int64 size)
+    {
+        const int64 readBytes = ReadAt(dest, size, PosInFile);
+        if (readBytes > 0)
+        {
+            PosInFile += readBytes;
+        }
+        return readBytes == size;
+    }
+
+    bool LinuxFileHandle::Write(const uint8* src, int64 size)
+    {
+        const int64 writtenBytes = WriteAt(src, size, PosInFile);
+        if (writtenBytes > 0)
+        {
+            PosInFile += writtenBytes;
+        }
+        return writtenBytes == size;
+    }
+
+    bool LinuxFileHandle::Seek(int64 offset, ESeekOrigin origin)
+    {
+        int64 base = 0;
+        if (origin == ESeekOrigin::Current)
+        {
+            base = PosInFile;
+        }
+        else if (origin == ESeekOrigin::End)
+        {
+            base = GetSize();
+        }
+
+        if (base < 0 || base + offset < 0)
+        {
+            return false;
+        }
+        PosInFile = base + offset;
+        return true;
+    }
+
+    int64 LinuxFileHandle::Tell() const
+    {
+        return PosInFile;
+    }
+
+    int64 LinuxFileHandle::ReadAt(uint8* dest, int64 size, int64 offset)
+    {
+        int64 totalSize = 0;
+        while (totalSize < size)
+        {
+            const ssize_t readBytes = ::pread(Fd, dest + totalSize, static_cast<size_t>(size - totalSize), offset + totalSize);
+            if (readBytes < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                LOG_ERROR(FileSystem, "Read file meet error, error code: {0:d}", errno);
+                return -1;
+            }
+
+            if (readBytes == 0)
+            {
+                break;
+            }
+            totalSize += readBytes;
+        }
+        GStatBytesRead.Add(totalSize);
+        return totalSize;
+    }
+
+    int64 LinuxFileHandle::WriteAt(const uint8* src, int64 size, int64 offset)
+    {
+        int64 totalSize = 0;
+        while (totalSize < size)
+        {
+            const ssize_t writtenBytes = ::pwrite(Fd, src + totalSize, static_cast<size_t>(size - totalSize), offset + totalSize);
+            if (writtenBytes < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                LOG_ERROR(FileSystem, "Write file meet error, error code: {0:d}", errno);
+                return -1;
+            }
+
+            if (writtenBytes == 0)
+            {
+                // no progress would retry forever, eg: some devices accept nothing
+                LOG_ERROR(FileSystem, "Write file stopped after {0} of {1} bytes", totalSize, size);
+                break;
+            }
+            totalSize += writtenBytes;
+        }
+        return totalSize;
+    }
+
+    int64 LinuxFileHandle::ReadV(const FileReadVector* vectors, int32 count, int64 offset)
+    {
+        int64 totalSize = 0;
+        int32 index = 0;
+        // byte offset into vectors[index] after a partial read
+        int64 consumed = 0;
+        while (index < count)
+        {
+            iovec ioVectors[MAX_IO_VECTOR_NUM];
+            int32 vectorNum = 0;
+            for (int32 i = index; i < count && vectorNum < MAX_IO_VECTOR_NUM; ++i, ++vectorNum)
+            {
+                const int64 skip = i == index ? consumed : 0;
+                ioVectors[vectorNum].iov_base = vectors[i].Dest + skip;
+                ioVectors[vectorNum].iov_len = static_cast<size_t>(vectors[i].Size - skip);
+            }
+
+            const ssize_t readBytes = ::preadv(Fd, ioVectors, vectorNum, offset + totalSize);
+            if (readBytes < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                LOG_ERROR(FileSystem, "Read file meet error, error code: {0:d}", errno);
+                return -1;
+            }
+
+            if (readBytes == 0)
+            {
+                break;
+            }
+
+            // continue from where a short read stopped
+            totalSize += readBytes;
+            int64 remain = readBytes;
+            while (index < count && remain >= vectors[index].Size - consumed)
+            {
+                remain -= vectors[index].Size - consumed;
+                consumed = 0;
+                ++index;
+            }
+            consumed += remain;
+        }
+        return totalSize;
+    }
+
+    int64 LinuxFileHandle::WriteV(const FileWriteVector* vectors, int32 count, int64 offset)
+    {
+        int64 totalSize = 0;
+        int32 index = 0;
+        int64 consumed = 0;
+        while (index < count)
+        {
+            iovec ioVectors[MAX_IO_VECTOR_NUM];
+            int32 vectorNum = 0;
+            for (int32 i = index; i < count && vectorNum < MAX_IO_VECTOR_NUM; ++i, ++vectorNum)
+            {
+                const int64 skip = i == index ? consumed : 0;
+                ioVectors[vectorNum].iov_base = const_cast<uint8*>(vectors[i].Src) + skip;
+                ioVectors[vectorNum].iov_len = static_cast<size_t>(vectors[i].Size - skip);
+            }
+
+            const ssize_t writtenBytes = ::pwritev(Fd, ioVectors, vectorNum, offset + totalSize);
+            if (writtenBytes < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                LOG_ERROR(FileSystem, "Write file meet error, error code: {0:d}", errno);
+                return -1;
+            }
+
+            totalSize += writtenBytes;
+            int64 remain = writtenBytes;
+            while (index < count && remain >= vectors[index].Size - consumed)
+            {
+                remain -= vectors[index].Size - consumed;
+                consumed = 0;
+                ++index;
+            }
+            consumed += remain;
+
+            // empty vectors are skipped above, nothing written with data left means no progress
+            if (writtenBytes == 0 && index < count)
+            {
+                LOG_ERROR(FileSystem, "Write file stopped after {0} bytes", totalSize);
+                break;
+            }
+        }
+        return totalSize;
+    }
+
+    bool LinuxFileHandle::Truncate(int64 size)
+    {
+        if (::ftruncate(Fd, size) != 0)
+        {
+            LOG_ERROR(FileSystem, "Truncate file failed, error code: {0:d}", errno);
+            return false;
+        }
+        return true;
+    }
+
+    bool LinuxFileHandle::Flush()
+    {
+        return ::fsync(Fd) == 0;
+    }
+
+    static int32 ToAdvice(EMappedAccessHint hint)
+    {
+        switch (hint)
+        {
+            case EMappedAccessHint::Sequential:
+                return MADV_SEQUENTIAL;
+            case EMappedAccessHint::Random:
+                return MADV_RANDOM;
+            case EMappedAccessHint::WillNeed:
+                return MADV_WILLNEED;
+            default:
+                return MADV_NORMAL;
+        }
+    }
+
+    LinuxMappedFileHandle::~LinuxMappedFileHandle()
+    {
+        if (View != nullptr)
+        {
+            ::munmap(View, static_cast<size_t>(ViewOffset + Size));
+        }
+    }
+
+    UniquePtr<IMappedFileHandle> LinuxMappedFileHandle::Map(const String& filePath, int64 offset, int64 length, EMappedAccessHint hint)
+    {
+        const int32 fd = ::open(filePath.Data(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            LOG_ERROR(FileSystem, "Open file {0} for mapping failed, error code: {1:d}", filePath.Data(), errno);
+            return nullptr;
+        }
+
+        struct stat fileStat;
+        if (::fstat(fd, &fileStat) != 0 || offset < 0 || offset > fileStat.st_size)
+        {
+            LOG_ERROR(FileSystem, "Map file {0} with invalid offset {1:d}", filePath.Data(), offset);
+            ::close(fd);
+            return nullptr;
+        }
+
+        if (length < 0 || offset + length > fileStat.st_size)
+        {
+            length = fileStat.st_size - offset;
+        }
+
+        // empty file can't be mapped
+        if (length == 0)
+        {
+            ::close(fd);
+            return MakeUnique<LinuxMappedFileHandle>(nullptr, 0, 0);
+        }
+
+        // view must start at a multiple of page size
+        const int64 viewOffset = offset % static_cast<int64>(PlatformMemory::GetPageSize());
+        void* view = ::mmap(nullptr, static_cast<size_t>(viewOffset + length), PROT_READ, MAP_PRIVATE, fd, offset - viewOffset);
+        // mapping keeps a reference of file
+        ::close(fd);
+        if (view == MAP_FAILED)
+        {
+            LOG_ERROR(FileSystem, "Map view of {0} failed, error code: {1:d}", filePath.Data(), errno);
+            return nullptr;
+        }
+
+        auto handle = MakeUnique<LinuxMappedFileHandle>(static_cast<uint8*>(view), viewOffset, length);
+        if (hint != EMappedAccessHint::Normal)
+        {
+            handle->Advise(hint, 0, length);
+        }
+        return handle;
+    }
+
+    const uint8* LinuxMappedFileHandle::GetData() const
+    {
+        return View != nullptr ? View + ViewOffset : nullptr;
+    }
+
+    int64 LinuxMappedFileHandle::GetSize() const
+    {
+        return Size;
+    }
+
+    void LinuxMappedFileHandle::Advise(EMappedAccessHint hint, int64 offset, int64 size)
+    {
+        if (View == nullptr || offset >= Size)
+        {
+            return;
+        }
+
+        size = size < 0 ? Size - offset : Math::Min(size, Size - offset);
+        // madvise requires page aligned address
+        const int64 start = ViewOffset + offset;
+        const int64 alignedStart = start - start % static_cast<int64>(PlatformMemory::GetPageSize());
+        ::madvise(View + alignedStart, static_cast<size_t>(start + size - alignedStart), ToAdvice(hint));
+    }
+
+    void LinuxMappedFileHandle::Prefetch(int64 offset, int64 size)
+    {
+        Advise(EMappedAccessHint::WillNeed, offset, size);
+    }
+
+    static bool ReadDirectoryEntry(DIR* handle, const String& directory, DirectoryEntry& entry, bool& isDirectory)
+    {
+        dirent* data = nullptr;
+        do
+        {
+            data = ::readdir(handle);
+        }
+        while (data != nullptr && (!CharTraits<char>::Compare(data->d_name, ".") ||
+                                   !CharTraits<char>::Compare(data->d_name, "..")));
+
+        if (data == nullptr)
+        {
+            return false;
+        }
+
+        String entryPath = Path::Combine(directory, data->d_name);
+        // links are reported as themselves, recursive find would loop forever on a link to an ancestor
+        struct stat fileStat;
+        const bool valid = ::fstatat(::dirfd(handle), data->d_name, &fileStat, AT_SYMLINK_NOFOLLOW) == 0;
+        isDirectory = valid && S_ISDIR(fileStat.st_mode);
+
+        FileStat status;
+        if (valid)
+        {
+            status = FileStat{TimespecToTimestamp(fileStat.st_mtim),
+                              TimespecToTimestamp(fileStat.st_atim),
+                              TimespecToTimestamp(fileStat.st_ctim),
+                              static_cast<int64>(fileStat.st_size),
+                              ::access(entryPath.Data(), W_OK) != 0,
+                              isDirectory,
+                              true
+            };
+        }
+
+        entry = DirectoryEntry(status, entryPath);
+        return true;
+    }
+
+    LinuxFindFileHandle::LinuxFindFileHandle(const String& path)
+        : NormalizedPath(Path::Normalize(path))
+    {}
+
+    LinuxFindFileHandle::~LinuxFindFileHandle()
+    {
+        if (Handle != nullptr)
+        {
+            ::closedir(Handle);
+            Handle = nullptr;
+        }
+    }
+
+    bool LinuxFindFileHandle::FindNext(DirectoryEntry& entry)
+    {
+        if (Handle == nullptr)
+        {
+            Handle = ::opendir(NormalizedPath.Data());
+            if (Handle == nullptr)
+            {
+                return false;
+            }
+        }
+
+        bool isDirectory = false;
+        return ReadDirectoryEntry(Handle, NormalizedPath, entry, isDirectory);
+    }
+
+    LinuxRecursiveFindFileHandle::LinuxRecursiveFindFileHandle(const String& path)
+    {
+        RecursionDirectories.Push(Path::Normalize(path));
+    }
+
+    LinuxRecursiveFindFileHandle::~LinuxRecursiveFindFileHandle()
+    {
+        if (Handle != nullptr)
+        {
+            ::closedir(Handle);
+            Handle = nullptr;
+        }
+    }
+
+    bool LinuxRecursiveFindFileHandle::FindNext(DirectoryEntry& entry)
+    {
+        while (true)
+        {
+            if (Handle == nullptr)
+            {
+                if (RecursionDirectories.Empty())
+                {
+                    return false;
+                }
+                NormalizedPath = RecursionDirectories.Pop();
+                Handle = ::opendir(NormalizedPath.Data());
+                if (Handle == nullptr)
+                {
+                    continue;
+                }
+            }
+
+            bool isDirectory = false;
+            if (ReadDirectoryEntry(Handle, NormalizedPath, entry, isDirectory))
+            {
+                if (isDirectory)
+                {
+                    RecursionDirectories.Push(entry.GetPath());
+                }
+                return true;
+            }
+
+            ::closedir(Handle);
+            Handle = nullptr;
+        }
+    }
+}
+#endif
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "global.hpp"
+#if PLATFORM_LINUX
+#include <dirent.h>
+#include "foundation/array.hpp"
+#include "foundation/smart_ptr.hpp"
+#include "foundation/string.hpp"
+#include "file_system/file_handle_interface.hpp"
+
+namespace Engine
+{
+    class CORE_API LinuxFileHandle final : public IFileHandle
+    {
+    public:
+        explicit LinuxFileHandle(int32 fd) : Fd(fd) {}
+
+        ~LinuxFileHandle() final;
+
+        int64 GetSize() const final;
+
+        bool Read(uint8* dest, int64 size) final;
+
+        bool Write(const uint8* src, int64 size) final;
+
+        bool Seek(int64 offset, ESeekOrigin origin) final;
+
+        int64 Tell() const final;
+
+        int64 ReadAt(uint8* dest, int64 size, int64 offset) final;
+
+        int64 WriteAt(const uint8* src, int64 size, int64 offset) final;
+
+        int64 ReadV(const FileReadVector* vectors, int32 count, int64 offset) final;
+
+        int64 WriteV(const FileWriteVector* vectors, int32 count, int64 offset) final;
+
+        bool Truncate(int64 size) final;
+
+        bool Flush() final;
+
+    private:
+        int32 Fd{ -1 };
+        /** cursor is kept by handle and all io goes through pread and pwrite, so the one of descriptor is never used */
+        int64 PosInFile{ 0 };
+    };
+
+    class CORE_API LinuxMappedFileHandle final : public IMappedFileHandle
+    {
+    public:
+        LinuxMappedFileHandle(uint8* view, int64 viewOffset, int64 size)
+            : View(view), ViewOffset(viewOffset), Size(size)
+        {}
+
+        ~LinuxMappedFileHandle() final;
+
+        /** map a region of file with mmap, nullptr if failed */
+        static UniquePtr<IMappedFileHandle> Map(const String& filePath, int64 offset, int64 length, EMappedAccessHint hint);
+
+        const uint8* GetData() const final;
+
+        int64 GetSize() const final;
+
+        void Advise(EMappedAccessHint hint, int64 offset, int64 size) final;
+
+        void Prefetch(int64 offset, int64 size) final;
+
+    private:
+        uint8* View{ nullptr };
+        int64 ViewOffset{ 0 };
+        int64 Size{ 0 };
+    };
+
+    class CORE_API LinuxFindFileHandle final : public IFindFileHandle
+    {
+    public:
+        LinuxFindFileHandle(const String& path);
+
+        ~LinuxFindFileHandle() final;
+
+        bool FindNext(DirectoryEntry& entry) final;
+
+    private:
+        DIR* Handle{ nullptr };
+        String NormalizedPath;
+    };
+
+    class CORE_API LinuxRecursiveFindFileHandle final : public IFindFileHandle
+    {
+    public:
+        LinuxRecursiveFindFileHandle(const String& path);
+
+        ~LinuxRecursiveFindFileHandle() final;
+
+        bool FindNext(DirectoryEntry& entry) final;
+
+    private:
+        DIR* Handle{ nullptr };
+        String NormalizedPath;
+        Array<String> RecursionDirectories;
+    };
+
+    typedef LinuxFileHandle PlatformFileHandle;
+    typedef LinuxMappedFileHandle PlatformMappedFileHandle;
+    typedef LinuxFindFileHandle PlatformFindFileHandle;
+    typedef LinuxRecursiveFindFileHandle PlatformRecursiveFindFileHandle;
+}
+#endif
@@ -0,0 +1,361 @@
+#include "file_system/file_watcher.hpp"
+#if PLATFORM_LINUX
+#include <cerrno>
+#include <dirent.h>
+#include <mutex>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "log/logger.hpp"
+#include "file_system/file_system_log.hpp"
+#include "file_system/file_watcher_backend.hpp"
+
+namespace Engine
+{
+    /**
+     * inotify watches a single directory, so recursive watching adds a watch for every subdirectory
+     * and keeps adding them as directories are created or moved in. An eventfd wakes poll up for Wake.
+     */
+    class InotifyFileWatcherBackend final : public IFileWatcherBackend
+    {
+    public:
+        static UniquePtr<IFileWatcherBackend> Create()
+        {
+            const int32 inotifyFd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            if (inotifyFd < 0)
+            {
+                LOG_ERROR(FileSystem, "Create inotify instance failed, error code: {0:d}", errno);
+                return nullptr;
+            }
+
+            const int32 wakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if (wakeFd < 0)
+            {
+                LOG_ERROR(FileSystem, "Create eventfd failed, error code: {0:d}", errno);
+                ::close(inotifyFd);
+                return nullptr;
+            }
+            return UniquePtr<IFileWatcherBackend>(new InotifyFileWatcherBackend(inotifyFd, wakeFd));
+        }
+
+        ~InotifyFileWatcherBackend() final
+        {
+            ::close(InotifyFd);
+            ::close(WakeFd);
+        }
+
+        bool AddWatch(FileWatchHandle handle, const String& directory, bool recursive) final
+        {
+            std::scoped_lock lock(Mutex);
+            if (!AddDirectory(handle, directory, recursive))
+            {
+                return false;
+            }
+            Roots.Add(handle, directory.EndsWith('/') ? directory.Slices(0, directory.Length() - 1) : directory);
+            if (recursive)
+            {
+                AddSubdirectories(handle, directory, nullptr);
+            }
+            return true;
+        }
+
+        void RemoveWatch(FileWatchHandle handle) final
+        {
+            std::scoped_lock lock(Mutex);
+            Roots.Remove(handle);
+            RemoveTargets([handle](const WatchTarget& target) { return target.Handle == handle; });
+        }
+
+        void WaitChanges(int32 timeoutMs, Array<RawFileChange>& outChanges) final
+        {
+            pollfd fds[2] = { { InotifyFd, POLLIN, 0 }, { WakeFd, POLLIN, 0 } };
+            if (::poll(fds, 2, timeoutMs) <= 0)
+            {
+                return;
+            }
+
+            if (fds[1].revents & POLLIN)
+            {
+                uint64 count;
+                [[maybe_unused]] const ssize_t readBytes = ::read(WakeFd, &count, sizeof(count));
+            }
+
+            if (fds[0].revents & POLLIN)
+            {
+                ReadEvents(outChanges);
+            }
+        }
+
+        void Wake() final
+        {
+            const uint64 count = 1;
+            [[maybe_unused]] const ssize_t writtenBytes = ::write(WakeFd, &count, sizeof(count));
+        }
+
+    private:
+        struct WatchTarget
+        {
+            FileWatchHandle Handle;
+            /** ends with '/' */
+            String Path;
+            bool Recursive;
+        };
+
+        /** the first half of a rename, waiting for IN_MOVED_TO with the same cookie */
+        struct MovedFrom
+        {
+            uint32 Cookie;
+            FileWatchHandle Handle;
+            String Path;
+            bool IsDirectory;
+        };
+
+        static constexpr uint32 WATCH_MASK = IN_CREATE | IN_DELETE | IN_MODIFY | IN_ATTRIB | IN_CLOSE_WRITE |
+                                             IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR;
+
+        InotifyFileWatcherBackend(int32 inotifyFd, int32 wakeFd) : InotifyFd(inotifyFd), WakeFd(wakeFd) {}
+
+        bool AddDirectory(FileWatchHandle handle, const String& directory, bool recursive)
+        {
+            const int32 wd = ::inotify_add_watch(InotifyFd, directory.Data(), WATCH_MASK);
+            if (wd < 0)
+            {
+                LOG_ERROR(FileSystem, "Watch directory {0} failed, error code: {1:d}", directory.Data(), errno);
+                return false;
+            }
+
+            // same directory watched by multiple handles shares a watch descriptor
+            Array<WatchTarget>& targets = Watches.FindOrAdd(wd, Array<WatchTarget>());
+            String path = directory.EndsWith('/') ? directory : directory + "/";
+            for (const WatchTarget& target : targets)
+            {
+                if (target.Handle == handle)
+                {
+                    return true;
+                }
+            }
+            targets.Add(WatchTarget{ handle, MoveTemp(path), recursive });
+            return true;
+        }
+
+        /** @param outChanges report entries inside as added if it isn't nullptr, they may be created before the watch */
+        void AddSubdirectories(FileWatchHandle handle, const String& directory, Array<RawFileChange>* outChanges)
+        {
+            DIR* dir = ::opendir(directory.Data());
+            if (dir == nullptr)
+            {
+                return;
+            }
+
+            const String prefix = directory.EndsWith('/') ? directory : directory + "/";
+            while (dirent* entry = ::readdir(dir))
+            {
+                if (CharTraits<char>::Compare(entry->d_name, ".") == 0 || CharTraits<char>::Compare(entry->d_name, "..") == 0)
+                {
+                    continue;
+                }
+
+                String path = prefix + entry->d_name;
+                if (outChanges != nullptr)
+                {
+                    outChanges->Add(RawFileChange{ handle, EFileChangeAction::Added, path, String() });
+                }
+                bool isDirectory = entry->d_type == DT_DIR;
+                if (entry->d_type == DT_UNKNOWN)
+                {
+                    struct stat fileStat;
+                    isDirectory = ::stat(path.Data(), &fileStat) == 0 && S_ISDIR(fileStat.st_mode);
+                }
+                if (isDirectory && AddDirectory(handle, path, true))
+                {
+                    AddSubdirectories(handle, path, outChanges);
+                }
+            }
+            ::closedir(dir);
+        }
+
+        /** remove matched targets, and watch descriptors which nobody uses any more */
+        template <typename Predicate>
+        void RemoveTargets(const Predicate& predicate)
+        {
+            Array<int32> unusedWatches;
+            for (auto& pair : Watches)
+            {
+                Array<WatchTarget>& targets = pair.Value;
+                for (int32 index = targets.Size() - 1; index >= 0; --index)
+                {
+                    if (predicate(targets[index]))
+                    {
+                        targets.RemoveAt(index);
+                    }
+                }
+                if (targets.Empty())
+                {
+                    unusedWatches.Add(pair.Key);
+                }
+            }
+
+            for (int32 wd : unusedWatches)
+            {
+                ::inotify_rm_watch(InotifyFd, wd);
+                Watches.Remove(wd);
+            }
+        }
+
+        /** directory moved inside watched tree keeps its watch descriptors, only recorded paths change */
+        void RenameTargets(FileWatchHandle handle, const String& oldPath, const String& newPath)
+        {
+            const String oldPrefix = oldPath + "/";
+            for (auto& pair : Watches)
+            {
+                for (WatchTarget& target : pair.Value)
+                {
+                    if (target.Handle == handle && target.Path.StartsWith(oldPrefix))
+                    {
+                        target.Path = newPath + "/" + target.Path.Slices(oldPrefix.Length(), target.Path.Length() - oldPrefix.Length());
+                    }
+                }
+            }
+        }
+
+        void RemoveSubtreeTargets(FileWatchHandle handle, const String& path)
+        {
+            const String prefix = path + "/";
+            RemoveTargets([handle, &prefix](const WatchTarget& target) {
+                return target.Handle == handle && target.Path.StartsWith(prefix);
+            });
+        }
+
+        void ReadEvents(Array<RawFileChange>& outChanges)
+        {
+            alignas(inotify_event) char buffer[16 * 1024];
+            Array<MovedFrom> movedFroms;
+
+            std::scoped_lock lock(Mutex);
+            while (true)
+            {
+                const ssize_t length = ::read(InotifyFd, buffer, sizeof(buffer));
+                if (length <= 0)
+                {
+                    break;
+                }
+
+                for (const char* cursor = buffer; cursor < buffer + length;)
+                {
+                    const inotify_event* event = reinterpret_cast<const inotify_event*>(cursor);
+                    cursor += sizeof(inotify_event) + event->len;
+                    HandleEvent(*event, movedFroms, outChanges);
+                }
+            }
+
+            // moved out of watched tree
+            for (MovedFrom& movedFrom : movedFroms)
+            {
+                if (movedFrom.IsDirectory)
+                {
+                    RemoveSubtreeTargets(movedFrom.Handle, movedFrom.Path);
+                }
+                outChanges.Add(RawFileChange{ movedFrom.Handle, EFileChangeAction::Removed, MoveTemp(movedFrom.Path), String() });
+            }
+        }
+
+        void HandleEvent(const inotify_event& event, Array<MovedFrom>& movedFroms, Array<RawFileChange>& outChanges)
+        {
+            if (event.mask & IN_Q_OVERFLOW)
+            {
+                // queue is shared by all watches, any of them may have lost changes
+                LOG_WARN(FileSystem, "Too many file changes, some of them are lost");
+                for (const auto& pair : Roots)
+                {
+                    outChanges.Add(RawFileChange{ pair.Key, EFileChangeAction::Overflow, pair.Value, String() });
+                }
+                return;
+            }
+
+            if (event.mask & IN_IGNORED)
+            {
+                // directory is removed or unwatched
+                Watches.Remove(event.wd);
+                return;
+            }
+
+            Array<WatchTarget>* targets = Watches.Find(event.wd);
+            if (targets == nullptr || event.len == 0)
+            {
+                return;
+            }
+
+            const bool isDirectory = (event.mask & IN_ISDIR) != 0;
+            // targets may grow when a created directory is watched
+            for (int32 index = 0; index < targets->Size(); ++index)
+            {
+                const FileWatchHandle handle = (*targets)[index].Handle;
+                const bool recursive = (*targets)[index].Recursive;
+                String path = (*targets)[index].Path + event.name;
+
+                if (event.mask & (IN_CREATE | IN_MOVED_TO))
+                {
+                    String oldPath;
+                    if (event.mask & IN_MOVED_TO)
+                    {
+                        for (int32 movedIndex = 0; movedIndex < movedFroms.Size(); ++movedIndex)
+                        {
+                            if (movedFroms[movedIndex].Cookie == event.cookie && movedFroms[movedIndex].Handle == handle)
+                            {
+                                oldPath = MoveTemp(movedFroms[movedIndex].Path);
+                                movedFroms.RemoveAt(movedIndex);
+                                break;
+                            }
+                        }
+                    }
+
+                    if (!oldPath.Empty())
+                    {
+                        if (isDirectory)
+                        {
+                            RenameTargets(handle, oldPath, path);
+                        }
+                        outChanges.Add(RawFileChange{ handle, EFileChangeAction::Renamed, path, MoveTemp(oldPath) });
+                        continue;
+                    }
+
+                    outChanges.Add(RawFileChange{ handle, EFileChangeAction::Added, path, String() });
+                    if (isDirectory && recursive && AddDirectory(handle, path, true))
+                    {
+                        // files may be created before the watch is added
+                        AddSubdirectories(handle, path, &outChanges);
+                        targets = Watches.Find(event.wd);
+                    }
+                }
+                else if (event.mask & IN_MOVED_FROM)
+                {
+                    movedFroms.Add(MovedFrom{ event.cookie, handle, MoveTemp(path), isDirectory });
+                }
+                else if (event.mask & IN_DELETE)
+                {
+                    outChanges.Add(RawFileChange{ handle, EFileChangeAction::Removed, MoveTemp(path), String() });
+                }
+                else if (!isDirectory && (event.mask & (IN_MODIFY | IN_ATTRIB | IN_CLOSE_WRITE)))
+                {
+                    outChanges.Add(RawFileChange{ handle, EFileChangeAction::Modified, MoveTemp(path), String() });
+                }
+            }
+        }
+
+        int32 InotifyFd;
+        int32 WakeFd;
+        std::mutex Mutex;
+        /** watch descriptor to handles using it */
+        Map<int32, Array<WatchTarget>> Watches;
+        /** watched directory of each handle, without trailing '/' */
+        Map<FileWatchHandle, String> Roots;
+    };
+
+    UniquePtr<IFileWatcherBackend> CreateFileWatcherBackend()
+    {
+        return InotifyFileWatcherBackend::Create();
+    }
+}
+#endif
@@ -0,0 +1,288 @@
+#include "linux/linux_platform_file.hpp"
+#if PLATFORM_LINUX
+#include <cerrno>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "foundation/regex.hpp"
+#include "foundation/queue.hpp"
+#include "file_system/path.hpp"
+#include "linux/linux_file_handle.hpp"
+#include "linux/linux_utils.hpp"
+#include "log/logger.hpp"
+#include "file_system/file_system_log.hpp"
+
+namespace Engine
+{
+    bool LinuxPlatformFile::MakeDir(const String& path)
+    {
+        return ::mkdir(path.Data(), 0755) == 0 || errno == EEXIST;
+    }
+
+    bool LinuxPlatformFile::RemoveDir(const String& path)
+    {
+        return ::rmdir(path.Data()) == 0;
+    }
+
+    bool LinuxPlatformFile::MakeFile(const String& path)
+    {
+        const int32 fd = ::open(path.Data(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+        if (fd < 0)
+        {
+            return errno == EEXIST;
+        }
+        ::close(fd);
+        return true;
+    }
+
+    bool LinuxPlatformFile::RemoveFile(const String& path)
+    {
+        return ::unlink(path.Data()) == 0;
+    }
+
+    bool LinuxPlatformFile::MoveFile(const String& from, const String& to)
+    {
+        return ::rename(from.Data(), to.Data()) == 0;
+    }
+
+    bool LinuxPlatformFile::CopyFile(const String& from, const String& to)
+    {
+        const int32 src = ::open(from.Data(), O_RDONLY | O_CLOEXEC);
+        if (src < 0)
+        {
+            return false;
+        }
+
+        struct stat fileStat;
+        ::fstat(src, &fileStat);
+        // fail if destination exists, same as windows
+        const int32 dest = ::open(to.Data(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, fileStat.st_mode & 0777);
+        if (dest < 0)
+        {
+            ::close(src);
+            return false;
+        }
+
+        bool result = true;
+        uint8 buffer[64 * 1024];
+        while (true)
+        {
+            const ssize_t readBytes = ::read(src, buffer, sizeof(buffer));
+            if (readBytes < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (readBytes <= 0)
+            {
+                result = readBytes == 0;
+                break;
+            }
+
+            ssize_t offset = 0;
+            while (offset < readBytes)
+            {
+                const ssize_t writtenBytes = ::write(dest, buffer + offset, static_cast<size_t>(readBytes - offset));
+                if (writtenBytes < 0 && errno != EINTR)
+                {
+                    result = false;
+                    break;
+                }
+                offset += writtenBytes > 0 ? writtenBytes : 0;
+            }
+
+            if (!result)
+            {
+                break;
+            }
+        }
+
+        ::close(src);
+        ::close(dest);
+        CLOG(!result, FileSystem, Error, "Copy file {0} to {1} failed, error code: {2:d}", from.Data(), to.Data(), errno);
+        return result;
+    }
+
+    bool LinuxPlatformFile::FileExists(const String& path)
+    {
+        struct stat fileStat;
+        return ::stat(path.Data(), &fileStat) == 0 && S_ISREG(fileStat.st_mode);
+    }
+
+    bool LinuxPlatformFile::IsReadOnly(const String& filePath)
+    {
+        return ::access(filePath.Data(), F_OK) == 0 && ::access(filePath.Data(), W_OK) != 0;
+    }
+
+    int64 LinuxPlatformFile::FileSize(const String& filePath)
+    {
+        struct stat fileStat;
+        if (::stat(filePath.Data(), &fileStat) == 0 && !S_ISDIR(fileStat.st_mode))
+        {
+            return static_cast<int64>(fileStat.st_size);
+        }
+        return -1;
+    }
+
+    bool LinuxPlatformFile::DirExists(const String& path)
+    {
+        struct stat fileStat;
+        return ::stat(path.Data(), &fileStat) == 0 && S_ISDIR(fileStat.st_mode);
+    }
+
+    FileTime LinuxPlatformFile::GetFileTime(const String& path)
+    {
+        FileTime ret;
+        struct stat fileStat;
+        if (::stat(path.Data(), &fileStat) == 0)
+        {
+            // birth time isn't kept by stat, status change time is the closest one.
+            // same conversion as FileStat of directory entries, truncated to seconds
+            ret.CreationTime = static_cast<size_t>(TimespecToTimestamp(fileStat.st_ctim).TimeSinceEpoch());
+            ret.LastAccessTime = static_cast<size_t>(TimespecToTimestamp(fileStat.st_atim).TimeSinceEpoch());
+            ret.LastModifyTime = static_cast<size_t>(TimespecToTimestamp(fileStat.st_mtim).TimeSinceEpoch());
+        }
+        return ret;
+    }
+
+    Array<String> LinuxPlatformFile::QueryFiles(const String& searchPath, const String& regexExpr, bool recursion)
+    {
+        Array<String> ret;
+
+        std::regex pattern(regexExpr.Data());
+
+        Queue<String> searchQueue;
+        searchQueue.emplace(searchPath);
+
+        while (!searchQueue.empty())
+        {
+            String path = MoveTemp(searchQueue.front());
+            searchQueue.pop();
+
+            DIR* handle = ::opendir(path.Data());
+            if (handle == nullptr)
+            {
+                continue;
+            }
+
+            const int32 dirFd = ::dirfd(handle);
+            while (dirent* data = ::readdir(handle))
+            {
+                if (CharTraits<char>::Compare(data->d_name, ".") == 0 ||
+                    CharTraits<char>::Compare(data->d_name, "..") == 0)
+                {
+                    continue;
+                }
+
+                String entryPath = Path::Combine(path, data->d_name);
+                // don't follow links, a link to an ancestor would be queued again and again
+                struct stat fileStat;
+                const bool isDirectory = ::fstatat(dirFd, data->d_name, &fileStat, AT_SYMLINK_NOFOLLOW) == 0 &&
+                                         S_ISDIR(fileStat.st_mode);
+                if (recursion && isDirectory)
+                {
+                    if (std::regex_match(data->d_name, pattern))
+                    {
+                        ret.Add(entryPath);
+                    }
+                    searchQueue.emplace(entryPath);
+                }
+                else if (!isDirectory && std::regex_match(data->d_name, pattern))
+                {
+                    ret.Add(entryPath);
+                }
+            }
+            ::closedir(handle);
+        }
+
+        return ret;
+    }
+
+    bool LinuxPlatformFile::IterateDirectory(const String& directory, const DirectoryVisitor& visitor)
+    {
+        DIR* handle = ::opendir(directory.Data());
+        if (handle == nullptr)
+        {
+            return false;
+        }
+
+        const String prefix = directory.EndsWith('/') ? directory : directory + "/";
+        const int32 dirFd = ::dirfd(handle);
+        while (dirent* data = ::readdir(handle))
+        {
+            if (CharTraits<char>::Compare(data->d_name, ".") == 0 ||
+                CharTraits<char>::Compare(data->d_name, "..") == 0)
+            {
+                continue;
+            }
+
+            // stat relative to opened directory skips resolving the whole path again,
+            // links are reported as themselves so a walker never descends into them and loops
+            struct stat fileStat;
+            if (::fstatat(dirFd, data->d_name, &fileStat, AT_SYMLINK_NOFOLLOW) != 0)
+            {
+                continue;
+            }
+
+            FileStat status{TimespecToTimestamp(fileStat.st_mtim),
+                            TimespecToTimestamp(fileStat.st_atim),
+                            TimespecToTimestamp(fileStat.st_ctim),
+                            static_cast<int64>(fileStat.st_size),
+                            // permission bits instead of access(), which costs another syscall per entry
+                            (fileStat.st_mode & (S_IWUSR | S_IWGRP | S_IWOTH)) == 0,
+                            S_ISDIR(fileStat.st_mode),
+                            true
+            };
+
+            if (!visitor(DirectoryEntry(status, prefix + data->d_name)))
+            {
+                break;
+            }
+        }
+        ::closedir(handle);
+        return true;
+    }
+
+    UniquePtr<IFileHandle> LinuxPlatformFile::OpenFile(const String& filePath, EFileAccess access, EFileShareMode mode)
+    {
+        // share mode is advisory on linux, files are never locked against other openers
+        int32 flags = O_CLOEXEC;
+        switch (access)
+        {
+            case EFileAccess::Read:
+            {
+                flags |= O_RDONLY;
+                break;
+            }
+            case EFileAccess::Write:
+            {
+                flags |= O_WRONLY | O_CREAT | O_TRUNC;
+                break;
+            }
+            case EFileAccess::ReadWrite:
+            {
+                flags |= O_RDWR | O_CREAT;
+                break;
+            }
+            default:
+            {
+                flags |= O_RDONLY;
+            }
+        }
+
+        const int32 fd = ::open(filePath.Data(), flags, 0644);
+        if (fd < 0)
+        {
+            LOG_ERROR(FileSystem, "Open file {0} failed, error code: {1:d}", filePath.Data(), errno);
+            return nullptr;
+        }
+
+        return MakeUnique<LinuxFileHandle>(fd);
+    }
+
+    UniquePtr<IMappedFileHandle> LinuxPlatformFile::MapFile(const String& filePath, int64 offset, int64 length, EMappedAccessHint hint)
+    {
+        return LinuxMappedFileHandle::Map(filePath, offset, length, hint);
+    }
+}
+#endif
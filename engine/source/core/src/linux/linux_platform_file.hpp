@@ -0,0 +1,46 @@
+#pragma once
+
+#include "global.hpp"
+#if PLATFORM_LINUX
+#include "file_system/platform_file_interface.hpp"
+
+namespace Engine
+{
+    class CORE_API LinuxPlatformFile final : public IPlatformFile
+    {
+    public:
+        LinuxPlatformFile() = default;
+        virtual ~LinuxPlatformFile() = default;
+
+        bool MakeDir(const String& path) final;
+
+        bool RemoveDir(const String& path) final;
+
+        bool MakeFile(const String& path) final;
+
+        bool RemoveFile(const String& path) final;
+
+        bool MoveFile(const String& from, const String& to) final;
+
+        bool CopyFile(const String& from, const String& to) final;
+
+        bool FileExists(const String& path) final;
+
+        bool IsReadOnly(const String& filePath) final;
+
+        int64 FileSize(const String& filePath) final;
+
+        bool DirExists(const String& path) final;
+
+        FileTime GetFileTime(const String& path) final;
+
+        Array<String> QueryFiles(const String& searchPath, const String& regexExpr, bool recursion) final;
+
+        bool IterateDirectory(const String& directory, const DirectoryVisitor& visitor) final;
+
+        UniquePtr<IFileHandle> OpenFile(const String& fileName, EFileAccess access, EFileShareMode mode) final;
+
+        UniquePtr<IMappedFileHandle> MapFile(const String& fileName, int64 offset, int64 length, EMappedAccessHint hint) final;
+    };
+}
+#endif
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "global.hpp"
+#if PLATFORM_LINUX
+#include <ctime>
+#include "foundation/time.hpp"
+
+namespace Engine
+{
+    inline Timestamp TimespecToTimestamp(const timespec& time)
+    {
+        return Timestamp(Timestamp::Duration(static_cast<int64>(time.tv_sec) * 1000 + time.tv_nsec / 1'000'000));
+    }
+}
+#endif
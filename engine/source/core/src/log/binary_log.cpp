@@ -0,0 +1,240 @@
+#include "log/binary_log.hpp"
+#include "file_system/file_stream.hpp"
+
+namespace Engine
+{
+    namespace
+    {
+        /** guard against allocating for a corrupted length */
+        constexpr uint32 MAX_RECORD_LENGTH = 1u << 24;
+    }
+
+    BinaryLogWriter::BinaryLogWriter(const String& filePath)
+        : Writer(MakeUnique<FileWriter>(filePath))
+    {
+        if (Writer->IsValid())
+        {
+            Writer->SetEndian(EEndian::Little);
+            Writer->Write(MAGIC);
+            Writer->Write(VERSION);
+        }
+    }
+
+    BinaryLogWriter::~BinaryLogWriter() = default;
+
+    bool BinaryLogWriter::IsValid() const
+    {
+        return Writer->IsValid();
+    }
+
+    bool BinaryLogWriter::HasError() const
+    {
+        return Writer->HasError();
+    }
+
+    void BinaryLogWriter::WriteMessage(const LogSite& site, int64 time, uint64 threadId, const uint8* args, int32 size)
+    {
+        const uint64 siteKey = static_cast<uint64>(reinterpret_cast<uintptr_t>(&site));
+        const uint32* foundId = SiteIds.Find(siteKey);
+        uint32 siteId;
+        if (foundId != nullptr)
+        {
+            siteId = *foundId;
+        }
+        else
+        {
+            siteId = static_cast<uint32>(SiteIds.Size());
+            SiteIds.Add(siteKey, siteId);
+
+            Writer->Write(static_cast<uint8>(EBinaryLogRecord::Site));
+            Writer->Write(siteId);
+            Writer->Write(static_cast<uint8>(site.Level));
+            Writer->Write(site.Line);
+            WriteString(StringView(site.Category));
+            WriteString(site.File != nullptr ? StringView(site.File) : StringView());
+            WriteString(StringView(site.Format));
+            Writer->Write(static_cast<uint8>(site.ArgNum));
+            Writer->Write(reinterpret_cast<const uint8*>(site.ArgTypes), site.ArgNum);
+        }
+
+        Writer->Write(static_cast<uint8>(EBinaryLogRecord::Message));
+        Writer->Write(siteId);
+        Writer->Write(time);
+        Writer->Write(threadId);
+        // arguments are kept in native layout, engine only runs on little endian platforms
+        Writer->Write(static_cast<uint32>(size));
+        Writer->Write(args, size);
+    }
+
+    void BinaryLogWriter::WriteText(spdlog::level::level_enum level, StringView category, int64 time, uint64 threadId, StringView text)
+    {
+        Writer->Write(static_cast<uint8>(EBinaryLogRecord::Text));
+        Writer->Write(static_cast<uint8>(level));
+        WriteString(category);
+        Writer->Write(time);
+        Writer->Write(threadId);
+        WriteString(text);
+    }
+
+    bool BinaryLogWriter::Flush()
+    {
+        return Writer->Flush();
+    }
+
+    void BinaryLogWriter::WriteString(StringView str)
+    {
+        Writer->Write(static_cast<uint32>(str.Length()));
+        Writer->Write(reinterpret_cast<const uint8*>(str.Data()), str.Length());
+    }
+
+    BinaryLogReader::BinaryLogReader(const String& filePath)
+        : Reader(MakeUnique<FileReader>(filePath))
+    {
+        if (Reader->IsValid())
+        {
+            Reader->SetEndian(EEndian::Little);
+            uint32 magic, version;
+            Valid = Reader->Read(magic) && magic == BinaryLogWriter::MAGIC && Reader->Read(version) &&
+                    version == BinaryLogWriter::VERSION;
+        }
+    }
+
+    BinaryLogReader::~BinaryLogReader() = default;
+
+    bool BinaryLogReader::Next(LogEntry& outEntry)
+    {
+        if (!Valid || Error)
+        {
+            return false;
+        }
+
+        while (true)
+        {
+            uint8 record;
+            if (!Reader->Read(record))
+            {
+                Error = Reader->HasError();
+                return false;
+            }
+
+            if (record == static_cast<uint8>(EBinaryLogRecord::Site))
+            {
+                if (!ReadSite())
+                {
+                    Error = true;
+                    return false;
+                }
+                continue;
+            }
+
+            if (record == static_cast<uint8>(EBinaryLogRecord::Message))
+            {
+                uint32 siteId, size;
+                if (!Reader->Read(siteId) || siteId >= static_cast<uint32>(Sites.Size()) || !Reader->Read(outEntry.Time) ||
+                    !Reader->Read(outEntry.ThreadId) || !Reader->Read(size) || size > MAX_RECORD_LENGTH)
+                {
+                    Error = true;
+                    return false;
+                }
+                Args.Resize(static_cast<int32>(size));
+                const Site& site = Sites[static_cast<int32>(siteId)];
+                Buffer.clear();
+                if (Reader->Read(Args.Data(), size) != size ||
+                    !LogFormatter::Format(site.Format.Data(), site.ArgTypes.Data(), site.ArgTypes.Size(), Args.Data(),
+                                          Args.Size(), Buffer))
+                {
+                    Error = true;
+                    return false;
+                }
+                LogFormatter::ReadFields(site.ArgTypes.Data(), site.ArgTypes.Size(), Args.Data(), Args.Size(), outEntry.Fields);
+                outEntry.Level = site.Level;
+                outEntry.Category = site.Category;
+                outEntry.File = site.File;
+                outEntry.Line = site.Line;
+                outEntry.Message.Clear();
+                outEntry.Message.Append(StringView(Buffer.data(), static_cast<int32>(Buffer.size())));
+                return true;
+            }
+
+            if (record == static_cast<uint8>(EBinaryLogRecord::Text))
+            {
+                uint8 level;
+                if (!Reader->Read(level) || !ReadString(outEntry.Category) || !Reader->Read(outEntry.Time) ||
+                    !Reader->Read(outEntry.ThreadId) || !ReadString(outEntry.Message))
+                {
+                    Error = true;
+                    return false;
+                }
+                outEntry.Level = static_cast<spdlog::level::level_enum>(level);
+                outEntry.File.Clear();
+                outEntry.Line = 0;
+                outEntry.Fields.Clear();
+                return true;
+            }
+
+            Error = true;
+            return false;
+        }
+    }
+
+    bool BinaryLogReader::ConvertToText(const String& binaryPath, const String& textPath)
+    {
+        BinaryLogReader reader(binaryPath);
+        if (!reader.IsValid())
+        {
+            return false;
+        }
+        FileWriter writer(textPath);
+        if (!writer.IsValid())
+        {
+            return false;
+        }
+
+        spdlog::memory_buf_t text;
+        LogEntry entry;
+        while (reader.Next(entry))
+        {
+            text.clear();
+            LogFormatter::FormatText(entry, text);
+            writer.Write(reinterpret_cast<const uint8*>(text.data()), static_cast<int64>(text.size()));
+        }
+        return !reader.HasError() && writer.Flush() && !writer.HasError();
+    }
+
+    bool BinaryLogReader::ReadSite()
+    {
+        uint32 siteId;
+        uint8 level, argNum;
+        Site site;
+        if (!Reader->Read(siteId) || siteId != static_cast<uint32>(Sites.Size()) || !Reader->Read(level) ||
+            !Reader->Read(site.Line) || !ReadString(site.Category) || !ReadString(site.File) || !ReadString(site.Format) ||
+            !Reader->Read(argNum))
+        {
+            return false;
+        }
+        site.Level = static_cast<spdlog::level::level_enum>(level);
+        site.ArgTypes.Resize(argNum);
+        if (argNum > 0 && Reader->Read(reinterpret_cast<uint8*>(site.ArgTypes.Data()), argNum) != argNum)
+        {
+            return false;
+        }
+        Sites.Add(MoveTemp(site));
+        return true;
+    }
+
+    bool BinaryLogReader::ReadString(String& outStr)
+    {
+        uint32 length;
+        if (!Reader->Read(length) || length > MAX_RECORD_LENGTH)
+        {
+            return false;
+        }
+        outStr.Clear();
+        if (length == 0)
+        {
+            return true;
+        }
+        outStr = String(static_cast<int32>(length), '\0');
+        return Reader->Read(reinterpret_cast<uint8*>(outStr.Data()), length) == length;
+    }
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "global.hpp"
+#include "definitions_core.hpp"
+
+namespace Engine
+{
+    using CrashCallback = void (*)();
+
+    /**
+     * Call callback when process crashes, eg: access violation or abort, then let the crash go on as usual.
+     * Handlers installed by others are kept, it's called before them. Callback is called once per process and
+     * never inside a signal handler, so it may lock and allocate, but a crash only waits for it a bounded time.
+     */
+    void InstallCrashHandler(CrashCallback callback);
+}
@@ -0,0 +1,678 @@
+#include <cstdio>
+#include <cstdlib>
+#include "log/log_backend.hpp"
+#include "log/binary_log.hpp"
+#include "log/crash_handler.hpp"
+#include "log/structured_log.hpp"
+#include "spdlog/sinks/base_sink.h"
+#include "spdlog/sinks/stdout_color_sinks.h"
+#include "spdlog/pattern_formatter.h"
+#include "file_system/file_system.hpp"
+#include "file_system/path.hpp"
+#include "profiler/profiler.hpp"
+
+namespace Engine
+{
+    namespace
+    {
+        /** used by crash handlers, backend is never destroyed once created */
+        std::atomic<LogBackend*> GLogBackend{ nullptr };
+
+        /**
+         * Non zero on writer thread and while SinkMutex is held. A message logged from there, eg: by file layer when
+         * a sink fails to write, can't lock SinkMutex again, wait for a flush or wait for room in a queue.
+         */
+        thread_local int32 GInsideBackend = 0;
+
+        class InsideBackendScope
+        {
+        public:
+            InsideBackendScope() { ++GInsideBackend; }
+
+            ~InsideBackendScope() { --GInsideBackend; }
+
+            InsideBackendScope(const InsideBackendScope& other) = delete;
+
+            InsideBackendScope& operator= (const InsideBackendScope& other) = delete;
+        };
+    }
+
+    /**
+     * Either a formatted message copied from log_msg or a deferred one made of site and raw arguments.
+     * Buffers are reused, so a warmed up queue doesn't allocate.
+     */
+    struct LogRecord
+    {
+        spdlog::log_clock::time_point Time;
+        spdlog::source_loc Source;
+        size_t ThreadId{ 0 };
+        spdlog::level::level_enum Level{ spdlog::level::off };
+        String LoggerName;
+        String Payload;
+        /** not null for deferred message */
+        const LogSite* Site{ nullptr };
+        Array<uint8> Args;
+
+        void Assign(const spdlog::details::log_msg& msg)
+        {
+            Time = msg.time;
+            Source = msg.source;
+            ThreadId = msg.thread_id;
+            Level = msg.level;
+            LoggerName.Clear();
+            LoggerName.Append(StringView(msg.logger_name.data(), static_cast<int32>(msg.logger_name.size())));
+            Payload.Clear();
+            Payload.Append(StringView(msg.payload.data(), static_cast<int32>(msg.payload.size())));
+            Site = nullptr;
+        }
+
+        void Assign(const LogSite& site, const uint8* args, int32 size)
+        {
+            Time = spdlog::log_clock::now();
+            Source = spdlog::source_loc{ site.File, site.Line, nullptr };
+            ThreadId = spdlog::details::os::thread_id();
+            Level = site.Level;
+            Site = &site;
+            Args.Resize(size);
+            if (size > 0)
+            {
+                std::memcpy(Args.Data(), args, size);
+            }
+        }
+    };
+
+    /**
+     * Bounded lock-free ring written by its owner thread only and read by writer thread only.
+     * Consumer reads in a batch: BeginRead takes a snapshot of what's published, Pop releases slot to producer.
+     */
+    class ThreadLogQueue
+    {
+    public:
+        explicit ThreadLogQueue(int32 capacity)
+            : Mask(static_cast<uint64>(capacity) - 1)
+        {
+            ENSURE((capacity & (capacity - 1)) == 0);
+            Slots.Resize(capacity);
+        }
+
+        template <typename Fill>
+        bool TryPush(Fill& fill)
+        {
+            const uint64 tail = Tail.load(std::memory_order_relaxed);
+            if (tail - Head.load(std::memory_order_acquire) > Mask)
+            {
+                return false;
+            }
+            fill(Slots[static_cast<int32>(tail & Mask)]);
+            Tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        void BeginRead()
+        {
+            ReadCursor = Head.load(std::memory_order_relaxed);
+            ReadEnd = Tail.load(std::memory_order_acquire);
+        }
+
+        const LogRecord* Peek() const
+        {
+            return ReadCursor != ReadEnd ? &Slots[static_cast<int32>(ReadCursor & Mask)] : nullptr;
+        }
+
+        void Pop()
+        {
+            Head.store(++ReadCursor, std::memory_order_release);
+        }
+
+        bool IsEmpty() const { return Head.load(std::memory_order_relaxed) == Tail.load(std::memory_order_acquire); }
+
+        /** set when owner thread exits, queue is removed once it's drained */
+        std::atomic<bool> Orphaned{ false };
+
+    private:
+        Array<LogRecord> Slots;
+        const uint64 Mask;
+        uint64 ReadCursor{ 0 };
+        uint64 ReadEnd{ 0 };
+        alignas(64) std::atomic<uint64> Head{ 0 };
+        alignas(64) std::atomic<uint64> Tail{ 0 };
+    };
+
+    class AsyncLogSink final : public spdlog::sinks::sink
+    {
+    public:
+        explicit AsyncLogSink(LogBackend& backend) : Backend(backend) {}
+
+        void log(const spdlog::details::log_msg& msg) override
+        {
+            Backend.Push(msg);
+            if (msg.level >= spdlog::level::critical)
+            {
+                Backend.Flush();
+            }
+        }
+
+        void flush() override { Backend.Flush(); }
+
+        /** pattern is shared by all categories and set by backend */
+        void set_pattern(const std::string&) override {}
+
+        void set_formatter(std::unique_ptr<spdlog::formatter>) override {}
+
+    private:
+        LogBackend& Backend;
+    };
+
+    /** text log sink appending to a rotating file, only used by writer thread */
+    class RotatingFileSink final : public spdlog::sinks::base_sink<spdlog::details::null_mutex>
+    {
+    public:
+        explicit RotatingFileSink(const String& filePath) : File(filePath) {}
+
+    protected:
+        void sink_it_(const spdlog::details::log_msg& msg) override
+        {
+            spdlog::memory_buf_t formatted;
+            formatter_->format(msg, formatted);
+            File.Write(reinterpret_cast<const uint8*>(formatted.data()), static_cast<int64>(formatted.size()));
+        }
+
+        void flush_() override { File.Flush(); }
+
+    private:
+        RotatingLogFile File;
+    };
+
+    namespace
+    {
+        struct ThreadQueueHolder
+        {
+            SharedPtr<ThreadLogQueue> Queue;
+
+            ~ThreadQueueHolder()
+            {
+                if (Queue != nullptr)
+                {
+                    Queue->Orphaned.store(true, std::memory_order_release);
+                }
+            }
+        };
+
+        thread_local ThreadQueueHolder GThreadQueue;
+    }
+
+    LogBackend& LogBackend::Get()
+    {
+        // leaked on purpose, static objects may still log while being destroyed on exit
+        static LogBackend* backend = new LogBackend();
+        return *backend;
+    }
+
+    LogBackend::LogBackend()
+    {
+        MEMORY_TAG_SCOPE(Log);
+        auto colorSink = std::make_shared<spdlog::sinks::stdout_color_sink_st>();
+#if PLATFORM_WINDOWS
+        colorSink->set_color(spdlog::level::info, 0xffff);
+#endif
+        OutputSinks.Add(colorSink);
+        const String logDir = Path::Combine(FileSystem::GetEngineSaveDir(), "logs");
+        OutputSinks.Add(std::make_shared<RotatingFileSink>(Path::Combine(logDir, "engine_log.txt")));
+        for (auto& sink : OutputSinks)
+        {
+            sink->set_pattern(LogFormatter::TEXT_PATTERN);
+        }
+
+        StructuredWriter = MakeUnique<StructuredLogWriter>(Path::Combine(logDir, "engine_log.jsonl"));
+        if (!StructuredWriter->IsValid())
+        {
+            StructuredWriter.reset();
+        }
+
+        Sink = std::make_shared<AsyncLogSink>(*this);
+        Running.store(true);
+        Writer = std::thread([this]() { Run(); });
+
+        GLogBackend.store(this);
+        std::atexit([]() { LogBackend::Get().Shutdown(); });
+        InstallCrashHandler(&LogBackend::FlushOnCrash);
+    }
+
+    LogBackend::~LogBackend() = default;
+
+    bool LogBackend::OpenBinaryLog(const String& filePath)
+    {
+        Flush();
+        auto writer = MakeUnique<BinaryLogWriter>(filePath);
+        if (!writer->IsValid())
+        {
+            return false;
+        }
+
+        InsideBackendScope insideScope;
+        std::scoped_lock lock(SinkMutex);
+        WriteQueued();
+        BinaryWriter = MoveTemp(writer);
+        return true;
+    }
+
+    void LogBackend::CloseBinaryLog()
+    {
+        InsideBackendScope insideScope;
+        std::scoped_lock lock(SinkMutex);
+        WriteQueued();
+        if (BinaryWriter != nullptr)
+        {
+            BinaryWriter->Flush();
+            BinaryWriter.reset();
+        }
+    }
+
+    bool LogBackend::OpenStructuredLog(const String& filePath, const LogRotationPolicy& policy)
+    {
+        Flush();
+        auto writer = MakeUnique<StructuredLogWriter>(filePath, policy);
+        if (!writer->IsValid())
+        {
+            return false;
+        }
+
+        // old writer is destroyed after lock is released, it waits for archive thread which may log
+        UniquePtr<StructuredLogWriter> oldWriter;
+        InsideBackendScope insideScope;
+        std::scoped_lock lock(SinkMutex);
+        WriteQueued();
+        if (StructuredWriter != nullptr)
+        {
+            StructuredWriter->Flush();
+        }
+        oldWriter = MoveTemp(StructuredWriter);
+        StructuredWriter = MoveTemp(writer);
+        return true;
+    }
+
+    void LogBackend::CloseStructuredLog()
+    {
+        UniquePtr<StructuredLogWriter> oldWriter;
+        InsideBackendScope insideScope;
+        std::scoped_lock lock(SinkMutex);
+        WriteQueued();
+        if (StructuredWriter != nullptr)
+        {
+            StructuredWriter->Flush();
+            oldWriter = MoveTemp(StructuredWriter);
+        }
+    }
+
+    void LogBackend::Flush()
+    {
+        if (GInsideBackend > 0)
+        {
+            // writer thread flushes by itself, and lock holder writes sinks before it releases the lock
+            return;
+        }
+
+        if (Running.load())
+        {
+            std::unique_lock lock(WakeMutex);
+            const uint64 ticket = ++FlushRequest;
+            WakeCondition.notify_one();
+            FlushedCondition.wait(lock, [this, ticket]() { return FlushDone >= ticket || !Running.load(); });
+            if (FlushDone >= ticket)
+            {
+                return;
+            }
+        }
+
+        InsideBackendScope insideScope;
+        std::scoped_lock lock(SinkMutex);
+        WriteQueued();
+        WriteDroppedReport();
+        FlushSinks();
+    }
+
+    void LogBackend::Shutdown()
+    {
+        if (!Running.exchange(false))
+        {
+            return;
+        }
+
+        {
+            std::scoped_lock lock(WakeMutex);
+            Stopping.store(true);
+            WakeCondition.notify_one();
+            FlushedCondition.notify_all();
+        }
+        if (Writer.joinable())
+        {
+            Writer.join();
+        }
+
+        InsideBackendScope insideScope;
+        std::scoped_lock lock(SinkMutex);
+        WriteQueued();
+        WriteDroppedReport();
+        FlushSinks();
+    }
+
+    void LogBackend::FlushOnCrash()
+    {
+        LogBackend* backend = GLogBackend.load();
+        // a thread inside backend may own SinkMutex already, eg: terminate while writing a sink
+        if (backend == nullptr || GInsideBackend > 0)
+        {
+            return;
+        }
+
+        // crashing thread may hold the lock, or writer thread is stuck, so don't wait forever.
+        // on a posix signal it runs on crash handler thread, which never owns the lock already
+        InsideBackendScope insideScope;
+        std::unique_lock lock(backend->SinkMutex, std::defer_lock);
+        for (int32 retry = 0; retry < 200 && !lock.try_lock(); ++retry)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (!lock.owns_lock())
+        {
+            return;
+        }
+        backend->WriteQueued();
+        backend->WriteDroppedReport();
+        backend->FlushSinks();
+    }
+
+    void LogBackend::Push(const spdlog::details::log_msg& msg)
+    {
+        PushRecord(msg.level, [&msg](LogRecord& record) { record.Assign(msg); });
+    }
+
+    void LogBackend::PushDeferred(const LogSite& site, const uint8* args, int32 size)
+    {
+        PushRecord(site.Level, [&](LogRecord& record) { record.Assign(site, args, size); });
+        if (site.Level >= spdlog::level::critical)
+        {
+            Flush();
+        }
+    }
+
+    template <typename Fill>
+    void LogBackend::PushRecord(spdlog::level::level_enum level, Fill&& fill)
+    {
+        if (GInsideBackend > 0)
+        {
+            LogRecord record;
+            fill(record);
+            WriteToStderr(record);
+            DroppedNum.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        if (!Running.load(std::memory_order_acquire))
+        {
+            // writer thread is gone, keep order by writing what's left in queues first
+            LogRecord record;
+            fill(record);
+            InsideBackendScope insideScope;
+            std::scoped_lock lock(SinkMutex);
+            WriteQueued();
+            WriteRecord(record);
+            return;
+        }
+
+        ThreadLogQueue& queue = GetThreadQueue();
+        while (!queue.TryPush(fill))
+        {
+            if (OverflowPolicy.load(std::memory_order_relaxed) == ELogOverflowPolicy::Drop)
+            {
+                DroppedNum.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            Wake();
+            std::this_thread::yield();
+        }
+
+        if (level >= spdlog::level::warn && WriterWaiting.load(std::memory_order_relaxed))
+        {
+            Wake();
+        }
+    }
+
+    ThreadLogQueue& LogBackend::GetThreadQueue()
+    {
+        if (GThreadQueue.Queue == nullptr)
+        {
+            MEMORY_TAG_SCOPE(Log);
+            GThreadQueue.Queue = MakeShared<ThreadLogQueue>(QUEUE_CAPACITY);
+            std::scoped_lock lock(QueuesMutex);
+            Queues.Add(GThreadQueue.Queue);
+        }
+        return *GThreadQueue.Queue;
+    }
+
+    void LogBackend::Run()
+    {
+        MEMORY_TAG_SCOPE(Log);
+        InsideBackendScope insideScope;
+        while (true)
+        {
+            uint64 flushRequest;
+            {
+                std::unique_lock lock(WakeMutex);
+                WriterWaiting.store(true, std::memory_order_relaxed);
+                WakeCondition.wait_for(lock, std::chrono::milliseconds(WRITE_INTERVAL_MS), [this]() {
+                    return Stopping.load() || FlushRequest != FlushDone;
+                });
+                WriterWaiting.store(false, std::memory_order_relaxed);
+                flushRequest = FlushRequest;
+            }
+
+            {
+                PROFILE_SCOPE("LogBackend::Write");
+                std::scoped_lock lock(SinkMutex);
+                const bool written = WriteQueued();
+                WriteDroppedReport();
+                if (written || flushRequest != FlushDone)
+                {
+                    FlushSinks();
+                }
+            }
+
+            {
+                std::scoped_lock lock(WakeMutex);
+                FlushDone = flushRequest;
+                FlushedCondition.notify_all();
+                if (Stopping.load())
+                {
+                    break;
+                }
+            }
+        }
+    }
+
+    bool LogBackend::WriteQueued()
+    {
+        Array<ThreadLogQueue*> readQueues;
+        {
+            std::scoped_lock lock(QueuesMutex);
+            for (int32 index = Queues.Size() - 1; index >= 0; --index)
+            {
+                ThreadLogQueue& queue = *Queues[index];
+                // check orphaned before reading, so nothing pushed before thread exits is missed
+                const bool orphaned = queue.Orphaned.load(std::memory_order_acquire);
+                queue.BeginRead();
+                if (queue.Peek() != nullptr)
+                {
+                    readQueues.Add(&queue);
+                }
+                else if (orphaned)
+                {
+                    Queues.RemoveAt(index);
+                }
+            }
+        }
+
+        // queues are removed only by this function with SinkMutex held, so pointers stay valid after unlock
+        bool written = false;
+        while (true)
+        {
+            ThreadLogQueue* earliest = nullptr;
+            for (ThreadLogQueue* queue : readQueues)
+            {
+                const LogRecord* record = queue->Peek();
+                if (record != nullptr && (earliest == nullptr || record->Time < earliest->Peek()->Time))
+                {
+                    earliest = queue;
+                }
+            }
+            if (earliest == nullptr)
+            {
+                break;
+            }
+
+            WriteRecord(*earliest->Peek());
+            earliest->Pop();
+            written = true;
+        }
+        return written;
+    }
+
+    void LogBackend::WriteRecord(const LogRecord& record)
+    {
+        const int64 time = std::chrono::duration_cast<std::chrono::nanoseconds>(record.Time.time_since_epoch()).count();
+        const bool writeText = BinaryWriter == nullptr || record.Level >= spdlog::level::warn;
+        if (BinaryWriter != nullptr)
+        {
+            if (record.Site != nullptr)
+            {
+                BinaryWriter->WriteMessage(*record.Site, time, record.ThreadId, record.Args.Data(), record.Args.Size());
+            }
+            else
+            {
+                BinaryWriter->WriteText(record.Level, StringView(record.LoggerName.Data(), record.LoggerName.Length()), time,
+                                        record.ThreadId, StringView(record.Payload.Data(), record.Payload.Length()));
+            }
+        }
+        if (!writeText && StructuredWriter == nullptr)
+        {
+            return;
+        }
+
+        // deferred message is formatted once for all outputs
+        spdlog::string_view_t loggerName(record.LoggerName.Data(), record.LoggerName.Length());
+        spdlog::string_view_t payload(record.Payload.Data(), record.Payload.Length());
+        if (record.Site != nullptr)
+        {
+            DecodeBuffer.clear();
+            if (!LogFormatter::Format(*record.Site, record.Args.Data(), record.Args.Size(), DecodeBuffer))
+            {
+                DecodeBuffer.clear();
+                fmt::format_to(fmt::appender(DecodeBuffer), "Format log failed: {0}", record.Site->Format);
+            }
+            loggerName = record.Site->Category;
+            payload = spdlog::string_view_t(DecodeBuffer.data(), DecodeBuffer.size());
+        }
+
+        if (StructuredWriter != nullptr)
+        {
+            StructuredLogRecord structured;
+            structured.Time = time;
+            structured.ThreadId = record.ThreadId;
+            structured.Level = record.Level;
+            structured.Category = StringView(loggerName.data(), static_cast<int32>(loggerName.size()));
+            structured.File = record.Source.filename;
+            structured.Line = record.Source.line;
+            structured.Message = StringView(payload.data(), static_cast<int32>(payload.size()));
+            if (record.Site != nullptr)
+            {
+                structured.Site = record.Site;
+                structured.Args = record.Args.Data();
+                structured.ArgsSize = record.Args.Size();
+            }
+            StructuredWriter->Write(structured);
+        }
+        if (!writeText)
+        {
+            return;
+        }
+
+        spdlog::details::log_msg msg(record.Time, record.Source, loggerName, record.Level, payload);
+        msg.thread_id = record.ThreadId;
+        for (auto& sink : OutputSinks)
+        {
+            if (sink->should_log(msg.level))
+            {
+                sink->log(msg);
+            }
+        }
+    }
+
+    void LogBackend::WriteToStderr(const LogRecord& record)
+    {
+        fmt::memory_buffer buffer;
+        if (record.Site != nullptr)
+        {
+            fmt::format_to(fmt::appender(buffer), "[{0}] ", record.Site->Category);
+            if (!LogFormatter::Format(*record.Site, record.Args.Data(), record.Args.Size(), buffer))
+            {
+                fmt::format_to(fmt::appender(buffer), "Format log failed: {0}", record.Site->Format);
+            }
+        }
+        else
+        {
+            fmt::format_to(fmt::appender(buffer), "[{0}] {1}", std::string_view(record.LoggerName.Data(), record.LoggerName.Length()),
+                           std::string_view(record.Payload.Data(), record.Payload.Length()));
+        }
+        buffer.push_back('\n');
+        std::fwrite(buffer.data(), 1, buffer.size(), stderr);
+    }
+
+    void LogBackend::WriteDroppedReport()
+    {
+        const int64 droppedNum = DroppedNum.load(std::memory_order_relaxed);
+        if (droppedNum == ReportedDroppedNum)
+        {
+            return;
+        }
+
+        const std::string report = fmt::format("{0} log messages are dropped as queue is full or they are logged by log writer", droppedNum - ReportedDroppedNum);
+        ReportedDroppedNum = droppedNum;
+        spdlog::details::log_msg msg(spdlog::source_loc{}, "Log", spdlog::level::warn, report);
+        for (auto& sink : OutputSinks)
+        {
+            sink->log(msg);
+        }
+        if (StructuredWriter != nullptr)
+        {
+            StructuredLogRecord structured;
+            structured.Time = std::chrono::duration_cast<std::chrono::nanoseconds>(msg.time.time_since_epoch()).count();
+            structured.ThreadId = msg.thread_id;
+            structured.Level = msg.level;
+            structured.Category = "Log";
+            structured.Message = StringView(report.data(), static_cast<int32>(report.size()));
+            StructuredWriter->Write(structured);
+        }
+    }
+
+    void LogBackend::FlushSinks()
+    {
+        for (auto& sink : OutputSinks)
+        {
+            sink->flush();
+        }
+        if (BinaryWriter != nullptr)
+        {
+            BinaryWriter->Flush();
+        }
+        if (StructuredWriter != nullptr)
+        {
+            StructuredWriter->Flush();
+        }
+    }
+
+    void LogBackend::Wake()
+    {
+        std::scoped_lock lock(WakeMutex);
+        WakeCondition.notify_one();
+    }
+}
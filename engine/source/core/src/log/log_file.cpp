@@ -0,0 +1,340 @@
+#include <algorithm>
+#include <ctime>
+#include <regex>
+#include "spdlog/details/os.h"
+#include "log/log_file.hpp"
+#include "file_system/file_stream.hpp"
+#include "file_system/file_system.hpp"
+#include "file_system/file_system_log.hpp"
+#include "file_system/path.hpp"
+#include "foundation/compression.hpp"
+#include "foundation/time.hpp"
+
+namespace Engine
+{
+    namespace
+    {
+        constexpr int64 COMPRESS_BLOCK_SIZE = 1 << 20;
+
+        int64 GetNowSeconds()
+        {
+            return PlatformClock::Now().TimeSinceEpoch();
+        }
+
+        String EscapeRegex(StringView text)
+        {
+            String result;
+            for (int32 index = 0; index < text.Length(); ++index)
+            {
+                const char ch = text.Data()[index];
+                if (std::strchr(".^$|()[]{}*+?\\", ch) != nullptr)
+                {
+                    result.Append('\\');
+                }
+                result.Append(ch);
+            }
+            return result;
+        }
+
+        /** rotated files are ordered by time in name, then by number of files rotated in the same second */
+        struct RotatedOrder
+        {
+            std::string Stamp;
+            int32 Index{ 0 };
+
+            bool operator< (const RotatedOrder& other) const
+            {
+                return Stamp != other.Stamp ? Stamp < other.Stamp : Index < other.Index;
+            }
+        };
+
+        RotatedOrder GetRotatedOrder(const String& path)
+        {
+            static const std::regex pattern("\\.([0-9]{8}-[0-9]{6})(-([0-9]+))?(\\.|$)");
+            const StringView fileName = PathView(path).GetFileName();
+            std::cmatch match;
+            RotatedOrder order;
+            if (std::regex_search(fileName.Data(), fileName.Data() + fileName.Length(), match, pattern))
+            {
+                order.Stamp = match[1].str();
+                order.Index = match[3].matched ? std::atoi(match[3].str().c_str()) : 0;
+            }
+            return order;
+        }
+    }
+
+    RotatingLogFile::RotatingLogFile(const String& filePath, const LogRotationPolicy& policy)
+        : FilePath(filePath)
+        , Policy(policy)
+    {
+        Open();
+    }
+
+    RotatingLogFile::~RotatingLogFile()
+    {
+        if (Archiver.joinable())
+        {
+            {
+                std::scoped_lock lock(ArchiveMutex);
+                ArchiveStop = true;
+            }
+            ArchiveCondition.notify_one();
+            Archiver.join();
+        }
+    }
+
+    bool RotatingLogFile::Write(const uint8* data, int64 size)
+    {
+        const bool tooBig = Policy.MaxFileSize > 0 && Size > 0 && Size + size > Policy.MaxFileSize;
+        const bool tooOld = Policy.MaxFileAgeSeconds > 0 && Size > 0 && GetNowSeconds() - OpenTime >= Policy.MaxFileAgeSeconds;
+        if ((tooBig || tooOld) && !Rotate())
+        {
+            return false;
+        }
+        if (Writer == nullptr || !Writer->Write(data, size))
+        {
+            return false;
+        }
+        Size += size;
+        return true;
+    }
+
+    bool RotatingLogFile::Flush(bool toDevice)
+    {
+        return Writer != nullptr && Writer->Flush(toDevice);
+    }
+
+    bool RotatingLogFile::Rotate()
+    {
+        Writer.reset();
+        if (Size > 0)
+        {
+            const String rotatedPath = MakeRotatedPath();
+            if (!FileSystem::MoveFile(FilePath, rotatedPath))
+            {
+                // keep appending to current file rather than losing messages
+                Open();
+                return Writer != nullptr;
+            }
+            Archive(rotatedPath);
+        }
+        return Open();
+    }
+
+    Array<String> RotatingLogFile::GetRotatedFiles(const String& filePath)
+    {
+        const PathView view(filePath);
+        const StringView parentView = view.GetParent();
+        const String parent(parentView.Data(), parentView.Length());
+        const String pattern = EscapeRegex(view.GetStem()) + "\\.[0-9]{8}-[0-9]{6}(-[0-9]+)?" +
+                               EscapeRegex(view.GetExtension()) + "(\\.lz4)?";
+
+        Array<String> files = FileSystem::QueryFiles(parent, pattern, false);
+        std::sort(files.Data(), files.Data() + files.Size(), [](const String& lhs, const String& rhs) {
+            return GetRotatedOrder(lhs) < GetRotatedOrder(rhs);
+        });
+        return files;
+    }
+
+    bool RotatingLogFile::CompressFile(const String& src, const String& dest)
+    {
+        FileReader reader(src, COMPRESS_BLOCK_SIZE);
+        FileWriter writer(dest);
+        if (!reader.IsValid() || !writer.IsValid())
+        {
+            return false;
+        }
+        writer.SetEndian(EEndian::Little);
+        writer.Write(COMPRESSED_MAGIC);
+
+        Array64<uint8> raw;
+        raw.Resize(COMPRESS_BLOCK_SIZE);
+        Array64<uint8> compressed;
+        compressed.Resize(Compression::GetMaxCompressedSize(ECompressionMethod::LZ4, COMPRESS_BLOCK_SIZE));
+        while (true)
+        {
+            const int64 rawSize = reader.Read(raw.Data(), COMPRESS_BLOCK_SIZE);
+            if (rawSize <= 0)
+            {
+                break;
+            }
+            const int64 compressedSize = Compression::Compress(ECompressionMethod::LZ4, compressed.Data(), compressed.Size(),
+                                                               raw.Data(), rawSize);
+            if (compressedSize < 0)
+            {
+                return false;
+            }
+            writer.Write(static_cast<uint32>(rawSize));
+            writer.Write(static_cast<uint32>(compressedSize));
+            writer.Write(compressed.Data(), compressedSize);
+        }
+        return !reader.HasError() && writer.Flush() && !writer.HasError();
+    }
+
+    bool RotatingLogFile::ReadFile(const String& path, Array64<uint8>& outData)
+    {
+        outData.Clear();
+        if (!path.EndsWith(StringView(COMPRESSED_EXTENSION)))
+        {
+            if (!FileSystem::FileExists(path))
+            {
+                return false;
+            }
+            FileSystem::ReadFileToBinary(path, outData);
+            return true;
+        }
+
+        FileReader reader(path, COMPRESS_BLOCK_SIZE);
+        if (!reader.IsValid())
+        {
+            return false;
+        }
+        reader.SetEndian(EEndian::Little);
+        uint32 magic;
+        if (!reader.Read(magic) || magic != COMPRESSED_MAGIC)
+        {
+            return false;
+        }
+
+        Array64<uint8> compressed;
+        uint32 rawSize, compressedSize;
+        while (reader.Read(rawSize))
+        {
+            if (!reader.Read(compressedSize) || rawSize > COMPRESS_BLOCK_SIZE ||
+                compressedSize > Compression::GetMaxCompressedSize(ECompressionMethod::LZ4, COMPRESS_BLOCK_SIZE))
+            {
+                return false;
+            }
+            compressed.Resize(compressedSize);
+            if (reader.Read(compressed.Data(), compressedSize) != compressedSize)
+            {
+                return false;
+            }
+            const int64 offset = outData.Size();
+            outData.Resize(offset + rawSize);
+            if (!Compression::Decompress(ECompressionMethod::LZ4, outData.Data() + offset, rawSize, compressed.Data(), compressedSize))
+            {
+                return false;
+            }
+        }
+        return !reader.HasError();
+    }
+
+    bool RotatingLogFile::Open()
+    {
+        const PathView view(FilePath);
+        if (view.GetParent().Length() > 0)
+        {
+            FileSystem::MakeDirTree(String(view.GetParent().Data(), view.GetParent().Length()));
+        }
+
+        Writer = MakeUnique<FileWriter>(FilePath, FileWriter::DEFAULT_BUFFER_SIZE, true);
+        if (!Writer->IsValid())
+        {
+            Writer.reset();
+            return false;
+        }
+        Size = Writer->Tell();
+        OpenTime = GetNowSeconds();
+        return true;
+    }
+
+    String RotatingLogFile::MakeRotatedPath() const
+    {
+        const PathView view(FilePath);
+        const std::tm time = spdlog::details::os::gmtime(static_cast<std::time_t>(GetNowSeconds()));
+        const std::string stamp = fmt::format("{:04}{:02}{:02}-{:02}{:02}{:02}", time.tm_year + 1900, time.tm_mon + 1,
+                                              time.tm_mday, time.tm_hour, time.tm_min, time.tm_sec);
+
+        String prefix(view.GetParent().Data(), view.GetParent().Length());
+        if (!prefix.Empty())
+        {
+            prefix.Append('/');
+        }
+        prefix.Append(view.GetStem());
+        prefix.Append('.');
+        prefix.Append(stamp.c_str());
+
+        // number it after the newest file rotated in the same second, so order holds once older ones are removed
+        int32 index = 0;
+        for (const String& file : GetRotatedFiles(FilePath))
+        {
+            const RotatedOrder order = GetRotatedOrder(file);
+            if (order.Stamp == stamp)
+            {
+                index = std::max(index, order.Index + 1);
+            }
+        }
+
+        const String extension(view.GetExtension().Data(), view.GetExtension().Length());
+        return index == 0 ? prefix + extension : prefix + "-" + String(std::to_string(index).c_str()) + extension;
+    }
+
+    void RotatingLogFile::Archive(const String& rotatedPath)
+    {
+        if (!Policy.Compress && Policy.MaxRotatedFiles <= 0)
+        {
+            return;
+        }
+
+        {
+            std::scoped_lock lock(ArchiveMutex);
+            ArchiveQueue.Add(rotatedPath);
+        }
+        if (Archiver.joinable())
+        {
+            ArchiveCondition.notify_one();
+        }
+        else
+        {
+            Archiver = std::thread(&RotatingLogFile::RunArchiver, this);
+        }
+    }
+
+    void RotatingLogFile::RunArchiver()
+    {
+        while (true)
+        {
+            String rotatedPath;
+            {
+                std::unique_lock lock(ArchiveMutex);
+                ArchiveCondition.wait(lock, [this]() { return ArchiveStop || ArchiveQueue.Size() > 0; });
+                if (ArchiveQueue.Size() == 0)
+                {
+                    return;
+                }
+                rotatedPath = MoveTemp(ArchiveQueue[0]);
+                ArchiveQueue.RemoveAt(0);
+            }
+
+            // it's removed already if files are rotated faster than they are compressed
+            if (Policy.Compress && FileSystem::FileExists(rotatedPath))
+            {
+                const String compressedPath = rotatedPath + COMPRESSED_EXTENSION;
+                if (CompressFile(rotatedPath, compressedPath))
+                {
+                    FileSystem::RemoveFile(rotatedPath);
+                }
+                else
+                {
+                    FileSystem::RemoveFile(compressedPath);
+                    LOG_WARN(FileSystem, "Compress rotated log {0} failed, it's kept uncompressed", rotatedPath.Data());
+                }
+            }
+            RemoveOldFiles();
+        }
+    }
+
+    void RotatingLogFile::RemoveOldFiles()
+    {
+        if (Policy.MaxRotatedFiles <= 0)
+        {
+            return;
+        }
+        const Array<String> files = GetRotatedFiles(FilePath);
+        for (int32 index = 0; index < files.Size() - Policy.MaxRotatedFiles; ++index)
+        {
+            FileSystem::RemoveFile(files[index]);
+        }
+    }
+}
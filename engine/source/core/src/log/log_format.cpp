@@ -0,0 +1,278 @@
+#include "fmt/args.h"
+#include "spdlog/pattern_formatter.h"
+#include "log/log_format.hpp"
+
+namespace Engine
+{
+    namespace
+    {
+        template <typename T>
+        bool ReadValue(const uint8*& cursor, const uint8* end, T& outValue)
+        {
+            if (end - cursor < static_cast<ptrdiff_t>(sizeof(T)))
+            {
+                return false;
+            }
+            std::memcpy(&outValue, cursor, sizeof(T));
+            cursor += sizeof(T);
+            return true;
+        }
+
+        template <typename T>
+        void PushArg(fmt::dynamic_format_arg_store<fmt::format_context>& store, const LogArgValue& value, const T& arg)
+        {
+            if (value.Name.empty())
+            {
+                store.push_back(arg);
+            }
+            else
+            {
+                // name is followed by '\0' in args, which are kept while formatting
+                store.push_back(fmt::arg(value.Name.data(), arg));
+            }
+        }
+    }
+
+    bool LogArgReader::Next(LogArgValue& outValue)
+    {
+        if (Error || Index >= ArgNum)
+        {
+            return false;
+        }
+
+        const ELogArgType type = ArgTypes[Index++];
+        outValue.Name = std::string_view();
+        if (IsNamedLogArgType(type))
+        {
+            // name must be followed by '\0'
+            if (!ReadString(outValue.Name) || Cursor >= End || *Cursor != 0)
+            {
+                Error = true;
+                return false;
+            }
+            ++Cursor;
+        }
+
+        outValue.Type = GetLogArgValueType(type);
+        bool succeed = false;
+        switch (outValue.Type)
+        {
+            case ELogArgType::Bool:
+            {
+                uint8 value;
+                succeed = ReadValue(Cursor, End, value);
+                outValue.Bool = value != 0;
+                break;
+            }
+            case ELogArgType::Char:
+                succeed = ReadValue(Cursor, End, outValue.Char);
+                break;
+            case ELogArgType::Int32:
+            {
+                int32 value;
+                succeed = ReadValue(Cursor, End, value);
+                outValue.Int = value;
+                break;
+            }
+            case ELogArgType::UInt32:
+            {
+                uint32 value;
+                succeed = ReadValue(Cursor, End, value);
+                outValue.UInt = value;
+                break;
+            }
+            case ELogArgType::Int64:
+                succeed = ReadValue(Cursor, End, outValue.Int);
+                break;
+            case ELogArgType::UInt64:
+                succeed = ReadValue(Cursor, End, outValue.UInt);
+                break;
+            case ELogArgType::Float:
+            {
+                float value;
+                succeed = ReadValue(Cursor, End, value);
+                outValue.Float = value;
+                break;
+            }
+            case ELogArgType::Double:
+                succeed = ReadValue(Cursor, End, outValue.Float);
+                break;
+            case ELogArgType::String:
+                succeed = ReadString(outValue.Str);
+                break;
+            case ELogArgType::Pointer:
+            {
+                uint64 value;
+                succeed = ReadValue(Cursor, End, value);
+                outValue.Pointer = reinterpret_cast<const void*>(static_cast<uintptr_t>(value));
+                break;
+            }
+            default:
+                break;
+        }
+
+        Error = !succeed;
+        return succeed;
+    }
+
+    bool LogArgReader::ReadString(std::string_view& outStr)
+    {
+        uint32 length;
+        if (!ReadValue(Cursor, End, length) || End - Cursor < static_cast<ptrdiff_t>(length))
+        {
+            return false;
+        }
+        outStr = std::string_view(reinterpret_cast<const char*>(Cursor), length);
+        Cursor += length;
+        return true;
+    }
+
+    bool LogFormatter::Format(const char* format, const ELogArgType* argTypes, int32 argNum, const uint8* args, int32 size,
+                              fmt::memory_buffer& out)
+    {
+        fmt::dynamic_format_arg_store<fmt::format_context> store;
+        store.reserve(argNum, 0);
+
+        // original types are kept, so format specs like {:x} or float precision give the same text as formatting directly
+        LogArgReader reader(argTypes, argNum, args, size);
+        LogArgValue value;
+        while (reader.Next(value))
+        {
+            switch (value.Type)
+            {
+                case ELogArgType::Bool:
+                    PushArg(store, value, value.Bool);
+                    break;
+                case ELogArgType::Char:
+                    PushArg(store, value, value.Char);
+                    break;
+                case ELogArgType::Int32:
+                    PushArg(store, value, static_cast<int32>(value.Int));
+                    break;
+                case ELogArgType::UInt32:
+                    PushArg(store, value, static_cast<uint32>(value.UInt));
+                    break;
+                case ELogArgType::Int64:
+                    PushArg(store, value, value.Int);
+                    break;
+                case ELogArgType::UInt64:
+                    PushArg(store, value, value.UInt);
+                    break;
+                case ELogArgType::Float:
+                    PushArg(store, value, static_cast<float>(value.Float));
+                    break;
+                case ELogArgType::Double:
+                    PushArg(store, value, value.Float);
+                    break;
+                case ELogArgType::String:
+                    PushArg(store, value, fmt::string_view(value.Str.data(), value.Str.size()));
+                    break;
+                case ELogArgType::Pointer:
+                    PushArg(store, value, value.Pointer);
+                    break;
+                default:
+                    break;
+            }
+        }
+        if (!reader.IsFinished())
+        {
+            return false;
+        }
+
+        try
+        {
+            fmt::vformat_to(fmt::appender(out), fmt::string_view(format), store);
+        }
+        catch (const fmt::format_error&)
+        {
+            return false;
+        }
+        return true;
+    }
+
+    void LogFormatter::FormatText(const LogEntry& entry, spdlog::memory_buf_t& out)
+    {
+        thread_local spdlog::pattern_formatter formatter(TEXT_PATTERN);
+        thread_local String payload;
+
+        payload = entry.Message;
+        for (int32 index = 0; index < entry.Fields.Size(); ++index)
+        {
+            payload.Append(index == 0 ? " {" : ", ");
+            payload.Append(entry.Fields[index].Key);
+            payload.Append('=');
+            payload.Append(entry.Fields[index].Value);
+        }
+        if (entry.Fields.Size() > 0)
+        {
+            payload.Append('}');
+        }
+
+        const auto time = spdlog::log_clock::time_point(
+            std::chrono::duration_cast<spdlog::log_clock::duration>(std::chrono::nanoseconds(entry.Time)));
+        spdlog::source_loc source(entry.File.Empty() ? nullptr : entry.File.Data(), entry.Line, nullptr);
+        spdlog::details::log_msg msg(time, source, spdlog::string_view_t(entry.Category.Data(), entry.Category.Length()),
+                                     entry.Level, spdlog::string_view_t(payload.Data(), payload.Length()));
+        msg.thread_id = static_cast<size_t>(entry.ThreadId);
+        formatter.format(msg, out);
+    }
+
+    void LogFormatter::FormatValue(const LogArgValue& value, fmt::memory_buffer& out)
+    {
+        auto output = fmt::appender(out);
+        switch (value.Type)
+        {
+            case ELogArgType::Bool:
+                fmt::format_to(output, "{}", value.Bool);
+                break;
+            case ELogArgType::Char:
+                fmt::format_to(output, "{}", value.Char);
+                break;
+            case ELogArgType::Int32:
+            case ELogArgType::Int64:
+                fmt::format_to(output, "{}", value.Int);
+                break;
+            case ELogArgType::UInt32:
+            case ELogArgType::UInt64:
+                fmt::format_to(output, "{}", value.UInt);
+                break;
+            case ELogArgType::Float:
+                fmt::format_to(output, "{}", static_cast<float>(value.Float));
+                break;
+            case ELogArgType::Double:
+                fmt::format_to(output, "{}", value.Float);
+                break;
+            case ELogArgType::String:
+                out.append(value.Str.data(), value.Str.data() + value.Str.size());
+                break;
+            case ELogArgType::Pointer:
+                fmt::format_to(output, "{}", value.Pointer);
+                break;
+            default:
+                break;
+        }
+    }
+
+    bool LogFormatter::ReadFields(const ELogArgType* argTypes, int32 argNum, const uint8* args, int32 size,
+                                  Array<LogEntryField>& outFields)
+    {
+        outFields.Clear();
+        fmt::memory_buffer buffer;
+        LogArgReader reader(argTypes, argNum, args, size);
+        LogArgValue value;
+        while (reader.Next(value))
+        {
+            if (value.Name.empty())
+            {
+                continue;
+            }
+            buffer.clear();
+            FormatValue(value, buffer);
+            LogEntryField field;
+            field.Key = String(value.Name.data(), static_cast<int32>(value.Name.size()));
+            field.Value = String(buffer.data(), static_cast<int32>(buffer.size()));
+            outFields.Add(MoveTemp(field));
+        }
+        return reader.IsFinished();
+    }
+}
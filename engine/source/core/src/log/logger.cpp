@@ -0,0 +1,81 @@
+#include "log/logger.hpp"
+
+namespace Engine
+{
+    namespace
+    {
+        struct CategoryLevel
+        {
+            const char* Name;
+            std::atomic<int32>* Level;
+        };
+
+        struct CategoryLevels
+        {
+            std::mutex Mutex;
+            /** a category declared in a header has a copy in every module including it */
+            Array<CategoryLevel> Levels;
+        };
+
+        CategoryLevels& GetCategoryLevels()
+        {
+            static CategoryLevels levels;
+            return levels;
+        }
+    }
+
+    void LogCategoryRegistry::Register(const char* name, std::atomic<int32>& level)
+    {
+        CategoryLevels& levels = GetCategoryLevels();
+        std::scoped_lock lock(levels.Mutex);
+        levels.Levels.Add(CategoryLevel{ name, &level });
+    }
+
+    void LogCategoryRegistry::Unregister(std::atomic<int32>& level)
+    {
+        CategoryLevels& levels = GetCategoryLevels();
+        std::scoped_lock lock(levels.Mutex);
+        for (int32 index = levels.Levels.Size() - 1; index >= 0; --index)
+        {
+            if (levels.Levels[index].Level == &level)
+            {
+                levels.Levels.RemoveAt(index);
+            }
+        }
+    }
+
+    bool LogCategoryRegistry::SetLevel(StringView name, ELogLevel level)
+    {
+        CategoryLevels& levels = GetCategoryLevels();
+        std::scoped_lock lock(levels.Mutex);
+        bool found = false;
+        for (auto& category : levels.Levels)
+        {
+            const StringView categoryName(category.Name);
+            if (CharTraits<char>::Compare(name.Data(), name.Length(), categoryName.Data(), categoryName.Length(), CaseInsensitive) == 0)
+            {
+                category.Level->store(level, std::memory_order_relaxed);
+                found = true;
+            }
+        }
+        return found;
+    }
+
+    void LogCategoryRegistry::SetAllLevels(ELogLevel level)
+    {
+        CategoryLevels& levels = GetCategoryLevels();
+        std::scoped_lock lock(levels.Mutex);
+        for (auto& category : levels.Levels)
+        {
+            category.Level->store(level, std::memory_order_relaxed);
+        }
+    }
+
+    spdlog::logger* LogSystem::CreateLogger(const char* name)
+    {
+        auto* logger = new spdlog::logger(name, LogBackend::Get().GetSink());
+        // level is checked by log macros already
+        logger->set_level(spdlog::level::trace);
+        return logger;
+    }
+}
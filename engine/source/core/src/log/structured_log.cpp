@@ -0,0 +1,464 @@
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include "spdlog/details/os.h"
+#include "log/structured_log.hpp"
+#include "file_system/path.hpp"
+
+namespace Engine
+{
+    namespace
+    {
+        constexpr int64 NANOSECONDS_PER_SECOND = 1000000000;
+
+        void AppendText(fmt::memory_buffer& out, std::string_view text)
+        {
+            out.append(text.data(), text.data() + text.size());
+        }
+
+        void AppendJsonString(fmt::memory_buffer& out, std::string_view text)
+        {
+            out.push_back('"');
+            for (const char ch : text)
+            {
+                switch (ch)
+                {
+                    case '"':
+                        AppendText(out, "\\\"");
+                        break;
+                    case '\\':
+                        AppendText(out, "\\\\");
+                        break;
+                    case '\n':
+                        AppendText(out, "\\n");
+                        break;
+                    case '\r':
+                        AppendText(out, "\\r");
+                        break;
+                    case '\t':
+                        AppendText(out, "\\t");
+                        break;
+                    default:
+                        if (static_cast<uint8>(ch) < 0x20)
+                        {
+                            fmt::format_to(fmt::appender(out), "\\u{:04x}", static_cast<uint32>(ch));
+                        }
+                        else
+                        {
+                            out.push_back(ch);
+                        }
+                        break;
+                }
+            }
+            out.push_back('"');
+        }
+
+        void AppendJsonValue(fmt::memory_buffer& out, fmt::memory_buffer& scratch, const LogArgValue& value)
+        {
+            switch (value.Type)
+            {
+                case ELogArgType::Bool:
+                    AppendText(out, value.Bool ? "true" : "false");
+                    break;
+                case ELogArgType::Int32:
+                case ELogArgType::Int64:
+                    fmt::format_to(fmt::appender(out), "{}", value.Int);
+                    break;
+                case ELogArgType::UInt32:
+                case ELogArgType::UInt64:
+                    fmt::format_to(fmt::appender(out), "{}", value.UInt);
+                    break;
+                case ELogArgType::Float:
+                case ELogArgType::Double:
+                    if (std::isfinite(value.Float))
+                    {
+                        LogFormatter::FormatValue(value, out);
+                        break;
+                    }
+                    // JSON has no nan or inf, write them as string
+                    [[fallthrough]];
+                default:
+                    scratch.clear();
+                    LogFormatter::FormatValue(value, scratch);
+                    AppendJsonString(out, std::string_view(scratch.data(), scratch.size()));
+                    break;
+            }
+        }
+
+        /** days since 1970-01-01 of a civil date */
+        int64 DaysFromCivil(int64 year, int64 month, int64 day)
+        {
+            year -= month <= 2 ? 1 : 0;
+            const int64 era = (year >= 0 ? year : year - 399) / 400;
+            const int64 yearOfEra = year - era * 400;
+            const int64 dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+            const int64 dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+            return era * 146097 + dayOfEra - 719468;
+        }
+
+        /** parse time written by writer, eg: 2022-06-01T08:00:00.123456Z */
+        bool ParseTime(std::string_view text, int64& outTime)
+        {
+            int32 year, month, day, hour, minute, second;
+            if (text.size() < 20 || std::sscanf(std::string(text.substr(0, 19)).c_str(), "%4d-%2d-%2dT%2d:%2d:%2d", &year,
+                                                &month, &day, &hour, &minute, &second) != 6)
+            {
+                return false;
+            }
+
+            int64 fraction = 0;
+            int64 scale = NANOSECONDS_PER_SECOND;
+            size_t index = 19;
+            if (text[index] == '.')
+            {
+                for (++index; index < text.size() && text[index] >= '0' && text[index] <= '9'; ++index)
+                {
+                    if (scale > 1)
+                    {
+                        scale /= 10;
+                        fraction += (text[index] - '0') * scale;
+                    }
+                }
+            }
+            if (index >= text.size() || text[index] != 'Z')
+            {
+                return false;
+            }
+
+            const int64 seconds = DaysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second;
+            outTime = seconds * NANOSECONDS_PER_SECOND + fraction;
+            return true;
+        }
+
+        /** minimal JSON reader for lines written by StructuredLogWriter */
+        class JsonLineParser
+        {
+        public:
+            explicit JsonLineParser(std::string_view text) : Text(text) {}
+
+            bool ParseEntry(LogEntry& outEntry)
+            {
+                outEntry = LogEntry();
+                bool hasTime = false, hasMessage = false;
+                if (!Expect('{'))
+                {
+                    return false;
+                }
+                if (Peek() == '}')
+                {
+                    return false;
+                }
+
+                do
+                {
+                    std::string key;
+                    if (!ParseString(key) || !Expect(':'))
+                    {
+                        return false;
+                    }
+
+                    if (key == "fields")
+                    {
+                        if (!ParseFields(outEntry.Fields))
+                        {
+                            return false;
+                        }
+                        continue;
+                    }
+
+                    std::string value;
+                    bool quoted;
+                    if (!ParseScalar(value, quoted))
+                    {
+                        return false;
+                    }
+                    if (key == "time")
+                    {
+                        hasTime = quoted && ParseTime(value, outEntry.Time);
+                    }
+                    else if (key == "thread")
+                    {
+                        outEntry.ThreadId = std::strtoull(value.c_str(), nullptr, 10);
+                    }
+                    else if (key == "level")
+                    {
+                        outEntry.Level = spdlog::level::from_str(value);
+                    }
+                    else if (key == "category")
+                    {
+                        outEntry.Category = ToString(value);
+                    }
+                    else if (key == "file")
+                    {
+                        outEntry.File = ToString(value);
+                    }
+                    else if (key == "line")
+                    {
+                        outEntry.Line = static_cast<int32>(std::strtol(value.c_str(), nullptr, 10));
+                    }
+                    else if (key == "message")
+                    {
+                        outEntry.Message = ToString(value);
+                        hasMessage = true;
+                    }
+                    // unknown keys are ignored, so newer writers can add keys
+                }
+                while (Accept(','));
+
+                return Expect('}') && SkipSpace() == Text.size() && hasTime && hasMessage;
+            }
+
+        private:
+            static String ToString(const std::string& str)
+            {
+                return str.empty() ? String() : String(str.data(), static_cast<int32>(str.size()));
+            }
+
+            size_t SkipSpace()
+            {
+                while (Cursor < Text.size() && (Text[Cursor] == ' ' || Text[Cursor] == '\t' || Text[Cursor] == '\r'))
+                {
+                    ++Cursor;
+                }
+                return Cursor;
+            }
+
+            char Peek()
+            {
+                SkipSpace();
+                return Cursor < Text.size() ? Text[Cursor] : '\0';
+            }
+
+            bool Accept(char ch)
+            {
+                if (Peek() == ch)
+                {
+                    ++Cursor;
+                    return true;
+                }
+                return false;
+            }
+
+            bool Expect(char ch)
+            {
+                return Accept(ch);
+            }
+
+            bool ParseFields(Array<LogEntryField>& outFields)
+            {
+                if (!Expect('{'))
+                {
+                    return false;
+                }
+                if (Accept('}'))
+                {
+                    return true;
+                }
+                do
+                {
+                    std::string key, value;
+                    bool quoted;
+                    if (!ParseString(key) || !Expect(':') || !ParseScalar(value, quoted))
+                    {
+                        return false;
+                    }
+                    LogEntryField field;
+                    field.Key = ToString(key);
+                    field.Value = ToString(value);
+                    outFields.Add(MoveTemp(field));
+                }
+                while (Accept(','));
+                return Expect('}');
+            }
+
+            bool ParseScalar(std::string& outValue, bool& outQuoted)
+            {
+                outQuoted = Peek() == '"';
+                if (outQuoted)
+                {
+                    return ParseString(outValue);
+                }
+
+                const size_t start = Cursor;
+                while (Cursor < Text.size() && Text[Cursor] != ',' && Text[Cursor] != '}' && Text[Cursor] != ' ')
+                {
+                    ++Cursor;
+                }
+                outValue.assign(Text.substr(start, Cursor - start));
+                return !outValue.empty();
+            }
+
+            bool ParseString(std::string& outStr)
+            {
+                outStr.clear();
+                if (!Expect('"'))
+                {
+                    return false;
+                }
+                while (Cursor < Text.size())
+                {
+                    const char ch = Text[Cursor++];
+                    if (ch == '"')
+                    {
+                        return true;
+                    }
+                    if (ch != '\\')
+                    {
+                        outStr.push_back(ch);
+                        continue;
+                    }
+                    if (Cursor >= Text.size())
+                    {
+                        return false;
+                    }
+                    const char escaped = Text[Cursor++];
+                    switch (escaped)
+                    {
+                        case 'n':
+                            outStr.push_back('\n');
+                            break;
+                        case 'r':
+                            outStr.push_back('\r');
+                            break;
+                        case 't':
+                            outStr.push_back('\t');
+                            break;
+                        case 'b':
+                            outStr.push_back('\b');
+                            break;
+                        case 'f':
+                            outStr.push_back('\f');
+                            break;
+                        case 'u':
+                        {
+                            if (Text.size() - Cursor < 4)
+                            {
+                                return false;
+                            }
+                            const uint32 code = static_cast<uint32>(std::strtoul(std::string(Text.substr(Cursor, 4)).c_str(), nullptr, 16));
+                            Cursor += 4;
+                            // writer only escapes control characters, others are encoded as utf-8 for completeness
+                            if (code < 0x80)
+                            {
+                                outStr.push_back(static_cast<char>(code));
+                            }
+                            else if (code < 0x800)
+                            {
+                                outStr.push_back(static_cast<char>(0xC0 | (code >> 6)));
+                                outStr.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+                            }
+                            else
+                            {
+                                outStr.push_back(static_cast<char>(0xE0 | (code >> 12)));
+                                outStr.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+                                outStr.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+                            }
+                            break;
+                        }
+                        default:
+                            outStr.push_back(escaped);
+                            break;
+                    }
+                }
+                return false;
+            }
+
+            std::string_view Text;
+            size_t Cursor{ 0 };
+        };
+    }
+
+    StructuredLogWriter::StructuredLogWriter(const String& filePath, const LogRotationPolicy& policy)
+        : File(filePath, policy)
+    {}
+
+    void StructuredLogWriter::Write(const StructuredLogRecord& record)
+    {
+        Line.clear();
+        auto output = fmt::appender(Line);
+
+        const int64 seconds = record.Time >= 0 ? record.Time / NANOSECONDS_PER_SECOND : (record.Time + 1) / NANOSECONDS_PER_SECOND - 1;
+        const int64 microseconds = (record.Time - seconds * NANOSECONDS_PER_SECOND) / 1000;
+        const std::tm time = spdlog::details::os::gmtime(static_cast<std::time_t>(seconds));
+        fmt::format_to(output, "{{\"time\":\"{:04}-{:02}-{:02}T{:02}:{:02}:{:02}.{:06}Z\",\"thread\":{},\"level\":",
+                       time.tm_year + 1900, time.tm_mon + 1, time.tm_mday, time.tm_hour, time.tm_min, time.tm_sec,
+                       microseconds, record.ThreadId);
+        const spdlog::string_view_t level = spdlog::level::to_string_view(record.Level);
+        AppendJsonString(Line, std::string_view(level.data(), level.size()));
+
+        AppendText(Line, ",\"category\":");
+        AppendJsonString(Line, std::string_view(record.Category.Data(), record.Category.Length()));
+        if (record.File != nullptr)
+        {
+            const StringView fileName = PathView(record.File).GetFileName();
+            AppendText(Line, ",\"file\":");
+            AppendJsonString(Line, std::string_view(fileName.Data(), fileName.Length()));
+            fmt::format_to(output, ",\"line\":{}", record.Line);
+        }
+        AppendText(Line, ",\"message\":");
+        AppendJsonString(Line, std::string_view(record.Message.Data(), record.Message.Length()));
+
+        if (record.Site != nullptr)
+        {
+            bool hasField = false;
+            LogArgReader reader(record.Site->ArgTypes, record.Site->ArgNum, record.Args, record.ArgsSize);
+            LogArgValue value;
+            while (reader.Next(value))
+            {
+                if (value.Name.empty())
+                {
+                    continue;
+                }
+                AppendText(Line, hasField ? "," : ",\"fields\":{");
+                AppendJsonString(Line, value.Name);
+                Line.push_back(':');
+                AppendJsonValue(Line, Value, value);
+                hasField = true;
+            }
+            if (hasField)
+            {
+                Line.push_back('}');
+            }
+        }
+        AppendText(Line, "}\n");
+
+        File.Write(reinterpret_cast<const uint8*>(Line.data()), static_cast<int64>(Line.size()));
+    }
+
+    StructuredLogReader::StructuredLogReader(const String& filePath)
+    {
+        Valid = RotatingLogFile::ReadFile(filePath, Data);
+    }
+
+    bool StructuredLogReader::Next(LogEntry& outEntry)
+    {
+        const char* text = reinterpret_cast<const char*>(Data.Data());
+        while (Cursor < Data.Size())
+        {
+            int64 end = Cursor;
+            while (end < Data.Size() && text[end] != '\n')
+            {
+                ++end;
+            }
+            const StringView line(text + Cursor, static_cast<int32>(end - Cursor));
+            Cursor = end + 1;
+
+            if (line.Length() == 0)
+            {
+                continue;
+            }
+            if (ParseLine(line, outEntry))
+            {
+                return true;
+            }
+            // a line cut by crash or a foreign line, keep reading rest of log
+            ++MalformedLineNum;
+        }
+        return false;
+    }
+
+    bool StructuredLogReader::ParseLine(StringView line, LogEntry& outEntry)
+    {
+        return JsonLineParser(std::string_view(line.Data(), line.Length())).ParseEntry(outEntry);
+    }
+}
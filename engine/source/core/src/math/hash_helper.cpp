@@ -1,8 +1,54 @@
 //#include "precompiled_core.hpp"
 #include "math/hash_helper.hpp"
+#include "math/hash_kernels.hpp"
+#include "misc/cpu_features.hpp"
 
 namespace Engine
 {
+    namespace
+    {
+        constexpr uint32 CRC32C_POLYNOMIAL = 0x82F63B78u;
+
+        struct Crc32cTable
+        {
+            constexpr Crc32cTable()
+            {
+                for (uint32 i = 0; i < 256; ++i)
+                {
+                    uint32 crc = i;
+                    for (int32 bit = 0; bit < 8; ++bit)
+                    {
+                        crc = (crc >> 1) ^ ((crc & 1) ? CRC32C_POLYNOMIAL : 0);
+                    }
+                    Entries[i] = crc;
+                }
+            }
+
+            uint32 Entries[256]{};
+        };
+
+        constexpr Crc32cTable GCrc32cTable;
+
+        uint32 Crc32cScalar(const uint8* data, size_t size, uint32 crc)
+        {
+            for (; size > 0; --size, ++data)
+            {
+                crc = GCrc32cTable.Entries[(crc ^ *data) & 0xFF] ^ (crc >> 8);
+            }
+            return crc;
+        }
+
+        Crc32cKernel SelectCrc32cKernel()
+        {
+            Crc32cKernel kernel = GetSse42Crc32cKernel();
+            if (kernel != nullptr && CpuFeatures::HasFeature(ECpuFeature::Sse42))
+            {
+                return kernel;
+            }
+            return &Crc32cScalar;
+        }
+    }
+
     uint64 HashHelper::FnvHash(const char* str, uint64 n) noexcept
     {
         static uint64 fnvOffset = 14695981039346656037ull;
@@ -19,4 +65,10 @@ namespace Engine
     {
         return FnvHash(str.Data(), str.Length());
     }
+
+    uint32 HashHelper::Crc32c(const void* data, size_t size, uint32 crc) noexcept
+    {
+        static const Crc32cKernel kernel = SelectCrc32cKernel();
+        return ~kernel(static_cast<const uint8*>(data), size, ~crc);
+    }
 }
\ No newline at end of file
@@ -0,0 +1,66 @@
+#include <cstring>
+#include "math/hash_kernels.hpp"
+
+#if SUPPORT_SSE2
+
+// everything after this point may use sse4.2, hash helper only calls into it after checking cpu supports it
+#if defined(COMPILER_GNUC)
+#pragma GCC target("sse4.2")
+#elif defined(COMPILER_CLANG) || defined(COMPILER_APPLECLANG)
+#pragma clang attribute push (__attribute__((target("sse4.2"))), apply_to = function)
+#endif
+
+#include <nmmintrin.h>
+
+namespace Engine
+{
+    namespace
+    {
+        /** crc is already inverted by caller */
+        uint32 Crc32cSse42(const uint8* data, size_t size, uint32 crc)
+        {
+#if defined(__x86_64__) || defined(_M_X64)
+            uint64 crc64 = crc;
+            for (; size >= sizeof(uint64); size -= sizeof(uint64), data += sizeof(uint64))
+            {
+                uint64 value;
+                std::memcpy(&value, data, sizeof(uint64));
+                crc64 = _mm_crc32_u64(crc64, value);
+            }
+            crc = static_cast<uint32>(crc64);
+#endif
+            for (; size >= sizeof(uint32); size -= sizeof(uint32), data += sizeof(uint32))
+            {
+                uint32 value;
+                std::memcpy(&value, data, sizeof(uint32));
+                crc = _mm_crc32_u32(crc, value);
+            }
+            for (; size > 0; --size, ++data)
+            {
+                crc = _mm_crc32_u8(crc, *data);
+            }
+            return crc;
+        }
+    }
+
+    Crc32cKernel GetSse42Crc32cKernel()
+    {
+        return &Crc32cSse42;
+    }
+}
+
+#if defined(COMPILER_CLANG) || defined(COMPILER_APPLECLANG)
+#pragma clang attribute pop
+#endif
+
+#else
+
+namespace Engine
+{
+    Crc32cKernel GetSse42Crc32cKernel()
+    {
+        return nullptr;
+    }
+}
+
+#endif
\ No newline at end of file
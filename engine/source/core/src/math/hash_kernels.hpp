@@ -0,0 +1,11 @@
+#pragma once
+
+#include "global.hpp"
+
+namespace Engine
+{
+    /** crc32c with the sse4.2 crc32 instruction, nullptr when it isn't compiled for this platform */
+    using Crc32cKernel = uint32 (*)(const uint8* data, size_t size, uint32 crc);
+
+    Crc32cKernel GetSse42Crc32cKernel();
+}
\ No newline at end of file
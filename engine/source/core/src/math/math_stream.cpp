@@ -0,0 +1,254 @@
+#include "math/math_stream.hpp"
+#include "math/math_stream_kernels.hpp"
+#include "misc/cpu_features.hpp"
+#include <atomic>
+
+namespace Engine
+{
+    namespace
+    {
+        Vector3StreamView MakeView(const Vector3Stream& stream)
+        {
+            return { const_cast<float*>(stream.X.Data()), const_cast<float*>(stream.Y.Data()), const_cast<float*>(stream.Z.Data()) };
+        }
+
+        QuatStreamView MakeView(const QuatStream& stream)
+        {
+            return {
+                const_cast<float*>(stream.X.Data()), const_cast<float*>(stream.Y.Data()),
+                const_cast<float*>(stream.Z.Data()), const_cast<float*>(stream.W.Data())
+            };
+        }
+
+        TransformStreamView MakeView(const TransformStream& stream)
+        {
+            return { MakeView(stream.Rotation), MakeView(stream.Translation), MakeView(stream.Scale) };
+        }
+
+        Vector3f LoadVector3(const Vector3StreamView& view, int32 index)
+        {
+            return Vector3f(view.X[index], view.Y[index], view.Z[index]);
+        }
+
+        void StoreVector3(const Vector3StreamView& view, int32 index, const Vector3f& vector)
+        {
+            view.X[index] = vector.X;
+            view.Y[index] = vector.Y;
+            view.Z[index] = vector.Z;
+        }
+
+        Quat LoadQuat(const QuatStreamView& view, int32 index)
+        {
+            return Quat(view.X[index], view.Y[index], view.Z[index], view.W[index]);
+        }
+
+        void StoreQuat(const QuatStreamView& view, int32 index, const Quat& quat)
+        {
+            view.X[index] = quat.X;
+            view.Y[index] = quat.Y;
+            view.Z[index] = quat.Z;
+            view.W[index] = quat.W;
+        }
+
+        // scalar backend calls the per element methods, so it's the reference of other backends
+        const MathStreamKernels GScalarKernels = {
+            [](const Vector3StreamView& vectors, int32 num) {
+                for (int32 index = 0; index < num; ++index)
+                {
+                    Vector3f vector = LoadVector3(vectors, index);
+                    vector.Normalize();
+                    StoreVector3(vectors, index, vector);
+                }
+            },
+            [](const Vector3StreamView& a, const Vector3StreamView& b, float* outDots, int32 num) {
+                for (int32 index = 0; index < num; ++index)
+                {
+                    outDots[index] = Vector3f::Dot(LoadVector3(a, index), LoadVector3(b, index));
+                }
+            },
+            [](const Vector3StreamView& a, const Vector3StreamView& b, const Vector3StreamView& out, int32 num) {
+                for (int32 index = 0; index < num; ++index)
+                {
+                    StoreVector3(out, index, Vector3f::Cross(LoadVector3(a, index), LoadVector3(b, index)));
+                }
+            },
+            [](const QuatStreamView& quats, int32 num) {
+                for (int32 index = 0; index < num; ++index)
+                {
+                    Quat quat = LoadQuat(quats, index);
+                    quat.Normalize();
+                    StoreQuat(quats, index, quat);
+                }
+            },
+            [](const QuatStreamView& a, const QuatStreamView& b, const QuatStreamView& out, int32 num) {
+                for (int32 index = 0; index < num; ++index)
+                {
+                    StoreQuat(out, index, LoadQuat(a, index) * LoadQuat(b, index));
+                }
+            },
+            [](const QuatStreamView& quats, const Vector3StreamView& vectors, const Vector3StreamView& out, int32 num) {
+                for (int32 index = 0; index < num; ++index)
+                {
+                    StoreVector3(out, index, LoadQuat(quats, index).RotateVector(LoadVector3(vectors, index)));
+                }
+            },
+            [](const QuatStreamView& src, const QuatStreamView& dest, float slerp, const QuatStreamView& out, int32 num) {
+                for (int32 index = 0; index < num; ++index)
+                {
+                    StoreQuat(out, index, Quat::Slerp(LoadQuat(src, index), LoadQuat(dest, index), slerp));
+                }
+            },
+            [](const TransformStreamView& a, const TransformStreamView& b, const TransformStreamView& out, int32 num) {
+                for (int32 index = 0; index < num; ++index)
+                {
+                    const Transform transformA(LoadQuat(a.Rotation, index), LoadVector3(a.Translation, index), LoadVector3(a.Scale, index));
+                    const Transform transformB(LoadQuat(b.Rotation, index), LoadVector3(b.Translation, index), LoadVector3(b.Scale, index));
+                    Transform result;
+                    Transform::Multiply(transformA, transformB, result);
+                    StoreQuat(out.Rotation, index, result.GetRotation());
+                    StoreVector3(out.Translation, index, result.GetTranslation());
+                    StoreVector3(out.Scale, index, result.GetScale());
+                }
+            },
+        };
+
+        const MathStreamKernels* FindKernels(EMathStreamBackend backend)
+        {
+            const ESimdLevel level = CpuFeatures::GetSimdLevel();
+            switch (backend)
+            {
+                case EMathStreamBackend::Scalar:
+                    return &GScalarKernels;
+                case EMathStreamBackend::Sse:
+                    return level >= ESimdLevel::Sse2 ? GetSseMathStreamKernels() : nullptr;
+                case EMathStreamBackend::Avx2:
+                    return level >= ESimdLevel::Avx2 ? GetAvx2MathStreamKernels() : nullptr;
+                case EMathStreamBackend::Avx512:
+                    return level >= ESimdLevel::Avx512 ? GetAvx512MathStreamKernels() : nullptr;
+                case EMathStreamBackend::Ispc:
+                    // ispc objects are compiled for sse2 unless native_simd is on
+                    return level >= ESimdLevel::Sse2 ? GetIspcMathStreamKernels() : nullptr;
+                default:
+                    return nullptr;
+            }
+        }
+
+        EMathStreamBackend GetDefaultBackend()
+        {
+            for (EMathStreamBackend backend : { EMathStreamBackend::Avx512, EMathStreamBackend::Avx2, EMathStreamBackend::Ispc, EMathStreamBackend::Sse })
+            {
+                if (FindKernels(backend) != nullptr)
+                {
+                    return backend;
+                }
+            }
+            return EMathStreamBackend::Scalar;
+        }
+
+        struct ActiveKernels
+        {
+            std::atomic<EMathStreamBackend> Backend{ GetDefaultBackend() };
+            std::atomic<const MathStreamKernels*> Kernels{ FindKernels(Backend) };
+        };
+
+        ActiveKernels& GetActiveKernels()
+        {
+            static ActiveKernels* active = new ActiveKernels();
+            return *active;
+        }
+
+        const MathStreamKernels& GetKernels()
+        {
+            return *GetActiveKernels().Kernels.load(std::memory_order_acquire);
+        }
+    }
+
+    void MathStream::Normalize(Vector3Stream& vectors)
+    {
+        GetKernels().Vector3Normalize(MakeView(vectors), vectors.Size());
+    }
+
+    void MathStream::Dot(const Vector3Stream& a, const Vector3Stream& b, Array<float>& outDots)
+    {
+        ENSURE(a.Size() == b.Size());
+        outDots.Resize(a.Size());
+        GetKernels().Vector3Dot(MakeView(a), MakeView(b), outDots.Data(), a.Size());
+    }
+
+    void MathStream::Cross(const Vector3Stream& a, const Vector3Stream& b, Vector3Stream& outCross)
+    {
+        ENSURE(a.Size() == b.Size());
+        outCross.Resize(a.Size());
+        GetKernels().Vector3Cross(MakeView(a), MakeView(b), MakeView(outCross), a.Size());
+    }
+
+    void MathStream::Normalize(QuatStream& quats)
+    {
+        GetKernels().QuatNormalize(MakeView(quats), quats.Size());
+    }
+
+    void MathStream::Multiply(const QuatStream& a, const QuatStream& b, QuatStream& outQuats)
+    {
+        ENSURE(a.Size() == b.Size());
+        outQuats.Resize(a.Size());
+        GetKernels().QuatMultiply(MakeView(a), MakeView(b), MakeView(outQuats), a.Size());
+    }
+
+    void MathStream::RotateVector(const QuatStream& quats, const Vector3Stream& vectors, Vector3Stream& outVectors)
+    {
+        ENSURE(quats.Size() == vectors.Size());
+        outVectors.Resize(vectors.Size());
+        GetKernels().QuatRotateVector(MakeView(quats), MakeView(vectors), MakeView(outVectors), vectors.Size());
+    }
+
+    void MathStream::Slerp(const QuatStream& src, const QuatStream& dest, float slerp, QuatStream& outQuats)
+    {
+        ENSURE(src.Size() == dest.Size());
+        outQuats.Resize(src.Size());
+        GetKernels().QuatSlerp(MakeView(src), MakeView(dest), slerp, MakeView(outQuats), src.Size());
+    }
+
+    void MathStream::Multiply(const TransformStream& a, const TransformStream& b, TransformStream& outTransforms)
+    {
+        ENSURE(a.Size() == b.Size());
+        outTransforms.Resize(a.Size());
+        GetKernels().TransformMultiply(MakeView(a), MakeView(b), MakeView(outTransforms), a.Size());
+    }
+
+    bool MathStream::IsBackendSupported(EMathStreamBackend backend)
+    {
+        return FindKernels(backend) != nullptr;
+    }
+
+    bool MathStream::SetBackend(EMathStreamBackend backend)
+    {
+        const MathStreamKernels* kernels = FindKernels(backend);
+        if (kernels == nullptr)
+        {
+            return false;
+        }
+
+        ActiveKernels& active = GetActiveKernels();
+        active.Kernels.store(kernels, std::memory_order_release);
+        active.Backend.store(backend, std::memory_order_relaxed);
+        return true;
+    }
+
+    EMathStreamBackend MathStream::GetBackend()
+    {
+        return GetActiveKernels().Backend.load(std::memory_order_relaxed);
+    }
+
+    const char* MathStream::GetBackendName(EMathStreamBackend backend)
+    {
+        switch (backend)
+        {
+            case EMathStreamBackend::Scalar: return "scalar";
+            case EMathStreamBackend::Sse: return "sse";
+            case EMathStreamBackend::Avx2: return "avx2";
+            case EMathStreamBackend::Ispc: return "ispc";
+            case EMathStreamBackend::Avx512: return "avx512";
+            default: return "unknown";
+        }
+    }
+}
@@ -0,0 +1,59 @@
+#include "math/math_stream_kernels.hpp"
+
+#if SUPPORT_SSE2
+
+// everything after this point may use avx2, math stream only calls into it after checking cpu supports it
+#if defined(COMPILER_GNUC)
+#pragma GCC target("avx2,fma")
+#elif defined(COMPILER_CLANG) || defined(COMPILER_APPLECLANG)
+#pragma clang attribute push (__attribute__((target("avx2,fma"))), apply_to = function)
+#endif
+
+#include "math/math_stream_simd.hpp"
+
+namespace Engine
+{
+    namespace
+    {
+        struct Avx2Lanes
+        {
+            using Reg = __m256;
+            using Mask = __m256;
+            static constexpr int32 WIDTH = 8;
+
+            static Reg Load(const float* data) { return _mm256_loadu_ps(data); }
+            static void Store(float* data, Reg value) { _mm256_storeu_ps(data, value); }
+            static Reg Set(float value) { return _mm256_set1_ps(value); }
+            static Reg Add(Reg a, Reg b) { return _mm256_add_ps(a, b); }
+            static Reg Sub(Reg a, Reg b) { return _mm256_sub_ps(a, b); }
+            static Reg Mul(Reg a, Reg b) { return _mm256_mul_ps(a, b); }
+            static Reg Div(Reg a, Reg b) { return _mm256_div_ps(a, b); }
+            static Reg Sqrt(Reg a) { return _mm256_sqrt_ps(a); }
+            static Reg Abs(Reg a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+            static Mask CmpGE(Reg a, Reg b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+            static Reg Select(Mask mask, Reg a, Reg b) { return _mm256_blendv_ps(b, a, mask); }
+        };
+    }
+
+    const MathStreamKernels* GetAvx2MathStreamKernels()
+    {
+        static const MathStreamKernels kernels = MakeMathStreamKernels<Avx2Lanes>();
+        return &kernels;
+    }
+}
+
+#if defined(COMPILER_CLANG) || defined(COMPILER_APPLECLANG)
+#pragma clang attribute pop
+#endif
+
+#else
+
+namespace Engine
+{
+    const MathStreamKernels* GetAvx2MathStreamKernels()
+    {
+        return nullptr;
+    }
+}
+
+#endif
\ No newline at end of file
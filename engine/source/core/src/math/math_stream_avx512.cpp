@@ -0,0 +1,59 @@
+#include "math/math_stream_kernels.hpp"
+
+#if SUPPORT_SSE2
+
+// everything after this point may use avx512, math stream only calls into it after checking cpu supports it
+#if defined(COMPILER_GNUC)
+#pragma GCC target("avx512f,avx2,fma")
+#elif defined(COMPILER_CLANG) || defined(COMPILER_APPLECLANG)
+#pragma clang attribute push (__attribute__((target("avx512f,avx2,fma"))), apply_to = function)
+#endif
+
+#include "math/math_stream_simd.hpp"
+
+namespace Engine
+{
+    namespace
+    {
+        struct Avx512Lanes
+        {
+            using Reg = __m512;
+            using Mask = __mmask16;
+            static constexpr int32 WIDTH = 16;
+
+            static Reg Load(const float* data) { return _mm512_loadu_ps(data); }
+            static void Store(float* data, Reg value) { _mm512_storeu_ps(data, value); }
+            static Reg Set(float value) { return _mm512_set1_ps(value); }
+            static Reg Add(Reg a, Reg b) { return _mm512_add_ps(a, b); }
+            static Reg Sub(Reg a, Reg b) { return _mm512_sub_ps(a, b); }
+            static Reg Mul(Reg a, Reg b) { return _mm512_mul_ps(a, b); }
+            static Reg Div(Reg a, Reg b) { return _mm512_div_ps(a, b); }
+            static Reg Sqrt(Reg a) { return _mm512_sqrt_ps(a); }
+            static Reg Abs(Reg a) { return _mm512_abs_ps(a); }
+            static Mask CmpGE(Reg a, Reg b) { return _mm512_cmp_ps_mask(a, b, _CMP_GE_OQ); }
+            static Reg Select(Mask mask, Reg a, Reg b) { return _mm512_mask_blend_ps(mask, b, a); }
+        };
+    }
+
+    const MathStreamKernels* GetAvx512MathStreamKernels()
+    {
+        static const MathStreamKernels kernels = MakeMathStreamKernels<Avx512Lanes>();
+        return &kernels;
+    }
+}
+
+#if defined(COMPILER_CLANG) || defined(COMPILER_APPLECLANG)
+#pragma clang attribute pop
+#endif
+
+#else
+
+namespace Engine
+{
+    const MathStreamKernels* GetAvx512MathStreamKernels()
+    {
+        return nullptr;
+    }
+}
+
+#endif
\ No newline at end of file
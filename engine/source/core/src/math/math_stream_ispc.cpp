@@ -0,0 +1,75 @@
+#include "math/math_stream_kernels.hpp"
+
+#if WITH_ISPC
+
+#include "ispc/math_stream.hpp"
+
+namespace Engine
+{
+    namespace
+    {
+        // views have the same layout as the structs declared in math_stream.ispc
+        ispc::Vector3StreamView* ToIspc(const Vector3StreamView& view)
+        {
+            return reinterpret_cast<ispc::Vector3StreamView*>(const_cast<Vector3StreamView*>(&view));
+        }
+
+        ispc::QuatStreamView* ToIspc(const QuatStreamView& view)
+        {
+            return reinterpret_cast<ispc::QuatStreamView*>(const_cast<QuatStreamView*>(&view));
+        }
+
+        ispc::TransformStreamView* ToIspc(const TransformStreamView& view)
+        {
+            return reinterpret_cast<ispc::TransformStreamView*>(const_cast<TransformStreamView*>(&view));
+        }
+
+        MathStreamKernels MakeIspcKernels()
+        {
+            MathStreamKernels kernels;
+            kernels.Vector3Normalize = [](const Vector3StreamView& vectors, int32 num) {
+                ispc::Vector3StreamNormalize(ToIspc(vectors), num);
+            };
+            kernels.Vector3Dot = [](const Vector3StreamView& a, const Vector3StreamView& b, float* outDots, int32 num) {
+                ispc::Vector3StreamDot(ToIspc(a), ToIspc(b), outDots, num);
+            };
+            kernels.Vector3Cross = [](const Vector3StreamView& a, const Vector3StreamView& b, const Vector3StreamView& out, int32 num) {
+                ispc::Vector3StreamCross(ToIspc(a), ToIspc(b), ToIspc(out), num);
+            };
+            kernels.QuatNormalize = [](const QuatStreamView& quats, int32 num) {
+                ispc::QuatStreamNormalize(ToIspc(quats), num);
+            };
+            kernels.QuatMultiply = [](const QuatStreamView& a, const QuatStreamView& b, const QuatStreamView& out, int32 num) {
+                ispc::QuatStreamMultiply(ToIspc(a), ToIspc(b), ToIspc(out), num);
+            };
+            kernels.QuatRotateVector = [](const QuatStreamView& quats, const Vector3StreamView& vectors, const Vector3StreamView& out, int32 num) {
+                ispc::QuatStreamRotateVector(ToIspc(quats), ToIspc(vectors), ToIspc(out), num);
+            };
+            kernels.QuatSlerp = [](const QuatStreamView& src, const QuatStreamView& dest, float slerp, const QuatStreamView& out, int32 num) {
+                ispc::QuatStreamSlerp(ToIspc(src), ToIspc(dest), slerp, ToIspc(out), num);
+            };
+            kernels.TransformMultiply = [](const TransformStreamView& a, const TransformStreamView& b, const TransformStreamView& out, int32 num) {
+                ispc::TransformStreamMultiply(ToIspc(a), ToIspc(b), ToIspc(out), num);
+            };
+            return kernels;
+        }
+    }
+
+    const MathStreamKernels* GetIspcMathStreamKernels()
+    {
+        static const MathStreamKernels kernels = MakeIspcKernels();
+        return &kernels;
+    }
+}
+
+#else
+
+namespace Engine
+{
+    const MathStreamKernels* GetIspcMathStreamKernels()
+    {
+        return nullptr;
+    }
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "global.hpp"
+
+namespace Engine
+{
+    /**
+     * Raw component pointers of a stream, kernels only see these so a backend compiled for a wider
+     * instruction set doesn't instantiate inline functions of engine headers (linker may keep that copy for every caller).
+     * Inputs are passed through the same views and never written.
+     */
+    struct Vector3StreamView
+    {
+        float* X;
+        float* Y;
+        float* Z;
+    };
+
+    struct QuatStreamView
+    {
+        float* X;
+        float* Y;
+        float* Z;
+        float* W;
+    };
+
+    struct TransformStreamView
+    {
+        QuatStreamView Rotation;
+        Vector3StreamView Translation;
+        Vector3StreamView Scale;
+    };
+
+    struct MathStreamKernels
+    {
+        void (*Vector3Normalize)(const Vector3StreamView& vectors, int32 num);
+        void (*Vector3Dot)(const Vector3StreamView& a, const Vector3StreamView& b, float* outDots, int32 num);
+        void (*Vector3Cross)(const Vector3StreamView& a, const Vector3StreamView& b, const Vector3StreamView& out, int32 num);
+        void (*QuatNormalize)(const QuatStreamView& quats, int32 num);
+        void (*QuatMultiply)(const QuatStreamView& a, const QuatStreamView& b, const QuatStreamView& out, int32 num);
+        void (*QuatRotateVector)(const QuatStreamView& quats, const Vector3StreamView& vectors, const Vector3StreamView& out, int32 num);
+        void (*QuatSlerp)(const QuatStreamView& src, const QuatStreamView& dest, float slerp, const QuatStreamView& out, int32 num);
+        void (*TransformMultiply)(const TransformStreamView& a, const TransformStreamView& b, const TransformStreamView& out, int32 num);
+    };
+
+    /** nullptr when backend isn't compiled for this platform, cpu support is checked by caller */
+    const MathStreamKernels* GetSseMathStreamKernels();
+
+    const MathStreamKernels* GetAvx2MathStreamKernels();
+
+    const MathStreamKernels* GetAvx512MathStreamKernels();
+
+    const MathStreamKernels* GetIspcMathStreamKernels();
+}
@@ -0,0 +1,303 @@
+#pragma once
+
+#include <immintrin.h>
+#include "math/math_stream_kernels.hpp"
+
+/**
+ * Kernels shared by sse, avx2 and avx512 backends, written once against a lanes type which provides Reg, Mask, WIDTH
+ * and static Load, Store, Set, Add, Sub, Mul, Div, Sqrt, Abs, CmpGE, Select.
+ * Everything is in an anonymous namespace on purpose: each backend translation unit gets its own copy compiled for its
+ * instruction set, none of them can be merged with a copy of another backend.
+ */
+namespace Engine
+{
+    namespace
+    {
+        /** one element at a time, runs the remainder of a stream that doesn't fill a register */
+        struct ScalarLanes
+        {
+            using Reg = float;
+            using Mask = bool;
+            static constexpr int32 WIDTH = 1;
+
+            static Reg Load(const float* data) { return *data; }
+            static void Store(float* data, Reg value) { *data = value; }
+            static Reg Set(float value) { return value; }
+            static Reg Add(Reg a, Reg b) { return a + b; }
+            static Reg Sub(Reg a, Reg b) { return a - b; }
+            static Reg Mul(Reg a, Reg b) { return a * b; }
+            static Reg Div(Reg a, Reg b) { return a / b; }
+            static Reg Sqrt(Reg a) { return _mm_cvtss_f32(_mm_sqrt_ss(_mm_set_ss(a))); }
+            static Reg Abs(Reg a) { return a < 0.0f ? -a : a; }
+            static Mask CmpGE(Reg a, Reg b) { return a >= b; }
+            static Reg Select(Mask mask, Reg a, Reg b) { return mask ? a : b; }
+        };
+
+        template <typename L>
+        struct Vector3Lanes
+        {
+            typename L::Reg X;
+            typename L::Reg Y;
+            typename L::Reg Z;
+        };
+
+        template <typename L>
+        struct QuatLanes
+        {
+            typename L::Reg X;
+            typename L::Reg Y;
+            typename L::Reg Z;
+            typename L::Reg W;
+        };
+
+        /** calls fun(lanes, index) for every full register, then element by element for the rest */
+        template <typename V, typename Fun>
+        void ForEachLanes(int32 num, Fun&& fun)
+        {
+            int32 index = 0;
+            for (; index + V::WIDTH <= num; index += V::WIDTH)
+            {
+                fun(V(), index);
+            }
+            for (; index < num; ++index)
+            {
+                fun(ScalarLanes(), index);
+            }
+        }
+
+        template <typename L>
+        Vector3Lanes<L> LoadVector3(const Vector3StreamView& view, int32 index)
+        {
+            return { L::Load(view.X + index), L::Load(view.Y + index), L::Load(view.Z + index) };
+        }
+
+        template <typename L>
+        void StoreVector3(const Vector3StreamView& view, int32 index, const Vector3Lanes<L>& vector)
+        {
+            L::Store(view.X + index, vector.X);
+            L::Store(view.Y + index, vector.Y);
+            L::Store(view.Z + index, vector.Z);
+        }
+
+        template <typename L>
+        QuatLanes<L> LoadQuat(const QuatStreamView& view, int32 index)
+        {
+            return { L::Load(view.X + index), L::Load(view.Y + index), L::Load(view.Z + index), L::Load(view.W + index) };
+        }
+
+        template <typename L>
+        void StoreQuat(const QuatStreamView& view, int32 index, const QuatLanes<L>& quat)
+        {
+            L::Store(view.X + index, quat.X);
+            L::Store(view.Y + index, quat.Y);
+            L::Store(view.Z + index, quat.Z);
+            L::Store(view.W + index, quat.W);
+        }
+
+        template <typename L>
+        typename L::Reg Dot3(const Vector3Lanes<L>& a, const Vector3Lanes<L>& b)
+        {
+            return L::Add(L::Add(L::Mul(a.X, b.X), L::Mul(a.Y, b.Y)), L::Mul(a.Z, b.Z));
+        }
+
+        template <typename L>
+        Vector3Lanes<L> Cross3(const Vector3Lanes<L>& a, const Vector3Lanes<L>& b)
+        {
+            return {
+                L::Sub(L::Mul(a.Y, b.Z), L::Mul(a.Z, b.Y)),
+                L::Sub(L::Mul(a.Z, b.X), L::Mul(a.X, b.Z)),
+                L::Sub(L::Mul(a.X, b.Y), L::Mul(a.Y, b.X))
+            };
+        }
+
+        template <typename L>
+        QuatLanes<L> MultiplyQuat(const QuatLanes<L>& a, const QuatLanes<L>& b)
+        {
+            return {
+                L::Sub(L::Add(L::Add(L::Mul(a.W, b.X), L::Mul(a.X, b.W)), L::Mul(a.Z, b.Y)), L::Mul(a.Y, b.Z)),
+                L::Sub(L::Add(L::Add(L::Mul(a.W, b.Y), L::Mul(a.Y, b.W)), L::Mul(a.X, b.Z)), L::Mul(a.Z, b.X)),
+                L::Sub(L::Add(L::Add(L::Mul(a.W, b.Z), L::Mul(a.Z, b.W)), L::Mul(a.Y, b.X)), L::Mul(a.X, b.Y)),
+                L::Sub(L::Sub(L::Sub(L::Mul(a.W, b.W), L::Mul(a.X, b.X)), L::Mul(a.Y, b.Y)), L::Mul(a.Z, b.Z))
+            };
+        }
+
+        /** same as Quat::RotateVector: t = 2 * (q ^ v), v' = v + w * t + q ^ t */
+        template <typename L>
+        Vector3Lanes<L> RotateVector3(const QuatLanes<L>& quat, const Vector3Lanes<L>& vector)
+        {
+            const Vector3Lanes<L> q{ quat.X, quat.Y, quat.Z };
+            const typename L::Reg two = L::Set(2.0f);
+            Vector3Lanes<L> t = Cross3<L>(q, vector);
+            t = { L::Mul(t.X, two), L::Mul(t.Y, two), L::Mul(t.Z, two) };
+            const Vector3Lanes<L> qt = Cross3<L>(q, t);
+            return {
+                L::Add(L::Add(vector.X, L::Mul(quat.W, t.X)), qt.X),
+                L::Add(L::Add(vector.Y, L::Mul(quat.W, t.Y)), qt.Y),
+                L::Add(L::Add(vector.Z, L::Mul(quat.W, t.Z)), qt.Z)
+            };
+        }
+
+        template <typename L>
+        QuatLanes<L> NormalizeQuat(const QuatLanes<L>& quat)
+        {
+            const typename L::Reg sizeSq = L::Add(L::Add(L::Mul(quat.X, quat.X), L::Mul(quat.Y, quat.Y)),
+                                                  L::Add(L::Mul(quat.Z, quat.Z), L::Mul(quat.W, quat.W)));
+            const typename L::Reg scale = L::Div(L::Set(1.0f), L::Sqrt(sizeSq));
+            return { L::Mul(quat.X, scale), L::Mul(quat.Y, scale), L::Mul(quat.Z, scale), L::Mul(quat.W, scale) };
+        }
+
+        /** acos of x in [0, 1], Abramowitz and Stegun 4.4.46, error below 2e-8 */
+        template <typename L>
+        typename L::Reg AcosUnit(typename L::Reg x)
+        {
+            typename L::Reg poly = L::Set(-0.0012624911f);
+            poly = L::Add(L::Mul(poly, x), L::Set(0.0066700901f));
+            poly = L::Add(L::Mul(poly, x), L::Set(-0.0170881256f));
+            poly = L::Add(L::Mul(poly, x), L::Set(0.0308918810f));
+            poly = L::Add(L::Mul(poly, x), L::Set(-0.0501743046f));
+            poly = L::Add(L::Mul(poly, x), L::Set(0.0889789874f));
+            poly = L::Add(L::Mul(poly, x), L::Set(-0.2145988016f));
+            poly = L::Add(L::Mul(poly, x), L::Set(1.5707963050f));
+            return L::Mul(L::Sqrt(L::Sub(L::Set(1.0f), x)), poly);
+        }
+
+        /** sin of x in [0, pi / 2], taylor series up to x^11 */
+        template <typename L>
+        typename L::Reg SinHalfPi(typename L::Reg x)
+        {
+            const typename L::Reg x2 = L::Mul(x, x);
+            typename L::Reg poly = L::Set(-2.5052108e-8f);
+            poly = L::Add(L::Mul(poly, x2), L::Set(2.7557319e-6f));
+            poly = L::Add(L::Mul(poly, x2), L::Set(-1.9841270e-4f));
+            poly = L::Add(L::Mul(poly, x2), L::Set(8.3333333e-3f));
+            poly = L::Add(L::Mul(poly, x2), L::Set(-1.6666667e-1f));
+            poly = L::Add(L::Mul(poly, x2), L::Set(1.0f));
+            return L::Mul(poly, x);
+        }
+
+        template <typename V>
+        void Vector3NormalizeKernel(const Vector3StreamView& vectors, int32 num)
+        {
+            ForEachLanes<V>(num, [&](auto lanes, int32 index) {
+                using L = decltype(lanes);
+                const Vector3Lanes<L> vector = LoadVector3<L>(vectors, index);
+                const typename L::Reg scale = L::Div(L::Set(1.0f), L::Sqrt(Dot3<L>(vector, vector)));
+                StoreVector3<L>(vectors, index, { L::Mul(vector.X, scale), L::Mul(vector.Y, scale), L::Mul(vector.Z, scale) });
+            });
+        }
+
+        template <typename V>
+        void Vector3DotKernel(const Vector3StreamView& a, const Vector3StreamView& b, float* outDots, int32 num)
+        {
+            ForEachLanes<V>(num, [&](auto lanes, int32 index) {
+                using L = decltype(lanes);
+                L::Store(outDots + index, Dot3<L>(LoadVector3<L>(a, index), LoadVector3<L>(b, index)));
+            });
+        }
+
+        template <typename V>
+        void Vector3CrossKernel(const Vector3StreamView& a, const Vector3StreamView& b, const Vector3StreamView& out, int32 num)
+        {
+            ForEachLanes<V>(num, [&](auto lanes, int32 index) {
+                using L = decltype(lanes);
+                StoreVector3<L>(out, index, Cross3<L>(LoadVector3<L>(a, index), LoadVector3<L>(b, index)));
+            });
+        }
+
+        template <typename V>
+        void QuatNormalizeKernel(const QuatStreamView& quats, int32 num)
+        {
+            ForEachLanes<V>(num, [&](auto lanes, int32 index) {
+                using L = decltype(lanes);
+                StoreQuat<L>(quats, index, NormalizeQuat<L>(LoadQuat<L>(quats, index)));
+            });
+        }
+
+        template <typename V>
+        void QuatMultiplyKernel(const QuatStreamView& a, const QuatStreamView& b, const QuatStreamView& out, int32 num)
+        {
+            ForEachLanes<V>(num, [&](auto lanes, int32 index) {
+                using L = decltype(lanes);
+                StoreQuat<L>(out, index, MultiplyQuat<L>(LoadQuat<L>(a, index), LoadQuat<L>(b, index)));
+            });
+        }
+
+        template <typename V>
+        void QuatRotateVectorKernel(const QuatStreamView& quats, const Vector3StreamView& vectors, const Vector3StreamView& out, int32 num)
+        {
+            ForEachLanes<V>(num, [&](auto lanes, int32 index) {
+                using L = decltype(lanes);
+                StoreVector3<L>(out, index, RotateVector3<L>(LoadQuat<L>(quats, index), LoadVector3<L>(vectors, index)));
+            });
+        }
+
+        /** same steps as Quat::Slerp, lanes close to each other fall back to linear interpolation */
+        template <typename V>
+        void QuatSlerpKernel(const QuatStreamView& src, const QuatStreamView& dest, float slerp, const QuatStreamView& out, int32 num)
+        {
+            ForEachLanes<V>(num, [&](auto lanes, int32 index) {
+                using L = decltype(lanes);
+                using Reg = typename L::Reg;
+                const QuatLanes<L> a = LoadQuat<L>(src, index);
+                const QuatLanes<L> b = LoadQuat<L>(dest, index);
+
+                const Reg rawCosine = L::Add(L::Add(L::Mul(a.X, b.X), L::Mul(a.Y, b.Y)), L::Add(L::Mul(a.Z, b.Z), L::Mul(a.W, b.W)));
+                const Reg cosine = L::Abs(rawCosine);
+                const Reg alpha = L::Set(slerp);
+                const Reg beta = L::Set(1.0f - slerp);
+
+                const Reg omega = AcosUnit<L>(cosine);
+                const Reg invSin = L::Div(L::Set(1.0f), SinHalfPi<L>(omega));
+                const typename L::Mask linear = L::CmpGE(cosine, L::Set(0.9999f));
+                const Reg scale0 = L::Select(linear, beta, L::Mul(SinHalfPi<L>(L::Mul(beta, omega)), invSin));
+                Reg scale1 = L::Select(linear, alpha, L::Mul(SinHalfPi<L>(L::Mul(alpha, omega)), invSin));
+                scale1 = L::Select(L::CmpGE(rawCosine, L::Set(0.0f)), scale1, L::Sub(L::Set(0.0f), scale1));
+
+                const QuatLanes<L> result{
+                    L::Add(L::Mul(scale0, a.X), L::Mul(scale1, b.X)),
+                    L::Add(L::Mul(scale0, a.Y), L::Mul(scale1, b.Y)),
+                    L::Add(L::Mul(scale0, a.Z), L::Mul(scale1, b.Z)),
+                    L::Add(L::Mul(scale0, a.W), L::Mul(scale1, b.W))
+                };
+                StoreQuat<L>(out, index, NormalizeQuat<L>(result));
+            });
+        }
+
+        /** same as Transform::Multiply, every input is loaded before storing so out may be a or b */
+        template <typename V>
+        void TransformMultiplyKernel(const TransformStreamView& a, const TransformStreamView& b, const TransformStreamView& out, int32 num)
+        {
+            ForEachLanes<V>(num, [&](auto lanes, int32 index) {
+                using L = decltype(lanes);
+                const QuatLanes<L> rotationA = LoadQuat<L>(a.Rotation, index);
+                const QuatLanes<L> rotationB = LoadQuat<L>(b.Rotation, index);
+                const Vector3Lanes<L> translationA = LoadVector3<L>(a.Translation, index);
+                const Vector3Lanes<L> translationB = LoadVector3<L>(b.Translation, index);
+                const Vector3Lanes<L> scaleA = LoadVector3<L>(a.Scale, index);
+                const Vector3Lanes<L> scaleB = LoadVector3<L>(b.Scale, index);
+
+                const Vector3Lanes<L> scaled{ L::Mul(scaleB.X, translationA.X), L::Mul(scaleB.Y, translationA.Y), L::Mul(scaleB.Z, translationA.Z) };
+                const Vector3Lanes<L> rotated = RotateVector3<L>(rotationB, scaled);
+
+                StoreQuat<L>(out.Rotation, index, MultiplyQuat<L>(rotationA, rotationB));
+                StoreVector3<L>(out.Scale, index, { L::Mul(scaleA.X, scaleB.X), L::Mul(scaleA.Y, scaleB.Y), L::Mul(scaleA.Z, scaleB.Z) });
+                StoreVector3<L>(out.Translation, index, { L::Add(rotated.X, translationB.X), L::Add(rotated.Y, translationB.Y), L::Add(rotated.Z, translationB.Z) });
+            });
+        }
+
+        template <typename V>
+        MathStreamKernels MakeMathStreamKernels()
+        {
+            MathStreamKernels kernels;
+            kernels.Vector3Normalize = &Vector3NormalizeKernel<V>;
+            kernels.Vector3Dot = &Vector3DotKernel<V>;
+            kernels.Vector3Cross = &Vector3CrossKernel<V>;
+            kernels.QuatNormalize = &QuatNormalizeKernel<V>;
+            kernels.QuatMultiply = &QuatMultiplyKernel<V>;
+            kernels.QuatRotateVector = &QuatRotateVectorKernel<V>;
+            kernels.QuatSlerp = &QuatSlerpKernel<V>;
+            kernels.TransformMultiply = &TransformMultiplyKernel<V>;
+            return kernels;
+        }
+    }
+}
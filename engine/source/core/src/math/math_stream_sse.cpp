@@ -0,0 +1,49 @@
+#include "math/math_stream_kernels.hpp"
+
+#if SUPPORT_SSE2
+
+#include "math/math_stream_simd.hpp"
+
+namespace Engine
+{
+    namespace
+    {
+        /** sse2 only, it's the baseline of x86-64 so the backend is always usable there */
+        struct SseLanes
+        {
+            using Reg = __m128;
+            using Mask = __m128;
+            static constexpr int32 WIDTH = 4;
+
+            static Reg Load(const float* data) { return _mm_loadu_ps(data); }
+            static void Store(float* data, Reg value) { _mm_storeu_ps(data, value); }
+            static Reg Set(float value) { return _mm_set1_ps(value); }
+            static Reg Add(Reg a, Reg b) { return _mm_add_ps(a, b); }
+            static Reg Sub(Reg a, Reg b) { return _mm_sub_ps(a, b); }
+            static Reg Mul(Reg a, Reg b) { return _mm_mul_ps(a, b); }
+            static Reg Div(Reg a, Reg b) { return _mm_div_ps(a, b); }
+            static Reg Sqrt(Reg a) { return _mm_sqrt_ps(a); }
+            static Reg Abs(Reg a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+            static Mask CmpGE(Reg a, Reg b) { return _mm_cmpge_ps(a, b); }
+            static Reg Select(Mask mask, Reg a, Reg b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+        };
+    }
+
+    const MathStreamKernels* GetSseMathStreamKernels()
+    {
+        static const MathStreamKernels kernels = MakeMathStreamKernels<SseLanes>();
+        return &kernels;
+    }
+}
+
+#else
+
+namespace Engine
+{
+    const MathStreamKernels* GetSseMathStreamKernels()
+    {
+        return nullptr;
+    }
+}
+
+#endif
\ No newline at end of file
@@ -17,35 +17,6 @@ namespace Engine
         Memory::Memcpy(M[3], const_cast<float*>(&w.X), sizeof(float) * 4);
     }
 
-    void Matrix::Multipy(const Matrix& a, const Matrix& b, Matrix& result)
-    {
-        Vector4f row0(
-            a.M[0][0] * b.M[0][0] + a.M[1][0] * b.M[0][1] + a.M[2][0] * b.M[0][2] + a.M[3][0] * b.M[0][3],
-            a.M[0][1] * b.M[0][0] + a.M[1][1] * b.M[0][1] + a.M[2][1] * b.M[0][2] + a.M[3][1] * b.M[0][3],
-            a.M[0][2] * b.M[0][0] + a.M[1][2] * b.M[0][1] + a.M[2][2] * b.M[0][2] + a.M[3][2] * b.M[0][3],
-            a.M[0][3] * b.M[0][0] + a.M[1][3] * b.M[0][1] + a.M[2][3] * b.M[0][2] + a.M[3][3] * b.M[0][3]);
-
-        Vector4f row1(
-            a.M[0][0] * b.M[1][0] + a.M[1][0] * b.M[1][1] + a.M[2][0] * b.M[1][2] + a.M[3][0] * b.M[1][3],
-            a.M[0][1] * b.M[1][0] + a.M[1][1] * b.M[1][1] + a.M[2][1] * b.M[1][2] + a.M[3][1] * b.M[1][3],
-            a.M[0][2] * b.M[1][0] + a.M[1][2] * b.M[1][1] + a.M[2][2] * b.M[1][2] + a.M[3][2] * b.M[1][3],
-            a.M[0][3] * b.M[1][0] + a.M[1][3] * b.M[1][1] + a.M[2][3] * b.M[1][2] + a.M[3][3] * b.M[1][3]);
-
-        Vector4f row2(
-            a.M[0][0] * b.M[2][0] + a.M[1][0] * b.M[2][1] + a.M[2][0] * b.M[2][2] + a.M[3][0] * b.M[2][3],
-            a.M[0][1] * b.M[2][0] + a.M[1][1] * b.M[2][1] + a.M[2][1] * b.M[2][2] + a.M[3][1] * b.M[2][3],
-            a.M[0][2] * b.M[2][0] + a.M[1][2] * b.M[2][1] + a.M[2][2] * b.M[2][2] + a.M[3][2] * b.M[2][3],
-            a.M[0][3] * b.M[2][0] + a.M[1][3] * b.M[2][1] + a.M[2][3] * b.M[2][2] + a.M[3][3] * b.M[2][3]);
-
-        Vector4f row3(
-            a.M[0][0] * b.M[3][0] + a.M[1][0] * b.M[3][1] + a.M[2][0] * b.M[3][2] + a.M[3][0] * b.M[3][3],
-            a.M[0][1] * b.M[3][0] + a.M[1][1] * b.M[3][1] + a.M[2][1] * b.M[3][2] + a.M[3][1] * b.M[3][3],
-            a.M[0][2] * b.M[3][0] + a.M[1][2] * b.M[3][1] + a.M[2][2] * b.M[3][2] + a.M[3][2] * b.M[3][3],
-            a.M[0][3] * b.M[3][0] + a.M[1][3] * b.M[3][1] + a.M[2][3] * b.M[3][2] + a.M[3][3] * b.M[3][3]);
-
-        result = Matrix(row0, row1, row2, row3);
-    }
-
     void Matrix::SetIdentity()
     {
         M[0][0] = 1; M[0][1] = 0;  M[0][2] = 0;  M[0][3] = 0;
@@ -73,16 +44,43 @@ namespace Engine
         return scale;
     }
 
+    Vector3f Matrix::TransformPosition(const Vector3f& position) const
+    {
+        const Vector4f result = TransformVector4(Vector4f(position.X, position.Y, position.Z, 1.0f));
+        return Vector3f(result.X, result.Y, result.Z);
+    }
+
+    Vector3f Matrix::TransformVector(const Vector3f& vector) const
+    {
+        const Vector4f result = TransformVector4(Vector4f(vector.X, vector.Y, vector.Z, 0.0f));
+        return Vector3f(result.X, result.Y, result.Z);
+    }
+
+    bool Matrix::Equals(const Matrix& other, float tolerance) const
+    {
+        for (int32 row = 0; row < 4; ++row)
+        {
+            for (int32 column = 0; column < 4; ++column)
+            {
+                if (!Math::Equals(M[row][column], other.M[row][column], tolerance))
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
     Matrix Matrix::operator*(const Matrix& other) const
     {
         Matrix result;
-        Multipy(other, *this, result);
+        Multiply(other, *this, result);
         return result;
     }
 
     Matrix Matrix::operator*=(const Matrix& other)
     {
-        Multipy(other, *this, *this);
+        Multiply(other, *this, *this);
         return *this;
     }
 
@@ -90,4 +88,104 @@ namespace Engine
     {
         return Vector4f(M[row][0], M[row][1], M[row][2], M[row][3]);
     }
+
+#if !ENABLE_TRANSFORM_INTRINSICS
+    void Matrix::Multiply(const Matrix& a, const Matrix& b, Matrix& result)
+    {
+        Vector4f row0(
+            a.M[0][0] * b.M[0][0] + a.M[1][0] * b.M[0][1] + a.M[2][0] * b.M[0][2] + a.M[3][0] * b.M[0][3],
+            a.M[0][1] * b.M[0][0] + a.M[1][1] * b.M[0][1] + a.M[2][1] * b.M[0][2] + a.M[3][1] * b.M[0][3],
+            a.M[0][2] * b.M[0][0] + a.M[1][2] * b.M[0][1] + a.M[2][2] * b.M[0][2] + a.M[3][2] * b.M[0][3],
+            a.M[0][3] * b.M[0][0] + a.M[1][3] * b.M[0][1] + a.M[2][3] * b.M[0][2] + a.M[3][3] * b.M[0][3]);
+
+        Vector4f row1(
+            a.M[0][0] * b.M[1][0] + a.M[1][0] * b.M[1][1] + a.M[2][0] * b.M[1][2] + a.M[3][0] * b.M[1][3],
+            a.M[0][1] * b.M[1][0] + a.M[1][1] * b.M[1][1] + a.M[2][1] * b.M[1][2] + a.M[3][1] * b.M[1][3],
+            a.M[0][2] * b.M[1][0] + a.M[1][2] * b.M[1][1] + a.M[2][2] * b.M[1][2] + a.M[3][2] * b.M[1][3],
+            a.M[0][3] * b.M[1][0] + a.M[1][3] * b.M[1][1] + a.M[2][3] * b.M[1][2] + a.M[3][3] * b.M[1][3]);
+
+        Vector4f row2(
+            a.M[0][0] * b.M[2][0] + a.M[1][0] * b.M[2][1] + a.M[2][0] * b.M[2][2] + a.M[3][0] * b.M[2][3],
+            a.M[0][1] * b.M[2][0] + a.M[1][1] * b.M[2][1] + a.M[2][1] * b.M[2][2] + a.M[3][1] * b.M[2][3],
+            a.M[0][2] * b.M[2][0] + a.M[1][2] * b.M[2][1] + a.M[2][2] * b.M[2][2] + a.M[3][2] * b.M[2][3],
+            a.M[0][3] * b.M[2][0] + a.M[1][3] * b.M[2][1] + a.M[2][3] * b.M[2][2] + a.M[3][3] * b.M[2][3]);
+
+        Vector4f row3(
+            a.M[0][0] * b.M[3][0] + a.M[1][0] * b.M[3][1] + a.M[2][0] * b.M[3][2] + a.M[3][0] * b.M[3][3],
+            a.M[0][1] * b.M[3][0] + a.M[1][1] * b.M[3][1] + a.M[2][1] * b.M[3][2] + a.M[3][1] * b.M[3][3],
+            a.M[0][2] * b.M[3][0] + a.M[1][2] * b.M[3][1] + a.M[2][2] * b.M[3][2] + a.M[3][2] * b.M[3][3],
+            a.M[0][3] * b.M[3][0] + a.M[1][3] * b.M[3][1] + a.M[2][3] * b.M[3][2] + a.M[3][3] * b.M[3][3]);
+
+        result = Matrix(row0, row1, row2, row3);
+    }
+
+    Matrix Matrix::GetTransposed() const
+    {
+        Matrix result;
+        for (int32 row = 0; row < 4; ++row)
+        {
+            for (int32 column = 0; column < 4; ++column)
+            {
+                result.M[column][row] = M[row][column];
+            }
+        }
+        return result;
+    }
+
+    Matrix Matrix::Inverse() const
+    {
+        // 2x2 determinants of the upper two rows and the lower two rows
+        const float s0 = M[0][0] * M[1][1] - M[1][0] * M[0][1];
+        const float s1 = M[0][0] * M[1][2] - M[1][0] * M[0][2];
+        const float s2 = M[0][0] * M[1][3] - M[1][0] * M[0][3];
+        const float s3 = M[0][1] * M[1][2] - M[1][1] * M[0][2];
+        const float s4 = M[0][1] * M[1][3] - M[1][1] * M[0][3];
+        const float s5 = M[0][2] * M[1][3] - M[1][2] * M[0][3];
+
+        const float c0 = M[2][0] * M[3][1] - M[3][0] * M[2][1];
+        const float c1 = M[2][0] * M[3][2] - M[3][0] * M[2][2];
+        const float c2 = M[2][0] * M[3][3] - M[3][0] * M[2][3];
+        const float c3 = M[2][1] * M[3][2] - M[3][1] * M[2][2];
+        const float c4 = M[2][1] * M[3][3] - M[3][1] * M[2][3];
+        const float c5 = M[2][2] * M[3][3] - M[3][2] * M[2][3];
+
+        const float det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+        if (det == 0.0f)
+        {
+            return Identity;
+        }
+
+        const float rdet = 1.0f / det;
+        Matrix result;
+        result.M[0][0] = ( M[1][1] * c5 - M[1][2] * c4 + M[1][3] * c3) * rdet;
+        result.M[0][1] = (-M[0][1] * c5 + M[0][2] * c4 - M[0][3] * c3) * rdet;
+        result.M[0][2] = ( M[3][1] * s5 - M[3][2] * s4 + M[3][3] * s3) * rdet;
+        result.M[0][3] = (-M[2][1] * s5 + M[2][2] * s4 - M[2][3] * s3) * rdet;
+
+        result.M[1][0] = (-M[1][0] * c5 + M[1][2] * c2 - M[1][3] * c1) * rdet;
+        result.M[1][1] = ( M[0][0] * c5 - M[0][2] * c2 + M[0][3] * c1) * rdet;
+        result.M[1][2] = (-M[3][0] * s5 + M[3][2] * s2 - M[3][3] * s1) * rdet;
+        result.M[1][3] = ( M[2][0] * s5 - M[2][2] * s2 + M[2][3] * s1) * rdet;
+
+        result.M[2][0] = ( M[1][0] * c4 - M[1][1] * c2 + M[1][3] * c0) * rdet;
+        result.M[2][1] = (-M[0][0] * c4 + M[0][1] * c2 - M[0][3] * c0) * rdet;
+        result.M[2][2] = ( M[3][0] * s4 - M[3][1] * s2 + M[3][3] * s0) * rdet;
+        result.M[2][3] = (-M[2][0] * s4 + M[2][1] * s2 - M[2][3] * s0) * rdet;
+
+        result.M[3][0] = (-M[1][0] * c3 + M[1][1] * c1 - M[1][2] * c0) * rdet;
+        result.M[3][1] = ( M[0][0] * c3 - M[0][1] * c1 + M[0][2] * c0) * rdet;
+        result.M[3][2] = (-M[3][0] * s3 + M[3][1] * s1 - M[3][2] * s0) * rdet;
+        result.M[3][3] = ( M[2][0] * s3 - M[2][1] * s1 + M[2][2] * s0) * rdet;
+        return result;
+    }
+
+    Vector4f Matrix::TransformVector4(const Vector4f& vector) const
+    {
+        return Vector4f(
+            vector.X * M[0][0] + vector.Y * M[1][0] + vector.Z * M[2][0] + vector.W * M[3][0],
+            vector.X * M[0][1] + vector.Y * M[1][1] + vector.Z * M[2][1] + vector.W * M[3][1],
+            vector.X * M[0][2] + vector.Y * M[1][2] + vector.Z * M[2][2] + vector.W * M[3][2],
+            vector.X * M[0][3] + vector.Y * M[1][3] + vector.Z * M[2][3] + vector.W * M[3][3]);
+    }
+#endif
 }
\ No newline at end of file
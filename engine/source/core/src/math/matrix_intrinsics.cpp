@@ -0,0 +1,156 @@
+#include "math/matrix.hpp"
+
+#if ENABLE_TRANSFORM_INTRINSICS
+
+#include "math/engine_simd.hpp"
+
+namespace Engine
+{
+    namespace
+    {
+        struct MatrixRows
+        {
+            explicit MatrixRows(const Matrix& matrix)
+                : Row0(VectorLoadAligned(matrix.M[0]))
+                , Row1(VectorLoadAligned(matrix.M[1]))
+                , Row2(VectorLoadAligned(matrix.M[2]))
+                , Row3(VectorLoadAligned(matrix.M[3]))
+            {}
+
+            void Store(Matrix& matrix) const
+            {
+                VectorStoreAligned(Row0, matrix.M[0]);
+                VectorStoreAligned(Row1, matrix.M[1]);
+                VectorStoreAligned(Row2, matrix.M[2]);
+                VectorStoreAligned(Row3, matrix.M[3]);
+            }
+
+            /** row vector times these rows */
+            VectorRegister TransformVector(VectorRegister vector) const
+            {
+                VectorRegister result = VectorMultiply(VectorReplicate<0>(vector), Row0);
+                result = VectorMultiplyAdd(VectorReplicate<1>(vector), Row1, result);
+                result = VectorMultiplyAdd(VectorReplicate<2>(vector), Row2, result);
+                return VectorMultiplyAdd(VectorReplicate<3>(vector), Row3, result);
+            }
+
+            VectorRegister Row0;
+            VectorRegister Row1;
+            VectorRegister Row2;
+            VectorRegister Row3;
+        };
+
+        /**
+         * 2x2 matrices below are stored row major in one register as (m00, m01, m10, m11).
+         * https://lxjk.github.io/2017/09/03/Fast-4x4-Matrix-Inverse-with-SSE-SIMD-Explained.html
+         */
+
+        /** lhs * rhs */
+        VectorRegister Matrix2Multiply(VectorRegister lhs, VectorRegister rhs)
+        {
+            return VectorAdd(
+                VectorMultiply(lhs, VectorShuffle<0, 3, 0, 3>(rhs)),
+                VectorMultiply(VectorShuffle<1, 0, 3, 2>(lhs), VectorShuffle<2, 1, 2, 1>(rhs)));
+        }
+
+        /** adjugate(lhs) * rhs */
+        VectorRegister Matrix2AdjugateMultiply(VectorRegister lhs, VectorRegister rhs)
+        {
+            return VectorSubtract(
+                VectorMultiply(VectorShuffle<3, 3, 0, 0>(lhs), rhs),
+                VectorMultiply(VectorShuffle<1, 1, 2, 2>(lhs), VectorShuffle<2, 3, 0, 1>(rhs)));
+        }
+
+        /** lhs * adjugate(rhs) */
+        VectorRegister Matrix2MultiplyAdjugate(VectorRegister lhs, VectorRegister rhs)
+        {
+            return VectorSubtract(
+                VectorMultiply(lhs, VectorShuffle<3, 0, 3, 0>(rhs)),
+                VectorMultiply(VectorShuffle<1, 0, 3, 2>(lhs), VectorShuffle<2, 1, 2, 1>(rhs)));
+        }
+    }
+
+    void Matrix::Multiply(const Matrix& a, const Matrix& b, Matrix& result)
+    {
+        // every row of b is read before the same row of result is written, so result may be a or b
+        const MatrixRows rowsA(a);
+        for (int32 row = 0; row < 4; ++row)
+        {
+            VectorStoreAligned(rowsA.TransformVector(VectorLoadAligned(b.M[row])), result.M[row]);
+        }
+    }
+
+    Matrix Matrix::GetTransposed() const
+    {
+        MatrixRows rows(*this);
+        _MM_TRANSPOSE4_PS(rows.Row0, rows.Row1, rows.Row2, rows.Row3);
+
+        Matrix result;
+        rows.Store(result);
+        return result;
+    }
+
+    Matrix Matrix::Inverse() const
+    {
+        const MatrixRows rows(*this);
+
+        // sub matrices of | A B |
+        //                 | C D |
+        const VectorRegister a = _mm_movelh_ps(rows.Row0, rows.Row1);
+        const VectorRegister b = _mm_movehl_ps(rows.Row1, rows.Row0);
+        const VectorRegister c = _mm_movelh_ps(rows.Row2, rows.Row3);
+        const VectorRegister d = _mm_movehl_ps(rows.Row3, rows.Row2);
+
+        // (|A|, |B|, |C|, |D|)
+        const VectorRegister detSub = VectorSubtract(
+            VectorMultiply(VectorShuffle<0, 2, 0, 2>(rows.Row0, rows.Row2), VectorShuffle<1, 3, 1, 3>(rows.Row1, rows.Row3)),
+            VectorMultiply(VectorShuffle<1, 3, 1, 3>(rows.Row0, rows.Row2), VectorShuffle<0, 2, 0, 2>(rows.Row1, rows.Row3)));
+        const VectorRegister detA = VectorReplicate<0>(detSub);
+        const VectorRegister detB = VectorReplicate<1>(detSub);
+        const VectorRegister detC = VectorReplicate<2>(detSub);
+        const VectorRegister detD = VectorReplicate<3>(detSub);
+
+        // inverse is 1 / |M| * | X Y |, below are adjugates of X, Y, Z, W
+        //                      | Z W |
+        const VectorRegister adjugateDC = Matrix2AdjugateMultiply(d, c);
+        const VectorRegister adjugateAB = Matrix2AdjugateMultiply(a, b);
+        VectorRegister x = VectorSubtract(VectorMultiply(detD, a), Matrix2Multiply(b, adjugateDC));
+        VectorRegister w = VectorSubtract(VectorMultiply(detA, d), Matrix2Multiply(c, adjugateAB));
+        VectorRegister y = VectorSubtract(VectorMultiply(detB, c), Matrix2MultiplyAdjugate(d, adjugateAB));
+        VectorRegister z = VectorSubtract(VectorMultiply(detC, b), Matrix2MultiplyAdjugate(a, adjugateDC));
+
+        // |M| = |A| * |D| + |B| * |C| - trace((A#B) * (D#C))
+        VectorRegister trace = VectorMultiply(adjugateAB, VectorShuffle<0, 2, 1, 3>(adjugateDC));
+        trace = VectorAdd(trace, VectorShuffle<2, 3, 0, 1>(trace));
+        trace = VectorAdd(trace, VectorShuffle<1, 0, 3, 2>(trace));
+        const VectorRegister detM = VectorSubtract(VectorMultiplyAdd(detB, detC, VectorMultiply(detA, detD)), trace);
+        if (VectorGetX(detM) == 0.0f)
+        {
+            return Identity;
+        }
+
+        // sign of adjugate
+        const VectorRegister rdet = VectorDivide(MakeVectorRegister(1.0f, -1.0f, -1.0f, 1.0f), detM);
+        x = VectorMultiply(x, rdet);
+        y = VectorMultiply(y, rdet);
+        z = VectorMultiply(z, rdet);
+        w = VectorMultiply(w, rdet);
+
+        // adjugate swaps are folded into the shuffle back to rows
+        Matrix inverse;
+        VectorStoreAligned(VectorShuffle<3, 1, 3, 1>(x, y), inverse.M[0]);
+        VectorStoreAligned(VectorShuffle<2, 0, 2, 0>(x, y), inverse.M[1]);
+        VectorStoreAligned(VectorShuffle<3, 1, 3, 1>(z, w), inverse.M[2]);
+        VectorStoreAligned(VectorShuffle<2, 0, 2, 0>(z, w), inverse.M[3]);
+        return inverse;
+    }
+
+    Vector4f Matrix::TransformVector4(const Vector4f& vector) const
+    {
+        Vector4f result;
+        VectorStore(MatrixRows(*this).TransformVector(VectorLoad(&vector.X)), &result.X);
+        return result;
+    }
+}
+
+#endif
\ No newline at end of file
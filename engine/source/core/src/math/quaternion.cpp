@@ -47,7 +47,7 @@ namespace Engine
 
     Quat Quat::Inverse() const
     {
-        return Conjugate() / Size();
+        return Conjugate() / (X * X + Y * Y + Z * Z + W * W);
     }
 
     Vector3f Quat::RotateVector(const Vector3f& v) const
@@ -78,10 +78,7 @@ namespace Engine
 
     Quat Quat::operator*=(const Quat& other)
     {
-        X = W * other.X + X * other.W + Z * other.Y - Y * other.Z;
-        Y = W * other.Y + Y * other.W + X * other.Z - Z * other.X;
-        Z = W * other.Z + Z * other.W + Y * other.X - X * other.Y;
-        W = W * other.W - X * other.X - Y * other.Y - Z * other.Z;
+        *this = *this * other;
         return *this;
     }
 
@@ -1,9 +1,22 @@
-#if !ENABLE_TRANSFORM_INTRINSICS
-
 #include "math/transform.hpp"
 
+#if !ENABLE_TRANSFORM_INTRINSICS
+
 namespace Engine
 {
+    namespace
+    {
+        Vector3f GetSafeScaleReciprocal(const Vector3f& scale)
+        {
+            Vector3f result;
+            for (int32 i = 0; i < 3; ++i)
+            {
+                result[i] = Math::Abs(scale[i]) <= SMALL_FLOAT ? 0.0f : 1.0f / scale[i];
+            }
+            return result;
+        }
+    }
+
     void Transform::Multiply(const Transform& a, const Transform& b, Transform& result)
     {
         Quat rotationB = b.Rotation;
@@ -26,6 +39,29 @@ namespace Engine
         Multiply(*this, other, *this);
         return *this;
     }
+
+    Transform Transform::Inverse() const
+    {
+        const Quat inverseRotation = Rotation.Inverse();
+        const Vector3f inverseScale = GetSafeScaleReciprocal(Scale);
+        const Vector3f inverseTranslation = inverseRotation.RotateVector(inverseScale * -Translation);
+        return Transform(inverseRotation, inverseTranslation, inverseScale);
+    }
+
+    Vector3f Transform::TransformPosition(const Vector3f& position) const
+    {
+        return Rotation.RotateVector(Scale * position) + Translation;
+    }
+
+    Vector3f Transform::TransformVector(const Vector3f& vector) const
+    {
+        return Rotation.RotateVector(Scale * vector);
+    }
+
+    Vector3f Transform::InverseTransformPosition(const Vector3f& position) const
+    {
+        return Rotation.Inverse().RotateVector(position - Translation) * GetSafeScaleReciprocal(Scale);
+    }
 }
 
 #endif
\ No newline at end of file
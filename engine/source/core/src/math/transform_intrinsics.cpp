@@ -1,17 +1,91 @@
-#pragma once
+#include "math/transform.hpp"
 
 #if ENABLE_TRANSFORM_INTRINSICS
 
-#include "math/transform.hpp"
-
 namespace Engine
 {
+    Transform::Transform()
+        : Rotation(MakeVectorRegister(0.0f, 0.0f, 0.0f, 1.0f))
+        , Translation(VectorZero())
+        , Scale(MakeVectorRegister(1.0f, 1.0f, 1.0f, 0.0f))
+    {}
 
-    Engine::Transform::Transform()
-        : Rotation(VectorSetW(VectorZero(), 1.0f))
+    Transform::Transform(const Quat& rotation)
+        : Rotation(VectorLoadAligned(&rotation.X))
         , Translation(VectorZero())
-        , Scale(VectorSetW(MakeVectorRegister(1.0f), 0.0f))
+        , Scale(MakeVectorRegister(1.0f, 1.0f, 1.0f, 0.0f))
+    {}
+
+    Transform::Transform(const Vector3f& location)
+        : Rotation(MakeVectorRegister(0.0f, 0.0f, 0.0f, 1.0f))
+        , Translation(VectorLoadFloat3(&location.X))
+        , Scale(MakeVectorRegister(1.0f, 1.0f, 1.0f, 0.0f))
+    {}
+
+    Transform::Transform(const Quat& rotation, const Vector3f& location, const Vector3f& scale)
+        : Rotation(VectorLoadAligned(&rotation.X))
+        , Translation(VectorLoadFloat3(&location.X))
+        , Scale(VectorLoadFloat3(&scale.X))
     {}
+
+    void Transform::Multiply(const Transform& a, const Transform& b, Transform& result)
+    {
+        const VectorRegister rotationB = b.Rotation;
+        const VectorRegister scaleB = b.Scale;
+        const VectorRegister translationB = b.Translation;
+        const VectorRegister scaledTranslation = VectorMultiply(scaleB, a.Translation);
+
+        result.Rotation = VectorQuaternionMultiply(a.Rotation, rotationB);
+        result.Scale = VectorMultiply(a.Scale, scaleB);
+        result.Translation = VectorAdd(VectorQuaternionRotateVector(rotationB, scaledTranslation), translationB);
+    }
+
+    Transform Transform::operator*(const Transform& other) const
+    {
+        Transform result;
+        Multiply(*this, other, result);
+        return result;
+    }
+
+    Transform Transform::operator*=(const Transform& other)
+    {
+        Multiply(*this, other, *this);
+        return *this;
+    }
+
+    Transform Transform::Inverse() const
+    {
+        Transform result;
+        result.Rotation = VectorQuaternionInverse(Rotation);
+        result.Scale = VectorReciprocalSafe(Scale);
+        result.Translation = VectorQuaternionRotateVector(result.Rotation, VectorMultiply(result.Scale, VectorNegate(Translation)));
+        return result;
+    }
+
+    Vector3f Transform::TransformPosition(const Vector3f& position) const
+    {
+        const VectorRegister scaled = VectorMultiply(Scale, VectorLoadFloat3(&position.X));
+        Vector3f result;
+        VectorStoreFloat3(VectorAdd(VectorQuaternionRotateVector(Rotation, scaled), Translation), &result.X);
+        return result;
+    }
+
+    Vector3f Transform::TransformVector(const Vector3f& vector) const
+    {
+        const VectorRegister scaled = VectorMultiply(Scale, VectorLoadFloat3(&vector.X));
+        Vector3f result;
+        VectorStoreFloat3(VectorQuaternionRotateVector(Rotation, scaled), &result.X);
+        return result;
+    }
+
+    Vector3f Transform::InverseTransformPosition(const Vector3f& position) const
+    {
+        const VectorRegister translated = VectorSubtract(VectorLoadFloat3(&position.X), Translation);
+        const VectorRegister unrotated = VectorQuaternionRotateVector(VectorQuaternionInverse(Rotation), translated);
+        Vector3f result;
+        VectorStoreFloat3(VectorMultiply(unrotated, VectorReciprocalSafe(Scale)), &result.X);
+        return result;
+    }
 }
 
 #endif
\ No newline at end of file
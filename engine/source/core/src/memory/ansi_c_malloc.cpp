@@ -3,37 +3,179 @@
 #include "memory/memory.hpp"
 #include "math/align_utils.hpp"
 #include "math/generic_math.hpp"
+#include <malloc.h>
 
 namespace Engine
 {
+    /** alignment guaranteed by crt malloc on 64 bit platforms */
+    static constexpr uint32 MALLOC_ALIGNMENT = 16;
+
+#if !PLATFORM_WINDOWS
+    /** most bytes a shrink may leave unused at the end of block when it's resized in place */
+    static constexpr size_t SHRINK_IN_PLACE_SLACK = 64;
+#endif
+
+#if PLATFORM_WINDOWS
+    /**
+     * Memory of _aligned_malloc must be released by _aligned_free, to free every allocation the same way
+     * raw pointer of malloc is stored right before the result. Default alignment costs MALLOC_ALIGNMENT bytes.
+     */
+    static void*& GetRawPtr(void* ptr)
+    {
+        return *reinterpret_cast<void**>(static_cast<uint8*>(ptr) - sizeof(void*));
+    }
+
+    static size_t GetRawOffset(void* ptr)
+    {
+        return static_cast<uint8*>(ptr) - static_cast<uint8*>(GetRawPtr(ptr));
+    }
+
     void* AnsiCMalloc::Malloc(size_t size, uint32 alignment)
     {
-        void* ptr = malloc(size + alignment + sizeof(void*) + sizeof(size_t));
-        void* result;
-        result = Align((uint8*)ptr + sizeof(void*) + sizeof(size_t), alignment);
-        *((void**)((uint8*)result - sizeof(void*))) = ptr;
-        *((size_t*)((uint8*)result - sizeof(void*) - sizeof(size_t))) = size;
+        if (alignment <= MALLOC_ALIGNMENT)
+        {
+            void* ptr = ::malloc(size + MALLOC_ALIGNMENT);
+            if (ptr == nullptr)
+            {
+                return nullptr;
+            }
+            void* result = static_cast<uint8*>(ptr) + MALLOC_ALIGNMENT;
+            GetRawPtr(result) = ptr;
+            return result;
+        }
+
+        void* ptr = ::malloc(size + alignment + sizeof(void*));
+        if (ptr == nullptr)
+        {
+            return nullptr;
+        }
+        void* result = Align(static_cast<uint8*>(ptr) + sizeof(void*), alignment);
+        GetRawPtr(result) = ptr;
         return result;
     }
 
     void AnsiCMalloc::Free(void* ptr)
     {
-        free(*((void**)((uint8*)ptr - sizeof(void*))));
+        if (ptr != nullptr)
+        {
+            ::free(GetRawPtr(ptr));
+        }
     }
 
     void* AnsiCMalloc::Realloc(void* ptr, size_t size, uint32 alignment)
     {
-        alignment = Math::Max(size >= 16 ? (uint32)16 : (uint32)8, alignment);
+        if (ptr == nullptr)
+        {
+            return Malloc(size, alignment);
+        }
+
+        if (size == 0)
+        {
+            Free(ptr);
+            return nullptr;
+        }
+
+        if (IsAligned(ptr, alignment) && TryResizeInPlace(ptr, size))
+        {
+            return ptr;
+        }
+
+        // crt realloc keeps offset of result, which is still aligned for default alignment
+        if (alignment <= MALLOC_ALIGNMENT && GetRawOffset(ptr) == MALLOC_ALIGNMENT)
+        {
+            void* newRaw = ::realloc(GetRawPtr(ptr), size + MALLOC_ALIGNMENT);
+            if (newRaw == nullptr)
+            {
+                return nullptr;
+            }
+            void* result = static_cast<uint8*>(newRaw) + MALLOC_ALIGNMENT;
+            GetRawPtr(result) = newRaw;
+            return result;
+        }
 
         void* newPtr = Malloc(size, alignment);
-        size_t rawSize = GetAllocateSize(ptr);
-        Memory::Memcpy(newPtr, ptr, Math::Min(size, rawSize));
-        Free(ptr);
+        if (newPtr != nullptr)
+        {
+            Memory::Memcpy(newPtr, ptr, Math::Min(size, GetAllocationSize(ptr)));
+            Free(ptr);
+        }
         return newPtr;
     }
 
-    size_t AnsiCMalloc::GetAllocateSize(void* ptr)
+    size_t AnsiCMalloc::GetAllocationSize(void* ptr)
+    {
+        return ::_msize(GetRawPtr(ptr)) - GetRawOffset(ptr);
+    }
+
+    bool AnsiCMalloc::TryResizeInPlace(void* ptr, size_t newSize)
+    {
+        const size_t offset = GetRawOffset(ptr);
+        return ::_expand(GetRawPtr(ptr), newSize + offset) != nullptr;
+    }
+#else
+    void* AnsiCMalloc::Malloc(size_t size, uint32 alignment)
+    {
+        if (alignment <= MALLOC_ALIGNMENT)
+        {
+            return ::malloc(size);
+        }
+
+        void* ptr = nullptr;
+        if (::posix_memalign(&ptr, Math::Max(static_cast<size_t>(alignment), sizeof(void*)), size) != 0)
+        {
+            return nullptr;
+        }
+        return ptr;
+    }
+
+    void AnsiCMalloc::Free(void* ptr)
+    {
+        ::free(ptr);
+    }
+
+    void* AnsiCMalloc::Realloc(void* ptr, size_t size, uint32 alignment)
+    {
+        if (ptr == nullptr)
+        {
+            return Malloc(size, alignment);
+        }
+
+        if (size == 0)
+        {
+            Free(ptr);
+            return nullptr;
+        }
+
+        if (IsAligned(ptr, alignment) && TryResizeInPlace(ptr, size))
+        {
+            return ptr;
+        }
+
+        if (alignment <= MALLOC_ALIGNMENT)
+        {
+            return ::realloc(ptr, size);
+        }
+
+        void* newPtr = Malloc(size, alignment);
+        if (newPtr != nullptr)
+        {
+            Memory::Memcpy(newPtr, ptr, Math::Min(size, GetAllocationSize(ptr)));
+            Free(ptr);
+        }
+        return newPtr;
+    }
+
+    size_t AnsiCMalloc::GetAllocationSize(void* ptr)
+    {
+        return ::malloc_usable_size(ptr);
+    }
+
+    bool AnsiCMalloc::TryResizeInPlace(void* ptr, size_t newSize)
     {
-        return *((size_t*)((uint8*)ptr - sizeof(void*) - sizeof(size_t)));
+        // malloc has no in place resizing api, only the slack of block can be used. Keeping a block for a bigger shrink
+        // would never give memory back, realloc can split the block or move it to a smaller size class
+        const size_t usableSize = ::malloc_usable_size(ptr);
+        return newSize <= usableSize && usableSize - newSize <= SHRINK_IN_PLACE_SLACK;
     }
+#endif
 }
\ No newline at end of file
@@ -0,0 +1,82 @@
+#include "global.hpp"
+#if PLATFORM_LINUX
+#include "linux/linux_memory.hpp"
+#include "memory/ansi_c_malloc.hpp"
+#include <cstring>
+#include <execinfo.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace Engine
+{
+    uint32 LinuxMemory::SDefaultAlignment = 16;
+
+    IMalloc* LinuxMemory::GetDefaultMalloc()
+    {
+        return new AnsiCMalloc();
+    }
+
+    uint32 LinuxMemory::GetDefaultAlignment()
+    {
+        return SDefaultAlignment;
+    }
+
+    void LinuxMemory::Memcpy(void* dest, void const* src, size_t size)
+    {
+        ::memcpy(dest, src, size);
+    }
+
+    void LinuxMemory::Memmove(void* dest, void* src, size_t size)
+    {
+        ::memmove(dest, src, size);
+    }
+
+    void LinuxMemory::Memset(void* dest, uint8 byte, size_t size)
+    {
+        ::memset(dest, byte, size);
+    }
+
+    bool LinuxMemory::Memcmp(void* lBuffer, void* rBuffer, size_t size)
+    {
+        return ::memcmp(lBuffer, rBuffer, size) == 0;
+    }
+
+    int32 LinuxMemory::CaptureCallstack(void** frames, int32 maxDepth)
+    {
+        void* buffer[64];
+        const int32 depth = ::backtrace(buffer, maxDepth + 1 < 64 ? maxDepth + 1 : 64);
+        // skip the frame of this function
+        const int32 count = depth > 1 ? depth - 1 : 0;
+        ::memcpy(frames, buffer + 1, count * sizeof(void*));
+        return count;
+    }
+
+    size_t LinuxMemory::GetPageSize()
+    {
+        static const size_t pageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        return pageSize;
+    }
+
+    void* LinuxMemory::Reserve(size_t size)
+    {
+        void* ptr = ::mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        return ptr == MAP_FAILED ? nullptr : ptr;
+    }
+
+    bool LinuxMemory::Commit(void* ptr, size_t size)
+    {
+        return ::mprotect(ptr, size, PROT_READ | PROT_WRITE) == 0;
+    }
+
+    void LinuxMemory::Decommit(void* ptr, size_t size)
+    {
+        ::madvise(ptr, size, MADV_DONTNEED);
+        ::mprotect(ptr, size, PROT_NONE);
+    }
+
+    void LinuxMemory::Release(void* ptr, size_t size)
+    {
+        ::munmap(ptr, size);
+    }
+}
+#endif
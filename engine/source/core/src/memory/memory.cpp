@@ -2,12 +2,16 @@
 #include "core_minimal_private.hpp"
 #include "memory/memory.hpp"
 #include "memory/malloc_interface.hpp"
+#include "memory/memory_tracker.hpp"
 #include "math/limit.hpp"
+#include "stats/stats.hpp"
 
 namespace Engine
 {
     IMalloc* GMalloc = nullptr;
 
+    static StatCounter GStatAllocations("Memory.Allocations", "allocations made by engine allocator");
+
     void* Memory::Malloc(size_t size)
     {
         return Malloc(size, PlatformMemory::GetDefaultAlignment());
@@ -16,11 +20,16 @@ namespace Engine
     void* Memory::Malloc(size_t size, uint32 alignment)
     {
         IMalloc* gMalloc = GetGMalloc();
+        GStatAllocations.Add();
         return gMalloc->Malloc(size, alignment);
     }
 
     void Memory::Free(void* ptr)
     {
+        if (ptr == nullptr)
+        {
+            return;
+        }
         IMalloc* gMalloc = GetGMalloc();
         gMalloc->Free(ptr);
     }
@@ -28,9 +37,33 @@ namespace Engine
     void* Memory::Realloc(void* ptr, size_t newSize, uint32 alignment)
     {
         IMalloc* gMalloc = GetGMalloc();
+        if (ptr == nullptr)
+        {
+            GStatAllocations.Add();
+        }
         return gMalloc->Realloc(ptr, newSize, alignment);
     }
 
+    size_t Memory::GetAllocationSize(void* ptr)
+    {
+        if (ptr == nullptr)
+        {
+            return 0;
+        }
+        IMalloc* gMalloc = GetGMalloc();
+        return gMalloc->GetAllocationSize(ptr);
+    }
+
+    bool Memory::TryResizeInPlace(void* ptr, size_t newSize)
+    {
+        if (ptr == nullptr)
+        {
+            return false;
+        }
+        IMalloc* gMalloc = GetGMalloc();
+        return gMalloc->TryResizeInPlace(ptr, newSize);
+    }
+
     void Memory::Memcpy(void* dest, void const* src, size_t size)
     {
         PlatformMemory::Memcpy(dest, src, size);
@@ -287,11 +320,21 @@ namespace Engine
 
     void Memory::Shutdown()
     {
+#if ENABLE_MEMORY_TRACKING
+        if (MemoryTracker* tracker = MemoryTracker::Get())
+        {
+            tracker->DumpStats();
+            tracker->ReportLeaks();
+        }
+#endif
+#if !ENABLE_MEMORY_TRACKING && !ENABLE_OVERRIDE_NEW_DELETE
         if (GMalloc != nullptr)
         {
             delete GMalloc;
             GMalloc = nullptr;
         }
+#endif
+        // otherwise allocations freed by static destructors are still alive here, GMalloc is kept to serve them
     }
 
     void Memory::NormalizeOffset(uint32* data, int32& offset)
@@ -314,6 +357,11 @@ namespace Engine
         if (GMalloc == nullptr)
         {
             GMalloc = PlatformMemory::GetDefaultMalloc();
+#if ENABLE_MEMORY_TRACKING
+            MemoryTracker* tracker = new MemoryTracker(GMalloc);
+            MemoryTracker::Install(tracker);
+            GMalloc = tracker;
+#endif
         }
         ENSURE(GMalloc);
         return GMalloc;
@@ -0,0 +1,8 @@
+#pragma once
+
+#include "log/logger.hpp"
+
+namespace Engine
+{
+    DECLARE_LOG_CATEGORY(Memory);
+}
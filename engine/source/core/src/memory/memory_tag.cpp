@@ -0,0 +1,63 @@
+#include "memory/memory_tag.hpp"
+#include "math/generic_math.hpp"
+
+namespace Engine
+{
+    static constexpr const char* MEMORY_TAG_NAMES[] =
+    {
+        "Untagged",
+        "Container",
+        "String",
+        "Object",
+        "Delegate",
+        "Taskflow",
+        "FileSystem",
+        "Log",
+        "Module",
+        "Render",
+        "Application",
+    };
+    static_assert(sizeof(MEMORY_TAG_NAMES) / sizeof(MEMORY_TAG_NAMES[0]) == static_cast<size_t>(EMemoryTag::Count));
+
+    const char* GetMemoryTagName(EMemoryTag tag)
+    {
+        return tag < EMemoryTag::Count ? MEMORY_TAG_NAMES[static_cast<int32>(tag)] : "Invalid";
+    }
+
+    struct MemoryTagStack
+    {
+        static constexpr int32 MAX_DEPTH = 32;
+
+        EMemoryTag Tags[MAX_DEPTH];
+        int32 Depth{ 0 };
+    };
+
+    static thread_local MemoryTagStack GMemoryTagStack;
+
+    MemoryTagScope::MemoryTagScope(EMemoryTag tag)
+    {
+        MemoryTagStack& stack = GMemoryTagStack;
+        ENSURE(stack.Depth < MemoryTagStack::MAX_DEPTH);
+        // tags deeper than MAX_DEPTH are dropped, outer tag is used instead
+        if (stack.Depth < MemoryTagStack::MAX_DEPTH)
+        {
+            stack.Tags[stack.Depth] = tag;
+        }
+        ++stack.Depth;
+    }
+
+    MemoryTagScope::~MemoryTagScope()
+    {
+        --GMemoryTagStack.Depth;
+    }
+
+    EMemoryTag MemoryTagScope::GetCurrentTag()
+    {
+        const MemoryTagStack& stack = GMemoryTagStack;
+        if (stack.Depth <= 0)
+        {
+            return EMemoryTag::Untagged;
+        }
+        return stack.Tags[Math::Min(stack.Depth, MemoryTagStack::MAX_DEPTH) - 1];
+    }
+}
\ No newline at end of file
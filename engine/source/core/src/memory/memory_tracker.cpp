@@ -0,0 +1,354 @@
+#include "memory/memory_tracker.hpp"
+#include "memory/memory.hpp"
+#include "memory/memory_log.hpp"
+#include "math/align_utils.hpp"
+#include "math/generic_math.hpp"
+#include <bit>
+
+namespace Engine
+{
+    /** placed right before the pointer returned to user */
+    struct MemoryTracker::AllocationHeader
+    {
+        void* RawPtr;
+        size_t Size;
+        AllocationHeader* Prev;
+        AllocationHeader* Next;
+        Callstack* Stack;
+        EMemoryTag Tag;
+        /** shard of ListShards the header is linked to, freeing thread may be another one */
+        uint8 ShardIndex;
+    };
+
+    static MemoryTracker* GMemoryTracker = nullptr;
+
+    MemoryTracker::MemoryTracker(IMalloc* innerMalloc)
+        : InnerMalloc(innerMalloc)
+    {
+        ENSURE(InnerMalloc);
+        for (std::atomic<uint64>& bucket : SizeHistogram)
+        {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    MemoryTracker::~MemoryTracker()
+    {
+        if (GMemoryTracker == this)
+        {
+            GMemoryTracker = nullptr;
+        }
+        delete InnerMalloc;
+    }
+
+    MemoryTracker* MemoryTracker::Get()
+    {
+        return GMemoryTracker;
+    }
+
+    void MemoryTracker::Install(MemoryTracker* tracker)
+    {
+        GMemoryTracker = tracker;
+    }
+
+    void* MemoryTracker::Malloc(size_t size, uint32 alignment)
+    {
+        return TrackedMalloc(size, alignment, MemoryTagScope::GetCurrentTag());
+    }
+
+    void MemoryTracker::Free(void* ptr)
+    {
+        if (ptr == nullptr)
+        {
+            return;
+        }
+
+        AllocationHeader* header = GetHeader(ptr);
+        {
+            ListShard& shard = ListShards[header->ShardIndex];
+            std::scoped_lock lock(shard.Mutex);
+            if (header->Prev != nullptr)
+            {
+                header->Prev->Next = header->Next;
+            }
+            else
+            {
+                shard.Head = header->Next;
+            }
+            if (header->Next != nullptr)
+            {
+                header->Next->Prev = header->Prev;
+            }
+        }
+
+        OnFree(header->Size, header->Tag);
+        if (header->Stack != nullptr)
+        {
+            InnerMalloc->Free(header->Stack);
+        }
+        InnerMalloc->Free(header->RawPtr);
+    }
+
+    void* MemoryTracker::Realloc(void* ptr, size_t size, uint32 alignment)
+    {
+        if (ptr == nullptr)
+        {
+            return Malloc(size, alignment);
+        }
+
+        if (size == 0)
+        {
+            Free(ptr);
+            return nullptr;
+        }
+
+        if (IsAligned(ptr, alignment) && TryResizeInPlace(ptr, size))
+        {
+            return ptr;
+        }
+
+        AllocationHeader* header = GetHeader(ptr);
+        void* newPtr = TrackedMalloc(size, alignment, header->Tag);
+        if (newPtr == nullptr)
+        {
+            // same as realloc, original block stays valid when out of memory
+            return nullptr;
+        }
+        Memory::Memcpy(newPtr, ptr, Math::Min(size, header->Size));
+        Free(ptr);
+        return newPtr;
+    }
+
+    void MemoryTracker::SetupCurrentThreadTLS()
+    {
+        InnerMalloc->SetupCurrentThreadTLS();
+    }
+
+    size_t MemoryTracker::GetAllocationSize(void* ptr)
+    {
+        AllocationHeader* header = GetHeader(ptr);
+        const size_t rawSize = InnerMalloc->GetAllocationSize(header->RawPtr);
+        const size_t offset = static_cast<uint8*>(ptr) - static_cast<uint8*>(header->RawPtr);
+        return rawSize > offset ? rawSize - offset : 0;
+    }
+
+    bool MemoryTracker::TryResizeInPlace(void* ptr, size_t newSize)
+    {
+        AllocationHeader* header = GetHeader(ptr);
+        const size_t offset = static_cast<uint8*>(ptr) - static_cast<uint8*>(header->RawPtr);
+        if (!InnerMalloc->TryResizeInPlace(header->RawPtr, newSize + offset))
+        {
+            return false;
+        }
+
+        // same allocation, only live and peak bytes change
+        OnResize(header->Size, newSize, header->Tag);
+        header->Size = newSize;
+        return true;
+    }
+
+    MemoryTrackerStats MemoryTracker::GetStats() const
+    {
+        MemoryTrackerStats stats;
+        for (int32 index = 0; index < static_cast<int32>(EMemoryTag::Count); ++index)
+        {
+            const TagCounter& counter = TagCounters[index];
+            MemoryTagStats& tagStats = stats.Tags[index];
+            tagStats.AllocatedBytes = counter.AllocatedBytes.load(std::memory_order_relaxed);
+            tagStats.PeakBytes = counter.PeakBytes.load(std::memory_order_relaxed);
+            tagStats.AllocationCount = counter.AllocationCount.load(std::memory_order_relaxed);
+            tagStats.TotalAllocationCount = counter.TotalAllocationCount.load(std::memory_order_relaxed);
+        }
+
+        stats.AllocatedBytes = AllocatedBytes.load(std::memory_order_relaxed);
+        stats.PeakBytes = PeakBytes.load(std::memory_order_relaxed);
+        stats.AllocationCount = AllocationCount.load(std::memory_order_relaxed);
+        for (int32 index = 0; index < MemoryTrackerStats::HISTOGRAM_BUCKET_NUM; ++index)
+        {
+            stats.SizeHistogram[index] = SizeHistogram[index].load(std::memory_order_relaxed);
+        }
+        return stats;
+    }
+
+    void MemoryTracker::DumpStats() const
+    {
+        const MemoryTrackerStats stats = GetStats();
+        LOG_INFO(Memory, "allocated {0} bytes in {1} allocations, peak {2} bytes", stats.AllocatedBytes, stats.AllocationCount, stats.PeakBytes);
+        for (int32 index = 0; index < static_cast<int32>(EMemoryTag::Count); ++index)
+        {
+            const MemoryTagStats& tagStats = stats.Tags[index];
+            if (tagStats.TotalAllocationCount > 0)
+            {
+                LOG_INFO(Memory, "  {0}: {1} bytes in {2} allocations, peak {3} bytes, total {4} allocations",
+                         GetMemoryTagName(static_cast<EMemoryTag>(index)), tagStats.AllocatedBytes, tagStats.AllocationCount,
+                         tagStats.PeakBytes, tagStats.TotalAllocationCount);
+            }
+        }
+        for (int32 index = 0; index < MemoryTrackerStats::HISTOGRAM_BUCKET_NUM; ++index)
+        {
+            if (stats.SizeHistogram[index] > 0)
+            {
+                LOG_INFO(Memory, "  [{0}, {1}) bytes: {2} allocations", index == 0 ? 0 : (uint64)1 << index, (uint64)1 << (index + 1), stats.SizeHistogram[index]);
+            }
+        }
+    }
+
+    int64 MemoryTracker::ReportLeaks(int32 maxReportNum) const
+    {
+        struct LeakRecord
+        {
+            size_t Size;
+            EMemoryTag Tag;
+            Callstack Stack;
+        };
+
+        // copy records out of the lists first, logging allocates and must not run under a shard lock
+        int64 leakCount = 0;
+        int32 recordNum = 0;
+        LeakRecord* records = static_cast<LeakRecord*>(InnerMalloc->Malloc(sizeof(LeakRecord) * Math::Max(maxReportNum, 1), alignof(LeakRecord)));
+        for (ListShard& shard : ListShards)
+        {
+            std::scoped_lock lock(shard.Mutex);
+            for (AllocationHeader* header = shard.Head; header != nullptr; header = header->Next)
+            {
+                if (recordNum < maxReportNum)
+                {
+                    LeakRecord& record = records[recordNum++];
+                    record.Size = header->Size;
+                    record.Tag = header->Tag;
+                    record.Stack.Depth = 0;
+                    if (header->Stack != nullptr)
+                    {
+                        record.Stack = *header->Stack;
+                    }
+                }
+                ++leakCount;
+            }
+        }
+
+        if (leakCount > 0)
+        {
+            const MemoryTrackerStats stats = GetStats();
+            LOG_WARN(Memory, "{0} allocations ({1} bytes) are still alive", leakCount, stats.AllocatedBytes);
+            for (int32 index = 0; index < static_cast<int32>(EMemoryTag::Count); ++index)
+            {
+                const MemoryTagStats& tagStats = stats.Tags[index];
+                if (tagStats.AllocationCount > 0)
+                {
+                    LOG_WARN(Memory, "  {0}: {1} bytes in {2} allocations", GetMemoryTagName(static_cast<EMemoryTag>(index)),
+                             tagStats.AllocatedBytes, tagStats.AllocationCount);
+                }
+            }
+
+            for (int32 index = 0; index < recordNum; ++index)
+            {
+                const LeakRecord& record = records[index];
+                LOG_WARN(Memory, "  leak {0} bytes, tag {1}", record.Size, GetMemoryTagName(record.Tag));
+                for (int32 frame = 0; frame < record.Stack.Depth; ++frame)
+                {
+                    LOG_WARN(Memory, "    #{0} {1}", frame, record.Stack.Frames[frame]);
+                }
+            }
+        }
+
+        InnerMalloc->Free(records);
+        return leakCount;
+    }
+
+    void* MemoryTracker::TrackedMalloc(size_t size, uint32 alignment, EMemoryTag tag)
+    {
+        alignment = Math::Max(alignment, static_cast<uint32>(alignof(AllocationHeader)));
+        const size_t headerSize = Align(sizeof(AllocationHeader), static_cast<uint64>(alignment));
+        uint8* rawPtr = static_cast<uint8*>(InnerMalloc->Malloc(size + headerSize, alignment));
+        if (rawPtr == nullptr)
+        {
+            return nullptr;
+        }
+
+        uint8* result = rawPtr + headerSize;
+        AllocationHeader* header = GetHeader(result);
+        header->RawPtr = rawPtr;
+        header->Size = size;
+        header->Tag = tag;
+        header->Prev = nullptr;
+        header->Stack = nullptr;
+
+        if (IsCaptureCallstack())
+        {
+            Callstack* stack = static_cast<Callstack*>(InnerMalloc->Malloc(sizeof(Callstack), alignof(Callstack)));
+            if (stack != nullptr)
+            {
+                stack->Depth = PlatformMemory::CaptureCallstack(stack->Frames, MAX_CALLSTACK_DEPTH);
+            }
+            header->Stack = stack;
+        }
+
+        const int32 shardIndex = GetThreadShardIndex();
+        header->ShardIndex = static_cast<uint8>(shardIndex);
+        {
+            ListShard& shard = ListShards[shardIndex];
+            std::scoped_lock lock(shard.Mutex);
+            header->Next = shard.Head;
+            if (shard.Head != nullptr)
+            {
+                shard.Head->Prev = header;
+            }
+            shard.Head = header;
+        }
+
+        OnAllocate(size, tag);
+        return result;
+    }
+
+    void MemoryTracker::OnAllocate(size_t size, EMemoryTag tag)
+    {
+        TagCounter& counter = TagCounters[static_cast<int32>(tag)];
+        const int64 bytes = static_cast<int64>(size);
+        UpdatePeak(counter.PeakBytes, counter.AllocatedBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes);
+        counter.AllocationCount.fetch_add(1, std::memory_order_relaxed);
+        counter.TotalAllocationCount.fetch_add(1, std::memory_order_relaxed);
+
+        UpdatePeak(PeakBytes, AllocatedBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes);
+        AllocationCount.fetch_add(1, std::memory_order_relaxed);
+
+        const int32 bucket = size == 0 ? 0 : static_cast<int32>(std::bit_width(static_cast<uint64>(size))) - 1;
+        SizeHistogram[Math::Min(bucket, MemoryTrackerStats::HISTOGRAM_BUCKET_NUM - 1)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void MemoryTracker::OnFree(size_t size, EMemoryTag tag)
+    {
+        TagCounter& counter = TagCounters[static_cast<int32>(tag)];
+        const int64 bytes = static_cast<int64>(size);
+        counter.AllocatedBytes.fetch_sub(bytes, std::memory_order_relaxed);
+        counter.AllocationCount.fetch_sub(1, std::memory_order_relaxed);
+
+        AllocatedBytes.fetch_sub(bytes, std::memory_order_relaxed);
+        AllocationCount.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void MemoryTracker::OnResize(size_t oldSize, size_t newSize, EMemoryTag tag)
+    {
+        TagCounter& counter = TagCounters[static_cast<int32>(tag)];
+        const int64 delta = static_cast<int64>(newSize) - static_cast<int64>(oldSize);
+        UpdatePeak(counter.PeakBytes, counter.AllocatedBytes.fetch_add(delta, std::memory_order_relaxed) + delta);
+        UpdatePeak(PeakBytes, AllocatedBytes.fetch_add(delta, std::memory_order_relaxed) + delta);
+    }
+
+    int32 MemoryTracker::GetThreadShardIndex()
+    {
+        static std::atomic<int32> nextShard{ 0 };
+        thread_local int32 shardIndex = nextShard.fetch_add(1, std::memory_order_relaxed) % LIST_SHARD_NUM;
+        return shardIndex;
+    }
+
+    MemoryTracker::AllocationHeader* MemoryTracker::GetHeader(void* ptr)
+    {
+        return reinterpret_cast<AllocationHeader*>(static_cast<uint8*>(ptr) - sizeof(AllocationHeader));
+    }
+
+    void MemoryTracker::UpdatePeak(std::atomic<int64>& peak, int64 value)
+    {
+        int64 current = peak.load(std::memory_order_relaxed);
+        while (value > current && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed));
+    }
+}
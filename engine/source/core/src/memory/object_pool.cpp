@@ -0,0 +1,347 @@
+#include "memory/object_pool.hpp"
+#include "memory/memory.hpp"
+#include "memory/platform_memory.hpp"
+#include "foundation/array.hpp"
+#include "math/align_utils.hpp"
+#include "math/generic_math.hpp"
+
+namespace Engine
+{
+    /**
+     * Registry of alive pools, index is never reused so that a thread cache can't hand out
+     * elements of a destroyed pool to a new one.
+     * It's never destroyed since worker threads may exit after static destruction.
+     */
+    class PoolRegistry
+    {
+    public:
+        static PoolRegistry& Get()
+        {
+            static PoolRegistry* registry = new PoolRegistry();
+            return *registry;
+        }
+
+        uint32 Register(FixedSizePool* pool)
+        {
+            std::scoped_lock lock(Mutex);
+            Pools.Add(pool);
+            return static_cast<uint32>(Pools.Size() - 1);
+        }
+
+        void Unregister(uint32 index)
+        {
+            std::scoped_lock lock(Mutex);
+            Pools[index] = nullptr;
+        }
+
+        std::mutex Mutex;
+        Array<FixedSizePool*> Pools;
+    };
+
+    class PoolThreadCache
+    {
+    public:
+        using LocalCache = FixedSizePool::LocalCache;
+
+        static PoolThreadCache& Get()
+        {
+            thread_local PoolThreadCache cache;
+            return cache;
+        }
+
+        ~PoolThreadCache()
+        {
+            PoolRegistry& registry = PoolRegistry::Get();
+            std::scoped_lock lock(registry.Mutex);
+            for (int32 index = 0; index < Caches.Size(); ++index)
+            {
+                LocalCache& cache = Caches[index];
+                if (index < registry.Pools.Size() && registry.Pools[index] != nullptr)
+                {
+                    Flush(*registry.Pools[index], cache);
+                }
+            }
+        }
+
+        LocalCache& Find(uint32 poolIndex)
+        {
+            if (UNLIKELY(static_cast<int32>(poolIndex) >= Caches.Size()))
+            {
+                Caches.Resize(static_cast<int32>(poolIndex) + 1);
+            }
+            return Caches[static_cast<int32>(poolIndex)];
+        }
+
+        static void Flush(FixedSizePool& pool, LocalCache& cache)
+        {
+            if (cache.Head != nullptr)
+            {
+                pool.ReturnBatch(cache.Head, cache.Count);
+                cache.Head = nullptr;
+                cache.Count = 0;
+            }
+            pool.MergeStats(cache);
+        }
+
+    private:
+        Array<LocalCache> Caches;
+    };
+
+    FixedSizePool::FixedSizePool(size_t elementSize, uint32 alignment, int32 elementsPerBlock, int32 batchSize)
+        : ElementSize(elementSize)
+        , Alignment(Math::Max(alignment, static_cast<uint32>(alignof(FreeNode))))
+        , BatchSize(Math::Max(batchSize, 1))
+    {
+        // segments are page aligned, so is every block in them
+        ENSURE(Alignment <= PlatformMemory::GetPageSize());
+        Stride = Align(Math::Max(elementSize, sizeof(FreeNode)), Alignment);
+        // a block always contains whole batches
+        ElementsPerBlock = (Math::Max(elementsPerBlock, BatchSize) + BatchSize - 1) / BatchSize * BatchSize;
+        BlockSize = Stride * ElementsPerBlock;
+        PoolIndex = PoolRegistry::Get().Register(this);
+    }
+
+    FixedSizePool::~FixedSizePool()
+    {
+        PoolRegistry::Get().Unregister(PoolIndex);
+
+        const int32 segmentNum = SegmentNum.load(std::memory_order_relaxed);
+        for (int32 index = 0; index < segmentNum; ++index)
+        {
+            PlatformMemory::Release(SegmentBases[index], SegmentSizes[index]);
+        }
+        SegmentNum.store(0, std::memory_order_relaxed);
+        Memory::Free(DepotBatches);
+        DepotBatches = nullptr;
+        DepotBatchNum = 0;
+    }
+
+    void* FixedSizePool::Allocate()
+    {
+        LocalCache& cache = PoolThreadCache::Get().Find(PoolIndex);
+        if (UNLIKELY(cache.Head == nullptr))
+        {
+            MergeStats(cache);
+            cache.Head = FetchBatch(cache.Count);
+        }
+
+        FreeNode* node = cache.Head;
+        cache.Head = node->Next;
+        --cache.Count;
+        ++cache.AllocateCount;
+        return node;
+    }
+
+    void FixedSizePool::Free(void* ptr)
+    {
+        if (ptr == nullptr)
+        {
+            return;
+        }
+
+        LocalCache& cache = PoolThreadCache::Get().Find(PoolIndex);
+        FreeNode* node = static_cast<FreeNode*>(ptr);
+        node->Next = cache.Head;
+        cache.Head = node;
+        ++cache.Count;
+        ++cache.FreeCount;
+
+        // keep one batch locally so that alternate allocate and free won't bounce on depot
+        if (UNLIKELY(cache.Count >= BatchSize * 2))
+        {
+            FreeNode* batchHead = cache.Head;
+            FreeNode* batchTail = batchHead;
+            for (int32 index = 1; index < BatchSize; ++index)
+            {
+                batchTail = batchTail->Next;
+            }
+            cache.Head = batchTail->Next;
+            cache.Count -= BatchSize;
+            batchTail->Next = nullptr;
+
+            MergeStats(cache);
+            ReturnBatch(batchHead, BatchSize);
+        }
+    }
+
+    bool FixedSizePool::Owns(const void* ptr) const
+    {
+        const uintptr address = reinterpret_cast<uintptr>(ptr);
+        const int32 segmentNum = SegmentNum.load(std::memory_order_acquire);
+        for (int32 index = 0; index < segmentNum; ++index)
+        {
+            const uintptr base = reinterpret_cast<uintptr>(SegmentBases[index]);
+            if (address >= base && address - base < SegmentSizes[index])
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void FixedSizePool::FlushThreadCache()
+    {
+        PoolThreadCache::Flush(*this, PoolThreadCache::Get().Find(PoolIndex));
+    }
+
+    PoolStats FixedSizePool::GetStats() const
+    {
+        PoolStats stats;
+        stats.AllocateCount = AllocateCount.load(std::memory_order_relaxed);
+        stats.FreeCount = FreeCount.load(std::memory_order_relaxed);
+        stats.LiveCount = static_cast<int64>(stats.AllocateCount) - static_cast<int64>(stats.FreeCount);
+        stats.PeakLiveCount = PeakLiveCount.load(std::memory_order_relaxed);
+        stats.BlockCount = BlockCount.load(std::memory_order_relaxed);
+        stats.DepotFetchCount = DepotFetchCount.load(std::memory_order_relaxed);
+        stats.DepotReturnCount = DepotReturnCount.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    FixedSizePool::FreeNode* FixedSizePool::FetchBatch(int32& outCount)
+    {
+        std::scoped_lock lock(DepotMutex);
+        if (DepotBatchNum == 0)
+        {
+            AllocateBlock();
+        }
+
+        const DepotBatch& batch = DepotBatches[--DepotBatchNum];
+        outCount = batch.Count;
+        DepotFetchCount.fetch_add(1, std::memory_order_relaxed);
+        return batch.Head;
+    }
+
+    void FixedSizePool::ReturnBatch(FreeNode* head, int32 count)
+    {
+        ENSURE(head != nullptr && count > 0);
+        std::scoped_lock lock(DepotMutex);
+        PushBatch(head, count);
+        DepotReturnCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void FixedSizePool::PushBatch(FreeNode* head, int32 count)
+    {
+        if (DepotBatchNum == DepotBatchCapacity)
+        {
+            DepotBatchCapacity = Math::Max(DepotBatchCapacity * 2, ElementsPerBlock / BatchSize);
+            DepotBatches = static_cast<DepotBatch*>(Memory::Realloc(DepotBatches, sizeof(DepotBatch) * DepotBatchCapacity, alignof(DepotBatch)));
+        }
+        DepotBatches[DepotBatchNum++] = DepotBatch{ head, count };
+    }
+
+    void FixedSizePool::AllocateBlock()
+    {
+        const size_t pageSize = PlatformMemory::GetPageSize();
+        int32 segmentNum = SegmentNum.load(std::memory_order_relaxed);
+        if (segmentNum == 0 || SegmentUsed + BlockSize > SegmentSizes[segmentNum - 1])
+        {
+            ENSURE(segmentNum < MAX_SEGMENT_NUM);
+            const size_t reserveSize = Align(BlockSize * (static_cast<size_t>(INITIAL_SEGMENT_BLOCKS) << segmentNum), pageSize);
+            uint8* base = static_cast<uint8*>(PlatformMemory::Reserve(reserveSize));
+            ENSURE(base);
+            SegmentBases[segmentNum] = base;
+            SegmentSizes[segmentNum] = reserveSize;
+            SegmentNum.store(++segmentNum, std::memory_order_release);
+            SegmentUsed = 0;
+            SegmentCommitted = 0;
+        }
+
+        // commit whole pages, a block may share its first and last page with its neighbours
+        uint8* segment = SegmentBases[segmentNum - 1];
+        const size_t blockEnd = SegmentUsed + BlockSize;
+        if (blockEnd > SegmentCommitted)
+        {
+            const size_t commitEnd = Math::Min(Align(blockEnd, pageSize), SegmentSizes[segmentNum - 1]);
+            if (!PlatformMemory::Commit(segment + SegmentCommitted, commitEnd - SegmentCommitted))
+            {
+                ENSURE(false);
+            }
+            SegmentCommitted = commitEnd;
+        }
+
+        uint8* elements = segment + SegmentUsed;
+        SegmentUsed = blockEnd;
+        BlockCount.fetch_add(1, std::memory_order_relaxed);
+
+        // push batches from back to front, so that the first fetched batch is at the head of block
+        for (int32 batchIndex = ElementsPerBlock / BatchSize - 1; batchIndex >= 0; --batchIndex)
+        {
+            uint8* batchStart = elements + Stride * BatchSize * batchIndex;
+            for (int32 index = 0; index < BatchSize; ++index)
+            {
+                FreeNode* node = reinterpret_cast<FreeNode*>(batchStart + Stride * index);
+                node->Next = index + 1 < BatchSize ? reinterpret_cast<FreeNode*>(batchStart + Stride * (index + 1)) : nullptr;
+            }
+            PushBatch(reinterpret_cast<FreeNode*>(batchStart), BatchSize);
+        }
+    }
+
+    void FixedSizePool::MergeStats(LocalCache& cache)
+    {
+        if (cache.AllocateCount == 0 && cache.FreeCount == 0)
+        {
+            return;
+        }
+
+        const uint64 allocated = AllocateCount.fetch_add(cache.AllocateCount, std::memory_order_relaxed) + cache.AllocateCount;
+        const uint64 freed = FreeCount.fetch_add(cache.FreeCount, std::memory_order_relaxed) + cache.FreeCount;
+        cache.AllocateCount = 0;
+        cache.FreeCount = 0;
+
+        const int64 live = static_cast<int64>(allocated) - static_cast<int64>(freed);
+        int64 peak = PeakLiveCount.load(std::memory_order_relaxed);
+        while (live > peak && !PeakLiveCount.compare_exchange_weak(peak, live, std::memory_order_relaxed));
+    }
+
+    static constexpr int32 SMALL_POOL_NUM = static_cast<int32>(SmallObjectPool::MAX_POOLED_SIZE / SmallObjectPool::POOLED_GRANULARITY);
+
+    static FixedSizePool& GetSmallPool(size_t size)
+    {
+        struct SmallPools
+        {
+            SmallPools()
+            {
+                for (int32 index = 0; index < SMALL_POOL_NUM; ++index)
+                {
+                    const size_t elementSize = (index + 1) * SmallObjectPool::POOLED_GRANULARITY;
+                    Pools[index] = new FixedSizePool(elementSize, static_cast<uint32>(SmallObjectPool::POOLED_GRANULARITY));
+                }
+            }
+
+            FixedSizePool* Pools[SMALL_POOL_NUM];
+        };
+
+        // intentionally leaked, pooled objects may be released by worker threads during static destruction
+        static SmallPools* pools = new SmallPools();
+        const size_t index = (size + SmallObjectPool::POOLED_GRANULARITY - 1) / SmallObjectPool::POOLED_GRANULARITY - 1;
+        return *pools->Pools[index];
+    }
+
+    void* SmallObjectPool::Allocate(size_t size)
+    {
+        if (size == 0 || size > MAX_POOLED_SIZE)
+        {
+            return Memory::Malloc(size);
+        }
+        return GetSmallPool(size).Allocate();
+    }
+
+    void SmallObjectPool::Free(void* ptr, size_t size)
+    {
+        if (size == 0 || size > MAX_POOLED_SIZE)
+        {
+            Memory::Free(ptr);
+            return;
+        }
+        GetSmallPool(size).Free(ptr);
+    }
+
+    PoolStats SmallObjectPool::GetStats(size_t size)
+    {
+        if (size == 0 || size > MAX_POOLED_SIZE)
+        {
+            return PoolStats();
+        }
+        return GetSmallPool(size).GetStats();
+    }
+}
@@ -1,6 +1,8 @@
 #include "precompiled_core.hpp"
 #include "windows/windows_memory.hpp"
+#if PLATFORM_WINDOWS
 #include "memory/ansi_c_malloc.hpp"
+#include "windows/minimal_windows.hpp"
 
 namespace Engine
 {
@@ -35,4 +37,41 @@ namespace Engine
     {
         return ::memcmp(lBuffer, rBuffer, size) == 0;
     }
-}
\ No newline at end of file
+
+    int32 WindowsMemory::CaptureCallstack(void** frames, int32 maxDepth)
+    {
+        return static_cast<int32>(::RtlCaptureStackBackTrace(1, static_cast<DWORD>(maxDepth), frames, nullptr));
+    }
+
+    size_t WindowsMemory::GetPageSize()
+    {
+        static const size_t pageSize = []()
+        {
+            SYSTEM_INFO info;
+            ::GetSystemInfo(&info);
+            return static_cast<size_t>(info.dwPageSize);
+        }();
+        return pageSize;
+    }
+
+    void* WindowsMemory::Reserve(size_t size)
+    {
+        return ::VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+    }
+
+    bool WindowsMemory::Commit(void* ptr, size_t size)
+    {
+        return ::VirtualAlloc(ptr, size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+    }
+
+    void WindowsMemory::Decommit(void* ptr, size_t size)
+    {
+        ::VirtualFree(ptr, size, MEM_DECOMMIT);
+    }
+
+    void WindowsMemory::Release(void* ptr, size_t size)
+    {
+        ::VirtualFree(ptr, 0, MEM_RELEASE);
+    }
+}
+#endif
@@ -0,0 +1,251 @@
+#include "misc/cpu_features.hpp"
+#include <cstdlib>
+#include <cctype>
+#include <initializer_list>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CPU_X86 1
+#if defined(COMPILER_MSVC)
+#include <intrin.h>
+#include <immintrin.h>
+#else
+#include <cpuid.h>
+#endif
+#else
+#define CPU_X86 0
+#endif
+
+namespace Engine
+{
+    namespace
+    {
+        // must not use String, log or anything else which dispatches on cpu features, they are detected on their first call
+        struct CpuState
+        {
+            bool Features[static_cast<int32>(ECpuFeature::Count)]{};
+            ESimdLevel DetectedLevel{ ESimdLevel::Scalar };
+            ESimdLevel Level{ ESimdLevel::Scalar };
+        };
+
+#if CPU_X86
+        void CpuId(int32 leaf, int32 subLeaf, uint32 outRegisters[4])
+        {
+#if defined(COMPILER_MSVC)
+            int32 registers[4];
+            __cpuidex(registers, leaf, subLeaf);
+            for (int32 i = 0; i < 4; ++i)
+            {
+                outRegisters[i] = static_cast<uint32>(registers[i]);
+            }
+#else
+            __cpuid_count(leaf, subLeaf, outRegisters[0], outRegisters[1], outRegisters[2], outRegisters[3]);
+#endif
+        }
+
+        /** register state the os saves on context switch */
+        uint64 GetExtendedControlRegister()
+        {
+#if defined(COMPILER_MSVC)
+            return _xgetbv(0);
+#else
+            uint32 eax, edx;
+            __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+            return (static_cast<uint64>(edx) << 32) | eax;
+#endif
+        }
+
+        void DetectFeatures(CpuState& state)
+        {
+            auto set = [&state](ECpuFeature feature, bool supported) {
+                state.Features[static_cast<int32>(feature)] = supported;
+            };
+            auto bit = [](uint32 value, int32 index) {
+                return (value & (1u << index)) != 0;
+            };
+
+            uint32 registers[4];
+            CpuId(0, 0, registers);
+            const uint32 maxLeaf = registers[0];
+            if (maxLeaf < 1)
+            {
+                return;
+            }
+
+            CpuId(1, 0, registers);
+            const uint32 ecx1 = registers[2];
+            const uint32 edx1 = registers[3];
+            set(ECpuFeature::Sse2, bit(edx1, 26));
+            set(ECpuFeature::Sse3, bit(ecx1, 0));
+            set(ECpuFeature::Ssse3, bit(ecx1, 9));
+            set(ECpuFeature::Sse41, bit(ecx1, 19));
+            set(ECpuFeature::Sse42, bit(ecx1, 20));
+            set(ECpuFeature::Popcnt, bit(ecx1, 23));
+
+            // ymm and zmm registers are usable only if os enabled them, checked through xgetbv
+            const bool osxsave = bit(ecx1, 27);
+            const uint64 xcr0 = osxsave ? GetExtendedControlRegister() : 0;
+            const bool osYmm = (xcr0 & 0x6) == 0x6;
+            const bool osZmm = (xcr0 & 0xe6) == 0xe6;
+
+            set(ECpuFeature::Avx, osYmm && bit(ecx1, 28));
+            set(ECpuFeature::Fma, osYmm && bit(ecx1, 12));
+            if (maxLeaf < 7)
+            {
+                return;
+            }
+
+            CpuId(7, 0, registers);
+            const uint32 ebx7 = registers[1];
+            set(ECpuFeature::Avx2, osYmm && bit(ebx7, 5));
+            set(ECpuFeature::Bmi2, bit(ebx7, 8));
+            set(ECpuFeature::Avx512F, osZmm && bit(ebx7, 16));
+            set(ECpuFeature::Avx512BW, osZmm && bit(ebx7, 30));
+            set(ECpuFeature::Avx512VL, osZmm && bit(ebx7, 31));
+        }
+#endif
+
+        ESimdLevel GetFeatureTier(ECpuFeature feature)
+        {
+            if (feature >= ECpuFeature::Avx512F)
+            {
+                return ESimdLevel::Avx512;
+            }
+            if (feature >= ECpuFeature::Avx)
+            {
+                return ESimdLevel::Avx2;
+            }
+            return ESimdLevel::Sse2;
+        }
+
+        ESimdLevel GetLevelOfFeatures(const CpuState& state)
+        {
+            auto has = [&state](ECpuFeature feature) {
+                return state.Features[static_cast<int32>(feature)];
+            };
+
+            if (!has(ECpuFeature::Sse2))
+            {
+                return ESimdLevel::Scalar;
+            }
+            if (!has(ECpuFeature::Avx) || !has(ECpuFeature::Avx2) || !has(ECpuFeature::Fma))
+            {
+                return ESimdLevel::Sse2;
+            }
+            if (!has(ECpuFeature::Avx512F) || !has(ECpuFeature::Avx512BW) || !has(ECpuFeature::Avx512VL))
+            {
+                return ESimdLevel::Avx2;
+            }
+            return ESimdLevel::Avx512;
+        }
+
+        bool ReadOverride(ESimdLevel& outLevel)
+        {
+#if defined(COMPILER_MSVC)
+            char* value = nullptr;
+            size_t size = 0;
+            if (_dupenv_s(&value, &size, CpuFeatures::OVERRIDE_ENV_NAME) != 0 || value == nullptr)
+            {
+                return false;
+            }
+            const bool parsed = CpuFeatures::ParseSimdLevel(value, outLevel);
+            free(value);
+            return parsed;
+#else
+            const char* value = std::getenv(CpuFeatures::OVERRIDE_ENV_NAME);
+            return value != nullptr && CpuFeatures::ParseSimdLevel(value, outLevel);
+#endif
+        }
+
+        CpuState DetectCpuState()
+        {
+            CpuState state;
+#if CPU_X86
+            DetectFeatures(state);
+#endif
+            state.DetectedLevel = GetLevelOfFeatures(state);
+            state.Level = state.DetectedLevel;
+
+            ESimdLevel overrideLevel;
+            if (ReadOverride(overrideLevel) && overrideLevel < state.DetectedLevel)
+            {
+                state.Level = overrideLevel;
+            }
+            return state;
+        }
+
+        const CpuState& GetCpuState()
+        {
+            static const CpuState state = DetectCpuState();
+            return state;
+        }
+    }
+
+    bool CpuFeatures::HasFeature(ECpuFeature feature)
+    {
+        ENSURE(feature < ECpuFeature::Count);
+        const CpuState& state = GetCpuState();
+        return state.Features[static_cast<int32>(feature)] && GetFeatureTier(feature) <= state.Level;
+    }
+
+    ESimdLevel CpuFeatures::GetSimdLevel()
+    {
+        return GetCpuState().Level;
+    }
+
+    ESimdLevel CpuFeatures::GetDetectedSimdLevel()
+    {
+        return GetCpuState().DetectedLevel;
+    }
+
+    const char* CpuFeatures::GetFeatureName(ECpuFeature feature)
+    {
+        switch (feature)
+        {
+            case ECpuFeature::Sse2: return "sse2";
+            case ECpuFeature::Sse3: return "sse3";
+            case ECpuFeature::Ssse3: return "ssse3";
+            case ECpuFeature::Sse41: return "sse4.1";
+            case ECpuFeature::Sse42: return "sse4.2";
+            case ECpuFeature::Popcnt: return "popcnt";
+            case ECpuFeature::Avx: return "avx";
+            case ECpuFeature::Avx2: return "avx2";
+            case ECpuFeature::Fma: return "fma";
+            case ECpuFeature::Bmi2: return "bmi2";
+            case ECpuFeature::Avx512F: return "avx512f";
+            case ECpuFeature::Avx512BW: return "avx512bw";
+            case ECpuFeature::Avx512VL: return "avx512vl";
+            default: return "unknown";
+        }
+    }
+
+    const char* CpuFeatures::GetSimdLevelName(ESimdLevel level)
+    {
+        switch (level)
+        {
+            case ESimdLevel::Scalar: return "scalar";
+            case ESimdLevel::Sse2: return "sse2";
+            case ESimdLevel::Avx2: return "avx2";
+            case ESimdLevel::Avx512: return "avx512";
+            default: return "unknown";
+        }
+    }
+
+    bool CpuFeatures::ParseSimdLevel(const char* name, ESimdLevel& outLevel)
+    {
+        for (ESimdLevel level : { ESimdLevel::Scalar, ESimdLevel::Sse2, ESimdLevel::Avx2, ESimdLevel::Avx512 })
+        {
+            const char* levelName = GetSimdLevelName(level);
+            int32 index = 0;
+            while (name[index] != '\0' && std::tolower(static_cast<uint8>(name[index])) == levelName[index])
+            {
+                ++index;
+            }
+            if (name[index] == '\0' && levelName[index] == '\0')
+            {
+                outLevel = level;
+                return true;
+            }
+        }
+        return false;
+    }
+}
\ No newline at end of file
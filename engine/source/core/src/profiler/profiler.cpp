@@ -0,0 +1,452 @@
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include "spdlog/details/os.h"
+#include "profiler/profiler.hpp"
+#include "file_system/file_stream.hpp"
+#include "file_system/file_system.hpp"
+#include "file_system/path.hpp"
+#include "foundation/smart_ptr.hpp"
+#include "foundation/time.hpp"
+
+namespace Engine
+{
+    std::atomic<bool> Profiler::Enabled{ ENABLE_PROFILER != 0 };
+
+    namespace
+    {
+        /**
+         * Ring of finished scopes written by its owner thread only.
+         * Reader copies published events then drops those which may have been overwritten meanwhile.
+         */
+        class ThreadProfileBuffer
+        {
+        public:
+            ThreadProfileBuffer()
+            {
+                Events.Resize(Profiler::THREAD_BUFFER_CAPACITY);
+            }
+
+            void Push(const char* name, int64 begin, int64 end, int32 depth)
+            {
+                const uint64 written = Written.load(std::memory_order_relaxed);
+                ProfileEvent& event = Events[static_cast<int32>(written & MASK)];
+                event.Name = name;
+                event.Begin = begin;
+                event.End = end;
+                event.Depth = depth;
+                Written.store(written + 1, std::memory_order_release);
+            }
+
+            /** @return whether older events are overwritten */
+            bool Copy(Array<ProfileEvent>& outEvents, int64 minBegin) const
+            {
+                const uint64 end = Written.load(std::memory_order_acquire);
+                const uint64 capacity = static_cast<uint64>(Profiler::THREAD_BUFFER_CAPACITY);
+                const uint64 start = end > capacity ? end - capacity : 0;
+
+                Array<ProfileEvent> events;
+                events.Reserve(static_cast<int32>(end - start));
+                for (uint64 index = start; index < end; ++index)
+                {
+                    events.Add(Events[static_cast<int32>(index & MASK)]);
+                }
+
+                // owner may have overwritten oldest slots while copying, also the slot being written now
+                std::atomic_thread_fence(std::memory_order_acquire);
+                const uint64 written = Written.load(std::memory_order_relaxed);
+                const uint64 validStart = written + 1 > capacity ? written + 1 - capacity : 0;
+                const int32 skipped = static_cast<int32>(validStart > start ? std::min(validStart - start, end - start) : 0);
+                for (int32 index = skipped; index < events.Size(); ++index)
+                {
+                    // recorded in cycles, converted only when they're read
+                    ProfileEvent& event = events[index];
+                    event.Begin = HighResolutionClock::CyclesToNanoseconds(event.Begin);
+                    event.End = HighResolutionClock::CyclesToNanoseconds(event.End);
+                    if (event.Begin >= minBegin)
+                    {
+                        outEvents.Add(event);
+                    }
+                }
+                return start > 0 || skipped > 0;
+            }
+
+            uint64 ThreadId{ 0 };
+            /** guarded by registry mutex */
+            String ThreadName;
+            std::atomic<bool> Orphaned{ false };
+
+        private:
+            static constexpr uint64 MASK = static_cast<uint64>(Profiler::THREAD_BUFFER_CAPACITY) - 1;
+            static_assert((Profiler::THREAD_BUFFER_CAPACITY & (Profiler::THREAD_BUFFER_CAPACITY - 1)) == 0);
+
+            Array<ProfileEvent> Events;
+            std::atomic<uint64> Written{ 0 };
+        };
+
+        struct FrameMarker
+        {
+            uint64 Index{ 0 };
+            int64 Begin{ 0 };
+        };
+
+        struct ProfilerRegistry
+        {
+            std::mutex Mutex;
+            Array<SharedPtr<ThreadProfileBuffer>> Buffers;
+            /** ring of frame markers, the newest is the frame in progress */
+            Array<FrameMarker> Frames;
+            uint64 FrameIndex{ 0 };
+            /** events which begin before it are dropped by Reset */
+            int64 ResetTime{ 0 };
+        };
+
+        ProfilerRegistry& GetRegistry()
+        {
+            // leaked on purpose, threads may still record while static objects are destroyed
+            static ProfilerRegistry* registry = new ProfilerRegistry();
+            return *registry;
+        }
+
+        struct ThreadBufferHolder
+        {
+            SharedPtr<ThreadProfileBuffer> Buffer;
+
+            ~ThreadBufferHolder()
+            {
+                if (Buffer != nullptr)
+                {
+                    Buffer->Orphaned.store(true, std::memory_order_release);
+                }
+            }
+        };
+
+        thread_local ThreadBufferHolder GThreadBuffer;
+        thread_local int32 GScopeDepth = 0;
+
+        ThreadProfileBuffer& GetThreadBuffer()
+        {
+            if (GThreadBuffer.Buffer == nullptr)
+            {
+                auto buffer = MakeShared<ThreadProfileBuffer>();
+                buffer->ThreadId = spdlog::details::os::thread_id();
+                ProfilerRegistry& registry = GetRegistry();
+                std::scoped_lock lock(registry.Mutex);
+                registry.Buffers.Add(buffer);
+                GThreadBuffer.Buffer = buffer;
+            }
+            return *GThreadBuffer.Buffer;
+        }
+
+        /** frame markers oldest first, must be called with registry mutex held */
+        Array<FrameMarker> GetFrameMarkers(const ProfilerRegistry& registry)
+        {
+            Array<FrameMarker> markers;
+            const uint64 num = std::min<uint64>(registry.FrameIndex, Profiler::FRAME_CAPACITY);
+            for (uint64 index = registry.FrameIndex - num + 1; index <= registry.FrameIndex; ++index)
+            {
+                markers.Add(registry.Frames[static_cast<int32>(index % Profiler::FRAME_CAPACITY)]);
+            }
+            return markers;
+        }
+
+        void AppendJsonString(fmt::memory_buffer& out, const char* str)
+        {
+            out.push_back('"');
+            for (; *str != '\0'; ++str)
+            {
+                if (*str == '"' || *str == '\\')
+                {
+                    out.push_back('\\');
+                }
+                if (static_cast<uint8>(*str) >= 0x20)
+                {
+                    out.push_back(*str);
+                }
+            }
+            out.push_back('"');
+        }
+
+        bool WriteToFile(const String& filePath, const fmt::memory_buffer& content)
+        {
+            const PathView view(filePath);
+            if (view.GetParent().Length() > 0)
+            {
+                FileSystem::MakeDirTree(String(view.GetParent().Data(), view.GetParent().Length()));
+            }
+            FileWriter writer(filePath);
+            return writer.IsValid() && writer.Write(reinterpret_cast<const uint8*>(content.data()), static_cast<int64>(content.size())) &&
+                   writer.Flush() && !writer.HasError();
+        }
+
+        /** aggregated time of one scope instance */
+        struct ScopeSample
+        {
+            const char* Name;
+            int64 InclusiveTime;
+            int64 ExclusiveTime;
+        };
+
+        /** append samples of events beginning in [begin, end) of one thread */
+        void SampleFrame(const Array<ProfileEvent>& events, int64 begin, int64 end, Array<ScopeSample>& outSamples)
+        {
+            Array<ProfileEvent> frameEvents;
+            for (const ProfileEvent& event : events)
+            {
+                if (event.Begin >= begin && event.Begin < end)
+                {
+                    frameEvents.Add(event);
+                }
+            }
+            // parent begins no later than its children, and is ordered first when it begins at the same time
+            std::sort(frameEvents.Data(), frameEvents.Data() + frameEvents.Size(), [](const ProfileEvent& lhs, const ProfileEvent& rhs) {
+                return lhs.Begin != rhs.Begin ? lhs.Begin < rhs.Begin : lhs.Depth < rhs.Depth;
+            });
+
+            const int32 first = outSamples.Size();
+            Array<int32> stack;
+            for (const ProfileEvent& event : frameEvents)
+            {
+                while (stack.Size() > 0 && frameEvents[stack.Last() - first].Depth >= event.Depth)
+                {
+                    stack.Pop();
+                }
+                const int64 time = event.End - event.Begin;
+                if (stack.Size() > 0 && frameEvents[stack.Last() - first].Depth == event.Depth - 1)
+                {
+                    outSamples[stack.Last()].ExclusiveTime -= time;
+                }
+                stack.Add(outSamples.Size());
+                outSamples.Add(ScopeSample{ event.Name, time, time });
+            }
+        }
+    }
+
+    int64 Profiler::Now()
+    {
+        return HighResolutionClock::Now();
+    }
+
+    void Profiler::Record(const char* name, int64 begin, int64 end, int32 depth)
+    {
+        GetThreadBuffer().Push(name, begin, end, depth);
+    }
+
+    void Profiler::MarkFrame()
+    {
+        const int64 now = Now();
+        ProfilerRegistry& registry = GetRegistry();
+        std::scoped_lock lock(registry.Mutex);
+        if (registry.Frames.Size() == 0)
+        {
+            registry.Frames.Resize(FRAME_CAPACITY);
+        }
+        ++registry.FrameIndex;
+        registry.Frames[static_cast<int32>(registry.FrameIndex % FRAME_CAPACITY)] = FrameMarker{ registry.FrameIndex, now };
+    }
+
+    uint64 Profiler::GetFrameIndex()
+    {
+        ProfilerRegistry& registry = GetRegistry();
+        std::scoped_lock lock(registry.Mutex);
+        return registry.FrameIndex;
+    }
+
+    void Profiler::SetThreadName(const String& name)
+    {
+        ThreadProfileBuffer& buffer = GetThreadBuffer();
+        std::scoped_lock lock(GetRegistry().Mutex);
+        buffer.ThreadName = name;
+    }
+
+    Array<ProfileThreadEvents> Profiler::CollectEvents()
+    {
+        ProfilerRegistry& registry = GetRegistry();
+        std::scoped_lock lock(registry.Mutex);
+
+        Array<ProfileThreadEvents> threads;
+        for (int32 index = registry.Buffers.Size() - 1; index >= 0; --index)
+        {
+            const ThreadProfileBuffer& buffer = *registry.Buffers[index];
+            ProfileThreadEvents thread;
+            thread.ThreadId = buffer.ThreadId;
+            thread.ThreadName = buffer.ThreadName;
+            buffer.Copy(thread.Events, registry.ResetTime);
+            if (thread.Events.Size() > 0)
+            {
+                threads.Add(MoveTemp(thread));
+            }
+            else if (buffer.Orphaned.load(std::memory_order_acquire))
+            {
+                // nothing of an exited thread is left to report
+                registry.Buffers.RemoveAt(index);
+            }
+        }
+        std::reverse(threads.Data(), threads.Data() + threads.Size());
+        return threads;
+    }
+
+    Array<ProfileFrame> Profiler::CollectFrames(int32 frameNum)
+    {
+        Array<FrameMarker> markers;
+        Array<ProfileThreadEvents> threads;
+        Array<int64> overwrittenBefore;
+        {
+            ProfilerRegistry& registry = GetRegistry();
+            std::scoped_lock lock(registry.Mutex);
+            markers = GetFrameMarkers(registry);
+            for (const SharedPtr<ThreadProfileBuffer>& buffer : registry.Buffers)
+            {
+                ProfileThreadEvents thread;
+                const bool overwritten = buffer->Copy(thread.Events, registry.ResetTime);
+                // events ending before the oldest kept one may be lost, so a frame beginning before it is incomplete
+                overwrittenBefore.Add(overwritten && thread.Events.Size() > 0 ? thread.Events[0].End + 1 : 0);
+                threads.Add(MoveTemp(thread));
+            }
+        }
+
+        Array<ProfileFrame> frames;
+        const int32 firstMarker = std::max(0, markers.Size() - 1 - frameNum);
+        for (int32 index = firstMarker; index + 1 < markers.Size(); ++index)
+        {
+            ProfileFrame frame;
+            frame.Index = markers[index].Index;
+            frame.Begin = markers[index].Begin;
+            frame.End = markers[index + 1].Begin;
+
+            bool complete = true;
+            Array<ScopeSample> samples;
+            for (int32 threadIndex = 0; threadIndex < threads.Size(); ++threadIndex)
+            {
+                complete = complete && overwrittenBefore[threadIndex] <= frame.Begin;
+                SampleFrame(threads[threadIndex].Events, frame.Begin, frame.End, samples);
+            }
+            if (!complete)
+            {
+                continue;
+            }
+
+            // same name may be different pointers in different modules, so merge by content
+            std::sort(samples.Data(), samples.Data() + samples.Size(), [](const ScopeSample& lhs, const ScopeSample& rhs) {
+                return std::strcmp(lhs.Name, rhs.Name) < 0;
+            });
+            for (const ScopeSample& sample : samples)
+            {
+                if (frame.Stats.Size() == 0 || std::strcmp(frame.Stats.Last().Name, sample.Name) != 0)
+                {
+                    ProfileScopeStat stat;
+                    stat.Name = sample.Name;
+                    frame.Stats.Add(stat);
+                }
+                ProfileScopeStat& stat = frame.Stats.Last();
+                ++stat.CallNum;
+                stat.InclusiveTime += sample.InclusiveTime;
+                stat.ExclusiveTime += sample.ExclusiveTime;
+                stat.MaxTime = std::max(stat.MaxTime, sample.InclusiveTime);
+            }
+            std::sort(frame.Stats.Data(), frame.Stats.Data() + frame.Stats.Size(), [](const ProfileScopeStat& lhs, const ProfileScopeStat& rhs) {
+                return lhs.ExclusiveTime > rhs.ExclusiveTime;
+            });
+            frames.Add(MoveTemp(frame));
+        }
+        return frames;
+    }
+
+    bool Profiler::ExportChromeTrace(const String& filePath)
+    {
+        const Array<ProfileThreadEvents> threads = CollectEvents();
+        Array<FrameMarker> markers;
+        {
+            ProfilerRegistry& registry = GetRegistry();
+            std::scoped_lock lock(registry.Mutex);
+            markers = GetFrameMarkers(registry);
+        }
+
+        // timestamps are microseconds in trace format
+        fmt::memory_buffer content;
+        auto output = fmt::appender(content);
+        fmt::format_to(output, "{{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+        bool first = true;
+        auto separate = [&]() {
+            if (!first)
+            {
+                fmt::format_to(output, ",\n");
+            }
+            first = false;
+        };
+
+        for (const ProfileThreadEvents& thread : threads)
+        {
+            separate();
+            const String name = thread.ThreadName.Empty() ? String(fmt::format("Thread {0}", thread.ThreadId).c_str()) : thread.ThreadName;
+            fmt::format_to(output, "{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{0},\"args\":{{\"name\":", thread.ThreadId);
+            AppendJsonString(content, name.Data());
+            fmt::format_to(output, "}}}}");
+
+            for (const ProfileEvent& event : thread.Events)
+            {
+                separate();
+                fmt::format_to(output, "{{\"name\":");
+                AppendJsonString(content, event.Name);
+                fmt::format_to(output, ",\"ph\":\"X\",\"pid\":1,\"tid\":{0},\"ts\":{1:.3f},\"dur\":{2:.3f}}}", thread.ThreadId,
+                               event.Begin / 1000.0, (event.End - event.Begin) / 1000.0);
+            }
+        }
+        for (const FrameMarker& marker : markers)
+        {
+            separate();
+            fmt::format_to(output, "{{\"name\":\"Frame {0}\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":0,\"ts\":{1:.3f}}}",
+                           marker.Index, marker.Begin / 1000.0);
+        }
+        fmt::format_to(output, "\n]}}\n");
+
+        return WriteToFile(filePath, content);
+    }
+
+    bool Profiler::ExportFrameReport(const String& filePath, int32 frameNum)
+    {
+        fmt::memory_buffer content;
+        auto output = fmt::appender(content);
+        for (const ProfileFrame& frame : CollectFrames(frameNum))
+        {
+            fmt::format_to(output, "Frame {0}: {1:.3f} ms\n", frame.Index, (frame.End - frame.Begin) / 1e6);
+            fmt::format_to(output, "  {0:>12} {1:>12} {2:>12} {3:>8}  {4}\n", "Self(ms)", "Total(ms)", "Max(ms)", "Calls", "Scope");
+            for (const ProfileScopeStat& stat : frame.Stats)
+            {
+                fmt::format_to(output, "  {0:>12.3f} {1:>12.3f} {2:>12.3f} {3:>8}  {4}\n", stat.ExclusiveTime / 1e6,
+                               stat.InclusiveTime / 1e6, stat.MaxTime / 1e6, stat.CallNum, stat.Name);
+            }
+            fmt::format_to(output, "\n");
+        }
+        return WriteToFile(filePath, content);
+    }
+
+    void Profiler::Reset()
+    {
+        const int64 now = Now();
+        ProfilerRegistry& registry = GetRegistry();
+        std::scoped_lock lock(registry.Mutex);
+        // buffers are owned by their threads, so events are filtered out instead of cleared
+        registry.ResetTime = now;
+        registry.FrameIndex = 0;
+    }
+
+    ProfileScope::ProfileScope(const char* name)
+        : Name(Profiler::IsEnabled() ? name : nullptr)
+    {
+        if (Name != nullptr)
+        {
+            ++GScopeDepth;
+            Begin = HighResolutionClock::Cycles();
+        }
+    }
+
+    ProfileScope::~ProfileScope()
+    {
+        if (Name != nullptr)
+        {
+            const int64 end = HighResolutionClock::Cycles();
+            Profiler::Record(Name, Begin, end, --GScopeDepth);
+        }
+    }
+}
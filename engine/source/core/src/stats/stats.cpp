@@ -0,0 +1,602 @@
+#include <atomic>
+#include <bit>
+#include <cstdlib>
+#include <mutex>
+#include "stats/stats.hpp"
+#include "file_system/file_stream.hpp"
+#include "file_system/file_system.hpp"
+#include "file_system/path.hpp"
+#include "foundation/time.hpp"
+
+namespace Engine
+{
+    namespace
+    {
+        constexpr int32 HISTOGRAM_SLOT_NUM = Stats::HISTOGRAM_BUCKET_NUM + 2;
+        /** blocks grow by whole cache lines of slots */
+        constexpr int32 BLOCK_SLOT_ALIGNMENT = 64;
+
+        /**
+         * Values accumulated by one thread, only its owner writes so plain load and store are enough.
+         * Sized by slots registered when it's created, slots registered later grow it.
+         */
+        struct ThreadStatBlock
+        {
+            int32 Capacity{ 0 };
+            std::atomic<int64> Slots[1];
+
+            static size_t GetAllocSize(int32 capacity)
+            {
+                return sizeof(ThreadStatBlock) + sizeof(std::atomic<int64>) * (capacity - 1);
+            }
+        };
+
+        struct StatEntry
+        {
+            StringID Name;
+            String Description;
+            EStatType Type{ EStatType::Counter };
+            uint32 Slot{ 0 };
+            std::atomic<int64> GaugeValue{ 0 };
+
+            /** merged by EndFrame */
+            int64 Value{ 0 };
+            int64 FrameValue{ 0 };
+            int64 Sum{ 0 };
+            int64 Buckets[Stats::HISTOGRAM_BUCKET_NUM]{};
+        };
+
+        struct PeriodicExport
+        {
+            EStatExportFormat Format{ EStatExportFormat::Text };
+            String FilePath;
+            int64 Interval{ 0 };
+            int64 LastExportTime{ 0 };
+        };
+
+        struct StatRegistry
+        {
+            /** guards entries and exports, values of entries are written by EndFrame with it held */
+            std::mutex Mutex;
+            StatEntry Entries[Stats::MAX_STAT_NUM];
+            int32 EntryNum{ 0 };
+            /** slot 0 is never used, so a zero handle is invalid. Written with Mutex held, read by threads sizing their block */
+            std::atomic<int32> SlotNum{ 1 };
+            uint64 FrameIndex{ 0 };
+            Array<PeriodicExport> Exports;
+
+            /** guards blocks and retired values, it's never held while locking Mutex */
+            std::mutex BlocksMutex;
+            Array<ThreadStatBlock*> Blocks;
+            /** values of exited threads */
+            int64 Retired[Stats::MAX_SLOT_NUM]{};
+            int64 Totals[Stats::MAX_SLOT_NUM]{};
+        };
+
+        StatRegistry& GetRegistry()
+        {
+            // leaked on purpose, threads may still update stats while static objects are destroyed
+            static StatRegistry* registry = new StatRegistry();
+            return *registry;
+        }
+
+        void RetireBlock(ThreadStatBlock* block)
+        {
+            StatRegistry& registry = GetRegistry();
+            {
+                std::scoped_lock lock(registry.BlocksMutex);
+                for (int32 slot = 0; slot < block->Capacity; ++slot)
+                {
+                    registry.Retired[slot] += block->Slots[slot].load(std::memory_order_relaxed);
+                }
+                for (int32 index = 0; index < registry.Blocks.Size(); ++index)
+                {
+                    if (registry.Blocks[index] == block)
+                    {
+                        registry.Blocks.RemoveAt(index);
+                        break;
+                    }
+                }
+            }
+            std::free(block);
+        }
+
+        struct ThreadStatHolder
+        {
+            ThreadStatBlock* Block{ nullptr };
+
+            ~ThreadStatHolder()
+            {
+                if (Block != nullptr)
+                {
+                    RetireBlock(Block);
+                    Block = nullptr;
+                }
+            }
+        };
+
+        thread_local ThreadStatHolder GThreadStats;
+
+        /** create block of calling thread or grow it, so it holds every slot registered by now */
+        ThreadStatBlock* GrowThreadBlock(uint32 slot)
+        {
+            StatRegistry& registry = GetRegistry();
+            const int32 slotNum = std::max(registry.SlotNum.load(std::memory_order_acquire), static_cast<int32>(slot) + 1);
+            const int32 capacity = std::min((slotNum + BLOCK_SLOT_ALIGNMENT - 1) / BLOCK_SLOT_ALIGNMENT * BLOCK_SLOT_ALIGNMENT,
+                                            static_cast<int32>(Stats::MAX_SLOT_NUM));
+
+            // bypass engine allocator, allocations themselves are counted
+            void* memory = std::calloc(1, ThreadStatBlock::GetAllocSize(capacity));
+            ENSURE(memory);
+            ThreadStatBlock* block = static_cast<ThreadStatBlock*>(memory);
+            block->Capacity = capacity;
+
+            ThreadStatBlock* oldBlock = GThreadStats.Block;
+            if (oldBlock == nullptr)
+            {
+                // block is set first, so allocation made by adding it finds the block
+                GThreadStats.Block = block;
+                std::scoped_lock lock(registry.BlocksMutex);
+                registry.Blocks.Add(block);
+                return block;
+            }
+
+            {
+                // EndFrame reads blocks with the lock held, so the old one is never read once replaced
+                std::scoped_lock lock(registry.BlocksMutex);
+                for (int32 index = 0; index < oldBlock->Capacity; ++index)
+                {
+                    block->Slots[index].store(oldBlock->Slots[index].load(std::memory_order_relaxed), std::memory_order_relaxed);
+                }
+                for (ThreadStatBlock*& registered : registry.Blocks)
+                {
+                    if (registered == oldBlock)
+                    {
+                        registered = block;
+                        break;
+                    }
+                }
+                GThreadStats.Block = block;
+            }
+            std::free(oldBlock);
+            return block;
+        }
+
+        void AddToSlot(uint32 slot, int64 value)
+        {
+            ThreadStatBlock* block = GThreadStats.Block;
+            if (UNLIKELY(block == nullptr || static_cast<int32>(slot) >= block->Capacity))
+            {
+                block = GrowThreadBlock(slot);
+            }
+            std::atomic<int64>& target = block->Slots[slot];
+            target.store(target.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+
+        const char* GetTypeName(EStatType type)
+        {
+            switch (type)
+            {
+                case EStatType::Counter:
+                    return "counter";
+                case EStatType::Gauge:
+                    return "gauge";
+                case EStatType::Histogram:
+                    return "histogram";
+                default:
+                    return "unknown";
+            }
+        }
+
+        /** prometheus metric names only allow [a-zA-Z0-9_:] */
+        std::string MakeMetricName(const StatValue& value)
+        {
+            const String name = value.Name.ToString();
+            std::string metric = "polaris_";
+            for (int32 index = 0; index < name.Length(); ++index)
+            {
+                const char ch = name.Data()[index];
+                const bool valid = (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9') || ch == '_';
+                metric.push_back(valid ? ch : '_');
+            }
+            return metric;
+        }
+
+        void FormatText(const Array<StatValue>& values, fmt::memory_buffer& out)
+        {
+            auto output = fmt::appender(out);
+            fmt::format_to(output, "Stats of frame {0}\n", Stats::GetFrameIndex());
+            fmt::format_to(output, "{0:<40} {1:<10} {2:>16} {3:>16}  {4}\n", "Name", "Type", "Value", "Last frame", "Detail");
+            for (const StatValue& value : values)
+            {
+                const String name = value.Name.ToString();
+                fmt::format_to(output, "{0:<40} {1:<10} {2:>16} {3:>16}", name.Data(), GetTypeName(value.Type), value.Value,
+                               value.FrameValue);
+                if (value.Type == EStatType::Histogram && value.Value > 0)
+                {
+                    int32 maxBucket = 0;
+                    for (int32 bucket = 0; bucket < value.Buckets.Size(); ++bucket)
+                    {
+                        maxBucket = value.Buckets[bucket] > 0 ? bucket : maxBucket;
+                    }
+                    fmt::format_to(output, "  avg={0:.1f} max<={1}", static_cast<double>(value.Sum) / value.Value,
+                                   Stats::GetBucketUpperBound(maxBucket));
+                }
+                fmt::format_to(output, "\n");
+            }
+        }
+
+        void FormatCsv(const Array<StatValue>& values, fmt::memory_buffer& out)
+        {
+            auto output = fmt::appender(out);
+            const uint64 frame = Stats::GetFrameIndex();
+            const int64 time = PlatformClock::Now().TimeSinceEpoch();
+            for (const StatValue& value : values)
+            {
+                const String name = value.Name.ToString();
+                fmt::format_to(output, "{0},{1},\"{2}\",{3},{4},{5},{6}\n", frame, time, name.Data(), GetTypeName(value.Type),
+                               value.Value, value.FrameValue, value.Sum);
+            }
+        }
+
+        void FormatPrometheus(const Array<StatValue>& values, fmt::memory_buffer& out)
+        {
+            auto output = fmt::appender(out);
+            for (const StatValue& value : values)
+            {
+                std::string metric = MakeMetricName(value);
+                if (value.Type == EStatType::Counter)
+                {
+                    metric += "_total";
+                }
+                if (!value.Description.Empty())
+                {
+                    fmt::format_to(output, "# HELP {0} {1}\n", metric, value.Description.Data());
+                }
+                fmt::format_to(output, "# TYPE {0} {1}\n", metric, GetTypeName(value.Type));
+                if (value.Type != EStatType::Histogram)
+                {
+                    fmt::format_to(output, "{0} {1}\n", metric, value.Value);
+                    continue;
+                }
+
+                // buckets are cumulative, empty ones beyond the largest value are omitted
+                int32 lastBucket = 0;
+                for (int32 bucket = 0; bucket < value.Buckets.Size(); ++bucket)
+                {
+                    lastBucket = value.Buckets[bucket] > 0 ? bucket : lastBucket;
+                }
+                int64 cumulative = 0;
+                for (int32 bucket = 0; bucket <= lastBucket && bucket + 1 < value.Buckets.Size(); ++bucket)
+                {
+                    cumulative += value.Buckets[bucket];
+                    fmt::format_to(output, "{0}_bucket{{le=\"{1}\"}} {2}\n", metric, Stats::GetBucketUpperBound(bucket), cumulative);
+                }
+                fmt::format_to(output, "{0}_bucket{{le=\"+Inf\"}} {1}\n", metric, value.Value);
+                fmt::format_to(output, "{0}_sum {1}\n", metric, value.Sum);
+                fmt::format_to(output, "{0}_count {1}\n", metric, value.Value);
+            }
+        }
+
+        void MakeParentDir(const String& filePath)
+        {
+            const PathView view(filePath);
+            if (view.GetParent().Length() > 0)
+            {
+                FileSystem::MakeDirTree(String(view.GetParent().Data(), view.GetParent().Length()));
+            }
+        }
+    }
+
+    void Stats::EndFrame()
+    {
+        // create block of this thread now, allocations below would create it while blocks are locked
+        if (GThreadStats.Block == nullptr)
+        {
+            GrowThreadBlock(0);
+        }
+
+        Array<PeriodicExport> dueExports;
+        StatRegistry& registry = GetRegistry();
+        {
+            std::scoped_lock lock(registry.Mutex);
+            {
+                std::scoped_lock blocksLock(registry.BlocksMutex);
+                const int32 slotNum = registry.SlotNum.load(std::memory_order_relaxed);
+                for (int32 slot = 0; slot < slotNum; ++slot)
+                {
+                    registry.Totals[slot] = registry.Retired[slot];
+                }
+                for (ThreadStatBlock* block : registry.Blocks)
+                {
+                    // slots beyond capacity are never touched by that thread
+                    const int32 blockSlotNum = std::min(slotNum, block->Capacity);
+                    for (int32 slot = 0; slot < blockSlotNum; ++slot)
+                    {
+                        registry.Totals[slot] += block->Slots[slot].load(std::memory_order_relaxed);
+                    }
+                }
+            }
+
+            ++registry.FrameIndex;
+            for (int32 index = 0; index < registry.EntryNum; ++index)
+            {
+                StatEntry& entry = registry.Entries[index];
+                switch (entry.Type)
+                {
+                    case EStatType::Counter:
+                        entry.FrameValue = registry.Totals[entry.Slot] - entry.Value;
+                        entry.Value = registry.Totals[entry.Slot];
+                        break;
+                    case EStatType::Gauge:
+                        entry.Value = entry.GaugeValue.load(std::memory_order_relaxed);
+                        break;
+                    case EStatType::Histogram:
+                    {
+                        // layout of slots: count, sum, buckets
+                        entry.FrameValue = registry.Totals[entry.Slot] - entry.Value;
+                        entry.Value = registry.Totals[entry.Slot];
+                        entry.Sum = registry.Totals[entry.Slot + 1];
+                        for (int32 bucket = 0; bucket < HISTOGRAM_BUCKET_NUM; ++bucket)
+                        {
+                            entry.Buckets[bucket] = registry.Totals[entry.Slot + 2 + bucket];
+                        }
+                        break;
+                    }
+                    default:
+                        break;
+                }
+            }
+
+            const int64 now = HighResolutionClock::Now();
+            for (PeriodicExport& periodic : registry.Exports)
+            {
+                if (now - periodic.LastExportTime >= periodic.Interval)
+                {
+                    periodic.LastExportTime = now;
+                    dueExports.Add(periodic);
+                }
+            }
+        }
+
+        // exports are copied, they may be added or removed by other threads while writing files
+        for (const PeriodicExport& periodic : dueExports)
+        {
+            Export(periodic.Format, periodic.FilePath);
+        }
+    }
+
+    uint64 Stats::GetFrameIndex()
+    {
+        StatRegistry& registry = GetRegistry();
+        std::scoped_lock lock(registry.Mutex);
+        return registry.FrameIndex;
+    }
+
+    Array<StatValue> Stats::GetValues()
+    {
+        StatRegistry& registry = GetRegistry();
+        std::scoped_lock lock(registry.Mutex);
+        Array<StatValue> values;
+        values.Reserve(registry.EntryNum);
+        for (int32 index = 0; index < registry.EntryNum; ++index)
+        {
+            const StatEntry& entry = registry.Entries[index];
+            StatValue value;
+            value.Name = entry.Name;
+            value.Description = entry.Description;
+            value.Type = entry.Type;
+            value.Value = entry.Value;
+            value.FrameValue = entry.FrameValue;
+            value.Sum = entry.Sum;
+            if (entry.Type == EStatType::Histogram)
+            {
+                value.Buckets.Resize(HISTOGRAM_BUCKET_NUM);
+                for (int32 bucket = 0; bucket < HISTOGRAM_BUCKET_NUM; ++bucket)
+                {
+                    value.Buckets[bucket] = entry.Buckets[bucket];
+                }
+            }
+            values.Add(MoveTemp(value));
+        }
+        return values;
+    }
+
+    const StatValue* Stats::FindValue(const Array<StatValue>& values, const StringID& name)
+    {
+        for (const StatValue& value : values)
+        {
+            if (value.Name == name)
+            {
+                return &value;
+            }
+        }
+        return nullptr;
+    }
+
+    int64 Stats::GetBucketUpperBound(int32 bucket)
+    {
+        if (bucket <= 0)
+        {
+            return 0;
+        }
+        if (bucket >= HISTOGRAM_BUCKET_NUM - 1)
+        {
+            return INT64_MAX;
+        }
+        return (1ll << bucket) - 1;
+    }
+
+    bool Stats::Export(EStatExportFormat format, const String& filePath)
+    {
+        fmt::memory_buffer content;
+        Format(format, GetValues(), content);
+        MakeParentDir(filePath);
+
+        if (format == EStatExportFormat::Csv)
+        {
+            FileWriter writer(filePath, FileWriter::DEFAULT_BUFFER_SIZE, true);
+            if (!writer.IsValid())
+            {
+                return false;
+            }
+            if (writer.Tell() == 0)
+            {
+                const std::string_view header = "frame,time,name,type,value,frame_value,sum\n";
+                writer.Write(reinterpret_cast<const uint8*>(header.data()), static_cast<int64>(header.size()));
+            }
+            writer.Write(reinterpret_cast<const uint8*>(content.data()), static_cast<int64>(content.size()));
+            return writer.Flush() && !writer.HasError();
+        }
+
+        // write aside then rename, so a collector never reads a half written file
+        const String tempPath = filePath + ".tmp";
+        {
+            FileWriter writer(tempPath);
+            if (!writer.IsValid() || !writer.Write(reinterpret_cast<const uint8*>(content.data()), static_cast<int64>(content.size())) ||
+                !writer.Flush() || writer.HasError())
+            {
+                return false;
+            }
+        }
+        if (!FileSystem::MoveFile(tempPath, filePath))
+        {
+            FileSystem::RemoveFile(filePath);
+            return FileSystem::MoveFile(tempPath, filePath);
+        }
+        return true;
+    }
+
+    void Stats::AddPeriodicExport(EStatExportFormat format, const String& filePath, int32 intervalSeconds)
+    {
+        StatRegistry& registry = GetRegistry();
+        std::scoped_lock lock(registry.Mutex);
+        PeriodicExport periodic;
+        periodic.Format = format;
+        periodic.FilePath = filePath;
+        periodic.Interval = static_cast<int64>(intervalSeconds) * 1'000'000'000;
+        periodic.LastExportTime = HighResolutionClock::Now();
+        registry.Exports.Add(MoveTemp(periodic));
+    }
+
+    void Stats::RemovePeriodicExports()
+    {
+        StatRegistry& registry = GetRegistry();
+        std::scoped_lock lock(registry.Mutex);
+        registry.Exports.Clear();
+    }
+
+    void Stats::Format(EStatExportFormat format, const Array<StatValue>& values, fmt::memory_buffer& out)
+    {
+        switch (format)
+        {
+            case EStatExportFormat::Text:
+                FormatText(values, out);
+                break;
+            case EStatExportFormat::Csv:
+                FormatCsv(values, out);
+                break;
+            case EStatExportFormat::Prometheus:
+                FormatPrometheus(values, out);
+                break;
+            default:
+                break;
+        }
+    }
+
+    uint32 Stats::Register(const StringID& name, const char* description, EStatType type)
+    {
+        StatRegistry& registry = GetRegistry();
+        std::scoped_lock lock(registry.Mutex);
+        for (int32 index = 0; index < registry.EntryNum; ++index)
+        {
+            if (registry.Entries[index].Name == name)
+            {
+                // same name registered in several places refers to the same stat
+                ENSURE(registry.Entries[index].Type == type);
+                return static_cast<uint32>(index + 1);
+            }
+        }
+
+        const int32 slotNum = type == EStatType::Counter ? 1 : type == EStatType::Histogram ? HISTOGRAM_SLOT_NUM : 0;
+        const int32 usedSlotNum = registry.SlotNum.load(std::memory_order_relaxed);
+        if (registry.EntryNum >= MAX_STAT_NUM || usedSlotNum + slotNum > MAX_SLOT_NUM)
+        {
+            ENSURE(false);
+            return 0;
+        }
+
+        StatEntry& entry = registry.Entries[registry.EntryNum];
+        entry.Name = name;
+        entry.Description = description;
+        entry.Type = type;
+        entry.Slot = slotNum > 0 ? static_cast<uint32>(usedSlotNum) : 0;
+        registry.SlotNum.store(usedSlotNum + slotNum, std::memory_order_release);
+        return static_cast<uint32>(++registry.EntryNum);
+    }
+
+    uint32 Stats::GetSlot(uint32 index)
+    {
+        StatRegistry& registry = GetRegistry();
+        std::scoped_lock lock(registry.Mutex);
+        return index > 0 ? registry.Entries[index - 1].Slot : 0;
+    }
+
+    StatCounter::StatCounter(const StringID& name, const char* description)
+    {
+        // assigned last, so updates made while registering are ignored
+        Slot = Stats::GetSlot(Stats::Register(name, description, EStatType::Counter));
+    }
+
+    void StatCounter::Add(int64 value) const
+    {
+        if (Slot != 0)
+        {
+            AddToSlot(Slot, value);
+        }
+    }
+
+    StatGauge::StatGauge(const StringID& name, const char* description)
+    {
+        Index = Stats::Register(name, description, EStatType::Gauge);
+    }
+
+    void StatGauge::Set(int64 value) const
+    {
+        if (Index != 0)
+        {
+            GetRegistry().Entries[Index - 1].GaugeValue.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    void StatGauge::Add(int64 value) const
+    {
+        if (Index != 0)
+        {
+            GetRegistry().Entries[Index - 1].GaugeValue.fetch_add(value, std::memory_order_relaxed);
+        }
+    }
+
+    int64 StatGauge::Get() const
+    {
+        return Index != 0 ? GetRegistry().Entries[Index - 1].GaugeValue.load(std::memory_order_relaxed) : 0;
+    }
+
+    StatHistogram::StatHistogram(const StringID& name, const char* description)
+    {
+        Slot = Stats::GetSlot(Stats::Register(name, description, EStatType::Histogram));
+    }
+
+    void StatHistogram::Record(int64 value) const
+    {
+        if (Slot == 0)
+        {
+            return;
+        }
+        const int32 bucket = value <= 0 ? 0 : std::min(static_cast<int32>(std::bit_width(static_cast<uint64>(value))),
+                                                        Stats::HISTOGRAM_BUCKET_NUM - 1);
+        AddToSlot(Slot, 1);
+        AddToSlot(Slot + 1, value);
+        AddToSlot(Slot + 2 + bucket, 1);
+    }
+}
@@ -1,23 +1,34 @@
 #include "thread/thread_pool.hpp"
+#include "stats/stats.hpp"
 
 namespace Engine
 {
+    static StatCounter GStatTasksExecuted("ThreadPool.TasksExecuted", "tasks run by workers of thread pools");
+
     WorkThread::WorkThread(IThreadPool* owner)
         : Owner(owner)
     {
         Thread = std::jthread([this]{
-            std::mutex mutex;
-            std::unique_lock<std::mutex> lock(mutex);
-            while (!Stop)
+            while (true)
             {
-                Condition.wait(lock, [this] { return Task != nullptr; });
-
-                IWorkThreadTask* localTask = Task;
-                Task = nullptr;
+                IWorkThreadTask* localTask = nullptr;
+                {
+                    // task and stop are set under the same mutex, so a notification can't be missed
+                    std::unique_lock<std::mutex> lock(Mutex);
+                    Condition.wait(lock, [this] { return Task != nullptr || Stop; });
+                    // a task handed over before stop is still run
+                    if (Task == nullptr)
+                    {
+                        return;
+                    }
+                    localTask = Task;
+                    Task = nullptr;
+                }
 
                 while (localTask)
                 {
                     localTask->Run();
+                    GStatTasksExecuted.Add();
                     localTask = Owner->GetNextTask(*this);
                 }
             }
@@ -52,55 +63,84 @@ namespace Engine
     {
         ENSURE(task);
 
-        WorkThread* worker = nullptr;
         {
-            std::scoped_lock lock(WorkerQueueMutex);
-            if (!IdleWorkers.empty())
+            // both queues are locked, otherwise a worker may find task queue empty and turn idle
+            // right after the task was queued for lack of idle workers, leaving the task unrun
+            std::scoped_lock lock(TaskQueueMutex, WorkerQueueMutex);
+            if (!Destroying)
             {
-                worker = IdleWorkers.front();
+                if (IdleWorkers.empty())
+                {
+                    TaskQueue.push(task);
+                    return;
+                }
+
+                // worker is handed the task before queue locks are released, so destroy can't free it in between
+                WorkThread* worker = IdleWorkers.front();
                 IdleWorkers.pop();
+                std::scoped_lock workerLock(worker->Mutex);
+                worker->Task = task;
+                worker->Condition.notify_one();
+                return;
             }
         }
 
-        if (worker)
-        {
-            worker->Task = task;
-            worker->Condition.notify_one();
-        }
-        else
-        {
-            std::scoped_lock lock(TaskQueueMutex);
-            TaskQueue.push(task);
-        }
+        // workers are stopping, eg: a running task adds more work while pool is destroyed
+        task->Run();
+        GStatTasksExecuted.Add();
     }
 
     IWorkThreadTask* BuiltInThreadPool::GetNextTask(WorkThread& worker)
     {
+        std::scoped_lock lock(TaskQueueMutex, WorkerQueueMutex);
+        if (!TaskQueue.empty())
         {
-            std::scoped_lock lock(TaskQueueMutex);
-            if (!TaskQueue.empty())
-            {
-                IWorkThreadTask* task = TaskQueue.front();
-                TaskQueue.pop();
-                return task;
-            }
+            IWorkThreadTask* task = TaskQueue.front();
+            TaskQueue.pop();
+            return task;
         }
 
+        if (!Destroying)
         {
-            std::scoped_lock lock(WorkerQueueMutex);
             IdleWorkers.push(&worker);
         }
-
         return nullptr;
     }
 
     void BuiltInThreadPool::DestroyInternal()
     {
+        {
+            std::scoped_lock lock(TaskQueueMutex, WorkerQueueMutex);
+            Destroying = true;
+        }
+
+        // every worker is stopped before any is freed, busy workers keep draining task queue until it's empty
+        for (auto&& worker : AllWorkers)
+        {
+            {
+                std::scoped_lock lock(worker->Mutex);
+                worker->Stop = true;
+            }
+            worker->Condition.notify_one();
+        }
         for (auto&& worker : AllWorkers)
         {
-            worker->Stop = true;
+            // joins the thread
             delete worker;
         }
         AllWorkers.Clear();
+
+        IdleWorkers = std::queue<WorkThread*>();
+        // only left if pool has no worker
+        while (!TaskQueue.empty())
+        {
+            IWorkThreadTask* task = TaskQueue.front();
+            TaskQueue.pop();
+            task->Run();
+            GStatTasksExecuted.Add();
+        }
+
+        std::scoped_lock lock(TaskQueueMutex, WorkerQueueMutex);
+        Destroying = false;
     }
 }
\ No newline at end of file
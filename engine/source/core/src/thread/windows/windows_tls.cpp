@@ -1,6 +1,7 @@
 //#include "precompiled_core.hpp"
-#include "windows/minimal_windows.hpp"
 #include "windows/windows_tls.hpp"
+#if PLATFORM_WINDOWS
+#include "windows/minimal_windows.hpp"
 
 namespace Engine
 {
@@ -28,4 +29,5 @@ namespace Engine
     {
         ::TlsSetValue(tlsIndex, value);
     }
-}
\ No newline at end of file
+}
+#endif
@@ -0,0 +1,71 @@
+#include "file_system/async_file_io.hpp"
+#if PLATFORM_WINDOWS
+#include "windows/minimal_windows.hpp"
+#include "log/logger.hpp"
+#include "math/generic_math.hpp"
+#include "math/limit.hpp"
+#include "file_system/async_io_backend.hpp"
+#include "file_system/file_system_log.hpp"
+
+namespace Engine
+{
+    AsyncReadFile::~AsyncReadFile()
+    {
+        ::CloseHandle(reinterpret_cast<HANDLE>(NativeHandle));
+    }
+
+    SharedPtr<AsyncReadFile> AsyncFileIO::OpenFile(const String& filePath)
+    {
+        HANDLE handle = ::CreateFileA(filePath.Data(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (handle == INVALID_HANDLE_VALUE)
+        {
+            LOG_ERROR(FileSystem, "Open file {0} for async reading failed, error code: {1:d}", filePath.Data(), ::GetLastError());
+            return nullptr;
+        }
+
+        LARGE_INTEGER size;
+        ::GetFileSizeEx(handle, &size);
+        return MakeShared<AsyncReadFile>(reinterpret_cast<intptr>(handle), static_cast<int64>(size.QuadPart));
+    }
+
+    int64 AsyncFileIO::ReadAt(intptr nativeHandle, uint8* dest, int64 offset, int64 size)
+    {
+        HANDLE handle = reinterpret_cast<HANDLE>(nativeHandle);
+        int64 totalSize = 0;
+        while (totalSize < size)
+        {
+            // offset in OVERLAPPED makes synchronous read positional, so io threads can share one handle
+            OVERLAPPED overlapped{};
+            ULARGE_INTEGER pos;
+            pos.QuadPart = static_cast<uint64>(offset + totalSize);
+            overlapped.Offset = pos.LowPart;
+            overlapped.OffsetHigh = pos.HighPart;
+
+            DWORD readBytes = 0;
+            DWORD bytesToRead = static_cast<DWORD>(Math::Min(size - totalSize, static_cast<int64>(MAX_DWORD)));
+            if (!::ReadFile(handle, dest + totalSize, bytesToRead, &readBytes, &overlapped))
+            {
+                const DWORD error = ::GetLastError();
+                if (error == ERROR_HANDLE_EOF)
+                {
+                    break;
+                }
+                LOG_ERROR(FileSystem, "Async read file meet error, error code: {0:d}", error);
+                return -1;
+            }
+
+            if (readBytes == 0)
+            {
+                break;
+            }
+            totalSize += readBytes;
+        }
+        return totalSize;
+    }
+
+    UniquePtr<IAsyncIOBackend> CreateNativeAsyncIOBackend()
+    {
+        return nullptr;
+    }
+}
+#endif
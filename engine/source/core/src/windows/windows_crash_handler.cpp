@@ -0,0 +1,66 @@
+#include "log/crash_handler.hpp"
+#if PLATFORM_WINDOWS
+#include <atomic>
+#include <csignal>
+#include <cstdlib>
+#include <exception>
+#include "windows/minimal_windows.hpp"
+
+namespace Engine
+{
+    namespace
+    {
+        CrashCallback GCrashCallback = nullptr;
+        LPTOP_LEVEL_EXCEPTION_FILTER GPreviousFilter = nullptr;
+        _crt_signal_t GPreviousAbortHandler = SIG_DFL;
+        std::terminate_handler GPreviousTerminate = nullptr;
+        /** set by the first crash, abort raised by terminate handler doesn't call callback again */
+        std::atomic<bool> GCrashHandled{ false };
+
+        void CallCrashCallback()
+        {
+            if (!GCrashHandled.exchange(true))
+            {
+                GCrashCallback();
+            }
+        }
+
+        LONG WINAPI HandleUnhandledException(EXCEPTION_POINTERS* exceptionInfo)
+        {
+            CallCrashCallback();
+            return GPreviousFilter != nullptr ? GPreviousFilter(exceptionInfo) : EXCEPTION_CONTINUE_SEARCH;
+        }
+
+        void HandleAbort(int32 signal)
+        {
+            // crt signal handler runs on raising thread like a plain call, unlike posix signals
+            CallCrashCallback();
+            ::signal(SIGABRT, GPreviousAbortHandler);
+            ::raise(signal);
+        }
+
+        void HandleTerminate()
+        {
+            CallCrashCallback();
+            if (GPreviousTerminate != nullptr)
+            {
+                GPreviousTerminate();
+            }
+            std::abort();
+        }
+    }
+
+    void InstallCrashHandler(CrashCallback callback)
+    {
+        if (GCrashCallback != nullptr)
+        {
+            return;
+        }
+        GCrashCallback = callback;
+
+        GPreviousFilter = ::SetUnhandledExceptionFilter(HandleUnhandledException);
+        GPreviousAbortHandler = ::signal(SIGABRT, HandleAbort);
+        GPreviousTerminate = std::set_terminate(HandleTerminate);
+    }
+}
+#endif
@@ -1,13 +1,25 @@
 #include "windows/windows_file_handle.hpp"
+#if PLATFORM_WINDOWS
 #include "log/logger.hpp"
 #include "math/generic_math.hpp"
 #include "math/limit.hpp"
 #include "file_system/path.hpp"
 #include "windows/windows_utils.hpp"
 #include "file_system/file_system_log.hpp"
+#include "stats/stats.hpp"
 
 namespace Engine
 {
+    static StatCounter GStatBytesRead("FileSystem.BytesRead", "bytes read from files, including async reads");
+
+    static void SetOverlappedOffset(OVERLAPPED& overlapped, int64 offset)
+    {
+        ULARGE_INTEGER pos;
+        pos.QuadPart = static_cast<uint64>(offset);
+        overlapped.Offset = pos.LowPart;
+        overlapped.OffsetHigh = pos.HighPart;
+    }
+
     WindowsFileHandle::~WindowsFileHandle()
     {
         bool result = CloseHandle(Handle);
@@ -16,49 +28,222 @@ namespace Engine
 
     int64 WindowsFileHandle::GetSize() const
     {
-        return Size;
+        LARGE_INTEGER size;
+        if (!::GetFileSizeEx(Handle, &size))
+        {
+            return -1;
+        }
+        return size.QuadPart;
     }
 
-    void WindowsFileHandle::CalcFileSize()
+    bool WindowsFileHandle::Read(uint8* dest, int64 size)
     {
-        LARGE_INTEGER size;
-        GetFileSizeEx(Handle, &size);
-        Size = size.QuadPart;
+        const int64 readBytes = ReadAt(dest, size, PosInFile);
+        if (readBytes > 0)
+        {
+            PosInFile += readBytes;
+        }
+        return readBytes == size;
     }
 
-    bool WindowsFileHandle::Read(uint8* dest, int64 size)
+    bool WindowsFileHandle::Write(const uint8* src, int64 size)
+    {
+        const int64 writtenBytes = WriteAt(src, size, PosInFile);
+        if (writtenBytes > 0)
+        {
+            PosInFile += writtenBytes;
+        }
+        return writtenBytes == size;
+    }
+
+    bool WindowsFileHandle::Seek(int64 offset, ESeekOrigin origin)
     {
-        if (size <= 0)
+        int64 base = 0;
+        if (origin == ESeekOrigin::Current)
+        {
+            base = PosInFile;
+        }
+        else if (origin == ESeekOrigin::End)
+        {
+            base = GetSize();
+        }
+
+        if (base < 0 || base + offset < 0)
         {
             return false;
         }
+        PosInFile = base + offset;
+        return true;
+    }
 
-        uint64 totalSize = 0;
-        do
+    int64 WindowsFileHandle::Tell() const
+    {
+        return PosInFile;
+    }
+
+    int64 WindowsFileHandle::ReadAt(uint8* dest, int64 size, int64 offset)
+    {
+        int64 totalSize = 0;
+        while (totalSize < size)
         {
+            // offset in OVERLAPPED makes read on synchronous handle positional
+            OVERLAPPED overlapped{ 0 };
+            SetOverlappedOffset(overlapped, offset + totalSize);
+
             DWORD readBytes = 0;
-            DWORD bytesToRead = (DWORD)Math::Min(size, static_cast<int64>(MAX_DWORD));
-            if (!::ReadFile(Handle, dest, bytesToRead, &readBytes, &Overlapped))
+            DWORD bytesToRead = static_cast<DWORD>(Math::Min(size - totalSize, static_cast<int64>(MAX_DWORD)));
+            if (!::ReadFile(Handle, dest + totalSize, bytesToRead, &readBytes, &overlapped))
             {
-                LOG_ERROR(FileSystem, "Read file meet error, error code: {0:d}", ::GetLastError());
+                const DWORD error = ::GetLastError();
+                if (error == ERROR_HANDLE_EOF)
+                {
+                    break;
+                }
+                LOG_ERROR(FileSystem, "Read file meet error, error code: {0:d}", error);
+                return -1;
+            }
+
+            if (readBytes == 0)
+            {
+                break;
             }
-            size -= bytesToRead;
-            dest += bytesToRead;
             totalSize += readBytes;
-            PosInFile += readBytes;
-            UpdateOverlapped();
         }
-        while(size > 0);
+        GStatBytesRead.Add(totalSize);
+        return totalSize;
+    }
 
-        return totalSize == size;
+    int64 WindowsFileHandle::WriteAt(const uint8* src, int64 size, int64 offset)
+    {
+        int64 totalSize = 0;
+        while (totalSize < size)
+        {
+            OVERLAPPED overlapped{ 0 };
+            SetOverlappedOffset(overlapped, offset + totalSize);
+
+            DWORD writtenBytes = 0;
+            DWORD bytesToWrite = static_cast<DWORD>(Math::Min(size - totalSize, static_cast<int64>(MAX_DWORD)));
+            if (!::WriteFile(Handle, src + totalSize, bytesToWrite, &writtenBytes, &overlapped))
+            {
+                LOG_ERROR(FileSystem, "Write file meet error, error code: {0:d}", ::GetLastError());
+                return -1;
+            }
+
+            if (writtenBytes == 0)
+            {
+                LOG_ERROR(FileSystem, "Write file stopped after {0} of {1} bytes", totalSize, size);
+                break;
+            }
+            totalSize += writtenBytes;
+        }
+        return totalSize;
     }
 
-    void WindowsFileHandle::UpdateOverlapped()
+    int64 WindowsFileHandle::ReadV(const FileReadVector* vectors, int32 count, int64 offset)
     {
-        ULARGE_INTEGER pos;
-        pos.QuadPart = PosInFile;
-        Overlapped.Offset = pos.LowPart;
-        Overlapped.OffsetHigh = pos.HighPart;
+        // ReadFileScatter only works with unbuffered handle and page sized buffers
+        int64 totalSize = 0;
+        for (int32 index = 0; index < count; ++index)
+        {
+            const int64 readBytes = ReadAt(vectors[index].Dest, vectors[index].Size, offset + totalSize);
+            if (readBytes < 0)
+            {
+                return -1;
+            }
+
+            totalSize += readBytes;
+            if (readBytes < vectors[index].Size)
+            {
+                break;
+            }
+        }
+        return totalSize;
+    }
+
+    int64 WindowsFileHandle::WriteV(const FileWriteVector* vectors, int32 count, int64 offset)
+    {
+        int64 totalSize = 0;
+        for (int32 index = 0; index < count; ++index)
+        {
+            const int64 writtenBytes = WriteAt(vectors[index].Src, vectors[index].Size, offset + totalSize);
+            if (writtenBytes < 0)
+            {
+                return -1;
+            }
+
+            totalSize += writtenBytes;
+            if (writtenBytes < vectors[index].Size)
+            {
+                break;
+            }
+        }
+        return totalSize;
+    }
+
+    bool WindowsFileHandle::Truncate(int64 size)
+    {
+        FILE_END_OF_FILE_INFO info;
+        info.EndOfFile.QuadPart = size;
+        if (!::SetFileInformationByHandle(Handle, FileEndOfFileInfo, &info, sizeof(info)))
+        {
+            LOG_ERROR(FileSystem, "Truncate file failed, error code: {0:d}", ::GetLastError());
+            return false;
+        }
+        return true;
+    }
+
+    bool WindowsFileHandle::Flush()
+    {
+        return ::FlushFileBuffers(Handle);
+    }
+
+    WindowsMappedFileHandle::~WindowsMappedFileHandle()
+    {
+        if (View != nullptr)
+        {
+            ::UnmapViewOfFile(View);
+        }
+        if (Mapping != nullptr)
+        {
+            ::CloseHandle(Mapping);
+        }
+        if (File != nullptr && File != INVALID_HANDLE_VALUE)
+        {
+            ::CloseHandle(File);
+        }
+    }
+
+    const uint8* WindowsMappedFileHandle::GetData() const
+    {
+        return View != nullptr ? View + ViewOffset : nullptr;
+    }
+
+    int64 WindowsMappedFileHandle::GetSize() const
+    {
+        return Size;
+    }
+
+    void WindowsMappedFileHandle::Advise(EMappedAccessHint hint, int64 offset, int64 size)
+    {
+        // sequential and random hints only work as flags of CreateFile, which are applied in MapFile
+        if (hint == EMappedAccessHint::WillNeed)
+        {
+            Prefetch(offset, size);
+        }
+    }
+
+    void WindowsMappedFileHandle::Prefetch(int64 offset, int64 size)
+    {
+        if (View == nullptr || offset >= Size)
+        {
+            return;
+        }
+
+        size = size < 0 ? Size - offset : Math::Min(size, Size - offset);
+        WIN32_MEMORY_RANGE_ENTRY range;
+        range.VirtualAddress = View + ViewOffset + offset;
+        range.NumberOfBytes = static_cast<SIZE_T>(size);
+        ::PrefetchVirtualMemory(::GetCurrentProcess(), 1, &range, 0);
     }
 
     WindowsFindFileHandle::WindowsFindFileHandle(const String& path)
@@ -190,4 +375,5 @@ namespace Engine
         Handle = ::FindFirstFileA(path.Data(), &data);
         return Handle;
     }
-}
\ No newline at end of file
+}
+#endif
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "global.hpp"
+#if PLATFORM_WINDOWS
 #include "windows/minimal_windows.hpp"
 #include "file_system/file_handle_interface.hpp"
 
@@ -8,26 +10,61 @@ namespace Engine
     class CORE_API WindowsFileHandle final : public IFileHandle
     {
     public:
-        explicit WindowsFileHandle(HANDLE handle) : Handle(handle)
-        {
-            CalcFileSize();
-        }
+        explicit WindowsFileHandle(HANDLE handle) : Handle(handle) {}
 
         ~WindowsFileHandle() final;
 
         int64 GetSize() const final;
 
         bool Read(uint8* dest, int64 size) final;
-    private:
-        void CalcFileSize();
 
-        void UpdateOverlapped();
+        bool Write(const uint8* src, int64 size) final;
+
+        bool Seek(int64 offset, ESeekOrigin origin) final;
+
+        int64 Tell() const final;
+
+        int64 ReadAt(uint8* dest, int64 size, int64 offset) final;
+
+        int64 WriteAt(const uint8* src, int64 size, int64 offset) final;
+
+        int64 ReadV(const FileReadVector* vectors, int32 count, int64 offset) final;
+
+        int64 WriteV(const FileWriteVector* vectors, int32 count, int64 offset) final;
+
+        bool Truncate(int64 size) final;
+
+        bool Flush() final;
 
     private:
         HANDLE Handle{ nullptr };
+        /** cursor is kept by handle, every io passes an explicit offset so positional io can't disturb it */
+        int64 PosInFile{ 0 };
+    };
+
+    class CORE_API WindowsMappedFileHandle final : public IMappedFileHandle
+    {
+    public:
+        WindowsMappedFileHandle(HANDLE file, HANDLE mapping, uint8* view, int64 viewOffset, int64 size)
+            : File(file), Mapping(mapping), View(view), ViewOffset(viewOffset), Size(size)
+        {}
+
+        ~WindowsMappedFileHandle() final;
+
+        const uint8* GetData() const final;
+
+        int64 GetSize() const final;
+
+        void Advise(EMappedAccessHint hint, int64 offset, int64 size) final;
+
+        void Prefetch(int64 offset, int64 size) final;
+
+    private:
+        HANDLE File{ nullptr };
+        HANDLE Mapping{ nullptr };
+        uint8* View{ nullptr };
+        int64 ViewOffset{ 0 };
         int64 Size{ 0 };
-        uint64 PosInFile{ 0 };
-        OVERLAPPED Overlapped{ 0 };
     };
 
     class CORE_API WindowsFindFileHandle final : public IFindFileHandle
@@ -62,6 +99,8 @@ namespace Engine
     };
 
     typedef WindowsFileHandle PlatformFileHandle;
+    typedef WindowsMappedFileHandle PlatformMappedFileHandle;
     typedef WindowsFindFileHandle PlatformFindFileHandle;
     typedef WindowsRecursiveFindFileHandle PlatformRecursiveFindFileHandle;
-}
\ No newline at end of file
+}
+#endif
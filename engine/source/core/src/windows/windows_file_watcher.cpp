@@ -0,0 +1,303 @@
+#include "file_system/file_watcher.hpp"
+#if PLATFORM_WINDOWS
+#include <mutex>
+#include "windows/minimal_windows.hpp"
+#include "log/logger.hpp"
+#include "file_system/file_system_log.hpp"
+#include "file_system/file_watcher_backend.hpp"
+
+namespace Engine
+{
+    /**
+     * Every watched directory keeps an overlapped ReadDirectoryChangesW in flight, watcher thread waits on their events.
+     * Reads are issued and cancelled by watcher thread only, as pending io is cancelled when the issuing thread exits,
+     * so AddWatch and RemoveWatch just queue the request and wake it up.
+     */
+    class WindowsFileWatcherBackend final : public IFileWatcherBackend
+    {
+    public:
+        static UniquePtr<IFileWatcherBackend> Create()
+        {
+            HANDLE wakeEvent = ::CreateEventA(nullptr, FALSE, FALSE, nullptr);
+            if (wakeEvent == nullptr)
+            {
+                LOG_ERROR(FileSystem, "Create event failed, error code: {0:d}", ::GetLastError());
+                return nullptr;
+            }
+            return UniquePtr<IFileWatcherBackend>(new WindowsFileWatcherBackend(wakeEvent));
+        }
+
+        ~WindowsFileWatcherBackend() final
+        {
+            for (auto& pair : Watches)
+            {
+                CloseWatch(*pair.Value);
+            }
+            for (UniquePtr<DirectoryWatch>& watch : PendingAdds)
+            {
+                CloseWatch(*watch);
+            }
+            ::CloseHandle(WakeEvent);
+        }
+
+        bool AddWatch(FileWatchHandle handle, const String& directory, bool recursive) final
+        {
+            HANDLE dirHandle = ::CreateFileA(directory.Data(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                             nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+            if (dirHandle == INVALID_HANDLE_VALUE)
+            {
+                LOG_ERROR(FileSystem, "Watch directory {0} failed, error code: {1:d}", directory.Data(), ::GetLastError());
+                return false;
+            }
+
+            UniquePtr<DirectoryWatch> watch = MakeUnique<DirectoryWatch>();
+            watch->Handle = handle;
+            watch->Path = directory.EndsWith('/') ? directory : directory + "/";
+            watch->Recursive = recursive;
+            watch->DirHandle = dirHandle;
+            watch->Overlapped.hEvent = ::CreateEventA(nullptr, TRUE, FALSE, nullptr);
+
+            {
+                std::scoped_lock lock(Mutex);
+                // one slot of WaitForMultipleObjects is taken by wake event
+                if (Watches.Size() + PendingAdds.Size() >= MAXIMUM_WAIT_OBJECTS - 1)
+                {
+                    LOG_ERROR(FileSystem, "Watch directory {0} failed, too many directories are watched", directory.Data());
+                    CloseWatch(*watch);
+                    return false;
+                }
+                PendingAdds.Add(MoveTemp(watch));
+            }
+            Wake();
+            return true;
+        }
+
+        void RemoveWatch(FileWatchHandle handle) final
+        {
+            {
+                std::scoped_lock lock(Mutex);
+                for (int32 index = 0; index < PendingAdds.Size(); ++index)
+                {
+                    if (PendingAdds[index]->Handle == handle)
+                    {
+                        CloseWatch(*PendingAdds[index]);
+                        PendingAdds.RemoveAt(index);
+                        return;
+                    }
+                }
+                PendingRemoves.Add(handle);
+            }
+            Wake();
+        }
+
+        void WaitChanges(int32 timeoutMs, Array<RawFileChange>& outChanges) final
+        {
+            ApplyPendingRequests();
+
+            HANDLE events[MAXIMUM_WAIT_OBJECTS];
+            DWORD eventNum = 0;
+            events[eventNum++] = WakeEvent;
+            for (auto& pair : Watches)
+            {
+                events[eventNum++] = pair.Value->Overlapped.hEvent;
+            }
+
+            const DWORD result = ::WaitForMultipleObjects(eventNum, events, FALSE, timeoutMs < 0 ? INFINITE : static_cast<DWORD>(timeoutMs));
+            if (result == WAIT_TIMEOUT || result == WAIT_FAILED || result == WAIT_OBJECT_0)
+            {
+                return;
+            }
+
+            Array<FileWatchHandle> brokenWatches;
+            for (auto& pair : Watches)
+            {
+                DirectoryWatch& watch = *pair.Value;
+                if (HasOverlappedIoCompleted(&watch.Overlapped) && !ReadChanges(watch, outChanges))
+                {
+                    brokenWatches.Add(pair.Key);
+                }
+            }
+
+            if (!brokenWatches.Empty())
+            {
+                std::scoped_lock lock(Mutex);
+                for (FileWatchHandle handle : brokenWatches)
+                {
+                    CloseWatch(*Watches.FindRef(handle));
+                    Watches.Remove(handle);
+                }
+            }
+        }
+
+        void Wake() final
+        {
+            ::SetEvent(WakeEvent);
+        }
+
+    private:
+        struct DirectoryWatch
+        {
+            FileWatchHandle Handle;
+            /** ends with '/' */
+            String Path;
+            bool Recursive;
+            HANDLE DirHandle{ INVALID_HANDLE_VALUE };
+            OVERLAPPED Overlapped{};
+            /** buffer larger than 64KB fails on network drives */
+            alignas(DWORD) uint8 Buffer[64 * 1024];
+        };
+
+        static constexpr DWORD NOTIFY_FILTER = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_SIZE |
+                                               FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_CREATION;
+
+        explicit WindowsFileWatcherBackend(HANDLE wakeEvent) : WakeEvent(wakeEvent) {}
+
+        static bool IssueRead(DirectoryWatch& watch)
+        {
+            if (!::ReadDirectoryChangesW(watch.DirHandle, watch.Buffer, sizeof(watch.Buffer), watch.Recursive ? TRUE : FALSE,
+                                         NOTIFY_FILTER, nullptr, &watch.Overlapped, nullptr))
+            {
+                LOG_ERROR(FileSystem, "Read changes of directory {0} failed, error code: {1:d}", watch.Path.Data(), ::GetLastError());
+                return false;
+            }
+            return true;
+        }
+
+        static void CloseWatch(DirectoryWatch& watch)
+        {
+            if (watch.DirHandle != INVALID_HANDLE_VALUE)
+            {
+                DWORD bytes;
+                if (::CancelIoEx(watch.DirHandle, &watch.Overlapped) || ::GetLastError() != ERROR_NOT_FOUND)
+                {
+                    // buffer must stay alive until cancelled read completes
+                    ::GetOverlappedResult(watch.DirHandle, &watch.Overlapped, &bytes, TRUE);
+                }
+                ::CloseHandle(watch.DirHandle);
+                watch.DirHandle = INVALID_HANDLE_VALUE;
+            }
+            if (watch.Overlapped.hEvent != nullptr)
+            {
+                ::CloseHandle(watch.Overlapped.hEvent);
+                watch.Overlapped.hEvent = nullptr;
+            }
+        }
+
+        static String ToPathString(const WCHAR* name, int32 length)
+        {
+            const int32 size = ::WideCharToMultiByte(CP_UTF8, 0, name, length, nullptr, 0, nullptr, nullptr);
+            String ret(size, '\0');
+            ::WideCharToMultiByte(CP_UTF8, 0, name, length, ret.Data(), size, nullptr, nullptr);
+            ret.Replace("\\", "/");
+            return ret;
+        }
+
+        void ApplyPendingRequests()
+        {
+            std::scoped_lock lock(Mutex);
+            for (FileWatchHandle handle : PendingRemoves)
+            {
+                if (UniquePtr<DirectoryWatch>* watch = Watches.Find(handle))
+                {
+                    CloseWatch(**watch);
+                    Watches.Remove(handle);
+                }
+            }
+            PendingRemoves.Clear();
+
+            for (UniquePtr<DirectoryWatch>& watch : PendingAdds)
+            {
+                if (IssueRead(*watch))
+                {
+                    const FileWatchHandle handle = watch->Handle;
+                    Watches.Add(handle, MoveTemp(watch));
+                }
+                else
+                {
+                    CloseWatch(*watch);
+                }
+            }
+            PendingAdds.Clear();
+        }
+
+        /** @return false if directory can't be watched any more, eg: it's removed */
+        bool ReadChanges(DirectoryWatch& watch, Array<RawFileChange>& outChanges)
+        {
+            DWORD bytes = 0;
+            if (!::GetOverlappedResult(watch.DirHandle, &watch.Overlapped, &bytes, FALSE))
+            {
+                LOG_WARN(FileSystem, "Stop watching directory {0}, error code: {1:d}", watch.Path.Data(), ::GetLastError());
+                return false;
+            }
+
+            if (bytes == 0)
+            {
+                LOG_WARN(FileSystem, "Too many changes in directory {0}, some of them are lost", watch.Path.Data());
+                outChanges.Add(RawFileChange{ watch.Handle, EFileChangeAction::Overflow, watch.Path.Slices(0, watch.Path.Length() - 1), String() });
+            }
+
+            String oldPath;
+            for (DWORD offset = 0; bytes > 0;)
+            {
+                const FILE_NOTIFY_INFORMATION* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(watch.Buffer + offset);
+                String path = watch.Path + ToPathString(info->FileName, static_cast<int32>(info->FileNameLength / sizeof(WCHAR)));
+                switch (info->Action)
+                {
+                    case FILE_ACTION_ADDED:
+                        outChanges.Add(RawFileChange{ watch.Handle, EFileChangeAction::Added, MoveTemp(path), String() });
+                        break;
+                    case FILE_ACTION_REMOVED:
+                        outChanges.Add(RawFileChange{ watch.Handle, EFileChangeAction::Removed, MoveTemp(path), String() });
+                        break;
+                    case FILE_ACTION_MODIFIED:
+                    {
+                        // directory is modified whenever its content changes, it's reported by the content itself
+                        const DWORD attributes = ::GetFileAttributesA(path.Data());
+                        if (attributes == INVALID_FILE_ATTRIBUTES || (attributes & FILE_ATTRIBUTE_DIRECTORY) == 0)
+                        {
+                            outChanges.Add(RawFileChange{ watch.Handle, EFileChangeAction::Modified, MoveTemp(path), String() });
+                        }
+                        break;
+                    }
+                    case FILE_ACTION_RENAMED_OLD_NAME:
+                        oldPath = MoveTemp(path);
+                        break;
+                    case FILE_ACTION_RENAMED_NEW_NAME:
+                    {
+                        const EFileChangeAction action = oldPath.Empty() ? EFileChangeAction::Added : EFileChangeAction::Renamed;
+                        outChanges.Add(RawFileChange{ watch.Handle, action, MoveTemp(path), MoveTemp(oldPath) });
+                        oldPath.Clear();
+                        break;
+                    }
+                    default:
+                        break;
+                }
+
+                if (info->NextEntryOffset == 0)
+                {
+                    break;
+                }
+                offset += info->NextEntryOffset;
+            }
+
+            if (!oldPath.Empty())
+            {
+                outChanges.Add(RawFileChange{ watch.Handle, EFileChangeAction::Removed, MoveTemp(oldPath), String() });
+            }
+            return IssueRead(watch);
+        }
+
+        HANDLE WakeEvent;
+        std::mutex Mutex;
+        Array<UniquePtr<DirectoryWatch>> PendingAdds;
+        Array<FileWatchHandle> PendingRemoves;
+        /** modified by watcher thread with lock held, so it's read by watcher thread without lock */
+        Map<FileWatchHandle, UniquePtr<DirectoryWatch>> Watches;
+    };
+
+    UniquePtr<IFileWatcherBackend> CreateFileWatcherBackend()
+    {
+        return WindowsFileWatcherBackend::Create();
+    }
+}
+#endif
@@ -1,9 +1,11 @@
-#include <corecrt_io.h>
 #include "windows/windows_platform_file.hpp"
+#if PLATFORM_WINDOWS
+#include <corecrt_io.h>
 #include "foundation/regex.hpp"
 #include "file_system/path.hpp"
 #include "foundation/queue.hpp"
 #include "windows/windows_file_handle.hpp"
+#include "windows/windows_utils.hpp"
 #include "log/logger.hpp"
 #include "file_system/file_system_log.hpp"
 
@@ -13,14 +15,8 @@ namespace Engine
 {
     static uint64 GetTimeStamp(const ::FILETIME& fileTime)
     {
-        const uint64 k_UnixTimeStart = 0x019DB1DED53E8000;
-        const uint64 k_TicksPerSecond = 10000000;
-
-        ULARGE_INTEGER li;
-        li.LowPart = fileTime.dwLowDateTime;
-        li.HighPart = fileTime.dwHighDateTime;
-
-        return (li.QuadPart - k_UnixTimeStart) / k_TicksPerSecond;
+        // same conversion as FileStat of directory entries, truncated to seconds
+        return static_cast<uint64>(FileTimeToTimestamp(fileTime).TimeSinceEpoch());
     }
 
     bool WindowsPlatformFile::MakeDir(const String& path)
@@ -161,6 +157,51 @@ namespace Engine
         return ret;
     }
 
+    bool WindowsPlatformFile::IterateDirectory(const String& directory, const DirectoryVisitor& visitor)
+    {
+        const String prefix = directory.EndsWith('/') || directory.EndsWith('\\') ? directory : directory + "/";
+        const String queryPath = prefix + "*";
+
+        // basic info skips short names, large fetch asks for more entries per call
+        WIN32_FIND_DATAA data;
+        HANDLE handle = ::FindFirstFileExA(queryPath.Data(), FindExInfoBasic, &data, FindExSearchNameMatch, nullptr,
+                                           FIND_FIRST_EX_LARGE_FETCH);
+        if (handle == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+
+        do
+        {
+            if (CharTraits<char>::Compare(data.cFileName, ".") == 0 ||
+                CharTraits<char>::Compare(data.cFileName, "..") == 0)
+            {
+                continue;
+            }
+
+            ULARGE_INTEGER fileSize;
+            fileSize.HighPart = data.nFileSizeHigh;
+            fileSize.LowPart = data.nFileSizeLow;
+
+            FileStat status{FileTimeToTimestamp(data.ftLastWriteTime),
+                            FileTimeToTimestamp(data.ftLastAccessTime),
+                            FileTimeToTimestamp(data.ftCreationTime),
+                            static_cast<int64>(fileSize.QuadPart),
+                            (data.dwFileAttributes & FILE_ATTRIBUTE_READONLY) != 0,
+                            (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0,
+                            true
+            };
+
+            if (!visitor(DirectoryEntry(status, prefix + data.cFileName)))
+            {
+                break;
+            }
+        } while (::FindNextFileA(handle, &data));
+
+        ::FindClose(handle);
+        return true;
+    }
+
     uint32 WindowsPlatformFile::GetLastError()
     {
         return (uint32) ::GetLastError();
@@ -170,6 +211,7 @@ namespace Engine
     {
         int64 desiredAccess = 0;
         int32 shareMode = 0;
+        DWORD creation = OPEN_EXISTING;
         switch (access)
         {
             case EFileAccess::Read:
@@ -180,11 +222,13 @@ namespace Engine
             case EFileAccess::Write:
             {
                 desiredAccess = GENERIC_WRITE;
+                creation = CREATE_ALWAYS;
                 break;
             }
             case EFileAccess::ReadWrite:
             {
                 desiredAccess = GENERIC_READ | GENERIC_WRITE;
+                creation = OPEN_ALWAYS;
                 break;
             }
             default:
@@ -215,14 +259,87 @@ namespace Engine
                 shareMode = 0;
             }
         }
-        HANDLE handle = ::CreateFileA(filePath.Data(), desiredAccess, shareMode, nullptr, OPEN_EXISTING,
+        HANDLE handle = ::CreateFileA(filePath.Data(), desiredAccess, shareMode, nullptr, creation,
                                       FILE_ATTRIBUTE_NORMAL, nullptr);
 
         if (handle == INVALID_HANDLE_VALUE)
         {
-            LOG_ERROR(FileSystem, "Open file failed");
+            LOG_ERROR(FileSystem, "Open file {0} failed, error code: {1:d}", filePath.Data(), GetLastError());
+            return nullptr;
         }
 
         return MakeUnique<WindowsFileHandle>(handle);
     }
-}
\ No newline at end of file
+
+    UniquePtr<IMappedFileHandle> WindowsPlatformFile::MapFile(const String& filePath, int64 offset, int64 length, EMappedAccessHint hint)
+    {
+        DWORD flags = FILE_ATTRIBUTE_NORMAL;
+        if (hint == EMappedAccessHint::Sequential)
+        {
+            flags |= FILE_FLAG_SEQUENTIAL_SCAN;
+        }
+        else if (hint == EMappedAccessHint::Random)
+        {
+            flags |= FILE_FLAG_RANDOM_ACCESS;
+        }
+
+        HANDLE file = ::CreateFileA(filePath.Data(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, flags, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            LOG_ERROR(FileSystem, "Open file {0} for mapping failed, error code: {1:d}", filePath.Data(), GetLastError());
+            return nullptr;
+        }
+
+        LARGE_INTEGER fileSize;
+        ::GetFileSizeEx(file, &fileSize);
+        if (offset < 0 || offset > fileSize.QuadPart)
+        {
+            LOG_ERROR(FileSystem, "Map file {0} with invalid offset {1:d}", filePath.Data(), offset);
+            ::CloseHandle(file);
+            return nullptr;
+        }
+
+        if (length < 0 || offset + length > fileSize.QuadPart)
+        {
+            length = fileSize.QuadPart - offset;
+        }
+
+        // empty file can't be mapped
+        if (length == 0)
+        {
+            return MakeUnique<WindowsMappedFileHandle>(file, nullptr, nullptr, 0, 0);
+        }
+
+        HANDLE mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr)
+        {
+            LOG_ERROR(FileSystem, "Create file mapping of {0} failed, error code: {1:d}", filePath.Data(), GetLastError());
+            ::CloseHandle(file);
+            return nullptr;
+        }
+
+        // view must start at a multiple of allocation granularity
+        SYSTEM_INFO info;
+        ::GetSystemInfo(&info);
+        const int64 viewOffset = offset % info.dwAllocationGranularity;
+        ULARGE_INTEGER viewStart;
+        viewStart.QuadPart = offset - viewOffset;
+
+        void* view = ::MapViewOfFile(mapping, FILE_MAP_READ, viewStart.HighPart, viewStart.LowPart, static_cast<SIZE_T>(viewOffset + length));
+        if (view == nullptr)
+        {
+            LOG_ERROR(FileSystem, "Map view of {0} failed, error code: {1:d}", filePath.Data(), GetLastError());
+            ::CloseHandle(mapping);
+            ::CloseHandle(file);
+            return nullptr;
+        }
+
+        auto handle = MakeUnique<WindowsMappedFileHandle>(file, mapping, static_cast<uint8*>(view), viewOffset, length);
+        if (hint == EMappedAccessHint::WillNeed)
+        {
+            handle->Prefetch(0, length);
+        }
+        return handle;
+    }
+}
+#endif
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "global.hpp"
+#if PLATFORM_WINDOWS
 #include "file_system/platform_file_interface.hpp"
 
 namespace Engine
@@ -34,9 +36,14 @@ namespace Engine
 
         Array<String> QueryFiles(const String& searchPath, const String& regexExpr, bool recursion) final;
 
+        bool IterateDirectory(const String& directory, const DirectoryVisitor& visitor) final;
+
         UniquePtr<IFileHandle> OpenFile(const String& fileName, EFileAccess access, EFileShareMode mode) final;
 
+        UniquePtr<IMappedFileHandle> MapFile(const String& fileName, int64 offset, int64 length, EMappedAccessHint hint) final;
+
     private:
         uint32 GetLastError();
     };
-}
\ No newline at end of file
+}
+#endif
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "global.hpp"
+#if PLATFORM_WINDOWS
 #include "foundation/time.hpp"
 #include "windows/minimal_windows.hpp"
 
@@ -8,14 +9,16 @@ namespace Engine
 {
     constexpr uint64 k_UnixTimeStart = 0x019DB1DED53E8000;
 
-    Timestamp FileTimeToTimestamp(const FILETIME& time)
+    inline Timestamp FileTimeToTimestamp(const FILETIME& time)
     {
         ULARGE_INTEGER li;
         li.LowPart = time.dwLowDateTime;
         li.HighPart = time.dwHighDateTime;
-        uint64 unixTime = (li.QuadPart - k_UnixTimeStart) / 10'000'000;
+        // file time counts 100 nanoseconds, timestamp counts milliseconds
+        uint64 unixTime = (li.QuadPart - k_UnixTimeStart) / 10'000;
 
 
         return Timestamp(Timestamp::Duration(unixTime));
     }
 }
+#endif
@@ -1,30 +1,50 @@
 #include "engine_loop.hpp"
 #include "platform_application.hpp"
 #include "memory/memory.hpp"
+#include "memory/memory_tag.hpp"
+#include "file_system/async_file_io.hpp"
+#include "file_system/content_hash_cache.hpp"
+#include "file_system/file_system.hpp"
+#include "file_system/path.hpp"
 #include "render_module.hpp"
 #include "module/module_manager.hpp"
+#include "profiler/profiler.hpp"
+#include "stats/stats.hpp"
 
 namespace Engine
 {
     void EngineLoop::Init()
     {
-        auto* app = PlatformApplication::CreateApplication();
+        Profiler::SetThreadName("Main");
+        Stats::AddPeriodicExport(EStatExportFormat::Prometheus, Path::Combine(FileSystem::GetEngineSaveDir(), "stats/engine.prom"), 10);
+        {
+            MEMORY_TAG_SCOPE(Application);
+            PlatformApplication::CreateApplication();
+        }
         ModuleManager::Load<RenderModule>("Render");
     }
 
     void EngineLoop::Tick()
     {
+        PROFILE_FRAME();
+        PROFILE_SCOPE("EngineLoop::Tick");
         auto* app = PlatformApplication::GetApplication();
         if (app != nullptr)
         {
+            MEMORY_TAG_SCOPE(Application);
+            PROFILE_SCOPE("Application::Tick");
             app->Tick();
         }
+        Stats::EndFrame();
     }
 
     void EngineLoop::Shutdown()
     {
+        Stats::RemovePeriodicExports();
         ModuleManager::ShutdownModule();
         PlatformApplication::DestroyApplication();
+        FileSystem::GetContentHashCache().Save();
+        AsyncFileIO::Shutdown();
         Memory::Shutdown();
     }
 
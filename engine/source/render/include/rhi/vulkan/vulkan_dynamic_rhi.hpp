@@ -78,7 +78,7 @@ namespace Engine
 
         void CreateGraphicsPipeline();
 
-        VkShaderModule CreateShaderModule(Array64<uint8> code);
+        VkShaderModule CreateShaderModule(const uint8* code, size_t size);
     private:
         VkInstance Instance{ nullptr };
 
@@ -1,15 +1,21 @@
 #include "render_module.hpp"
+#include "memory/memory_tag.hpp"
+#include "profiler/profiler.hpp"
 
 namespace Engine
 {
     void RenderModule::Startup()
     {
+        MEMORY_TAG_SCOPE(Render);
+        PROFILE_SCOPE("RenderModule::Startup");
         RHI = MakeUnique<VulkanDynamicRHI>();
         RHI->Init();
     }
 
     void RenderModule::Shutdown()
     {
+        MEMORY_TAG_SCOPE(Render);
+        PROFILE_SCOPE("RenderModule::Shutdown");
         RHI->Shutdown();
     }
 }
\ No newline at end of file
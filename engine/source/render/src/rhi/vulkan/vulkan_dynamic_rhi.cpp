@@ -14,16 +14,16 @@ static VKAPI_ATTR VkBool32 VKAPI_CALL DebugCallback(
     switch (messageSeverity)
     {
     case VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT:
-        LOG_VERBOSE(RenderModule, pCallbackData->pMessage)
+        LOG_VERBOSE(RenderModule, "{0}", pCallbackData->pMessage)
             break;
     case VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT:
-        LOG_INFO(RenderModule, pCallbackData->pMessage)
+        LOG_INFO(RenderModule, "{0}", pCallbackData->pMessage)
             break;
     case VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT:
-        LOG_WARN(RenderModule, pCallbackData->pMessage)
+        LOG_WARN(RenderModule, "{0}", pCallbackData->pMessage)
             break;
     case VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT:
-        LOG_ERROR(RenderModule, pCallbackData->pMessage)
+        LOG_ERROR(RenderModule, "{0}", pCallbackData->pMessage)
             break;
     default:
         break;
@@ -547,13 +547,16 @@ namespace Engine
 
     void VulkanDynamicRHI::CreateGraphicsPipeline()
     {
-        Array64<uint8> vertShader;
-        Array64<uint8> fragShader;
-        FileSystem::ReadFileToBinary(FileSystem::GetEngineRootPath() / "intermediate/generated/shader/spv/shader.vert.spv", vertShader);
-        FileSystem::ReadFileToBinary(FileSystem::GetEngineRootPath() / "intermediate/generated/shader/spv/shader.frag.spv", fragShader);
+        UniquePtr<IMappedFileHandle> vertShader = FileSystem::MapFile(FileSystem::GetEngineRootPath() / "intermediate/generated/shader/spv/shader.vert.spv");
+        UniquePtr<IMappedFileHandle> fragShader = FileSystem::MapFile(FileSystem::GetEngineRootPath() / "intermediate/generated/shader/spv/shader.frag.spv");
+        if (vertShader == nullptr || fragShader == nullptr)
+        {
+            LOG_ERROR(RenderModule, "Load shader failed");
+            return;
+        }
 
-        VkShaderModule vertShaderModule = CreateShaderModule(vertShader);
-        VkShaderModule fragShaderModule = CreateShaderModule(fragShader);
+        VkShaderModule vertShaderModule = CreateShaderModule(vertShader->GetData(), vertShader->GetSize());
+        VkShaderModule fragShaderModule = CreateShaderModule(fragShader->GetData(), fragShader->GetSize());
 
         VkPipelineShaderStageCreateInfo vertShaderStageInfo = {};
         vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -634,12 +637,13 @@ namespace Engine
         vkDestroyShaderModule(Device, fragShaderModule, nullptr);
     }
 
-    VkShaderModule VulkanDynamicRHI::CreateShaderModule(Array64<uint8> code)
+    VkShaderModule VulkanDynamicRHI::CreateShaderModule(const uint8* code, size_t size)
     {
         VkShaderModuleCreateInfo createInfo = {};
         createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-        createInfo.codeSize = code.Size();
-        createInfo.pCode = reinterpret_cast<const uint32*>(code.Data());
+        createInfo.codeSize = size;
+        // mapped view starts at page boundary, satisfies alignment of spir-v words
+        createInfo.pCode = reinterpret_cast<const uint32*>(code);
 
         VkShaderModule shaderModule;
         if (vkCreateShaderModule(Device, &createInfo, nullptr, &shaderModule) != VK_SUCCESS)
@@ -1,11 +1,15 @@
 #pragma once
 
 #include "thread/thread_pool.hpp"
+#include "memory/object_pool.hpp"
+#include "memory/memory_tag.hpp"
+#include "profiler/profiler.hpp"
 #include "definitions_taskflow.hpp"
 
 namespace Engine
 {
-    class TASKFLOW_API GraphTaskBase : public IWorkThreadTask
+    /** tasks are created and destroyed per execution, allocate them from SmallObjectPool */
+    class TASKFLOW_API GraphTaskBase : public IWorkThreadTask, public PoolNewDeleteObject
     {
     public:
         ~GraphTaskBase() override = default;
@@ -54,6 +58,8 @@ namespace Engine
 
         void Run() override
         {
+            MEMORY_TAG_SCOPE(Taskflow);
+            PROFILE_SCOPE("GraphTask::Run");
             Callable();
 
             for (GraphTaskBase* child : Subsequences)
@@ -74,6 +80,8 @@ namespace Engine
 
         void Run() override
         {
+            MEMORY_TAG_SCOPE(Taskflow);
+            PROFILE_SCOPE("LambdaTask::Run");
             Lambda();
 
             for (GraphTaskBase* child : Subsequences)
@@ -0,0 +1,2 @@
+#include "definitions_taskflow.hpp"
+#include "memory/override_new_delete.hpp"
\ No newline at end of file
@@ -0,0 +1,93 @@
+#include "gtest/gtest.h"
+#include "benchmark_json_reader.hpp"
+
+using namespace Engine;
+
+namespace
+{
+    const char* REPORT_JSON = R"({
+  "context": {
+    "host_name": "host",
+    "build_config": "release"
+  },
+  "benchmarks": [
+    {
+      "name": "BM_Push/64",
+      "run_name": "BM_Push/64",
+      "run_type": "iteration",
+      "real_time": 2.0e+00,
+      "cpu_time": 1.0e+00,
+      "time_unit": "us"
+    },
+    {
+      "name": "BM_Alloc/real_time",
+      "run_name": "BM_Alloc/real_time",
+      "run_type": "iteration",
+      "real_time": 3.0e+00,
+      "cpu_time": 1.0e+00,
+      "time_unit": "ns"
+    },
+    {
+      "name": "BM_Alloc/64/real_time/threads:2",
+      "run_name": "BM_Alloc/64/real_time/threads:2",
+      "run_type": "iteration",
+      "real_time": 5.0e+00,
+      "cpu_time": 9.0e+00,
+      "time_unit": "ns"
+    },
+    {
+      "name": "BM_Alloc/64/real_time/threads:2_median",
+      "run_name": "BM_Alloc/64/real_time/threads:2",
+      "run_type": "aggregate",
+      "aggregate_name": "median",
+      "real_time": 5.0e+00,
+      "cpu_time": 9.0e+00,
+      "time_unit": "ns"
+    },
+    {
+      "name": "BM_Walk/real_time_ish",
+      "run_name": "BM_Walk/real_time_ish",
+      "run_type": "iteration",
+      "real_time": 1.0e+00,
+      "cpu_time": 1.0e+00,
+      "time_unit": "ms"
+    }
+  ]
+})";
+}
+
+TEST(BenchmarkCompare, ReadReport)
+{
+    BenchmarkReport report;
+    BenchmarkJsonReader reader(REPORT_JSON);
+    EXPECT_TRUE(reader.Read(report));
+    EXPECT_EQ(report.HostName, "host");
+    EXPECT_EQ(report.BuildConfig, "release");
+    EXPECT_EQ(report.Benchmarks.Size(), 4);
+
+    const int32* push = report.Indices.Find("BM_Push/64");
+    ASSERT_TRUE(push != nullptr);
+    EXPECT_FALSE(report.Benchmarks[*push].UseRealTime);
+    EXPECT_EQ(report.Benchmarks[*push].RealTimes[0], 2000.0);
+
+    const int32* alloc = report.Indices.Find("BM_Alloc/real_time");
+    ASSERT_TRUE(alloc != nullptr);
+    EXPECT_TRUE(report.Benchmarks[*alloc].UseRealTime);
+
+    const int32* threaded = report.Indices.Find("BM_Alloc/64/real_time/threads:2");
+    ASSERT_TRUE(threaded != nullptr);
+    EXPECT_TRUE(report.Benchmarks[*threaded].UseRealTime);
+    // median aggregate is ignored once repetitions are present
+    EXPECT_EQ(report.Benchmarks[*threaded].RealTimes.Size(), 1);
+
+    const int32* walk = report.Indices.Find("BM_Walk/real_time_ish");
+    ASSERT_TRUE(walk != nullptr);
+    EXPECT_FALSE(report.Benchmarks[*walk].UseRealTime);
+}
+
+TEST(BenchmarkCompare, InvalidJson)
+{
+    BenchmarkReport report;
+    BenchmarkJsonReader reader(R"({"benchmarks": [{"name": "BM_Push")");
+    EXPECT_FALSE(reader.Read(report));
+}
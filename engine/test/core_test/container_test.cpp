@@ -218,6 +218,58 @@ namespace Engine
         }
     }
 
+    TEST(ContainerTest, Array_GrowByMany)
+    {
+        // size already counts new elements when buffer grows, only old elements may be copied from old buffer
+        Array<int32> array = {1, 2, 3};
+        array.Shrink();
+        Array<int32> many(7, 1 << 20);
+        array.Add(many.Data(), many.Size());
+        ASSERT_EQ(array.Size(), 3 + (1 << 20));
+        EXPECT_TRUE(array[0] == 1 && array[1] == 2 && array[2] == 3);
+        EXPECT_EQ(array[3], 7);
+        EXPECT_EQ(array.Last(), 7);
+
+        Array<int32> inserted = {1, 2, 3};
+        inserted.Shrink();
+        inserted.Insert(1, many.Data(), many.Size());
+        ASSERT_EQ(inserted.Size(), 3 + (1 << 20));
+        EXPECT_EQ(inserted[0], 1);
+        EXPECT_EQ(inserted[1], 7);
+        EXPECT_EQ(inserted[(1 << 20) + 1], 2);
+        EXPECT_EQ(inserted.Last(), 3);
+    }
+
+    TEST(ContainerTest, Array_UsableCapacity)
+    {
+        // growth takes the slack malloc rounds blocks up with, Reserve keeps the exact capacity
+        Array<uint8> array;
+        array.Reserve(3);
+        EXPECT_EQ(array.Capacity(), 3);
+
+        int32 reallocations = 0;
+        const uint8* data = array.Data();
+        for (int32 i = 0; i < 1000; ++i)
+        {
+            array.Add(static_cast<uint8>(i));
+            if (array.Data() != data)
+            {
+                data = array.Data();
+                ++reallocations;
+                const size_t usableSize = Memory::GetAllocationSize(array.Data());
+                if (usableSize > 0)
+                {
+                    EXPECT_EQ(static_cast<size_t>(array.Capacity()), usableSize);
+                }
+            }
+        }
+        EXPECT_TRUE(reallocations < 1000);
+        for (int32 i = 0; i < 1000; ++i)
+        {
+            EXPECT_EQ(array[i], static_cast<uint8>(i));
+        }
+    }
+
     TEST(ContainerTest, Array_Find)
     {
         Array<NonTrivialArrayItem> array = {NonTrivialArrayItem(0), NonTrivialArrayItem(1), NonTrivialArrayItem(2), NonTrivialArrayItem(0)};
@@ -307,6 +359,18 @@ namespace Engine
         EXPECT_TRUE(array.Capacity() == 3);
     }
 
+    TEST(ContainerTest, Array_CopyEmpty)
+    {
+        Array<NonTrivialArrayItem> empty;
+        Array<NonTrivialArrayItem> copied(empty);
+        EXPECT_TRUE(copied.Empty());
+
+        Array<NonTrivialArrayItem> assigned;
+        assigned.Resize(2);
+        assigned = empty;
+        EXPECT_TRUE(assigned.Empty());
+    }
+
     TEST(ContainerTest, Array_Iterator)
     {
         Array<int32> array = {0, 1, 2, 3, 4, 5};
@@ -417,6 +481,53 @@ namespace Engine
             EXPECT_TRUE(*it);
             EXPECT_TRUE(it.GetIndex() % 2 == 0);
         }
+
+        // const iterator starts at the index asked for, SparseArray builds its end from it
+        const BitArray<>& constArray = array;
+        EXPECT_EQ(constArray.CreateValidIterator(1).GetIndex(), 2);
+        EXPECT_FALSE((bool)constArray.CreateValidIterator(constArray.Size()));
+
+        const SparseArray<int32> sparse = { 1, 2, 3 };
+        int32 count = 0;
+        for (int32 value : sparse)
+        {
+            EXPECT_EQ(value, ++count);
+        }
+        EXPECT_EQ(count, 3);
+    }
+
+    TEST(ContainerTest, BitArray_Grow)
+    {
+        // growing copies old elements, not size in bytes, which would run past both buffers
+        BitArray array;
+        Array<void*> neighbours;
+        for (int32 index = 0; index < 4096; ++index)
+        {
+            array.Add(index % 3 == 0);
+            if (index % 64 == 0)
+            {
+                neighbours.Add(Memory::Malloc(16));
+            }
+        }
+        EXPECT_EQ(array.Size(), 4096);
+        for (int32 index = 0; index < 4096; ++index)
+        {
+            ASSERT_EQ(array[index], index % 3 == 0);
+        }
+        for (void* ptr : neighbours)
+        {
+            Memory::Free(ptr);
+        }
+
+        Set<int32> set;
+        for (int32 index = 0; index < 1000; ++index)
+        {
+            set.Add(index);
+        }
+        set.Remove(500);
+        EXPECT_EQ(set.Size(), 999);
+        EXPECT_FALSE(set.Contains(500));
+        EXPECT_TRUE(set.Contains(999));
     }
 
     TEST(ContainerTest, SparseArray_Ctor)
@@ -515,6 +626,18 @@ namespace Engine
            ++count;
         }
         EXPECT_TRUE(count == 3);
+
+        // const iterator points into the set itself, not into a copy of its elements
+        const Set<NonTrivialArrayItem>& constSet = set;
+        count = 0;
+        for (auto it = constSet.begin(); it != constSet.end(); ++it)
+        {
+            EXPECT_EQ(it.operator->(), &*it);
+            EXPECT_TRUE(constSet.Contains(*it));
+            EXPECT_EQ(constSet.Find(*it), &*it);
+            ++count;
+        }
+        EXPECT_EQ(count, 3);
     }
 
     TEST(ContainerTest, Map_Ctor)
@@ -577,5 +700,15 @@ namespace Engine
         {
             EXPECT_TRUE(it->Key == it->Value);
         }
+
+        // const end is past the last pair, not begin
+        const Map<int32, NonTrivialArrayItem>& constMap = map;
+        int32 count = 0;
+        for (auto&& pair : constMap)
+        {
+            EXPECT_TRUE(pair.Key == pair.Value);
+            ++count;
+        }
+        EXPECT_EQ(count, 3);
     }
 }
\ No newline at end of file
@@ -0,0 +1,786 @@
+#include "gtest/gtest.h"
+#include "core_minimal_public.hpp"
+#include "file_system/path.hpp"
+#include "file_system/file_system.hpp"
+#include "file_system/async_file_io.hpp"
+#include "file_system/content_hash_cache.hpp"
+#include "file_system/file_stream.hpp"
+#include "file_system/file_watcher.hpp"
+#include "file_system/pak_file.hpp"
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+namespace Engine
+{
+    static String MakeTestFile(const String& name, int32 size)
+    {
+        String dir = FileSystem::GetEngineSaveDir() / "test";
+        FileSystem::MakeDirTree(dir);
+        String path = dir / name;
+        std::ofstream stream(path.Data(), std::ios::binary | std::ios::trunc);
+        for (int32 index = 0; index < size; ++index)
+        {
+            stream.put(static_cast<char>(index % 251));
+        }
+        return path;
+    }
+
+    TEST(FileSystem, MapFile)
+    {
+        String path = MakeTestFile("map_file.bin", 100000);
+
+        UniquePtr<IMappedFileHandle> whole = FileSystem::MapFile(path);
+        ASSERT_TRUE(whole != nullptr);
+        EXPECT_EQ(whole->GetSize(), 100000);
+        EXPECT_EQ(whole->GetData()[0], 0);
+        EXPECT_EQ(whole->GetData()[99999], 99999 % 251);
+
+        UniquePtr<IMappedFileHandle> region = FileSystem::MapFile(path, 70001, 100, EMappedAccessHint::WillNeed);
+        ASSERT_TRUE(region != nullptr);
+        EXPECT_EQ(region->GetSize(), 100);
+        EXPECT_EQ(region->GetData()[0], 70001 % 251);
+        region->Advise(EMappedAccessHint::Random);
+        region->Prefetch(50);
+
+        UniquePtr<IMappedFileHandle> tail = FileSystem::MapFile(path, 100000);
+        ASSERT_TRUE(tail != nullptr);
+        EXPECT_EQ(tail->GetSize(), 0);
+
+        EXPECT_TRUE(FileSystem::MapFile(path, 100001) == nullptr);
+
+        whole.reset();
+        region.reset();
+        tail.reset();
+        FileSystem::RemoveFile(path);
+    }
+
+    TEST(FileSystem, FileHandle)
+    {
+        String path = MakeTestFile("file_handle.bin", 0);
+        uint8 data[256];
+        for (int32 index = 0; index < 256; ++index)
+        {
+            data[index] = static_cast<uint8>(index);
+        }
+
+        {
+            UniquePtr<IFileHandle> writer = FileSystem::OpenFile(path, EFileAccess::Write);
+            ASSERT_TRUE(writer != nullptr);
+            EXPECT_TRUE(writer->Write(data, 100));
+            EXPECT_EQ(writer->Tell(), 100);
+            EXPECT_EQ(writer->WriteAt(data + 200, 56, 200), 56);
+
+            FileWriteVector vectors[] = { { data + 100, 50 }, { data + 150, 50 } };
+            EXPECT_EQ(writer->WriteV(vectors, 2, 100), 100);
+            EXPECT_EQ(writer->GetSize(), 256);
+            EXPECT_EQ(writer->Tell(), 100);
+            EXPECT_TRUE(writer->Flush());
+        }
+
+        {
+            UniquePtr<IFileHandle> reader = FileSystem::OpenFile(path, EFileAccess::Read);
+            ASSERT_TRUE(reader != nullptr);
+            uint8 buffer[256] = {};
+            EXPECT_TRUE(reader->Seek(-56, ESeekOrigin::End));
+            EXPECT_EQ(reader->Tell(), 200);
+            EXPECT_TRUE(reader->Read(buffer, 56));
+            EXPECT_EQ(buffer[0], 200);
+            EXPECT_FALSE(reader->Read(buffer, 1));
+            EXPECT_FALSE(reader->Seek(-1, ESeekOrigin::Begin));
+
+            EXPECT_EQ(reader->ReadAt(buffer, 10, 250), 6);
+            EXPECT_EQ(buffer[0], 250);
+
+            FileReadVector vectors[] = { { buffer, 3 }, { buffer + 3, 200 } };
+            EXPECT_EQ(reader->ReadV(vectors, 2, 100), 156);
+            EXPECT_EQ(buffer[3], 103);
+            EXPECT_EQ(buffer[155], 255);
+            EXPECT_EQ(reader->Tell(), 256);
+
+            std::atomic<int32> mismatchCount{ 0 };
+            Array<std::thread> workers;
+            for (int32 worker = 0; worker < 4; ++worker)
+            {
+                workers.Add(std::thread([&reader, &mismatchCount, worker]() {
+                    for (int32 round = 0; round < 100; ++round)
+                    {
+                        const int64 offset = (worker * 61 + round * 7) % 256;
+                        uint8 value = 0;
+                        if (reader->ReadAt(&value, 1, offset) != 1 || value != offset)
+                        {
+                            ++mismatchCount;
+                        }
+                    }
+                }));
+            }
+            for (std::thread& worker : workers)
+            {
+                worker.join();
+            }
+            EXPECT_EQ(mismatchCount, 0);
+        }
+
+        {
+            UniquePtr<IFileHandle> editor = FileSystem::OpenFile(path, EFileAccess::ReadWrite);
+            ASSERT_TRUE(editor != nullptr);
+            EXPECT_TRUE(editor->Truncate(128));
+            EXPECT_EQ(editor->GetSize(), 128);
+            EXPECT_EQ(editor->Tell(), 0);
+        }
+
+        EXPECT_EQ(FileSystem::OpenFile(path / "missing", EFileAccess::Read), nullptr);
+        FileSystem::RemoveFile(path);
+    }
+
+    class AsyncReadCounter
+    {
+    public:
+        void OnCompleted(AsyncReadRequest& request)
+        {
+            ++Count;
+        }
+
+        std::atomic<int32> Count{ 0 };
+    };
+
+    class AsyncFollowUpReader
+    {
+    public:
+        void OnCompleted(AsyncReadRequest& request)
+        {
+            FollowUp = AsyncFileIO::Read(request.GetFile(), 0, 10);
+        }
+
+        AsyncReadRequestPtr FollowUp;
+    };
+
+    static void TestAsyncRead(bool allowNativeBackend)
+    {
+        AsyncFileIO::Initialize(allowNativeBackend, 2);
+        String path = MakeTestFile("async_read.bin", 100000);
+        SharedPtr<AsyncReadFile> file = AsyncFileIO::OpenFile(path);
+        ASSERT_TRUE(file != nullptr);
+        EXPECT_EQ(file->GetSize(), 100000);
+
+        AsyncReadCounter counter;
+        Array<AsyncReadRequestPtr> requests;
+        for (int32 index = 0; index < 100; ++index)
+        {
+            auto request = MakeShared<AsyncReadRequest>(file, index * 1000, 1000, static_cast<EAsyncIOPriority>(index % 4));
+            request->OnCompleted.BindRaw(&counter, &AsyncReadCounter::OnCompleted);
+            requests.Add(request);
+        }
+        AsyncFileIO::Submit(requests);
+
+        for (int32 index = 0; index < requests.Size(); ++index)
+        {
+            requests[index]->Wait();
+            EXPECT_EQ(requests[index]->GetStatus(), EAsyncIOStatus::Completed);
+            EXPECT_EQ(requests[index]->GetBytesRead(), 1000);
+            EXPECT_EQ(requests[index]->GetData()[999], (index * 1000 + 999) % 251);
+        }
+        EXPECT_EQ(counter.Count, 100);
+
+        AsyncReadRequestPtr tail = AsyncFileIO::Read(file, 99990, -1, EAsyncIOPriority::Critical);
+        tail->Wait();
+        EXPECT_EQ(tail->GetBytesRead(), 10);
+        EXPECT_EQ(tail->GetData()[0], 99990 % 251);
+
+        auto cancelled = MakeShared<AsyncReadRequest>(file, 0, 100);
+        EXPECT_TRUE(cancelled->Cancel());
+        EXPECT_FALSE(cancelled->Cancel());
+        AsyncFileIO::Submit(cancelled);
+        cancelled->Wait();
+        EXPECT_EQ(cancelled->GetStatus(), EAsyncIOStatus::Cancelled);
+        EXPECT_FALSE(tail->Cancel());
+
+        // completion of an empty read submits a follow-up read, backend must not finish it under its lock
+        AsyncFollowUpReader followUpReader;
+        auto empty = MakeShared<AsyncReadRequest>(file, 0, 0);
+        empty->OnCompleted.BindRaw(&followUpReader, &AsyncFollowUpReader::OnCompleted);
+        AsyncFileIO::Submit(empty);
+        empty->Wait();
+        ASSERT_TRUE(followUpReader.FollowUp != nullptr);
+        followUpReader.FollowUp->Wait();
+        EXPECT_EQ(followUpReader.FollowUp->GetBytesRead(), 10);
+
+        AsyncFileIO::Shutdown();
+        requests.Clear();
+        tail.reset();
+        cancelled.reset();
+        file.reset();
+        FileSystem::RemoveFile(path);
+    }
+
+    TEST(FileSystem, AsyncRead)
+    {
+        TestAsyncRead(true);
+        TestAsyncRead(false);
+    }
+
+    static void TestFileStream(bool readAhead)
+    {
+        String path = MakeTestFile("file_stream.bin", 0);
+        {
+            FileWriter writer(path, 64);
+            ASSERT_TRUE(writer.IsValid());
+            writer.SetEndian(EEndian::Big);
+            for (uint32 index = 0; index < 10000; ++index)
+            {
+                EXPECT_TRUE(writer.Write(index));
+            }
+            writer.SetEndian(EEndian::Little);
+            EXPECT_TRUE(writer.Write(static_cast<uint16>(0x1234)));
+            EXPECT_TRUE(writer.Write(1.5));
+            EXPECT_EQ(writer.Tell(), 40010);
+            EXPECT_TRUE(writer.Flush(true));
+        }
+        {
+            FileWriter appender(path, 64, true);
+            uint8 tail[100] = {};
+            EXPECT_TRUE(appender.Write(tail, 100));
+            EXPECT_EQ(appender.Tell(), 40110);
+        }
+
+        FileReader reader(path, 1000, readAhead);
+        ASSERT_TRUE(reader.IsValid());
+        EXPECT_EQ(reader.GetSize(), 40110);
+
+        uint8 first[4];
+        EXPECT_EQ(reader.Read(first, 4), 4);
+        EXPECT_EQ(first[3], 0);
+        reader.SetEndian(EEndian::Big);
+        for (uint32 index = 1; index < 10000; ++index)
+        {
+            uint32 value = 0;
+            ASSERT_TRUE(reader.Read(value));
+            ASSERT_EQ(value, index);
+        }
+
+        reader.SetEndian(EEndian::Little);
+        uint16 half = 0;
+        double real = 0;
+        EXPECT_TRUE(reader.Read(half));
+        EXPECT_TRUE(reader.Read(real));
+        EXPECT_EQ(half, 0x1234);
+        EXPECT_EQ(real, 1.5);
+
+        EXPECT_TRUE(reader.Seek(4 * 5000));
+        reader.SetEndian(EEndian::Big);
+        uint32 value = 0;
+        EXPECT_TRUE(reader.Read(value));
+        EXPECT_EQ(value, 5000);
+        EXPECT_TRUE(reader.Skip(-8));
+        EXPECT_TRUE(reader.Read(value));
+        EXPECT_EQ(value, 4999);
+
+        EXPECT_TRUE(reader.Seek(40100));
+        uint8 rest[20];
+        EXPECT_EQ(reader.Read(rest, 20), 10);
+        EXPECT_TRUE(reader.IsEof());
+        EXPECT_FALSE(reader.HasError());
+    }
+
+    TEST(FileSystem, FileStream)
+    {
+        TestFileStream(true);
+        TestFileStream(false);
+        FileSystem::RemoveFile(FileSystem::GetEngineSaveDir() / "test" / "file_stream.bin");
+    }
+
+    TEST(FileSystem, Pak)
+    {
+        // compressible text, noise which is stored as is, and data crossing many blocks
+        Array<uint8> text;
+        Array<uint8> noise;
+        uint32 seed = 12345;
+        for (int32 index = 0; index < 50000; ++index)
+        {
+            text.Add(static_cast<uint8>("polaris engine pak "[index % 19] + index / 5000));
+            seed = seed * 1664525 + 1013904223;
+            noise.Add(static_cast<uint8>(seed >> 24));
+        }
+
+        Array<uint8> compressed;
+        compressed.Resize(static_cast<int32>(Compression::GetMaxCompressedSize(ECompressionMethod::LZ4, text.Size())));
+        const int64 compressedSize = Compression::Compress(ECompressionMethod::LZ4, compressed.Data(), compressed.Size(), text.Data(), text.Size());
+        ASSERT_GT(compressedSize, 0);
+        EXPECT_LT(compressedSize, text.Size() / 4);
+        Array<uint8> decompressed;
+        decompressed.Resize(text.Size());
+        EXPECT_TRUE(Compression::Decompress(ECompressionMethod::LZ4, decompressed.Data(), decompressed.Size(), compressed.Data(), compressedSize));
+        EXPECT_TRUE(decompressed == text);
+        EXPECT_FALSE(Compression::Decompress(ECompressionMethod::LZ4, decompressed.Data(), decompressed.Size() - 1, compressed.Data(), compressedSize));
+        EXPECT_FALSE(Compression::Decompress(ECompressionMethod::LZ4, decompressed.Data(), decompressed.Size(), compressed.Data(), compressedSize / 2));
+
+        String dir = FileSystem::GetEngineSaveDir() / "test";
+        String pakPath = dir / "test.pak";
+        String noisePath = MakeTestFile("pak_source.bin", 0);
+        {
+            std::ofstream stream(noisePath.Data(), std::ios::binary | std::ios::trunc);
+            stream.write(reinterpret_cast<const char*>(noise.Data()), noise.Size());
+        }
+        {
+            PakWriter writer(pakPath, ECompressionMethod::LZ4, 4096, 64);
+            ASSERT_TRUE(writer.IsValid());
+            EXPECT_TRUE(writer.AddFile("text/readme.txt", text.Data(), text.Size()));
+            EXPECT_TRUE(writer.AddFile("data\\noise.bin", noisePath));
+            EXPECT_TRUE(writer.AddFile("/data/deep/empty.bin", nullptr, 0));
+            EXPECT_FALSE(writer.AddFile("TEXT/README.TXT", text.Data(), text.Size()));
+            EXPECT_TRUE(writer.Finalize());
+            EXPECT_EQ(writer.GetEntryNum(), 3);
+            EXPECT_LT(writer.GetCompressedSize(), writer.GetUncompressedSize());
+        }
+
+        SharedPtr<PakFile> pak = PakFile::Load(FileSystem::OpenFile(pakPath, EFileAccess::Read));
+        ASSERT_TRUE(pak != nullptr);
+        EXPECT_EQ(pak->GetEntryNum(), 3);
+        const PakEntry* noiseEntry = pak->FindEntry("Data/Noise.bin");
+        ASSERT_TRUE(noiseEntry != nullptr);
+        EXPECT_EQ(pak->GetEntryPath(*noiseEntry), "data/noise.bin");
+        EXPECT_EQ(pak->GetBlock(*noiseEntry, 0).Offset % 64, 0);
+        EXPECT_GE(pak->GetMappableOffset(*noiseEntry), 0);
+        EXPECT_TRUE(pak->FindEntry("data/missing.bin") == nullptr);
+        EXPECT_TRUE(PakFile::Load(FileSystem::OpenFile(noisePath, EFileAccess::Read)) == nullptr);
+
+        String mountPoint = dir / "mounted";
+        ASSERT_TRUE(FileSystem::MountPak(pakPath, mountPoint));
+        EXPECT_TRUE(FileSystem::FileExists(mountPoint / "text/readme.txt"));
+        EXPECT_TRUE(FileSystem::FileExists(mountPoint / "data/deep/empty.bin"));
+        EXPECT_FALSE(FileSystem::FileExists(mountPoint / "text"));
+        EXPECT_TRUE(FileSystem::DirExists(mountPoint));
+        EXPECT_TRUE(FileSystem::DirExists(mountPoint / "data/deep"));
+        EXPECT_FALSE(FileSystem::DirExists(mountPoint / "data/readme.txt"));
+        EXPECT_TRUE(FileSystem::FileExists(noisePath));
+
+        UniquePtr<IFileHandle> handle = FileSystem::OpenFile(mountPoint / "text/readme.txt", EFileAccess::Read);
+        ASSERT_TRUE(handle != nullptr);
+        EXPECT_EQ(handle->GetSize(), text.Size());
+        Array<uint8> buffer;
+        buffer.Resize(text.Size());
+        for (int32 offset = 0; offset < text.Size(); offset += 1000)
+        {
+            EXPECT_TRUE(handle->Read(buffer.Data() + offset, Math::Min(1000, text.Size() - offset)));
+        }
+        EXPECT_TRUE(buffer == text);
+        EXPECT_FALSE(handle->Read(buffer.Data(), 1));
+        EXPECT_TRUE(handle->Seek(-10, ESeekOrigin::End));
+        EXPECT_FALSE(handle->Read(buffer.Data(), 20));
+        EXPECT_EQ(handle->ReadAt(buffer.Data(), 5000, 10000), 5000);
+        EXPECT_EQ(std::memcmp(buffer.Data(), text.Data() + 10000, 5000), 0);
+        EXPECT_FALSE(handle->Write(text.Data(), 1));
+        EXPECT_TRUE(FileSystem::OpenFile(mountPoint / "text/readme.txt", EFileAccess::Write) == nullptr);
+
+        UniquePtr<IMappedFileHandle> textView = FileSystem::MapFile(mountPoint / "text/readme.txt", 100, 4000);
+        ASSERT_TRUE(textView != nullptr);
+        EXPECT_EQ(textView->GetSize(), 4000);
+        EXPECT_EQ(std::memcmp(textView->GetData(), text.Data() + 100, 4000), 0);
+        UniquePtr<IMappedFileHandle> noiseView = FileSystem::MapFile(mountPoint / "data/noise.bin", 5000);
+        ASSERT_TRUE(noiseView != nullptr);
+        EXPECT_EQ(noiseView->GetSize(), noise.Size() - 5000);
+        EXPECT_EQ(std::memcmp(noiseView->GetData(), noise.Data() + 5000, noise.Size() - 5000), 0);
+
+        Array<String> files = FileSystem::QueryFiles(mountPoint, ".*", true);
+        EXPECT_EQ(files.Size(), 6);
+        EXPECT_EQ(FileSystem::QueryFiles(mountPoint / "data", ".*\\.bin", false).Size(), 1);
+        EXPECT_EQ(FileSystem::WalkDirectory(mountPoint, FileMatcher("*.bin"), [](const DirectoryEntry&) { return true; }), 2);
+        EXPECT_EQ(FileSystem::WalkDirectory(mountPoint, FileMatcher(), [](const DirectoryEntry&) { return true; }, true, true), 6);
+
+        String copyPath = dir / "pak_copy.bin";
+        FileSystem::RemoveFile(copyPath);
+        EXPECT_TRUE(FileSystem::CopyFile(mountPoint / "data/noise.bin", copyPath));
+        Array64<uint8> copied;
+        FileSystem::ReadFileToBinary(copyPath, copied);
+        ASSERT_EQ(copied.Size(), noise.Size());
+        EXPECT_EQ(std::memcmp(copied.Data(), noise.Data(), noise.Size()), 0);
+
+        EXPECT_TRUE(FileSystem::UnmountPak(pakPath));
+        EXPECT_FALSE(FileSystem::FileExists(mountPoint / "text/readme.txt"));
+        // opened files are still readable after unmount
+        EXPECT_EQ(handle->ReadAt(buffer.Data(), 10, 0), 10);
+
+        handle.reset();
+        textView.reset();
+        noiseView.reset();
+        pak.reset();
+        FileSystem::RemoveFile(copyPath);
+        FileSystem::RemoveFile(noisePath);
+        FileSystem::RemoveFile(pakPath);
+    }
+
+    TEST(FileSystem, EntryTime)
+    {
+        String path = MakeTestFile("entry_time.bin", 16);
+        const String directory = path.Slices(0, path.LastIndexOf('/'));
+
+        DirectoryEntry found;
+        for (const DirectoryEntry& entry : FileSystem::DirectoryIterator(directory))
+        {
+            if (entry.GetPath().EndsWith("entry_time.bin"))
+            {
+                found = entry;
+            }
+        }
+        ASSERT_TRUE(found.GetStat().IsValid);
+
+        // entry times are milliseconds on every platform, file time keeps seconds
+        const int64 writeTime = found.GetStat().LastWriteTime.ToTimePoint().time_since_epoch().count();
+        const int64 now = PlatformClock::Now().ToTimePoint().time_since_epoch().count();
+        EXPECT_LT(std::abs(writeTime - now), 5000);
+        EXPECT_EQ(writeTime / 1000, static_cast<int64>(FileSystem::GetFileTime(path).LastModifyTime));
+
+        FileSystem::RemoveFile(path);
+    }
+
+    static void SetModifyTime(const String& path, std::chrono::seconds offset)
+    {
+        std::filesystem::last_write_time(path.Data(), std::filesystem::file_time_type::clock::now() + offset);
+    }
+
+    TEST(FileSystem, ContentHashCache)
+    {
+        String path = MakeTestFile("content_hash.bin", (3 << 20) + 7);
+        String cachePath = FileSystem::GetEngineSaveDir() / "test" / "content_hash_cache.bin";
+        FileSystem::RemoveFile(cachePath);
+        SetModifyTime(path, std::chrono::seconds(-20));
+
+        ContentHash hash;
+        ContentHash directHash;
+        {
+            ContentHashCache cache(cachePath);
+            EXPECT_FALSE(cache.IsUnchanged(path));
+            ASSERT_TRUE(cache.GetHash(path, hash));
+            ASSERT_TRUE(ContentHashCache::HashFile(path, directHash));
+            EXPECT_TRUE(hash == directHash);
+            EXPECT_TRUE(cache.IsUnchanged(path));
+
+            Array<uint8> artifact;
+            artifact.Add(reinterpret_cast<const uint8*>("compiled"), 8);
+            EXPECT_FALSE(cache.SetArtifact(path, ContentHash{ hash.Low + 1, hash.High }, "shader", Array<uint8>(artifact)));
+            EXPECT_TRUE(cache.SetArtifact(path, hash, "shader", Array<uint8>(artifact)));
+            EXPECT_TRUE(cache.Save());
+        }
+
+        {
+            // records come back from disk, file isn't read again
+            ContentHashCache cache(cachePath);
+            EXPECT_EQ(cache.GetRecordNum(), 1);
+            EXPECT_TRUE(cache.IsUnchanged(path));
+            ContentHash cachedHash;
+            EXPECT_TRUE(cache.GetHash(path, cachedHash));
+            EXPECT_TRUE(cachedHash == hash);
+            Array<uint8> artifact;
+            EXPECT_TRUE(cache.FindArtifact(path, "shader", artifact));
+            EXPECT_EQ(artifact.Size(), 8);
+            EXPECT_FALSE(cache.FindArtifact(path, "mesh", artifact));
+
+            // same size but different content and modify time
+            {
+                std::fstream stream(path.Data(), std::ios::binary | std::ios::in | std::ios::out);
+                stream.seekp(1 << 20);
+                stream.put('x');
+            }
+            SetModifyTime(path, std::chrono::seconds(-10));
+            EXPECT_FALSE(cache.IsUnchanged(path));
+            EXPECT_FALSE(cache.FindArtifact(path, "shader", artifact));
+            ContentHash newHash;
+            EXPECT_TRUE(cache.GetHash(path, newHash));
+            EXPECT_TRUE(newHash != hash);
+            EXPECT_TRUE(cache.IsUnchanged(path));
+
+            // modified within file system granularity before it's hashed, or later, can't be trusted
+            SetModifyTime(path, std::chrono::seconds(-1));
+            EXPECT_TRUE(cache.GetHash(path, newHash));
+            EXPECT_FALSE(cache.IsUnchanged(path));
+            SetModifyTime(path, std::chrono::seconds(3600));
+            EXPECT_TRUE(cache.GetHash(path, newHash));
+            EXPECT_FALSE(cache.IsUnchanged(path));
+
+            SetModifyTime(path, std::chrono::seconds(-10));
+            EXPECT_TRUE(cache.GetHash(path, newHash));
+            EXPECT_TRUE(cache.IsUnchanged(path));
+        }
+
+        {
+            // unsaved records are written when cache is destroyed
+            ContentHashCache cache(cachePath);
+            EXPECT_EQ(cache.GetRecordNum(), 1);
+            EXPECT_TRUE(cache.IsUnchanged(path));
+            ContentHash newHash;
+
+            cache.Remove(path);
+            EXPECT_EQ(cache.GetRecordNum(), 0);
+            EXPECT_FALSE(cache.GetHash(path / "missing", newHash));
+        }
+
+        {
+            std::ofstream stream(cachePath.Data(), std::ios::binary | std::ios::trunc);
+            stream << "broken cache";
+        }
+        ContentHashCache brokenCache(cachePath);
+        EXPECT_EQ(brokenCache.GetRecordNum(), 0);
+
+        FileSystem::RemoveFile(path);
+        FileSystem::RemoveFile(cachePath);
+    }
+
+    TEST(FileSystem, WalkDirectory)
+    {
+        FileMatcher matcher("*.png; *.TGA ;a/**/*.txt;[a-c]?.bin");
+        EXPECT_TRUE(matcher.Match("icon.png"));
+        EXPECT_FALSE(matcher.Match("icon.tga"));
+        EXPECT_TRUE(matcher.Match("b1.bin"));
+        EXPECT_FALSE(matcher.Match("d1.bin"));
+        EXPECT_FALSE(matcher.Match("b12.bin"));
+        EXPECT_TRUE(matcher.Match("c.txt", "a/c.txt"));
+        EXPECT_TRUE(matcher.Match("c.txt", "a/b/c/c.txt"));
+        EXPECT_FALSE(matcher.Match("c.txt", "b/c.txt"));
+        EXPECT_TRUE(FileMatcher("*.TGA", CaseInsensitive).Match("icon.tga"));
+        EXPECT_TRUE(FileMatcher("a/*.txt").Match("c.txt", "a/c.txt"));
+        EXPECT_FALSE(FileMatcher("a/*.txt").Match("c.txt", "a/b/c.txt"));
+        EXPECT_TRUE(FileMatcher("[!a]*").Match("bat"));
+        EXPECT_TRUE(FileMatcher("*;*.png").IsMatchAll());
+
+        String root = FileSystem::GetEngineSaveDir() / "test/walk";
+        FileSystem::ClearDir(root);
+        ASSERT_TRUE(FileSystem::MakeDirTree(root / "a/b/c"));
+        const char* files[] = { "root.png", "a/one.txt", "a/two.tga", "a/b/three.txt", "a/b/c/four.png", "a/b/c/b1.bin" };
+        for (const char* file : files)
+        {
+            ASSERT_TRUE(FileSystem::MakeFile(root / file));
+        }
+        for (int32 index = 0; index < 20; ++index)
+        {
+            String dir = root / String::Format("wide{0}", index);
+            ASSERT_TRUE(FileSystem::MakeDir(dir));
+            ASSERT_TRUE(FileSystem::MakeFile(dir / "data.png"));
+        }
+
+        std::atomic<int32> visited{ 0 };
+        auto counter = [&visited](const DirectoryEntry& entry) {
+            EXPECT_FALSE(entry.IsDirectory());
+            ++visited;
+            return true;
+        };
+        EXPECT_EQ(FileSystem::WalkDirectory(root, FileMatcher(), counter), 26);
+        EXPECT_EQ(visited.load(), 26);
+        EXPECT_EQ(FileSystem::WalkDirectory(root, matcher, counter), 25);
+        EXPECT_EQ(FileSystem::WalkDirectory(root, FileMatcher("*.png"), counter, false), 1);
+        EXPECT_EQ(FileSystem::WalkDirectory(root, FileMatcher("a/**"), counter), 5);
+        EXPECT_EQ(FileSystem::WalkDirectory(root / "missing", FileMatcher(), counter), 0);
+
+        std::atomic<int32> dirNum{ 0 };
+        EXPECT_EQ(FileSystem::WalkDirectory(root, FileMatcher(), [&dirNum](const DirectoryEntry& entry) {
+            dirNum += entry.IsDirectory() ? 1 : 0;
+            return true;
+        }, true, true), 49);
+        EXPECT_EQ(dirNum.load(), 23);
+
+        // stopped walk visits no more entries once visitor returns false
+        std::atomic<int32> stopNum{ 0 };
+        FileSystem::WalkDirectory(root, FileMatcher(), [&stopNum](const DirectoryEntry&) {
+            return ++stopNum < 3;
+        });
+        EXPECT_GE(stopNum.load(), 3);
+        EXPECT_LT(stopNum.load(), 26);
+
+        // walks running at the same time share pool workers, each one still sees whole tree
+        Array<std::thread> walkers;
+        std::atomic<int32> completeNum{ 0 };
+        for (int32 index = 0; index < 4; ++index)
+        {
+            walkers.Add(std::thread([&root, &completeNum]() {
+                for (int32 round = 0; round < 10; ++round)
+                {
+                    const int64 num = FileSystem::WalkDirectory(root, FileMatcher(), [](const DirectoryEntry&) { return true; });
+                    completeNum += num == 26 ? 1 : 0;
+                }
+            }));
+        }
+        for (std::thread& walker : walkers)
+        {
+            walker.join();
+        }
+        EXPECT_EQ(completeNum.load(), 40);
+
+#if PLATFORM_LINUX
+        // link back to an ancestor is reported as an entry but never descended into
+        std::filesystem::create_directory_symlink(root.Data(), (root / "a/b/loop").Data());
+        EXPECT_EQ(FileSystem::WalkDirectory(root, FileMatcher(), [](const DirectoryEntry& entry) {
+            EXPECT_FALSE(entry.IsDirectory());
+            return true;
+        }), 27);
+        FileSystem::RemoveFile(root / "a/b/loop");
+#endif
+
+        FileSystem::ClearDir(root);
+        FileSystem::RemoveDir(root);
+    }
+
+#if PLATFORM_LINUX
+    TEST(FileSystem, SymlinkLoop)
+    {
+        String root = FileSystem::GetEngineSaveDir() / "test/link";
+        FileSystem::ClearDir(root);
+        ASSERT_TRUE(FileSystem::MakeDirTree(root / "a/b"));
+        ASSERT_TRUE(FileSystem::MakeFile(root / "a/b/data.txt"));
+        // link back to an ancestor, recursive queries must report it without descending
+        std::filesystem::create_directory_symlink(root.Data(), (root / "a/b/loop").Data());
+
+        Array<String> files = FileSystem::QueryFiles(root, ".*", true);
+        EXPECT_EQ(files.Size(), 4);
+
+        int32 entryNum = 0;
+        for (const DirectoryEntry& entry : FileSystem::DirectoryIterator(root, true))
+        {
+            if (entry.GetPath().EndsWith("loop"))
+            {
+                EXPECT_FALSE(entry.IsDirectory());
+            }
+            ASSERT_LT(++entryNum, 100);
+        }
+        EXPECT_EQ(entryNum, 4);
+
+        EXPECT_TRUE(FileSystem::ClearDir(root));
+        EXPECT_FALSE(FileSystem::FileExists(root / "a/b/data.txt"));
+        FileSystem::RemoveDir(root);
+    }
+#endif
+
+    struct FileChangeCollector
+    {
+        void OnChanged(const Array<FileChange>& changes)
+        {
+            std::scoped_lock lock(Mutex);
+            ++BatchNum;
+            for (const FileChange& change : changes)
+            {
+                Changes.Add(change);
+            }
+        }
+
+        /** pump deferred batches until at least count changes arrived */
+        bool WaitChanges(FileWatcher& watcher, int32 count)
+        {
+            for (int32 retry = 0; retry < 500; ++retry)
+            {
+                watcher.DispatchEvents();
+                {
+                    std::scoped_lock lock(Mutex);
+                    if (Changes.Size() >= count)
+                    {
+                        return true;
+                    }
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+            return false;
+        }
+
+        const FileChange* Find(const String& path)
+        {
+            std::scoped_lock lock(Mutex);
+            for (const FileChange& change : Changes)
+            {
+                if (change.Path == path)
+                {
+                    return &change;
+                }
+            }
+            return nullptr;
+        }
+
+        std::mutex Mutex;
+        Array<FileChange> Changes;
+        int32 BatchNum{ 0 };
+    };
+
+    static void AppendToFile(const String& path, const char* text)
+    {
+        std::ofstream stream(path.Data(), std::ios::binary | std::ios::app);
+        stream << text;
+    }
+
+    TEST(FileSystem, FileWatcher)
+    {
+        String root = FileSystem::GetEngineSaveDir() / "test/watch";
+        FileSystem::ClearDir(root);
+        ASSERT_TRUE(FileSystem::MakeDirTree(root / "sub"));
+        AppendToFile(root / "stay.txt", "stay");
+
+        FileWatcher watcher(30);
+        ASSERT_TRUE(watcher.IsAvailable());
+        FileChangeCollector deferred;
+        FileChangeCollector immediate;
+        FileWatchHandle rootHandle = watcher.Watch(root, true, FileChangesDelegate::CreateRaw(&deferred, &FileChangeCollector::OnChanged));
+        FileWatchHandle subHandle = watcher.Watch(root / "sub", false, FileChangesDelegate::CreateRaw(&immediate, &FileChangeCollector::OnChanged),
+                                                  EFileWatchDispatch::WatcherThread);
+        ASSERT_NE(rootHandle, INDEX_NONE);
+        ASSERT_NE(subHandle, INDEX_NONE);
+        EXPECT_EQ(watcher.Watch(root / "missing", true, FileChangesDelegate()), INDEX_NONE);
+
+        // a burst of changes is merged per path
+        for (int32 index = 0; index < 5; ++index)
+        {
+            AppendToFile(root / "a.txt", "burst");
+        }
+        AppendToFile(root / "temp.txt", "temp");
+        FileSystem::RemoveFile(root / "temp.txt");
+        AppendToFile(root / "stay.txt", "modified");
+        AppendToFile(root / "sub/b.txt", "b");
+        ASSERT_TRUE(FileSystem::MakeDir(root / "new"));
+        AppendToFile(root / "new/c.txt", "c");
+
+        ASSERT_TRUE(deferred.WaitChanges(watcher, 5));
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        watcher.DispatchEvents();
+        EXPECT_EQ(deferred.Changes.Size(), 5);
+        ASSERT_TRUE(deferred.Find(root / "a.txt") != nullptr);
+        EXPECT_EQ(deferred.Find(root / "a.txt")->Action, EFileChangeAction::Added);
+        ASSERT_TRUE(deferred.Find(root / "stay.txt") != nullptr);
+        EXPECT_EQ(deferred.Find(root / "stay.txt")->Action, EFileChangeAction::Modified);
+        EXPECT_TRUE(deferred.Find(root / "temp.txt") == nullptr);
+        EXPECT_TRUE(deferred.Find(root / "sub/b.txt") != nullptr);
+        EXPECT_TRUE(deferred.Find(root / "new") != nullptr);
+        EXPECT_TRUE(deferred.Find(root / "new/c.txt") != nullptr);
+
+        // delegate bound to watcher thread is executed without pumping
+        for (int32 retry = 0; retry < 500 && immediate.Find(root / "sub/b.txt") == nullptr; ++retry)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        ASSERT_TRUE(immediate.Find(root / "sub/b.txt") != nullptr);
+        EXPECT_EQ(immediate.Changes.Size(), 1);
+        EXPECT_TRUE(watcher.Unwatch(subHandle));
+        EXPECT_FALSE(watcher.Unwatch(subHandle));
+
+        deferred.Changes.Clear();
+        EXPECT_TRUE(FileSystem::MoveFile(root / "a.txt", root / "new/renamed.txt"));
+        EXPECT_TRUE(FileSystem::RemoveFile(root / "sub/b.txt"));
+        AppendToFile(root / "new/c.txt", "more");
+        ASSERT_TRUE(deferred.WaitChanges(watcher, 3));
+        const FileChange* renamed = deferred.Find(root / "new/renamed.txt");
+        ASSERT_TRUE(renamed != nullptr);
+        EXPECT_EQ(renamed->Action, EFileChangeAction::Renamed);
+        EXPECT_EQ(renamed->OldPath, root / "a.txt");
+        ASSERT_TRUE(deferred.Find(root / "sub/b.txt") != nullptr);
+        EXPECT_EQ(deferred.Find(root / "sub/b.txt")->Action, EFileChangeAction::Removed);
+        ASSERT_TRUE(deferred.Find(root / "new/c.txt") != nullptr);
+        EXPECT_EQ(deferred.Find(root / "new/c.txt")->Action, EFileChangeAction::Modified);
+
+        EXPECT_TRUE(watcher.Unwatch(rootHandle));
+        deferred.Changes.Clear();
+        AppendToFile(root / "after.txt", "after");
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        EXPECT_EQ(watcher.DispatchEvents(), 0);
+        EXPECT_TRUE(deferred.Changes.Empty());
+        EXPECT_EQ(immediate.Changes.Size(), 1);
+
+        FileSystem::ClearDir(root);
+        FileSystem::RemoveDir(root);
+    }
+}
@@ -3,6 +3,9 @@
 #include "math/rotator.hpp"
 #include "math/quaternion.hpp"
 #include "math/matrix.hpp"
+#include "math/transform.hpp"
+#include "math/math_stream.hpp"
+#include "math/hash_helper.hpp"
 #include "log/logger.hpp"
 
 namespace Engine
@@ -17,6 +20,16 @@ namespace Engine
         EXPECT_TRUE(Math::CeilLogTwo((uint8)31) == 5);
     }
 
+    TEST(MathTest, Alignment)
+    {
+        // simd loads of these types expect 16 bytes alignment
+        EXPECT_EQ(alignof(Quat), 16);
+        EXPECT_EQ(alignof(Matrix), 16);
+        EXPECT_EQ(alignof(Transform), 16);
+        EXPECT_EQ(sizeof(Quat), 16);
+        EXPECT_EQ(sizeof(Matrix), 64);
+    }
+
     TEST(MathTest, Vector3)
     {
         EXPECT_TRUE(Vector3f::Zero.IsZero());
@@ -51,6 +64,273 @@ namespace Engine
             }
         }
 
+        // rows of M are linear dependent
+        EXPECT_TRUE(M.Inverse().Equals(Matrix::Identity));
+
+        Matrix expected;
+        for (int32 i = 0; i < 4; ++i)
+        {
+            for (int32 j = 0; j < 4; ++j)
+            {
+                expected.M[i][j] = 0;
+                for (int32 k = 0; k < 4; ++k)
+                {
+                    expected.M[i][j] += M.M[i][k] * N.M[k][j];
+                }
+            }
+        }
         M = M * N;
+        EXPECT_TRUE(M.Equals(expected));
+
+        uint32 seed = 3;
+        auto random = [&seed](float min, float max) {
+            seed = seed * 1664525u + 1013904223u;
+            return min + (max - min) * static_cast<float>(seed >> 8) / static_cast<float>(1 << 24);
+        };
+
+        for (int32 round = 0; round < 16; ++round)
+        {
+            Matrix A;
+            for (int32 i = 0; i < 4; ++i)
+            {
+                for (int32 j = 0; j < 4; ++j)
+                {
+                    // diagonally dominant, never singular
+                    A.M[i][j] = random(-1, 1) + (i == j ? 4.0f : 0.0f);
+                }
+            }
+
+            Matrix transposed = A.GetTransposed();
+            for (int32 i = 0; i < 4; ++i)
+            {
+                for (int32 j = 0; j < 4; ++j)
+                {
+                    EXPECT_EQ(transposed.M[i][j], A.M[j][i]);
+                }
+            }
+
+            EXPECT_TRUE((A * A.Inverse()).Equals(Matrix::Identity, 1e-4f));
+            EXPECT_TRUE((A.Inverse() * A).Equals(Matrix::Identity, 1e-4f));
+
+            const Vector4f vector(random(-5, 5), random(-5, 5), random(-5, 5), random(-5, 5));
+            const Vector4f transformed = A.TransformVector4(vector);
+            for (int32 j = 0; j < 4; ++j)
+            {
+                const float component = vector.X * A.M[0][j] + vector.Y * A.M[1][j] + vector.Z * A.M[2][j] + vector.W * A.M[3][j];
+                EXPECT_NEAR(transformed[j], component, 1e-4f);
+            }
+
+            const Vector3f position(vector.X, vector.Y, vector.Z);
+            EXPECT_TRUE(A.TransformPosition(position) == Vector3f(
+                A.TransformVector4(Vector4f(position.X, position.Y, position.Z, 1.0f)).X,
+                A.TransformVector4(Vector4f(position.X, position.Y, position.Z, 1.0f)).Y,
+                A.TransformVector4(Vector4f(position.X, position.Y, position.Z, 1.0f)).Z));
+            EXPECT_TRUE(A.TransformVector(position) == Vector3f(
+                A.TransformVector4(Vector4f(position.X, position.Y, position.Z, 0.0f)).X,
+                A.TransformVector4(Vector4f(position.X, position.Y, position.Z, 0.0f)).Y,
+                A.TransformVector4(Vector4f(position.X, position.Y, position.Z, 0.0f)).Z));
+
+            // result may be one of the inputs
+            Matrix product = A;
+            product *= transposed;
+            EXPECT_TRUE(product.Equals(A * transposed));
+        }
+    }
+
+    TEST(MathTest, Transform)
+    {
+        uint32 seed = 7;
+        auto random = [&seed](float min, float max) {
+            seed = seed * 1664525u + 1013904223u;
+            return min + (max - min) * static_cast<float>(seed >> 8) / static_cast<float>(1 << 24);
+        };
+        auto randomQuat = [&random]() {
+            Quat quat(random(-1, 1), random(-1, 1), random(-1, 1), random(-1, 1));
+            quat.Normalize();
+            return quat;
+        };
+        auto randomVector = [&random](float min, float max) {
+            return Vector3f(random(min, max), random(min, max), random(min, max));
+        };
+
+        const Transform identity;
+        EXPECT_TRUE(identity.GetRotation() == Quat::Identity);
+        EXPECT_TRUE(identity.GetTranslation() == Vector3f::Zero);
+        EXPECT_TRUE(identity.GetScale() == Vector3f(1.0f));
+
+        // expected values are built from Quat and Vector3f, same as the scalar path
+        for (int32 round = 0; round < 32; ++round)
+        {
+            const Transform a(randomQuat(), randomVector(-10, 10), randomVector(0.5f, 2));
+            const Transform b(randomQuat(), randomVector(-10, 10), randomVector(0.5f, 2));
+            const Vector3f position = randomVector(-5, 5);
+
+            const Quat rotationA = a.GetRotation();
+            const Quat rotationB = b.GetRotation();
+            const Vector3f translationA = a.GetTranslation();
+            const Vector3f translationB = b.GetTranslation();
+            const Vector3f scaleA = a.GetScale();
+            const Vector3f scaleB = b.GetScale();
+
+            const Transform product = a * b;
+            EXPECT_TRUE(product.Equals(Transform(rotationA * rotationB, rotationB.RotateVector(scaleB * translationA) + translationB, scaleA * scaleB), 1e-4f));
+
+            Transform aliased = a;
+            aliased *= b;
+            EXPECT_TRUE(aliased.Equals(product));
+            aliased = b;
+            Transform::Multiply(a, aliased, aliased);
+            EXPECT_TRUE(aliased.Equals(product));
+
+            EXPECT_TRUE(a.TransformPosition(position).Equals(rotationA.RotateVector(scaleA * position) + translationA, 1e-4f));
+            EXPECT_TRUE(a.TransformVector(position).Equals(rotationA.RotateVector(scaleA * position), 1e-4f));
+            EXPECT_TRUE(a.InverseTransformPosition(a.TransformPosition(position)).Equals(position, 1e-4f));
+
+            // inverse is exact for uniform scale
+            const Transform uniform(rotationA, translationA, Vector3f(random(0.5f, 2)));
+            const Transform inverse = uniform.Inverse();
+            EXPECT_TRUE(inverse.GetRotation().Equals(rotationA.Inverse()));
+            EXPECT_TRUE(inverse.TransformPosition(uniform.TransformPosition(position)).Equals(position, 1e-3f));
+            EXPECT_TRUE((uniform * inverse).Equals(identity, 1e-3f));
+        }
+
+        const Transform flat(Quat::Identity, Vector3f(1, 2, 3), Vector3f(0, 2, 4));
+        EXPECT_TRUE(flat.Inverse().GetScale() == Vector3f(0, 0.5f, 0.25f));
+        EXPECT_TRUE(flat.InverseTransformPosition(Vector3f(5, 6, 7)) == Vector3f(0, 2, 1));
+    }
+
+#if ENABLE_TRANSFORM_INTRINSICS
+    TEST(MathTest, VectorRegister)
+    {
+        const VectorRegister a = MakeVectorRegister(1, 2, 3, 4);
+        const VectorRegister b = MakeVectorRegister(5, 6, 7, 8);
+        float result[4];
+
+        VectorStore(Vector3fDot(a, b), result);
+        EXPECT_TRUE(result[0] == 38.0f && result[1] == 38.0f && result[2] == 38.0f && result[3] == 38.0f);
+
+        VectorStore(Vector4fDot(a, b), result);
+        EXPECT_TRUE(result[0] == 70.0f && result[1] == 70.0f && result[2] == 70.0f && result[3] == 70.0f);
+
+        VectorStore(VectorSetW(a, 9.0f), result);
+        EXPECT_TRUE(result[0] == 1.0f && result[1] == 2.0f && result[2] == 3.0f && result[3] == 9.0f);
+
+        VectorStore(VectorShuffle<3, 2, 1, 0>(a, b), result);
+        EXPECT_TRUE(result[0] == 4.0f && result[1] == 3.0f && result[2] == 6.0f && result[3] == 5.0f);
+
+        VectorStore(VectorCross(a, b), result);
+        const Vector3f cross = Vector3f::Cross(Vector3f(1, 2, 3), Vector3f(5, 6, 7));
+        EXPECT_TRUE(Vector3f(result[0], result[1], result[2]) == cross && result[3] == 0.0f);
+    }
+#endif
+
+    TEST(MathTest, MathStream)
+    {
+        // not a multiple of register width, so remainder of every backend is covered
+        constexpr int32 num = 37;
+        uint32 seed = 1;
+        auto random = [&seed](float min, float max) {
+            seed = seed * 1664525u + 1013904223u;
+            return min + (max - min) * static_cast<float>(seed >> 8) / static_cast<float>(1 << 24);
+        };
+        auto randomQuat = [&random]() {
+            Quat quat(random(-1, 1), random(-1, 1), random(-1, 1), random(-1, 1));
+            quat.Normalize();
+            return quat;
+        };
+
+        TransformStream a;
+        TransformStream b;
+        Vector3Stream vectors;
+        for (int32 i = 0; i < num; ++i)
+        {
+            a.Add(Transform(randomQuat(), Vector3f(random(-10, 10), random(-10, 10), random(-10, 10)), Vector3f(random(0.5f, 2), random(0.5f, 2), random(0.5f, 2))));
+            b.Add(Transform(randomQuat(), Vector3f(random(-10, 10), random(-10, 10), random(-10, 10)), Vector3f(random(0.5f, 2), random(0.5f, 2), random(0.5f, 2))));
+            vectors.Add(Vector3f(random(-5, 5), random(-5, 5), random(-5, 5)));
+        }
+        // nearly equal rotations take linear path of slerp
+        b.Rotation.Set(3, a.Rotation.Get(3));
+
+        auto expectEquals = [](const Array<float>& lhs, const Array<float>& rhs, float tolerance) {
+            ASSERT_EQ(lhs.Size(), rhs.Size());
+            for (int32 i = 0; i < lhs.Size(); ++i)
+            {
+                EXPECT_NEAR(lhs[i], rhs[i], tolerance) << "index " << i;
+            }
+        };
+
+        auto run = [&](EMathStreamBackend backend, Array<float>& outFloats) {
+            EXPECT_TRUE(MathStream::SetBackend(backend));
+            outFloats.Clear();
+
+            Vector3Stream normalized = vectors;
+            MathStream::Normalize(normalized);
+            Array<float> dots;
+            MathStream::Dot(vectors, a.Translation, dots);
+            Vector3Stream cross;
+            MathStream::Cross(vectors, a.Translation, cross);
+            QuatStream multiplied;
+            MathStream::Multiply(a.Rotation, b.Rotation, multiplied);
+            Vector3Stream rotated;
+            MathStream::RotateVector(a.Rotation, vectors, rotated);
+            QuatStream slerped;
+            MathStream::Slerp(a.Rotation, b.Rotation, 0.3f, slerped);
+            // output aliases input
+            TransformStream transforms = a;
+            MathStream::Multiply(transforms, b, transforms);
+
+            for (const Array<float>* data : { &normalized.X, &normalized.Y, &normalized.Z, &dots, &cross.X, &cross.Y, &cross.Z,
+                                              &multiplied.X, &multiplied.Y, &multiplied.Z, &multiplied.W,
+                                              &rotated.X, &rotated.Y, &rotated.Z, &slerped.X, &slerped.Y, &slerped.Z, &slerped.W,
+                                              &transforms.Rotation.X, &transforms.Rotation.W, &transforms.Translation.X,
+                                              &transforms.Translation.Y, &transforms.Translation.Z, &transforms.Scale.Z })
+            {
+                for (float value : *data)
+                {
+                    outFloats.Add(value);
+                }
+            }
+        };
+
+        const EMathStreamBackend defaultBackend = MathStream::GetBackend();
+        EXPECT_TRUE(MathStream::IsBackendSupported(EMathStreamBackend::Scalar));
+        Array<float> expected;
+        run(EMathStreamBackend::Scalar, expected);
+
+        // scalar path matches per element methods
+        const Transform transform = a.Get(5) * b.Get(5);
+        EXPECT_TRUE(transform.GetTranslation() == Vector3f(expected[num * 20 + 5], expected[num * 21 + 5], expected[num * 22 + 5]));
+
+        for (EMathStreamBackend backend : { EMathStreamBackend::Sse, EMathStreamBackend::Avx2, EMathStreamBackend::Ispc, EMathStreamBackend::Avx512 })
+        {
+            if (!MathStream::IsBackendSupported(backend))
+            {
+                EXPECT_FALSE(MathStream::SetBackend(backend));
+                continue;
+            }
+            SCOPED_TRACE(MathStream::GetBackendName(backend));
+            Array<float> actual;
+            run(backend, actual);
+            expectEquals(expected, actual, 1e-3f);
+        }
+
+        EXPECT_TRUE(MathStream::SetBackend(defaultBackend));
+    }
+
+    TEST(MathTest, Crc32c)
+    {
+        EXPECT_EQ(HashHelper::Crc32c("123456789", 9), 0xE3069283u);
+        EXPECT_EQ(HashHelper::Crc32c("", 0), 0u);
+
+        uint8 zeros[32] = {};
+        EXPECT_EQ(HashHelper::Crc32c(zeros, sizeof(zeros)), 0x8A9136AAu);
+
+        // continued checksum equals the one of whole data, at any split and alignment
+        const char* text = "the quick brown fox jumps over the lazy dog";
+        const uint32 whole = HashHelper::Crc32c(text, 43);
+        for (size_t split = 0; split <= 43; ++split)
+        {
+            EXPECT_EQ(HashHelper::Crc32c(text + split, 43 - split, HashHelper::Crc32c(text, split)), whole);
+        }
     }
 }
\ No newline at end of file
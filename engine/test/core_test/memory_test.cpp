@@ -0,0 +1,344 @@
+#include <thread>
+#include "gtest/gtest.h"
+#include "core_minimal_public.hpp"
+#include "memory/object_pool.hpp"
+#include "memory/allocator_policies.hpp"
+#include "memory/memory_tracker.hpp"
+#include "memory/ansi_c_malloc.hpp"
+#include "foundation/array.hpp"
+#include "foundation/bit_array.hpp"
+
+namespace Engine
+{
+    struct PooledObject
+    {
+        PooledObject(int32 value) : Value(value) {}
+
+        int32 Value;
+        float Padding[7];
+    };
+
+    TEST(ObjectPool, NewDelete)
+    {
+        ObjectPool<PooledObject> pool(64, 16);
+        Array<PooledObject*> objects;
+        for (int32 index = 0; index < 200; ++index)
+        {
+            PooledObject* obj = pool.New(index);
+            EXPECT_TRUE(reinterpret_cast<uintptr>(obj) % alignof(PooledObject) == 0);
+            objects.Add(obj);
+        }
+
+        for (int32 index = 0; index < 200; ++index)
+        {
+            EXPECT_EQ(objects[index]->Value, index);
+            pool.Delete(objects[index]);
+        }
+
+        pool.FlushThreadCache();
+        PoolStats stats = pool.GetStats();
+        EXPECT_EQ(stats.AllocateCount, 200);
+        EXPECT_EQ(stats.FreeCount, 200);
+        EXPECT_EQ(stats.LiveCount, 0);
+        EXPECT_TRUE(stats.PeakLiveCount >= 200 - 16);
+        EXPECT_EQ(stats.BlockCount, 4);
+    }
+
+    TEST(ObjectPool, Reuse)
+    {
+        ObjectPool<PooledObject> pool;
+        PooledObject* first = pool.New(1);
+        pool.Delete(first);
+        PooledObject* second = pool.New(2);
+        EXPECT_EQ(first, second);
+        pool.Delete(second);
+    }
+
+    TEST(ObjectPool, SmallObjectPool)
+    {
+        void* small = SmallObjectPool::Allocate(24);
+        void* large = SmallObjectPool::Allocate(SmallObjectPool::MAX_POOLED_SIZE + 1);
+        EXPECT_TRUE(reinterpret_cast<uintptr>(small) % SmallObjectPool::POOLED_GRANULARITY == 0);
+        EXPECT_TRUE(large != nullptr);
+        SmallObjectPool::Free(small, 24);
+        SmallObjectPool::Free(large, SmallObjectPool::MAX_POOLED_SIZE + 1);
+    }
+
+    TEST(ObjectPool, SmallStride)
+    {
+        // free nodes are a single pointer, the 16 byte class doesn't pad elements to 32 bytes
+        FixedSizePool pool(16, 16);
+        uint8* first = static_cast<uint8*>(pool.Allocate());
+        uint8* second = static_cast<uint8*>(pool.Allocate());
+        EXPECT_EQ(second - first, 16);
+        EXPECT_TRUE(pool.Owns(first) && pool.Owns(second));
+
+        void* heap = Memory::Malloc(16);
+        EXPECT_FALSE(pool.Owns(heap));
+        Memory::Free(heap);
+
+        pool.Free(first);
+        pool.Free(second);
+    }
+
+    TEST(ObjectPool, PoolAllocator)
+    {
+        Array<int32, PoolAllocator<int32>> array;
+        array.Add(1);
+        for (int32 index = 2; index <= 100; ++index)
+        {
+            array.Add(index);
+        }
+        EXPECT_EQ(array.Size(), 100);
+        EXPECT_EQ(array[99], 100);
+
+        // single element goes to the pool and must come back with the same count
+        PoolAllocator<int32>::ElementAllocator<int64> alloc;
+        ObjectPool<int64>::Get().FlushThreadCache();
+        const uint64 allocateCount = ObjectPool<int64>::Get().GetStats().AllocateCount;
+        int64* single = alloc.Allocate(1);
+        *single = 42;
+        alloc.Deallocate(single, 1);
+        ObjectPool<int64>::Get().FlushThreadCache();
+        EXPECT_EQ(ObjectPool<int64>::Get().GetStats().AllocateCount, allocateCount + 1);
+
+        // heap block freed with a wrong count still goes back to heap, pool decides by owning the address
+        const uint64 freeCount = ObjectPool<int64>::Get().GetStats().FreeCount;
+        int64* multiple = alloc.Allocate(4);
+        EXPECT_FALSE(ObjectPool<int64>::Get().Owns(multiple));
+        alloc.Deallocate(multiple, 1);
+        ObjectPool<int64>::Get().FlushThreadCache();
+        EXPECT_EQ(ObjectPool<int64>::Get().GetStats().FreeCount, freeCount);
+
+        // bit array keeps capacity in bits but allocates elements, its first block is a single pooled element
+        BitArray<PoolAllocator<int32>> bits;
+        for (int32 index = 0; index < 100; ++index)
+        {
+            bits.Add(index % 3 == 0);
+        }
+        EXPECT_EQ(bits.Size(), 100);
+        EXPECT_TRUE(bits[99]);
+        EXPECT_FALSE(bits[98]);
+    }
+
+    TEST(MemoryTracker, TagScope)
+    {
+        EXPECT_EQ(MemoryTagScope::GetCurrentTag(), EMemoryTag::Untagged);
+        {
+            MEMORY_TAG_SCOPE(Container);
+            EXPECT_EQ(MemoryTagScope::GetCurrentTag(), EMemoryTag::Container);
+            {
+                MEMORY_TAG_SCOPE(String);
+                EXPECT_EQ(MemoryTagScope::GetCurrentTag(), EMemoryTag::String);
+            }
+            EXPECT_EQ(MemoryTagScope::GetCurrentTag(), EMemoryTag::Container);
+        }
+        EXPECT_EQ(MemoryTagScope::GetCurrentTag(), EMemoryTag::Untagged);
+
+        // containers only tag their buffers when no subsystem did
+        EXPECT_EQ(MemoryTagScope::GetCurrentTagOr(EMemoryTag::Container), EMemoryTag::Container);
+        {
+            MEMORY_TAG_SCOPE(FileSystem);
+            EXPECT_EQ(MemoryTagScope::GetCurrentTagOr(EMemoryTag::Container), EMemoryTag::FileSystem);
+        }
+
+#if ENABLE_MEMORY_TRACKING
+        auto tagBytes = [](EMemoryTag tag) {
+            return MemoryTracker::Get()->GetStats().Tags[static_cast<int32>(tag)].AllocatedBytes;
+        };
+        const int64 containerBytes = tagBytes(EMemoryTag::Container);
+        const int64 fileSystemBytes = tagBytes(EMemoryTag::FileSystem);
+        {
+            Array<int32> untagged;
+            untagged.Reserve(1000);
+            EXPECT_TRUE(tagBytes(EMemoryTag::Container) >= containerBytes + 4000);
+
+            MEMORY_TAG_SCOPE(FileSystem);
+            Array<int32> tagged;
+            tagged.Reserve(1000);
+            EXPECT_TRUE(tagBytes(EMemoryTag::FileSystem) >= fileSystemBytes + 4000);
+        }
+        EXPECT_EQ(tagBytes(EMemoryTag::Container), containerBytes);
+        EXPECT_EQ(tagBytes(EMemoryTag::FileSystem), fileSystemBytes);
+#endif
+    }
+
+    TEST(MemoryTracker, Stats)
+    {
+        MemoryTracker tracker(new AnsiCMalloc());
+        // only the tracker Memory installed as GMalloc is global
+        EXPECT_NE(MemoryTracker::Get(), &tracker);
+        void* untagged = tracker.Malloc(100, 16);
+        void* tagged;
+        {
+            MEMORY_TAG_SCOPE(FileSystem);
+            tagged = tracker.Malloc(1000, 64);
+        }
+        EXPECT_TRUE(reinterpret_cast<uintptr>(tagged) % 64 == 0);
+
+        tagged = tracker.Realloc(tagged, 2000, 64);
+        MemoryTrackerStats stats = tracker.GetStats();
+        const MemoryTagStats& fileSystem = stats.Tags[static_cast<int32>(EMemoryTag::FileSystem)];
+        EXPECT_EQ(fileSystem.AllocatedBytes, 2000);
+        EXPECT_EQ(fileSystem.PeakBytes, 3000);
+        EXPECT_EQ(fileSystem.AllocationCount, 1);
+        EXPECT_EQ(stats.AllocatedBytes, 2100);
+        EXPECT_EQ(stats.SizeHistogram[6], 1);
+        EXPECT_EQ(stats.SizeHistogram[9], 1);
+        EXPECT_EQ(tracker.ReportLeaks(), 2);
+
+        // resizing in place is neither a new allocation nor a histogram sample
+        const size_t usableSize = tracker.GetAllocationSize(untagged);
+        EXPECT_TRUE(usableSize >= 100);
+        EXPECT_TRUE(tracker.TryResizeInPlace(untagged, usableSize));
+        stats = tracker.GetStats();
+        EXPECT_EQ(stats.AllocatedBytes, static_cast<int64>(2000 + usableSize));
+        EXPECT_EQ(stats.AllocationCount, 2);
+        EXPECT_EQ(stats.Tags[static_cast<int32>(EMemoryTag::Untagged)].TotalAllocationCount, 1u);
+        EXPECT_EQ(stats.SizeHistogram[6], 1);
+
+        tracker.Free(untagged);
+        tracker.Free(tagged);
+        EXPECT_EQ(tracker.ReportLeaks(), 0);
+        EXPECT_EQ(tracker.GetStats().AllocatedBytes, 0);
+    }
+
+    TEST(MemoryTracker, CrossThreadFree)
+    {
+        MemoryTracker tracker(new AnsiCMalloc());
+        constexpr int32 threadNum = 8;
+        constexpr int32 allocationNum = 1000;
+        void* allocations[threadNum][allocationNum];
+
+        // allocations of every thread are freed by the next one, so headers are unlinked from other threads' shards
+        std::thread threads[threadNum];
+        for (int32 index = 0; index < threadNum; ++index)
+        {
+            threads[index] = std::thread([&tracker, &allocations, index]() {
+                for (void*& ptr : allocations[index])
+                {
+                    ptr = tracker.Malloc(32, 16);
+                }
+            });
+        }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+        EXPECT_EQ(tracker.ReportLeaks(0), threadNum * allocationNum);
+
+        for (int32 index = 0; index < threadNum; ++index)
+        {
+            threads[index] = std::thread([&tracker, &allocations, index]() {
+                for (void* ptr : allocations[(index + 1) % threadNum])
+                {
+                    tracker.Free(ptr);
+                }
+            });
+        }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+        EXPECT_EQ(tracker.ReportLeaks(), 0);
+        EXPECT_EQ(tracker.GetStats().AllocationCount, 0);
+    }
+
+    TEST(AnsiCMalloc, AllocationSize)
+    {
+        AnsiCMalloc malloc;
+        void* ptr = malloc.Malloc(100, 16);
+        EXPECT_TRUE(reinterpret_cast<uintptr>(ptr) % 16 == 0);
+        EXPECT_TRUE(malloc.GetAllocationSize(ptr) >= 100);
+
+        EXPECT_TRUE(malloc.TryResizeInPlace(ptr, 50));
+        EXPECT_TRUE(malloc.GetAllocationSize(ptr) >= 50);
+        EXPECT_EQ(malloc.Realloc(ptr, 40, 16), ptr);
+
+        void* aligned = malloc.Malloc(100, 256);
+        EXPECT_TRUE(reinterpret_cast<uintptr>(aligned) % 256 == 0);
+        EXPECT_TRUE(malloc.GetAllocationSize(aligned) >= 100);
+        Memory::Memset(aligned, 0xcd, 100);
+        aligned = malloc.Realloc(aligned, 4096, 256);
+        EXPECT_TRUE(reinterpret_cast<uintptr>(aligned) % 256 == 0);
+        EXPECT_EQ(static_cast<uint8*>(aligned)[99], 0xcd);
+
+        malloc.Free(malloc.Realloc(ptr, 40, 16));
+        malloc.Free(aligned);
+
+#if !PLATFORM_WINDOWS
+        // a big shrink isn't done in place, realloc gives the tail back
+        void* big = malloc.Malloc(1 << 16, 16);
+        EXPECT_FALSE(malloc.TryResizeInPlace(big, 1000));
+        big = malloc.Realloc(big, 1000, 16);
+        EXPECT_TRUE(malloc.GetAllocationSize(big) >= 1000 && malloc.GetAllocationSize(big) < (1 << 16));
+        malloc.Free(big);
+#endif
+    }
+
+#if ENABLE_OVERRIDE_NEW_DELETE
+    TEST(Memory, OverrideNewDelete)
+    {
+        // global new and delete go through Memory, so blocks of either side can be freed by the other
+        void* block = ::operator new(100);
+        EXPECT_TRUE(Memory::GetAllocationSize(block) >= 100);
+        Memory::Free(block);
+
+        void* aligned = ::operator new[](100, std::align_val_t(256));
+        EXPECT_TRUE(reinterpret_cast<uintptr>(aligned) % 256 == 0);
+        ::operator delete[](aligned, 100, std::align_val_t(256));
+
+        void* engineBlock = Memory::Malloc(32);
+        ::operator delete(engineBlock, 32);
+
+        Array<int32>* array = new Array<int32>(7, 100);
+        EXPECT_EQ(array->Size(), 100);
+        delete array;
+    }
+#endif
+
+    TEST(VirtualArray, Growth)
+    {
+        VirtualArray<int32, 1ull << 30> array;
+        array.Add(0);
+        const int32* data = array.Data();
+        for (int32 index = 1; index < 1000000; ++index)
+        {
+            array.Add(index);
+        }
+        EXPECT_EQ(array.Data(), data);
+        EXPECT_EQ(array[999999], 999999);
+
+        array.RemoveAt(1000, array.Size() - 1000);
+        array.Shrink();
+        EXPECT_EQ(array.Data(), data);
+        EXPECT_EQ(array.Capacity(), 1000);
+        EXPECT_EQ(array[999], 999);
+
+        array.Reserve(2000000);
+        EXPECT_EQ(array.Data(), data);
+
+        // empty allocation doesn't reserve address space
+        VirtualAllocator<1ull << 30>::ElementAllocator<int32> alloc;
+        EXPECT_EQ(alloc.Allocate(0), nullptr);
+    }
+
+    TEST(VirtualArray, GrowToReservation)
+    {
+        // geometric growth past 2/3 of the reservation would ask for more than is reserved, it's capped instead
+        VirtualArray<int32, 1ull << 20> array;
+        const int64 maxSize = (1ll << 20) / sizeof(int32);
+        EXPECT_EQ(array.MaxSize(), maxSize);
+
+        array.Add(0);
+        const int32* data = array.Data();
+        for (int32 index = 1; index < maxSize; ++index)
+        {
+            array.Add(index);
+        }
+        EXPECT_EQ(array.Data(), data);
+        EXPECT_EQ(array.Size(), maxSize);
+        EXPECT_EQ(array.Capacity(), maxSize);
+        EXPECT_EQ(array.Last(), maxSize - 1);
+    }
+}
\ No newline at end of file
@@ -4,7 +4,21 @@
 #include "file_system/path.hpp"
 #include "file_system/file_system.hpp"
 #include "foundation/string.hpp"
+#include "foundation/string_kernels.hpp"
+#include "misc/cpu_features.hpp"
 #include "misc/type_hash.hpp"
+#include "foundation/set.hpp"
+#include "log/logger.hpp"
+#include "log/binary_log.hpp"
+#include "log/structured_log.hpp"
+#include "profiler/profiler.hpp"
+#include "foundation/time.hpp"
+#include "stats/stats.hpp"
+#include "thread/thread_pool.hpp"
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <thread>
 
 namespace Engine
 {
@@ -148,6 +162,31 @@ namespace Engine
         EXPECT_TRUE(items.Size() == 4);
     }
 
+    TEST(String, Trimmed)
+    {
+        // last character is kept when there is no trailing whitespace
+        EXPECT_TRUE(String("hello").Trimmed() == "hello");
+        EXPECT_TRUE(String(" hello").Trimmed() == "hello");
+        EXPECT_TRUE(String("hello  ").Trimmed() == "hello");
+        EXPECT_TRUE(String("a").Trimmed() == "a");
+        EXPECT_TRUE(String("  ").Trimmed().Empty());
+        EXPECT_TRUE(String().Trimmed().Empty());
+    }
+
+    TEST(String, CaseInsensitiveCompare)
+    {
+        // both sides are folded, a mismatch isn't hidden by comparing lhs with itself
+        EXPECT_EQ(CharTraits<char>::Compare("Hello", "hELLO", 5, CaseInsensitive), 0);
+        EXPECT_LT(CharTraits<char>::Compare("abc", "ABD", 3, CaseInsensitive), 0);
+        EXPECT_GT(CharTraits<char>::Compare("abd", "ABC", 3, CaseInsensitive), 0);
+        EXPECT_NE(CharTraits<char>::Compare("abc", "abd", 3, CaseInsensitive), 0);
+
+        EXPECT_TRUE(String("Polaris.PNG").EndsWith(".png", CaseInsensitive));
+        EXPECT_FALSE(String("Polaris.PNG").EndsWith(".jpg", CaseInsensitive));
+        EXPECT_FALSE(String("Hello").StartsWith("HELP", CaseInsensitive));
+        EXPECT_TRUE(String("Hello").StartsWith("hell", CaseInsensitive));
+    }
+
     TEST(String, Iterator)
     {
         String str = "abcd1234fgh";
@@ -189,6 +228,91 @@ namespace Engine
         EXPECT_TRUE(hash != 0);
     }
 
+    TEST(String, Kernels)
+    {
+        SCOPED_TRACE(CpuFeatures::GetSimdLevelName(StringKernels::GetSimdLevel()));
+        EXPECT_TRUE(StringKernels::GetSimdLevel() <= CpuFeatures::GetSimdLevel());
+
+        // every length up to a few avx512 registers, at every alignment, with match in head, body and tail
+        alignas(64) uint8 narrow[256];
+        alignas(64) uint8 narrowOther[256];
+        alignas(64) uint16 wide[256];
+        alignas(64) uint16 wideOther[256];
+        for (int32 offset = 0; offset < 4; ++offset)
+        {
+            for (int32 len = 0; len < 160; ++len)
+            {
+                for (int32 i = 0; i < 256; ++i)
+                {
+                    narrow[i] = static_cast<uint8>('a' + i % 23);
+                    wide[i] = static_cast<uint16>(0x4E00 + i % 23);
+                }
+                narrow[offset + len] = 0;
+                wide[offset + len] = 0;
+                EXPECT_EQ(StringKernels::Length(narrow + offset), static_cast<size_t>(len));
+                EXPECT_EQ(StringKernels::Length(wide + offset), static_cast<size_t>(len));
+
+                for (int32 position : { 0, len / 2, len - 1 })
+                {
+                    if (position < 0 || position >= len)
+                    {
+                        continue;
+                    }
+                    narrow[offset + position] = 0xFF;
+                    wide[offset + position] = 0xFFFF;
+                    EXPECT_EQ(StringKernels::Find(narrow + offset, len, 0xFF), narrow + offset + position);
+                    EXPECT_EQ(StringKernels::Find(wide + offset, len, 0xFFFF), wide + offset + position);
+                    // only first match counts
+                    EXPECT_EQ(StringKernels::Find(narrow + offset, len, narrow[offset]), narrow + offset);
+
+                    Memory::Memcpy(narrowOther, narrow, sizeof(narrow));
+                    Memory::Memcpy(wideOther, wide, sizeof(wide));
+                    EXPECT_EQ(StringKernels::Mismatch(narrow + offset, narrowOther + offset, len), static_cast<size_t>(len));
+                    EXPECT_EQ(StringKernels::Mismatch(wide + offset, wideOther + offset, len), static_cast<size_t>(len));
+                    narrowOther[offset + position] = 1;
+                    wideOther[offset + position] = 1;
+                    EXPECT_EQ(StringKernels::Mismatch(narrow + offset, narrowOther + offset, len), static_cast<size_t>(position));
+                    EXPECT_EQ(StringKernels::Mismatch(wide + offset, wideOther + offset, len), static_cast<size_t>(position));
+
+                    narrow[offset + position] = narrowOther[offset + position] = static_cast<uint8>('a' + (offset + position) % 23);
+                    wide[offset + position] = wideOther[offset + position] = static_cast<uint16>(0x4E00 + (offset + position) % 23);
+                }
+                EXPECT_EQ(StringKernels::Find(narrow + offset, len, 0), nullptr);
+                EXPECT_EQ(StringKernels::Find(wide + offset, len, 0), nullptr);
+            }
+        }
+
+        String str = "the quick brown fox jumps over the lazy dog, the quick brown fox jumps over the lazy cat";
+        EXPECT_TRUE(str.Length() == 88);
+        EXPECT_TRUE(str.IndexOf('z') == 37);
+        EXPECT_TRUE(str.IndexOf('Z', CaseInsensitive) == 37);
+        EXPECT_TRUE(str.IndexOf('!') == INDEX_NONE);
+        EXPECT_TRUE(str.StartsWith("the quick brown fox jumps over the lazy dog"));
+        EXPECT_TRUE(str < "the quick brown fox jumps over the lazy dog, the quick brown fox jumps over the lazy cow");
+        EXPECT_TRUE(str == "the quick brown fox jumps over the lazy dog, the quick brown fox jumps over the lazy cat");
+    }
+
+    TEST(CpuFeatures, SimdLevel)
+    {
+        EXPECT_TRUE(CpuFeatures::GetSimdLevel() <= CpuFeatures::GetDetectedSimdLevel());
+
+        ESimdLevel level = ESimdLevel::Scalar;
+        EXPECT_TRUE(CpuFeatures::ParseSimdLevel("AVX2", level) && level == ESimdLevel::Avx2);
+        EXPECT_TRUE(CpuFeatures::ParseSimdLevel("sse2", level) && level == ESimdLevel::Sse2);
+        EXPECT_FALSE(CpuFeatures::ParseSimdLevel("avx", level));
+        EXPECT_FALSE(CpuFeatures::ParseSimdLevel("avx5120", level));
+
+        // features follow level, so kernels checking either one agree
+        const ESimdLevel current = CpuFeatures::GetSimdLevel();
+        EXPECT_EQ(CpuFeatures::HasFeature(ECpuFeature::Sse2), current >= ESimdLevel::Sse2);
+        EXPECT_EQ(CpuFeatures::HasFeature(ECpuFeature::Avx2), current >= ESimdLevel::Avx2);
+        EXPECT_EQ(CpuFeatures::HasFeature(ECpuFeature::Avx512BW), current >= ESimdLevel::Avx512);
+        if (current < ESimdLevel::Sse2)
+        {
+            EXPECT_FALSE(CpuFeatures::HasFeature(ECpuFeature::Sse42));
+        }
+    }
+
     TEST(String, StringView)
     {
         StringView view = "abcd1234";
@@ -230,6 +354,105 @@ namespace Engine
         EXPECT_TRUE(Path::GetExtension(path) == ".ex");
         EXPECT_TRUE(Path::GetShortName(path, false) == "file");
         EXPECT_TRUE(Path::SplitPath(path).Size() == 4);
+
+        EXPECT_TRUE(Path::Combine("c:/dirA", "file") == "c:/dirA/file");
+        EXPECT_TRUE(Path::Combine("c:/dirA/", "\\file") == "c:/dirA/file");
+        EXPECT_TRUE(Path::Combine("c:/dirA\\", "/file") == "c:/dirA\\file");
+        EXPECT_TRUE(Path::GetExtension("c:/dir.A/file") == "");
+        EXPECT_TRUE(Path::RemoveExtension("c:/dirA/file.ex") == "c:/dirA/file");
+        EXPECT_TRUE(Path::GetExtension("dir/.gitignore") == "");
+        EXPECT_TRUE(Path::RemoveExtension("dir/.gitignore") == "dir/.gitignore");
+        EXPECT_TRUE(Path::GetExtension("dir/.config.json") == ".json");
+        EXPECT_TRUE(Path::RemoveExtension("dir/.config.json") == "dir/.config");
+        EXPECT_TRUE(Path::Normalize("c:\\dirA\\") == "c:/dirA");
+        EXPECT_TRUE(Path::Normalize("c:\\") == "c:/");
+        EXPECT_TRUE(Path::Normalize("/") == "/");
+    }
+
+    TEST(FileSystem, PathView)
+    {
+        PathView view("c:/dirA/file.tar.gz");
+        EXPECT_TRUE(view.IsAbsolute());
+        EXPECT_TRUE(view.GetParent() == "c:/dirA");
+        EXPECT_TRUE(view.GetFileName() == "file.tar.gz");
+        EXPECT_TRUE(view.GetStem() == "file.tar");
+        EXPECT_TRUE(view.GetExtension() == ".gz");
+        EXPECT_TRUE(view.HasExtension("GZ"));
+        EXPECT_TRUE(view.HasExtension(".gz"));
+        EXPECT_FALSE(view.HasExtension("tar"));
+
+        EXPECT_TRUE(PathView("/file").GetParent() == "/");
+        EXPECT_TRUE(PathView("c:/").GetParent() == "c:/");
+        EXPECT_TRUE(PathView("file").GetParent() == "");
+        EXPECT_TRUE(PathView("dir/.gitignore").GetExtension() == "");
+        EXPECT_TRUE(PathView("dir/file.").GetExtension() == "");
+
+        PathView upper("C:\\DirA\\File.tar.gz");
+        EXPECT_TRUE(upper == view);
+        EXPECT_FALSE(upper.Equals(view, CaseSensitive));
+        EXPECT_EQ(upper.GetHash64(), view.GetHash64());
+        EXPECT_NE(PathView("c:/dirA/file.tar").GetHash64(), view.GetHash64());
+
+        String longPath(300, 'a');
+        String longUpper(300, 'A');
+        EXPECT_EQ(PathView(longPath).GetHash64(), PathView(longUpper).GetHash64());
+        longUpper.Append('b');
+        EXPECT_NE(PathView(longPath).GetHash64(), PathView(longUpper).GetHash64());
+
+        Set<PathView> paths;
+        paths.Add(view);
+        EXPECT_TRUE(paths.Contains(upper));
+    }
+
+    TEST(FileSystem, PathBuilder)
+    {
+        PathBuilder builder("c:\\dirA\\\\.\\dirB\\..\\");
+        EXPECT_TRUE(builder.ToString() == "c:/dirA");
+
+        builder /= "/dirC//file.ex";
+        EXPECT_TRUE(builder.ToString() == "c:/dirA/dirC/file.ex");
+        builder.ReplaceExtension("bin");
+        EXPECT_TRUE(builder.ToString() == "c:/dirA/dirC/file.bin");
+        builder.Concat(".bak");
+        EXPECT_TRUE(builder.ToString() == "c:/dirA/dirC/file.bin.bak");
+        builder.ReplaceExtension("");
+        EXPECT_TRUE(builder.ToString() == "c:/dirA/dirC/file.bin");
+        builder.RemoveFileName();
+        EXPECT_TRUE(builder.ToString() == "c:/dirA/dirC");
+        builder.Append("../../../..");
+        EXPECT_TRUE(builder.ToString() == "c:/");
+        builder.Append("file");
+        EXPECT_TRUE(builder.ToString() == "c:/file");
+
+        builder.Reset("./dirA/../..");
+        EXPECT_TRUE(builder.ToString() == "..");
+        builder.Append("../dirB");
+        EXPECT_TRUE(builder.ToString() == "../../dirB");
+        builder.Reset("dirA/..");
+        EXPECT_TRUE(builder.ToString() == ".");
+        builder.Append("file");
+        EXPECT_TRUE(builder.ToString() == "file");
+        builder.Reset("//server/share/");
+        EXPECT_TRUE(builder.ToString() == "//server/share");
+        builder.Reset("/../dirA");
+        EXPECT_TRUE(builder.ToString() == "/dirA");
+
+        // reused builder keeps its buffer
+        builder.Reset();
+        builder.Append("/root");
+        const char* data = builder.ToString().Data();
+        for (int32 index = 0; index < 16; ++index)
+        {
+            builder.Reset("/root");
+            builder /= "content/textures";
+            builder /= "texture.png";
+            EXPECT_TRUE(builder.GetView().HasExtension("png"));
+        }
+        EXPECT_EQ(data, builder.ToString().Data());
+
+        String released = builder.Release();
+        EXPECT_TRUE(released == "/root/content/textures/texture.png");
+        EXPECT_TRUE(builder.Empty());
     }
 
     TEST(FileSystem, DirectoryIterator)
@@ -239,4 +462,692 @@ namespace Engine
             LOG_INFO(LogTemp, "{0}", entry.GetPath());
         }
     }
+
+    namespace
+    {
+        /** log is appended across runs, messages are tagged so lines of previous runs aren't counted */
+        const std::string& GetRunTag()
+        {
+            static const std::string tag =
+                fmt::format("run{0}", std::chrono::system_clock::now().time_since_epoch().count());
+            return tag;
+        }
+
+        /**
+         * @return lines of engine log containing tag of this run and given tag
+         * newest rotated file is read too, as log may be rotated in the middle of a test
+         */
+        Array<std::string> ReadLogLines(const char* tag)
+        {
+            String logFile = Path::Combine(FileSystem::GetEngineSaveDir(), "logs/engine_log.txt");
+            std::string text;
+            const Array<String> rotated = RotatingLogFile::GetRotatedFiles(logFile);
+            if (rotated.Size() > 0)
+            {
+                // plain file is removed only after it's fully compressed
+                const StringView extension(RotatingLogFile::COMPRESSED_EXTENSION);
+                String plainFile = rotated.Last();
+                if (plainFile.EndsWith(extension))
+                {
+                    plainFile = String(plainFile.Data(), plainFile.Length() - extension.Length());
+                }
+                Array64<uint8> data;
+                if (RotatingLogFile::ReadFile(plainFile, data) ||
+                    RotatingLogFile::ReadFile(plainFile + RotatingLogFile::COMPRESSED_EXTENSION, data))
+                {
+                    text.assign(reinterpret_cast<const char*>(data.Data()), static_cast<size_t>(data.Size()));
+                }
+            }
+            Array64<uint8> data;
+            if (RotatingLogFile::ReadFile(logFile, data))
+            {
+                text.append(reinterpret_cast<const char*>(data.Data()), static_cast<size_t>(data.Size()));
+            }
+
+            Array<std::string> lines;
+            std::istringstream stream(text);
+            std::string line;
+            while (std::getline(stream, line))
+            {
+                if (line.find(tag) != std::string::npos && line.find(GetRunTag()) != std::string::npos)
+                {
+                    lines.Add(line);
+                }
+            }
+            return lines;
+        }
+    }
+
+    TEST(Log, AsyncBackend)
+    {
+        constexpr int32 threadNum = 4;
+        constexpr int32 messageNum = 2000;
+
+        Array<std::thread> threads;
+        for (int32 thread = 0; thread < threadNum; ++thread)
+        {
+            threads.Add(std::thread([thread]() {
+                for (int32 index = 0; index < messageNum; ++index)
+                {
+                    LOG_INFO(LogTemp, "{0} async_block {1} {2}", GetRunTag(), thread, index);
+                }
+            }));
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        LogBackend::Get().Flush();
+
+        // nothing is lost with block policy and messages of one thread keep their order
+        Array<std::string> lines = ReadLogLines("async_block ");
+        EXPECT_EQ(lines.Size(), threadNum * messageNum);
+        int32 next[threadNum] = {};
+        for (const auto& line : lines)
+        {
+            int32 thread, index;
+            ASSERT_EQ(std::sscanf(line.c_str() + line.find("async_block "), "async_block %d %d", &thread, &index), 2);
+            EXPECT_EQ(index, next[thread]);
+            next[thread] = index + 1;
+        }
+
+        LogBackend::Get().SetOverflowPolicy(ELogOverflowPolicy::Drop);
+        const int64 droppedBefore = LogBackend::Get().GetDroppedNum();
+        constexpr int32 burstNum = LogBackend::QUEUE_CAPACITY * 4;
+        for (int32 index = 0; index < burstNum; ++index)
+        {
+            LOG_INFO(LogTemp, "{0} async_drop {1}", GetRunTag(), index);
+        }
+        LogBackend::Get().Flush();
+        LogBackend::Get().SetOverflowPolicy(ELogOverflowPolicy::Block);
+
+        const int64 dropped = LogBackend::Get().GetDroppedNum() - droppedBefore;
+        EXPECT_EQ(ReadLogLines("async_drop ").Size() + dropped, burstNum);
+        LOG_INFO(LogTemp, "{0} async_drop_end", GetRunTag());
+        LogBackend::Get().Flush();
+        if (dropped > 0)
+        {
+            // report isn't tagged, it's written before the tagged message after burst
+            std::ifstream stream(Path::Combine(FileSystem::GetEngineSaveDir(), "logs/engine_log.txt").Data());
+            std::string line;
+            bool reported = false;
+            while (std::getline(stream, line) && line.find(GetRunTag() + " async_drop_end") == std::string::npos)
+            {
+                reported = reported || line.find("log messages are dropped") != std::string::npos;
+            }
+            EXPECT_TRUE(reported);
+        }
+    }
+
+    DECLARE_LOG_CATEGORY_EX(LogStripped, ELogLevel::Trace, ELogLevel::Warn);
+    DECLARE_LOG_CATEGORY_EX(LogRuntime, ELogLevel::Info, ELogLevel::Trace);
+
+    TEST(Log, Level)
+    {
+        int32 evaluated = 0;
+        LOG_INFO(LogStripped, "stripped {0}", ++evaluated);
+        LOG_VERBOSE(LogStripped, "stripped {0}", ++evaluated);
+        EXPECT_EQ(evaluated, 0);
+        LOG_WARN(LogStripped, "not stripped {0}", ++evaluated);
+        EXPECT_EQ(evaluated, 1);
+
+        LOG_VERBOSE(LogRuntime, "runtime {0}", ++evaluated);
+        EXPECT_EQ(evaluated, 1);
+        EXPECT_TRUE(LogCategoryRegistry::SetLevel("logruntime", ELogLevel::Trace));
+        LOG_VERBOSE(LogRuntime, "runtime {0}", ++evaluated);
+        EXPECT_EQ(evaluated, 2);
+        GLogCategory_LogRuntime::SetLevel(ELogLevel::Error);
+        LOG_WARN(LogRuntime, "runtime {0}", ++evaluated);
+        EXPECT_EQ(evaluated, 2);
+        EXPECT_FALSE(LogCategoryRegistry::SetLevel("NotExist", ELogLevel::Trace));
+
+        // level of an unloaded module isn't touched anymore
+        std::atomic<int32> unloadedLevel{ ELogLevel::Info };
+        LogCategoryRegistry::Register("LogUnloaded", unloadedLevel);
+        EXPECT_TRUE(LogCategoryRegistry::SetLevel("LogUnloaded", ELogLevel::Warn));
+        EXPECT_EQ(unloadedLevel.load(), ELogLevel::Warn);
+        LogCategoryRegistry::Unregister(unloadedLevel);
+        EXPECT_FALSE(LogCategoryRegistry::SetLevel("LogUnloaded", ELogLevel::Trace));
+        EXPECT_EQ(unloadedLevel.load(), ELogLevel::Warn);
+    }
+
+#if PLATFORM_LINUX
+    TEST(Log, LogFromWriter)
+    {
+        // every write into binary log fails, file layer logs the error on writer thread while it holds sink lock
+        const int64 droppedBefore = LogBackend::Get().GetDroppedNum();
+        ASSERT_TRUE(LogBackend::Get().OpenBinaryLog("/dev/full"));
+        for (int32 index = 0; index < 20000; ++index)
+        {
+            LOG_INFO(LogTemp, "{0} full_device {1}", GetRunTag(), index);
+        }
+        LogBackend::Get().Flush();
+        LogBackend::Get().CloseBinaryLog();
+        LogBackend::Get().Flush();
+        EXPECT_GT(LogBackend::Get().GetDroppedNum(), droppedBefore);
+    }
+#endif
+
+    TEST(Log, BinaryLog)
+    {
+        String binaryFile = Path::Combine(FileSystem::GetEngineSaveDir(), "logs/binary_log_test.bin");
+        String textFile = Path::Combine(FileSystem::GetEngineSaveDir(), "logs/binary_log_test.txt");
+        ASSERT_TRUE(LogBackend::Get().OpenBinaryLog(binaryFile));
+
+        const char* nullStr = nullptr;
+        const int32 value = 42;
+        LOG_INFO(LogTemp, "binary_info {0} {1:.2f} {2} {3} {4:x} {5}", value, 1.5f, "str", String("engine"), 255u, GetRunTag());
+        LOG_WARN(LogTemp, "binary_warn {0} {1} {2} {3}", true, 'c', nullStr, GetRunTag());
+        // long double can't be recorded, it's formatted on logging thread
+        LOG_INFO(LogTemp, "binary_text {0}", 2.5L);
+        LogBackend::Get().CloseBinaryLog();
+        LogBackend::Get().Flush();
+
+        BinaryLogReader reader(binaryFile);
+        ASSERT_TRUE(reader.IsValid());
+        Array<LogEntry> entries;
+        LogEntry entry;
+        while (reader.Next(entry))
+        {
+            entries.Add(entry);
+        }
+        EXPECT_FALSE(reader.HasError());
+        ASSERT_EQ(entries.Size(), 3);
+        EXPECT_EQ(entries[0].Message, String(("binary_info 42 1.50 str engine ff " + GetRunTag()).c_str()));
+        EXPECT_EQ(entries[0].Category, "LogTemp");
+        EXPECT_EQ(entries[0].Level, spdlog::level::info);
+        EXPECT_EQ(entries[1].Message, String(("binary_warn true c (null) " + GetRunTag()).c_str()));
+        EXPECT_EQ(entries[1].Level, spdlog::level::warn);
+        EXPECT_GT(entries[1].Line, 0);
+        EXPECT_EQ(entries[2].Message, "binary_text 2.5");
+        EXPECT_LE(entries[0].Time, entries[2].Time);
+
+        // only warning and above are formatted into text log meanwhile
+        EXPECT_EQ(ReadLogLines("binary_info").Size(), 0);
+        EXPECT_EQ(ReadLogLines("binary_warn").Size(), 1);
+
+        ASSERT_TRUE(BinaryLogReader::ConvertToText(binaryFile, textFile));
+        std::ifstream stream(textFile.Data());
+        std::string line;
+        ASSERT_TRUE(std::getline(stream, line));
+        EXPECT_NE(line.find("[LogTemp]"), std::string::npos);
+        EXPECT_NE(line.find("[info] binary_info 42 1.50 str engine ff"), std::string::npos);
+        stream.close();
+
+        FileSystem::RemoveFile(binaryFile);
+        FileSystem::RemoveFile(textFile);
+    }
+
+    TEST(Log, StructuredLog)
+    {
+        LOG_INFO(LogTemp, "structured {0} {pak} {entries}", GetRunTag(), LogField("pak", "a \"b\".pak"), LogField("entries", 12));
+        LOG_WARN(LogTemp, "structured {0}\tescaped", GetRunTag(), 2.5L);
+        LogBackend::Get().Flush();
+
+        StructuredLogReader reader(Path::Combine(FileSystem::GetEngineSaveDir(), "logs/engine_log.jsonl"));
+        ASSERT_TRUE(reader.IsValid());
+        Array<LogEntry> entries;
+        LogEntry entry;
+        const std::string tag = "structured " + GetRunTag();
+        while (reader.Next(entry))
+        {
+            if (std::string_view(entry.Message.Data(), entry.Message.Length()).find(tag) == 0)
+            {
+                entries.Add(entry);
+            }
+        }
+        ASSERT_EQ(entries.Size(), 2);
+        EXPECT_EQ(entries[0].Message, String((tag + " a \"b\".pak 12").c_str()));
+        EXPECT_EQ(entries[0].Category, "LogTemp");
+        EXPECT_EQ(entries[0].Level, spdlog::level::info);
+        // source is only recorded from warning on
+        EXPECT_TRUE(entries[0].File.Empty());
+        ASSERT_EQ(entries[0].Fields.Size(), 2);
+        EXPECT_EQ(entries[0].Fields[0].Key, "pak");
+        EXPECT_EQ(entries[0].Fields[0].Value, "a \"b\".pak");
+        EXPECT_EQ(entries[0].Fields[1].Key, "entries");
+        EXPECT_EQ(entries[0].Fields[1].Value, "12");
+        EXPECT_EQ(entries[1].Message, String((tag + "\tescaped").c_str()));
+        EXPECT_EQ(entries[1].Level, spdlog::level::warn);
+        EXPECT_EQ(entries[1].File, "misc_test.cpp");
+        EXPECT_GT(entries[1].Line, 0);
+        EXPECT_LE(entries[0].Time, entries[1].Time);
+        EXPECT_LT(std::abs(entries[0].Time / 1000000000 - std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count()), 60);
+
+        EXPECT_TRUE(StructuredLogReader::ParseLine(R"({"time":"1970-01-02T00:00:01.5Z","level":"error","message":"m\u0041"})", entry));
+        EXPECT_EQ(entry.Time, 86401500000000ll);
+        EXPECT_EQ(entry.Level, spdlog::level::err);
+        EXPECT_EQ(entry.Message, "mA");
+        EXPECT_FALSE(StructuredLogReader::ParseLine(R"({"time":"1970-01-02T00:00:01Z","message":"cut)", entry));
+        EXPECT_FALSE(StructuredLogReader::ParseLine("plain text", entry));
+    }
+
+    TEST(Log, Rotation)
+    {
+        String logFile = Path::Combine(FileSystem::GetEngineSaveDir(), "logs/rotation_test.txt");
+        for (const String& file : RotatingLogFile::GetRotatedFiles(logFile))
+        {
+            FileSystem::RemoveFile(file);
+        }
+        FileSystem::RemoveFile(logFile);
+
+        LogRotationPolicy policy;
+        policy.MaxFileSize = 64;
+        policy.MaxRotatedFiles = 2;
+        {
+            RotatingLogFile file(logFile, policy);
+            ASSERT_TRUE(file.IsValid());
+            for (int32 index = 0; index < 5; ++index)
+            {
+                const std::string record = fmt::format("record {0:032}\n", index);
+                EXPECT_TRUE(file.Write(reinterpret_cast<const uint8*>(record.data()), static_cast<int64>(record.size())));
+            }
+            EXPECT_TRUE(file.Flush());
+        }
+
+        // every record is larger than half of max size, so each one gets its own file
+        // compressed on archive thread, which is done once file is destroyed
+        Array<String> rotated = RotatingLogFile::GetRotatedFiles(logFile);
+        ASSERT_EQ(rotated.Size(), 2);
+        EXPECT_TRUE(rotated[0].EndsWith(StringView(RotatingLogFile::COMPRESSED_EXTENSION)));
+        EXPECT_TRUE(rotated[1].EndsWith(StringView(RotatingLogFile::COMPRESSED_EXTENSION)));
+        Array64<uint8> data;
+        ASSERT_TRUE(RotatingLogFile::ReadFile(rotated[1], data));
+        EXPECT_EQ(std::string(reinterpret_cast<const char*>(data.Data()), data.Size()), fmt::format("record {0:032}\n", 3));
+        ASSERT_TRUE(RotatingLogFile::ReadFile(logFile, data));
+        EXPECT_EQ(std::string(reinterpret_cast<const char*>(data.Data()), data.Size()), fmt::format("record {0:032}\n", 4));
+
+        // appended on reopen instead of truncated
+        {
+            RotatingLogFile file(logFile, LogRotationPolicy());
+            EXPECT_EQ(file.GetSize(), data.Size());
+        }
+
+        for (const String& file : RotatingLogFile::GetRotatedFiles(logFile))
+        {
+            FileSystem::RemoveFile(file);
+        }
+        FileSystem::RemoveFile(logFile);
+    }
+
+    TEST(Profiler, Frame)
+    {
+        const bool enabled = Profiler::IsEnabled();
+        Profiler::SetEnabled(true);
+        Profiler::Reset();
+
+        Profiler::MarkFrame();
+        {
+            ProfileScope outer("Outer");
+            for (int32 index = 0; index < 2; ++index)
+            {
+                ProfileScope inner("Inner");
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        std::thread worker([]() {
+            Profiler::SetThreadName("Worker");
+            ProfileScope scope("Work");
+        });
+        worker.join();
+        Profiler::MarkFrame();
+        EXPECT_EQ(Profiler::GetFrameIndex(), 2);
+
+        Array<ProfileFrame> frames = Profiler::CollectFrames(8);
+        ASSERT_EQ(frames.Size(), 1);
+        const ProfileFrame& frame = frames[0];
+        EXPECT_EQ(frame.Index, 1);
+        // engine threads, eg: log writer, may add their own scopes to the frame
+        ASSERT_GE(frame.Stats.Size(), 3);
+        const ProfileScopeStat* outer = nullptr;
+        const ProfileScopeStat* inner = nullptr;
+        const ProfileScopeStat* work = nullptr;
+        for (const ProfileScopeStat& stat : frame.Stats)
+        {
+            outer = std::strcmp(stat.Name, "Outer") == 0 ? &stat : outer;
+            inner = std::strcmp(stat.Name, "Inner") == 0 ? &stat : inner;
+            work = std::strcmp(stat.Name, "Work") == 0 ? &stat : work;
+        }
+        ASSERT_TRUE(outer != nullptr && inner != nullptr && work != nullptr);
+        EXPECT_EQ(outer->CallNum, 1);
+        EXPECT_EQ(inner->CallNum, 2);
+        EXPECT_GE(inner->InclusiveTime, 2000000);
+        EXPECT_EQ(outer->ExclusiveTime, outer->InclusiveTime - inner->InclusiveTime);
+        EXPECT_LE(outer->InclusiveTime, frame.End - frame.Begin);
+        EXPECT_STREQ(frame.Stats[0].Name, "Inner");
+
+        String traceFile = Path::Combine(FileSystem::GetEngineSaveDir(), "profiler_test.json");
+        ASSERT_TRUE(Profiler::ExportChromeTrace(traceFile));
+        std::ifstream stream(traceFile.Data());
+        const std::string trace((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+        EXPECT_NE(trace.find(R"("name":"Outer","ph":"X")"), std::string::npos);
+        EXPECT_NE(trace.find(R"("args":{"name":"Worker"})"), std::string::npos);
+        EXPECT_NE(trace.find(R"("name":"Frame 1")"), std::string::npos);
+        stream.close();
+        FileSystem::RemoveFile(traceFile);
+
+        Profiler::Reset();
+        EXPECT_EQ(Profiler::CollectFrames(8).Size(), 0);
+        Profiler::SetEnabled(enabled);
+    }
+
+    TEST(Profiler, LogWriter)
+    {
+        const bool enabled = Profiler::IsEnabled();
+        Profiler::SetEnabled(true);
+        Profiler::Reset();
+
+        LOG_INFO(LogTemp, "{0} profiled_write", GetRunTag());
+        LogBackend::Get().Flush();
+
+        // writer thread records its work, not the time it waits for messages
+        bool found = false;
+        for (const ProfileThreadEvents& thread : Profiler::CollectEvents())
+        {
+            for (const ProfileEvent& event : thread.Events)
+            {
+                found |= std::strcmp(event.Name, "LogBackend::Write") == 0;
+            }
+        }
+        EXPECT_TRUE(found);
+
+        Profiler::Reset();
+        Profiler::SetEnabled(enabled);
+    }
+
+    TEST(Time, HighResolutionClock)
+    {
+        const int64 begin = HighResolutionClock::Now();
+        const auto steadyBegin = std::chrono::steady_clock::now();
+        Stopwatch stopwatch;
+        int64 scoped = 0;
+        {
+            ScopedTimer timer(scoped);
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+        stopwatch.Stop();
+        const int64 steady = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - steadyBegin).count();
+        const int64 elapsed = HighResolutionClock::Now() - begin;
+
+        EXPECT_GE(scoped, 20000000);
+        EXPECT_GE(stopwatch.GetElapsedNanoseconds(), scoped);
+        // calibrated against steady clock, so both agree within a small error
+        EXPECT_NEAR(static_cast<double>(elapsed), static_cast<double>(steady), steady * 0.02 + 100000.0);
+        EXPECT_NEAR(HighResolutionClock::CyclesToSeconds(stopwatch.GetElapsedCycles()), stopwatch.GetElapsedNanoseconds() / 1e9, 1e-6);
+
+        // stopped stopwatch doesn't advance, resumed one accumulates
+        const int64 stopped = stopwatch.GetElapsedCycles();
+        EXPECT_EQ(stopwatch.GetElapsedCycles(), stopped);
+        stopwatch.Start();
+        EXPECT_TRUE(stopwatch.IsRunning());
+        EXPECT_GE(stopwatch.GetElapsedCycles(), stopped);
+        stopwatch.Reset();
+        EXPECT_EQ(stopwatch.GetElapsedCycles(), 0);
+
+        int64 last = HighResolutionClock::Now();
+        for (int32 index = 0; index < 1000; ++index)
+        {
+            const int64 now = HighResolutionClock::Now();
+            EXPECT_GE(now, last);
+            last = now;
+        }
+    }
+
+    TEST(Stats, Registry)
+    {
+        static StatCounter counter("Test.Counter", "counted by test");
+        static StatGauge gauge("Test.Gauge");
+        static StatHistogram histogram("Test.Histogram", "recorded by test");
+        ASSERT_TRUE(counter.IsValid() && gauge.IsValid() && histogram.IsValid());
+        // registered again by name refers to the same stat
+        StatCounter sameCounter("Test.Counter");
+
+        Stats::EndFrame();
+        const int64 base = Stats::FindValue(Stats::GetValues(), "Test.Counter")->Value;
+        const int64 histogramBase = Stats::FindValue(Stats::GetValues(), "Test.Histogram")->Value;
+
+        counter.Add(3);
+        sameCounter.Add();
+        // values of exited threads are kept
+        std::thread worker([]() {
+            for (int32 index = 0; index < 1000; ++index)
+            {
+                counter.Add();
+            }
+        });
+        worker.join();
+        gauge.Set(10);
+        gauge.Add(-3);
+        histogram.Record(0);
+        histogram.Record(1);
+        histogram.Record(5);
+        histogram.Record(7);
+
+        const uint64 frame = Stats::GetFrameIndex();
+        Stats::EndFrame();
+        EXPECT_EQ(Stats::GetFrameIndex(), frame + 1);
+
+        const Array<StatValue> values = Stats::GetValues();
+        const StatValue* counterValue = Stats::FindValue(values, "Test.Counter");
+        const StatValue* gaugeValue = Stats::FindValue(values, "Test.Gauge");
+        const StatValue* histogramValue = Stats::FindValue(values, "Test.Histogram");
+        ASSERT_TRUE(counterValue != nullptr && gaugeValue != nullptr && histogramValue != nullptr);
+        EXPECT_EQ(Stats::FindValue(values, "Test.Missing"), nullptr);
+        EXPECT_EQ(counterValue->Value, base + 1004);
+        EXPECT_EQ(counterValue->FrameValue, 1004);
+        EXPECT_EQ(gaugeValue->Value, 7);
+        EXPECT_EQ(histogramValue->Value - histogramBase, 4);
+        EXPECT_EQ(histogramValue->FrameValue, 4);
+        ASSERT_EQ(histogramValue->Buckets.Size(), Stats::HISTOGRAM_BUCKET_NUM);
+        EXPECT_EQ(Stats::GetBucketUpperBound(3), 7);
+        EXPECT_EQ(Stats::GetBucketUpperBound(Stats::HISTOGRAM_BUCKET_NUM - 1), INT64_MAX);
+        if (histogramBase == 0)
+        {
+            EXPECT_EQ(histogramValue->Sum, 13);
+            EXPECT_EQ(histogramValue->Buckets[0], 1);
+            EXPECT_EQ(histogramValue->Buckets[1], 1);
+            EXPECT_EQ(histogramValue->Buckets[3], 2);
+        }
+
+        Stats::EndFrame();
+        EXPECT_EQ(Stats::FindValue(Stats::GetValues(), "Test.Counter")->FrameValue, 0);
+
+        String statsDir = Path::Combine(FileSystem::GetEngineSaveDir(), "stats_test");
+        String promFile = Path::Combine(statsDir, "stats.prom");
+        String csvFile = Path::Combine(statsDir, "stats.csv");
+        String textFile = Path::Combine(statsDir, "stats.txt");
+        FileSystem::RemoveFile(csvFile);
+        ASSERT_TRUE(Stats::Export(EStatExportFormat::Prometheus, promFile));
+        ASSERT_TRUE(Stats::Export(EStatExportFormat::Csv, csvFile));
+        ASSERT_TRUE(Stats::Export(EStatExportFormat::Csv, csvFile));
+        ASSERT_TRUE(Stats::Export(EStatExportFormat::Text, textFile));
+
+        auto readFile = [](const String& filePath) {
+            std::ifstream stream(filePath.Data());
+            return std::string((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+        };
+        const std::string prom = readFile(promFile);
+        EXPECT_NE(prom.find("# HELP polaris_Test_Counter_total counted by test\n# TYPE polaris_Test_Counter_total counter\n"),
+                  std::string::npos);
+        EXPECT_NE(prom.find("polaris_Test_Gauge 7\n"), std::string::npos);
+        EXPECT_NE(prom.find("# TYPE polaris_Test_Histogram histogram\n"), std::string::npos);
+        EXPECT_NE(prom.find("polaris_Test_Histogram_bucket{le=\"+Inf\"}"), std::string::npos);
+        EXPECT_NE(prom.find("polaris_Test_Histogram_count"), std::string::npos);
+
+        // header is written once, rows are appended
+        const std::string csv = readFile(csvFile);
+        EXPECT_EQ(csv.find("frame,time,name,type,value,frame_value,sum\n"), 0);
+        EXPECT_EQ(csv.rfind("frame,time"), 0);
+        size_t rowNum = 0;
+        for (size_t pos = csv.find("\"Test.Gauge\",gauge,7,"); pos != std::string::npos; pos = csv.find("\"Test.Gauge\",gauge,7,", pos + 1))
+        {
+            ++rowNum;
+        }
+        EXPECT_EQ(rowNum, 2);
+
+        EXPECT_NE(readFile(textFile).find("Test.Counter"), std::string::npos);
+        FileSystem::RemoveFile(promFile);
+        FileSystem::RemoveFile(csvFile);
+        FileSystem::RemoveFile(textFile);
+    }
+
+    TEST(Stats, LateRegistration)
+    {
+        // block of this thread already exists, stats registered now lie beyond its capacity
+        static StatCounter before("Test.Before");
+        before.Add();
+        Stats::EndFrame();
+
+        static StatHistogram first("Test.LateHistogram0");
+        static StatHistogram second("Test.LateHistogram1");
+        static StatCounter late("Test.Late");
+        ASSERT_TRUE(late.IsValid());
+        const int64 base = Stats::FindValue(Stats::GetValues(), "Test.Before")->Value;
+        const int64 lateBase = Stats::FindValue(Stats::GetValues(), "Test.Late")->Value;
+        before.Add(2);
+        first.Record(1);
+        second.Record(2);
+        late.Add(5);
+        std::thread worker([]() { late.Add(7); });
+        worker.join();
+
+        Stats::EndFrame();
+        const Array<StatValue> values = Stats::GetValues();
+        EXPECT_EQ(Stats::FindValue(values, "Test.Before")->Value, base + 2);
+        EXPECT_EQ(Stats::FindValue(values, "Test.Late")->Value, lateBase + 12);
+        EXPECT_EQ(Stats::FindValue(values, "Test.LateHistogram1")->FrameValue, 1);
+    }
+
+    TEST(Stats, PeriodicExport)
+    {
+        String textFile = Path::Combine(FileSystem::GetEngineSaveDir(), "stats_test/periodic.txt");
+        Stats::AddPeriodicExport(EStatExportFormat::Text, textFile, 0);
+
+        // exports changed by another thread while EndFrame writes them
+        std::atomic<bool> stop{ false };
+        std::thread changer([&stop, &textFile]() {
+            while (!stop.load())
+            {
+                Stats::RemovePeriodicExports();
+                for (int32 index = 0; index < 8; ++index)
+                {
+                    Stats::AddPeriodicExport(EStatExportFormat::Text, textFile, 0);
+                }
+            }
+        });
+        for (int32 frame = 0; frame < 50; ++frame)
+        {
+            Stats::EndFrame();
+        }
+        stop.store(true);
+        changer.join();
+
+        Stats::RemovePeriodicExports();
+        EXPECT_TRUE(FileSystem::FileExists(textFile));
+        FileSystem::RemoveFile(textFile);
+    }
+
+    TEST(ThreadPool, RunEveryTask)
+    {
+        class CountTask : public IWorkThreadTask
+        {
+        public:
+            explicit CountTask(std::atomic<int32>& counter) : Counter(counter) {}
+
+            void Run() override { Counter.fetch_add(1); }
+
+        private:
+            std::atomic<int32>& Counter;
+        };
+
+        constexpr int32 taskNum = 2000;
+        std::atomic<int32> counter{ 0 };
+        Array<UniquePtr<CountTask>> tasks;
+        for (int32 index = 0; index < taskNum; ++index)
+        {
+            tasks.Add(MakeUnique<CountTask>(counter));
+        }
+
+        // tasks are added while workers keep turning idle, none of them may be left in queue
+        for (int32 round = 0; round < 20; ++round)
+        {
+            counter = 0;
+            BuiltInThreadPool pool;
+            pool.Create(4);
+            for (int32 index = 0; index < taskNum; ++index)
+            {
+                pool.AddTask(tasks[index].get());
+                if (index % 64 == 0)
+                {
+                    std::this_thread::yield();
+                }
+            }
+
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+            while (counter.load() < taskNum && std::chrono::steady_clock::now() < deadline)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            ASSERT_EQ(counter.load(), taskNum);
+            pool.Destroy();
+        }
+
+        // workers waiting for task are woken up by destroy
+        for (int32 round = 0; round < 20; ++round)
+        {
+            BuiltInThreadPool pool;
+            pool.Create(4);
+            pool.Destroy();
+        }
+    }
+
+    TEST(ThreadPool, DestroyWhileBusy)
+    {
+        class SpawnTask : public IWorkThreadTask
+        {
+        public:
+            SpawnTask(IThreadPool& pool, std::atomic<int32>& counter, int32 depth)
+                : Pool(pool), Counter(counter), Depth(depth)
+            {}
+
+            void Run() override
+            {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+                Counter.fetch_add(1);
+                if (Depth > 0)
+                {
+                    Pool.AddTask(new SpawnTask(Pool, Counter, Depth - 1));
+                }
+                delete this;
+            }
+
+        private:
+            IThreadPool& Pool;
+            std::atomic<int32>& Counter;
+            int32 Depth;
+        };
+
+        // queued tasks and tasks added by running ones while pool is destroyed are all run, none is lost or leaked
+        for (int32 round = 0; round < 10; ++round)
+        {
+            std::atomic<int32> counter{ 0 };
+            BuiltInThreadPool pool;
+            pool.Create(2);
+            for (int32 index = 0; index < 8; ++index)
+            {
+                pool.AddTask(new SpawnTask(pool, counter, 5));
+            }
+            pool.Destroy();
+            EXPECT_EQ(counter.load(), 8 * 6);
+        }
+
+        // pool without worker runs what's queued on destroy
+        std::atomic<int32> counter{ 0 };
+        BuiltInThreadPool emptyPool;
+        emptyPool.Create(0);
+        emptyPool.AddTask(new SpawnTask(emptyPool, counter, 0));
+        emptyPool.Destroy();
+        EXPECT_EQ(counter.load(), 1);
+    }
 }
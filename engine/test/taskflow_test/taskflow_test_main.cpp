@@ -1,5 +1,6 @@
 #include "gtest/gtest.h"
 #include "foundation/encoding.hpp"
+#include "memory/override_new_delete.hpp"
 
 int main(int argc, char* argv[])
 {
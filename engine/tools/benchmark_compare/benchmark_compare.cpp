@@ -0,0 +1,448 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <regex>
+#include <string>
+#include <string_view>
+#include "benchmark_json_reader.hpp"
+#include "cxxopts.hpp"
+#include "file_system/async_file_io.hpp"
+#include "file_system/file_system.hpp"
+#include "file_system/path.hpp"
+#include "foundation/map.hpp"
+#include "memory/memory.hpp"
+#include "memory/override_new_delete.hpp"
+
+using namespace Engine;
+
+struct SampleStats
+{
+    int32 Num{ 0 };
+    double Median{ 0.0 };
+    double Mean{ 0.0 };
+    /** half width of 95% confidence interval of mean, 0 when there is only one sample */
+    double Interval{ 0.0 };
+};
+
+static double GetStudentT95(int32 degree)
+{
+    static constexpr double TABLE[] = { 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                                        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                                        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042 };
+    constexpr int32 tableSize = static_cast<int32>(sizeof(TABLE) / sizeof(TABLE[0]));
+    return degree <= tableSize ? TABLE[degree - 1] : 1.960;
+}
+
+static SampleStats GetStats(const Array<double>& samples)
+{
+    SampleStats stats;
+    stats.Num = samples.Size();
+    if (stats.Num == 0)
+    {
+        return stats;
+    }
+
+    Array<double> sorted = samples;
+    std::sort(sorted.Data(), sorted.Data() + sorted.Size());
+    const int32 half = stats.Num / 2;
+    stats.Median = (stats.Num & 1) ? sorted[half] : (sorted[half - 1] + sorted[half]) * 0.5;
+
+    double sum = 0.0;
+    for (double value : samples)
+    {
+        sum += value;
+    }
+    stats.Mean = sum / stats.Num;
+
+    if (stats.Num > 1)
+    {
+        double variance = 0.0;
+        for (double value : samples)
+        {
+            variance += (value - stats.Mean) * (value - stats.Mean);
+        }
+        variance /= stats.Num - 1;
+        stats.Interval = GetStudentT95(stats.Num - 1) * std::sqrt(variance / stats.Num);
+    }
+    return stats;
+}
+
+/**
+ * Two sided p value of Mann-Whitney U test with normal approximation and tie correction.
+ * Unlike t test it doesn't assume timings are normal distributed, outliers of a noisy run
+ * only count as one rank.
+ */
+static double GetUTestPValue(const Array<double>& lhs, const Array<double>& rhs)
+{
+    struct RankedSample
+    {
+        double Value;
+        bool FromLhs;
+    };
+
+    Array<RankedSample> all;
+    for (double value : lhs)
+    {
+        all.Add({ value, true });
+    }
+    for (double value : rhs)
+    {
+        all.Add({ value, false });
+    }
+    std::sort(all.Data(), all.Data() + all.Size(), [](const RankedSample& a, const RankedSample& b) { return a.Value < b.Value; });
+
+    const double n1 = lhs.Size();
+    const double n2 = rhs.Size();
+    const double n = n1 + n2;
+    double rankSum = 0.0;
+    double tieTerm = 0.0;
+    for (int32 start = 0; start < all.Size();)
+    {
+        int32 end = start + 1;
+        while (end < all.Size() && all[end].Value == all[start].Value)
+        {
+            ++end;
+        }
+        const double rank = (start + end + 1) * 0.5;
+        for (int32 i = start; i < end; i++)
+        {
+            rankSum += all[i].FromLhs ? rank : 0.0;
+        }
+        const double ties = end - start;
+        tieTerm += ties * ties * ties - ties;
+        start = end;
+    }
+
+    const double u = rankSum - n1 * (n1 + 1) * 0.5;
+    const double mean = n1 * n2 * 0.5;
+    const double variance = n1 * n2 / 12.0 * ((n + 1) - tieTerm / (n * (n - 1)));
+    if (variance <= 0.0)
+    {
+        return 1.0;
+    }
+    const double z = (std::abs(u - mean) - 0.5) / std::sqrt(variance);
+    return std::erfc(std::max(z, 0.0) / std::sqrt(2.0));
+}
+
+enum class EVerdict : uint8
+{
+    Same,
+    Improved,
+    Regressed,
+    Noisy,
+};
+
+struct CompareOptions
+{
+    double Threshold{ 0.05 };
+    double Alpha{ 0.05 };
+    /** below this many repetitions per side the u test can't reach significance, fall back to confidence intervals */
+    int32 MinUTestSamples{ 5 };
+    std::string Metric{ "auto" };
+};
+
+struct CompareResult
+{
+    SampleStats Base;
+    SampleStats Current;
+    double Change{ 0.0 };
+    double PValue{ -1.0 };
+    EVerdict Verdict{ EVerdict::Same };
+};
+
+static const Array<double>& GetMetricSamples(const BenchmarkSamples& samples, const CompareOptions& options)
+{
+    const bool useRealTime = options.Metric == "auto" ? samples.UseRealTime : options.Metric == "real_time";
+    return useRealTime ? samples.RealTimes : samples.CpuTimes;
+}
+
+static CompareResult Compare(const BenchmarkSamples& base, const BenchmarkSamples& current, const CompareOptions& options)
+{
+    const Array<double>& baseSamples = GetMetricSamples(base, options);
+    const Array<double>& currentSamples = GetMetricSamples(current, options);
+
+    CompareResult result;
+    result.Base = GetStats(baseSamples);
+    result.Current = GetStats(currentSamples);
+    result.Change = result.Base.Median > 0.0 ? result.Current.Median / result.Base.Median - 1.0 : 0.0;
+
+    bool significant;
+    if (result.Base.Num >= options.MinUTestSamples && result.Current.Num >= options.MinUTestSamples)
+    {
+        result.PValue = GetUTestPValue(baseSamples, currentSamples);
+        significant = result.PValue < options.Alpha;
+    }
+    else if (result.Base.Num > 1 && result.Current.Num > 1)
+    {
+        const double gap = std::abs(result.Current.Mean - result.Base.Mean);
+        significant = gap > result.Base.Interval + result.Current.Interval;
+    }
+    else
+    {
+        // single run, threshold is all we have
+        significant = true;
+    }
+
+    if (std::abs(result.Change) <= options.Threshold)
+    {
+        result.Verdict = EVerdict::Same;
+    }
+    else if (!significant)
+    {
+        result.Verdict = EVerdict::Noisy;
+    }
+    else
+    {
+        result.Verdict = result.Change > 0.0 ? EVerdict::Regressed : EVerdict::Improved;
+    }
+    return result;
+}
+
+static bool LoadReport(const String& path, BenchmarkReport& outReport)
+{
+    Array64<uint8> data;
+    FileSystem::ReadFileToBinary(path, data);
+    if (data.Size() == 0)
+    {
+        printf("Can't read benchmark result %s\n", path.Data());
+        return false;
+    }
+
+    BenchmarkJsonReader reader(std::string_view(reinterpret_cast<const char*>(data.Data()), static_cast<size_t>(data.Size())));
+    if (!reader.Read(outReport))
+    {
+        printf("%s isn't a valid google benchmark json\n", path.Data());
+        return false;
+    }
+    return true;
+}
+
+/** CopyFile doesn't overwrite, old baseline is moved away first so a failed copy doesn't lose it */
+static bool SaveBaseline(const String& currentPath, const String& baselinePath)
+{
+    const StringView parent = PathView(baselinePath).GetParent();
+    FileSystem::MakeDirTree(String(parent.Data(), parent.Length()));
+
+    const String backupPath = baselinePath + ".old";
+    const bool hasOld = FileSystem::FileExists(baselinePath);
+    if (hasOld)
+    {
+        if (FileSystem::FileExists(backupPath))
+        {
+            FileSystem::RemoveFile(backupPath);
+        }
+        if (!FileSystem::MoveFile(baselinePath, backupPath))
+        {
+            return false;
+        }
+    }
+    if (!FileSystem::CopyFile(currentPath, baselinePath))
+    {
+        if (hasOld)
+        {
+            FileSystem::MoveFile(backupPath, baselinePath);
+        }
+        return false;
+    }
+    if (hasOld)
+    {
+        FileSystem::RemoveFile(backupPath);
+    }
+    return true;
+}
+
+static std::string FormatTime(double nanoseconds)
+{
+    char buffer[32];
+    if (nanoseconds >= 1e9)
+    {
+        snprintf(buffer, sizeof(buffer), "%.3f s", nanoseconds / 1e9);
+    }
+    else if (nanoseconds >= 1e6)
+    {
+        snprintf(buffer, sizeof(buffer), "%.3f ms", nanoseconds / 1e6);
+    }
+    else if (nanoseconds >= 1e3)
+    {
+        snprintf(buffer, sizeof(buffer), "%.3f us", nanoseconds / 1e3);
+    }
+    else
+    {
+        snprintf(buffer, sizeof(buffer), "%.1f ns", nanoseconds);
+    }
+    return buffer;
+}
+
+static const char* GetVerdictName(EVerdict verdict)
+{
+    switch (verdict)
+    {
+        case EVerdict::Improved: return "improved";
+        case EVerdict::Regressed: return "REGRESSED";
+        case EVerdict::Noisy: return "noisy";
+        default: return "";
+    }
+}
+
+static int Run(int argc, char** argv)
+{
+    cxxopts::Options options("benchmark_compare", "Compare google benchmark json results against a baseline");
+    options.add_options()
+        ("b,baseline", "Baseline json, eg: a checked in or previously saved result", cxxopts::value<std::string>())
+        ("c,current", "Json of run to check", cxxopts::value<std::string>())
+        ("t,threshold", "Relative change of median that counts, in percent", cxxopts::value<double>()->default_value("5"))
+        ("alpha", "Significance level of u test", cxxopts::value<double>()->default_value("0.05"))
+        ("metric", "auto, real_time or cpu_time, auto follows UseRealTime of benchmark", cxxopts::value<std::string>()->default_value("auto"))
+        ("filter", "Only compare benchmarks matching regex", cxxopts::value<std::string>())
+        ("fail", "Return non zero when any benchmark regressed")
+        ("update", "Replace baseline with whole current run when nothing regressed, or baseline doesn't exist yet")
+        ("h,help", "Print usage");
+    options.parse_positional({ "baseline", "current" });
+
+    const cxxopts::ParseResult result = options.parse(argc, argv);
+    if (result.count("help") || !result.count("baseline") || !result.count("current"))
+    {
+        printf("%s\n", options.help().c_str());
+        return result.count("help") ? 0 : 1;
+    }
+
+    CompareOptions compareOptions;
+    compareOptions.Threshold = result["threshold"].as<double>() / 100.0;
+    compareOptions.Alpha = result["alpha"].as<double>();
+    compareOptions.Metric = result["metric"].as<std::string>();
+    if (compareOptions.Metric != "auto" && compareOptions.Metric != "real_time" && compareOptions.Metric != "cpu_time")
+    {
+        printf("Unknown metric %s\n", compareOptions.Metric.c_str());
+        return 1;
+    }
+
+    const String baselinePath = result["baseline"].as<std::string>().c_str();
+    const String currentPath = result["current"].as<std::string>().c_str();
+    const bool update = result.count("update") > 0;
+
+    BenchmarkReport current;
+    if (!LoadReport(currentPath, current))
+    {
+        return 1;
+    }
+
+    if (!FileSystem::FileExists(baselinePath))
+    {
+        printf("Baseline %s doesn't exist", baselinePath.Data());
+        if (update)
+        {
+            const bool copied = SaveBaseline(currentPath, baselinePath);
+            printf(copied ? ", saved current run as baseline\n" : ", failed to save current run as baseline\n");
+            return copied ? 0 : 1;
+        }
+        printf("\n");
+        return 1;
+    }
+
+    BenchmarkReport base;
+    if (!LoadReport(baselinePath, base))
+    {
+        return 1;
+    }
+    if (base.BuildConfig != current.BuildConfig)
+    {
+        printf("Warning: baseline is a %s build but current is %s, timings aren't comparable\n",
+               base.BuildConfig.empty() ? "unknown" : base.BuildConfig.c_str(),
+               current.BuildConfig.empty() ? "unknown" : current.BuildConfig.c_str());
+    }
+    if (base.HostName != current.HostName)
+    {
+        printf("Warning: baseline was recorded on %s, current on %s\n", base.HostName.c_str(), current.HostName.c_str());
+    }
+
+    std::regex filter;
+    const bool hasFilter = result.count("filter") > 0;
+    if (hasFilter)
+    {
+        filter = std::regex(result["filter"].as<std::string>());
+    }
+
+    int32 counts[4] = {};
+    int32 missingNum = 0;
+    printf("%-64s %12s %12s %9s %7s %5s\n", "Benchmark", "Baseline", "Current", "Change", "p", "Runs");
+    for (const BenchmarkSamples& samples : current.Benchmarks)
+    {
+        if (hasFilter && !std::regex_search(samples.Name.Data(), filter))
+        {
+            continue;
+        }
+
+        const int32* baseIndex = base.Indices.Find(samples.Name);
+        if (baseIndex == nullptr)
+        {
+            printf("%-64s %12s %12s\n", samples.Name.Data(), "-", "new");
+            continue;
+        }
+        const BenchmarkSamples& baseSamples = base.Benchmarks[*baseIndex];
+        if (samples.HasError || baseSamples.HasError || samples.RealTimes.Size() == 0 || baseSamples.RealTimes.Size() == 0)
+        {
+            printf("%-64s %12s %12s\n", samples.Name.Data(), "-", "error");
+            continue;
+        }
+
+        const CompareResult compare = Compare(baseSamples, samples, compareOptions);
+        ++counts[static_cast<int32>(compare.Verdict)];
+
+        char pValue[16] = "-";
+        if (compare.PValue >= 0.0)
+        {
+            snprintf(pValue, sizeof(pValue), "%.3f", compare.PValue);
+        }
+        printf("%-64s %12s %12s %+8.1f%% %7s %2d/%-2d %s\n", samples.Name.Data(),
+               FormatTime(compare.Base.Median).c_str(), FormatTime(compare.Current.Median).c_str(), compare.Change * 100.0,
+               pValue, compare.Base.Num, compare.Current.Num, GetVerdictName(compare.Verdict));
+    }
+
+    for (const BenchmarkSamples& samples : base.Benchmarks)
+    {
+        if ((!hasFilter || std::regex_search(samples.Name.Data(), filter)) && !current.Indices.Contains(samples.Name))
+        {
+            ++missingNum;
+            printf("%-64s %12s %12s\n", samples.Name.Data(), "-", "missing");
+        }
+    }
+
+    const int32 regressedNum = counts[static_cast<int32>(EVerdict::Regressed)];
+    printf("\n%d regressed, %d improved, %d unchanged, %d too noisy to tell, %d missing (threshold %.1f%%)\n",
+           regressedNum, counts[static_cast<int32>(EVerdict::Improved)], counts[static_cast<int32>(EVerdict::Same)],
+           counts[static_cast<int32>(EVerdict::Noisy)], missingNum, compareOptions.Threshold * 100.0);
+
+    if (update && regressedNum == 0)
+    {
+        if (!SaveBaseline(currentPath, baselinePath))
+        {
+            printf("Failed to update baseline %s\n", baselinePath.Data());
+            return 1;
+        }
+        printf("Updated baseline %s\n", baselinePath.Data());
+    }
+    return result.count("fail") && regressedNum > 0 ? 1 : 0;
+}
+
+int main(int argc, char** argv)
+{
+    int ret;
+    try
+    {
+        ret = Run(argc, argv);
+    }
+    catch (const cxxopts::OptionException& e)
+    {
+        printf("%s\n", e.what());
+        ret = 1;
+    }
+    catch (const std::regex_error& e)
+    {
+        printf("Invalid filter: %s\n", e.what());
+        ret = 1;
+    }
+
+    AsyncFileIO::Shutdown();
+    Memory::Shutdown();
+    return ret;
+}
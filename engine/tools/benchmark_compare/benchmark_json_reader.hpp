@@ -0,0 +1,389 @@
+#pragma once
+
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include "foundation/map.hpp"
+#include "foundation/string.hpp"
+
+namespace Engine
+{
+/** repetitions of one benchmark, times are in nanoseconds */
+struct BenchmarkSamples
+{
+    String Name;
+    Array<double> RealTimes;
+    Array<double> CpuTimes;
+    bool UseRealTime{ false };
+    bool HasError{ false };
+};
+
+struct BenchmarkReport
+{
+    std::string BuildConfig;
+    std::string HostName;
+    Array<BenchmarkSamples> Benchmarks;
+    Map<String, int32> Indices;
+};
+
+/**
+ * Reads the subset of google benchmark json the comparison needs: context strings
+ * and flat fields of every entry in "benchmarks", nested values are skipped.
+ */
+class BenchmarkJsonReader
+{
+public:
+    explicit BenchmarkJsonReader(std::string_view text) : Text(text) {}
+
+    bool Read(BenchmarkReport& outReport)
+    {
+        if (!Consume('{'))
+        {
+            return false;
+        }
+        if (Consume('}'))
+        {
+            return true;
+        }
+        do
+        {
+            std::string key;
+            if (!ReadString(key) || !Consume(':'))
+            {
+                return false;
+            }
+            bool ok;
+            if (key == "context")
+            {
+                ok = ReadContext(outReport);
+            }
+            else if (key == "benchmarks")
+            {
+                ok = ReadBenchmarks(outReport);
+            }
+            else
+            {
+                ok = SkipValue();
+            }
+            if (!ok)
+            {
+                return false;
+            }
+        } while (Consume(','));
+        return Consume('}');
+    }
+
+private:
+    struct Entry
+    {
+        std::string Name;
+        std::string RunName;
+        std::string RunType;
+        std::string AggregateName;
+        std::string TimeUnit{ "ns" };
+        double RealTime{ 0.0 };
+        double CpuTime{ 0.0 };
+        bool Error{ false };
+    };
+
+    bool ReadContext(BenchmarkReport& outReport)
+    {
+        return ReadObject([&](const std::string& key) {
+            if (key == "build_config")
+            {
+                return ReadString(outReport.BuildConfig);
+            }
+            if (key == "host_name")
+            {
+                return ReadString(outReport.HostName);
+            }
+            return SkipValue();
+        });
+    }
+
+    bool ReadBenchmarks(BenchmarkReport& outReport)
+    {
+        if (!Consume('['))
+        {
+            return false;
+        }
+        if (Consume(']'))
+        {
+            return true;
+        }
+        do
+        {
+            Entry entry;
+            if (!ReadEntry(entry))
+            {
+                return false;
+            }
+            AddEntry(entry, outReport);
+        } while (Consume(','));
+        return Consume(']');
+    }
+
+    bool ReadEntry(Entry& outEntry)
+    {
+        return ReadObject([&](const std::string& key) {
+            if (key == "name")
+            {
+                return ReadString(outEntry.Name);
+            }
+            if (key == "run_name")
+            {
+                return ReadString(outEntry.RunName);
+            }
+            if (key == "run_type")
+            {
+                return ReadString(outEntry.RunType);
+            }
+            if (key == "aggregate_name")
+            {
+                return ReadString(outEntry.AggregateName);
+            }
+            if (key == "time_unit")
+            {
+                return ReadString(outEntry.TimeUnit);
+            }
+            if (key == "real_time")
+            {
+                return ReadNumber(outEntry.RealTime);
+            }
+            if (key == "cpu_time")
+            {
+                return ReadNumber(outEntry.CpuTime);
+            }
+            if (key == "error_occurred")
+            {
+                return ReadBool(outEntry.Error);
+            }
+            return SkipValue();
+        });
+    }
+
+    static double ToNanoseconds(const std::string& unit)
+    {
+        if (unit == "us")
+        {
+            return 1e3;
+        }
+        if (unit == "ms")
+        {
+            return 1e6;
+        }
+        if (unit == "s")
+        {
+            return 1e9;
+        }
+        return 1.0;
+    }
+
+    /**
+     * Repetitions are kept as samples. A report written with --benchmark_report_aggregates_only
+     * only has aggregates, its median is used as the single sample instead.
+     */
+    static void AddEntry(const Entry& entry, BenchmarkReport& outReport)
+    {
+        const bool isAggregate = entry.RunType == "aggregate";
+        if (isAggregate && entry.AggregateName != "median")
+        {
+            return;
+        }
+
+        const std::string& runName = entry.RunName.empty() ? entry.Name : entry.RunName;
+        const String key(runName.c_str());
+        int32* index = outReport.Indices.Find(key);
+        if (index == nullptr)
+        {
+            BenchmarkSamples samples;
+            samples.Name = key;
+            samples.UseRealTime = IsRealTimeRun(runName);
+            outReport.Benchmarks.Add(std::move(samples));
+            index = &outReport.Indices.Add(key, outReport.Benchmarks.Size() - 1);
+        }
+
+        BenchmarkSamples& samples = outReport.Benchmarks[*index];
+        samples.HasError |= entry.Error;
+        if (entry.Error || (isAggregate && samples.RealTimes.Size() > 0))
+        {
+            return;
+        }
+        const double scale = ToNanoseconds(entry.TimeUnit);
+        samples.RealTimes.Add(entry.RealTime * scale);
+        samples.CpuTimes.Add(entry.CpuTime * scale);
+    }
+
+    /** real_time is one path component, eg: BM_Foo/64/real_time/threads:2 */
+    static bool IsRealTimeRun(std::string_view runName)
+    {
+        size_t begin = 0;
+        while (begin <= runName.size())
+        {
+            size_t end = runName.find('/', begin);
+            if (end == std::string_view::npos)
+            {
+                end = runName.size();
+            }
+            if (runName.substr(begin, end - begin) == "real_time")
+            {
+                return true;
+            }
+            begin = end + 1;
+        }
+        return false;
+    }
+
+    template <typename FieldFun>
+    bool ReadObject(FieldFun&& fieldFun)
+    {
+        if (!Consume('{'))
+        {
+            return false;
+        }
+        if (Consume('}'))
+        {
+            return true;
+        }
+        do
+        {
+            std::string key;
+            if (!ReadString(key) || !Consume(':') || !fieldFun(key))
+            {
+                return false;
+            }
+        } while (Consume(','));
+        return Consume('}');
+    }
+
+    void SkipSpace()
+    {
+        while (Pos < Text.size() && (Text[Pos] == ' ' || Text[Pos] == '\t' || Text[Pos] == '\r' || Text[Pos] == '\n'))
+        {
+            ++Pos;
+        }
+    }
+
+    bool Consume(char ch)
+    {
+        SkipSpace();
+        if (Pos < Text.size() && Text[Pos] == ch)
+        {
+            ++Pos;
+            return true;
+        }
+        return false;
+    }
+
+    bool ReadString(std::string& outString)
+    {
+        if (!Consume('"'))
+        {
+            return false;
+        }
+        outString.clear();
+        while (Pos < Text.size())
+        {
+            const char ch = Text[Pos++];
+            if (ch == '"')
+            {
+                return true;
+            }
+            if (ch != '\\')
+            {
+                outString.push_back(ch);
+                continue;
+            }
+            if (Pos >= Text.size())
+            {
+                return false;
+            }
+            const char escaped = Text[Pos++];
+            switch (escaped)
+            {
+                case 'n': outString.push_back('\n'); break;
+                case 't': outString.push_back('\t'); break;
+                case 'r': outString.push_back('\r'); break;
+                case 'b': outString.push_back('\b'); break;
+                case 'f': outString.push_back('\f'); break;
+                // names are ascii, keep other code points as placeholder
+                case 'u':
+                    Pos += 4;
+                    outString.push_back('?');
+                    break;
+                default: outString.push_back(escaped); break;
+            }
+        }
+        return false;
+    }
+
+    bool ReadNumber(double& outNumber)
+    {
+        SkipSpace();
+        const char* begin = Text.data() + Pos;
+        char* end = nullptr;
+        outNumber = std::strtod(begin, &end);
+        if (end == begin)
+        {
+            // inf and nan are written unquoted by some versions
+            return SkipValue();
+        }
+        Pos += static_cast<size_t>(end - begin);
+        return true;
+    }
+
+    bool ReadBool(bool& outBool)
+    {
+        SkipSpace();
+        outBool = Text.substr(Pos, 4) == "true";
+        return SkipValue();
+    }
+
+    bool SkipValue()
+    {
+        SkipSpace();
+        if (Pos >= Text.size())
+        {
+            return false;
+        }
+
+        std::string ignored;
+        const char ch = Text[Pos];
+        if (ch == '"')
+        {
+            return ReadString(ignored);
+        }
+        if (ch == '{')
+        {
+            return ReadObject([this](const std::string&) { return SkipValue(); });
+        }
+        if (ch == '[')
+        {
+            ++Pos;
+            if (Consume(']'))
+            {
+                return true;
+            }
+            do
+            {
+                if (!SkipValue())
+                {
+                    return false;
+                }
+            } while (Consume(','));
+            return Consume(']');
+        }
+
+        // number, true, false or null
+        const size_t start = Pos;
+        while (Pos < Text.size() && Text[Pos] != ',' && Text[Pos] != '}' && Text[Pos] != ']' && Text[Pos] != ' ' && Text[Pos] != '\n')
+        {
+            ++Pos;
+        }
+        return Pos > start;
+    }
+
+    std::string_view Text;
+    size_t Pos{ 0 };
+};
+}
@@ -1,10 +1,12 @@
 #include <array>
+#include <bitset>
+#include <cstdio>
+#include <cstring>
 
 // https://learn.microsoft.com/en-us/cpp/intrinsics/cpuid-cpuidex?view=msvc-170
 #if defined(__x86_64__) || defined(_M_X64) || defined(__i386) || defined(_M_IX86)
 #ifdef _WIN32
 #include <intrin.h>
-#include <bitset>
 
 #define cpuid(info, x)    __cpuidex(info, x, 0)
 #else
@@ -92,7 +94,7 @@ void DetectFeature()
 }
 
 #else
-#error ""No cpuid intrinsic defined for processor architecture"
+#error "No cpuid intrinsic defined for processor architecture"
 
 void DetectFeature()
 {
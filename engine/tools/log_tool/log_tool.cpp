@@ -0,0 +1,221 @@
+#include <cstdio>
+#include "cxxopts.hpp"
+#include "file_system/async_file_io.hpp"
+#include "file_system/file_system.hpp"
+#include "log/binary_log.hpp"
+#include "log/log_file.hpp"
+#include "log/structured_log.hpp"
+#include "memory/memory.hpp"
+#include "memory/override_new_delete.hpp"
+
+using namespace Engine;
+
+struct LogFilter
+{
+    spdlog::level::level_enum MinLevel{ spdlog::level::trace };
+    std::string Category;
+    std::string Text;
+
+    bool Pass(const LogEntry& entry) const
+    {
+        if (entry.Level < MinLevel)
+        {
+            return false;
+        }
+        if (!Category.empty() && std::string_view(entry.Category.Data(), entry.Category.Length()) != Category)
+        {
+            return false;
+        }
+        return Text.empty() || std::string_view(entry.Message.Data(), entry.Message.Length()).find(Text) != std::string_view::npos;
+    }
+};
+
+static void Output(FILE* output, const char* data, size_t size)
+{
+    fwrite(data, 1, size, output);
+}
+
+static bool IsLogOfType(const String& path, const char* extension)
+{
+    const String compressed = String(extension) + RotatingLogFile::COMPRESSED_EXTENSION;
+    return path.EndsWith(extension) || path.EndsWith(compressed);
+}
+
+static int PrintEntries(const String& path, const LogFilter& filter, FILE* output)
+{
+    spdlog::memory_buf_t text;
+    LogEntry entry;
+    int32 num = 0;
+    if (path.EndsWith(".bin"))
+    {
+        BinaryLogReader reader(path);
+        if (!reader.IsValid())
+        {
+            printf("Can't read binary log %s\n", path.Data());
+            return 1;
+        }
+        while (reader.Next(entry))
+        {
+            if (filter.Pass(entry))
+            {
+                text.clear();
+                LogFormatter::FormatText(entry, text);
+                Output(output, text.data(), text.size());
+                ++num;
+            }
+        }
+        if (reader.HasError())
+        {
+            printf("Binary log %s is truncated or corrupted after %d messages\n", path.Data(), num);
+        }
+        return 0;
+    }
+
+    StructuredLogReader reader(path);
+    if (!reader.IsValid())
+    {
+        printf("Can't read structured log %s\n", path.Data());
+        return 1;
+    }
+    while (reader.Next(entry))
+    {
+        if (filter.Pass(entry))
+        {
+            text.clear();
+            LogFormatter::FormatText(entry, text);
+            Output(output, text.data(), text.size());
+        }
+    }
+    if (reader.GetMalformedLineNum() > 0)
+    {
+        printf("Skipped %d malformed lines in %s\n", reader.GetMalformedLineNum(), path.Data());
+    }
+    return 0;
+}
+
+/** text log can't be parsed back, only text filter applies */
+static int PrintText(const String& path, const LogFilter& filter, FILE* output)
+{
+    Array64<uint8> data;
+    if (!RotatingLogFile::ReadFile(path, data))
+    {
+        printf("Can't read log %s\n", path.Data());
+        return 1;
+    }
+
+    const std::string_view text(reinterpret_cast<const char*>(data.Data()), static_cast<size_t>(data.Size()));
+    size_t start = 0;
+    while (start < text.size())
+    {
+        size_t end = text.find('\n', start);
+        end = end == std::string_view::npos ? text.size() : end + 1;
+        const std::string_view line = text.substr(start, end - start);
+        if (filter.Text.empty() || line.find(filter.Text) != std::string_view::npos)
+        {
+            Output(output, line.data(), line.size());
+        }
+        start = end;
+    }
+    return 0;
+}
+
+static int PrintLog(const String& path, const LogFilter& filter, FILE* output)
+{
+    if (path.EndsWith(".bin") || IsLogOfType(path, ".jsonl"))
+    {
+        return PrintEntries(path, filter, output);
+    }
+    return PrintText(path, filter, output);
+}
+
+static int Run(int argc, char** argv)
+{
+    cxxopts::Options options("log_tool", "Print binary, structured or rotated log as text");
+    options.add_options()
+        ("i,input", "Log to read, .bin, .jsonl or text log, optionally compressed by rotation", cxxopts::value<std::string>())
+        ("o,output", "Text file to write, console if not given", cxxopts::value<std::string>())
+        ("a,all", "Read rotated files of log first, oldest first")
+        ("level", "Lowest level to print, eg: warning", cxxopts::value<std::string>())
+        ("category", "Only print messages of category", cxxopts::value<std::string>())
+        ("grep", "Only print messages containing text", cxxopts::value<std::string>())
+        ("h,help", "Print usage");
+    options.parse_positional({ "input" });
+
+    const cxxopts::ParseResult result = options.parse(argc, argv);
+    if (result.count("help") || !result.count("input"))
+    {
+        printf("%s\n", options.help().c_str());
+        return result.count("help") ? 0 : 1;
+    }
+
+    LogFilter filter;
+    if (result.count("level"))
+    {
+        filter.MinLevel = spdlog::level::from_str(result["level"].as<std::string>());
+    }
+    if (result.count("category"))
+    {
+        filter.Category = result["category"].as<std::string>();
+    }
+    if (result.count("grep"))
+    {
+        filter.Text = result["grep"].as<std::string>();
+    }
+
+    const String input = result["input"].as<std::string>().c_str();
+    Array<String> files;
+    if (result.count("all"))
+    {
+        files = RotatingLogFile::GetRotatedFiles(input);
+    }
+    if (FileSystem::FileExists(input))
+    {
+        files.Add(input);
+    }
+    if (files.Size() == 0)
+    {
+        printf("Log %s doesn't exist\n", input.Data());
+        return 1;
+    }
+
+    FILE* output = stdout;
+    if (result.count("output"))
+    {
+        output = fopen(result["output"].as<std::string>().c_str(), "wb");
+        if (output == nullptr)
+        {
+            printf("Can't create %s\n", result["output"].as<std::string>().c_str());
+            return 1;
+        }
+    }
+
+    int ret = 0;
+    for (const String& file : files)
+    {
+        ret = PrintLog(file, filter, output) != 0 ? 1 : ret;
+    }
+
+    if (output != stdout)
+    {
+        fclose(output);
+    }
+    return ret;
+}
+
+int main(int argc, char** argv)
+{
+    int ret;
+    try
+    {
+        ret = Run(argc, argv);
+    }
+    catch (const cxxopts::OptionException& e)
+    {
+        printf("%s\n", e.what());
+        ret = 1;
+    }
+
+    AsyncFileIO::Shutdown();
+    Memory::Shutdown();
+    return ret;
+}
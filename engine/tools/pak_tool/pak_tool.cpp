@@ -0,0 +1,133 @@
+#include <cstdio>
+#include "cxxopts.hpp"
+#include "file_system/file_system.hpp"
+#include "file_system/async_file_io.hpp"
+#include "file_system/pak_file.hpp"
+#include "file_system/path.hpp"
+#include "memory/memory.hpp"
+#include "memory/override_new_delete.hpp"
+
+using namespace Engine;
+
+static int CreatePak(const String& pakPath, const String& inputDir, ECompressionMethod method, uint32 blockSize, uint32 alignment)
+{
+    const String rootDir = Path::Normalize(inputDir);
+    if (!FileSystem::DirExists(rootDir))
+    {
+        printf("Input directory %s doesn't exist\n", rootDir.Data());
+        return 1;
+    }
+
+    PakWriter writer(pakPath, method, blockSize, alignment);
+    if (!writer.IsValid())
+    {
+        printf("Can't create pak %s\n", pakPath.Data());
+        return 1;
+    }
+
+    for (const String& file : FileSystem::QueryFiles(rootDir, ".*", true))
+    {
+        if (!FileSystem::FileExists(file))
+        {
+            continue;
+        }
+
+        // path in pak is relative to input directory
+        const String normalizedFile = Path::Normalize(file);
+        const String pathInPak = normalizedFile.Slices(rootDir.Length(), normalizedFile.Length() - rootDir.Length());
+        if (!writer.AddFile(pathInPak, file))
+        {
+            printf("Add %s failed\n", file.Data());
+            return 1;
+        }
+    }
+
+    if (!writer.Finalize())
+    {
+        printf("Write pak index failed\n");
+        return 1;
+    }
+
+    const int64 uncompressedSize = writer.GetUncompressedSize();
+    const int64 compressedSize = writer.GetCompressedSize();
+    printf("Packed %d files, %lld -> %lld bytes (%.1f%%)\n", writer.GetEntryNum(), static_cast<long long>(uncompressedSize),
+           static_cast<long long>(compressedSize), uncompressedSize > 0 ? compressedSize * 100.0 / uncompressedSize : 100.0);
+    return 0;
+}
+
+static int ListPak(const String& pakPath)
+{
+    SharedPtr<PakFile> pak = PakFile::Load(FileSystem::OpenFile(pakPath, EFileAccess::Read));
+    if (pak == nullptr)
+    {
+        printf("Can't load pak %s\n", pakPath.Data());
+        return 1;
+    }
+
+    for (int32 index = 0; index < pak->GetEntryNum(); ++index)
+    {
+        const PakEntry& entry = pak->GetEntry(index);
+        int64 compressedSize = 0;
+        for (int32 blockIndex = 0; blockIndex < static_cast<int32>(entry.BlockNum); ++blockIndex)
+        {
+            compressedSize += pak->GetBlock(entry, blockIndex).CompressedSize;
+        }
+        printf("%12lld %12lld  %s\n", static_cast<long long>(entry.Size), static_cast<long long>(compressedSize),
+               pak->GetEntryPath(entry).Data());
+    }
+    return 0;
+}
+
+static int Run(int argc, char** argv)
+{
+    cxxopts::Options options("pak_tool", "Pack a directory into pak or list content of pak");
+    options.add_options()
+        ("o,output", "Pak to create", cxxopts::value<std::string>())
+        ("i,input", "Directory to pack", cxxopts::value<std::string>())
+        ("l,list", "Pak to list", cxxopts::value<std::string>())
+        ("block-size", "Uncompressed size of block", cxxopts::value<uint32>()->default_value(std::to_string(PakWriter::DEFAULT_BLOCK_SIZE)))
+        ("alignment", "Alignment of block in pak", cxxopts::value<uint32>()->default_value(std::to_string(PakWriter::DEFAULT_ALIGNMENT)))
+        ("no-compress", "Store files without compression")
+        ("h,help", "Print usage");
+
+    const cxxopts::ParseResult result = options.parse(argc, argv);
+    if (result.count("list"))
+    {
+        return ListPak(result["list"].as<std::string>().c_str());
+    }
+
+    if (result.count("help") || !result.count("output") || !result.count("input"))
+    {
+        printf("%s\n", options.help().c_str());
+        return result.count("help") ? 0 : 1;
+    }
+
+    const uint32 blockSize = result["block-size"].as<uint32>();
+    const uint32 alignment = result["alignment"].as<uint32>();
+    if ((blockSize & (blockSize - 1)) != 0 || (alignment & (alignment - 1)) != 0 || alignment == 0 || alignment > blockSize)
+    {
+        printf("Block size and alignment must be power of two, and alignment can't be greater than block size\n");
+        return 1;
+    }
+
+    const ECompressionMethod method = result.count("no-compress") ? ECompressionMethod::None : ECompressionMethod::LZ4;
+    return CreatePak(result["output"].as<std::string>().c_str(), result["input"].as<std::string>().c_str(), method, blockSize, alignment);
+}
+
+int main(int argc, char** argv)
+{
+    int ret;
+    try
+    {
+        ret = Run(argc, argv);
+    }
+    catch (const cxxopts::OptionException& e)
+    {
+        printf("%s\n", e.what());
+        ret = 1;
+    }
+
+    AsyncFileIO::Shutdown();
+    Memory::Shutdown();
+    return ret;
+}